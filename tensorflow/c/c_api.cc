@@ -139,15 +139,17 @@ class TF_ManagedBuffer : public TensorBuffer {
  public:
   TF_ManagedBuffer(void* data, size_t len,
                    void (*deallocator)(void* data, size_t len, void* arg),
-                   void* deallocator_arg)
+                   void* deallocator_arg, bool owns_memory)
       : TensorBuffer(data),
         len_(len),
         deallocator_(deallocator),
-        deallocator_arg_(deallocator_arg) {}
+        deallocator_arg_(deallocator_arg),
+        owns_memory_(owns_memory) {}
 
   const size_t len_;
   void (*const deallocator_)(void* data, size_t len, void* arg);
   void* const deallocator_arg_;
+  const bool owns_memory_;
 
   ~TF_ManagedBuffer() override {
     (*deallocator_)(data(), len_, deallocator_arg_);
@@ -161,8 +163,9 @@ class TF_ManagedBuffer : public TensorBuffer {
     proto->set_allocator_name(tensorflow::cpu_allocator()->Name());
   }
 
-  // Prevents input forwarding from mutating this buffer.
-  bool OwnsMemory() const override { return false; }
+  // When false, the buffer is borrowed from the client and input forwarding
+  // must not mutate it.
+  bool OwnsMemory() const override { return owns_memory_; }
 };
 
 void* allocate_tensor(const char* operation, size_t len) {
@@ -186,6 +189,25 @@ void deallocate_buffer(void* data, size_t len, void* arg) {
   tensorflow::cpu_allocator()->DeallocateRaw(data);
 }
 
+// Wraps `buf` in a TF_Tensor, validating that the buffer is large enough for
+// a tensor of the given type and shape.  May return nullptr (releasing the
+// reference to `buf`, which invokes its deallocator) if the buffer is
+// inconsistent with the requested tensor.
+TF_Tensor* MakeTensorFromManagedBuffer(TF_DataType dtype, const int64_t* dims,
+                                       int num_dims, TF_ManagedBuffer* buf) {
+  std::vector<tensorflow::int64> dimvec(num_dims);
+  for (int i = 0; i < num_dims; ++i) {
+    dimvec[i] = static_cast<tensorflow::int64>(dims[i]);
+  }
+  TF_Tensor* ret = new TF_Tensor{dtype, TensorShape(dimvec), buf};
+  size_t elem_size = TF_DataTypeSize(dtype);
+  if (elem_size > 0 && buf->size() < (elem_size * ret->shape.num_elements())) {
+    delete ret;
+    return nullptr;
+  }
+  return ret;
+}
+
 }  // namespace
 
 TF_Tensor::~TF_Tensor() { buffer->Unref(); }
@@ -193,19 +215,17 @@ TF_Tensor::~TF_Tensor() { buffer->Unref(); }
 TF_Tensor* TF_AllocateTensor(TF_DataType dtype, const int64_t* dims,
                              int num_dims, size_t len) {
   void* data = allocate_tensor("TF_AllocateTensor", len);
-  return TF_NewTensor(dtype, dims, num_dims, data, len, deallocate_buffer,
-                      nullptr);
+  // TensorFlow allocated this buffer and nothing else can be holding a
+  // reference to it, so in-place-capable ops may reuse it.
+  TF_ManagedBuffer* buf = new TF_ManagedBuffer(
+      data, len, deallocate_buffer, nullptr, /*owns_memory=*/true);
+  return MakeTensorFromManagedBuffer(dtype, dims, num_dims, buf);
 }
 
 TF_Tensor* TF_NewTensor(TF_DataType dtype, const int64_t* dims, int num_dims,
                         void* data, size_t len,
                         void (*deallocator)(void* data, size_t len, void* arg),
                         void* deallocator_arg) {
-  std::vector<tensorflow::int64> dimvec(num_dims);
-  for (int i = 0; i < num_dims; ++i) {
-    dimvec[i] = static_cast<tensorflow::int64>(dims[i]);
-  }
-
   TF_ManagedBuffer* buf = nullptr;
   if (dtype != TF_STRING && dtype != TF_RESOURCE &&
       tensorflow::DataTypeCanUseMemcpy(static_cast<DataType>(dtype)) &&
@@ -219,21 +239,36 @@ TF_Tensor* TF_NewTensor(TF_DataType dtype, const int64_t* dims, int num_dims,
     // Other types have the same representation, so copy only if it is safe to
     // do so.
     buf = new TF_ManagedBuffer(allocate_tensor("TF_NewTensor", len), len,
-                               deallocate_buffer, nullptr);
+                               deallocate_buffer, nullptr,
+                               /*owns_memory=*/true);
     std::memcpy(buf->data(), data, len);
     // Free the original buffer.
     deallocator(data, len, deallocator_arg);
   } else {
-    buf = new TF_ManagedBuffer(data, len, deallocator, deallocator_arg);
+    buf = new TF_ManagedBuffer(data, len, deallocator, deallocator_arg,
+                               /*owns_memory=*/false);
   }
 
-  TF_Tensor* ret = new TF_Tensor{dtype, TensorShape(dimvec), buf};
-  size_t elem_size = TF_DataTypeSize(dtype);
-  if (elem_size > 0 && len < (elem_size * ret->shape.num_elements())) {
-    delete ret;
-    return nullptr;
-  }
-  return ret;
+  return MakeTensorFromManagedBuffer(dtype, dims, num_dims, buf);
+}
+
+TF_Tensor* TF_NewDonatedTensor(
+    TF_DataType dtype, const int64_t* dims, int num_dims, void* data,
+    size_t len, void (*deallocator)(void* data, size_t len, void* arg),
+    void* deallocator_arg) {
+  if (dtype != TF_STRING && dtype != TF_RESOURCE &&
+      tensorflow::DataTypeCanUseMemcpy(static_cast<DataType>(dtype)) &&
+      reinterpret_cast<intptr_t>(data) % std::max(1, EIGEN_MAX_ALIGN_BYTES) !=
+          0) {
+    // An insufficiently aligned buffer cannot be used in place anyway; fall
+    // back to the copying path of TF_NewTensor, which consumes `data` and
+    // hands the runtime a buffer it owns.
+    return TF_NewTensor(dtype, dims, num_dims, data, len, deallocator,
+                        deallocator_arg);
+  }
+  TF_ManagedBuffer* buf = new TF_ManagedBuffer(
+      data, len, deallocator, deallocator_arg, /*owns_memory=*/true);
+  return MakeTensorFromManagedBuffer(dtype, dims, num_dims, buf);
 }
 
 TF_Tensor* TF_TensorMaybeMove(TF_Tensor* tensor) {
@@ -236,6 +236,20 @@ TF_CAPI_EXPORT extern TF_Tensor* TF_NewTensor(
     void (*deallocator)(void* data, size_t len, void* arg),
     void* deallocator_arg);
 
+// Like TF_NewTensor, but donates the buffer to TensorFlow: the caller promises
+// not to read or modify data[0,len-1] after this call, which allows the
+// runtime to hand the buffer to in-place-capable ops for reuse.
+//
+// The buffer is adopted without copying (provided `data` satisfies
+// TensorFlow's alignment preferences, see TF_AllocateTensor) and is reference
+// counted internally, so the tensor can be fed through the session run APIs
+// without a copy; the deallocator is invoked exactly once, when the last
+// reference to the buffer is released.
+TF_CAPI_EXPORT extern TF_Tensor* TF_NewDonatedTensor(
+    TF_DataType, const int64_t* dims, int num_dims, void* data, size_t len,
+    void (*deallocator)(void* data, size_t len, void* arg),
+    void* deallocator_arg);
+
 // Allocate and return a new Tensor.
 //
 // This function is an alternative to TF_NewTensor and should be used when
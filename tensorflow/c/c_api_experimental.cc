@@ -8527,6 +8527,113 @@ void TF_EnqueueNamedTensor(TF_Session* session, int tensor_id,
   VLOG(1) << "Enqueuing is done.";
 }
 
+struct TF_SessionCallable {
+  TF_Session* session;
+  tensorflow::Session::CallableHandle handle;
+
+  // Feed dtypes captured at preparation time, used to validate each run
+  // without consulting the graph.
+  std::vector<tensorflow::DataType> input_dtypes;
+
+  int noutputs;
+};
+
+TF_SessionCallable* TF_SessionMakeCallable(
+    TF_Session* session, const TF_Output* inputs, int ninputs,
+    const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status) {
+  assert(session);
+  if (session->extend_before_run &&
+      !tensorflow::ExtendSessionGraphHelper(session, status)) {
+    return nullptr;
+  }
+
+  // Do all the feed/fetch name construction once here, so that runs of the
+  // callable don't have to.
+  tensorflow::CallableOptions callable_options;
+  std::vector<tensorflow::DataType> input_dtypes;
+  input_dtypes.reserve(ninputs);
+  for (int i = 0; i < ninputs; ++i) {
+    callable_options.add_feed(tensorflow::strings::StrCat(
+        inputs[i].oper->node.name(), ":", inputs[i].index));
+    input_dtypes.push_back(inputs[i].oper->node.output_type(inputs[i].index));
+  }
+  for (int i = 0; i < noutputs; ++i) {
+    callable_options.add_fetch(tensorflow::strings::StrCat(
+        outputs[i].oper->node.name(), ":", outputs[i].index));
+  }
+  for (int i = 0; i < ntargets; ++i) {
+    callable_options.add_target(target_opers[i]->node.name());
+  }
+
+  tensorflow::Session::CallableHandle handle;
+  status->status =
+      session->session->MakeCallable(callable_options, &handle);
+  if (!status->status.ok()) {
+    return nullptr;
+  }
+
+  TF_SessionCallable* callable = new TF_SessionCallable;
+  callable->session = session;
+  callable->handle = handle;
+  callable->input_dtypes = std::move(input_dtypes);
+  callable->noutputs = noutputs;
+  return callable;
+}
+
+void TF_SessionRunCallable(TF_SessionCallable* callable,
+                           TF_Tensor* const* input_values,
+                           TF_Tensor** output_values, TF_Buffer* run_metadata,
+                           TF_Status* status) {
+  assert(callable);
+  status->status = tensorflow::Status::OK();
+  for (int i = 0; i < callable->noutputs; ++i) {
+    output_values[i] = nullptr;
+  }
+
+  const int ninputs = callable->input_dtypes.size();
+  std::vector<tensorflow::Tensor> feeds(ninputs);
+  for (int i = 0; i < ninputs; ++i) {
+    if (TF_TensorType(input_values[i]) !=
+        static_cast<TF_DataType>(callable->input_dtypes[i])) {
+      status->status = tensorflow::errors::InvalidArgument(
+          "Expected a tensor of type ",
+          tensorflow::DataTypeString(callable->input_dtypes[i]), " for feed ",
+          i, " but got ",
+          tensorflow::DataTypeString(static_cast<tensorflow::DataType>(
+              TF_TensorType(input_values[i]))));
+      return;
+    }
+    status->status = tensorflow::TF_TensorToTensor(input_values[i], &feeds[i]);
+    if (!status->status.ok()) return;
+  }
+
+  std::vector<tensorflow::Tensor> fetches;
+  tensorflow::RunMetadata metadata;
+  status->status = callable->session->session->RunCallable(
+      callable->handle, feeds, &fetches,
+      run_metadata != nullptr ? &metadata : nullptr);
+  if (!status->status.ok()) return;
+
+  if (run_metadata != nullptr) {
+    status->status = tensorflow::MessageToBuffer(metadata, run_metadata);
+    if (!status->status.ok()) return;
+  }
+
+  for (int i = 0; i < callable->noutputs; ++i) {
+    output_values[i] = tensorflow::TF_TensorFromTensor(fetches[i], status);
+    if (!status->status.ok()) return;
+  }
+}
+
+void TF_SessionReleaseCallable(TF_SessionCallable* callable,
+                               TF_Status* status) {
+  assert(callable);
+  status->status = callable->session->session->ReleaseCallable(
+      callable->handle);
+  delete callable;
+}
+
 TF_Buffer* TFE_GetServerDef(const char* text_proto, TF_Status* status) {
   tensorflow::ServerDef server_def;
   if (!tensorflow::protobuf::TextFormat::ParseFromString(text_proto,
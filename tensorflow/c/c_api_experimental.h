@@ -141,6 +141,44 @@ TF_CAPI_EXPORT extern void TF_EnqueueNamedTensor(TF_Session* session,
                                                  int tensor_id,
                                                  TF_Tensor* tensor,
                                                  TF_Status* status);
+
+// --------------------------------------------------------------------------
+// Prepared session calls.
+//
+// TF_SessionMakeCallable() resolves a fixed set of feeds, fetches and targets
+// once, mirroring Session::MakeCallable() from the C++ API.  The returned
+// callable feeds and fetches tensors by position, so repeated invocations via
+// TF_SessionRunCallable() skip the per-call feed/fetch name construction,
+// parsing and dtype validation that TF_SessionRun() performs.  Intended for
+// high-QPS serving frontends that run the same subgraph many times.
+
+// An opaque handle to a prepared session call.
+typedef struct TF_SessionCallable TF_SessionCallable;
+
+// Prepares a callable that feeds `inputs[0,ninputs-1]`, fetches
+// `outputs[0,noutputs-1]` and runs `target_opers[0,ntargets-1]`.  The feed
+// dtypes are captured at preparation time and validated cheaply on each run.
+// The callable must be released with TF_SessionReleaseCallable() before the
+// session is deleted.  Returns nullptr on failure.
+TF_CAPI_EXPORT extern TF_SessionCallable* TF_SessionMakeCallable(
+    TF_Session* session, const TF_Output* inputs, int ninputs,
+    const TF_Output* outputs, int noutputs,
+    const TF_Operation* const* target_opers, int ntargets, TF_Status* status);
+
+// Runs a prepared callable.  `input_values[i]` feeds the i-th input passed to
+// TF_SessionMakeCallable() and on success `output_values[i]` holds the i-th
+// fetch; the caller takes ownership of the output tensors, as with
+// TF_SessionRun().  `run_metadata` may be nullptr.
+TF_CAPI_EXPORT extern void TF_SessionRunCallable(TF_SessionCallable* callable,
+                                                 TF_Tensor* const* input_values,
+                                                 TF_Tensor** output_values,
+                                                 TF_Buffer* run_metadata,
+                                                 TF_Status* status);
+
+// Releases the resources associated with a prepared callable.  The callable
+// must not be used afterwards.
+TF_CAPI_EXPORT extern void TF_SessionReleaseCallable(
+    TF_SessionCallable* callable, TF_Status* status);
 // Create a serialized tensorflow.ServerDef proto.
 TF_Buffer* TFE_GetServerDef(const char* text_proto, TF_Status* status);
 
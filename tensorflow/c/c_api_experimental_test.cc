@@ -176,6 +176,61 @@ TEST(CAPI_EXPERIMENTAL, IsStateful) {
   EXPECT_EQ(id, 0);
 }
 
+TEST(CAPI_EXPERIMENTAL, SessionCallable) {
+  TF_Status* s = TF_NewStatus();
+  TF_Graph* graph = TF_NewGraph();
+  TF_Operation* feed = Placeholder(graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* two = ScalarConst(2, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_Operation* add = Add(feed, two, graph, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_SessionOptions* opts = TF_NewSessionOptions();
+  TF_Session* session = TF_NewSession(graph, opts, s);
+  TF_DeleteSessionOptions(opts);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_Output feed_output = {feed, 0};
+  TF_Output add_output = {add, 0};
+  TF_SessionCallable* callable = TF_SessionMakeCallable(
+      session, &feed_output, 1, &add_output, 1, nullptr, 0, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  ASSERT_NE(nullptr, callable);
+
+  // The callable can be run repeatedly with different feed values.
+  for (int i = 0; i < 3; ++i) {
+    TF_Tensor* input = Int32Tensor(i);
+    TF_Tensor* output = nullptr;
+    TF_SessionRunCallable(callable, &input, &output, nullptr, s);
+    ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+    ASSERT_NE(nullptr, output);
+    ASSERT_EQ(TF_INT32, TF_TensorType(output));
+    EXPECT_EQ(2 + i, *static_cast<int32_t*>(TF_TensorData(output)));
+    TF_DeleteTensor(input);
+    TF_DeleteTensor(output);
+  }
+
+  // A feed of the wrong dtype is rejected by the pre-validated dtype check.
+  TF_Tensor* bad_input =
+      TF_AllocateTensor(TF_FLOAT, nullptr, 0, sizeof(float));
+  TF_Tensor* output = nullptr;
+  TF_SessionRunCallable(callable, &bad_input, &output, nullptr, s);
+  EXPECT_EQ(TF_INVALID_ARGUMENT, TF_GetCode(s));
+  EXPECT_EQ(nullptr, output);
+  TF_DeleteTensor(bad_input);
+
+  TF_SessionReleaseCallable(callable, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+
+  TF_CloseSession(session, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_DeleteSession(session, s);
+  ASSERT_EQ(TF_OK, TF_GetCode(s)) << TF_Message(s);
+  TF_DeleteGraph(graph);
+  TF_DeleteStatus(s);
+}
+
 TEST(CAPI_EXPERIMENTAL, TFE_ExecuteOpInNewThreadTest_Simple) {
   TF_Status* status = TF_NewStatus();
   TFE_ContextOptions* opts = TFE_NewContextOptions();
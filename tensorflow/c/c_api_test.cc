@@ -183,6 +183,27 @@ TEST(CAPI, MaybeMove) {
   EXPECT_TRUE(deallocator_called);
 }
 
+TEST(CAPI, NewDonatedTensor) {
+  const int num_bytes = 6 * sizeof(float);
+  float* values =
+      reinterpret_cast<float*>(tensorflow::cpu_allocator()->AllocateRaw(
+          EIGEN_MAX_ALIGN_BYTES, num_bytes));
+  int64_t dims[] = {2, 3};
+  bool deallocator_called = false;
+  TF_Tensor* t = TF_NewDonatedTensor(TF_FLOAT, dims, 2, values, num_bytes,
+                                     &Deallocator, &deallocator_called);
+  // The aligned buffer is adopted without a copy.
+  EXPECT_EQ(static_cast<void*>(values), TF_TensorData(t));
+  EXPECT_FALSE(deallocator_called);
+
+  // Unlike a borrowed buffer (see the MaybeMove test above), a donated buffer
+  // with a unique reference may be reused by the runtime.
+  TF_Tensor* o = TF_TensorMaybeMove(t);
+  ASSERT_TRUE(o != nullptr);
+  TF_DeleteTensor(o);
+  EXPECT_TRUE(deallocator_called);
+}
+
 TEST(CAPI, LibraryLoadFunctions) {
   // TODO(b/73318067): Fix linking for the GPU test generated by the
   // tf_cuda_cc_test() bazel rule and remove the next line.
@@ -15,24 +15,102 @@ limitations under the License.
 
 #include "tensorflow/cc/saved_model/reader.h"
 
+#include <algorithm>
+#include <limits>
 #include <unordered_set>
 
 #include "tensorflow/cc/saved_model/constants.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/protobuf/saved_model.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace {
 
+// Chunk size for concurrent positional reads of a binary SavedModel proto.
+constexpr uint64 kSavedModelReadChunkBytes = 32 << 20;  // 32MB
+
+// Whether to read the binary SavedModel proto with concurrent positional
+// reads before parsing it.  Read per call (rather than cached) since models
+// are loaded rarely and this keeps the knob testable.
+bool ParallelSavedModelReadEnabled() {
+  bool enabled;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_SAVED_MODEL_PARALLEL_READ",
+                                 /*default_val=*/false, &enabled));
+  return enabled;
+}
+
+// Reads the file into memory with chunked reads issued concurrently on a
+// thread pool, then parses it.  Large SavedModels are dominated by the
+// sequential read of the proto; chunked positional reads let the filesystem
+// serve them in parallel.
+Status ReadSavedModelParallel(Env* env, const string& fname,
+                              SavedModel* saved_model_proto) {
+  uint64 file_size;
+  TF_RETURN_IF_ERROR(env->GetFileSize(fname, &file_size));
+  if (file_size > static_cast<uint64>(std::numeric_limits<int>::max())) {
+    // Cannot be parsed as a single proto anyway; let the regular path
+    // produce the error.
+    return ReadBinaryProto(env, fname, saved_model_proto);
+  }
+  std::unique_ptr<RandomAccessFile> file;
+  TF_RETURN_IF_ERROR(env->NewRandomAccessFile(fname, &file));
+
+  std::unique_ptr<char[]> buffer(new char[file_size]);
+  const int num_chunks = static_cast<int>(
+      (file_size + kSavedModelReadChunkBytes - 1) / kSavedModelReadChunkBytes);
+  std::vector<Status> chunk_status(num_chunks);
+  {
+    thread::ThreadPool pool(
+        env, "saved_model_read",
+        std::max(1, std::min(num_chunks, port::NumSchedulableCPUs())));
+    for (int i = 0; i < num_chunks; ++i) {
+      pool.Schedule([i, file_size, &file, &buffer, &chunk_status] {
+        const uint64 offset = i * kSavedModelReadChunkBytes;
+        const size_t length = static_cast<size_t>(
+            std::min(kSavedModelReadChunkBytes, file_size - offset));
+        char* scratch = buffer.get() + offset;
+        StringPiece data;
+        chunk_status[i] = file->Read(offset, length, &data, scratch);
+        if (chunk_status[i].ok() && data.data() != scratch) {
+          memcpy(scratch, data.data(), data.size());
+        }
+      });
+    }
+  }  // Joins the pool.
+  for (const Status& s : chunk_status) {
+    TF_RETURN_IF_ERROR(s);
+  }
+
+  protobuf::io::CodedInputStream coded_stream(
+      reinterpret_cast<const uint8*>(buffer.get()),
+      static_cast<int>(file_size));
+  coded_stream.SetTotalBytesLimit(std::numeric_limits<int>::max(),
+                                  std::numeric_limits<int>::max());
+  if (!saved_model_proto->ParseFromCodedStream(&coded_stream) ||
+      !coded_stream.ConsumedEntireMessage()) {
+    return errors::DataLoss("Can't parse ", fname, " as binary proto");
+  }
+  return Status::OK();
+}
+
 Status ReadSavedModel(const string& export_dir, SavedModel* saved_model_proto) {
   LOG(INFO) << "Reading SavedModel from: " << export_dir;
 
   const string saved_model_pb_path =
       io::JoinPath(export_dir, kSavedModelFilenamePb);
   if (Env::Default()->FileExists(saved_model_pb_path).ok()) {
+    if (ParallelSavedModelReadEnabled()) {
+      return ReadSavedModelParallel(Env::Default(), saved_model_pb_path,
+                                    saved_model_proto);
+    }
     return ReadBinaryProto(Env::Default(), saved_model_pb_path,
                            saved_model_proto);
   }
@@ -48,12 +126,12 @@ Status ReadSavedModel(const string& export_dir, SavedModel* saved_model_proto) {
                     export_dir);
 }
 
-Status FindMetaGraphDef(const SavedModel& saved_model_proto,
+Status FindMetaGraphDef(SavedModel* saved_model_proto,
                         const std::unordered_set<string>& tags,
                         MetaGraphDef* meta_graph_def) {
   LOG(INFO) << "Reading meta graph with tags { " << str_util::Join(tags, " ")
             << " }";
-  for (const MetaGraphDef& graph_def : saved_model_proto.meta_graphs()) {
+  for (MetaGraphDef& graph_def : *saved_model_proto->mutable_meta_graphs()) {
     // Get tags from the graph_def.
     std::unordered_set<string> graph_tags;
     for (const string& tag : graph_def.meta_info_def().tags()) {
@@ -61,7 +139,10 @@ Status FindMetaGraphDef(const SavedModel& saved_model_proto,
     }
     // Match with the set of tags provided.
     if (graph_tags == tags) {
-      *meta_graph_def = graph_def;
+      // The SavedModel proto is discarded after this point, so steal the
+      // matching MetaGraphDef rather than deep-copying it; for large models
+      // the copy costs gigabytes of memory and seconds of load time.
+      meta_graph_def->Swap(&graph_def);
       return Status::OK();
     }
   }
@@ -81,7 +162,8 @@ Status ReadMetaGraphDefFromSavedModel(const string& export_dir,
                                       MetaGraphDef* const meta_graph_def) {
   SavedModel saved_model_proto;
   TF_RETURN_IF_ERROR(ReadSavedModel(export_dir, &saved_model_proto));
-  TF_RETURN_IF_ERROR(FindMetaGraphDef(saved_model_proto, tags, meta_graph_def));
+  TF_RETURN_IF_ERROR(
+      FindMetaGraphDef(&saved_model_proto, tags, meta_graph_def));
   return Status::OK();
 }
 
@@ -84,6 +84,18 @@ TEST_F(ReaderTest, NoTagMatchMultiple) {
       << st.error_message();
 }
 
+TEST_F(ReaderTest, ParallelRead) {
+  setenv("TF_SAVED_MODEL_PARALLEL_READ", "1", 1);
+  MetaGraphDef meta_graph_def;
+
+  const string export_dir =
+      io::JoinPath(testing::TensorFlowSrcRoot(), kTestDataSharded);
+  TF_ASSERT_OK(ReadMetaGraphDefFromSavedModel(export_dir, {kSavedModelTagServe},
+                                              &meta_graph_def));
+  CheckMetaGraphDef(meta_graph_def);
+  unsetenv("TF_SAVED_MODEL_PARALLEL_READ");
+}
+
 TEST_F(ReaderTest, PbtxtFormat) {
   MetaGraphDef meta_graph_def;
 
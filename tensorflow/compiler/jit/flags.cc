@@ -73,7 +73,12 @@ void AppendMarkForCompilationPassFlagsInternal(std::vector<Flag>* flag_list) {
            &mark_for_compilation_flags
                 ->tf_xla_disable_deadness_safety_checks_for_debugging,
            "Disable deadness related safety checks when clustering (this is "
-           "unsound).")};
+           "unsound)."),
+      Flag("tf_xla_cluster_exclude_ops",
+           &mark_for_compilation_flags->tf_xla_cluster_exclude_ops,
+           "Comma-separated list of operation types that are never clustered. "
+           "Useful for keeping shape-varying frontier ops out of clusters so "
+           "that new input shapes do not trigger recompilation.")};
   flag_list->insert(flag_list->end(), new_flags.begin(), new_flags.end());
 }
 
@@ -96,12 +101,15 @@ void AllocateAndParseFlags() {
   mark_for_compilation_flags->tf_xla_fusion_only = false;
   mark_for_compilation_flags
       ->tf_xla_disable_deadness_safety_checks_for_debugging = false;
+  mark_for_compilation_flags->tf_xla_cluster_exclude_ops = "";
 
   device_flags = new XlaDeviceFlags;
   device_flags->tf_xla_compile_on_demand = false;
 
   ops_flags = new XlaOpsCommonFlags;
   ops_flags->tf_xla_always_defer_compilation = false;
+  ops_flags->tf_xla_async_compilation = false;
+  ops_flags->tf_xla_max_compiles_per_cluster = 0;
 
   flag_list = new std::vector<Flag>({
       Flag("tf_xla_enable_lazy_compilation",
@@ -113,6 +121,17 @@ void AllocateAndParseFlags() {
 
       Flag("tf_xla_always_defer_compilation",
            &ops_flags->tf_xla_always_defer_compilation, ""),
+
+      Flag("tf_xla_async_compilation", &ops_flags->tf_xla_async_compilation,
+           "Compile XLA clusters on a background thread pool and run the "
+           "uncompiled cluster through the TF executor until the executable "
+           "is ready."),
+
+      Flag("tf_xla_max_compiles_per_cluster",
+           &ops_flags->tf_xla_max_compiles_per_cluster,
+           "Maximum number of times a cluster may be compiled before further "
+           "argument-shape signatures run through the TF executor instead. "
+           "Zero means no limit."),
   });
   AppendDumpGraphFlagsInternal(flag_list);
   AppendMarkForCompilationPassFlagsInternal(flag_list);
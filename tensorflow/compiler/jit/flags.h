@@ -58,6 +58,12 @@ struct MarkForCompilationPassFlags {
   // we do not do deadness related safety checks.  This is unsound in general,
   // but can be used as a debugging aid.
   bool tf_xla_disable_deadness_safety_checks_for_debugging;
+
+  // Comma-separated list of operation types that are never clustered.  Lets
+  // deployments keep shape-varying frontier ops out of clusters (splitting
+  // clusters at, say, bucketing boundaries) so that new input shapes do not
+  // recompile a giant executable.
+  string tf_xla_cluster_exclude_ops;
 };
 
 // Flags associated with the XLA bridge's xla_device module.
@@ -74,6 +80,19 @@ struct XlaOpsCommonFlags {
   // If true, _XlaCompile always refuses to compile the cluster, which means the
   // XLA clusters always run in the TF executor.  Defaults to false.
   bool tf_xla_always_defer_compilation;
+
+  // If true, _XlaCompile compiles clusters asynchronously on a background
+  // thread pool and runs the uncompiled cluster through the TF executor until
+  // the compiled executable is ready, instead of blocking the executor thread
+  // on first-shape compilation.  Defaults to false.
+  bool tf_xla_async_compilation;
+
+  // Maximum number of times a cluster may be compiled (once per distinct
+  // argument-shape signature) before further signatures run through the TF
+  // executor instead of being compiled.  Bounds the compile time sunk into
+  // clusters with many input shapes.  Zero means no limit.  Clusters marked
+  // must-compile are not affected.  Defaults to zero.
+  int64 tf_xla_max_compiles_per_cluster;
 };
 
 // Flags for the build_xla_ops pass.
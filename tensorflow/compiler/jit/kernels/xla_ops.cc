@@ -231,7 +231,8 @@ static Status BuildCompilationCache(OpKernelContext* ctx,
 static Status CompileToLocalExecutable(
     OpKernelContext* ctx, const NameAttrList& function,
     const XlaPlatformInfo& platform_info, absl::Span<const int> resources,
-    absl::Span<const int> constants, bool lazy, xla::LocalClient** client,
+    absl::Span<const int> constants,
+    XlaCompilationCache::CompileMode compile_mode, xla::LocalClient** client,
     std::map<int, OptionalTensor>* variables,
     const XlaCompiler::CompilationResult** kernel,
     xla::LocalExecutable** executable) {
@@ -291,9 +292,7 @@ static Status CompileToLocalExecutable(
   std::vector<XlaCompiler::Argument> args;
   TF_RETURN_IF_ERROR(XlaComputationLaunchContext::BuildXlaCompilerArguments(
       constant_args, *variables, ctx, &args));
-  return cache->Compile(options, function, args, compile_options,
-                        lazy ? XlaCompilationCache::CompileMode::kLazy
-                             : XlaCompilationCache::CompileMode::kStrict,
+  return cache->Compile(options, function, args, compile_options, compile_mode,
                         kernel, executable);
 }
 
@@ -308,8 +307,9 @@ void XlaLocalLaunchBase::Compute(OpKernelContext* ctx) {
 
   {
     Status s = CompileToLocalExecutable(
-        ctx, function_, platform_info_, resources_, constants_, /*lazy=*/false,
-        &client, &variables, &kernel, &executable);
+        ctx, function_, platform_info_, resources_, constants_,
+        XlaCompilationCache::CompileMode::kStrict, &client, &variables, &kernel,
+        &executable);
     if (!s.ok() && (platform_info_.device_type().type_string() == DEVICE_CPU ||
                     platform_info_.device_type().type_string() == DEVICE_GPU)) {
       // Suggest auto jit if the failure was with GPU or CPU.
@@ -433,9 +433,19 @@ void XlaCompileOp::Compute(OpKernelContext* ctx) {
       cannot_compile_cluster) {
     executable = nullptr;
   } else {
+    XlaCompilationCache::CompileMode compile_mode;
+    if (must_compile_) {
+      compile_mode = XlaCompilationCache::CompileMode::kStrict;
+    } else if (GetXlaOpsCommonFlags().tf_xla_async_compilation) {
+      // Compile in the background and run the cluster through the TF
+      // executor until the executable is ready.
+      compile_mode = XlaCompilationCache::CompileMode::kAsync;
+    } else {
+      compile_mode = XlaCompilationCache::CompileMode::kLazy;
+    }
     Status status = CompileToLocalExecutable(
-        ctx, function_, platform_info_, resources_, constants_,
-        /*lazy=*/!must_compile_, &client, &variables, &kernel, &executable);
+        ctx, function_, platform_info_, resources_, constants_, compile_mode,
+        &client, &variables, &kernel, &executable);
     if (must_compile_ || status.code() != error::UNIMPLEMENTED) {
       OP_REQUIRES_OK(ctx, status);
     }
@@ -22,6 +22,7 @@ limitations under the License.
 #include <unordered_set>
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/str_split.h"
 #include "tensorflow/compiler/jit/deadness_analysis.h"
 #include "tensorflow/compiler/jit/defs.h"
 #include "tensorflow/compiler/jit/flags.h"
@@ -445,6 +446,16 @@ Status FindCompilationCandidates(
 
   int64& fuel = GetMarkForCompilationPassFlags()->tf_xla_clustering_fuel;
 
+  // Operation types the user has asked us to never cluster, typically
+  // shape-varying frontier ops whose inclusion would recompile the cluster
+  // for every new input shape.
+  absl::flat_hash_set<string> excluded_ops;
+  for (absl::string_view op : absl::StrSplit(
+           GetMarkForCompilationPassFlags()->tf_xla_cluster_exclude_ops, ',',
+           absl::SkipEmpty())) {
+    excluded_ops.insert(string(op));
+  }
+
   // Iterate over nodes in sorted order so that compiler fuel is deterministic.
   // We can't simply pass op_nodes().begin() and op_nodes().end to the
   // std::vector constructor because they're not proper iterators, with
@@ -481,6 +492,13 @@ Status FindCompilationCandidates(
       continue;
     }
 
+    if (excluded_ops.contains(node->type_string())) {
+      VLOG(2) << "Rejecting " << node->name() << ": op "
+              << node->type_string()
+              << " is listed in tf_xla_cluster_exclude_ops";
+      continue;
+    }
+
     const XlaOpRegistry::DeviceRegistration* registration;
     CHECK(
         XlaOpRegistry::GetCompilationDevice(device_type.type(), &registration));
@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_join.h"
+#include "tensorflow/compiler/jit/flags.h"
 #include "tensorflow/compiler/tf2xla/dump_graph.h"
 #include "tensorflow/compiler/tf2xla/shape_util.h"
 #include "tensorflow/compiler/tf2xla/type_util.h"
@@ -39,6 +40,7 @@ limitations under the License.
 namespace tensorflow {
 
 constexpr int64 XlaCompilationCache::kDefaultCompilationThreshold;
+constexpr int XlaCompilationCache::kNumAsyncCompilerThreads;
 
 XlaCompilationCache::XlaCompilationCache(xla::LocalClient* client,
                                          DeviceType device_type)
@@ -164,6 +166,30 @@ Status XlaCompilationCache::BuildExecutable(
   return Status::OK();
 }
 
+void XlaCompilationCache::MaybePersistHloModule(
+    const Signature& signature, const XlaCompiler::CompilationResult& result) {
+  const char* dir = getenv("XLA_PERSISTENT_CACHE_DIR");
+  if (dir == nullptr || result.computation == nullptr) {
+    return;
+  }
+  Env* env = Env::Default();
+  Status s = env->RecursivelyCreateDir(dir);
+  if (s.ok()) {
+    const string filename =
+        absl::StrCat(dir, "/", device_type_.type_string(), "_",
+                     Signature::Hash()(signature), ".hlo.pb");
+    s = WriteBinaryProto(env, filename, result.computation->proto());
+    if (s.ok()) {
+      VLOG(1) << "Persisted HLO module for signature "
+              << signature.HumanString() << " to " << filename;
+    }
+  }
+  if (!s.ok()) {
+    LOG(WARNING) << "Failed to persist HLO module for signature "
+                 << signature.HumanString() << ": " << s;
+  }
+}
+
 Status XlaCompilationCache::Compile(
     const XlaCompiler::Options& options, const NameAttrList& function,
     absl::Span<const XlaCompiler::Argument> args,
@@ -175,13 +201,31 @@ Status XlaCompilationCache::Compile(
   if (compile_mode == CompileMode::kLazy) {
     compile_threshold = kDefaultCompilationThreshold;
   }
-  auto compile_fn = [&](XlaCompiler* compiler,
-                        XlaCompiler::CompilationResult* result) {
-    return compiler->CompileFunction(compile_options, function, args, result);
-  };
+  const bool async_compilation = compile_mode == CompileMode::kAsync;
+
+  std::function<Status(XlaCompiler * compiler,
+                       XlaCompiler::CompilationResult * result)>
+      compile_fn;
+  if (async_compilation) {
+    // The compilation may run on a background thread after this call has
+    // returned, so the closure must own copies of everything it uses.
+    std::vector<XlaCompiler::Argument> arg_vector(args.begin(), args.end());
+    compile_fn = [compile_options, function, arg_vector](
+        XlaCompiler* compiler, XlaCompiler::CompilationResult* result) {
+      return compiler->CompileFunction(compile_options, function, arg_vector,
+                                       result);
+    };
+  } else {
+    compile_fn = [&](XlaCompiler* compiler,
+                     XlaCompiler::CompilationResult* result) {
+      return compiler->CompileFunction(compile_options, function, args,
+                                       result);
+    };
+  }
   return CompileImpl(options, function, args, compile_fn,
                      /*compile_threshold=*/compile_threshold,
-                     out_compilation_result, out_executable);
+                     async_compilation, out_compilation_result,
+                     out_executable);
 }
 
 static bool IsMegamorphic(int64 compile_count, int64 execution_count) {
@@ -216,7 +260,72 @@ Status XlaCompilationCache::CompileSingleOp(
   };
   return CompileImpl(options, name, args, compile_op,
                      /*compile_threshold=*/absl::nullopt,
-                     out_compilation_result, out_executable);
+                     /*async_compilation=*/false, out_compilation_result,
+                     out_executable);
+}
+
+thread::ThreadPool* XlaCompilationCache::async_compiler_threads() {
+  mutex_lock lock(async_compiler_threads_mu_);
+  if (!async_compiler_threads_) {
+    async_compiler_threads_.reset(new thread::ThreadPool(
+        Env::Default(), "xla_async_compile", kNumAsyncCompilerThreads));
+  }
+  return async_compiler_threads_.get();
+}
+
+void XlaCompilationCache::ScheduleAsyncCompilation(
+    Entry* entry, const XlaCompiler::Options& options,
+    const std::function<Status(XlaCompiler* compiler,
+                               XlaCompiler::CompilationResult*)>& compile_fn,
+    const Signature& signature, const string& cluster_name) {
+  // The lambda below captures copies; `entry` stays valid because cache
+  // entries are never evicted, and the thread pool is joined before the cache
+  // is destroyed.
+  XlaCompilationCache* cache = this;
+  XlaCompiler::Options options_copy = options;
+  std::function<Status(XlaCompiler*, XlaCompiler::CompilationResult*)> fn =
+      compile_fn;
+  Signature signature_copy = signature;
+  string name = cluster_name;
+  async_compiler_threads()->Schedule(
+      [cache, entry, options_copy, fn, signature_copy, name] {
+        tensorflow::Env* env = tensorflow::Env::Default();
+        const uint64 compile_start_us = env->NowMicros();
+
+        XlaCompiler compiler(options_copy);
+        XlaCompiler::CompilationResult result;
+        Status status = fn(&compiler, &result);
+        std::unique_ptr<xla::LocalExecutable> executable;
+        if (status.ok()) {
+          status = cache->BuildExecutable(options_copy, result, &executable);
+        }
+        if (status.ok()) {
+          cache->MaybePersistHloModule(signature_copy, result);
+        } else {
+          LOG(WARNING) << "Asynchronous compilation of cluster " << name
+                       << " failed: " << status;
+        }
+
+        {
+          mutex_lock lock(entry->mu);
+          entry->compilation_status = status;
+          entry->compilation_result = std::move(result);
+          entry->executable = std::move(executable);
+          entry->compiled = true;
+          entry->compile_pending = false;
+        }
+
+        const uint64 compile_time_us = env->NowMicros() - compile_start_us;
+        mutex_lock lock(cache->cluster_compile_stats_mu_);
+        auto it = cache->cluster_compile_stats_.find(name);
+        it->second.compile_count++;
+        it->second.cumulative_compile_time_us += compile_time_us;
+        VLOG(1) << "asynchronously compiled " << name << " "
+                << it->second.compile_count
+                << " times, compile time: " << compile_time_us
+                << " us, cumulative: "
+                << it->second.cumulative_compile_time_us << " us";
+      });
 }
 
 Status XlaCompilationCache::CompileImpl(
@@ -224,7 +333,7 @@ Status XlaCompilationCache::CompileImpl(
     absl::Span<const XlaCompiler::Argument> args,
     const std::function<Status(XlaCompiler* compiler,
                                XlaCompiler::CompilationResult*)>& compile_fn,
-    absl::optional<int64> compile_threshold,
+    absl::optional<int64> compile_threshold, bool async_compilation,
     const XlaCompiler::CompilationResult** out_compilation_result,
     xla::LocalExecutable** out_executable) {
   DCHECK_NE(out_executable, nullptr);
@@ -264,7 +373,12 @@ Status XlaCompilationCache::CompileImpl(
   // excessive amount of shape dynamism.
   bool is_megamorphic;
 
+  // We also stop compiling clusters that have used up their compile budget, if
+  // the user set one via --tf_xla_max_compiles_per_cluster.
+  bool compile_budget_exhausted;
+
   {
+    int64 max_compiles = GetXlaOpsCommonFlags().tf_xla_max_compiles_per_cluster;
     mutex_lock lock(cluster_compile_stats_mu_);
     auto it =
         cluster_compile_stats_.emplace(function.name(), ClusterCompileStats{})
@@ -277,6 +391,9 @@ Status XlaCompilationCache::CompileImpl(
         IsMegamorphic(/*compile_count=*/it->second.compile_count,
                       /*execution_count=*/it->second.execution_count);
     is_megamorphic = it->second.is_megamorphic;
+
+    compile_budget_exhausted =
+        max_compiles > 0 && it->second.compile_count >= max_compiles;
   }
 
   // Acquire the cache entry lock and compile, if necessary.
@@ -289,6 +406,15 @@ Status XlaCompilationCache::CompileImpl(
           << current_request_count << " and compile threshold "
           << compile_threshold.value_or(0);
   if (!entry->compiled) {
+    if (entry->compile_pending) {
+      // An asynchronous compilation of this signature is in flight; keep
+      // using the fallback path until it lands.
+      VLOG(2) << "Asynchronous compilation pending for signature: "
+              << signature.HumanString();
+      *out_compilation_result = nullptr;
+      *out_executable = nullptr;
+      return Status::OK();
+    }
     const bool should_compile = [&] {
       if (!compile_threshold.has_value()) {
         // Lazy compilation is disabled.
@@ -301,6 +427,12 @@ Status XlaCompilationCache::CompileImpl(
         return false;
       }
 
+      if (compile_budget_exhausted) {
+        VLOG(3) << "Not compiling cluster " << function.name()
+                << " because it has exhausted its compile budget.";
+        return false;
+      }
+
       if (is_first_execution) {
         return true;
       }
@@ -324,6 +456,17 @@ Status XlaCompilationCache::CompileImpl(
       return Status::OK();
     }
 
+    if (async_compilation) {
+      VLOG(2) << "Scheduling asynchronous compilation for signature: "
+              << signature.HumanString();
+      entry->compile_pending = true;
+      ScheduleAsyncCompilation(entry, options, compile_fn, signature,
+                               function.name());
+      *out_compilation_result = nullptr;
+      *out_executable = nullptr;
+      return Status::OK();
+    }
+
     tensorflow::Env* env = tensorflow::Env::Default();
     const uint64 compile_start_us = env->NowMicros();
     // Do the actual JIT compilation without holding the lock (it can take
@@ -338,6 +481,9 @@ Status XlaCompilationCache::CompileImpl(
     CHECK_EQ(entry->executable.get(), nullptr);
     entry->compilation_status =
         BuildExecutable(options, entry->compilation_result, &entry->executable);
+    if (entry->compilation_status.ok()) {
+      MaybePersistHloModule(signature, entry->compilation_result);
+    }
 
     const uint64 compile_end_us = env->NowMicros();
     const uint64 compile_time_us = compile_end_us - compile_start_us;
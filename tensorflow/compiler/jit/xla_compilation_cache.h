@@ -49,6 +49,7 @@ class XlaCompilationCache : public ResourceBase {
   enum class CompileMode {
     kLazy,
     kStrict,
+    kAsync,
   };
 
   // Compiles a function into a XlaCompiler::CompilationResult that can be used
@@ -61,7 +62,11 @@ class XlaCompilationCache : public ResourceBase {
   // heuristics, the compilation cache may decide not to compile the cluster at
   // this time.  In this case it returns null into both `out_compilation_result`
   // and `out_executable`.  If `compile_mode` is `kStrict` then the compilation
-  // cache always attempts the compilation on a cache miss.
+  // cache always attempts the compilation on a cache miss.  If `compile_mode`
+  // is `kAsync` then, on a cache miss, the compilation runs on a background
+  // thread pool and null is returned into both outputs until the executable
+  // is ready, so the caller can fall back to executing the cluster through
+  // the TF executor in the meantime.
   //
   // The result of compilation is written to `*compilation_result`, which must
   // be non-null. If `executable` is non-null, also builds an
@@ -119,22 +124,44 @@ class XlaCompilationCache : public ResourceBase {
       absl::Span<const XlaCompiler::Argument> args);
 
  private:
-  // Common implementation of Compile and CompileSingleOp.
+  struct Entry;
+
+  // Common implementation of Compile and CompileSingleOp. If
+  // `async_compilation` is true then `compile_fn` must own all state it
+  // needs; it may run on a background thread after this call returns.
   Status CompileImpl(
       const XlaCompiler::Options& options, const NameAttrList& function,
       absl::Span<const XlaCompiler::Argument> args,
       const std::function<Status(XlaCompiler* compiler,
                                  XlaCompiler::CompilationResult*)>& compile_fn,
-      absl::optional<int64> compile_threshold,
+      absl::optional<int64> compile_threshold, bool async_compilation,
       const XlaCompiler::CompilationResult** out_compilation_result,
       xla::LocalExecutable** out_executable);
 
+  // Compiles `compile_fn` into `entry` on the async compilation thread pool,
+  // marking the entry compiled when done. Invoked with the entry in the
+  // compile-pending state.
+  void ScheduleAsyncCompilation(
+      Entry* entry, const XlaCompiler::Options& options,
+      const std::function<Status(XlaCompiler* compiler,
+                                 XlaCompiler::CompilationResult*)>& compile_fn,
+      const Signature& signature, const string& cluster_name);
+
   // Takes `result` which has been compiled from a Tensorflow subgraph to a
   // XLA computation already, and generates an XLA LocalExecutable `executable`.
   Status BuildExecutable(const XlaCompiler::Options& options,
                          const XlaCompiler::CompilationResult& result,
                          std::unique_ptr<xla::LocalExecutable>* executable);
 
+  // If the XLA_PERSISTENT_CACHE_DIR environment variable is set, writes the
+  // HLO module of `result` to <dir>/<device>_<signature hash>.hlo.pb.  This
+  // XLA version has no API for serializing a built LocalExecutable (or its
+  // backend object code), so the cache cannot be rehydrated directly; the
+  // persisted modules let warmup tooling compile the same clusters ahead of
+  // serving after a process restart.  Failures are logged, not returned.
+  void MaybePersistHloModule(const Signature& signature,
+                             const XlaCompiler::CompilationResult& result);
+
   xla::LocalClient* const client_;
   const DeviceType device_type_;
 
@@ -145,6 +172,11 @@ class XlaCompilationCache : public ResourceBase {
     // Have we tried compiling this entry?
     bool compiled = false;
 
+    // Is an asynchronous compilation of this entry in flight? Only one
+    // asynchronous compilation is scheduled per entry; callers fall back to
+    // the TF executor until it completes.
+    bool compile_pending = false;
+
     // The number of times a compilation with this signature has been requested.
     int64 request_count = 0;
 
@@ -189,6 +221,21 @@ class XlaCompilationCache : public ResourceBase {
   // signature before  we attempt to compile it.
   static constexpr int64 kDefaultCompilationThreshold = 2;
 
+  // Returns the thread pool used for asynchronous compilation, creating it on
+  // first use.
+  thread::ThreadPool* async_compiler_threads();
+
+  // The number of threads used for asynchronous compilation.
+  static constexpr int kNumAsyncCompilerThreads = 2;
+
+  mutex async_compiler_threads_mu_;
+
+  // Thread pool for asynchronous compilation; lazily created, and declared
+  // last so it is destroyed (joining in-flight compilations) before the cache
+  // entries they write to.
+  std::unique_ptr<thread::ThreadPool> async_compiler_threads_
+      GUARDED_BY(async_compiler_threads_mu_);
+
   TF_DISALLOW_COPY_AND_ASSIGN(XlaCompilationCache);
 };
 
@@ -31,8 +31,11 @@ limitations under the License.
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/lib/core/refcount.h"
+#include "tensorflow/core/lib/io/path.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/stream_executor.h"
@@ -99,6 +102,24 @@ class TRTEngineOp : public AsyncOpKernel {
       const std::vector<TensorShape>& actual_input_shapes,
       std::vector<TensorShape>* engine_input_shapes);
 
+  // Return the file under which an engine built for engine_input_shapes is
+  // persisted across processes, or an empty string if persistence is disabled
+  // (TF_TRT_ENGINE_CACHE_DIR is unset).
+  string GetEngineCacheFilename(
+      const std::vector<TensorShape>& engine_input_shapes) const;
+
+  // Try to deserialize a previously persisted engine for engine_input_shapes.
+  // Returns nullptr if there is none or deserialization fails.
+  TrtUniquePtrType<nvinfer1::ICudaEngine> MaybeLoadSerializedEngine(
+      const std::vector<TensorShape>& engine_input_shapes,
+      nvinfer1::IGpuAllocator* allocator);
+
+  // Persist a freshly built engine so that future processes can deserialize
+  // it instead of rebuilding it.
+  void MaybeSaveSerializedEngine(
+      const std::vector<TensorShape>& engine_input_shapes,
+      nvinfer1::ICudaEngine* engine);
+
   std::vector<string> input_nodes_;
   std::vector<string> output_nodes_;
 
@@ -137,6 +158,10 @@ class TRTEngineOp : public AsyncOpKernel {
   // If true, create calibration graph for INT8 mode. Otherwise, we are using
   // user-provided quantization ranges.
   bool use_calibration_;
+
+  // Fingerprint of the serialized segment (and calibration data, if any),
+  // used to key persisted engines.
+  uint64 segment_fingerprint_ = 0;
 };
 
 #define TYPECASE(dt, X, Y)                                    \
@@ -197,6 +222,7 @@ TRTEngineOp::TRTEngineOp(OpKernelConstruction* context)
           errors::InvalidArgument("Failed to parse segment graphdef!"));
       return;
     }
+    segment_fingerprint_ = Fingerprint64(serialized_segment_);
     serialized_segment_.resize(0);
   }
   VLOG(1) << "Constructing " << name();
@@ -217,6 +243,10 @@ TRTEngineOp::TRTEngineOp(OpKernelConstruction* context)
        calibration_data.empty());
   if (!calibration_data.empty()) {
     calibrator_.reset(new TRTInt8Calibrator(calibration_data));
+    // Engines built for INT8 depend on the calibration table, so mix it into
+    // the fingerprint used to key persisted engines.
+    segment_fingerprint_ =
+        FingerprintCat64(segment_fingerprint_, Fingerprint64(calibration_data));
     calibration_data.resize(0);
   }
   native_func_ = kInvalidHandle;
@@ -503,6 +533,83 @@ bool TRTEngineOp::ExecuteTrtEngine(OpKernelContext* ctx,
   return !kRetry;
 }
 
+string TRTEngineOp::GetEngineCacheFilename(
+    const std::vector<TensorShape>& engine_input_shapes) const {
+  const char* dir = getenv("TF_TRT_ENGINE_CACHE_DIR");
+  if (dir == nullptr) {
+    return "";
+  }
+  string precision_name;
+  if (!TrtPrecisionModeToName(precision_mode_, &precision_name).ok()) {
+    return "";
+  }
+  // Serialized engines are not portable across segments, build parameters or
+  // TensorRT versions, so key the file on all of them.
+  const uint64 key = Fingerprint64(
+      StrCat(segment_fingerprint_, "|", precision_name, "|", workspace_size_,
+             "|", TensorShapeUtils::ShapeListString(engine_input_shapes), "|",
+             NV_TENSORRT_MAJOR, ".", NV_TENSORRT_MINOR, ".",
+             NV_TENSORRT_PATCH));
+  return io::JoinPath(dir, StrCat("trt_", absl::Hex(key), ".engine"));
+}
+
+TrtUniquePtrType<nvinfer1::ICudaEngine> TRTEngineOp::MaybeLoadSerializedEngine(
+    const std::vector<TensorShape>& engine_input_shapes,
+    nvinfer1::IGpuAllocator* allocator) {
+  const string filename = GetEngineCacheFilename(engine_input_shapes);
+  if (filename.empty()) {
+    return nullptr;
+  }
+  string serialized_engine;
+  if (!ReadFileToString(Env::Default(), filename, &serialized_engine).ok()) {
+    VLOG(1) << "No persisted TensorRT engine found at " << filename;
+    return nullptr;
+  }
+  TrtUniquePtrType<IRuntime> infer(nvinfer1::createInferRuntime(logger));
+  infer->setGpuAllocator(allocator);
+  TrtUniquePtrType<nvinfer1::ICudaEngine> engine(infer->deserializeCudaEngine(
+      serialized_engine.c_str(), serialized_engine.size(),
+      PluginFactoryTensorRT::GetInstance()));
+  if (!engine) {
+    LOG(WARNING) << "Failed to deserialize persisted TensorRT engine from "
+                 << filename << ", rebuilding it.";
+    return nullptr;
+  }
+  LOG(INFO) << "Loaded TensorRT engine for " << name() << " input shapes: "
+            << TensorShapeUtils::ShapeListString(engine_input_shapes)
+            << " from " << filename;
+  return engine;
+}
+
+void TRTEngineOp::MaybeSaveSerializedEngine(
+    const std::vector<TensorShape>& engine_input_shapes,
+    nvinfer1::ICudaEngine* engine) {
+  const string filename = GetEngineCacheFilename(engine_input_shapes);
+  if (filename.empty()) {
+    return;
+  }
+  TrtUniquePtrType<nvinfer1::IHostMemory> serialized(engine->serialize());
+  if (!serialized) {
+    LOG(WARNING) << "Failed to serialize TensorRT engine for " << name();
+    return;
+  }
+  Env* env = Env::Default();
+  Status status = env->RecursivelyCreateDir(string(io::Dirname(filename)));
+  if (status.ok()) {
+    status = WriteStringToFile(
+        env, filename,
+        StringPiece(static_cast<const char*>(serialized->data()),
+                    serialized->size()));
+  }
+  if (status.ok()) {
+    VLOG(1) << "Persisted TensorRT engine for " << name() << " to "
+            << filename;
+  } else {
+    LOG(WARNING) << "Failed to persist TensorRT engine for " << name() << ": "
+                 << status;
+  }
+}
+
 EngineContext* TRTEngineOp::GetEngine(
     const std::vector<TensorShape>& input_shapes, OpKernelContext* ctx) {
   static EngineContext empty_context;
@@ -591,34 +698,41 @@ EngineContext* TRTEngineOp::GetEngine(
   }
 
   if (!cache.count(engine_input_shapes)) {
-    TrtUniquePtrType<nvinfer1::ICudaEngine> engine;
-    bool convert_successfully = false;
-    LOG(INFO) << "Building a new TensorRT engine for " << name()
-              << " input shapes: "
-              << TensorShapeUtils::ShapeListString(engine_input_shapes);
-
-    // Convert to partial shapes
-    std::vector<PartialTensorShape> partial_shapes(engine_input_shapes.begin(),
-                                                   engine_input_shapes.end());
-
-    // Up to this point, calibrator_ can never be empty, since otherwise it
-    // means calibration_mode_ is true and this path won't get executed.
-    auto status = convert::ConvertGraphDefToEngine(
-        segment_graph_, precision_mode_, batch_size, workspace_size_,
-        partial_shapes, &logger, allocator, calibrator_.get(), &engine,
-        use_calibration_, &convert_successfully);
-    if (!status.ok()) {
-      if (convert_successfully) {
-        // This means it fail to build the engine even when the network is built
-        // successfully, probably due to internal issues. In this case we don't
-        // retry in the future.
-        cache.emplace(engine_input_shapes, absl::make_unique<EngineContext>());
+    // If a previous process persisted an engine for this segment and these
+    // shapes, deserialize it instead of rebuilding it from scratch.
+    TrtUniquePtrType<nvinfer1::ICudaEngine> engine =
+        MaybeLoadSerializedEngine(engine_input_shapes, allocator);
+    if (!engine) {
+      bool convert_successfully = false;
+      LOG(INFO) << "Building a new TensorRT engine for " << name()
+                << " input shapes: "
+                << TensorShapeUtils::ShapeListString(engine_input_shapes);
+
+      // Convert to partial shapes
+      std::vector<PartialTensorShape> partial_shapes(
+          engine_input_shapes.begin(), engine_input_shapes.end());
+
+      // Up to this point, calibrator_ can never be empty, since otherwise it
+      // means calibration_mode_ is true and this path won't get executed.
+      auto status = convert::ConvertGraphDefToEngine(
+          segment_graph_, precision_mode_, batch_size, workspace_size_,
+          partial_shapes, &logger, allocator, calibrator_.get(), &engine,
+          use_calibration_, &convert_successfully);
+      if (!status.ok()) {
+        if (convert_successfully) {
+          // This means it fail to build the engine even when the network is
+          // built successfully, probably due to internal issues. In this case
+          // we don't retry in the future.
+          cache.emplace(engine_input_shapes,
+                        absl::make_unique<EngineContext>());
+        }
+        LOG(WARNING) << "Engine creation for batch size " << batch_size
+                     << " failed " << status;
+        return &empty_context;
       }
-      LOG(WARNING) << "Engine creation for batch size " << batch_size
-                   << " failed " << status;
-      return &empty_context;
+      VLOG(1) << "Conversion is done";
+      MaybeSaveSerializedEngine(engine_input_shapes, engine.get());
     }
-    VLOG(1) << "Conversion is done";
     TrtUniquePtrType<nvinfer1::IExecutionContext> exec_context(
         engine->createExecutionContext());
     cache.emplace(engine_input_shapes,
@@ -261,6 +261,32 @@ static void AllocateFlags() {
                        flag_values->mutable_xla_dump_per_pass_hlo_proto_to(),
                        "Dump HLO after each pass as an HloProto in binary file "
                        "format into this directory."),
+      tensorflow::Flag("xla_dump_pass_telemetry_to",
+                       flag_values->mutable_xla_dump_pass_telemetry_to(),
+                       "Dump per-pass compilation telemetry (wall time, HLO "
+                       "instruction-count delta, resident memory) as CSV "
+                       "files into this directory."),
+      tensorflow::Flag(
+          "xla_computation_local_pass_parallelism",
+          int32_setter_for(
+              &DebugOptions::set_xla_computation_local_pass_parallelism),
+          flag_values->xla_computation_local_pass_parallelism(),
+          "Number of threads computation-local HLO passes may use to rewrite "
+          "independent computations of a module concurrently. Values of zero "
+          "or one mean serial execution."),
+      tensorflow::Flag(
+          "xla_gpu_multi_stream_library_calls",
+          bool_setter_for(
+              &DebugOptions::set_xla_gpu_multi_stream_library_calls),
+          flag_values->xla_gpu_multi_stream_library_calls(),
+          "Spread concurrent GPU library calls (convolutions and FFTs, in "
+          "addition to GEMMs) across streams. Has no effect when "
+          "xla_gpu_disable_multi_streaming is set."),
+      tensorflow::Flag(
+          "xla_gpu_fusion_profile_file",
+          flag_values->mutable_xla_gpu_fusion_profile_file(),
+          "Path to a file listing fingerprints of GPU fusions measured to be "
+          "unprofitable, one per line. Listed fusions are not performed."),
       tensorflow::Flag(
           "xla_test_all_output_layouts",
           bool_setter_for(&DebugOptions::set_xla_test_all_output_layouts),
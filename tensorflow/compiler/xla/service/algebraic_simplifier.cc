@@ -3700,17 +3700,13 @@ Status AlgebraicSimplifierVisitor::HandleMap(HloInstruction* map) {
   return ReplaceWithNewInstruction(map, std::move(clone));
 }
 
-StatusOr<bool> AlgebraicSimplifier::Run(HloModule* module) {
-  XLA_VLOG_LINES(2,
-                 "AlgebraicSimplifier::Run(), before:\n" + module->ToString());
-  bool changed = false;
-  for (auto* comp : module->MakeNonfusionComputations()) {
-    if (AlgebraicSimplifierVisitor::Run(comp, options_)) {
-      changed = true;
-    }
-  }
-  XLA_VLOG_LINES(2,
-                 "AlgebraicSimplifier::Run(), after:\n" + module->ToString());
+StatusOr<bool> AlgebraicSimplifier::RunOnComputation(
+    HloComputation* computation) {
+  XLA_VLOG_LINES(2, "AlgebraicSimplifier::RunOnComputation(), before:\n" +
+                        computation->ToString());
+  const bool changed = AlgebraicSimplifierVisitor::Run(computation, options_);
+  XLA_VLOG_LINES(2, "AlgebraicSimplifier::RunOnComputation(), after:\n" +
+                        computation->ToString());
   return changed;
 }
 
@@ -211,6 +211,41 @@ TEST_F(CpuLayoutAssignmentTest, DotWithConstantLhsTensor) {
   }
 }
 
+TEST_F(CpuLayoutAssignmentTest, MatrixVectorDotWithConstantLhsTensor) {
+  // A constant matrix in a matrix-vector product is made column major so that
+  // the GEMV emitter can use unit-stride vector loads.
+  auto builder = HloComputation::Builder(TestName());
+  Shape lhs_shape = ShapeUtil::MakeShape(F32, {24, 12});
+  Shape rhs_shape = ShapeUtil::MakeShapeWithLayout(F32, {12, 1}, {0, 1});
+  Shape result_shape = ShapeUtil::MakeShapeWithLayout(F32, {24, 1}, {0, 1});
+  auto dot_lhs = builder.AddInstruction(
+      HloInstruction::CreateConstant(Literal::CreateFromShape(lhs_shape)));
+  auto dot_rhs = builder.AddInstruction(
+      HloInstruction::CreateParameter(0, rhs_shape, "param0"));
+  auto dot_result = builder.AddInstruction(
+      CreateCanonicalDot(result_shape, dot_lhs, dot_rhs));
+
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation = module->AddEntryComputation(builder.Build());
+
+  ComputationLayout computation_layout(computation->ComputeProgramShape());
+  *computation_layout.mutable_parameter_layout(0) =
+      ShapeLayout(LayoutUtil::GetWithDefaultLayout(rhs_shape));
+  *computation_layout.mutable_result_layout() =
+      ShapeLayout(LayoutUtil::GetWithDefaultLayout(result_shape));
+  AssignLayouts(module.get(), &computation_layout);
+
+  EXPECT_TRUE(LayoutUtil::Equal(LayoutUtil::MakeLayout({0, 1}),
+                                dot_lhs->shape().layout()));
+  EXPECT_TRUE(LayoutUtil::Equal(LayoutUtil::MakeLayout({1, 0}),
+                                dot_rhs->shape().layout()));
+  EXPECT_TRUE(LayoutUtil::Equal(LayoutUtil::MakeLayout({1, 0}),
+                                dot_result->shape().layout()));
+  for (const auto& instruction : computation->instructions()) {
+    EXPECT_NE(instruction->opcode(), HloOpcode::kCopy);
+  }
+}
+
 TEST_F(CpuLayoutAssignmentTest, DotWithConstantRhsTensorThroughGTE) {
   // This is a case we could theoretically optimize at some point, but today we
   // don't.
@@ -26,6 +26,8 @@ const char* const kLlvmIrDotTilingFactor = "xla_llvm_dot_tiling_factor";
 const char* const kXlaForceEnableExperimentalLlvmIrGemm =
     "xla_force_enable_experimental_llvm_ir_gemm";
 const char* const kLlvmIrGemmTileSize = "xla_llvm_ir_gemm_tile_size";
+const char* const kXlaCpuParallelTaskProfileFile =
+    "xla_cpu_parallel_task_profile_file";
 
 }  // namespace
 
@@ -99,6 +101,16 @@ absl::optional<std::tuple<int64, int64, int64>> LlvmIrGemmTileSize(
                                          tile_size_n_in_vector_width);
 }
 
+absl::optional<string> ParallelTaskProfileFile(const HloModuleConfig& config) {
+  const auto& extra_options_map =
+      config.debug_options().xla_backend_extra_options();
+  auto it = extra_options_map.find(kXlaCpuParallelTaskProfileFile);
+  if (it == extra_options_map.end()) {
+    return absl::nullopt;
+  }
+  return it->second;
+}
+
 }  // namespace options
 }  // namespace cpu
 }  // namespace xla
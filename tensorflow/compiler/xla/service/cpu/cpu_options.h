@@ -30,6 +30,7 @@ bool ForceEnableExperimentalLlvmIrGemm(const HloModuleConfig& config);
 absl::optional<int64> LlvmIrGemvTilingFactor(const HloModuleConfig& config);
 absl::optional<std::tuple<int64, int64, int64>> LlvmIrGemmTileSize(
     const HloModuleConfig& config);
+absl::optional<string> ParallelTaskProfileFile(const HloModuleConfig& config);
 
 }  // namespace options
 }  // namespace cpu
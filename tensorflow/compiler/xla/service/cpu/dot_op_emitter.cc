@@ -712,11 +712,27 @@ DotOpEmitter::MatMultDims DotOpEmitter::GetMatMultDims() const {
 // column major.
 absl::optional<int64> ProfitableToMakeDotOperandColumnMajor(
     const HloInstruction& hlo) {
-  if (hlo.opcode() == HloOpcode::kDot && hlo.shape().dimensions_size() == 2 &&
-      hlo.shape().dimensions(0) == 1) {
-    if (hlo.dot_dimension_numbers().rhs_contracting_dimensions(0) == 0) {
-      return 1;
+  if (hlo.opcode() == HloOpcode::kDot && hlo.shape().dimensions_size() == 2) {
+    if (hlo.shape().dimensions(0) == 1) {
+      if (hlo.dot_dimension_numbers().rhs_contracting_dimensions(0) == 0) {
+        return 1;
+      }
+      return {};
     }
+
+    // Matrix-vector products are lowered to the tiled GEMV emitter, which
+    // accepts the matrix in either layout.  A column major matrix lets it
+    // accumulate into the result with unit-stride vector loads instead of a
+    // horizontal reduction per output element, and if the matrix is a
+    // constant (e.g. an ahead-of-time compiled weight) the transposition is
+    // paid for once at compile time.
+    if (hlo.shape().dimensions(1) == 1) {
+      if (hlo.dot_dimension_numbers().lhs_contracting_dimensions(0) == 1) {
+        return 0;
+      }
+      return {};
+    }
+
     return {};
   }
 
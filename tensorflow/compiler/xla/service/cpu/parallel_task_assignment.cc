@@ -15,14 +15,21 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/cpu/parallel_task_assignment.h"
 
+#include <unordered_map>
+
 #include "absl/memory/memory.h"
+#include "absl/strings/numbers.h"
 #include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
+#include "tensorflow/compiler/xla/service/cpu/cpu_options.h"
 #include "tensorflow/compiler/xla/service/cpu/dot_op_emitter.h"
 #include "tensorflow/compiler/xla/service/cpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/cpu/shape_partition.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_opcode.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+#include "tensorflow/core/platform/env.h"
 
 namespace xla {
 namespace cpu {
@@ -104,6 +111,64 @@ class DefaultCostModel : public ParallelCostModel {
   const std::unique_ptr<HloCostAnalysis> cost_analysis_;
 };
 
+// Cost model backed by per-shape costs measured offline (e.g. from kernel
+// microbenchmarks of a profiled run), supplied as a file via the
+// "xla_cpu_parallel_task_profile_file" backend option. Instructions without
+// a measured entry fall back to 'fallback_model'.
+class MeasuredCostModel : public ParallelCostModel {
+ public:
+  MeasuredCostModel(const int64 max_parallelism,
+                    std::unordered_map<string, int64> measured_usecs,
+                    std::unique_ptr<ParallelCostModel> fallback_model)
+      : max_parallelism_(max_parallelism),
+        measured_usecs_(std::move(measured_usecs)),
+        fallback_model_(std::move(fallback_model)) {}
+  ~MeasuredCostModel() override {}
+
+  // Returns the profile key for 'instruction': its opcode and shape, e.g.
+  // "add f32[1024,1024]".
+  static string ProfileKey(const HloInstruction* instruction) {
+    return absl::StrCat(HloOpcodeString(instruction->opcode()), " ",
+                        ShapeUtil::HumanString(instruction->shape()));
+  }
+
+  // Parses profile file contents with one "<usecs> <opcode> <shape>" entry
+  // per line. Malformed lines are skipped.
+  static std::unordered_map<string, int64> ParseProfile(
+      const string& contents) {
+    std::unordered_map<string, int64> measured_usecs;
+    for (absl::string_view line : absl::StrSplit(contents, '\n')) {
+      std::pair<absl::string_view, absl::string_view> parts =
+          absl::StrSplit(line, absl::MaxSplits(' ', 1));
+      int64 usecs;
+      if (parts.second.empty() || !absl::SimpleAtoi(parts.first, &usecs)) {
+        continue;
+      }
+      measured_usecs[string(parts.second)] = usecs;
+    }
+    return measured_usecs;
+  }
+
+  int64 GetParallelTaskCount(HloInstruction* instruction) override {
+    auto it = measured_usecs_.find(ProfileKey(instruction));
+    if (it == measured_usecs_.end()) {
+      return fallback_model_->GetParallelTaskCount(instruction);
+    }
+    // Size shards so each runs for roughly 'kMinUsecsPerTask', which
+    // amortizes thread wakeup and fork-join overhead. Measured costs already
+    // reflect memory-bound behavior, so unlike the default model no
+    // sub-linear I/O-bound cap is applied here.
+    const int64 kMinUsecsPerTask = 100;
+    return std::min(max_parallelism_,
+                    std::max(int64{1}, it->second / kMinUsecsPerTask));
+  }
+
+ private:
+  const int64 max_parallelism_;
+  const std::unordered_map<string, int64> measured_usecs_;
+  const std::unique_ptr<ParallelCostModel> fallback_model_;
+};
+
 ParallelTaskAssignment::ParallelTaskAssignment(
     const int64 max_parallelism,
     const HloCostAnalysis::ShapeSizeFunction& shape_size, HloModule* module,
@@ -124,6 +189,25 @@ ParallelTaskAssignment::ParallelTaskAssignment(
     // HLOs like CustomCall are not yet implemented in the HloCostAnalysis).
     cost_model_.reset(new SimpleCostModel(max_parallelism, shape_size));
   }
+  // Overlay measured per-shape costs on the cost model chosen above, if a
+  // profile file was provided.
+  absl::optional<string> profile_file =
+      options::ParallelTaskProfileFile(module->config());
+  if (profile_file) {
+    string contents;
+    Status read_status = tensorflow::ReadFileToString(
+        tensorflow::Env::Default(), *profile_file, &contents);
+    if (read_status.ok()) {
+      std::unique_ptr<ParallelCostModel> fallback_model =
+          std::move(cost_model_);
+      cost_model_.reset(new MeasuredCostModel(
+          max_parallelism, MeasuredCostModel::ParseProfile(contents),
+          std::move(fallback_model)));
+    } else {
+      LOG(WARNING) << "Could not read parallel task profile '" << *profile_file
+                   << "': " << read_status.error_message();
+    }
+  }
 }
 
 int64 ParallelTaskAssignment::GetTargetParallelTaskCount(
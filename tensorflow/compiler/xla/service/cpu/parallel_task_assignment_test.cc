@@ -19,6 +19,9 @@ limitations under the License.
 #include "tensorflow/compiler/xla/test.h"
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
 
 namespace xla {
 namespace {
@@ -108,6 +111,41 @@ TEST_F(ParallelTaskAssignmentTest, RngOperationNotParallelized) {
   EXPECT_FALSE(changed);
 }
 
+TEST_F(ParallelTaskAssignmentTest, MeasuredCostProfileOverridesCostModel) {
+  const string hlo_string = R"(
+    HloModule TestTaskParallel_MeasuredProfile
+    ENTRY Add {
+      lhs = f32[128,4]{1,0} parameter(0)
+      rhs = f32[128,4]{1,0} parameter(1)
+      ROOT add = f32[128,4]{1,0} add(lhs, rhs)
+    }
+  )";
+
+  // Without a measured profile the add is too small to shard.
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> m,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, RunParallelTaskAssigner(m.get()));
+  EXPECT_FALSE(changed);
+
+  // With a measured cost of 100ms for its opcode and shape, the add is
+  // sharded into parallel tasks.
+  const string profile_file = tensorflow::io::JoinPath(
+      tensorflow::testing::TmpDir(), "parallel_task_profile");
+  TF_ASSERT_OK(tensorflow::WriteStringToFile(
+      tensorflow::Env::Default(), profile_file, "100000 add f32[128,4]\n"));
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> profiled_module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  HloModuleConfig config = profiled_module->config();
+  DebugOptions debug_options = config.debug_options();
+  (*debug_options.mutable_xla_backend_extra_options())
+      ["xla_cpu_parallel_task_profile_file"] = profile_file;
+  config.set_debug_options(debug_options);
+  profiled_module->set_config(config);
+  TF_ASSERT_OK_AND_ASSIGN(bool profiled_changed,
+                          RunParallelTaskAssigner(profiled_module.get()));
+  EXPECT_TRUE(profiled_changed);
+}
+
 TEST_F(ParallelTaskAssignmentTest, InfeedOutfeedOperationNotParallelized) {
   const string hlo_string = R"(
     HloModule TestTaskParallel_infeed_outfeed
@@ -0,0 +1,53 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/buffer_coloring.h"
+
+#include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/tuple_points_to_analysis.h"
+#include "tensorflow/compiler/xla/shape_util.h"
+
+namespace xla {
+namespace gpu {
+
+const LogicalBuffer::Color kConvWorkspaceColor(1);
+
+namespace {
+
+// Returns whether `buffer` is the scratch buffer of a convolution
+// custom-call, i.e. the second element of its (result, scratch) output tuple.
+bool IsConvWorkspaceBuffer(const LogicalBuffer& buffer) {
+  return IsCustomCallToDnnConvolution(*buffer.instruction()) &&
+         buffer.index() == ShapeIndex({1});
+}
+
+}  // namespace
+
+BufferLiveness::Colorer ConvWorkspaceColorer() {
+  return [](const BufferLiveness& buffer_liveness) {
+    for (LogicalBuffer::Id id = 0;
+         id < buffer_liveness.points_to_analysis().num_logical_buffers();
+         id++) {
+      auto& buffer = buffer_liveness.points_to_analysis().logical_buffer(id);
+      buffer.set_color(IsConvWorkspaceBuffer(buffer) ? kConvWorkspaceColor
+                                                     : LogicalBuffer::Color(0));
+    }
+    return Status::OK();
+  };
+}
+
+}  // namespace gpu
+}  // namespace xla
@@ -0,0 +1,42 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_BUFFER_COLORING_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_BUFFER_COLORING_H_
+
+#include "tensorflow/compiler/xla/service/buffer_liveness.h"
+#include "tensorflow/compiler/xla/service/logical_buffer.h"
+
+namespace xla {
+namespace gpu {
+
+// Color assigned to the scratch (workspace) buffers of cudnn/MIOpen
+// convolution custom-calls.
+extern const LogicalBuffer::Color kConvWorkspaceColor;
+
+// Returns a buffer-liveness colorer which assigns kConvWorkspaceColor to
+// convolution workspace buffers and the default color to everything else.
+//
+// Buffer assignment heap-simulates each color separately and combines the
+// result into one allocation per color, so workspaces whose live ranges do
+// not overlap share a single arena sized by the largest workspace instead of
+// each convolution holding on to its own. The convolution thunks need no
+// changes: their scratch slices become offsets into the shared arena.
+BufferLiveness::Colorer ConvWorkspaceColorer();
+
+}  // namespace gpu
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_GPU_BUFFER_COLORING_H_
@@ -0,0 +1,97 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/gpu/buffer_coloring.h"
+
+#include "absl/memory/memory.h"
+#include "tensorflow/compiler/xla/service/buffer_liveness.h"
+#include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_ordering.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+
+namespace xla {
+namespace gpu {
+namespace {
+
+class BufferColoringTest : public HloTestBase {
+ protected:
+  const HloInstruction* FindInstruction(HloModule* module,
+                                        absl::string_view name) {
+    for (const HloInstruction* instruction :
+         module->entry_computation()->instructions()) {
+      if (instruction->name() == name) {
+        return instruction;
+      }
+    }
+    return nullptr;
+  }
+};
+
+TEST_F(BufferColoringTest, ColorsConvWorkspaces) {
+  const char* const hlo_string = R"(
+    HloModule TestConvWorkspaceColoring
+    ENTRY Convs {
+      input = f32[1,4,4,1]{3,2,1,0} parameter(0)
+      filter = f32[2,2,1,1]{3,2,1,0} parameter(1)
+      conv0 = (f32[1,4,4,1]{3,2,1,0}, u8[128]{0}) custom-call(input, filter),
+        custom_call_target="__cudnn$convForward"
+      gte0 = f32[1,4,4,1]{3,2,1,0} get-tuple-element(conv0), index=0
+      conv1 = (f32[1,4,4,1]{3,2,1,0}, u8[256]{0}) custom-call(gte0, filter),
+        custom_call_target="__cudnn$convForward"
+      ROOT gte1 = f32[1,4,4,1]{3,2,1,0} get-tuple-element(conv1), index=0
+    }
+  )";
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<HloModule> module,
+                          ParseAndReturnVerifiedModule(hlo_string));
+  TF_ASSERT_OK_AND_ASSIGN(
+      std::unique_ptr<BufferLiveness> liveness,
+      BufferLiveness::Run(module.get(), absl::make_unique<DependencyHloOrdering>(
+                                            module.get())));
+  TF_ASSERT_OK(ConvWorkspaceColorer()(*liveness));
+
+  const TuplePointsToAnalysis& points_to = liveness->points_to_analysis();
+  for (const char* conv_name : {"conv0", "conv1"}) {
+    const HloInstruction* conv = FindInstruction(module.get(), conv_name);
+    ASSERT_NE(conv, nullptr);
+    // The workspace (tuple element 1) takes the dedicated workspace color;
+    // the result and the tuple itself keep the default color.
+    TF_ASSERT_OK_AND_ASSIGN(const LogicalBuffer* workspace,
+                            points_to.GetBufferDefinedAt(conv, {1}));
+    EXPECT_EQ(workspace->color(), kConvWorkspaceColor);
+    TF_ASSERT_OK_AND_ASSIGN(const LogicalBuffer* result,
+                            points_to.GetBufferDefinedAt(conv, {0}));
+    EXPECT_EQ(result->color(), LogicalBuffer::Color(0));
+    TF_ASSERT_OK_AND_ASSIGN(const LogicalBuffer* tuple,
+                            points_to.GetBufferDefinedAt(conv, {}));
+    EXPECT_EQ(tuple->color(), LogicalBuffer::Color(0));
+  }
+
+  // Buffers of other instructions are untouched.
+  const HloInstruction* gte0 = FindInstruction(module.get(), "gte0");
+  ASSERT_NE(gte0, nullptr);
+  for (LogicalBuffer::Id id = 0; id < points_to.num_logical_buffers(); id++) {
+    const LogicalBuffer& buffer = points_to.logical_buffer(id);
+    if (!IsCustomCallToDnnConvolution(*buffer.instruction())) {
+      EXPECT_EQ(buffer.color(), LogicalBuffer::Color(0));
+    }
+  }
+}
+
+}  // namespace
+}  // namespace gpu
+}  // namespace xla
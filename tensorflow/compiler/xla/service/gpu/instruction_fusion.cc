@@ -16,12 +16,17 @@ limitations under the License.
 #include "tensorflow/compiler/xla/service/gpu/instruction_fusion.h"
 
 #include "absl/container/flat_hash_set.h"
+#include "absl/strings/numbers.h"
+#include "absl/strings/str_cat.h"
+#include "absl/strings/str_split.h"
 #include "tensorflow/compiler/xla/service/gpu/gpu_fusible.h"
 #include "tensorflow/compiler/xla/service/gpu/ir_emission_utils.h"
 #include "tensorflow/compiler/xla/service/hlo_opcode.h"
 #include "tensorflow/compiler/xla/service/pattern_matcher.h"
 #include "tensorflow/compiler/xla/shape_util.h"
 #include "tensorflow/compiler/xla/xla_data.pb.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 
 namespace xla {
 namespace gpu {
@@ -77,6 +82,45 @@ bool IsIEEEFloatingPointScalarConstant(const HloInstruction* constant) {
   }
 }
 
+/*static*/ uint64 GpuInstructionFusion::FusionFingerprint(
+    const HloInstruction* producer, const HloInstruction* consumer) {
+  auto print_options = HloPrintOptions::Canonical();
+  return tensorflow::Fingerprint64(
+      absl::StrCat(producer->ToString(print_options), " => ",
+                   consumer->ToString(print_options)));
+}
+
+StatusOr<bool> GpuInstructionFusion::Run(HloModule* module) {
+  fusions_to_skip_.clear();
+  const string& profile_file =
+      module->config().debug_options().xla_gpu_fusion_profile_file();
+  if (!profile_file.empty()) {
+    string profile;
+    Status status = tensorflow::ReadFileToString(tensorflow::Env::Default(),
+                                                 profile_file, &profile);
+    if (!status.ok()) {
+      LOG(WARNING) << "Could not read fusion profile file " << profile_file
+                   << ": " << status.error_message()
+                   << "; all fusion decisions fall back to the heuristics.";
+    } else {
+      // Each line names the fingerprint of one unprofitable fusion; anything
+      // after the fingerprint is a free-form comment. Malformed lines are
+      // skipped.
+      for (absl::string_view line : absl::StrSplit(profile, '\n')) {
+        std::pair<absl::string_view, absl::string_view> fields =
+            absl::StrSplit(line, absl::MaxSplits(' ', 1));
+        uint64 fingerprint;
+        if (absl::SimpleAtoi(fields.first, &fingerprint)) {
+          fusions_to_skip_.insert(fingerprint);
+        }
+      }
+      VLOG(1) << "Loaded " << fusions_to_skip_.size()
+              << " fusion fingerprints to skip from " << profile_file;
+    }
+  }
+  return InstructionFusion::Run(module);
+}
+
 // This function limits the maximum number of operands to a fusion.
 //
 // There's a cap on how many parameters we can pass to a CUDA kernel, but
@@ -142,6 +186,14 @@ bool GpuInstructionFusion::ShouldFuse(HloInstruction* consumer,
                                       int64 operand_index) {
   HloInstruction* producer = consumer->mutable_operand(operand_index);
 
+  // Respect measured fusion decisions before consulting the heuristics.
+  if (!fusions_to_skip_.empty() &&
+      fusions_to_skip_.contains(FusionFingerprint(producer, consumer))) {
+    VLOG(2) << "Not fusing " << producer->name() << " into "
+            << consumer->name() << ": listed in the fusion profile.";
+    return false;
+  }
+
   // Check if we can use output fusion for (A @ B) * alpha
   if (producer->opcode() == HloOpcode::kDot ||
       (producer->opcode() == HloOpcode::kFusion &&
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_SERVICE_GPU_INSTRUCTION_FUSION_H_
 #define TENSORFLOW_COMPILER_XLA_SERVICE_GPU_INSTRUCTION_FUSION_H_
 
+#include "absl/container/flat_hash_set.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/instruction_fusion.h"
 
@@ -42,6 +43,19 @@ class GpuInstructionFusion : public InstructionFusion {
 
   static bool IsExpensive(const HloInstruction& instruction);
 
+  // Returns a fingerprint identifying the fusion of `producer` into
+  // `consumer`. The fingerprint is computed from the canonical form of the
+  // two instructions, so it is stable across runs and instruction renames.
+  // It keys the entries of the fusion profile file (see
+  // --xla_gpu_fusion_profile_file).
+  static uint64 FusionFingerprint(const HloInstruction* producer,
+                                  const HloInstruction* consumer);
+
+  // Loads the fusion profile file named by the module's debug options, if
+  // any, before running fusion. Fusions whose fingerprints are listed in the
+  // profile are not performed.
+  StatusOr<bool> Run(HloModule* module) override;
+
   bool ShouldFuse(HloInstruction* consumer, int64 operand_index) override;
 
   bool ShouldFuseIntoMultiOutput(HloInstruction* consumer,
@@ -49,6 +63,11 @@ class GpuInstructionFusion : public InstructionFusion {
 
   HloInstruction::FusionKind ChooseKind(
       const HloInstruction* producer, const HloInstruction* consumer) override;
+
+ private:
+  // Fingerprints of fusions measured to be unprofitable, loaded from the
+  // fusion profile file at the start of Run().
+  absl::flat_hash_set<uint64> fusions_to_skip_;
 };
 
 }  // namespace gpu
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/compiler/xla/service/gpu/instruction_fusion.h"
 
+#include "absl/strings/str_cat.h"
 #include "tensorflow/compiler/xla/service/dfs_hlo_visitor_with_default.h"
 #include "tensorflow/compiler/xla/service/hlo_matchers.h"
 #include "tensorflow/compiler/xla/service/hlo_parser.h"
@@ -22,6 +23,10 @@ limitations under the License.
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/compiler/xla/tests/test_utils.h"
 #include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
 
 namespace op = xla::testing::opcode_matchers;
 
@@ -658,5 +663,41 @@ TEST_F(InstructionFusionTest, FuseReverse) {
               op::Reverse(op::Add(op::Parameter(), op::Parameter())));
 }
 
+TEST_F(InstructionFusionTest, FusionProfileVetoesListedFusion) {
+  const char* const hlo_string = R"(
+    HloModule test_module
+
+    ENTRY Reverse {
+      p0 = f32[50,96,1024]{2,1,0} parameter(0)
+      add = f32[50,96,1024]{2,1,0} add(p0, p0)
+      ROOT reverse = f32[50,96,1024] reverse(add), dimensions={0}
+    })";
+
+  // Record the fingerprint of the add->reverse fusion the heuristics perform
+  // (see the FuseReverse test above).
+  auto module = ParseHloString(hlo_string).ValueOrDie();
+  HloInstruction* root = module->entry_computation()->root_instruction();
+  const uint64 fingerprint = GpuInstructionFusion::FusionFingerprint(
+      root->mutable_operand(0), root);
+
+  // With that fingerprint in the fusion profile, the fusion is not performed.
+  const string profile_file = tensorflow::io::JoinPath(
+      tensorflow::testing::TmpDir(), "fusion_profile");
+  TF_ASSERT_OK(tensorflow::WriteStringToFile(
+      tensorflow::Env::Default(), profile_file,
+      absl::StrCat(fingerprint, " add->reverse measured 2x slower fused\n")));
+  HloModuleConfig config = module->config();
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_gpu_fusion_profile_file(profile_file);
+  config.set_debug_options(debug_options);
+  module->set_config(config);
+
+  EXPECT_FALSE(GpuInstructionFusion(/*may_duplicate=*/true)
+                   .Run(module.get())
+                   .ValueOrDie());
+  EXPECT_THAT(module->entry_computation()->root_instruction(),
+              op::Reverse(op::Add(op::Parameter(), op::Parameter())));
+}
+
 }  // namespace gpu
 }  // namespace xla
@@ -58,14 +58,33 @@ inline bool IsStreamNumValid(int stream_num) {
   return stream_num != kInvalidStreamNum;
 }
 
+// Returns whether `hlo` is worth placing on its own stream so it can overlap
+// with concurrent work. GEMMs always qualify. Convolutions and FFTs, which
+// also run as self-contained library calls, qualify when
+// xla_gpu_multi_stream_library_calls is set.
+bool IsStreamSpreadCandidate(const HloInstruction& hlo) {
+  if (ImplementedAsGemm(hlo)) {
+    return true;
+  }
+  if (hlo.GetModule()
+          ->config()
+          .debug_options()
+          .xla_gpu_multi_stream_library_calls()) {
+    return IsCustomCallToDnnConvolution(hlo) ||
+           hlo.opcode() == HloOpcode::kFft;
+  }
+  return false;
+}
+
 // Returns which existing stream to assign to `hlo`, or -1 if a stream is not
 // needed. `stream_assignment` is the existing stream assignment for all
-// instructions topologically before `hlo`. `seen_gemms` contains all GEMMs that
-// are topologically before `hlo`.
+// instructions topologically before `hlo`. `seen_candidates` contains all
+// stream-spread candidates (see IsStreamSpreadCandidate) that are
+// topologically before `hlo`.
 int ComputeStreamToAssign(
     const HloInstruction& hlo, const StreamAssignment& stream_assignment,
     const HloReachabilityMap& reachability,
-    const std::vector<const HloInstruction*>& seen_gemms) {
+    const std::vector<const HloInstruction*>& seen_candidates) {
   if (hlo.opcode() == HloOpcode::kParameter ||
       hlo.opcode() == HloOpcode::kConstant) {
     // kParameter and kConstant do not need a thunk.
@@ -79,9 +98,9 @@ int ComputeStreamToAssign(
     return 0;
   }
 
-  if (!ImplementedAsGemm(hlo)) {
-    // If `hlo` is not implemented as a GEMM, keep it close to its operands to
-    // avoid excessive synchronization.
+  if (!IsStreamSpreadCandidate(hlo)) {
+    // If `hlo` is not a stream-spread candidate, keep it close to its operands
+    // to avoid excessive synchronization.
     int stream_num = -1;
     for (const auto* operand : hlo.operands()) {
       if (stream_assignment.HasStreamAssigned(*operand)) {
@@ -95,15 +114,15 @@ int ComputeStreamToAssign(
     return stream_num;
   }
 
-  // Assign different streams to concurrent GEMMs. The code below uses a
+  // Assign different streams to concurrent candidates. The code below uses a
   // greedy approach. First, we compute as forbidden_stream_numbers the
-  // streams assigned to GEMMs that are concurrent with `hlo`. Then, we assign
-  // `hlo` a different stream.
+  // streams assigned to candidates that are concurrent with `hlo`. Then, we
+  // assign `hlo` a different stream.
   absl::flat_hash_set<int> forbidden_stream_numbers;
-  for (const auto* seen_gemm : seen_gemms) {
-    int stream_num = stream_assignment.StreamNumberForHlo(*seen_gemm);
+  for (const auto* seen_candidate : seen_candidates) {
+    int stream_num = stream_assignment.StreamNumberForHlo(*seen_candidate);
     if (!forbidden_stream_numbers.contains(stream_num) &&
-        CanRunConcurrently(*seen_gemm, hlo, reachability)) {
+        CanRunConcurrently(*seen_candidate, hlo, reachability)) {
       forbidden_stream_numbers.insert(stream_num);
     }
   }
@@ -124,7 +143,7 @@ std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module) {
   const HloComputation& computation = *module.entry_computation();
   std::unique_ptr<HloReachabilityMap> reachability =
       HloReachabilityMap::Build(&computation);
-  std::vector<const HloInstruction*> seen_gemms;
+  std::vector<const HloInstruction*> seen_candidates;
   // The execution of different RNG Hlo instructions in the same module updates
   // a common global variable. To avoid a race condition, we simply assign all
   // RNG kernels to the same stream to make them run sequentially.
@@ -139,7 +158,8 @@ std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module) {
                       IsStreamNumValid(stream_num_for_rng))
                          ? stream_num_for_rng
                          : ComputeStreamToAssign(*hlo, *stream_assignment,
-                                                 *reachability, seen_gemms);
+                                                 *reachability,
+                                                 seen_candidates);
     if (IsStreamNumValid(stream_num)) {
       stream_assignment->AssignStreamToHlo(hlo, stream_num);
       if (hlo->opcode() == HloOpcode::kRng &&
@@ -147,8 +167,8 @@ std::unique_ptr<StreamAssignment> AssignStreams(const HloModule& module) {
         stream_num_for_rng = stream_num;
       }
     }
-    if (ImplementedAsGemm(*hlo)) {
-      seen_gemms.push_back(hlo);
+    if (IsStreamSpreadCandidate(*hlo)) {
+      seen_candidates.push_back(hlo);
     }
   }
   return stream_assignment;
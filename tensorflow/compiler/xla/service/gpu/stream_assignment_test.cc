@@ -30,16 +30,20 @@ namespace gpu {
 
 class StreamAssignmentTest : public HloTestBase {
  protected:
-  std::unique_ptr<HloModule> CreateNewVerifiedModule() {
+  std::unique_ptr<HloModule> CreateNewVerifiedModule(
+      bool multi_stream_library_calls = false) {
     HloModuleConfig config;
     auto debug_options = GetDebugOptionsForTest();
     debug_options.set_xla_gpu_disable_multi_streaming(false);
+    debug_options.set_xla_gpu_multi_stream_library_calls(
+        multi_stream_library_calls);
     config.set_debug_options(debug_options);
     return absl::make_unique<HloModule>("test_module", config);
   }
 
   // Pre-canned shapes.
   Shape f32_2x2_ = ShapeUtil::MakeShape(F32, {2, 2});
+  Shape c64_8_ = ShapeUtil::MakeShape(C64, {8});
 };
 
 TEST_F(StreamAssignmentTest, SequentialMatMul) {
@@ -139,5 +143,49 @@ TEST_F(StreamAssignmentTest, LatticeMatMul) {
             assignment->StreamNumberForHlo(*d31));
 }
 
+TEST_F(StreamAssignmentTest, ConcurrentFftSharesStreamByDefault) {
+  HloComputation::Builder builder("entry_computation");
+  HloInstruction* x = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/0, c64_8_, /*name=*/"x"));
+  HloInstruction* y = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/1, c64_8_, /*name=*/"y"));
+  HloInstruction* fft1 = builder.AddInstruction(
+      HloInstruction::CreateFft(c64_8_, x, FftType::FFT, /*fft_length=*/{8}));
+  HloInstruction* fft2 = builder.AddInstruction(
+      HloInstruction::CreateFft(c64_8_, y, FftType::FFT, /*fft_length=*/{8}));
+  HloInstruction* tuple =
+      builder.AddInstruction(HloInstruction::CreateTuple({fft1, fft2}));
+
+  auto module = CreateNewVerifiedModule();
+  module->AddEntryComputation(builder.Build(tuple));
+
+  // Without xla_gpu_multi_stream_library_calls, only GEMMs are spread across
+  // streams; the FFTs stay on the stream of their operands.
+  std::unique_ptr<StreamAssignment> assignment = AssignStreams(*module);
+  EXPECT_EQ(assignment->StreamNumberForHlo(*fft1),
+            assignment->StreamNumberForHlo(*fft2));
+}
+
+TEST_F(StreamAssignmentTest, ConcurrentFftSpreadAcrossLibraryCallStreams) {
+  HloComputation::Builder builder("entry_computation");
+  HloInstruction* x = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/0, c64_8_, /*name=*/"x"));
+  HloInstruction* y = builder.AddInstruction(HloInstruction::CreateParameter(
+      /*parameter_number=*/1, c64_8_, /*name=*/"y"));
+  HloInstruction* fft1 = builder.AddInstruction(
+      HloInstruction::CreateFft(c64_8_, x, FftType::FFT, /*fft_length=*/{8}));
+  HloInstruction* fft2 = builder.AddInstruction(
+      HloInstruction::CreateFft(c64_8_, y, FftType::FFT, /*fft_length=*/{8}));
+  HloInstruction* tuple =
+      builder.AddInstruction(HloInstruction::CreateTuple({fft1, fft2}));
+
+  auto module = CreateNewVerifiedModule(/*multi_stream_library_calls=*/true);
+  module->AddEntryComputation(builder.Build(tuple));
+
+  std::unique_ptr<StreamAssignment> assignment = AssignStreams(*module);
+  EXPECT_NE(assignment->StreamNumberForHlo(*fft1),
+            assignment->StreamNumberForHlo(*fft2));
+}
+
 }  // namespace gpu
 }  // namespace xla
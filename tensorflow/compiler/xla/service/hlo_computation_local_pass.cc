@@ -0,0 +1,75 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/hlo_computation_local_pass.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "tensorflow/compiler/xla/status_macros.h"
+#include "tensorflow/compiler/xla/types.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/logging.h"
+
+namespace xla {
+
+std::vector<HloComputation*> HloComputationLocalPass::ComputationsToRun(
+    HloModule* module) {
+  return module->MakeNonfusionComputations();
+}
+
+StatusOr<bool> HloComputationLocalPass::Run(HloModule* module) {
+  std::vector<HloComputation*> computations = ComputationsToRun(module);
+  const int64 num_threads = std::min<int64>(
+      module->config().debug_options().xla_computation_local_pass_parallelism,
+      computations.size());
+
+  if (num_threads <= 1) {
+    bool changed = false;
+    for (HloComputation* computation : computations) {
+      TF_ASSIGN_OR_RETURN(bool computation_changed,
+                          RunOnComputation(computation));
+      changed |= computation_changed;
+    }
+    return changed;
+  }
+
+  VLOG(2) << "Running " << name() << " on " << computations.size()
+          << " computations with " << num_threads << " threads";
+  // Each task writes only its own result slot; no synchronization is needed
+  // beyond the thread pool joining in its destructor.
+  std::vector<StatusOr<bool>> results(computations.size(), false);
+  {
+    tensorflow::thread::ThreadPool pool(tensorflow::Env::Default(),
+                                        "computation_local_pass",
+                                        static_cast<int>(num_threads));
+    for (int64 i = 0; i < static_cast<int64>(computations.size()); ++i) {
+      HloComputation* computation = computations[i];
+      StatusOr<bool>* result = &results[i];
+      pool.Schedule([this, computation, result]() {
+        *result = RunOnComputation(computation);
+      });
+    }
+  }
+  bool changed = false;
+  for (StatusOr<bool>& result : results) {
+    TF_ASSIGN_OR_RETURN(bool computation_changed, std::move(result));
+    changed |= computation_changed;
+  }
+  return changed;
+}
+
+}  // namespace xla
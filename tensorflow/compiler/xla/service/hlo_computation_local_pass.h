@@ -0,0 +1,59 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_COMPILER_XLA_SERVICE_HLO_COMPUTATION_LOCAL_PASS_H_
+#define TENSORFLOW_COMPILER_XLA_SERVICE_HLO_COMPUTATION_LOCAL_PASS_H_
+
+#include <vector>
+
+#include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
+#include "tensorflow/compiler/xla/statusor.h"
+
+namespace xla {
+
+// Base class for module passes which rewrite each computation of a module in
+// isolation. Subclasses implement RunOnComputation(); Run() applies it to
+// every computation returned by ComputationsToRun(), across a thread pool
+// when --xla_computation_local_pass_parallelism is greater than one.
+//
+// Parallel execution is only safe for passes whose per-computation rewrite
+// neither reads nor writes the instructions of other computations.
+// Module-level bookkeeping -- instruction name and id assignment, and adding
+// embedded computations -- is serialized by HloModule, but a rewrite which
+// inspects a called computation (e.g. to compare while bodies) may observe
+// another thread's partial edits. The flag therefore defaults to serial
+// execution and should only be raised for pipelines known to be safe.
+class HloComputationLocalPass : public HloModulePass {
+ public:
+  // Runs the pass on the given computation. Returns whether the computation
+  // was changed. May be invoked concurrently for different computations of
+  // the same module when parallelism is enabled.
+  virtual StatusOr<bool> RunOnComputation(HloComputation* computation) = 0;
+
+  // Runs RunOnComputation on every computation returned by
+  // ComputationsToRun. Returns whether any computation was changed.
+  StatusOr<bool> Run(HloModule* module) override;
+
+ protected:
+  // The computations Run() visits. Defaults to the non-fusion computations
+  // of the module; subclasses may override to widen or narrow the set.
+  virtual std::vector<HloComputation*> ComputationsToRun(HloModule* module);
+};
+
+}  // namespace xla
+
+#endif  // TENSORFLOW_COMPILER_XLA_SERVICE_HLO_COMPUTATION_LOCAL_PASS_H_
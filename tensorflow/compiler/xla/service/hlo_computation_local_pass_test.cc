@@ -0,0 +1,166 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/compiler/xla/service/hlo_computation_local_pass.h"
+
+#include "absl/container/flat_hash_set.h"
+#include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_instruction.h"
+#include "tensorflow/compiler/xla/service/hlo_module.h"
+#include "tensorflow/compiler/xla/test_helpers.h"
+#include "tensorflow/compiler/xla/tests/hlo_test_base.h"
+#include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace xla {
+namespace {
+
+class HloComputationLocalPassTest : public HloTestBase {
+ protected:
+  // A module whose entry calls three independent computations.
+  static string ThreeCalleeModuleStr() {
+    return R"(
+HloModule ThreeCallees
+
+callee0 {
+  p0 = f32[] parameter(0)
+  ROOT n0 = f32[] negate(p0)
+}
+
+callee1 {
+  p1 = f32[] parameter(0)
+  ROOT n1 = f32[] negate(p1)
+}
+
+callee2 {
+  p2 = f32[] parameter(0)
+  ROOT n2 = f32[] negate(p2)
+}
+
+ENTRY main {
+  a = f32[] parameter(0)
+  c0 = f32[] call(a), to_apply=callee0
+  c1 = f32[] call(a), to_apply=callee1
+  c2 = f32[] call(a), to_apply=callee2
+  ROOT add = f32[] add(c0, c1)
+}
+)";
+  }
+
+  void SetParallelism(HloModule* module, int32 parallelism) {
+    HloModuleConfig config = module->config();
+    DebugOptions debug_options = config.debug_options();
+    debug_options.set_xla_computation_local_pass_parallelism(parallelism);
+    config.set_debug_options(debug_options);
+    module->set_config(config);
+  }
+};
+
+// A computation-local pass which appends a negate of the root to each
+// visited computation.
+class AppendNegatePass : public HloComputationLocalPass {
+  absl::string_view name() const override { return "append-negate"; }
+
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    HloInstruction* root = computation->root_instruction();
+    computation->AddInstruction(
+        HloInstruction::CreateUnary(root->shape(), HloOpcode::kNegate, root));
+    return true;
+  }
+};
+
+// A computation-local pass which changes nothing.
+class NoOpPass : public HloComputationLocalPass {
+  absl::string_view name() const override { return "no-op"; }
+
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+    return false;
+  }
+};
+
+TEST_F(HloComputationLocalPassTest, SerialRunVisitsAllComputations) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(ThreeCalleeModuleStr()));
+  const int64 instructions_before = module->instruction_count();
+
+  AppendNegatePass pass;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pass.Run(module.get()));
+  EXPECT_TRUE(changed);
+  // One negate per non-fusion computation (three callees plus entry).
+  EXPECT_EQ(module->instruction_count(), instructions_before + 4);
+}
+
+TEST_F(HloComputationLocalPassTest, UnchangedModuleReportsUnchanged) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(ThreeCalleeModuleStr()));
+  NoOpPass pass;
+  TF_ASSERT_OK_AND_ASSIGN(bool changed, pass.Run(module.get()));
+  EXPECT_FALSE(changed);
+}
+
+TEST_F(HloComputationLocalPassTest, ParallelRunKeepsNamesAndIdsUnique) {
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(ThreeCalleeModuleStr()));
+  SetParallelism(module.get(), 4);
+  const int64 instructions_before = module->instruction_count();
+
+  AppendNegatePass pass;
+  // Run the pass several times to give concurrent name uniquification a
+  // chance to collide if it were not serialized by the module.
+  for (int i = 0; i < 8; ++i) {
+    TF_ASSERT_OK_AND_ASSIGN(bool changed, pass.Run(module.get()));
+    EXPECT_TRUE(changed);
+  }
+  EXPECT_EQ(module->instruction_count(), instructions_before + 8 * 4);
+
+  absl::flat_hash_set<string> names;
+  absl::flat_hash_set<int> ids;
+  for (HloComputation* computation : module->computations()) {
+    for (HloInstruction* instruction : computation->instructions()) {
+      EXPECT_TRUE(names.insert(instruction->name()).second)
+          << "duplicate instruction name: " << instruction->name();
+      EXPECT_TRUE(ids.insert(instruction->unique_id()).second)
+          << "duplicate instruction id: " << instruction->unique_id();
+    }
+  }
+}
+
+TEST_F(HloComputationLocalPassTest, ParallelRunPropagatesError) {
+  // A pass which fails on one particular computation.
+  class FailOnCallee1Pass : public HloComputationLocalPass {
+    absl::string_view name() const override { return "fail-on-callee1"; }
+
+    StatusOr<bool> RunOnComputation(HloComputation* computation) override {
+      if (computation->name() == "callee1") {
+        return InternalError("tripped on callee1");
+      }
+      return false;
+    }
+  };
+
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(ThreeCalleeModuleStr()));
+  SetParallelism(module.get(), 4);
+
+  FailOnCallee1Pass pass;
+  Status status = pass.Run(module.get()).status();
+  ASSERT_IS_NOT_OK(status);
+  EXPECT_THAT(status.error_message(),
+              ::testing::HasSubstr("tripped on callee1"));
+}
+
+}  // namespace
+}  // namespace xla
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_COMPILER_XLA_SERVICE_HLO_CSE_H_
 #define TENSORFLOW_COMPILER_XLA_SERVICE_HLO_CSE_H_
 
+#include "tensorflow/compiler/xla/service/hlo_computation_local_pass.h"
 #include "tensorflow/compiler/xla/service/hlo_module.h"
 #include "tensorflow/compiler/xla/service/hlo_pass_interface.h"
 
@@ -25,7 +26,7 @@ namespace xla {
 // and identical instructions with the same operands are commoned. The pass
 // iterates over the instructions in topological order which enables the pass to
 // find arbitrarily large common expressions.
-class HloCSE : public HloModulePass {
+class HloCSE : public HloComputationLocalPass {
  public:
   // If is_layout_sensitive is true, then the simplifier preserves layout during
   // transformation. Otherwise, layout is ignored.
@@ -36,9 +37,14 @@ class HloCSE : public HloModulePass {
   ~HloCSE() override = default;
   absl::string_view name() const override { return "cse"; }
 
-  // Run CSE on the given module. Returns whether the module was changed (common
-  // subexpressions were found and eliminated).
-  StatusOr<bool> Run(HloModule* module) override;
+  // Run CSE on the given computation. Returns whether the computation was
+  // changed (common subexpressions were found and eliminated).
+  StatusOr<bool> RunOnComputation(HloComputation* computation) override;
+
+ protected:
+  // Unlike the default, visits fusion computations as well; visits only
+  // fusion computations when only_fusion_computations is set.
+  std::vector<HloComputation*> ComputationsToRun(HloModule* module) override;
 
  private:
   const bool is_layout_sensitive_;
@@ -48,6 +48,12 @@ Status HloModule::set_schedule(HloSchedule schedule) {
   return Status::OK();
 }
 
+void HloModule::AssignUniqueNameAndId(HloInstruction* instruction) {
+  tensorflow::mutex_lock lock(uniquification_mutex_);
+  instruction->UniquifyName(&instruction_name_uniquer_);
+  instruction->SetUniqueId(NewUniqueInstructionId());
+}
+
 HloComputation* HloModule::AddComputationInternal(
     std::unique_ptr<HloComputation> computation, bool is_entry,
     bool uniquify_identifiers) {
@@ -65,6 +71,10 @@ HloComputation* HloModule::AddComputationInternal(
         entry_computation_->root_instruction()->shape());
   }
 
+  // Identifier assignment and the computation list are guarded so embedded
+  // computations may be added from several threads; see
+  // HloComputationLocalPass.
+  tensorflow::mutex_lock lock(uniquification_mutex_);
   if (uniquify_identifiers) {
     computation->UniquifyName(&computation_name_uniquer_);
     for (auto* instruction : computation->instructions()) {
@@ -229,6 +229,13 @@ class HloModule {
     return result;
   }
 
+  // Uniquifies the name of the given instruction and assigns it a new unique
+  // dense id. Unlike using instruction_name_uniquer() and
+  // NewUniqueInstructionId() directly, this method is serialized with a mutex
+  // so that instructions may be added to different computations of this
+  // module from several threads (see HloComputationLocalPass).
+  void AssignUniqueNameAndId(HloInstruction* instruction);
+
   // input_output_alias_config indicates the list of aliased buffers that are
   // expected from the module.
   HloInputOutputAliasConfig& input_output_alias_config() {
@@ -300,6 +307,11 @@ class HloModule {
   NameUniquer instruction_name_uniquer_{/*separator=*/"."};
   int next_unique_id_ = 0;
 
+  // Serializes identifier assignment (name uniquification and unique id
+  // allocation) so computations may be edited from several threads. See
+  // AssignUniqueNameAndId and HloComputationLocalPass.
+  tensorflow::mutex uniquification_mutex_;
+
   // Used to keep track of the next unique module id that should be assigned.
   static std::atomic<int> next_unique_module_id_;
   // A unique id to label modules with.
@@ -26,9 +26,109 @@ limitations under the License.
 #include "tensorflow/compiler/xla/status_macros.h"
 #include "tensorflow/compiler/xla/types.h"
 #include "tensorflow/compiler/xla/util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/monitoring/counter.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 
+#if defined(__linux__)
+#include <stdio.h>
+#include <unistd.h>
+#endif
+
 namespace xla {
+namespace {
+
+// Cumulative compile time spent in HLO passes across the process; the
+// per-pass breakdown carries a "pass" label.
+auto* hlo_pass_time_usecs_total = tensorflow::monitoring::Counter<0>::New(
+    "/tensorflow/compiler/xla/hlo_pass_time_usecs",
+    "Cumulative wall time spent running HLO passes, in microseconds.");
+
+auto* hlo_pass_time_usecs = tensorflow::monitoring::Counter<1>::New(
+    "/tensorflow/compiler/xla/hlo_pass_time_usecs_by_pass",
+    "Cumulative wall time spent per HLO pass, in microseconds.", "pass");
+
+// One row of the per-pass telemetry report.
+struct PassTelemetry {
+  string pass_name;
+  int64 wall_time_usecs = 0;
+  int64 instruction_count_delta = 0;
+  int64 resident_bytes_after = 0;
+};
+
+int64 InstructionCount(const HloModule& module) {
+  return module.instruction_count();
+}
+
+int64 InstructionCount(const HloModuleGroup& module_group) {
+  int64 count = 0;
+  for (const HloModule* module : module_group.modules()) {
+    count += module->instruction_count();
+  }
+  return count;
+}
+
+const DebugOptions& GetDebugOptions(const HloModule& module) {
+  return module.config().debug_options();
+}
+
+const DebugOptions& GetDebugOptions(const HloModuleGroup& module_group) {
+  return module_group.module(0).config().debug_options();
+}
+
+// Best-effort resident set size of the process; returns 0 where the
+// platform provides no cheap way to read it.
+int64 CurrentResidentBytes() {
+#if defined(__linux__)
+  FILE* f = fopen("/proc/self/statm", "r");
+  if (f == nullptr) {
+    return 0;
+  }
+  long resident_pages = 0;  // NOLINT: format dictated by statm.
+  const int matched = fscanf(f, "%*ld %ld", &resident_pages);
+  fclose(f);
+  if (matched != 1) {
+    return 0;
+  }
+  return static_cast<int64>(resident_pages) * sysconf(_SC_PAGESIZE);
+#else
+  return 0;
+#endif
+}
+
+// Writes the collected telemetry as a CSV file into the directory given by
+// --xla_dump_pass_telemetry_to, if set.
+void MaybeDumpTelemetry(const DebugOptions& debug_options,
+                        absl::string_view pipeline_name,
+                        absl::string_view module_name,
+                        const std::vector<PassTelemetry>& telemetry) {
+  const string& directory = debug_options.xla_dump_pass_telemetry_to();
+  if (directory.empty()) {
+    return;
+  }
+  string report =
+      "pass,wall_time_usecs,instruction_count_delta,resident_bytes_after\n";
+  for (const PassTelemetry& entry : telemetry) {
+    absl::StrAppend(&report, entry.pass_name, ",", entry.wall_time_usecs, ",",
+                    entry.instruction_count_delta, ",",
+                    entry.resident_bytes_after, "\n");
+  }
+  tensorflow::Env* env = tensorflow::Env::Default();
+  Status status = env->RecursivelyCreateDir(directory);
+  if (status.ok()) {
+    const string filename = SanitizeFileName(
+        absl::StrCat(module_name, ".", pipeline_name, ".pass_telemetry.csv"));
+    status = tensorflow::WriteStringToFile(
+        env, tensorflow::io::JoinPath(directory, filename), report);
+  }
+  if (!status.ok()) {
+    LOG(WARNING) << "Could not dump pass telemetry: "
+                 << status.error_message();
+  }
+}
+
+}  // namespace
 
 template <typename HloT>
 Status HloPassPipeline::RunInvariantCheckers(
@@ -56,12 +156,28 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
   string last_pass_name = "pipeline-start";
   TF_RETURN_IF_ERROR(RunInvariantCheckers(hlo, last_pass_name));
   bool changed = false;
+  std::vector<PassTelemetry> telemetry;
+  telemetry.reserve(passes.size());
+  tensorflow::Env* env = tensorflow::Env::Default();
   for (HloPassInterface* pass : passes) {
     VLOG(1) << "  HLO pass " << pass->name();
     MaybeDumpHlo(*hlo,
                  /*after_pass_name=*/last_pass_name,
                  /*before_pass_name=*/pass->name());
+    const int64 instructions_before = InstructionCount(*hlo);
+    const uint64 start_usecs = env->NowMicros();
     TF_ASSIGN_OR_RETURN(bool pass_changed, RunHelper(pass, hlo));
+    const int64 wall_time_usecs = env->NowMicros() - start_usecs;
+    hlo_pass_time_usecs_total->GetCell()->IncrementBy(wall_time_usecs);
+    hlo_pass_time_usecs->GetCell(string(pass->name()))
+        ->IncrementBy(wall_time_usecs);
+    PassTelemetry entry;
+    entry.pass_name = string(pass->name());
+    entry.wall_time_usecs = wall_time_usecs;
+    entry.instruction_count_delta =
+        InstructionCount(*hlo) - instructions_before;
+    entry.resident_bytes_after = CurrentResidentBytes();
+    telemetry.push_back(std::move(entry));
     changed |= pass_changed;
     TF_RETURN_IF_ERROR(RunInvariantCheckers(hlo, pass->name()));
     last_pass_name = string(pass->name());
@@ -69,6 +185,7 @@ StatusOr<bool> HloPassPipeline::RunPassesInternal(
   MaybeDumpHlo(*hlo,
                /*after_pass_name=*/last_pass_name,
                /*before_pass_name=*/"pipeline-end");
+  MaybeDumpTelemetry(GetDebugOptions(*hlo), name(), hlo->name(), telemetry);
   return changed;
 }
 
@@ -22,6 +22,9 @@ limitations under the License.
 #include "tensorflow/compiler/xla/tests/hlo_test_base.h"
 #include "tensorflow/compiler/xla/util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/test.h"
 
 namespace xla {
 namespace {
@@ -255,5 +258,43 @@ ENTRY main {
       ::testing::HasSubstr("Module group pass cannot be run on a module"));
 }
 
+TEST_F(HloPassPipelineTest, TelemetryDumpWritten) {
+  // With --xla_dump_pass_telemetry_to set, a CSV report with one row per
+  // pass should be written into the directory.
+  const string module_str = R"(
+HloModule TelemetryDumpWritten
+
+ENTRY main {
+  a = f32[] parameter(0)
+  b = f32[] parameter(1)
+  ROOT foo = f32[] multiply(a, b)
+}
+)";
+  TF_ASSERT_OK_AND_ASSIGN(std::unique_ptr<VerifiedHloModule> module,
+                          ParseAndReturnVerifiedModule(module_str));
+  const string dump_dir = tensorflow::io::JoinPath(
+      tensorflow::testing::TmpDir(), "pass_telemetry");
+  HloModuleConfig config = module->config();
+  DebugOptions debug_options = config.debug_options();
+  debug_options.set_xla_dump_pass_telemetry_to(dump_dir);
+  config.set_debug_options(debug_options);
+  module->set_config(config);
+
+  HloPassPipeline pipeline(TestName());
+  pipeline.AddPass<FooToBarModulePass>();
+  TF_ASSERT_OK(pipeline.Run(module.get()).status());
+
+  std::vector<string> files;
+  TF_ASSERT_OK(
+      tensorflow::Env::Default()->GetChildren(dump_dir, &files));
+  ASSERT_EQ(files.size(), 1);
+  string report;
+  TF_ASSERT_OK(tensorflow::ReadFileToString(
+      tensorflow::Env::Default(),
+      tensorflow::io::JoinPath(dump_dir, files[0]), &report));
+  EXPECT_THAT(report, ::testing::HasSubstr("pass,wall_time_usecs"));
+  EXPECT_THAT(report, ::testing::HasSubstr("foo2bar"));
+}
+
 }  // namespace
 }  // namespace xla
@@ -23,6 +23,7 @@ limitations under the License.
 #include "absl/container/flat_hash_map.h"
 #include "absl/container/flat_hash_set.h"
 #include "absl/container/inlined_vector.h"
+#include "absl/memory/memory.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "absl/strings/str_join.h"
@@ -182,6 +183,7 @@ class InstructionList {
   //    for (auto item = q.first(); item != nullptr; item = q.next(item)) {...}
   Item* first() const { return first_; }
   Item* next(Item* item) const { return item->next; }
+  Item* prev(Item* item) const { return item->prev; }
 
   // Creates an Item for the given instruction, but doesn't add it to the list.
   // (Use InsertBeforeInstructions to add the Item to the list.)
@@ -859,16 +861,40 @@ int64 RematerializationCost(const HloInstruction* instruction,
 // candidate which reduce memory use at the program point of the current
 // instruction as indicated by memory_tracker. nullptr is returned if no
 // candidate can be found.
+//
+// If 'candidate_window_size' is greater than zero, only the given number of
+// instructions placed most recently before 'in_progress_item' are searched,
+// bounding the otherwise quadratic planner cost on large computations. If
+// 'max_flops_per_byte_saved' is greater than zero, candidates whose
+// recompute cost per byte of memory saved (per 'cost_analysis') exceeds it
+// are skipped.
 Item* PickRematerializationCandidate(
     const MemoryUsageTracker& memory_tracker,
-    const InstructionList& instruction_list, int64 memory_limit_bytes,
+    const InstructionList& instruction_list, Item* in_progress_item,
+    int64 memory_limit_bytes, int64 candidate_window_size,
+    int64 max_flops_per_byte_saved, const HloCostAnalysis* cost_analysis,
     absl::flat_hash_map<const HloInstruction*, bool>* remat_able) {
   Item* best_item = nullptr;
   int64 best_cost = 0;
 
+  // Bound the search to the trailing window of placed instructions if
+  // requested. High memory pressure is typically caused by values produced
+  // close to the current program point, so the window loses little.
+  Item* start_item = instruction_list.first();
+  if (candidate_window_size > 0 && in_progress_item != nullptr) {
+    start_item = in_progress_item;
+    for (int64 i = 0; i < candidate_window_size; ++i) {
+      Item* prev_item = instruction_list.prev(start_item);
+      if (prev_item == nullptr) {
+        break;
+      }
+      start_item = prev_item;
+    }
+  }
+
   // TODO(b/35244891): This is currently quadratic in the number of HLO
-  // instructions.
-  for (auto* item = instruction_list.first(); item != nullptr;
+  // instructions when no candidate window is set.
+  for (auto* item = start_item; item != nullptr;
        item = instruction_list.next(item)) {
     if (!item->placed) {
       // Only iterate up to the currently placed instruction.
@@ -914,6 +940,18 @@ Item* PickRematerializationCandidate(
       continue;
     }
 
+    if (max_flops_per_byte_saved > 0 && cost_analysis != nullptr) {
+      const int64 flop_count =
+          static_cast<int64>(cost_analysis->flop_count(*candidate));
+      if (flop_count > max_flops_per_byte_saved * memory_reduced) {
+        VLOG(5) << "candidate " << candidate->name()
+                << " not viable: recompute cost of " << flop_count
+                << " flops exceeds " << max_flops_per_byte_saved
+                << " flops per byte saved";
+        continue;
+      }
+    }
+
     const int cost = RematerializationCost(candidate, memory_tracker,
                                            memory_reduced, memory_limit_bytes);
 
@@ -1029,7 +1067,9 @@ StatusOr<bool> HloRematerialization::RematerializeComputation(
               << ", limit is " << HumanReadableNumBytes(memory_limit_bytes);
 
       Item* best_item = PickRematerializationCandidate(
-          memory_tracker, instruction_list, memory_limit_bytes, &remat_able);
+          memory_tracker, instruction_list, item, memory_limit_bytes,
+          candidate_window_size_, max_flops_per_byte_saved_,
+          cost_analysis_.get(), &remat_able);
 
       if (best_item == nullptr) {
         VLOG(3) << "Unable to find rematerialization candidate at program "
@@ -1214,6 +1254,25 @@ StatusOr<bool> HloRematerialization::Run(HloModule* module) {
   TF_RET_CHECK(module->has_schedule());
   TF_ASSIGN_OR_RETURN(points_to_analysis_, TuplePointsToAnalysis::Run(module));
 
+  // Build a cost analysis for the recompute-cost threshold, if enabled. A
+  // failed analysis (e.g. an unimplemented custom call) merely disables the
+  // threshold.
+  if (max_flops_per_byte_saved_ > 0) {
+    cost_analysis_ = absl::make_unique<HloCostAnalysis>(size_function_);
+    Status analysis_status = Status::OK();
+    for (auto* computation : module->MakeNonfusionComputations()) {
+      analysis_status = computation->Accept(cost_analysis_.get());
+      if (!analysis_status.ok()) {
+        break;
+      }
+    }
+    if (!analysis_status.ok()) {
+      LOG(WARNING) << "Disabling rematerialization recompute-cost threshold: "
+                   << analysis_status.error_message();
+      cost_analysis_.reset();
+    }
+  }
+
   // Adjust memory limit to account for the output of the entry
   // computation. This is necessary because the per-computation accounting in
   // MemoryUsageTracker do not include output as these are typically allocated
@@ -20,6 +20,7 @@
 #include "tensorflow/compiler/xla/service/buffer_liveness.h"
 #include "tensorflow/compiler/xla/service/call_graph.h"
 #include "tensorflow/compiler/xla/service/hlo_computation.h"
+#include "tensorflow/compiler/xla/service/hlo_cost_analysis.h"
 #include "tensorflow/compiler/xla/service/hlo_instruction.h"
 #include "tensorflow/compiler/xla/service/hlo_memory_scheduler.h"
 #include "tensorflow/compiler/xla/service/hlo_module.h"
@@ -57,11 +58,28 @@ class HloRematerialization : public HloModulePass {
   //   sizes: Pointer to data structure which records the peak memory usage of
   //     the HLO module before/after rematerialization. Value are set during
   //     Run(). Can be nullptr.
+  //
+  //   candidate_window_size: If greater than zero, bounds the candidate
+  //     search for each rematerialization decision to the given number of
+  //     most recently placed instructions. This bounds planner cost to
+  //     O(num_instructions * window) on large modules, at the price of
+  //     possibly missing profitable candidates far from the high-pressure
+  //     program point. Zero searches all placed instructions.
+  //
+  //   max_flops_per_byte_saved: If greater than zero, candidates whose
+  //     recomputation executes more than this many floating point operations
+  //     per byte of memory saved are skipped. Callers should derive the value
+  //     from the backend's measured FLOP rate and memory bandwidth. Zero
+  //     disables the threshold.
   HloRematerialization(const ShapeSizeFunction& size_function,
-                       int64 memory_limit_bytes, RematerializationSizes* sizes)
+                       int64 memory_limit_bytes, RematerializationSizes* sizes,
+                       int64 candidate_window_size = 0,
+                       int64 max_flops_per_byte_saved = 0)
       : size_function_(size_function),
         memory_limit_bytes_(memory_limit_bytes),
-        sizes_(sizes) {}
+        sizes_(sizes),
+        candidate_window_size_(candidate_window_size),
+        max_flops_per_byte_saved_(max_flops_per_byte_saved) {}
   ~HloRematerialization() {}
 
   absl::string_view name() const override { return "rematerialization"; }
@@ -109,6 +127,18 @@ class HloRematerialization : public HloModulePass {
   // module before/after rematerialization
   RematerializationSizes* sizes_;
 
+  // Bound on the number of recently placed instructions searched per
+  // rematerialization decision (0 = unbounded).
+  const int64 candidate_window_size_;
+
+  // Bound on the recompute cost, in FLOPs per byte of memory saved, above
+  // which a candidate is not rematerialized (0 = unbounded).
+  const int64 max_flops_per_byte_saved_;
+
+  // Cost analysis used to estimate candidate recompute cost. Only populated
+  // when max_flops_per_byte_saved_ is in effect.
+  std::unique_ptr<HloCostAnalysis> cost_analysis_;
+
   // Call graph of the hlo_module.
   std::unique_ptr<CallGraph> call_graph_;
 
@@ -142,14 +142,17 @@ class HloRematerializationTest : public HloTestBase {
   }
 
   StatusOr<bool> RunHloRematerialization(int64 memory_limit_bytes,
-                                         HloModule* module) {
+                                         HloModule* module,
+                                         int64 candidate_window_size = 0,
+                                         int64 max_flops_per_byte_saved = 0) {
     TF_EXPECT_OK(verifier().Run(module).status());
     HloMemoryScheduler scheduler(
         [](const BufferValue& buffer) { return ByteSizeOf(buffer.shape()); },
         DefaultMemoryScheduler);
     TF_EXPECT_OK(scheduler.Run(module).status());
     HloRematerialization remat(ByteSizeOf, memory_limit_bytes,
-                               /*sizes=*/nullptr);
+                               /*sizes=*/nullptr, candidate_window_size,
+                               max_flops_per_byte_saved);
     return remat.Run(module);
   }
 
@@ -199,6 +202,56 @@ TEST_F(HloRematerializationTest, SingleComputation) {
             remat_bcast);
 }
 
+// Test that a candidate window still finds the rematerialization in
+// MakeRematerializableComputation. The broadcast is placed three
+// instructions before the peak at %concat_1, so a window of four placed
+// instructions covers it.
+TEST_F(HloRematerializationTest, SingleComputationWindowedSearch) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(MakeRematerializableComputation());
+
+  const HloInstruction* slice = computation->root_instruction();
+  const HloInstruction* concat = slice->operand(0);
+  const HloInstruction* bcast = concat->operand(0);
+
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloRematerialization(
+                              /*memory_limit_bytes=*/14 * 1024, module.get(),
+                              /*candidate_window_size=*/4));
+  EXPECT_TRUE(changed);
+
+  // The broadcast should have been rematerialized just as in the unbounded
+  // search.
+  const HloInstruction* remat_bcast = concat->operand(0);
+  EXPECT_THAT(remat_bcast, op::Broadcast(::testing::Ne(bcast)));
+}
+
+// Test that the recompute-cost threshold does not block rematerialization of
+// instructions which are free to recompute, such as the broadcast in
+// MakeRematerializableComputation.
+TEST_F(HloRematerializationTest, RecomputeCostThresholdAllowsFreeRemat) {
+  auto module = CreateNewVerifiedModule();
+  HloComputation* computation =
+      module->AddEntryComputation(MakeRematerializableComputation());
+
+  const HloInstruction* slice = computation->root_instruction();
+  const HloInstruction* concat = slice->operand(0);
+  const HloInstruction* bcast = concat->operand(0);
+
+  // A broadcast executes no floating point operations, so even the tightest
+  // threshold of one flop per byte saved keeps it rematerializable.
+  TF_ASSERT_OK_AND_ASSIGN(bool changed,
+                          RunHloRematerialization(
+                              /*memory_limit_bytes=*/14 * 1024, module.get(),
+                              /*candidate_window_size=*/0,
+                              /*max_flops_per_byte_saved=*/1));
+  EXPECT_TRUE(changed);
+
+  const HloInstruction* remat_bcast = concat->operand(0);
+  EXPECT_THAT(remat_bcast, op::Broadcast(::testing::Ne(bcast)));
+}
+
 // Test rematerialization of a single computation produced by
 // MakeRematerializableComputation but with a sufficiently high memory limit
 // such that no instructions are rematerialized.
@@ -33,9 +33,11 @@ limitations under the License.
 #include "tensorflow/compiler/xla/statusor.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/stream_executor/stream_executor.h"
 
 namespace tensorflow {
@@ -71,6 +73,7 @@ class BufferAllocStats {
 };
 
 const char* kTupleContainer = "tuples";
+const char* kAllocationTableName = "allocation_table";
 
 int64 get_uid() {
   uint64 unsigned_rand = random::New64() & INT64_MAX;
@@ -82,6 +85,203 @@ BufferAllocStats* GetAllocStats() {
   return stats;
 }
 
+// Upper bound, per device ordinal, of device memory retained for reuse
+// instead of being returned to the device allocator when an
+// XRTBufferAllocation is freed. Zero (the default) disables pooling.
+int64 MemoryPoolBytes() {
+  static int64 pool_bytes = []() -> int64 {
+    int64 mb = 0;
+    Status status = ReadInt64FromEnvVar("XRT_MEM_POOL_MB", 0, &mb);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return mb << 20;
+  }();
+  return pool_bytes;
+}
+
+// A pool of freed device memory buffers, keyed by exact byte size. XRT
+// services tend to run the same computations over and over, so the
+// buffer sizes freed when a handle is released are exactly the sizes
+// requested by the next upload or execution, and reuse avoids a round
+// trip through the device allocator per buffer. Buffers are pooled with
+// the allocator that produced them and only handed back out for
+// requests against the same allocator and device ordinal.
+class DeviceMemoryPool {
+ public:
+  static DeviceMemoryPool* Get() {
+    static DeviceMemoryPool* pool = new DeviceMemoryPool;
+    return pool;
+  }
+
+  // If an exact-size buffer produced by allocator is pooled for
+  // device_ordinal, removes it from the pool, stores it in out and
+  // returns true.
+  bool Acquire(xla::DeviceMemoryAllocator* allocator, int device_ordinal,
+               uint64 size, se::DeviceMemoryBase* out) {
+    if (MemoryPoolBytes() == 0 || size == 0) return false;
+    mutex_lock lock(mu_);
+    auto it = free_buffers_.find(Key{device_ordinal, size});
+    if (it == free_buffers_.end()) return false;
+    std::vector<Entry>* entries = &it->second;
+    for (auto eit = entries->begin(); eit != entries->end(); ++eit) {
+      if (eit->allocator == allocator) {
+        *out = eit->buffer;
+        entries->erase(eit);
+        pooled_bytes_[device_ordinal] -= size;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  // Takes ownership of buffer if there is room in the pool for
+  // device_ordinal, returning true. On false the caller retains
+  // ownership and should deallocate as usual.
+  bool Release(xla::DeviceMemoryAllocator* allocator, int device_ordinal,
+               const se::DeviceMemoryBase& buffer) {
+    const int64 pool_limit = MemoryPoolBytes();
+    if (pool_limit == 0 || buffer.size() == 0) return false;
+    mutex_lock lock(mu_);
+    int64* pooled = &pooled_bytes_[device_ordinal];
+    if (*pooled + static_cast<int64>(buffer.size()) > pool_limit) {
+      return false;
+    }
+    free_buffers_[Key{device_ordinal, buffer.size()}].push_back(
+        Entry{buffer, allocator});
+    *pooled += buffer.size();
+    return true;
+  }
+
+  // Returns all pooled buffers to their allocators.
+  void Clear() {
+    std::map<Key, std::vector<Entry>> free_buffers;
+    {
+      mutex_lock lock(mu_);
+      free_buffers_.swap(free_buffers);
+      pooled_bytes_.clear();
+    }
+    for (auto& size_and_entries : free_buffers) {
+      for (Entry& entry : size_and_entries.second) {
+        Status s = entry.allocator->Deallocate(size_and_entries.first.first,
+                                               entry.buffer);
+        CHECK(s.ok());
+      }
+    }
+  }
+
+ private:
+  // (device_ordinal, byte size) of a pooled buffer.
+  typedef std::pair<int, uint64> Key;
+  struct Entry {
+    se::DeviceMemoryBase buffer;
+    xla::DeviceMemoryAllocator* allocator;
+  };
+
+  mutable mutex mu_;
+  std::map<Key, std::vector<Entry>> free_buffers_ GUARDED_BY(mu_);
+  std::map<int, int64> pooled_bytes_ GUARDED_BY(mu_);
+};
+
+// Sharded table mapping allocation handles to XRTTupleAllocations. The
+// table itself lives in the per-device ResourceMgr, so resolving a
+// handle takes the ResourceMgr mutex only for the constant-time lookup
+// of the table resource; the handle map operations are spread across
+// per-shard mutexes and scale with concurrent client threads. Handles
+// are uniformly random int64s, so the low bits select a shard evenly.
+class XRTAllocationTable : public ResourceBase {
+ public:
+  ~XRTAllocationTable() override {
+    for (Shard& shard : shards_) {
+      mutex_lock lock(shard.mu);
+      for (auto& key_and_allocation : shard.table) {
+        key_and_allocation.second->Unref();
+      }
+      shard.table.clear();
+    }
+  }
+
+  // Adds allocation under key, transferring a reference to the table.
+  Status Add(int64 key, XRTTupleAllocation* allocation) {
+    Shard* shard = GetShard(key);
+    mutex_lock lock(shard->mu);
+    if (!shard->table.insert({key, allocation}).second) {
+      return errors::AlreadyExists("XRT allocation handle ", key,
+                                   " already exists");
+    }
+    return Status::OK();
+  }
+
+  // Looks up key, returning the allocation with a reference added for
+  // the caller.
+  Status Lookup(int64 key, XRTTupleAllocation** allocation) {
+    Shard* shard = GetShard(key);
+    mutex_lock lock(shard->mu);
+    auto it = shard->table.find(key);
+    if (it == shard->table.end()) {
+      return errors::NotFound("XRT allocation handle ", key, " not found");
+    }
+    it->second->Ref();
+    *allocation = it->second;
+    return Status::OK();
+  }
+
+  // Removes key, dropping the table's reference on its allocation.
+  Status Delete(int64 key) {
+    Shard* shard = GetShard(key);
+    XRTTupleAllocation* allocation = nullptr;
+    {
+      mutex_lock lock(shard->mu);
+      auto it = shard->table.find(key);
+      if (it == shard->table.end()) {
+        return errors::NotFound("XRT allocation handle ", key, " not found");
+      }
+      allocation = it->second;
+      shard->table.erase(it);
+    }
+    allocation->Unref();
+    return Status::OK();
+  }
+
+  // Drops the table's reference on every allocation.
+  void ReleaseAll() {
+    for (Shard& shard : shards_) {
+      gtl::FlatMap<int64, XRTTupleAllocation*> table;
+      {
+        mutex_lock lock(shard.mu);
+        shard.table.swap(table);
+      }
+      for (auto& key_and_allocation : table) {
+        key_and_allocation.second->Unref();
+      }
+    }
+  }
+
+  string DebugString() const override { return "XRT allocation handle table"; }
+
+ private:
+  static constexpr int kNumShards = 16;
+
+  struct Shard {
+    mutex mu;
+    gtl::FlatMap<int64, XRTTupleAllocation*> table GUARDED_BY(mu);
+  };
+
+  Shard* GetShard(int64 key) { return &shards_[key & (kNumShards - 1)]; }
+
+  Shard shards_[kNumShards];
+};
+
+Status GetOrCreateAllocationTable(ResourceMgr* rm,
+                                  XRTAllocationTable** table) {
+  return rm->LookupOrCreate<XRTAllocationTable>(
+      kTupleContainer, kAllocationTableName, table,
+      [](XRTAllocationTable** new_table) {
+        *new_table = new XRTAllocationTable;
+        return Status::OK();
+      });
+}
+
 Status AllocateScopedShapedBuffer(
     xla::Backend* backend, int device_ordinal, const xla::Shape& shape,
     std::unique_ptr<xla::ScopedShapedBuffer>* buffer) {
@@ -112,6 +312,14 @@ Status AllocateScopedShapedBuffer(
     xla::Shape subshape =
         xla::ShapeUtil::GetSubshape(on_device_shape, index_to_buffer.first);
     uint64 size = transfer_manager->GetByteSizeRequirement(subshape);
+    se::DeviceMemoryBase pooled;
+    if (DeviceMemoryPool::Get()->Acquire(allocator, device_ordinal, size,
+                                         &pooled)) {
+      index_to_buffer.second = pooled;
+      VLOG(2) << "Reused pooled buffer at " << pooled.opaque() << " index "
+              << index_to_buffer.first.ToString();
+      continue;
+    }
     TF_ASSIGN_OR_RETURN(
         xla::OwningDeviceMemory buffer,
         allocator->Allocate(device_ordinal, size, /*retry_on_failure=*/false));
@@ -148,6 +356,12 @@ XRTBufferAllocation::~XRTBufferAllocation() {
   if (VLOG_IS_ON(2)) {
     GetAllocStats()->ReportFree(device_ordinal_, allocation_.size());
   }
+  if (!allocation_.is_null() &&
+      DeviceMemoryPool::Get()->Release(allocator_, device_ordinal_,
+                                       allocation_)) {
+    VLOG(2) << "Pooled buffer at " << allocation_.opaque();
+    return;
+  }
   // Deallocate explicitly allows allocation_ to be null.
   Status s = allocator_->Deallocate(device_ordinal_, allocation_);
   // Nothing to do but check fail here if memory datastructures are corrupted.
@@ -271,20 +485,34 @@ const se::DeviceMemoryBase& XRTTupleAllocation::root_allocation() {
 
 /*static*/ Status XRTTupleAllocation::Lookup(ResourceMgr* rm, int64 key,
                                              XRTTupleAllocation** allocation) {
-  string key_string = absl::StrCat(key);
-  TF_RETURN_IF_ERROR(rm->Lookup(kTupleContainer, key_string, allocation));
-  return Status::OK();
+  XRTAllocationTable* table;
+  TF_RETURN_IF_ERROR(GetOrCreateAllocationTable(rm, &table));
+  core::ScopedUnref table_unref(table);
+  return table->Lookup(key, allocation);
 }
 
 /*static*/ Status XRTTupleAllocation::DeleteFromResourceManager(ResourceMgr* rm,
                                                                 int64 key) {
-  string key_string = absl::StrCat(key);
-  return rm->Delete<XRTTupleAllocation>(kTupleContainer, key_string);
+  XRTAllocationTable* table;
+  TF_RETURN_IF_ERROR(GetOrCreateAllocationTable(rm, &table));
+  core::ScopedUnref table_unref(table);
+  return table->Delete(key);
 }
 
 /* static */ Status XRTTupleAllocation::ReleaseAllAllocations(ResourceMgr* rm) {
   VLOG(1) << "Releasing all XRT held device memory";
-  return rm->Cleanup(kTupleContainer);
+  XRTAllocationTable* table = nullptr;
+  Status status = rm->Lookup(kTupleContainer, kAllocationTableName, &table);
+  if (status.ok()) {
+    core::ScopedUnref table_unref(table);
+    table->ReleaseAll();
+  } else if (!errors::IsNotFound(status)) {
+    return status;
+  }
+  // Allocations released above may have been parked in the memory pool;
+  // return that memory to the device allocator as well.
+  DeviceMemoryPool::Get()->Clear();
+  return Status::OK();
 }
 
 // Helper typedef to make ShapeTree ForEach helper lambda signatures more
@@ -485,8 +713,10 @@ typedef XRTBufferAllocation* XRTBufferAllocationPtr;
 
 Status XRTTupleAllocation::Intern(ResourceMgr* rm, int64* key) {
   *key = get_uid();
-  string key_string = absl::StrCat(*key);
-  return rm->Create(kTupleContainer, key_string, this);
+  XRTAllocationTable* table;
+  TF_RETURN_IF_ERROR(GetOrCreateAllocationTable(rm, &table));
+  core::ScopedUnref table_unref(table);
+  return table->Add(*key, this);
 }
 
 bool XRTTupleAllocation::IsExclusiveOwner() {
@@ -105,9 +105,11 @@ class CollectiveRemoteAccessDistributed : public CollectiveRemoteAccessLocal {
         remote_memory_manager_->TensorFromTransportOptions(
             to_tensor, state->call->resp_.transport_options(), to_device,
             to_device_ctx, to_alloc_attr.on_host(), done);
-      }
-      if (!s.ok() && errors::IsFailedPrecondition(s)) {
-        dev_resolver_->ClearTask(peer_task);
+      } else {
+        if (errors::IsFailedPrecondition(s)) {
+          dev_resolver_->ClearTask(peer_task);
+        }
+        done(s);
       }
 
       delete state;
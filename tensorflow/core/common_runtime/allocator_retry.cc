@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/common_runtime/allocator_retry.h"
+#include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -44,9 +45,12 @@ void* AllocatorRetry::AllocateRaw(
         first = false;
       }
       if (now < deadline_micros) {
-        mutex_lock l(mu_);
-        WaitForMilliseconds(&l, &memory_returned_,
-                            (deadline_micros - now) / 1000);
+        {
+          mutex_lock l(mu_);
+          WaitForMilliseconds(&l, &memory_returned_,
+                              (deadline_micros - now) / 1000);
+        }
+        metrics::RecordAllocatorRetry(env_->NowMicros() - now);
       } else {
         return alloc_func(alignment, num_bytes, true);
       }
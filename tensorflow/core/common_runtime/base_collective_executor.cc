@@ -34,12 +34,90 @@ limitations under the License.
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
 
 #define VALUE_IN_DEBUG_STRING false
 
 namespace tensorflow {
+
+/*static*/
+CollectiveProgressRegistry* CollectiveProgressRegistry::Get() {
+  static CollectiveProgressRegistry* registry = new CollectiveProgressRegistry;
+  return registry;
+}
+
+void CollectiveProgressRegistry::Begin(const string& exec_key,
+                                       const string& name, int64 step_id) {
+  const int64 now = Env::Default()->NowMicros();
+  ProgressHook hook;
+  {
+    mutex_lock l(mu_);
+    InstanceState* state = &instances_[exec_key];
+    state->name = name;
+    state->step_id = step_id;
+    state->begin_micros = now;
+    state->last_micros = now;
+    state->num_events = 0;
+    state->last_event = "started";
+    hook = hook_;
+  }
+  if (hook) hook(exec_key, "started");
+}
+
+void CollectiveProgressRegistry::RecordProgress(const string& exec_key,
+                                                const string& event) {
+  ProgressHook hook;
+  {
+    mutex_lock l(mu_);
+    auto it = instances_.find(exec_key);
+    if (it != instances_.end()) {
+      it->second.last_micros = Env::Default()->NowMicros();
+      ++it->second.num_events;
+      it->second.last_event = event;
+    }
+    hook = hook_;
+  }
+  if (hook) hook(exec_key, event);
+}
+
+void CollectiveProgressRegistry::End(const string& exec_key,
+                                     const Status& status) {
+  ProgressHook hook;
+  {
+    mutex_lock l(mu_);
+    instances_.erase(exec_key);
+    hook = hook_;
+  }
+  if (hook) {
+    hook(exec_key, status.ok() ? "done"
+                               : strings::StrCat("done with error: ",
+                                                 status.error_message()));
+  }
+}
+
+void CollectiveProgressRegistry::SetHook(ProgressHook hook) {
+  mutex_lock l(mu_);
+  hook_ = std::move(hook);
+}
+
+string CollectiveProgressRegistry::DebugString() const {
+  const int64 now = Env::Default()->NowMicros();
+  mutex_lock l(mu_);
+  string s =
+      strings::StrCat(instances_.size(), " collective instance(s) in flight:");
+  for (const auto& entry : instances_) {
+    const InstanceState& state = entry.second;
+    strings::StrAppend(
+        &s, "\n", state.name, " exec ", entry.first, " step_id=",
+        state.step_id, " age=", (now - state.begin_micros) / 1000,
+        "ms idle=", (now - state.last_micros) / 1000,
+        "ms events=", state.num_events, " last: ", state.last_event);
+  }
+  return s;
+}
+
 /*static*/
 int64 CollectiveAdapter::AlignedChunkElts(int64 elt_bytes, int64 total_elts,
                                           int64 num_chunks) {
@@ -225,7 +303,10 @@ void BaseCollectiveExecutor::ExecuteAsync(OpKernelContext* ctx,
   // delay so that the original error status is more likely to
   // propagate up, and peers are unlikely to re-create the purged
   // BufRendezvous by late-arriving requests.
-  StatusCallback done_safe = [this, done](const Status& s) {
+  CollectiveProgressRegistry::Get()->Begin(exec_key, col_params.name,
+                                           step_id_);
+  StatusCallback done_safe = [this, done, exec_key](const Status& s) {
+    CollectiveProgressRegistry::Get()->End(exec_key, s);
     if (!s.ok()) {
       Ref();  // Ensure this lasts until the closure executes.
       SchedNonBlockingClosureAfter(1000000, [this, s] {
@@ -15,18 +15,67 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_BASE_COLLECTIVE_EXECUTOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_BASE_COLLECTIVE_EXECUTOR_H_
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <unordered_map>
 
 #include "tensorflow/core/common_runtime/buf_rendezvous.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/device_attributes.pb.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 class CollectiveImplementation;
 class DeviceMgr;
 class Device;
 
+// Process-wide registry of the live progress of collective instances.
+// Collective implementations report coarse per-chunk events as they
+// execute; the registry keeps the latest state of every in-flight
+// instance so that a hung collective can be diagnosed at runtime (see
+// DebugString) instead of post-mortem, and forwards each event to an
+// optional hook for export to external monitoring.
+class CollectiveProgressRegistry {
+ public:
+  // Called with the instance's exec_key and a short human-readable event
+  // description.  Invoked from collective execution threads; must not
+  // block.
+  typedef std::function<void(const string& exec_key, const string& event)>
+      ProgressHook;
+
+  static CollectiveProgressRegistry* Get();
+
+  // Registers an in-flight instance.
+  void Begin(const string& exec_key, const string& name, int64 step_id);
+
+  // Records a progress event for an in-flight instance.
+  void RecordProgress(const string& exec_key, const string& event);
+
+  // Unregisters the instance, forwarding its final status to the hook.
+  void End(const string& exec_key, const Status& status);
+
+  void SetHook(ProgressHook hook);
+
+  // Describes every in-flight instance: its age, the time since its last
+  // progress event, and what that event was.
+  string DebugString() const;
+
+ private:
+  struct InstanceState {
+    string name;
+    int64 step_id;
+    int64 begin_micros;
+    int64 last_micros;
+    int64 num_events;
+    string last_event;
+  };
+
+  mutable mutex mu_;
+  std::unordered_map<string, InstanceState> instances_ GUARDED_BY(mu_);
+  ProgressHook hook_ GUARDED_BY(mu_);
+};
+
 // Helper interface that aliases regular subfields of a Tensor as separate
 // Tensors for in-place update.
 class CollectiveAdapter {
@@ -0,0 +1,78 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/base_collective_executor.h"
+
+#include <vector>
+
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// The registry is a process-wide singleton, so each test uses its own
+// exec keys and unregisters them before finishing.
+
+TEST(CollectiveProgressRegistryTest, TracksInFlightInstances) {
+  CollectiveProgressRegistry* registry = CollectiveProgressRegistry::Get();
+  registry->Begin("test_key_1", "allreduce_1", 7);
+  string debug = registry->DebugString();
+  EXPECT_TRUE(str_util::StrContains(debug, "allreduce_1"));
+  EXPECT_TRUE(str_util::StrContains(debug, "test_key_1"));
+  EXPECT_TRUE(str_util::StrContains(debug, "step_id=7"));
+  EXPECT_TRUE(str_util::StrContains(debug, "last: started"));
+
+  registry->RecordProgress("test_key_1", "recv sc_idx=3");
+  debug = registry->DebugString();
+  EXPECT_TRUE(str_util::StrContains(debug, "events=1"));
+  EXPECT_TRUE(str_util::StrContains(debug, "last: recv sc_idx=3"));
+
+  registry->End("test_key_1", Status::OK());
+  debug = registry->DebugString();
+  EXPECT_FALSE(str_util::StrContains(debug, "test_key_1"));
+}
+
+TEST(CollectiveProgressRegistryTest, InvokesHook) {
+  CollectiveProgressRegistry* registry = CollectiveProgressRegistry::Get();
+  std::vector<string> events;
+  registry->SetHook([&events](const string& exec_key, const string& event) {
+    events.push_back(strings::StrCat(exec_key, ": ", event));
+  });
+  registry->Begin("test_key_2", "allreduce_2", 1);
+  registry->RecordProgress("test_key_2", "send sc_idx=0");
+  registry->End("test_key_2", errors::DeadlineExceeded("stuck"));
+  registry->SetHook(nullptr);
+
+  ASSERT_EQ(events.size(), 3);
+  EXPECT_EQ(events[0], "test_key_2: started");
+  EXPECT_EQ(events[1], "test_key_2: send sc_idx=0");
+  EXPECT_TRUE(str_util::StrContains(events[2], "done with error"));
+  EXPECT_TRUE(str_util::StrContains(events[2], "stuck"));
+}
+
+TEST(CollectiveProgressRegistryTest, IgnoresUnknownKeys) {
+  CollectiveProgressRegistry* registry = CollectiveProgressRegistry::Get();
+  // Progress for a key that was never registered (or already ended) must
+  // not create an entry.
+  registry->RecordProgress("test_key_3", "late event");
+  EXPECT_FALSE(str_util::StrContains(registry->DebugString(), "test_key_3"));
+  registry->End("test_key_3", Status::OK());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -18,22 +18,74 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 
 #include "tensorflow/core/common_runtime/allocator_retry.h"
+#include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/framework/device_base.h"
 #include "tensorflow/core/lib/core/bits.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env_time.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Returns true iff TF_BFC_ALLOCATOR_LOCK_STATS is set, in which case the
+// allocator records how long each AllocateRaw/DeallocateRaw call waited to
+// acquire the allocator lock.  The two extra clock reads per call are cheap
+// but not free, so this is opt-in.
+bool LockStatsEnabled() {
+  static bool enabled = [] {
+    bool value = false;
+    TF_CHECK_OK(
+        ReadBoolFromEnvVar("TF_BFC_ALLOCATOR_LOCK_STATS", false, &value));
+    return value;
+  }();
+  return enabled;
+}
+
+}  // namespace
+
+uint64 BFCAllocator::LockWaitStartNanos() {
+  return LockStatsEnabled() ? EnvTime::Default()->NowNanos() : 0;
+}
+
+void BFCAllocator::RecordLockWait(int bucket, uint64 start_nanos) const {
+  if (start_nanos == 0) return;
+  const uint64 now = EnvTime::Default()->NowNanos();
+  lock_wait_nanos_[bucket].fetch_add(now - start_nanos,
+                                     std::memory_order_relaxed);
+  lock_wait_counts_[bucket].fetch_add(1, std::memory_order_relaxed);
+}
+
+string BFCAllocator::LockWaitDebugString() const {
+  string rv = strings::StrCat("Lock wait stats for ", name_, ":\n");
+  for (int b = 0; b < kNumLockWaitBuckets; ++b) {
+    const int64 count = lock_wait_counts_[b].load(std::memory_order_relaxed);
+    if (count == 0) continue;
+    const int64 nanos = lock_wait_nanos_[b].load(std::memory_order_relaxed);
+    if (b < kNumBins) {
+      strings::StrAppend(&rv, "Bin ", b);
+    } else {
+      strings::StrAppend(&rv, "Dealloc");
+    }
+    strings::StrAppend(&rv, ": ", nanos / 1000, "us over ", count,
+                       " acquisitions\n");
+  }
+  return rv;
+}
+
 BFCAllocator::BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
-                           bool allow_growth, const string& name)
+                           bool allow_growth, const string& name,
+                           bool garbage_collect)
     : sub_allocator_(sub_allocator),
       name_(name),
+      garbage_collect_(garbage_collect),
       free_chunks_list_(kInvalidChunkHandle),
       next_allocation_id_(1) {
   if (allow_growth) {
@@ -137,6 +189,7 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
           << " bytes.";
 
   total_region_allocated_bytes_ += bytes;
+  metrics::RecordBFCAllocatorExtend(bytes);
   VLOG(1) << "Total allocated bytes: "
           << strings::HumanReadableNumBytes(total_region_allocated_bytes_);
 
@@ -163,6 +216,80 @@ bool BFCAllocator::Extend(size_t alignment, size_t rounded_bytes) {
   return true;
 }
 
+bool BFCAllocator::DeallocateFreeRegions(size_t rounded_bytes) {
+  // Find regions in which every chunk is free.
+  gtl::FlatSet<void*> free_region_ptrs;
+  size_t total_free_bytes = 0;
+  for (const AllocationRegion& region : region_manager_.regions()) {
+    ChunkHandle h = region_manager_.get_handle(region.ptr());
+    bool any_use = false;
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->in_use()) {
+        any_use = true;
+        break;
+      }
+      h = c->next;
+    }
+    if (!any_use) {
+      VLOG(2) << "Found free region with ptr = " << region.ptr();
+      free_region_ptrs.insert(region.ptr());
+      total_free_bytes += region.memory_size();
+    }
+  }
+  if (total_free_bytes == 0) {
+    return false;
+  }
+
+  // Even after freeing these regions the allocation cannot succeed if the
+  // required bytes exceed what would then be available.
+  size_t available_bytes =
+      memory_limit_ - total_region_allocated_bytes_ + total_free_bytes;
+  if (rounded_bytes > available_bytes) {
+    return false;
+  }
+
+  LOG(WARNING) << "Garbage collection: deallocating "
+               << strings::HumanReadableNumBytes(total_free_bytes)
+               << " of free memory regions from " << Name()
+               << " to defragment.  This is time-consuming if it happens "
+               << "frequently; consider raising the memory limit or "
+               << "reducing fragmentation in the workload.";
+  DeallocateRegions(free_region_ptrs);
+  return true;
+}
+
+void BFCAllocator::DeallocateRegions(const gtl::FlatSet<void*>& region_ptrs) {
+  std::vector<AllocationRegion>* regions = region_manager_.mutable_regions();
+  auto it = regions->begin();
+  while (it != regions->end()) {
+    if (region_ptrs.count(it->ptr()) == 0) {
+      ++it;
+      continue;
+    }
+
+    VLOG(2) << "Deallocating region with ptr = " << it->ptr();
+
+    // Remove the chunks of the region from their bins and release their
+    // metadata.
+    ChunkHandle h = region_manager_.get_handle(it->ptr());
+    while (h != kInvalidChunkHandle) {
+      const Chunk* c = ChunkFromHandle(h);
+      if (c->bin_num != kInvalidBinNum) {
+        RemoveFreeChunkFromBin(h);
+      }
+      const ChunkHandle h_to_delete = h;
+      h = c->next;
+      DeleteChunk(h_to_delete);
+    }
+
+    // Return the memory to the sub-allocator.
+    sub_allocator_->Free(it->ptr(), it->memory_size());
+    total_region_allocated_bytes_ -= it->memory_size();
+    it = region_manager_.RemoveAllocationRegion(it);
+  }
+}
+
 BFCAllocator::ChunkHandle BFCAllocator::AllocateChunk() {
   if (free_chunks_list_ != kInvalidChunkHandle) {
     ChunkHandle h = free_chunks_list_;
@@ -267,7 +394,9 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
   // The BFC allocator tries to find the best fit first.
   BinNum bin_num = BinNumForSize(rounded_bytes);
 
+  const uint64 lock_wait_start = LockWaitStartNanos();
   mutex_lock l(lock_);
+  RecordLockWait(bin_num, lock_wait_start);
   void* ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
   if (ptr != nullptr) {
     return ptr;
@@ -281,6 +410,17 @@ void* BFCAllocator::AllocateRawInternal(size_t unused_alignment,
     }
   }
 
+  // Fragmentation across regions can leave plenty of free memory that no
+  // single region can provide contiguously.  Reclaim fully-free regions and
+  // try to extend again with a larger contiguous region.
+  if (garbage_collect_ && DeallocateFreeRegions(rounded_bytes) &&
+      Extend(unused_alignment, rounded_bytes)) {
+    ptr = FindChunkPtr(bin_num, rounded_bytes, num_bytes, freed_before);
+    if (ptr != nullptr) {
+      return ptr;
+    }
+  }
+
   // We searched all bins for an existing free chunk to use and
   // couldn't find one.  This means we must have run out of memory,
   // Dump the memory log for analysis.
@@ -401,7 +541,9 @@ void BFCAllocator::DeallocateRawInternal(void* ptr) {
     LOG(ERROR) << "tried to deallocate nullptr";
     return;
   }
+  const uint64 lock_wait_start = LockWaitStartNanos();
   mutex_lock l(lock_);
+  RecordLockWait(kNumBins, lock_wait_start);
 
   // Find the chunk from the ptr.
   BFCAllocator::ChunkHandle h = region_manager_.get_handle(ptr);
@@ -684,6 +826,9 @@ void BFCAllocator::DumpMemoryLog(size_t num_bytes) {
   LOG(INFO) << "Sum Total of in-use chunks: "
             << strings::HumanReadableNumBytes(total_bytes);
   LOG(INFO) << "Stats: \n" << stats_.DebugString();
+  if (LockStatsEnabled()) {
+    LOG(INFO) << LockWaitDebugString();
+  }
 }
 
 absl::optional<AllocatorStats> BFCAllocator::GetStats() {
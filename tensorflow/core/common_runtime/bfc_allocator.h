@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_COMMON_RUNTIME_BFC_ALLOCATOR_H_
 
 #include <array>
+#include <atomic>
 #include <memory>
 #include <string>
 #include <unordered_map>
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/allocator_retry.h"
 #include "tensorflow/core/common_runtime/shared_counter.h"
 #include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/macros.h"
@@ -45,9 +47,13 @@ namespace tensorflow {
 // all requests to allocate memory go through this interface.
 class BFCAllocator : public Allocator {
  public:
-  // Takes ownership of sub_allocator.
+  // Takes ownership of sub_allocator.  If 'garbage_collect' is true, then
+  // when an allocation would otherwise fail, memory regions that contain no
+  // in-use chunks are returned to the sub-allocator and the allocation is
+  // retried, which can recover from fragmentation across regions.
   BFCAllocator(SubAllocator* sub_allocator, size_t total_memory,
-               bool allow_growth, const string& name);
+               bool allow_growth, const string& name,
+               bool garbage_collect = false);
   ~BFCAllocator() override;
 
   string Name() override { return name_; }
@@ -75,6 +81,13 @@ class BFCAllocator : public Allocator {
 
   void SetTimingCounter(SharedCounter* sc) { timing_counter_ = sc; }
 
+  // Returns a human-readable summary of how long threads have waited to
+  // acquire the allocator lock, bucketed by the bin of the triggering
+  // allocation (deallocations are accumulated in a separate bucket).
+  // Only populated when TF_BFC_ALLOCATOR_LOCK_STATS is set; otherwise the
+  // timing instrumentation is compiled in but skipped.
+  string LockWaitDebugString() const;
+
  private:
   struct Bin;
 
@@ -295,6 +308,13 @@ class BFCAllocator : public Allocator {
 
     const std::vector<AllocationRegion>& regions() const { return regions_; }
 
+    std::vector<AllocationRegion>* mutable_regions() { return &regions_; }
+
+    std::vector<AllocationRegion>::iterator RemoveAllocationRegion(
+        std::vector<AllocationRegion>::iterator it) {
+      return regions_.erase(it);
+    }
+
    private:
     static bool Comparator(const void* ptr, const AllocationRegion& other) {
       return ptr < other.end_ptr();
@@ -329,6 +349,19 @@ class BFCAllocator : public Allocator {
   bool Extend(size_t alignment, size_t rounded_bytes)
       EXCLUSIVE_LOCKS_REQUIRED(lock_);
 
+  // Deallocates regions in which no chunk is in use, returning their memory
+  // to the sub-allocator so a subsequent Extend() can carve out a region
+  // large enough for 'rounded_bytes'.  Returns true if any region was
+  // deallocated.  Only called when garbage_collect_ is set and an
+  // allocation has otherwise failed.
+  bool DeallocateFreeRegions(size_t rounded_bytes)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
+  // Helper for DeallocateFreeRegions: deallocates the regions whose base
+  // pointers are in 'region_ptrs', including their chunk metadata.
+  void DeallocateRegions(const gtl::FlatSet<void*>& region_ptrs)
+      EXCLUSIVE_LOCKS_REQUIRED(lock_);
+
   // Returns a pointer to an underlying allocated chunk of size
   // 'rounded_bytes'.
   void* FindChunkPtr(BinNum bin_num, size_t rounded_bytes, size_t num_bytes,
@@ -439,6 +472,10 @@ class BFCAllocator : public Allocator {
   string name_;
   SharedCounter* timing_counter_ = nullptr;
 
+  // Whether fully-free regions may be returned to the sub-allocator when an
+  // allocation would otherwise fail.  See DeallocateFreeRegions().
+  const bool garbage_collect_ = false;
+
   // Structures mutable after construction
   mutable mutex lock_;
   RegionManager region_manager_ GUARDED_BY(lock_);
@@ -455,6 +492,24 @@ class BFCAllocator : public Allocator {
   // Stats.
   AllocatorStats stats_ GUARDED_BY(lock_);
 
+  // Lock contention telemetry (see LockWaitDebugString()).  Slots [0,
+  // kNumBins) accumulate waits incurred by AllocateRaw calls for the
+  // corresponding bin; slot kNumBins accumulates waits incurred by
+  // DeallocateRaw calls (the freed chunk's bin is unknown until after the
+  // lock is held).
+  // Deliberately not guarded by lock_: these are updated with relaxed
+  // atomics so recording a wait does not itself contend.
+  static constexpr int kNumLockWaitBuckets = kNumBins + 1;
+  mutable std::array<std::atomic<int64>, kNumLockWaitBuckets>
+      lock_wait_nanos_{};
+  mutable std::array<std::atomic<int64>, kNumLockWaitBuckets>
+      lock_wait_counts_{};
+
+  // Returns the current time in nanos if lock-wait telemetry is enabled,
+  // otherwise 0.  Pass the result to RecordLockWait() after acquiring lock_.
+  static uint64 LockWaitStartNanos();
+  void RecordLockWait(int bucket, uint64 start_nanos) const;
+
   friend class GPUBFCAllocatorPrivateMethodsTest;
   TF_DISALLOW_COPY_AND_ASSIGN(BFCAllocator);
 };
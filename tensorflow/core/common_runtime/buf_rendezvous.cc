@@ -108,6 +108,56 @@ void BufRendezvous::ProvideBuf(const string& key, Device* dev,
   }
 }
 
+void BufRendezvous::ProvideBufs(std::vector<ProvidedBuf> bufs) {
+  std::vector<Hook*> ready_hooks;
+  std::vector<std::pair<ProducerCallback, Status>> failed_cbs;
+  {
+    mutex_lock l(mu_);
+    if (!status_.ok()) {
+      for (ProvidedBuf& pb : bufs) {
+        failed_cbs.push_back(std::make_pair(std::move(pb.done), status_));
+      }
+    } else {
+      for (ProvidedBuf& pb : bufs) {
+        Hook* h = nullptr;
+        auto it = hook_table_.find(pb.key);
+        if (it == hook_table_.end()) {
+          h = new Hook;
+          it = hook_table_.insert(std::make_pair(pb.key, h)).first;
+        } else {
+          if (it->second->prod_cb != nullptr) {
+            failed_cbs.push_back(std::make_pair(
+                std::move(pb.done),
+                errors::Internal(
+                    "BufRendezvous::ProvideBuf already called for key ",
+                    pb.key)));
+            continue;
+          }
+          h = it->second;
+        }
+        // Populate Hook with all of the prod values.
+        h->prod_dev = pb.dev;
+        h->prod_ctx = pb.dev_ctx;
+        h->prod_value = pb.v;
+        h->prod_attr = pb.attr;
+        h->prod_cb = std::move(pb.done);
+        // If consumer is waiting, kick off after the lock is released,
+        // removing Hook from table.
+        if (h->cons_cb != nullptr) {
+          hook_table_.erase(it);
+          ready_hooks.push_back(h);
+        }
+      }
+    }
+  }
+  for (Hook* h : ready_hooks) {
+    h->cons_cb(Status::OK(), h);
+  }
+  for (auto& cb_and_status : failed_cbs) {
+    cb_and_status.first(cb_and_status.second);
+  }
+}
+
 void BufRendezvous::ConsumeBuf(const string& key,
                                const ConsumerCallback& done) {
   Hook* existing_hook = nullptr;
@@ -147,6 +197,50 @@ void BufRendezvous::ConsumeBuf(const string& key,
   }
 }
 
+void BufRendezvous::ConsumeBufs(
+    std::vector<std::pair<string, ConsumerCallback>> keys_and_done) {
+  std::vector<Hook*> ready_hooks;
+  std::vector<std::pair<ConsumerCallback, Status>> failed_cbs;
+  {
+    mutex_lock l(mu_);
+    if (!status_.ok()) {
+      for (auto& entry : keys_and_done) {
+        failed_cbs.push_back(
+            std::make_pair(std::move(entry.second), status_));
+      }
+    } else {
+      for (auto& entry : keys_and_done) {
+        auto it = hook_table_.find(entry.first);
+        if (it != hook_table_.end()) {
+          // Producer already arrived; consume after the lock is released.
+          if (it->second->cons_cb != nullptr) {
+            failed_cbs.push_back(std::make_pair(
+                std::move(entry.second),
+                errors::Internal("Second consumer arrived for key ",
+                                 entry.first)));
+            continue;
+          }
+          Hook* h = it->second;
+          hook_table_.erase(it);
+          h->cons_cb = std::move(entry.second);
+          ready_hooks.push_back(h);
+        } else {
+          // Hang consumer callback on a new Hook.
+          Hook* h = new Hook;
+          hook_table_[entry.first] = h;
+          h->cons_cb = std::move(entry.second);
+        }
+      }
+    }
+  }
+  for (Hook* h : ready_hooks) {
+    h->cons_cb(Status::OK(), h);
+  }
+  for (auto& cb_and_status : failed_cbs) {
+    cb_and_status.first(cb_and_status.second, nullptr);
+  }
+}
+
 /*static*/
 void BufRendezvous::DoneWithHook(Hook* h) {
   h->prod_cb(Status::OK());
@@ -17,6 +17,8 @@ limitations under the License.
 
 #include <functional>
 #include <string>
+#include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -82,6 +84,32 @@ class BufRendezvous {
   // Consumer is provide with a Hook as soon as available.
   void ConsumeBuf(const string& key, const ConsumerCallback& done);
 
+  // One entry of a batched ProvideBufs call.  Semantics of the fields
+  // are identical to the corresponding ProvideBuf arguments.
+  struct ProvidedBuf {
+    string key;
+    Device* dev = nullptr;
+    DeviceContext* dev_ctx = nullptr;
+    const Tensor* v = nullptr;
+    AllocatorAttributes attr;
+    ProducerCallback done;
+  };
+
+  // Equivalent to calling ProvideBuf once per entry of bufs, but all
+  // entries are matched against the table in a single critical section.
+  // Ring algorithms with static schedules exchange many small chunks per
+  // step; batching avoids a mutex acquisition per chunk.  Callbacks for
+  // entries whose consumer is already waiting are invoked inline after
+  // the lock is released, in the order given.
+  void ProvideBufs(std::vector<ProvidedBuf> bufs);
+
+  // Equivalent to calling ConsumeBuf once per entry of keys_and_done,
+  // but all entries are matched in a single critical section.  Hooks
+  // whose producer has already arrived are delivered inline after the
+  // lock is released, in the order given.
+  void ConsumeBufs(
+      std::vector<std::pair<string, ConsumerCallback>> keys_and_done);
+
   // Consumer must call this function when it's done reading the Hook provided
   // by the ConsumerCallback.  This function will invoke the producer callback
   // and then delete h.
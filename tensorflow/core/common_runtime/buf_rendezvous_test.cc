@@ -106,6 +106,166 @@ TEST_F(BufRendezvousTest, CorrectUseConsumerFirst) {
   TF_EXPECT_OK(prod_status);
 }
 
+TEST_F(BufRendezvousTest, BatchedProducerFirst) {
+  std::vector<Status> prod_status(2);
+  std::vector<Status> cons_status(2);
+  int prod_callbacks_called = 0;
+  int cons_callbacks_called = 0;
+  std::vector<BufRendezvous::ProvidedBuf> bufs(2);
+  bufs[0].key = "key0";
+  bufs[0].dev = fake_dev_ptr_;
+  bufs[0].dev_ctx = fake_dev_ctx_;
+  bufs[0].v = &a_;
+  bufs[0].done = [&prod_status, &prod_callbacks_called](const Status& s) {
+    prod_status[0] = s;
+    ++prod_callbacks_called;
+  };
+  bufs[1].key = "key1";
+  bufs[1].dev = fake_dev_ptr_;
+  bufs[1].dev_ctx = fake_dev_ctx_;
+  bufs[1].v = &b_;
+  bufs[1].done = [&prod_status, &prod_callbacks_called](const Status& s) {
+    prod_status[1] = s;
+    ++prod_callbacks_called;
+  };
+  br_->ProvideBufs(std::move(bufs));
+  EXPECT_EQ(0, prod_callbacks_called);
+  std::vector<std::pair<string, BufRendezvous::ConsumerCallback>> consumes;
+  consumes.push_back(std::make_pair(
+      "key0", [this, &cons_status, &cons_callbacks_called](
+                  const Status& s, BufRendezvous::Hook* h) {
+        cons_status[0] = s;
+        ++cons_callbacks_called;
+        ASSERT_TRUE(h != nullptr);
+        EXPECT_EQ(h->prod_value, &a_);
+        br_->DoneWithHook(h);
+      }));
+  consumes.push_back(std::make_pair(
+      "key1", [this, &cons_status, &cons_callbacks_called](
+                  const Status& s, BufRendezvous::Hook* h) {
+        cons_status[1] = s;
+        ++cons_callbacks_called;
+        ASSERT_TRUE(h != nullptr);
+        EXPECT_EQ(h->prod_value, &b_);
+        br_->DoneWithHook(h);
+      }));
+  br_->ConsumeBufs(std::move(consumes));
+  EXPECT_EQ(2, cons_callbacks_called);
+  EXPECT_EQ(2, prod_callbacks_called);
+  TF_EXPECT_OK(cons_status[0]);
+  TF_EXPECT_OK(cons_status[1]);
+  TF_EXPECT_OK(prod_status[0]);
+  TF_EXPECT_OK(prod_status[1]);
+}
+
+TEST_F(BufRendezvousTest, BatchedConsumerFirst) {
+  Status prod_status;
+  Status cons_status;
+  bool prod_callback_called = false;
+  bool cons_callback_called = false;
+  std::vector<std::pair<string, BufRendezvous::ConsumerCallback>> consumes;
+  consumes.push_back(std::make_pair(
+      "key0", [this, &cons_status, &cons_callback_called](
+                  const Status& s, BufRendezvous::Hook* h) {
+        cons_status = s;
+        cons_callback_called = true;
+        ASSERT_TRUE(h != nullptr);
+        EXPECT_EQ(h->prod_dev, fake_dev_ptr_);
+        EXPECT_EQ(h->prod_ctx, fake_dev_ctx_);
+        EXPECT_EQ(h->prod_value, &a_);
+        br_->DoneWithHook(h);
+      }));
+  br_->ConsumeBufs(std::move(consumes));
+  EXPECT_FALSE(cons_callback_called);
+  std::vector<BufRendezvous::ProvidedBuf> bufs(1);
+  bufs[0].key = "key0";
+  bufs[0].dev = fake_dev_ptr_;
+  bufs[0].dev_ctx = fake_dev_ctx_;
+  bufs[0].v = &a_;
+  bufs[0].done = [&prod_status, &prod_callback_called](const Status& s) {
+    prod_status = s;
+    prod_callback_called = true;
+  };
+  br_->ProvideBufs(std::move(bufs));
+  EXPECT_TRUE(cons_callback_called);
+  EXPECT_TRUE(prod_callback_called);
+  TF_EXPECT_OK(cons_status);
+  TF_EXPECT_OK(prod_status);
+}
+
+TEST_F(BufRendezvousTest, BatchedPartialOverlap) {
+  // One consumer waits ahead of the batch, the other arrives after it.
+  Status early_cons_status;
+  bool early_cons_called = false;
+  br_->ConsumeBuf("key0", [this, &early_cons_status, &early_cons_called](
+                              const Status& s, BufRendezvous::Hook* h) {
+    early_cons_status = s;
+    early_cons_called = true;
+    ASSERT_TRUE(h != nullptr);
+    EXPECT_EQ(h->prod_value, &a_);
+    br_->DoneWithHook(h);
+  });
+  int prod_callbacks_called = 0;
+  std::vector<BufRendezvous::ProvidedBuf> bufs(2);
+  bufs[0].key = "key0";
+  bufs[0].dev = fake_dev_ptr_;
+  bufs[0].dev_ctx = fake_dev_ctx_;
+  bufs[0].v = &a_;
+  bufs[0].done = [&prod_callbacks_called](const Status& s) {
+    TF_EXPECT_OK(s);
+    ++prod_callbacks_called;
+  };
+  bufs[1].key = "key1";
+  bufs[1].dev = fake_dev_ptr_;
+  bufs[1].dev_ctx = fake_dev_ctx_;
+  bufs[1].v = &b_;
+  bufs[1].done = [&prod_callbacks_called](const Status& s) {
+    TF_EXPECT_OK(s);
+    ++prod_callbacks_called;
+  };
+  br_->ProvideBufs(std::move(bufs));
+  EXPECT_TRUE(early_cons_called);
+  TF_EXPECT_OK(early_cons_status);
+  EXPECT_EQ(1, prod_callbacks_called);
+  Status late_cons_status;
+  bool late_cons_called = false;
+  br_->ConsumeBuf("key1", [this, &late_cons_status, &late_cons_called](
+                              const Status& s, BufRendezvous::Hook* h) {
+    late_cons_status = s;
+    late_cons_called = true;
+    ASSERT_TRUE(h != nullptr);
+    EXPECT_EQ(h->prod_value, &b_);
+    br_->DoneWithHook(h);
+  });
+  EXPECT_TRUE(late_cons_called);
+  TF_EXPECT_OK(late_cons_status);
+  EXPECT_EQ(2, prod_callbacks_called);
+}
+
+TEST_F(BufRendezvousTest, BatchedProvideAfterAbort) {
+  br_->StartAbort(errors::Internal("Falling sky detected"));
+  Status prod_status;
+  std::vector<BufRendezvous::ProvidedBuf> bufs(1);
+  bufs[0].key = "key0";
+  bufs[0].dev = fake_dev_ptr_;
+  bufs[0].dev_ctx = fake_dev_ctx_;
+  bufs[0].v = &a_;
+  bufs[0].done = [&prod_status](const Status& s) { prod_status = s; };
+  br_->ProvideBufs(std::move(bufs));
+  EXPECT_FALSE(prod_status.ok());
+  EXPECT_EQ(prod_status.error_message(), "Falling sky detected");
+  Status cons_status;
+  std::vector<std::pair<string, BufRendezvous::ConsumerCallback>> consumes;
+  consumes.push_back(std::make_pair(
+      "key0", [&cons_status](const Status& s, BufRendezvous::Hook* h) {
+        cons_status = s;
+        EXPECT_EQ(h, nullptr);
+      }));
+  br_->ConsumeBufs(std::move(consumes));
+  EXPECT_FALSE(cons_status.ok());
+  EXPECT_EQ(cons_status.error_message(), "Falling sky detected");
+}
+
 TEST_F(BufRendezvousTest, ErrorDuplicatePut) {
   bool prod_callback_called = false;
   br_->ProvideBuf("key0", fake_dev_ptr_, fake_dev_ctx_, &a_, aa_,
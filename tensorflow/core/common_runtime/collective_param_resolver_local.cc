@@ -16,6 +16,7 @@ limitations under the License.
 
 #include <stddef.h>
 #include <algorithm>
+#include <map>
 #include <unordered_map>
 #include <utility>
 
@@ -30,6 +31,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -202,15 +204,10 @@ bool ParseRingOrder(const string& gpu_ring_order_str, TaskDeviceMap* tdm) {
   return true;
 }
 
-void OrderTaskDeviceMap(const string& gpu_ring_order, TaskDeviceMap* tdm) {
-  CHECK_GT(tdm->size(), 0);  // Should never be called with 0 devices
-
-  // If a valid ring order has been passed in via ConfigProto, use that.
-  if (ParseRingOrder(gpu_ring_order, tdm)) return;
-
-  // Either no ring order was passed in, or the format was unexpected.
-  // We now assign a ring order based on link strengths.  Note that this
-  // algorithm is not optimal and may not always find the best ring order.
+// Assigns local_rank values rank_offset, rank_offset+1, ... to the devices
+// in *tdm by greedily following the strongest interconnect links.  Note that
+// this algorithm is not optimal and may not always find the best ring order.
+void AssignRanksByLinkStrength(TaskDeviceMap* tdm, int rank_offset) {
   int least_rank = -1;
   string next_device;
   std::set<string> selected;
@@ -228,7 +225,7 @@ void OrderTaskDeviceMap(const string& gpu_ring_order, TaskDeviceMap* tdm) {
   // the time being if there's more than one device at a task we
   // assume they're all GPUs.
 
-  int next_rank = 0;
+  int next_rank = rank_offset;
   while (true) {
     selected.insert(next_device);
     auto next_dev_it = tdm->find(next_device);
@@ -283,6 +280,76 @@ void OrderTaskDeviceMap(const string& gpu_ring_order, TaskDeviceMap* tdm) {
   }
 }
 
+// Experimental: build the per-task ring hierarchically, keeping each
+// locality group (devices sharing a PCIe root complex / NUMA node, as
+// reported by DeviceLocality.bus_id) contiguous in the ring.
+bool HierarchicalRingOrderEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_COLLECTIVE_HIERARCHICAL_RING_ORDER",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Groups the devices in *tdm by DeviceLocality.bus_id, orders each group
+// internally by link strength, and concatenates the groups (in order of
+// their smallest original rank) into one ring.  With this layout the ring
+// crosses the inter-group interconnect exactly once per group boundary
+// rather than potentially on every hop.  Returns false (leaving *tdm
+// untouched) when the devices do not split into multiple groups, e.g.
+// when localities carry no bus_id.
+bool OrderTaskDeviceMapHierarchical(TaskDeviceMap* tdm) {
+  std::map<int32, TaskDeviceMap> groups;
+  for (const auto& it : *tdm) {
+    groups[it.second.locality->bus_id()][it.first] = it.second;
+  }
+  if (groups.size() < 2) return false;
+
+  // Order groups by the smallest original rank they contain, so the overall
+  // ring respects the caller-provided device order where possible.
+  std::vector<std::pair<int, TaskDeviceMap*>> group_order;
+  for (auto& git : groups) {
+    int min_rank = -1;
+    for (const auto& it : git.second) {
+      if (min_rank < 0 || it.second.original_rank < min_rank) {
+        min_rank = it.second.original_rank;
+      }
+    }
+    group_order.push_back(std::make_pair(min_rank, &git.second));
+  }
+  std::sort(group_order.begin(), group_order.end());
+
+  int rank_offset = 0;
+  for (auto& git : group_order) {
+    TaskDeviceMap* group_tdm = git.second;
+    AssignRanksByLinkStrength(group_tdm, rank_offset);
+    rank_offset += group_tdm->size();
+    for (const auto& it : *group_tdm) {
+      (*tdm)[it.first].local_rank = it.second.local_rank;
+    }
+  }
+  VLOG(2) << "Assigned local ranks hierarchically over " << groups.size()
+          << " locality groups";
+  return true;
+}
+
+void OrderTaskDeviceMap(const string& gpu_ring_order, TaskDeviceMap* tdm) {
+  CHECK_GT(tdm->size(), 0);  // Should never be called with 0 devices
+
+  // If a valid ring order has been passed in via ConfigProto, use that.
+  if (ParseRingOrder(gpu_ring_order, tdm)) return;
+
+  // Either no ring order was passed in, or the format was unexpected.
+  // Optionally keep PCIe/NUMA locality groups contiguous in the ring;
+  // otherwise assign a flat ring order based on link strengths.
+  if (HierarchicalRingOrderEnabled() && OrderTaskDeviceMapHierarchical(tdm)) {
+    return;
+  }
+  AssignRanksByLinkStrength(tdm, 0);
+}
+
 // The first time a shared CollectiveParams is established for a
 // shared set of instances we compute a good rank order for all the
 // devices in the group, that is appropriate for a ring algorithm.
@@ -613,7 +680,9 @@ void CollectiveParamResolverLocal::AssignCollectiveType(CollectiveParams* cp) {
   if (cp->instance.type == BROADCAST_COLLECTIVE) {
     cp->instance.impl_details.collective_name = "HierarchicalTreeBroadcast";
   } else if (cp->instance.type == REDUCTION_COLLECTIVE) {
-    if (nccl_) {
+    // NcclReduce is only implemented for GPU device groups; fall back to the
+    // ring implementation for CPU groups even when NCCL is requested.
+    if (nccl_ && cp->group.device_type == DEVICE_GPU) {
       cp->instance.impl_details.collective_name = "NcclReduce";
     } else {
       cp->instance.impl_details.collective_name = "RingReduce";
@@ -15,10 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 
+#include <algorithm>
 #include <atomic>
 #include <utility>
 #include <vector>
 #include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/refcount.h"
@@ -243,6 +245,92 @@ void CopyDeviceToDevice(CopyTensor::CopyFunction copy_function,
   }
 }
 
+// Streams a large tensor between non-peer devices through host memory in
+// fixed-size chunks so that the device-to-host copy of chunk N+1 overlaps
+// the host-to-device copy of chunk N (the two directions run on separate
+// copy streams). The single-buffer fallback below serializes the full D2H
+// against the full H2D and tops out at half the achievable bandwidth.
+//
+// Returns false (without scheduling anything) if the tensor cannot be
+// chunked, in which case the caller should use the single-buffer path.
+bool CopyDeviceToDevicePipelined(Allocator* cpu_allocator,
+                                 DeviceContext* send_dev_context,
+                                 DeviceContext* recv_dev_context, Device* src,
+                                 Device* dst, StringPiece edge_name,
+                                 const Tensor* input, Tensor* output,
+                                 StatusCallback done) {
+  // Large enough to saturate a copy engine, small enough to pipeline.
+  static const int64 kChunkBytes = 4 << 20;
+
+  const int64 bytes_per_element = DataTypeSize(input->dtype());
+  if (bytes_per_element == 0) return false;
+  const int64 total_elements = input->NumElements();
+  const int64 chunk_elements = kChunkBytes / bytes_per_element;
+  if (chunk_elements == 0 || total_elements <= chunk_elements) return false;
+
+  struct Chunk {
+    Tensor input;
+    Tensor host;
+    Tensor output;
+  };
+  struct PipelineState {
+    Tensor flat_input;
+    Tensor flat_output;
+    Tensor host_buffer;
+    string edge_name;
+    std::vector<Chunk> chunks;
+    StatusCallback done;
+  };
+  PipelineState* state = new PipelineState;
+  const TensorShape flat_shape({total_elements});
+  if (!state->flat_input.BitcastFrom(*input, input->dtype(), flat_shape)
+           .ok() ||
+      !state->flat_output.BitcastFrom(*output, output->dtype(), flat_shape)
+           .ok()) {
+    delete state;
+    return false;
+  }
+  state->host_buffer = Tensor(cpu_allocator, input->dtype(), flat_shape);
+  state->edge_name = string(edge_name);
+  state->done = std::move(done);
+  for (int64 start = 0; start < total_elements; start += chunk_elements) {
+    const int64 limit = std::min(start + chunk_elements, total_elements);
+    Chunk chunk;
+    chunk.input = state->flat_input.Slice(start, limit);
+    chunk.host = state->host_buffer.Slice(start, limit);
+    chunk.output = state->flat_output.Slice(start, limit);
+    state->chunks.push_back(std::move(chunk));
+  }
+
+  auto* status_cb = new ReffedStatusCallback([state](const Status& s) {
+    StatusCallback done_ = std::move(state->done);
+    delete state;
+    done_(s);
+  });
+  for (size_t i = 0; i < state->chunks.size(); ++i) {
+    Chunk* chunk = &state->chunks[i];
+    status_cb->Ref();  // Held until this chunk's H2D copy (or failure).
+    auto h2d_done = [status_cb](const Status& s) {
+      status_cb->UpdateStatus(s);
+      status_cb->Unref();
+    };
+    auto d2h_done = [status_cb, chunk, recv_dev_context, dst,
+                     h2d_done](const Status& s) {
+      if (!s.ok()) {
+        status_cb->UpdateStatus(s);
+        status_cb->Unref();
+        return;
+      }
+      recv_dev_context->CopyCPUTensorToDevice(&chunk->host, dst,
+                                              &chunk->output, h2d_done);
+    };
+    send_dev_context->CopyDeviceTensorToCPU(&chunk->input, state->edge_name,
+                                            src, &chunk->host, d2h_done);
+  }
+  status_cb->Unref();  // Drop the initial reference.
+  return true;
+}
+
 }  // namespace
 
 // static
@@ -292,6 +380,15 @@ void CopyTensor::ViaDMA(StringPiece edge_name, DeviceContext* send_dev_context,
             << dst_device_type.type()
             << ". Falling back to copying via the host.";
 
+    // Large DMA-able tensors are streamed through the host in chunks so the
+    // two copy directions overlap instead of running back to back.
+    if (input->dtype() != DT_VARIANT && DMAHelper::CanUseDMA(input) &&
+        CopyDeviceToDevicePipelined(cpu_allocator, send_dev_context,
+                                    recv_dev_context, src, dst, edge_name,
+                                    input, output, done)) {
+      return;
+    }
+
     Tensor* cpu_tensor =
         new Tensor(cpu_allocator, input->dtype(), input->shape());
     std::function<void(const Status&)> delete_and_done = std::bind(
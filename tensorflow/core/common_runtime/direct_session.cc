@@ -56,7 +56,9 @@ limitations under the License.
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/monitoring/counter.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -79,6 +81,24 @@ auto* direct_session_runs = monitoring::Counter<0>::New(
     "/tensorflow/core/direct_session_runs",
     "The number of times DirectSession::Run() has been called.");
 
+// Order-insensitive hash of the names, dtypes and shapes of the fed
+// tensors: runs that feed the same tensors with the same shapes map to
+// the same signature regardless of feed order.
+uint64 ComputeShapeSignature(
+    const std::vector<std::pair<string, Tensor>>& inputs) {
+  uint64 signature = 0;
+  for (const auto& it : inputs) {
+    uint64 h = Hash64(it.first);
+    h = Hash64Combine(h, static_cast<uint64>(it.second.dtype()));
+    for (int d = 0; d < it.second.dims(); ++d) {
+      h = Hash64Combine(h, static_cast<uint64>(it.second.dim_size(d)));
+    }
+    signature += h;
+  }
+  // Reserve 0 for "unspecialized".
+  return signature == 0 ? 1 : signature;
+}
+
 Status NewThreadPoolFromThreadPoolOptions(
     const SessionOptions& options,
     const ThreadPoolOptionProto& thread_pool_options, int pool_number,
@@ -94,6 +114,7 @@ Status NewThreadPoolFromThreadPoolOptions(
             << pool_number << ": " << num_threads;
     *pool = new thread::ThreadPool(
         options.env, strings::StrCat("Compute", pool_number), num_threads);
+    ApplyThreadPoolSchedulingOptions(thread_pool_options, *pool);
     *owned = true;
     return Status::OK();
   }
@@ -109,6 +130,7 @@ Status NewThreadPoolFromThreadPoolOptions(
     mvalue->first = thread_pool_options.num_threads();
     mvalue->second = new thread::ThreadPool(
         options.env, strings::StrCat("Compute", pool_number), num_threads);
+    ApplyThreadPoolSchedulingOptions(thread_pool_options, mvalue->second);
   } else {
     if (mvalue->first != thread_pool_options.num_threads()) {
       return errors::InvalidArgument(
@@ -303,6 +325,34 @@ DirectSession::DirectSession(const SessionOptions& options,
   if (!status.ok()) {
     LOG(ERROR) << status.error_message();
   }
+  // Deeply nested function calls otherwise park one inter-op pool thread
+  // per nesting level; running every kernel on its scheduling thread keeps
+  // the thread count flat at the cost of less intra-step parallelism.
+  const Status inline_status = ReadBoolFromEnvVar(
+      "TF_EXECUTOR_RUN_ALL_KERNELS_INLINE", false, &run_all_kernels_inline_);
+  if (!inline_status.ok()) {
+    LOG(ERROR) << inline_status.error_message();
+  }
+  // Concurrent Run() calls that share a device otherwise interleave
+  // arbitrarily, which can stack their allocation peaks and OOM a BFC
+  // allocator that would comfortably fit the steps one (or a few) at a
+  // time. Admitting a bounded number of steps in arrival order staggers
+  // those peaks while still overlapping transfers and compute.
+  int64 max_concurrent_steps = 0;
+  const Status admission_status = ReadInt64FromEnvVar(
+      "TF_SESSION_MAX_CONCURRENT_STEPS", 0, &max_concurrent_steps);
+  if (!admission_status.ok()) {
+    LOG(ERROR) << admission_status.error_message();
+  }
+  if (max_concurrent_steps > 0) {
+    step_admission_gate_.reset(new StepAdmissionGate(max_concurrent_steps));
+  }
+  const Status specialization_status =
+      ReadInt64FromEnvVar("TF_SESSION_SHAPE_SPECIALIZATION_LIMIT", 0,
+                          &shape_specialization_limit_);
+  if (!specialization_status.ok()) {
+    LOG(ERROR) << specialization_status.error_message();
+  }
   session_handle_ =
       strings::StrCat("direct", strings::FpToString(random::New64()));
   int devices_added = 0;
@@ -349,6 +399,13 @@ DirectSession::~DirectSession() {
   for (const auto& p_and_owned : thread_pools_) {
     if (p_and_owned.second) delete p_and_owned.first;
   }
+  {
+    mutex_lock l(rendezvous_pool_mu_);
+    for (IntraProcessRendezvous* rendez : rendezvous_pool_) {
+      rendez->Unref();
+    }
+    rendezvous_pool_.clear();
+  }
 
   execution_state_.reset(nullptr);
   flib_def_.reset(nullptr);
@@ -459,6 +516,82 @@ Status DirectSession::DecorateAndPublishGraphForDebug(
   return Status::OK();
 }
 
+IntraProcessRendezvous* DirectSession::GetOrCreateStepRendezvous() {
+  {
+    mutex_lock l(rendezvous_pool_mu_);
+    if (!rendezvous_pool_.empty()) {
+      IntraProcessRendezvous* rendez = rendezvous_pool_.back();
+      rendezvous_pool_.pop_back();
+      return rendez;
+    }
+  }
+  return new IntraProcessRendezvous(device_mgr_.get());
+}
+
+void DirectSession::ReturnStepRendezvous(RunState* run_state) {
+  IntraProcessRendezvous* rendez = run_state->rendez;
+  // Only pool a rendezvous from a fully completed, successful step: an
+  // aborted rendezvous rejects all further sends/recvs, and unmatched
+  // sends would leak buffered tensors into the next step.
+  if (rendez == nullptr || !run_state->executors_done.HasBeenNotified() ||
+      !rendez->ReadyForReuse()) {
+    return;
+  }
+  run_state->rendez = nullptr;
+  mutex_lock l(rendezvous_pool_mu_);
+  if (rendezvous_pool_.size() < kMaxPooledRendezvous) {
+    rendezvous_pool_.push_back(rendez);
+  } else {
+    rendez->Unref();
+  }
+}
+
+DirectSession::StepAdmissionGate::StepAdmissionGate(int64 max_concurrent_steps)
+    : max_concurrent_steps_(max_concurrent_steps) {}
+
+void DirectSession::StepAdmissionGate::AdvanceCursorLocked() {
+  while (abandoned_tickets_.erase(admit_cursor_) > 0) {
+    ++admit_cursor_;
+  }
+}
+
+Status DirectSession::StepAdmissionGate::Acquire(int64 timeout_in_ms) {
+  const uint64 deadline_micros =
+      timeout_in_ms > 0 ? Env::Default()->NowMicros() + timeout_in_ms * 1000
+                        : 0;
+  mutex_lock l(mu_);
+  const int64 ticket = next_ticket_++;
+  while (ticket != admit_cursor_ || active_steps_ >= max_concurrent_steps_) {
+    if (deadline_micros > 0) {
+      const uint64 now_micros = Env::Default()->NowMicros();
+      if (now_micros >= deadline_micros) {
+        // Leave a tombstone so later tickets are not blocked behind a
+        // waiter that gave up.
+        abandoned_tickets_.insert(ticket);
+        AdvanceCursorLocked();
+        cv_.notify_all();
+        return errors::DeadlineExceeded(
+            "Timed out waiting for admission of step after ", timeout_in_ms,
+            "ms.");
+      }
+      cv_.wait_for(l, std::chrono::microseconds(deadline_micros - now_micros));
+    } else {
+      cv_.wait(l);
+    }
+  }
+  ++active_steps_;
+  ++admit_cursor_;
+  AdvanceCursorLocked();
+  cv_.notify_all();
+  return Status::OK();
+}
+
+void DirectSession::StepAdmissionGate::Release() {
+  mutex_lock l(mu_);
+  --active_steps_;
+  cv_.notify_all();
+}
+
 Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
                                   CallFrameInterface* call_frame,
                                   ExecutorsAndKeys* executors_and_keys,
@@ -467,6 +600,17 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   string session_id_meta = strings::StrCat("SessionRun #id=", step_id, "#");
   tracing::ScopedActivity activity(session_id_meta);
 
+  // Hold back the step until the admission gate clears it, so a bounded
+  // number of steps execute concurrently. Acquired before any per-step
+  // state is allocated and released when this frame unwinds, i.e. after
+  // the executors have finished.
+  if (step_admission_gate_ != nullptr) {
+    TF_RETURN_IF_ERROR(step_admission_gate_->Acquire(operation_timeout_in_ms_));
+  }
+  auto admission_release = gtl::MakeCleanup([this]() {
+    if (step_admission_gate_ != nullptr) step_admission_gate_->Release();
+  });
+
   const int64 executor_step_count = executors_and_keys->step_count.fetch_add(1);
 
   std::unique_ptr<DebuggerStateInterface> debugger_state;
@@ -479,7 +623,7 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
 
   // Create a run state and start execution.
   RunState run_state(step_id, &devices_);
-  run_state.rendez = new IntraProcessRendezvous(device_mgr_.get());
+  run_state.rendez = GetOrCreateStepRendezvous();
 #ifndef __ANDROID__
   // Set up for collectives if ExecutorsAndKeys declares a key.
   if (executors_and_keys->collective_graph_key !=
@@ -537,6 +681,7 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   args.tensor_store = &run_state.tensor_store;
   args.step_container = &run_state.step_container;
   args.sync_on_finish = sync_on_finish_;
+  args.run_all_kernels_inline = run_all_kernels_inline_;
 
   const bool do_trace = (run_options.trace_level() > RunOptions::NO_TRACE);
 
@@ -552,11 +697,18 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
           ((measure_step_count + 1) % build_cost_model_every == 0);
     }
   }
+  std::unique_ptr<SamplingStatsCollector> sampling_collector;
   if (do_trace || update_cost_model ||
       run_options.report_tensor_allocations_upon_oom()) {
     run_state.collector.reset(
         new StepStatsCollector(run_metadata->mutable_step_stats()));
     args.stats_collector = run_state.collector.get();
+  } else if (run_metadata != nullptr &&
+             SamplingStatsCollector::ShouldSampleStep()) {
+    // Low-overhead always-on profiling: record fixed-size events for this
+    // step and export them to the step stats after the executors finish.
+    sampling_collector.reset(new SamplingStatsCollector());
+    args.stats_collector = sampling_collector.get();
   }
 
   std::unique_ptr<DeviceTracer> tracer;
@@ -676,6 +828,10 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
     TF_RETURN_IF_ERROR(run_state.status);
   }
 
+  // The executors are done and the step succeeded, so the rendezvous is
+  // clean and can serve the next step.
+  ReturnStepRendezvous(&run_state);
+
   // Save the output tensors of this run we choose to keep.
   if (!run_state.tensor_store.empty()) {
     TF_RETURN_IF_ERROR(run_state.tensor_store.SaveTensors(
@@ -687,6 +843,9 @@ Status DirectSession::RunInternal(int64 step_id, const RunOptions& run_options,
   if (run_state.collector) {
     run_state.collector->Finalize();
   }
+  if (sampling_collector != nullptr) {
+    sampling_collector->Export(run_metadata->mutable_step_stats());
+  }
 
   // Build and return the cost model as instructed.
   if (update_cost_model) {
@@ -748,9 +907,14 @@ Status DirectSession::Run(const RunOptions& run_options,
   run_state_args.collective_graph_key =
       run_options.experimental().collective_graph_key();
 
+  uint64 shape_signature = 0;
+  if (shape_specialization_limit_ > 0) {
+    shape_signature = ComputeShapeSignature(inputs);
+  }
+
   TF_RETURN_IF_ERROR(GetOrCreateExecutors(input_tensor_names, output_names,
                                           target_nodes, &executors_and_keys,
-                                          &run_state_args));
+                                          &run_state_args, shape_signature));
   {
     mutex_lock l(collective_graph_key_lock_);
     collective_graph_key_ = executors_and_keys->collective_graph_key;
@@ -896,6 +1060,7 @@ Status DirectSession::PRunSetup(const std::vector<string>& input_names,
     LogMemory::RecordStep(args.step_id, run_state_args.handle);
   }
   args.sync_on_finish = sync_on_finish_;
+  args.run_all_kernels_inline = run_all_kernels_inline_;
 
   if (options_.config.graph_options().build_cost_model()) {
     run_state->collector.reset(new StepStatsCollector(nullptr));
@@ -1347,7 +1512,7 @@ Status DirectSession::CreateExecutors(
 Status DirectSession::GetOrCreateExecutors(
     gtl::ArraySlice<string> inputs, gtl::ArraySlice<string> outputs,
     gtl::ArraySlice<string> target_nodes, ExecutorsAndKeys** executors_and_keys,
-    RunStateArgs* run_state_args) {
+    RunStateArgs* run_state_args, uint64 shape_signature) {
   int64 handle_name_counter_value = -1;
   if (LogMemory::IsEnabled() || run_state_args->is_partial_run) {
     handle_name_counter_value = handle_name_counter_.fetch_add(1);
@@ -1360,10 +1525,13 @@ Status DirectSession::GetOrCreateExecutors(
   }
 
   // Fast lookup path, no sorting.
-  const string key = strings::StrCat(
+  string key = strings::StrCat(
       str_util::Join(inputs, ","), "->", str_util::Join(outputs, ","), "/",
       str_util::Join(target_nodes, ","), "/", run_state_args->is_partial_run,
       "/", debug_tensor_watches_summary);
+  if (shape_signature != 0) {
+    strings::StrAppend(&key, "/sig=", shape_signature);
+  }
   // Set the handle, if it's needed to log memory or for partial run.
   if (handle_name_counter_value >= 0) {
     run_state_args->handle =
@@ -1393,10 +1561,13 @@ Status DirectSession::GetOrCreateExecutors(
   std::vector<string> tn_sorted(target_nodes.begin(), target_nodes.end());
   std::sort(tn_sorted.begin(), tn_sorted.end());
 
-  const string sorted_key = strings::StrCat(
+  string sorted_key = strings::StrCat(
       str_util::Join(inputs_sorted, ","), "->",
       str_util::Join(outputs_sorted, ","), "/", str_util::Join(tn_sorted, ","),
       "/", run_state_args->is_partial_run, "/", debug_tensor_watches_summary);
+  if (shape_signature != 0) {
+    strings::StrAppend(&sorted_key, "/sig=", shape_signature);
+  }
   // Set the handle, if its needed to log memory or for partial run.
   if (handle_name_counter_value >= 0) {
     run_state_args->handle =
@@ -1418,6 +1589,26 @@ Status DirectSession::GetOrCreateExecutors(
   // Nothing found, so create the executors and store in the cache.
   // The executor_lock_ is intentionally released while executors are
   // being created.
+  if (shape_signature != 0) {
+    // About to create a shape-specialized set; respect the cap.  The
+    // count may overshoot if two threads race to create the same
+    // signature, which only wastes a slot.
+    bool over_limit = false;
+    {
+      mutex_lock l(executor_lock_);
+      if (shape_specialized_count_ >= shape_specialization_limit_) {
+        over_limit = true;
+      } else {
+        ++shape_specialized_count_;
+      }
+    }
+    if (over_limit) {
+      // Too many distinct shape signatures; run on the shared executors.
+      return GetOrCreateExecutors(inputs, outputs, target_nodes,
+                                  executors_and_keys, run_state_args,
+                                  0 /* shape_signature */);
+    }
+  }
   CallableOptions callable_options;
   for (const string& input : inputs_sorted) {
     callable_options.add_feed(input);
@@ -1702,8 +1893,40 @@ void DirectSession::WaitForNotification(RunState* run_state,
   }
 }
 
+// Bounded spin budget (in microseconds) applied before blocking on the step
+// notification.  Sub-millisecond inference workloads can shave the condvar
+// wakeup latency off their critical path by setting TF_SESSION_SPIN_WAIT_US
+// to roughly their typical step time; the default of 0 keeps waits purely
+// blocking.
+static int64 SessionSpinWaitMicros() {
+  static const int64 result = [] {
+    int64 micros;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_SESSION_SPIN_WAIT_US",
+                                    /*default_val=*/0, &micros));
+    return micros;
+  }();
+  return result;
+}
+
+// Spins on the notification for at most "spin_micros".  Returns true iff
+// the notification fired while spinning.
+static bool SpinForNotification(Notification* notification,
+                                int64 spin_micros) {
+  const uint64 deadline = Env::Default()->NowMicros() + spin_micros;
+  while (!notification->HasBeenNotified()) {
+    if (Env::Default()->NowMicros() >= deadline) {
+      return false;
+    }
+  }
+  return true;
+}
+
 ::tensorflow::Status DirectSession::WaitForNotification(
     Notification* notification, int64 timeout_in_ms) {
+  const int64 spin_micros = SessionSpinWaitMicros();
+  if (spin_micros > 0 && SpinForNotification(notification, spin_micros)) {
+    return Status::OK();
+  }
   if (timeout_in_ms > 0) {
     const int64 timeout_in_us = timeout_in_ms * 1000;
     const bool notified =
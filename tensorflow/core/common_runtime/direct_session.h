@@ -219,10 +219,18 @@ class DirectSession : public Session {
 
   // Retrieves an already existing set of executors to run 'inputs' and
   // 'outputs', or creates and caches them for future use.
+  //
+  // A non-zero 'shape_signature' (a hash of the fed tensors' shapes, see
+  // TF_SESSION_SHAPE_SPECIALIZATION_LIMIT) selects a set of executors
+  // specialized to runs feeding those exact shapes, so that per-executor
+  // state such as kernel cost estimates and memoized step-invariant
+  // outputs is accumulated per shape signature rather than shared across
+  // all shapes.  Zero selects the shared, unspecialized executors.
   ::tensorflow::Status GetOrCreateExecutors(
       gtl::ArraySlice<string> inputs, gtl::ArraySlice<string> outputs,
       gtl::ArraySlice<string> target_nodes,
-      ExecutorsAndKeys** executors_and_keys, RunStateArgs* run_state_args);
+      ExecutorsAndKeys** executors_and_keys, RunStateArgs* run_state_args,
+      uint64 shape_signature = 0);
 
   // Creates a set of executors to run the subgraph defined by
   // `callable_options`.
@@ -278,6 +286,38 @@ class DirectSession : public Session {
       const std::vector<string>& fetches,
       const ExecutorsAndKeys* executors_and_keys, const RunState* run_state);
 
+  // Bounds how many steps may execute concurrently when
+  // TF_SESSION_MAX_CONCURRENT_STEPS is set to a positive value. Steps are
+  // admitted strictly in arrival order, so concurrent Run() calls enter
+  // their allocation-heavy startup phases staggered instead of hitting the
+  // device allocator's peak usage simultaneously.
+  class StepAdmissionGate {
+   public:
+    explicit StepAdmissionGate(int64 max_concurrent_steps);
+
+    // Blocks until the calling step may start executing. Returns
+    // DEADLINE_EXCEEDED if 'timeout_in_ms' is greater than 0 and expires
+    // before the step is admitted.
+    Status Acquire(int64 timeout_in_ms);
+
+    // Signals that a step admitted by Acquire() has finished executing.
+    void Release();
+
+   private:
+    // Skips over tickets whose waiters gave up before being admitted.
+    void AdvanceCursorLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+    const int64 max_concurrent_steps_;
+    mutex mu_;
+    condition_variable cv_;
+    // Tickets are handed out in Acquire() order; 'admit_cursor_' is the
+    // next ticket eligible for admission.
+    int64 next_ticket_ GUARDED_BY(mu_) = 0;
+    int64 admit_cursor_ GUARDED_BY(mu_) = 0;
+    int64 active_steps_ GUARDED_BY(mu_) = 0;
+    std::unordered_set<int64> abandoned_tickets_ GUARDED_BY(mu_);
+  };
+
   // Use the appropriate WaitForNotification function based on whether
   // operation_timeout_in_ms is greater than 0.
   //
@@ -330,6 +370,10 @@ class DirectSession : public Session {
 
   // If true, blocks until device has finished all queued operations in a step.
   bool sync_on_finish_ = true;
+
+  // If true, executors process every kernel on the scheduling thread
+  // (see TF_EXECUTOR_RUN_ALL_KERNELS_INLINE).
+  bool run_all_kernels_inline_ = false;
   // Schedules 'c' for execution on pool.
   void SchedClosure(thread::ThreadPool* pool, std::function<void()> c);
 
@@ -345,6 +389,14 @@ class DirectSession : public Session {
   std::unordered_map<string, std::shared_ptr<ExecutorsAndKeys>> executors_
       GUARDED_BY(executor_lock_);
 
+  // Maximum number of shape-specialized executor sets, read from
+  // TF_SESSION_SHAPE_SPECIALIZATION_LIMIT at construction; 0 disables
+  // specialization.
+  int64 shape_specialization_limit_ = 0;
+  // Number of shape-specialized executor sets created so far.
+  // Approximate under races.
+  int shape_specialized_count_ GUARDED_BY(executor_lock_) = 0;
+
   class RunCallableCallFrame;
   struct Callable {
     std::shared_ptr<ExecutorsAndKeys> executors_and_keys;
@@ -359,6 +411,23 @@ class DirectSession : public Session {
   std::unordered_map<string, std::unique_ptr<RunState>> partial_runs_
       GUARDED_BY(executor_lock_);
 
+  // Returns a pooled rendezvous if one is available, otherwise allocates a
+  // fresh one. The caller owns the returned reference.
+  IntraProcessRendezvous* GetOrCreateStepRendezvous();
+
+  // Returns `run_state`'s rendezvous to the pool if the step left it clean
+  // (never aborted, all sent tensors received); otherwise leaves it for the
+  // RunState destructor to release.
+  void ReturnStepRendezvous(RunState* run_state);
+
+  // Rendezvous objects are reusable once a completed step has consumed every
+  // tensor sent through them. Pooling them avoids a per-Run allocation on
+  // the steady-state (e.g. RunCallable serving) path.
+  static constexpr size_t kMaxPooledRendezvous = 8;
+  mutex rendezvous_pool_mu_;
+  std::vector<IntraProcessRendezvous*> rendezvous_pool_
+      GUARDED_BY(rendezvous_pool_mu_);
+
   // This holds all the tensors that are currently alive in the session.
   SessionState session_state_;
 
@@ -396,6 +465,12 @@ class DirectSession : public Session {
   // Global timeout for all blocking operations in this session.
   const int64 operation_timeout_in_ms_ = 0;
 
+  // If non-null, every step must be admitted by this gate before its
+  // executors launch. Created in the constructor when
+  // TF_SESSION_MAX_CONCURRENT_STEPS is positive; null means unlimited
+  // concurrency (the historical behavior).
+  std::unique_ptr<StepAdmissionGate> step_admission_gate_;
+
   // Manages all the cost models for the graphs executed in this session.
   CostModelManager cost_model_manager_;
 
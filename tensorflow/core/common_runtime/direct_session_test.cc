@@ -1044,6 +1044,61 @@ TEST(DirectSessionTest, SessionSyncRun) {
             static_cast<int64>(outputs[0].scalar<int64>()()));
 }
 
+TEST(DirectSessionTest, BoundedConcurrentStepAdmission) {
+  setenv("TF_SESSION_MAX_CONCURRENT_STEPS", "2", 1);
+  Graph g(OpRegistry::Global());
+  Tensor vx(DT_FLOAT, TensorShape({}));
+  vx.scalar<float>()() = 42.0f;
+  Node* x = test::graph::Constant(&g, vx);
+  GraphDef def;
+  test::graph::ToGraphDef(&g, &def);
+  auto sess = CreateSession();
+  TF_ASSERT_OK(sess->Create(def));
+  // Issue many more concurrent Run() calls than the gate admits; every
+  // call must still be admitted eventually and produce the right value.
+  {
+    thread::ThreadPool pool(Env::Default(), "admission_test", 8);
+    for (int i = 0; i < 32; ++i) {
+      pool.Schedule([&sess, x]() {
+        std::vector<Tensor> outputs;
+        TF_EXPECT_OK(sess->Run({}, {x->name() + ":0"}, {}, &outputs));
+        ASSERT_EQ(1, outputs.size());
+        EXPECT_EQ(42.0f, outputs[0].scalar<float>()());
+      });
+    }
+  }
+  unsetenv("TF_SESSION_MAX_CONCURRENT_STEPS");
+}
+
+TEST(DirectSessionTest, ShapeSpecializedExecutors) {
+  setenv("TF_SESSION_SHAPE_SPECIALIZATION_LIMIT", "2", 1);
+  Graph g(OpRegistry::Global());
+  Tensor vx(DT_FLOAT, TensorShape({2}));
+  vx.flat<float>().setZero();
+  Node* x = test::graph::Constant(&g, vx);
+  Node* y = test::graph::Identity(&g, x);
+  GraphDef def;
+  test::graph::ToGraphDef(&g, &def);
+  auto sess = CreateSession();
+  TF_ASSERT_OK(sess->Create(def));
+  // Feed several distinct shapes and revisit each of them.  The first
+  // two signatures get specialized executors, the third exceeds the
+  // limit and falls back to the shared set; all must produce the fed
+  // value unchanged.
+  for (int64 size : {2, 3, 4, 2, 3, 4}) {
+    Tensor feed(DT_FLOAT, TensorShape({size}));
+    for (int64 i = 0; i < size; ++i) {
+      feed.flat<float>()(i) = size * 10.0f + i;
+    }
+    std::vector<Tensor> outputs;
+    TF_ASSERT_OK(
+        sess->Run({{x->name(), feed}}, {y->name() + ":0"}, {}, &outputs));
+    ASSERT_EQ(1, outputs.size());
+    test::ExpectTensorEqual<float>(feed, outputs[0]);
+  }
+  unsetenv("TF_SESSION_SHAPE_SPECIALIZATION_LIMIT");
+}
+
 REGISTER_OP("Darth").Input("x: float").Output("y: float").Doc(R"doc(
 Darth promises one return value.
 
@@ -40,6 +40,35 @@ bool ReadBoolFromEnvVar(StringPiece env_var_name, bool default_val) {
   return default_val;
 }
 
+// Generates a process-unique id for each EagerContext, used to scope
+// per-thread kernel cache entries to the context that created them.
+uint64 NextContextId() {
+  static std::atomic<uint64> next_id{1};
+  return next_id.fetch_add(1);
+}
+
+bool ThreadLocalKernelCacheEnabled() {
+  static bool enabled =
+      ReadBoolFromEnvVar("TF_EAGER_THREAD_LOCAL_KERNEL_CACHE", false);
+  return enabled;
+}
+
+// Per-thread lookaside over EagerContext::kernel_cache_ that serves repeat
+// kernel lookups without taking cache_mu_.  The entries are raw pointers
+// owned by the shared cache; `context_id` and `generation` are checked on
+// every lookup so that entries from another context or from before a
+// ClearCaches() call are discarded rather than dereferenced.
+struct ThreadLocalKernelCache {
+  uint64 context_id = 0;
+  uint64 generation = 0;
+  std::unordered_map<Fprint128, KernelAndDevice*, Fprint128Hasher> kernels;
+};
+
+ThreadLocalKernelCache* GetThreadLocalKernelCache() {
+  static thread_local ThreadLocalKernelCache cache;
+  return &cache;
+}
+
 }  // namespace
 
 EagerContext::EagerContext(const SessionOptions& opts,
@@ -61,6 +90,7 @@ EagerContext::EagerContext(const SessionOptions& opts,
       pflr_(new ProcessFunctionLibraryRuntime(
           device_mgr, opts.env, TF_GRAPH_DEF_VERSION, &func_lib_def_,
           opts.config.graph_options().optimizer_options(), thread_pool_.get())),
+      context_id_(NextContextId()),
       log_device_placement_(opts.config.log_device_placement()),
       num_active_steps_(0),
       async_default_(async),
@@ -68,7 +98,9 @@ EagerContext::EagerContext(const SessionOptions& opts,
       env_(opts.env),
       use_send_tensor_rpc_(false),
       pin_small_ops_to_cpu_(ReadBoolFromEnvVar(
-          "TF_EAGER_ENABLE_SMALL_TENSOR_CPU_PINNING", false)) {
+          "TF_EAGER_ENABLE_SMALL_TENSOR_CPU_PINNING", false)),
+      pool_eager_buffers_(
+          ReadBoolFromEnvVar("TF_EAGER_ENABLE_BUFFER_POOL", false)) {
   if (device_mgr_owned) {
     local_device_manager_.reset(device_mgr);
     local_unowned_device_manager_ = nullptr;
@@ -138,10 +170,24 @@ Status EagerContext::SetAsyncForThread(bool async) {
 }
 
 void EagerContext::ClearCaches() {
+  // Advance the generation first so per-thread lookaside entries are
+  // invalidated before the kernels they point to are deleted.
+  kernel_cache_generation_.fetch_add(1, std::memory_order_release);
   mutex_lock ml(cache_mu_);
   gtl::STLDeleteValues(&kernel_cache_);
 }
 
+Allocator* EagerContext::GetPooledAllocator(Device* d) {
+  if (!pool_eager_buffers_ || d == nullptr) return nullptr;
+  Allocator* base = d->GetAllocator(AllocatorAttributes());
+  mutex_lock l(buffer_pool_mu_);
+  std::unique_ptr<TensorBufferPool>& pool = buffer_pools_[base];
+  if (pool == nullptr) {
+    pool.reset(new TensorBufferPool(base));
+  }
+  return pool.get();
+}
+
 void EagerContext::SetThreadLocalDevicePlacementPolicy(
     ContextDevicePlacementPolicy policy) {
   mutex_lock ml(policy_map_mu_);
@@ -341,14 +387,46 @@ Status EagerContext::AddFunctionDef(const FunctionDef& fdef) {
 }
 
 KernelAndDevice* EagerContext::GetCachedKernel(Fprint128 cache_key) {
+  if (ThreadLocalKernelCacheEnabled()) {
+    ThreadLocalKernelCache* cache = GetThreadLocalKernelCache();
+    const uint64 generation =
+        kernel_cache_generation_.load(std::memory_order_acquire);
+    if (cache->context_id != context_id_ || cache->generation != generation) {
+      cache->context_id = context_id_;
+      cache->generation = generation;
+      cache->kernels.clear();
+    } else {
+      KernelAndDevice* kernel = gtl::FindPtrOrNull(cache->kernels, cache_key);
+      if (kernel != nullptr) return kernel;
+    }
+    KernelAndDevice* kernel;
+    {
+      tf_shared_lock l(cache_mu_);
+      kernel = gtl::FindPtrOrNull(kernel_cache_, cache_key);
+    }
+    if (kernel != nullptr) {
+      cache->kernels[cache_key] = kernel;
+    }
+    return kernel;
+  }
   tf_shared_lock l(cache_mu_);
   return gtl::FindPtrOrNull(kernel_cache_, cache_key);
 }
 
 void EagerContext::AddKernelToCache(Fprint128 cache_key,
                                     KernelAndDevice* kernel) {
-  mutex_lock ml(cache_mu_);
-  gtl::InsertOrUpdate(&kernel_cache_, cache_key, kernel);
+  {
+    mutex_lock ml(cache_mu_);
+    gtl::InsertOrUpdate(&kernel_cache_, cache_key, kernel);
+  }
+  if (ThreadLocalKernelCacheEnabled()) {
+    ThreadLocalKernelCache* cache = GetThreadLocalKernelCache();
+    if (cache->context_id == context_id_ &&
+        cache->generation ==
+            kernel_cache_generation_.load(std::memory_order_acquire)) {
+      cache->kernels[cache_key] = kernel;
+    }
+  }
 }
 
 bool EagerContext::ShouldStoreGraphs() {
@@ -27,6 +27,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 #include "tensorflow/core/common_runtime/eager/kernel_and_device.h"
+#include "tensorflow/core/common_runtime/eager/tensor_buffer_pool.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/common_runtime/rendezvous_mgr.h"
 #include "tensorflow/core/example/example.pb.h"
@@ -157,6 +158,12 @@ class EagerContext {
   bool LogDevicePlacement() const { return log_device_placement_; }
   bool LogMemory() const { return log_memory_; }
 
+  // Returns a recycling pool in front of `d`'s default allocator, or nullptr
+  // if buffer pooling is disabled (TF_EAGER_ENABLE_BUFFER_POOL). The pool is
+  // owned by this context; one pool is shared by all kernels whose device
+  // resolves to the same allocator.
+  Allocator* GetPooledAllocator(Device* d);
+
   Rendezvous* GetRendezvous() const { return rendezvous_; }
   CollectiveExecutorMgrInterface* collective_executor_mgr() {
     return (collective_executor_mgr_ != nullptr)
@@ -284,6 +291,12 @@ class EagerContext {
   std::unordered_map<Fprint128, KernelAndDevice*, Fprint128Hasher> kernel_cache_
       GUARDED_BY(cache_mu_);
 
+  // Process-unique id for this context, used to scope per-thread kernel
+  // cache entries to the context that created them.
+  const uint64 context_id_;
+  // Bumped by ClearCaches() to invalidate per-thread kernel cache entries.
+  std::atomic<uint64> kernel_cache_generation_{0};
+
   // Whether we should compute RunMetadata.
   std::atomic<bool> should_store_step_stats_{false};
   std::atomic<bool> should_store_graphs_{false};
@@ -340,6 +353,14 @@ class EagerContext {
 
   bool use_send_tensor_rpc_;
   const bool pin_small_ops_to_cpu_;
+
+  // Lazily-created buffer recycling pools, keyed by the underlying device
+  // allocator. See tensor_buffer_pool.h.
+  const bool pool_eager_buffers_;
+  mutex buffer_pool_mu_;
+  std::unordered_map<Allocator*, std::unique_ptr<TensorBufferPool>>
+      buffer_pools_ GUARDED_BY(buffer_pool_mu_);
+
   std::vector<std::unique_ptr<tensorflow::Thread>> child_threads_;
 };
 
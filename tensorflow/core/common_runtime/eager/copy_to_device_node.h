@@ -55,6 +55,8 @@ class CopyToDeviceNode : public EagerNode {
 
   TensorHandle* dst() { return dst_; }
 
+  Device* device() const override { return dstd_; }
+
  private:
   TensorHandle* src_;
   Device* dstd_;
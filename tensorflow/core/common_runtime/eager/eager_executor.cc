@@ -15,7 +15,25 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/eager/eager_executor.h"
 
+#include "tensorflow/core/util/env_var.h"
+
 namespace tensorflow {
+namespace {
+
+// If true, nodes are dispatched to one queue and thread per target device
+// rather than executed in order on a single thread. See the class comment
+// in eager_executor.h for the ordering and dependency guarantees.
+bool PerDeviceQueuesEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_EAGER_PER_DEVICE_QUEUES",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+}  // namespace
 
 EagerNode::EagerNode(tensorflow::uint64 id) : id(id) {}
 
@@ -23,6 +41,7 @@ EagerExecutor::~EagerExecutor() {
   tensorflow::mutex_lock l(node_queue_mutex_);
   thread_done_ = true;
   nodes_pending_.notify_all();
+  node_done_.notify_all();
 }
 
 tensorflow::uint64 EagerExecutor::NextId() {
@@ -32,6 +51,10 @@ tensorflow::uint64 EagerExecutor::NextId() {
 
 void EagerExecutor::EnableAsync() {
   tensorflow::mutex_lock l(node_queue_mutex_);
+  if (PerDeviceQueuesEnabled()) {
+    // Per-device threads are started lazily by Add() as devices show up.
+    return;
+  }
   if (thread_ == nullptr) {
     thread_.reset(tensorflow::Env::Default()->StartThread(
         tensorflow::ThreadOptions(), "eager_async_executor",
@@ -41,11 +64,33 @@ void EagerExecutor::EnableAsync() {
 
 void EagerExecutor::Add(EagerNode* node) {
   tensorflow::mutex_lock l(node_queue_mutex_);
-  DCHECK(thread_) << "EnableAsync should have been called before Add";
   if (!status_.ok()) {
     delete node;
     return;
   }
+  if (PerDeviceQueuesEnabled()) {
+    if (last_enqueued_id_ >= node->id) {
+      status_ = tensorflow::errors::InvalidArgument(
+          "Inserting EagerNode with non-increasing ids:", last_enqueued_id_,
+          " vs ", node->id);
+      delete node;
+      return;
+    }
+    last_enqueued_id_ = node->id;
+    std::unique_ptr<DeviceQueue>& queue = device_queues_[node->device()];
+    if (queue == nullptr) {
+      queue.reset(new DeviceQueue);
+      DeviceQueue* raw_queue = queue.get();
+      queue->thread.reset(tensorflow::Env::Default()->StartThread(
+          tensorflow::ThreadOptions(), "eager_async_executor",
+          [this, raw_queue]() { RunDeviceQueue(raw_queue); }));
+    }
+    unfinished_node_ids_.insert(node->id);
+    queue->queue.push(node);
+    nodes_pending_.notify_all();
+    return;
+  }
+  DCHECK(thread_) << "EnableAsync should have been called before Add";
   int64 qlen = node_queue_.size();
   if (qlen > 0) {
     if (node_queue_.back()->id >= node->id) {
@@ -72,6 +117,22 @@ tensorflow::Status EagerExecutor::WaitForAllPendingNodes() {
 
 tensorflow::Status EagerExecutor::WaitImpl(bool wait_all,
                                            tensorflow::uint64 node_id) {
+  if (PerDeviceQueuesEnabled()) {
+    tensorflow::mutex_lock l(node_queue_mutex_);
+    // Nodes complete out of order across device queues, so wait on the
+    // unfinished-id set rather than on queue positions. A node id that was
+    // never added, or has already finished, is simply absent from the set.
+    if (wait_all) {
+      while (status_.ok() && !unfinished_node_ids_.empty()) {
+        node_done_.wait(l);
+      }
+    } else {
+      while (status_.ok() && unfinished_node_ids_.count(node_id) > 0) {
+        node_done_.wait(l);
+      }
+    }
+    return status_;
+  }
   tensorflow::condition_variable cond;
   tensorflow::mutex_lock l(node_queue_mutex_);
   // Don't wait if an error is already set.
@@ -98,6 +159,7 @@ void EagerExecutor::ClearError() {
   // been cleared, and no new entries should have been added since.
   DCHECK(node_done_notifications_.empty());
   DCHECK(node_queue_.empty());
+  DCHECK(unfinished_node_ids_.empty());
   status_ = tensorflow::Status::OK();
   nodes_pending_.notify_all();
 }
@@ -149,4 +211,42 @@ void EagerExecutor::Run() {
   }
 }
 
+void EagerExecutor::RunDeviceQueue(DeviceQueue* queue) {
+  while (true) {
+    std::unique_ptr<EagerNode> curr_node;
+    {
+      tensorflow::mutex_lock l(node_queue_mutex_);
+      while (queue->queue.empty() || !status_.ok()) {
+        if (thread_done_) return;
+        nodes_pending_.wait(l);
+      }
+      curr_node.reset(queue->queue.front());
+      queue->queue.pop();
+    }
+    // The node may block here on its inputs; per the ordering argument in
+    // the class comment this cannot deadlock with the other device queues.
+    tensorflow::Status status = curr_node->Run();
+    tensorflow::mutex_lock l(node_queue_mutex_);
+    unfinished_node_ids_.erase(curr_node->id);
+    if (!status.ok()) {
+      status_ = status;
+      ClearDeviceQueues();
+    }
+    // Notify all waiters; on error they are responsible for checking
+    // status_ before proceeding.
+    node_done_.notify_all();
+  }
+}
+
+void EagerExecutor::ClearDeviceQueues() {
+  for (auto& entry : device_queues_) {
+    std::queue<EagerNode*>* queue = &entry.second->queue;
+    while (!queue->empty()) {
+      unfinished_node_ids_.erase(queue->front()->id);
+      delete queue->front();
+      queue->pop();
+    }
+  }
+}
+
 }  // namespace tensorflow
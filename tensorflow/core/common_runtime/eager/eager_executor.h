@@ -20,6 +20,7 @@ limitations under the License.
 #include <map>
 #include <memory>
 #include <queue>
+#include <set>
 #include <string>
 #include <thread>
 #include <vector>
@@ -50,6 +51,11 @@ class EagerNode {
   // execution is done.
   virtual Status Run() = 0;
 
+  // The device this node's work runs on, or nullptr if not known. Used to
+  // pick a per-device execution queue when TF_EAGER_PER_DEVICE_QUEUES is
+  // set; nodes with unknown devices share one queue.
+  virtual Device* device() const { return nullptr; }
+
   // An id unique to the TFE_Context under which this node is created. Allocated
   // monotonically.
   const uint64 id;
@@ -61,9 +67,16 @@ class EagerNode {
 // device of the input handle. Fix that.
 // TODO(agarwal): On error, mark all affected handles as corrupted.
 // TODO(agarwal): Implement support for control dependencies.
-// TODO(agarwal): Support out-of-order execution and dispatching multiple
-// EagerNode in parallel.
 // TODO(agarwal): Implement optimizations over EagerNode traces.
+//
+// By default all nodes run in order on a single background thread. With
+// TF_EAGER_PER_DEVICE_QUEUES=1, nodes are instead dispatched to one queue
+// (and thread) per target device, so independent ops on different devices
+// run concurrently. Order is still preserved per device, and cross-device
+// dependencies are enforced by the consuming node blocking on its input
+// handles (TensorHandle::WaitReady calls back into WaitFor). Since node
+// ids are allocated in program order, a node can only ever wait on nodes
+// with smaller ids, which per-device FIFO dispatch cannot deadlock on.
 class EagerExecutor {
  public:
   ~EagerExecutor();
@@ -95,12 +108,27 @@ class EagerExecutor {
   Status status();
 
  private:
+  // State for one per-device execution queue. `thread` is declared after
+  // `queue` so that destruction joins the thread before the queue goes away.
+  struct DeviceQueue {
+    std::queue<EagerNode*> queue;
+    std::unique_ptr<Thread> thread;
+  };
+
   // Starts execution of pending EagerNodes. This function loops till
   // thread_done_ is set to true. If any errors are encontered, these are set
   // inside `status_`. The loop blocks anytime there are no pending nodes, or if
   // `status_` is not ok.
   void Run();
 
+  // Like Run(), but drains only `queue`'s nodes. Used when per-device
+  // queues are enabled; one such loop runs per device.
+  void RunDeviceQueue(DeviceQueue* queue);
+
+  // Deletes all pending nodes in all device queues and drops their ids from
+  // unfinished_node_ids_. Called after an execution error.
+  void ClearDeviceQueues() EXCLUSIVE_LOCKS_REQUIRED(node_queue_mutex_);
+
   Status WaitImpl(bool wait_all, uint64 node_id);
 
   mutex node_queue_mutex_;
@@ -125,6 +153,26 @@ class EagerExecutor {
   // for executing the EagerNodes one-by-one.
   std::unique_ptr<Thread> thread_ GUARDED_BY(node_queue_mutex_);
 
+  // Ids of nodes that have been added but have not finished executing.
+  // Maintained only when per-device queues are enabled, where completion is
+  // out of order across devices.
+  std::set<uint64> unfinished_node_ids_ GUARDED_BY(node_queue_mutex_);
+
+  // Notified every time a node finishes when per-device queues are enabled;
+  // WaitImpl waits on this instead of node_done_notifications_.
+  condition_variable node_done_ GUARDED_BY(node_queue_mutex_);
+
+  // Id of the most recently added node, used to check that ids still arrive
+  // in increasing order when nodes are spread over several queues.
+  uint64 last_enqueued_id_ GUARDED_BY(node_queue_mutex_) = 0;
+
+  // Per-device queues, used only when TF_EAGER_PER_DEVICE_QUEUES is set.
+  // Keyed by EagerNode::device(); nodes with a null device share one queue.
+  // Declared after the state the queue threads touch, so that destruction
+  // joins the threads before that state goes away.
+  std::map<const Device*, std::unique_ptr<DeviceQueue>> device_queues_
+      GUARDED_BY(node_queue_mutex_);
+
   // Indicates that `thread_` should stop as soon as it is done executing the
   // current EagerNode.
   bool thread_done_ GUARDED_BY(node_queue_mutex_) = false;
@@ -424,7 +424,8 @@ Status EagerLocalExecute(EagerOperation* op,
               << ". Full node_def=" << ndef.DebugString();
       kernel = new KernelAndDeviceOp(
           ctx->GetRendezvous(), ctx->LogMemory(), flr, ctx->runner(),
-          ctx->GetCollectiveExecutorHandle(), ctx->HostCPU());
+          ctx->GetCollectiveExecutorHandle(), ctx->HostCPU(),
+          ctx->GetPooledAllocator(flr->device()));
     }
 
     status = kernel->Init(ndef, graph_collector);
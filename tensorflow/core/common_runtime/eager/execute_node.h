@@ -77,6 +77,8 @@ class ExecuteNode : public EagerNode {
     }
   }
 
+  tensorflow::Device* device() const override { return op_device_; }
+
  private:
   tensorflow::EagerContext* ctx_;
   tensorflow::Device* op_device_;
@@ -200,6 +200,7 @@ Status KernelAndDeviceOp::Run(ScopedStepContainer* step_container,
   params.inputs = &inputs;
   params.op_kernel = kernel_.get();
   params.resource_manager = device_->resource_manager();
+  params.allocator_override = allocator_override_;
   params.output_attr_array = gtl::vector_as_array(&out_attrs);
   params.function_library = flr_;
   params.slice_reader_cache = &slice_reader_cache_;
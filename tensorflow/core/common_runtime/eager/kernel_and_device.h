@@ -125,16 +125,20 @@ class KernelAndDevice {
 // Represents an op kernel and the device it will be run on.
 class KernelAndDeviceOp final : public KernelAndDevice {
  public:
+  // `allocator_override` may be null; if set, kernel allocations with
+  // default allocator attributes are served from it instead of the device
+  // allocator (see EagerContext::GetPooledAllocator).
   KernelAndDeviceOp(
       tensorflow::Rendezvous* rendez, bool log_memory,
       FunctionLibraryRuntime* flr,
       std::function<void(std::function<void()>)>* runner,
       std::unique_ptr<CollectiveExecutor::Handle> collective_executor,
-      Device* host_cpu_device)
+      Device* host_cpu_device, Allocator* allocator_override = nullptr)
       : KernelAndDevice(flr, runner, std::move(collective_executor),
                         host_cpu_device),
         rendez_(rendez),
-        log_memory_(log_memory) {}
+        log_memory_(log_memory),
+        allocator_override_(allocator_override) {}
 
   virtual ~KernelAndDeviceOp();
 
@@ -165,6 +169,7 @@ class KernelAndDeviceOp final : public KernelAndDevice {
   Rendezvous* const rendez_;
   checkpoint::TensorSliceReaderCacheWrapper slice_reader_cache_;
   const bool log_memory_;
+  Allocator* const allocator_override_;
 
   // For deferred ops, AsyncOpKernel::DoneCallback is called once the op is
   // enqueued to device. The execution of the op may not finish when
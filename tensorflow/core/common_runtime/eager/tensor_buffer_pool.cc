@@ -0,0 +1,109 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/eager/tensor_buffer_pool.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/strings/strcat.h"
+
+namespace tensorflow {
+
+TensorBufferPool::TensorBufferPool(Allocator* base)
+    : base_(base), name_(strings::StrCat("pooled_", base->Name())) {}
+
+TensorBufferPool::~TensorBufferPool() { Clear(); }
+
+void* TensorBufferPool::AllocateRaw(size_t alignment, size_t num_bytes) {
+  // Tensor buffers are all requested at kAllocatorAlignment; anything else
+  // is rare enough that it is not worth tracking per-alignment buckets.
+  if (num_bytes == 0 || alignment > Allocator::kAllocatorAlignment) {
+    return base_->AllocateRaw(alignment, num_bytes);
+  }
+  {
+    mutex_lock l(mu_);
+    auto it = free_buffers_.find(num_bytes);
+    if (it != free_buffers_.end() && !it->second.empty()) {
+      void* ptr = it->second.back();
+      it->second.pop_back();
+      parked_bytes_ -= num_bytes;
+      in_use_bytes_ += num_bytes;
+      watermark_bytes_ = std::max(watermark_bytes_, in_use_bytes_);
+      live_sizes_[ptr] = num_bytes;
+      return ptr;
+    }
+  }
+  void* ptr = base_->AllocateRaw(alignment, num_bytes);
+  if (ptr != nullptr) {
+    mutex_lock l(mu_);
+    live_sizes_[ptr] = num_bytes;
+    in_use_bytes_ += num_bytes;
+    watermark_bytes_ = std::max(watermark_bytes_, in_use_bytes_);
+  }
+  return ptr;
+}
+
+void TensorBufferPool::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) return;
+  {
+    mutex_lock l(mu_);
+    auto it = live_sizes_.find(ptr);
+    if (it != live_sizes_.end()) {
+      const size_t num_bytes = it->second;
+      live_sizes_.erase(it);
+      in_use_bytes_ -= num_bytes;
+      if (in_use_bytes_ + parked_bytes_ + num_bytes <= watermark_bytes_) {
+        free_buffers_[num_bytes].push_back(ptr);
+        parked_bytes_ += num_bytes;
+        ptr = nullptr;  // Parked; nothing left to free.
+      }
+      if (++frees_since_trim_ >= kTrimInterval) {
+        frees_since_trim_ = 0;
+        watermark_bytes_ =
+            in_use_bytes_ + (watermark_bytes_ - in_use_bytes_) / 2;
+        TrimLocked();
+      }
+    }
+    // A pointer not in live_sizes_ took the pass-through path in
+    // AllocateRaw; hand it straight back to the underlying allocator.
+  }
+  if (ptr != nullptr) base_->DeallocateRaw(ptr);
+}
+
+void TensorBufferPool::TrimLocked() {
+  while (in_use_bytes_ + parked_bytes_ > watermark_bytes_ &&
+         !free_buffers_.empty()) {
+    auto it = free_buffers_.rbegin();
+    base_->DeallocateRaw(it->second.back());
+    it->second.pop_back();
+    parked_bytes_ -= it->first;
+    if (it->second.empty()) {
+      free_buffers_.erase(it->first);
+    }
+  }
+}
+
+void TensorBufferPool::Clear() {
+  mutex_lock l(mu_);
+  for (const auto& bucket : free_buffers_) {
+    for (void* ptr : bucket.second) {
+      base_->DeallocateRaw(ptr);
+    }
+  }
+  free_buffers_.clear();
+  parked_bytes_ = 0;
+}
+
+}  // namespace tensorflow
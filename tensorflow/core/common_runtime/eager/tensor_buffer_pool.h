@@ -0,0 +1,102 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_TENSOR_BUFFER_POOL_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_TENSOR_BUFFER_POOL_H_
+
+#include <map>
+#include <unordered_map>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A size-bucketed recycling pool in front of a device allocator.
+//
+// Eager execution allocates and frees each op's output buffers on every
+// call; iterative workloads that run the same ops over the same shapes pay
+// the device allocator (BFC locking on GPU, malloc on CPU) for the identical
+// set of buffers every step. When a buffer that was handed out by this pool
+// is freed -- typically because the last TensorHandle referencing it was
+// destroyed -- it is parked in a free list keyed by its byte size and
+// satisfies the next same-sized request without touching the underlying
+// allocator.
+//
+// Trimming is watermark based: the pool never holds more bytes (in-use plus
+// parked) than the observed peak in-use footprint, and the watermark decays
+// toward the current footprint every kTrimInterval frees so a workload phase
+// change releases memory back to the device allocator.
+//
+// Thread-safe. The underlying allocator must outlive the pool.
+class TensorBufferPool : public Allocator {
+ public:
+  explicit TensorBufferPool(Allocator* base);
+  ~TensorBufferPool() override;
+
+  string Name() override { return name_; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+
+  // Size queries are answered by the underlying allocator; pooled pointers
+  // remain live allocations from its point of view.
+  bool TracksAllocationSizes() override {
+    return base_->TracksAllocationSizes();
+  }
+  size_t RequestedSize(const void* ptr) override {
+    return base_->RequestedSize(ptr);
+  }
+  size_t AllocatedSize(const void* ptr) override {
+    return base_->AllocatedSize(ptr);
+  }
+  int64 AllocationId(const void* ptr) override {
+    return base_->AllocationId(ptr);
+  }
+
+  // Releases all parked buffers back to the underlying allocator.
+  void Clear();
+
+ private:
+  // Decay the watermark every this many frees.
+  static const int64 kTrimInterval = 1024;
+
+  // Frees parked buffers, largest first, until the pool fits under the
+  // watermark again.
+  void TrimLocked() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Allocator* const base_;
+  const string name_;
+
+  mutex mu_;
+  // Byte sizes of outstanding allocations made through this pool.
+  std::unordered_map<const void*, size_t> live_sizes_ GUARDED_BY(mu_);
+  // Parked buffers, keyed by byte size.
+  std::map<size_t, std::vector<void*>> free_buffers_ GUARDED_BY(mu_);
+  size_t in_use_bytes_ GUARDED_BY(mu_) = 0;
+  size_t parked_bytes_ GUARDED_BY(mu_) = 0;
+  size_t watermark_bytes_ GUARDED_BY(mu_) = 0;
+  int64 frees_since_trim_ GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(TensorBufferPool);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_EAGER_TENSOR_BUFFER_POOL_H_
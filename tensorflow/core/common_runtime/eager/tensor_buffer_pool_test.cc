@@ -0,0 +1,72 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/eager/tensor_buffer_pool.h"
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(TensorBufferPoolTest, RecyclesSameSizedBuffers) {
+  TensorBufferPool pool(cpu_allocator());
+  void* first = pool.AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  ASSERT_NE(first, nullptr);
+  // Establish a watermark above one buffer so the free below is parked.
+  void* second = pool.AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  ASSERT_NE(second, nullptr);
+  pool.DeallocateRaw(second);
+  void* reused = pool.AllocateRaw(Allocator::kAllocatorAlignment, 1024);
+  EXPECT_EQ(second, reused);
+  pool.DeallocateRaw(first);
+  pool.DeallocateRaw(reused);
+}
+
+TEST(TensorBufferPoolTest, DifferentSizesDoNotAlias) {
+  TensorBufferPool pool(cpu_allocator());
+  void* small = pool.AllocateRaw(Allocator::kAllocatorAlignment, 256);
+  void* large = pool.AllocateRaw(Allocator::kAllocatorAlignment, 4096);
+  pool.DeallocateRaw(small);
+  void* other = pool.AllocateRaw(Allocator::kAllocatorAlignment, 4096);
+  EXPECT_NE(small, other);
+  pool.DeallocateRaw(large);
+  pool.DeallocateRaw(other);
+}
+
+TEST(TensorBufferPoolTest, OversizedAlignmentPassesThrough) {
+  TensorBufferPool pool(cpu_allocator());
+  void* ptr =
+      pool.AllocateRaw(2 * Allocator::kAllocatorAlignment, 1 << 20);
+  ASSERT_NE(ptr, nullptr);
+  pool.DeallocateRaw(ptr);
+}
+
+TEST(TensorBufferPoolTest, ClearReleasesParkedBuffers) {
+  TensorBufferPool pool(cpu_allocator());
+  void* a = pool.AllocateRaw(Allocator::kAllocatorAlignment, 512);
+  void* b = pool.AllocateRaw(Allocator::kAllocatorAlignment, 512);
+  pool.DeallocateRaw(b);
+  pool.Clear();
+  // The parked buffer was released; a fresh allocation must not assume it is
+  // still owned by the pool.
+  void* c = pool.AllocateRaw(Allocator::kAllocatorAlignment, 512);
+  ASSERT_NE(c, nullptr);
+  pool.DeallocateRaw(a);
+  pool.DeallocateRaw(c);
+}
+
+}  // namespace
+}  // namespace tensorflow
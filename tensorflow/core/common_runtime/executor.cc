@@ -24,7 +24,10 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/common_runtime/executor_factory.h"
+#include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/common_runtime/pending_counts.h"
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -56,6 +59,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/context.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
@@ -64,6 +68,7 @@ limitations under the License.
 #include "tensorflow/core/platform/thread_annotations.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/tensor_slice_reader_cache.h"
 
 namespace tensorflow {
@@ -76,6 +81,124 @@ bool IsInitializationOp(const Node* node) {
   return node->op_def().allows_uninitialized_input();
 }
 
+// Returns true if cross-thread dispatch of ready nodes should go through a
+// sharded work-stealing queue instead of one thread-pool closure per node.
+// On hosts with many executor threads the per-node closure hand-off
+// serializes on the thread pool's queue; the sharded queue amortizes that
+// cost over batches of ready nodes.  Off by default.  Deliberately not
+// cached: this runs once per ExecutorState (i.e. once per step), so the
+// environment lookup is noise, and reading it each time lets tests toggle
+// the sharded path.
+bool UseShardedReadyQueue() {
+  bool enabled = false;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_EXECUTOR_USE_SHARDED_READY_QUEUE", false,
+                                 &enabled));
+  return enabled;
+}
+
+// Returns true if temporary tensors of a step should be served from a
+// per-step arena on CPU devices.
+bool UseStepArena() {
+  static bool use_step_arena = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_EXECUTOR_STEP_ARENA", false, &enabled));
+    return enabled;
+  }();
+  return use_step_arena;
+}
+
+// Returns the number of warmup steps after which an executor installs a
+// static memory plan for its CPU temporaries, or 0 if planning is
+// disabled (see StaticMemoryPlanner).  Intended for fixed-shape
+// inference graphs whose allocation behaviour repeats every step.
+int64 StaticMemoryPlanWarmupSteps() {
+  static int64 warmup_steps = [] {
+    int64 steps = 0;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_EXECUTOR_STATIC_MEMORY_PLAN_STEPS", 0,
+                                    &steps));
+    return steps;
+  }();
+  return warmup_steps;
+}
+
+// Returns true if the executor should compute step-invariant subgraphs
+// (nodes whose entire fanin is free of feeds, variables and other state)
+// once and reuse the resulting tensors for every subsequent step.  Off by
+// default: the reused tensors are pinned for the lifetime of the executor.
+bool MemoizeStepInvariantNodes() {
+  static bool memoize = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_EXECUTOR_MEMOIZE_CONSTANTS", false,
+                                   &enabled));
+    return enabled;
+  }();
+  return memoize;
+}
+
+// When positive, the executor attributes its own CPU cycles to runtime
+// phases (input preparation, kernel compute, output propagation, completion
+// bookkeeping) and logs a machine-readable per-executor breakdown every
+// this many completed steps.  Off (0) by default.
+int64 PhaseProfileSteps() {
+  static int64 interval = [] {
+    int64 steps = 0;
+    TF_CHECK_OK(
+        ReadInt64FromEnvVar("TF_EXECUTOR_PHASE_PROFILE_STEPS", 0, &steps));
+    return steps;
+  }();
+  return interval;
+}
+
+// Returns true for forwarding and shape-metadata ops that do (almost) no
+// work: they forward or alias their input buffer, or produce a small shape
+// tensor.  Such nodes are always executed inline on the thread that made
+// them ready instead of taking a round trip through the thread pool, and
+// they skip the per-run cost timing that dynamic expensiveness tracking
+// needs.  Note that OpKernel::IsExpensive() reports these kernels as
+// expensive for their first several runs, until the decayed cost estimate
+// drops below the threshold; the static list avoids both that warm-up and
+// the virtual call.
+bool IsInlineMetadataOp(const string& op_type) {
+  static const gtl::FlatSet<string>* inline_ops = new gtl::FlatSet<string>{
+      "BroadcastGradientArgs",
+      "Const",
+      "ExpandDims",
+      "Identity",
+      "IdentityN",
+      "NoOp",
+      "PreventGradient",
+      "Rank",
+      "RefIdentity",
+      "Reshape",
+      "Shape",
+      "ShapeN",
+      "Size",
+      "Snapshot",
+      "Squeeze",
+      "StopGradient",
+  };
+  return inline_ops->count(op_type) > 0;
+}
+
+// Returns true if ops of the given type must not allocate temps from the
+// step arena.  The arena retains its blocks until every allocation has been
+// freed, so ops known to hold temp buffers well past the step can be listed
+// in TF_EXECUTOR_STEP_ARENA_EXCLUDED_OPS (comma-separated op type names) to
+// keep them from pinning the arena's memory.
+bool IsStepArenaExcluded(const string& op_type) {
+  static const gtl::FlatSet<string>* excluded = [] {
+    auto* result = new gtl::FlatSet<string>;
+    const char* env = getenv("TF_EXECUTOR_STEP_ARENA_EXCLUDED_OPS");
+    if (env != nullptr) {
+      for (const string& op : str_util::Split(env, ',')) {
+        result->insert(op);
+      }
+    }
+    return result;
+  }();
+  return excluded->count(op_type) > 0;
+}
+
 // Helper routines for collecting step stats.
 namespace nodestats {
 inline int64 NowInNsec() { return Env::Default()->NowNanos(); }
@@ -144,6 +267,32 @@ struct KernelTimer {
   }
 };
 
+// Cycle sampler for the executor's phase profile.  Each Process() call
+// owns one, laps it around the phases of interest and flushes the local
+// totals to the executor's shared counters once on exit, so profiling
+// costs a handful of cycle reads per node and no shared-cache traffic.
+struct PhaseSampler {
+  const bool enabled;
+  uint64 last;
+
+  explicit PhaseSampler(bool enabled)
+      : enabled(enabled),
+        last(enabled ? profile_utils::CpuUtils::GetCurrentClockCycle() : 0) {}
+
+  // Adds the cycles elapsed since the previous sample to *phase_cycles.
+  inline void Lap(uint64* phase_cycles) {
+    if (!enabled) return;
+    const uint64 now = profile_utils::CpuUtils::GetCurrentClockCycle();
+    *phase_cycles += now - last;
+    last = now;
+  }
+
+  // Moves the sample point without attributing the elapsed cycles.
+  inline void Skip() {
+    if (enabled) last = profile_utils::CpuUtils::GetCurrentClockCycle();
+  }
+};
+
 struct NodeItem {
   NodeItem() {}
 
@@ -163,6 +312,13 @@ struct NodeItem {
   bool is_sink : 1;              // True iff IsSink(node)
   // True iff IsEnter(node) || IsExit(node) || IsNextIteration(node)
   bool is_enter_exit_or_next_iter : 1;
+  // True iff the node's outputs are identical every step (no feeds,
+  // variables or other stateful ops anywhere in its fanin) and may be
+  // memoized across steps.  See ExecutorImpl::MarkStepInvariantNodes.
+  bool is_step_invariant : 1;
+  // True iff the op is a forwarding/metadata op that always runs inline.
+  // See IsInlineMetadataOp.
+  bool is_inline_op : 1;
 
   // Cached values of node->num_inputs() and node->num_outputs(), to
   // avoid levels of indirection.
@@ -273,7 +429,12 @@ class GraphView {
   }
 
  private:
-  char* InitializeNode(char* ptr, const Node* n);
+  // Slot indices for the attrs InitializeNode reads through AttrSlots.
+  enum { kForwardInputSlot = 0, kScopedAllocatorSlot = 1 };
+
+  // `attr_slots` carries pre-resolved slots for the attrs InitializeNode
+  // reads, so the per-node attr lookups avoid repeated string matching.
+  char* InitializeNode(char* ptr, const Node* n, AttrSlots* attr_slots);
   size_t NodeItemBytes(const Node* n);
 
   int32 num_nodes_ = 0;
@@ -352,10 +513,54 @@ class ExecutorImpl : public Executor {
     }
   };
 
+  // One memoized output tensor of a step-invariant node, together with the
+  // allocator attributes the kernel produced it with.
+  struct MemoizedNodeOutput {
+    Tensor tensor;
+    AllocatorAttributes alloc_attr;
+  };
+
   static Status BuildControlFlowInfo(const Graph* graph,
                                      ControlFlowInfo* cf_info);
   void InitializePending(const Graph* graph, const ControlFlowInfo& cf_info);
 
+  // Sets NodeItem::is_step_invariant for every node whose outputs cannot
+  // change from step to step: the node and its entire fanin are stateless,
+  // live in the root frame and exchange no tensors with other devices or
+  // call frames.  Such nodes are computed once and their outputs memoized.
+  void MarkStepInvariantNodes(const ControlFlowInfo& cf_info);
+
+  // Returns true and fills `outputs` if the outputs of the node with the
+  // given id were memoized by an earlier step.
+  bool GetMemoizedOutputs(int id, std::vector<MemoizedNodeOutput>* outputs);
+
+  // Memoizes the outputs of the node with the given id, unless another step
+  // got there first or the memoization byte budget is exhausted.
+  void MemoizeOutputs(int id, std::vector<MemoizedNodeOutput> outputs);
+
+  // Cycle totals per runtime phase, accumulated across all threads and
+  // steps of this executor when TF_EXECUTOR_PHASE_PROFILE_STEPS is set.
+  // Process() buffers its samples in locals and adds them here once per
+  // call.  The phases are disjoint slices of process_cycles; whatever is
+  // left over is scheduling overhead.  For async kernels only the launch
+  // is attributed to kernel_cycles; their completion callbacks run
+  // outside Process() and are not sampled.
+  struct PhaseProfile {
+    std::atomic<uint64> process_cycles{0};
+    std::atomic<uint64> prepare_inputs_cycles{0};
+    std::atomic<uint64> kernel_cycles{0};
+    std::atomic<uint64> propagate_cycles{0};
+    std::atomic<uint64> node_done_cycles{0};
+    std::atomic<uint64> nodes{0};
+    std::atomic<int64> steps{0};
+  };
+  PhaseProfile phase_profile_;
+
+  // Counts one completed step toward the phase profile; every
+  // TF_EXECUTOR_PHASE_PROFILE_STEPS steps, logs the breakdown of the
+  // window just ended and starts a new one.
+  void RecordPhaseProfileStep();
+
   FrameInfo* EnsureFrameInfo(const string& fname) {
     auto slot = &frame_info_[fname];
     if (*slot == nullptr) {
@@ -380,6 +585,20 @@ class ExecutorImpl : public Executor {
   // the overhead of constructing it for each executor instance.
   gtl::FlatMap<string, FrameInfo*> frame_info_;
 
+  // Outputs of step-invariant nodes, keyed by node id and filled in lazily
+  // by the first step that computes them.  The tensors stay alive for the
+  // lifetime of the executor.
+  static constexpr int64 kMaxMemoizedBytes = 64 << 20;
+  mutex memoize_mu_;
+  gtl::FlatMap<int, std::vector<MemoizedNodeOutput>> memoized_outputs_
+      GUARDED_BY(memoize_mu_);
+  int64 memoized_bytes_ GUARDED_BY(memoize_mu_) = 0;
+
+  // Plans a fixed arena for CPU temporaries once the warmup steps have
+  // completed; non-null iff TF_EXECUTOR_STATIC_MEMORY_PLAN_STEPS > 0 and
+  // the device is a CPU (see StaticMemoryPlanner).
+  std::unique_ptr<StaticMemoryPlanner> memory_planner_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(ExecutorImpl);
 };
 
@@ -441,7 +660,8 @@ size_t GraphView::NodeItemBytes(const Node* n) {
   return bytes;
 }
 
-char* GraphView::InitializeNode(char* ptr, const Node* n) {
+char* GraphView::InitializeNode(char* ptr, const Node* n,
+                                AttrSlots* attr_slots) {
   const int id = n->id();
   CHECK(node_offsets_[id] == kuint32max);  // Initial value in constructor
 
@@ -508,12 +728,12 @@ char* GraphView::InitializeNode(char* ptr, const Node* n) {
 
   // Check ScopedAllocatorAttrs and forward_from.  Also assign output_types.
   {
+    attr_slots->Bind(n->attrs());
     std::vector<int> forward_input;
-    Status fwd_status =
-        GetNodeAttr(n->attrs(), "_forward_input", &forward_input);
+    Status fwd_status = attr_slots->Get(kForwardInputSlot, &forward_input);
     std::vector<int> scoped_allocator_attrs;
     Status sa_status =
-        GetNodeAttr(n->attrs(), "_scoped_allocator", &scoped_allocator_attrs);
+        attr_slots->Get(kScopedAllocatorSlot, &scoped_allocator_attrs);
 
     int* forward_from = item->forward_from_base();
     uint8* output_types = item->output_type_base();
@@ -566,8 +786,9 @@ void GraphView::Initialize(const Graph* g) {
 
   space_ = new char[total_bytes];  // NodeItem objects are allocated here
   char* ptr = space_;
+  AttrSlots attr_slots({"_forward_input", "_scoped_allocator"});
   for (const Node* n : g->nodes()) {
-    ptr = InitializeNode(ptr, n);
+    ptr = InitializeNode(ptr, n, &attr_slots);
   }
   CHECK_EQ(ptr, space_ + total_bytes);
 }
@@ -598,6 +819,13 @@ void GetMaxPendingCounts(const Node* n, size_t* max_pending,
 Status ExecutorImpl::Initialize() {
   gview_.Initialize(graph_.get());
 
+  if (StaticMemoryPlanWarmupSteps() > 0 &&
+      params_.device->attributes().device_type() == DEVICE_CPU) {
+    memory_planner_.reset(new StaticMemoryPlanner(
+        params_.device->GetAllocator(AllocatorAttributes()),
+        StaticMemoryPlanWarmupSteps()));
+  }
+
   // Build the information about frames in this subgraph.
   ControlFlowInfo cf_info;
   TF_RETURN_IF_ERROR(BuildControlFlowInfo(graph_.get(), &cf_info));
@@ -611,6 +839,12 @@ Status ExecutorImpl::Initialize() {
     EnsureFrameInfo(it)->nodes = new std::vector<const Node*>;
   }
 
+  // Attrs read off Enter nodes below, pre-resolved to slots once for the
+  // whole loop.
+  AttrSlots enter_attrs({"is_constant", "frame_name"});
+  constexpr int kIsConstantSlot = 0;
+  constexpr int kFrameNameSlot = 1;
+
   // Preprocess every node in the graph to create an instance of op
   // kernel for each node.
   for (const Node* n : graph_->nodes()) {
@@ -641,9 +875,10 @@ Status ExecutorImpl::Initialize() {
     item->is_merge = IsMerge(n);
     item->is_enter = IsEnter(n);
     if (item->is_enter) {
+      // The binding stays valid for the frame_name lookup further down.
+      enter_attrs.Bind(n->attrs());
       bool is_constant_enter;
-      TF_RETURN_IF_ERROR(
-          GetNodeAttr(n->attrs(), "is_constant", &is_constant_enter));
+      TF_RETURN_IF_ERROR(enter_attrs.Get(kIsConstantSlot, &is_constant_enter));
       item->is_constant_enter = is_constant_enter;
     } else {
       item->is_constant_enter = false;
@@ -653,6 +888,8 @@ Status ExecutorImpl::Initialize() {
     item->is_sink = IsSink(n);
     item->is_enter_exit_or_next_iter =
         (IsEnter(n) || IsExit(n) || IsNextIteration(n));
+    item->is_step_invariant = false;
+    item->is_inline_op = IsInlineMetadataOp(n->type_string());
 
     // Compute the maximum values we'll store for this node in the
     // pending counts data structure, and allocate a handle in
@@ -667,11 +904,15 @@ Status ExecutorImpl::Initialize() {
     frame_info->nodes->push_back(n);
     if (IsEnter(n)) {
       string enter_name;
-      TF_RETURN_IF_ERROR(GetNodeAttr(n->attrs(), "frame_name", &enter_name));
+      TF_RETURN_IF_ERROR(enter_attrs.Get(kFrameNameSlot, &enter_name));
       EnsureFrameInfo(enter_name)->input_count++;
     }
   }
 
+  if (MemoizeStepInvariantNodes()) {
+    MarkStepInvariantNodes(cf_info);
+  }
+
   // Initialize PendingCounts only after item->pending_id is initialized for
   // all nodes.
   InitializePending(graph_.get(), cf_info);
@@ -679,6 +920,113 @@ Status ExecutorImpl::Initialize() {
   return gview_.SetAllocAttrs(graph_.get(), params_.device);
 }
 
+void ExecutorImpl::MarkStepInvariantNodes(const ControlFlowInfo& cf_info) {
+  // A node is step-invariant if it could be constant-folded at runtime: the
+  // kernel is a pure function (not stateful, not async, no ref or resource
+  // tensors), the node neither enters control flow nor crosses a device or
+  // call-frame boundary, and every node feeding it is itself invariant.
+  // Feeds need no special casing here: they reach the graph as _Recv or
+  // _Arg nodes, which are excluded below.
+  std::vector<bool> invariant(graph_->num_node_ids(), false);
+  std::deque<const Node*> non_invariant;
+  for (const Node* n : graph_->nodes()) {
+    const int id = n->id();
+    const NodeItem* item = gview_.node(id);
+    bool eligible =
+        !n->IsSource() && !n->IsSink() && cf_info.frame_names[id].empty() &&
+        !n->op_def().is_stateful() && !item->kernel_is_async &&
+        !item->is_merge && !item->is_enter_exit_or_next_iter &&
+        !item->is_control_trigger && !IsSwitch(n) && !IsTransferNode(n) &&
+        n->type_string() != "_Arg" && n->type_string() != "_Retval" &&
+        n->type_string() != "SymbolicGradient" &&
+        n->type_string() != "PartitionedCall" &&
+        graph_->flib_def().Find(n->type_string()) == nullptr;
+    for (int i = 0; eligible && i < n->num_inputs(); ++i) {
+      const DataType dt = n->input_type(i);
+      if (IsRefType(dt) || dt == DT_RESOURCE) eligible = false;
+    }
+    for (int i = 0; eligible && i < n->num_outputs(); ++i) {
+      const DataType dt = n->output_type(i);
+      if (IsRefType(dt) || dt == DT_RESOURCE) eligible = false;
+    }
+    invariant[id] = eligible;
+    if (!eligible) non_invariant.push_back(n);
+  }
+
+  // Invariance is monotone: flood every non-invariant node forward through
+  // its fanout until no invariant node has a non-invariant input.
+  while (!non_invariant.empty()) {
+    const Node* n = non_invariant.front();
+    non_invariant.pop_front();
+    for (const Edge* e : n->out_edges()) {
+      const int dst_id = e->dst()->id();
+      if (invariant[dst_id]) {
+        invariant[dst_id] = false;
+        non_invariant.push_back(e->dst());
+      }
+    }
+  }
+
+  for (const Node* n : graph_->nodes()) {
+    if (invariant[n->id()]) {
+      gview_.node(n->id())->is_step_invariant = true;
+    }
+  }
+}
+
+bool ExecutorImpl::GetMemoizedOutputs(
+    int id, std::vector<MemoizedNodeOutput>* outputs) {
+  mutex_lock l(memoize_mu_);
+  auto it = memoized_outputs_.find(id);
+  if (it == memoized_outputs_.end()) return false;
+  *outputs = it->second;
+  return true;
+}
+
+void ExecutorImpl::MemoizeOutputs(int id,
+                                  std::vector<MemoizedNodeOutput> outputs) {
+  int64 bytes = 0;
+  for (const MemoizedNodeOutput& out : outputs) {
+    bytes += static_cast<int64>(out.tensor.TotalBytes());
+  }
+  mutex_lock l(memoize_mu_);
+  if (memoized_outputs_.count(id) > 0) return;
+  if (memoized_bytes_ + bytes > kMaxMemoizedBytes) return;
+  memoized_bytes_ += bytes;
+  memoized_outputs_.emplace(id, std::move(outputs));
+}
+
+void ExecutorImpl::RecordPhaseProfileStep() {
+  const int64 interval = PhaseProfileSteps();
+  if (interval <= 0) return;
+  const int64 steps = phase_profile_.steps.fetch_add(1) + 1;
+  if (steps % interval != 0) return;
+  // Drain the window's counters.  Steps still in flight may add cycles
+  // between the loads, so the totals are approximate at the margin.
+  const uint64 process = phase_profile_.process_cycles.exchange(0);
+  const uint64 prepare = phase_profile_.prepare_inputs_cycles.exchange(0);
+  const uint64 kernel = phase_profile_.kernel_cycles.exchange(0);
+  const uint64 propagate = phase_profile_.propagate_cycles.exchange(0);
+  const uint64 node_done = phase_profile_.node_done_cycles.exchange(0);
+  const uint64 nodes = phase_profile_.nodes.exchange(0);
+  const uint64 accounted = prepare + kernel + propagate + node_done;
+  const uint64 overhead = process > accounted ? process - accounted : 0;
+  // One JSON object per line so the artifact can be scraped from logs.
+  LOG(INFO) << "executor_phase_profile: {"
+            << "\"executor\": \"" << strings::Printf("%p", this) << "\", "
+            << "\"device\": \"" << params_.device->name() << "\", "
+            << "\"graph_nodes\": " << graph_->num_nodes() << ", "
+            << "\"steps\": " << interval << ", "
+            << "\"nodes_processed\": " << nodes << ", "
+            << "\"cycles\": {"
+            << "\"process\": " << process << ", "
+            << "\"prepare_inputs\": " << prepare << ", "
+            << "\"kernel_compute\": " << kernel << ", "
+            << "\"propagate_outputs\": " << propagate << ", "
+            << "\"node_done\": " << node_done << ", "
+            << "\"scheduling_overhead\": " << overhead << "}}";
+}
+
 // If a Node has been marked to use a ScopedAllocator x for output i, then
 // sc_attr will contain the subsequence (i, x) at an even offset.  This function
 // extracts and transfers that ScopedAllocator id to alloc_attr.  For now, we
@@ -994,6 +1342,19 @@ class ExecutorState {
                                     dead_result);
     }
 
+    // Prepares this object for reuse by a later iteration of the same
+    // frame: restores the initial pending counts and drops any input
+    // tensors left over from the retired iteration.
+    void Reset(const PendingCounts* pending_counts,
+               int total_input_tensors) {
+      outstanding_ops = 0;
+      outstanding_frame_count = 0;
+      counts_.ResetFrom(*pending_counts);
+      for (int i = 0; i < total_input_tensors; ++i) {
+        input_tensors[i] = Entry();
+      }
+    }
+
     ~IterationState() { delete[] input_tensors; }
 
    private:
@@ -1069,6 +1430,12 @@ class ExecutorState {
     // The active iteration states of this frame.
     gtl::InlinedVector<IterationState*, 12> iterations;
 
+    // Iteration states retired by CleanupIterations, kept for reuse by
+    // IncrementIteration.  Long-running loops otherwise reallocate the
+    // pending counts and input tensor array on every iteration.  Bounded
+    // by the number of iteration slots.
+    gtl::InlinedVector<IterationState*, 4> iteration_pool GUARDED_BY(mu);
+
     // The NextIteration nodes to enter a new iteration. If the number of
     // outstanding iterations reaches the limit, we will defer the start of
     // the next iteration until the number of outstanding iterations falls
@@ -1180,6 +1547,9 @@ class ExecutorState {
         delete iterations[i];
         iterations[i] = nullptr;
       }
+      for (IterationState* state : iteration_pool) {
+        delete state;
+      }
     }
   };
 
@@ -1190,6 +1560,8 @@ class ExecutorState {
     int64 input_iter = -1;
     bool is_dead = false;
 
+    TaggedNode() {}
+
     TaggedNode(const Node* t_node, FrameState* in_frame, int64 in_iter,
                bool dead) {
       node = t_node;
@@ -1234,6 +1606,56 @@ class ExecutorState {
     int front_index_;
   };
 
+  // A sharded queue of ready nodes used for cross-thread dispatch when
+  // TF_EXECUTOR_USE_SHARDED_READY_QUEUE is enabled.  Instead of handing one
+  // closure per ready node to the underlying thread pool (which funnels all
+  // producers through the pool's own queue lock), producers scatter ready
+  // nodes over independently-locked shards and we schedule at most one
+  // drainer closure per shard.  Drainers pop from their own shard first and
+  // then steal from the others, so a burst of small ops from one thread is
+  // spread over many workers without a single point of serialization.
+  class ShardedReadyQueue {
+   public:
+    explicit ShardedReadyQueue(int num_shards)
+        : shards_(num_shards), next_shard_(0) {}
+
+    // Appends "node" to some shard and returns the shard index, so the
+    // caller can direct a drainer at it.
+    int Push(const TaggedNode& node) {
+      const int shard =
+          next_shard_.fetch_add(1, std::memory_order_relaxed) % shards_.size();
+      Shard& s = shards_[shard];
+      mutex_lock l(s.mu);
+      s.queue.push_back(node);
+      return shard;
+    }
+
+    // Pops a node, preferring "preferred_shard" and falling back to
+    // stealing from the other shards.  Returns false iff every shard is
+    // empty at the time it is inspected.
+    bool TryPop(int preferred_shard, TaggedNode* node) {
+      const int n = shards_.size();
+      for (int i = 0; i < n; ++i) {
+        Shard& s = shards_[(preferred_shard + i) % n];
+        mutex_lock l(s.mu);
+        if (!s.queue.empty()) {
+          *node = s.queue.front();
+          s.queue.pop_front();
+          return true;
+        }
+      }
+      return false;
+    }
+
+   private:
+    struct Shard {
+      mutex mu;
+      std::deque<TaggedNode> queue GUARDED_BY(mu);
+    };
+    std::vector<Shard> shards_;
+    std::atomic<int> next_shard_;
+  };
+
   struct AsyncState;
 
   const bool vlog_;  // true if VLOG_IS_ON(1). Used to check vlog cheaply.
@@ -1250,6 +1672,12 @@ class ExecutorState {
   TensorStore* tensor_store_;
   // Step-local container.
   ScopedStepContainer* step_container_;
+  // Arena for the temporary tensors of this step, or nullptr.  Deletes
+  // itself once StepDone() has been called and all allocations are freed.
+  StepArenaAllocator* step_arena_ = nullptr;
+  // Planner-owned allocator serving CPU temporaries from a static plan,
+  // or nullptr.  Takes precedence over step_arena_.
+  Allocator* planned_step_allocator_ = nullptr;
   StepStatsCollectorInterface* const stats_collector_;
   const tracing::EventCollector* const event_collector_;
   Context context_;
@@ -1258,10 +1686,11 @@ class ExecutorState {
   // instead of a pointer?  (avoids having to delete).
   checkpoint::TensorSliceReaderCacheWrapper* slice_reader_cache_;
   CallFrameInterface* call_frame_;
-  const ExecutorImpl* impl_;
+  ExecutorImpl* impl_;
   CancellationManager* cancellation_manager_;
   Executor::Args::Runner runner_;
   bool sync_on_finish_;
+  const bool run_all_kernels_inline_;
   const bool trace_using_annotations_;
 
   // Owned.
@@ -1278,6 +1707,10 @@ class ExecutorState {
 
   std::atomic_int_fast32_t num_outstanding_ops_;
 
+  // Non-null iff sharded cross-thread dispatch is enabled (see
+  // ScheduleReady and TF_EXECUTOR_USE_SHARDED_READY_QUEUE).
+  std::unique_ptr<ShardedReadyQueue> sharded_ready_queue_;
+
   // Available via OpKernelContext to every OpKernel invocation.
   mutex num_deferred_ops_mu_;
   condition_variable no_deferred_ops_cv_;
@@ -1395,8 +1828,21 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
       cancellation_manager_(args.cancellation_manager),
       runner_(args.runner),
       sync_on_finish_(args.sync_on_finish),
+      run_all_kernels_inline_(args.run_all_kernels_inline),
       trace_using_annotations_(impl->params_.device->TraceUsingAnnotations()),
       num_outstanding_ops_(0) {
+  if (UseShardedReadyQueue()) {
+    sharded_ready_queue_.reset(
+        new ShardedReadyQueue(port::NumSchedulableCPUs()));
+  }
+  if (impl->memory_planner_ != nullptr) {
+    planned_step_allocator_ = impl->memory_planner_->step_allocator();
+  } else if (UseStepArena() &&
+             impl->params_.device->attributes().device_type() == DEVICE_CPU) {
+    step_arena_ = new StepArenaAllocator(
+        impl->params_.device->GetAllocator(AllocatorAttributes()));
+  }
+
   // We start the entire execution in iteration 0 of the root frame
   // so let us create the root frame and the state for iteration 0.
   // We assume root_frame_->frame_name.empty().
@@ -1413,6 +1859,12 @@ ExecutorState::ExecutorState(const Executor::Args& args, ExecutorImpl* impl)
 }
 
 ExecutorState::~ExecutorState() {
+  if (step_arena_ != nullptr) {
+    step_arena_->StepDone();
+  }
+  if (planned_step_allocator_ != nullptr) {
+    impl_->memory_planner_->StepDone();
+  }
   for (auto name_frame : outstanding_frames_) {
     delete name_frame.second;
   }
@@ -1640,6 +2092,7 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
   params.input_device_contexts = &input_device_contexts;
   params.input_alloc_attrs = &input_alloc_attrs;
   params.runner = &runner_;
+  params.run_all_kernels_inline = run_all_kernels_inline_;
   params.stats_collector = stats_collector_;
   params.inc_num_deferred_ops_function = [this]() {
     mutex_lock lock(num_deferred_ops_mu_);
@@ -1658,6 +2111,19 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
 
   EntryVector outputs;
   bool completed = false;
+
+  // Per-call phase cycle totals, flushed to the executor's shared
+  // counters once when the call ends.
+  const bool phase_profiling = PhaseProfileSteps() > 0;
+  const uint64 process_start_cycles =
+      phase_profiling ? profile_utils::CpuUtils::GetCurrentClockCycle() : 0;
+  uint64 prepare_inputs_cycles = 0;
+  uint64 kernel_cycles = 0;
+  uint64 propagate_cycles = 0;
+  uint64 node_done_cycles = 0;
+  uint64 nodes_processed = 0;
+  PhaseSampler sampler(phase_profiling);
+
   inline_ready.push_back(tagged_node);
   while (!inline_ready.empty()) {
     tagged_node = inline_ready.front();
@@ -1680,6 +2146,14 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
       params.op_device_context = device_context_map_[id];
     }
 
+    Allocator* step_temp_allocator = (planned_step_allocator_ != nullptr)
+                                         ? planned_step_allocator_
+                                         : static_cast<Allocator*>(step_arena_);
+    params.step_arena_allocator =
+        (step_temp_allocator != nullptr &&
+         !IsStepArenaExcluded(item.kernel->type_string()))
+            ? step_temp_allocator
+            : nullptr;
     params.track_allocations = false;
     stats = nullptr;
     if (stats_collector_ && !tagged_node.is_dead) {
@@ -1707,13 +2181,31 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
     // transfer node. For transfer nodes, we need to propagate the "dead"
     // bit even when the node is dead.
     bool launched_asynchronously = false;
+    std::vector<ExecutorImpl::MemoizedNodeOutput> memoized;
     if (tagged_node.is_dead && !IsTransferNode(node)) {
       outputs.resize(item.num_outputs);
+    } else if (item.is_step_invariant && device_context_map_.empty() &&
+               impl_->GetMemoizedOutputs(id, &memoized)) {
+      // An earlier step already computed this step-invariant node; reuse
+      // its outputs without running the kernel.
+      nodestats::SetOpStart(stats);
+      outputs.resize(item.num_outputs);
+      for (int i = 0; i < item.num_outputs; ++i) {
+        Entry* out = &outputs[i];
+        out->has_value = true;
+        out->val_field_is_set = true;
+        out->val.Init(memoized[i].tensor);
+        out->alloc_attr = memoized[i].alloc_attr;
+      }
+      nodestats::SetOpEnd(stats);
+      s = Status::OK();
     } else {
       // Prepares inputs.
       bool is_input_dead = false;
+      sampler.Skip();
       s = PrepareInputs(item, first_input, &inputs, &input_device_contexts,
                         &input_alloc_attrs, &is_input_dead);
+      sampler.Lap(&prepare_inputs_cycles);
       if (!s.ok()) {
         // Clear inputs.
         int num_inputs = item.num_inputs;
@@ -1722,7 +2214,10 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
         }
         MaybeMarkCompleted(input_frame, input_iter, id);
         // Continue to process the nodes in 'inline_ready'.
+        sampler.Skip();
         completed = NodeDone(s, item.node, ready, stats, &inline_ready);
+        sampler.Lap(&node_done_cycles);
+        ++nodes_processed;
         continue;
       }
 
@@ -1788,11 +2283,17 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           if (completed) ScheduleFinish();
         };
         nodestats::SetOpStart(stats);
+        // Only the launch is attributed to the kernel phase; the done
+        // callback runs outside Process().
+        sampler.Skip();
         device->ComputeAsync(async, &state->ctx, done);
+        sampler.Lap(&kernel_cycles);
+        ++nodes_processed;
       } else {
         // Synchronous computes.
         OpKernelContext ctx(&params, item.num_outputs);
         nodestats::SetOpStart(stats);
+        sampler.Skip();
 
         if (TF_PREDICT_FALSE(
                 MightTrace(item, event_collector_, trace_using_annotations_))) {
@@ -1819,7 +2320,12 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           }
         } else {
           // In the common case, avoid creating any tracing objects.
-          if (op_kernel->IsExpensive()) {
+          // Inline metadata ops finish in far fewer cycles than the
+          // expensiveness threshold, so they skip the timing entirely.
+          // Other kernels are timed whenever they are expensive, and
+          // sampled occasionally while inexpensive so a kernel whose
+          // workload grows can migrate back to scheduled execution.
+          if (!item.is_inline_op && op_kernel->ShouldTimeExecution()) {
             KernelTimer timer;
             device->Compute(op_kernel, &ctx);
             op_kernel->UpdateCostEstimate(timer.ElapsedCycles());
@@ -1828,8 +2334,23 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
           }
         }
 
+        sampler.Lap(&kernel_cycles);
         nodestats::SetOpEnd(stats);
         s = ProcessOutputs(item, &ctx, &outputs, stats);
+        if (s.ok() && item.is_step_invariant && device_context_map_.empty()) {
+          memoized.reserve(item.num_outputs);
+          bool memoizable = true;
+          for (const Entry& entry : outputs) {
+            if (!entry.val_field_is_set || !entry.val->IsInitialized()) {
+              memoizable = false;
+              break;
+            }
+            memoized.push_back({*entry.val, entry.alloc_attr});
+          }
+          if (memoizable) {
+            impl_->MemoizeOutputs(id, std::move(memoized));
+          }
+        }
         if (s.ok() && impl_->device_record_tensor_accesses_) {
           // Get the list of all tensors accessed during the execution
           ctx.retrieve_accessed_tensors(&accessed_tensors);
@@ -1854,9 +2375,11 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
       }
       MaybeMarkCompleted(input_frame, input_iter, id);
       // Propagates outputs.
+      sampler.Skip();
       if (s.ok()) {
         PropagateOutputs(tagged_node, &item, &outputs, &ready);
       }
+      sampler.Lap(&propagate_cycles);
       outputs.clear();
       if (!accessed_tensors.empty()) {
         nodestats::SetReferencedTensors(stats, accessed_tensors);
@@ -1867,10 +2390,28 @@ void ExecutorState::Process(TaggedNode tagged_node, int64 scheduled_nsec) {
         scheduled_nsec = nodestats::NowInNsec();
       }
       // Postprocess.
+      sampler.Skip();
       completed = NodeDone(s, item.node, ready, stats, &inline_ready);
+      sampler.Lap(&node_done_cycles);
+      ++nodes_processed;
     }
   }  // while !inline_ready.empty()
 
+  if (phase_profiling) {
+    ExecutorImpl::PhaseProfile* profile = &impl_->phase_profile_;
+    profile->process_cycles.fetch_add(
+        profile_utils::CpuUtils::GetCurrentClockCycle() - process_start_cycles,
+        std::memory_order_relaxed);
+    profile->prepare_inputs_cycles.fetch_add(prepare_inputs_cycles,
+                                             std::memory_order_relaxed);
+    profile->kernel_cycles.fetch_add(kernel_cycles, std::memory_order_relaxed);
+    profile->propagate_cycles.fetch_add(propagate_cycles,
+                                        std::memory_order_relaxed);
+    profile->node_done_cycles.fetch_add(node_done_cycles,
+                                        std::memory_order_relaxed);
+    profile->nodes.fetch_add(nodes_processed, std::memory_order_relaxed);
+  }
+
   // This thread of computation is done if completed = true.
   if (completed) ScheduleFinish();
 }
@@ -2259,7 +2800,56 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
     scheduled_nsec = nodestats::NowInNsec();
   }
 
+  if (run_all_kernels_inline_) {
+    metrics::RecordExecutorReadyNodes(0, ready.size());
+    if (inline_ready == nullptr) {
+      // Schedule all ready kernels from a single closure.  This avoids a
+      // thread hand-off per kernel, which matters when nested function
+      // executions would otherwise fan out over the inter-op pool.
+      runner_([this, ready, scheduled_nsec]() {
+        for (auto& tagged_node : ready) {
+          Process(tagged_node, scheduled_nsec);
+        }
+      });
+    } else {
+      for (auto& tagged_node : ready) {
+        inline_ready->push_back(tagged_node);
+      }
+    }
+    return;
+  }
+
   if (inline_ready == nullptr) {
+    metrics::RecordExecutorReadyNodes(ready.size(), 0);
+    if (sharded_ready_queue_ != nullptr) {
+      // Scatter the ready nodes over the sharded queue and schedule one
+      // drainer per touched shard.  Each drainer empties its own shard and
+      // then steals from the others, so we pay one thread-pool hand-off per
+      // shard instead of one per node.
+      gtl::FlatSet<int> shards;
+      for (auto& tagged_node : ready) {
+        shards.insert(sharded_ready_queue_->Push(tagged_node));
+      }
+      // Each drainer holds an extra count in num_outstanding_ops_ for as
+      // long as it is queued or running.  TryPop steals across shards, so
+      // one drainer may process nodes that were pushed for another; without
+      // the extra count, the final Process() call could finish the step and
+      // delete this ExecutorState while sibling drainers are still queued.
+      num_outstanding_ops_.fetch_add(shards.size(),
+                                     std::memory_order_relaxed);
+      for (int shard : shards) {
+        runner_([this, shard, scheduled_nsec]() {
+          TaggedNode curr;
+          while (sharded_ready_queue_->TryPop(shard, &curr)) {
+            Process(curr, scheduled_nsec);
+          }
+          // Drop this drainer's count.  The last count to go finishes the
+          // step; nothing may touch this ExecutorState afterwards.
+          if (num_outstanding_ops_.fetch_sub(1) == 1) ScheduleFinish();
+        });
+      }
+      return;
+    }
     // Schedule to run all the ready ops in thread pool.
     for (auto& tagged_node : ready) {
       runner_([=]() { Process(tagged_node, scheduled_nsec); });
@@ -2269,17 +2859,22 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
 
   const GraphView& gview = impl_->gview_;
   const TaggedNode* curr_expensive_node = nullptr;
+  int64 num_inline = 0;
+  int64 num_scheduled = 0;
   for (auto& tagged_node : ready) {
     const NodeItem& item = *gview.node(tagged_node.node->id());
-    if (tagged_node.is_dead || !item.kernel->IsExpensive()) {
+    if (tagged_node.is_dead || item.is_inline_op ||
+        !item.kernel->IsExpensive()) {
       // Inline this inexpensive node.
       inline_ready->push_back(tagged_node);
+      ++num_inline;
     } else {
       if (curr_expensive_node) {
         // Dispatch to another thread since there is plenty of work to
         // do for this thread.
         runner_(std::bind(&ExecutorState::Process, this, *curr_expensive_node,
                           scheduled_nsec));
+        ++num_scheduled;
       }
       curr_expensive_node = &tagged_node;
     }
@@ -2288,13 +2883,16 @@ void ExecutorState::ScheduleReady(const TaggedNodeSeq& ready,
     if (inline_ready->empty()) {
       // Tail recursion optimization
       inline_ready->push_back(*curr_expensive_node);
+      ++num_inline;
     } else {
       // There are inline nodes to run already. We dispatch this expensive
       // node to other thread.
       runner_(std::bind(&ExecutorState::Process, this, *curr_expensive_node,
                         scheduled_nsec));
+      ++num_scheduled;
     }
   }
+  metrics::RecordExecutorReadyNodes(num_scheduled, num_inline);
 }
 
 inline void ExecutorState::MaybeMarkCompleted(FrameState* frame, int64 iter,
@@ -2456,6 +3054,8 @@ void ExecutorState::Finish() {
   CHECK(done_cb != nullptr);
   Device* device = impl_->params_.device;
 
+  impl_->RecordPhaseProfileStep();
+
   // There are several potential race conditions below. To name a few:
   // 1. Even if the device's status is OK at the precise moment when
   // num_deferred_ops_ reaches 0, it could go bad before device->RefreshStatus()
@@ -2815,9 +3415,16 @@ void ExecutorState::FrameState::IncrementIteration(const GraphView* gview,
   iteration_count++;
   const int64 next_iter = iteration_count;
 
-  // Initialize the next iteration.
-  IterationState* iter_state =
-      new IterationState(pending_counts, total_input_tensors);
+  // Initialize the next iteration, reusing a retired iteration state
+  // when one is available.
+  IterationState* iter_state;
+  if (!iteration_pool.empty()) {
+    iter_state = iteration_pool.back();
+    iteration_pool.pop_back();
+    iter_state->Reset(pending_counts, total_input_tensors);
+  } else {
+    iter_state = new IterationState(pending_counts, total_input_tensors);
+  }
   SetIteration(next_iter, iter_state);
   num_outstanding_iterations++;
   dead_exits.clear();
@@ -2834,8 +3441,13 @@ bool ExecutorState::FrameState::CleanupIterations(const GraphView* gview,
                                                   TaggedNodeSeq* ready) {
   int64 curr_iter = iter;
   while (curr_iter <= iteration_count && IsIterationDone(curr_iter)) {
-    // Delete the iteration curr_iter.
-    delete GetIteration(curr_iter);
+    // Retire the iteration curr_iter, pooling its state for reuse.
+    IterationState* istate = GetIteration(curr_iter);
+    if (iteration_pool.size() < iterations.size()) {
+      iteration_pool.push_back(istate);
+    } else {
+      delete istate;
+    }
     SetIteration(curr_iter, nullptr);
     --num_outstanding_iterations;
     ++curr_iter;
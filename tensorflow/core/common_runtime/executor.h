@@ -97,6 +97,13 @@ class Executor {
     // If true, calls Sync() on the device.
     bool sync_on_finish = false;
 
+    // If true, all kernels are treated as "inexpensive" and processed on
+    // the scheduling thread rather than handed off to the inter-op pool.
+    // Deeply nested function calls (e.g. recursion via PartitionedCall)
+    // otherwise park one pool thread per nesting level; running nested
+    // executions inline keeps the thread count flat.
+    bool run_all_kernels_inline = false;
+
     typedef std::function<void()> Closure;
     typedef std::function<void(Closure)> Runner;
     Runner runner = nullptr;
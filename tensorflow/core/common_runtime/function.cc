@@ -16,6 +16,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/function.h"
 
 #include <deque>
+#include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -36,8 +38,11 @@ limitations under the License.
 #include "tensorflow/core/graph/gradients.h"
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/graph/optimizer_cse.h"
+#include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/macros.h"
 
 // See core/kernels/function_ops.cc for related kernels.
@@ -363,6 +368,15 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
 
   int next_handle_ GUARDED_BY(mu_);
 
+  // An optimized graph and the executor built for it. Shared (via
+  // shared_ptr) between all Items whose function bodies are structurally
+  // identical; executors keep no per-call state, so per-instance call
+  // frames are the only thing that stays separate.
+  struct ExecutorEntry {
+    const Graph* graph = nullptr;  // Owned by exec.
+    std::unique_ptr<Executor> exec;
+  };
+
   // The instantiated and transformed function is encoded as a Graph
   // object, and an executor is created for the graph.
   struct Item {
@@ -370,18 +384,26 @@ class FunctionLibraryRuntimeImpl : public FunctionLibraryRuntime {
     const Graph* graph = nullptr;                            // Owned by exec.
     const FunctionLibraryDefinition* overlay_lib = nullptr;  // Not owned.
     FunctionBody* func_graph = nullptr;
-    Executor* exec = nullptr;
+    Executor* exec = nullptr;  // Owned by exec_entry.
+    std::shared_ptr<ExecutorEntry> exec_entry;
     FunctionLibraryRuntimeOverlay* overlay_flr = nullptr;
     string executor_type;
 
     ~Item() {
       delete this->func_graph;
-      delete this->exec;
       delete this->overlay_flr;
     }
   };
   std::unordered_map<Handle, std::unique_ptr<Item>> items_ GUARDED_BY(mu_);
 
+  // Executors keyed by the structural fingerprint of the function body (and
+  // executor type), so that e.g. a templated layer function instantiated
+  // under hundreds of names optimizes and builds kernels only once. Entries
+  // are weak: once every instantiation of a body is released, its executor
+  // is freed.
+  std::unordered_map<string, std::weak_ptr<ExecutorEntry>> shared_executors_
+      GUARDED_BY(mu_);
+
   ProcessFunctionLibraryRuntime* parent_ = nullptr;  // not owned.
 
   Status CreateKernel(const NodeDef& ndef,
@@ -473,6 +495,7 @@ class CallOp : public AsyncOpKernel {
     opts.step_container = ctx->step_container();
     opts.stats_collector = ctx->stats_collector();
     opts.runner = ctx->runner();
+    opts.run_all_kernels_inline = ctx->run_all_kernels_inline();
     opts.collective_executor = ctx->collective_executor();
     std::vector<Tensor> args;
     args.reserve(ctx->num_inputs());
@@ -842,6 +865,26 @@ void PruneFunctionBody(const FunctionDef& fdef, Graph* g) {
 }
 }  // namespace
 
+namespace {
+
+// Returns a fingerprint of the (pre-optimization) function body that is
+// insensitive to the name the function was instantiated under: node order
+// out of ToGraphDef follows node ids, which are identical for bodies built
+// from textually identical function definitions, and the serialization is
+// deterministic. Returns an empty string if the body cannot be serialized,
+// in which case the caller should not share.
+string FunctionBodyFingerprint(const FunctionBody* fbody) {
+  GraphDef gdef;
+  fbody->graph->ToGraphDef(&gdef);
+  string serialized;
+  if (!SerializeToStringDeterministic(gdef, &serialized)) {
+    return "";
+  }
+  return strings::StrCat(Fingerprint64(serialized), ":", gdef.node_size());
+}
+
+}  // namespace
+
 Status FunctionLibraryRuntimeImpl::CreateItem(Item** item) {
   const FunctionBody* fbody;
   const FunctionLibraryDefinition* lib_def;
@@ -852,6 +895,29 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Item** item) {
     lib_def = (*item)->overlay_lib;
     executor_type = (*item)->executor_type;
   }
+  // Structurally identical bodies produce identical optimized graphs and
+  // kernels, so their executors can be shared; only instantiations without
+  // an overlay library participate since overlays change kernel creation.
+  string share_key;
+  if (lib_def == nullptr) {
+    const string fingerprint = FunctionBodyFingerprint(fbody);
+    if (!fingerprint.empty()) {
+      share_key = strings::StrCat(fingerprint, "|", executor_type);
+      mutex_lock l(mu_);
+      auto iter = shared_executors_.find(share_key);
+      if (iter != shared_executors_.end()) {
+        std::shared_ptr<ExecutorEntry> entry = iter->second.lock();
+        if (entry != nullptr) {
+          if ((*item)->exec == nullptr) {
+            (*item)->graph = entry->graph;
+            (*item)->exec = entry->exec.get();
+            (*item)->exec_entry = std::move(entry);
+          }
+          return Status::OK();
+        }
+      }
+    }
+  }
   if (!lib_def) {
     lib_def = base_lib_def_;
   }
@@ -885,12 +951,22 @@ Status FunctionLibraryRuntimeImpl::CreateItem(Item** item) {
   Graph* graph = g.get();
   std::unique_ptr<Executor> exec;
   TF_RETURN_IF_ERROR(NewExecutor(executor_type, params, std::move(g), &exec));
+  std::shared_ptr<ExecutorEntry> entry(new ExecutorEntry);
+  entry->graph = graph;
+  entry->exec = std::move(exec);
   {
     // Guard item since it is already inserted in items_.
     mutex_lock l(mu_);
     if ((*item)->exec == nullptr) {
-      (*item)->graph = graph;
-      (*item)->exec = exec.release();
+      (*item)->graph = entry->graph;
+      (*item)->exec = entry->exec.get();
+      (*item)->exec_entry = entry;
+    }
+    if (!share_key.empty()) {
+      // If two threads raced to build the same body, the later publish
+      // simply replaces the earlier one; both items stay valid through
+      // their own shared_ptr.
+      shared_executors_[share_key] = entry;
     }
   }
   return Status::OK();
@@ -931,6 +1007,7 @@ void FunctionLibraryRuntimeImpl::ExecutorArgsFromOptions(
   }
   exec_args->collective_executor = run_opts.collective_executor;
   exec_args->call_frame = frame;
+  exec_args->run_all_kernels_inline = run_opts.run_all_kernels_inline;
 }
 
 void FunctionLibraryRuntimeImpl::RunRemote(const Options& opts, Handle handle,
@@ -402,6 +402,35 @@ TEST_F(FunctionLibraryRuntimeTest, XTimesN) {
   test::ExpectTensorEqual<float>(y, test::AsTensor<float>({16, 32, 48, 64}));
 }
 
+TEST_F(FunctionLibraryRuntimeTest, StructurallyIdenticalBodiesShareExecutor) {
+  // Two functions with identical bodies but different names share one
+  // executor under the hood; releasing one instantiation must not affect
+  // the other.
+  FunctionDef clone = test::function::XTimesTwo();
+  clone.mutable_signature()->set_name("XTimesTwoClone");
+  Init({test::function::XTimesTwo(), clone});
+  auto x = test::AsTensor<float>({1, 2, 3, 4});
+  Tensor y;
+
+  FunctionLibraryRuntime::Handle original, cloned;
+  TF_CHECK_OK(Instantiate(flr0_, "XTimesTwo", {{"T", DT_FLOAT}}, &original));
+  TF_CHECK_OK(
+      Instantiate(flr0_, "XTimesTwoClone", {{"T", DT_FLOAT}}, &cloned));
+
+  FunctionLibraryRuntime::Options opts;
+  TF_CHECK_OK(Run(flr0_, original, opts, {x}, {&y}));
+  test::ExpectTensorEqual<float>(y, test::AsTensor<float>({2, 4, 6, 8}));
+  TF_CHECK_OK(Run(flr0_, cloned, opts, {x}, {&y}));
+  test::ExpectTensorEqual<float>(y, test::AsTensor<float>({2, 4, 6, 8}));
+
+  // The clone's handle keeps the shared executor alive after the original
+  // instantiation goes away.
+  TF_CHECK_OK(flr0_->ReleaseHandle(original));
+  TF_CHECK_OK(Run(flr0_, cloned, opts, {x}, {&y}));
+  test::ExpectTensorEqual<float>(y, test::AsTensor<float>({2, 4, 6, 8}));
+  TF_CHECK_OK(flr0_->ReleaseHandle(cloned));
+}
+
 TEST_F(FunctionLibraryRuntimeTest, XTimesNInOverlayLib) {
   Init({});
   FunctionDefLibrary proto;
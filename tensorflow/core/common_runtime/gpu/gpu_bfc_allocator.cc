@@ -15,9 +15,13 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_bfc_allocator.h"
 
+#include <algorithm>
+#include <thread>
+
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id_utils.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_init.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 
 namespace tensorflow {
@@ -59,11 +63,151 @@ GPUBFCAllocator::GPUBFCAllocator(GPUMemAllocator* sub_allocator,
                                  size_t total_memory, const string& name)
     : GPUBFCAllocator(sub_allocator, total_memory, GPUOptions(), name) {}
 
+bool GPUBFCAllocator::GetGarbageCollectionValue() {
+  const char* enable_gpu_garbage_collection =
+      std::getenv("TF_ENABLE_GPU_GARBAGE_COLLECTION");
+  if (enable_gpu_garbage_collection == nullptr) {
+    // By default, garbage collection is disabled.
+    return false;
+  }
+  if (strcmp("false", enable_gpu_garbage_collection) == 0) {
+    return false;
+  } else if (strcmp("true", enable_gpu_garbage_collection) == 0) {
+    return true;
+  }
+
+  LOG(ERROR)
+      << "The TF_ENABLE_GPU_GARBAGE_COLLECTION environment variable is set"
+      << " but could not be parsed: \"" << enable_gpu_garbage_collection
+      << "\". Valid values are \"true\" or \"false\". Using the default"
+      << " value of false.";
+  return false;
+}
+
 GPUBFCAllocator::GPUBFCAllocator(GPUMemAllocator* sub_allocator,
                                  size_t total_memory,
                                  const GPUOptions& gpu_options,
                                  const string& name)
     : BFCAllocator(sub_allocator, total_memory,
-                   GPUBFCAllocator::GetAllowGrowthValue(gpu_options), name) {}
+                   GPUBFCAllocator::GetAllowGrowthValue(gpu_options), name,
+                   GPUBFCAllocator::GetGarbageCollectionValue()) {}
+
+ShardedGPUBFCAllocator::ShardedGPUBFCAllocator(
+    std::vector<std::unique_ptr<GPUBFCAllocator>> shards, const string& name)
+    : shards_(std::move(shards)), name_(name) {
+  CHECK(!shards_.empty());
+}
+
+int ShardedGPUBFCAllocator::HomeShard() const {
+  const std::thread::id tid = std::this_thread::get_id();
+  return Hash64(reinterpret_cast<const char*>(&tid), sizeof(tid)) %
+         shards_.size();
+}
+
+ShardedGPUBFCAllocator::OwnerStripe& ShardedGPUBFCAllocator::StripeFor(
+    const void* ptr) {
+  // Drop the low bits, which are always zero for aligned allocations.
+  return stripes_[(reinterpret_cast<uintptr_t>(ptr) >> 8) % kNumStripes];
+}
+
+void ShardedGPUBFCAllocator::RecordOwner(const void* ptr, int shard) {
+  OwnerStripe& stripe = StripeFor(ptr);
+  mutex_lock l(stripe.mu);
+  stripe.owner[ptr] = shard;
+}
+
+int ShardedGPUBFCAllocator::ReleaseOwner(const void* ptr) {
+  OwnerStripe& stripe = StripeFor(ptr);
+  mutex_lock l(stripe.mu);
+  auto it = stripe.owner.find(ptr);
+  CHECK(it != stripe.owner.end())
+      << "Asked to free pointer we never allocated: " << ptr;
+  int shard = it->second;
+  stripe.owner.erase(it);
+  return shard;
+}
+
+GPUBFCAllocator* ShardedGPUBFCAllocator::OwnerOf(const void* ptr) {
+  OwnerStripe& stripe = StripeFor(ptr);
+  mutex_lock l(stripe.mu);
+  auto it = stripe.owner.find(ptr);
+  CHECK(it != stripe.owner.end())
+      << "Asked about pointer we never allocated: " << ptr;
+  return shards_[it->second].get();
+}
+
+void* ShardedGPUBFCAllocator::AllocateRaw(
+    size_t alignment, size_t num_bytes,
+    const AllocationAttributes& allocation_attr) {
+  const int home = HomeShard();
+  // Probe every shard without retrying so that a full home shard does not
+  // stall the caller while other shards have free memory.
+  AllocationAttributes no_retry_attr = allocation_attr;
+  no_retry_attr.no_retry_on_failure = true;
+  const int num_shards = shards_.size();
+  for (int i = 0; i < num_shards; ++i) {
+    const int shard = (home + i) % num_shards;
+    void* ptr = shards_[shard]->AllocateRaw(alignment, num_bytes,
+                                            no_retry_attr);
+    if (ptr != nullptr) {
+      RecordOwner(ptr, shard);
+      return ptr;
+    }
+  }
+  // All shards are full; fall back to the home shard with the caller's
+  // original retry/logging semantics.
+  void* ptr = shards_[home]->AllocateRaw(alignment, num_bytes,
+                                         allocation_attr);
+  if (ptr != nullptr) {
+    RecordOwner(ptr, home);
+  }
+  return ptr;
+}
+
+void ShardedGPUBFCAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) {
+    LOG(ERROR) << "tried to deallocate nullptr";
+    return;
+  }
+  const int shard = ReleaseOwner(ptr);
+  shards_[shard]->DeallocateRaw(ptr);
+}
+
+size_t ShardedGPUBFCAllocator::RequestedSize(const void* ptr) {
+  return OwnerOf(ptr)->RequestedSize(ptr);
+}
+
+size_t ShardedGPUBFCAllocator::AllocatedSize(const void* ptr) {
+  return OwnerOf(ptr)->AllocatedSize(ptr);
+}
+
+int64 ShardedGPUBFCAllocator::AllocationId(const void* ptr) {
+  return OwnerOf(ptr)->AllocationId(ptr);
+}
+
+absl::optional<AllocatorStats> ShardedGPUBFCAllocator::GetStats() {
+  AllocatorStats stats;
+  for (const auto& shard : shards_) {
+    absl::optional<AllocatorStats> shard_stats = shard->GetStats();
+    if (shard_stats) {
+      stats.num_allocs += shard_stats->num_allocs;
+      stats.bytes_in_use += shard_stats->bytes_in_use;
+      stats.peak_bytes_in_use += shard_stats->peak_bytes_in_use;
+      stats.largest_alloc_size =
+          std::max(stats.largest_alloc_size, shard_stats->largest_alloc_size);
+      if (shard_stats->bytes_limit) {
+        stats.bytes_limit = stats.bytes_limit.value_or(0) +
+                            *shard_stats->bytes_limit;
+      }
+    }
+  }
+  return stats;
+}
+
+void ShardedGPUBFCAllocator::ClearStats() {
+  for (const auto& shard : shards_) {
+    shard->ClearStats();
+  }
+}
 
 }  // namespace tensorflow
@@ -16,12 +16,14 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_BFC_ALLOCATOR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_BFC_ALLOCATOR_H_
 
+#include <array>
 #include <memory>
 #include <string>
 #include <unordered_map>
 #include <vector>
 
 #include "tensorflow/core/common_runtime/allocator_retry.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/common_runtime/bfc_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/platform/stream_executor.h"
@@ -96,6 +98,76 @@ class GPUBFCAllocator : public BFCAllocator {
 
  private:
   static bool GetAllowGrowthValue(const GPUOptions& gpu_options);
+  static bool GetGarbageCollectionValue();
+};
+
+// An allocator that spreads GPU memory over several independent
+// GPUBFCAllocator arenas in order to reduce contention on the single
+// allocator lock when many streams or host threads allocate concurrently.
+//
+// Each allocating thread is hashed to a "home" shard; if the home shard
+// cannot satisfy a request the other shards are tried before falling back to
+// the home shard with the caller's retry semantics.  Ownership of each live
+// pointer is tracked in a striped hash map so deallocation and size queries
+// take only a short-lived stripe lock rather than an arena lock.
+//
+// Enabled from GPUProcessState via TF_GPU_BFC_NUM_SHARDS (see
+// gpu_process_state.cc).
+class ShardedGPUBFCAllocator : public Allocator {
+ public:
+  // Takes ownership of the shard allocators, which must be non-empty.
+  ShardedGPUBFCAllocator(
+      std::vector<std::unique_ptr<GPUBFCAllocator>> shards,
+      const string& name);
+  ~ShardedGPUBFCAllocator() override {}
+
+  string Name() override { return name_; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    return AllocateRaw(alignment, num_bytes, AllocationAttributes());
+  }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes,
+                    const AllocationAttributes& allocation_attr) override;
+
+  void DeallocateRaw(void* ptr) override;
+
+  bool TracksAllocationSizes() override { return true; }
+
+  size_t RequestedSize(const void* ptr) override;
+
+  size_t AllocatedSize(const void* ptr) override;
+
+  int64 AllocationId(const void* ptr) override;
+
+  absl::optional<AllocatorStats> GetStats() override;
+
+  void ClearStats() override;
+
+ private:
+  // The shard preferred by the calling thread.
+  int HomeShard() const;
+
+  // Returns the shard that owns `ptr`. CHECK-fails if `ptr` was not
+  // allocated by this allocator.
+  GPUBFCAllocator* OwnerOf(const void* ptr);
+
+  // Remembers (or forgets) which shard owns a live pointer.
+  void RecordOwner(const void* ptr, int shard);
+  int ReleaseOwner(const void* ptr);
+
+  static constexpr int kNumStripes = 16;
+  struct OwnerStripe {
+    mutex mu;
+    gtl::FlatMap<const void*, int> owner GUARDED_BY(mu);
+  };
+  OwnerStripe& StripeFor(const void* ptr);
+
+  const std::vector<std::unique_ptr<GPUBFCAllocator>> shards_;
+  const string name_;
+  std::array<OwnerStripe, kNumStripes> stripes_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ShardedGPUBFCAllocator);
 };
 
 }  // namespace tensorflow
@@ -230,6 +230,37 @@ TEST(GPUBFCAllocatorTest, TestCustomMemoryLimit) {
   a.DeallocateRaw(first_ptr);
 }
 
+TEST(GPUBFCAllocatorTest, GarbageCollection) {
+  setenv("TF_ENABLE_GPU_GARBAGE_COLLECTION", "true", 1);
+  GPUOptions options;
+  options.set_allow_growth(true);
+
+  PlatformGpuId platform_gpu_id(0);
+  GPUMemAllocator* sub_allocator = new GPUMemAllocator(
+      GpuIdUtil::ExecutorForPlatformGpuId(platform_gpu_id).ValueOrDie(),
+      platform_gpu_id, false /*use_unified_memory*/, {}, {});
+  // A 64MiB limit, handed out in small regions because of allow_growth.
+  GPUBFCAllocator a(sub_allocator, 1 << 26, options, "GPU_0_bfc");
+
+  // Fill the allocator with small allocations spread over many regions.
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 64; ++i) {
+    void* raw = a.AllocateRaw(1, 1 << 19);  // 512KiB
+    ASSERT_NE(nullptr, raw);
+    ptrs.push_back(raw);
+  }
+  for (void* raw : ptrs) {
+    a.DeallocateRaw(raw);
+  }
+
+  // With every region free, garbage collection must reclaim them so that a
+  // single allocation close to the full limit can be satisfied.
+  void* big = a.AllocateRaw(1, (1 << 26) - (1 << 22));
+  EXPECT_NE(nullptr, big);
+  a.DeallocateRaw(big);
+  unsetenv("TF_ENABLE_GPU_GARBAGE_COLLECTION");
+}
+
 TEST(GPUBFCAllocatorTest, AllocationsAndDeallocationsWithGrowth) {
   GPUOptions options;
   options.set_allow_growth(true);
@@ -55,6 +55,7 @@ limitations under the License.
 #include "tensorflow/core/graph/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
@@ -258,6 +259,20 @@ class BaseGPUDevice::StreamGroupFactory {
       VLOG(2) << "Created device_to_host_stream[" << stream_group_within_gpu
               << "] = " << group->device_to_host;
 
+      if (GPUDeviceContext::BulkCopyThresholdBytes() > 0) {
+        group->host_to_device_bulk = new se::Stream(executor);
+        group->host_to_device_bulk->Init();
+        VLOG(2) << "Created host_to_device_bulk_stream["
+                << stream_group_within_gpu
+                << "] = " << group->host_to_device_bulk;
+
+        group->device_to_host_bulk = new se::Stream(executor);
+        group->device_to_host_bulk->Init();
+        VLOG(2) << "Created device_to_host_bulk_stream["
+                << stream_group_within_gpu
+                << "] = " << group->device_to_host_bulk;
+      }
+
       int num_d2d_streams =
           options.experimental().num_dev_to_dev_copy_streams();
       if (num_d2d_streams == 0) num_d2d_streams = 1;
@@ -379,6 +394,12 @@ Status BaseGPUDevice::Init(const SessionOptions& options) {
 
   executor_ = executor_status.ValueOrDie();
   em_.reset(new EventMgr(executor_, options.config.gpu_options()));
+  if (GpuOpTimingRecorder::Enabled()) {
+    op_timing_.reset(new GpuOpTimingRecorder(executor_));
+  }
+  if (GpuLaunchSequenceTracker::Enabled()) {
+    launch_sequence_tracker_.reset(new GpuLaunchSequenceTracker());
+  }
 
   if (max_streams_ < 1) {
     return errors::InvalidArgument("Invalid value for max_streams.");
@@ -390,7 +411,9 @@ Status BaseGPUDevice::Init(const SessionOptions& options) {
         tf_gpu_id_, i, executor_, options.config.gpu_options()));
     device_contexts_.push_back(new GPUDeviceContext(
         i, streams_.back()->compute, streams_.back()->host_to_device,
-        streams_.back()->device_to_host, streams_.back()->device_to_device));
+        streams_.back()->device_to_host, streams_.back()->device_to_device,
+        streams_.back()->host_to_device_bulk,
+        streams_.back()->device_to_host_bulk));
   }
   gpu_device_info_ = new GpuDeviceInfo;
   gpu_device_info_->stream = streams_[0]->compute;
@@ -505,6 +528,25 @@ void BaseGPUDevice::Compute(OpKernel* op_kernel, OpKernelContext* context) {
   }
 }
 
+namespace {
+
+// Identifies a kernel launch for sequence capture: the kernel instance
+// plus the byte sizes of its inputs, so that a shape change registers as
+// divergence without hashing full shapes on the hot path.
+uint64 LaunchSequenceFingerprint(OpKernel* op_kernel,
+                                 OpKernelContext* context) {
+  uint64 fp = Hash64Combine(reinterpret_cast<uintptr_t>(op_kernel),
+                            context->num_inputs());
+  for (int i = 0; i < context->num_inputs(); ++i) {
+    if (context->has_input(i) && !IsRefType(context->input_dtype(i))) {
+      fp = Hash64Combine(fp, context->input(i).TotalBytes());
+    }
+  }
+  return fp;
+}
+
+}  // namespace
+
 string BaseGPUDevice::ComputeOpKernelDebugString(const OpKernel& op_kernel,
                                                  const int& stream_id) {
   return strings::StrCat(op_kernel.name(), " op ", op_kernel.type_string(),
@@ -567,8 +609,30 @@ void BaseGPUDevice::ComputeHelper(OpKernel* op_kernel,
     kernel_tracker_->PauseWhilePendingExceeds(pending_cap_);
   }
   ScopedActivateExecutorContext scoped_activation{stream->parent()};
+  bool in_stable_sequence = false;
+  if (launch_sequence_tracker_ != nullptr) {
+    in_stable_sequence = launch_sequence_tracker_->RecordLaunch(
+        context->step_id(), LaunchSequenceFingerprint(op_kernel, context));
+  }
+  se::Timer* op_timer = nullptr;
+  if (op_timing_ != nullptr && !in_stable_sequence) {
+    // While a captured launch sequence replays, skip the per-op timer
+    // bracketing; the samples from the warmup steps already cover it and
+    // bracketing resumes as soon as the sequence diverges.
+    op_timer = op_timing_->StartTimer(stream);
+  }
   op_kernel->Compute(context);
   if (context->status().ok()) {
+    if (op_timer != nullptr) {
+      // Stop bracketing the op's stream work and read the elapsed time
+      // once the stream has drained past the stop timestamp.
+      op_timing_->StopTimer(stream, op_timer);
+      GpuOpTimingRecorder* recorder = op_timing_.get();
+      const string op_type = op_kernel->type_string();
+      em_->ThenExecute(stream, [recorder, op_type, op_timer]() {
+        recorder->RecordElapsed(op_type, op_timer);
+      });
+    }
     if (sync_every_op_) {
       // Note: GPUUtil::Sync() only syncs the default stream.
       // We need to either sync the stream used by this op, or
@@ -592,6 +656,11 @@ void BaseGPUDevice::ComputeHelper(OpKernel* op_kernel,
       });
     }
   } else {
+    if (op_timer != nullptr) {
+      // The op failed; recycle the timer without recording a sample.
+      op_timing_->StopTimer(stream, op_timer);
+      op_timing_->ReturnTimer(op_timer);
+    }
     if (vlog_1) {
       VLOG(1) << "GpuDevice::ComputeHelper failed to schedule "
               << ComputeOpKernelDebugString(*op_kernel, stream_id);
@@ -31,6 +31,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id_manager.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id_utils.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_launch_sequence_tracker.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_op_timing.h"
 #include "tensorflow/core/common_runtime/gpu_device_context.h"
 #include "tensorflow/core/common_runtime/local_device.h"
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
@@ -140,6 +142,10 @@ class BaseGPUDevice : public LocalDevice {
     se::Stream* host_to_device = nullptr;
     se::Stream* device_to_host = nullptr;
     gtl::InlinedVector<se::Stream*, 4> device_to_device;
+    // Only created when TF_GPU_BULK_COPY_THRESHOLD_MB is set; copies at
+    // least that large are dispatched here instead of the streams above.
+    se::Stream* host_to_device_bulk = nullptr;
+    se::Stream* device_to_host_bulk = nullptr;
   };
   class StreamGroupFactory;
 
@@ -155,6 +161,13 @@ class BaseGPUDevice : public LocalDevice {
   std::unique_ptr<EventMgr> em_;
   std::unique_ptr<thread::ThreadPool> thread_pool_;
   std::unique_ptr<GPUKernelTracker> kernel_tracker_;
+  // Non-null when TF_GPU_OP_TIMING is set; brackets every op's stream work
+  // with device-side timestamps and aggregates per-op-type latency.
+  std::unique_ptr<GpuOpTimingRecorder> op_timing_;
+  // Non-null when TF_GPU_LAUNCH_SEQUENCE_BATCHING is set; detects stable
+  // per-step launch sequences so optional per-launch bookkeeping can be
+  // skipped while they replay.
+  std::unique_ptr<GpuLaunchSequenceTracker> launch_sequence_tracker_;
   int pending_cap_ = 0;
   bool timestamped_allocator_ = false;
 
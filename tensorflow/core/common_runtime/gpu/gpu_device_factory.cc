@@ -22,9 +22,30 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/common_runtime/threadpool_device.h"
 #include "tensorflow/core/platform/numa.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+// Returns the number of compute streams per GPU device.  With more than one
+// stream, BaseGPUDevice assigns independent kernels to different streams
+// (gpu_stream_util::AssignStreams) and serializes cross-stream dependencies
+// with stream waits, which lets independent branches of a graph overlap on
+// the device.  Defaults to 1 (all compute serialized on a single stream).
+static int32 MaxComputeStreams() {
+  static const int32 max_streams = [] {
+    int64 max_streams;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GPU_MAX_COMPUTE_STREAMS",
+                                    1 /* default_val */, &max_streams));
+    if (max_streams < 1) {
+      LOG(WARNING) << "Invalid TF_GPU_MAX_COMPUTE_STREAMS value "
+                   << max_streams << ": using 1 instead.";
+      max_streams = 1;
+    }
+    return static_cast<int32>(max_streams);
+  }();
+  return max_streams;
+}
+
 class GPUDevice : public BaseGPUDevice {
  public:
   GPUDevice(const SessionOptions& options, const string& name,
@@ -33,7 +54,7 @@ class GPUDevice : public BaseGPUDevice {
             Allocator* gpu_allocator, Allocator* cpu_allocator)
       : BaseGPUDevice(options, name, memory_limit, locality, tf_gpu_id,
                       physical_device_desc, gpu_allocator, cpu_allocator,
-                      false /* sync every op */, 1 /* max_streams */) {
+                      false /* sync every op */, MaxComputeStreams()) {
     if (options.config.has_gpu_options()) {
       force_gpu_compatible_ =
           options.config.gpu_options().force_gpu_compatible();
@@ -15,9 +15,12 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/platform/stacktrace.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/protobuf/config.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -27,6 +30,46 @@ namespace {
 //  - Is this the right number of threads?
 //  - Should EventMgrs be shared between GPUDevices on a multi-GPU machine?
 static const int kNumThreads = 2;
+
+// Experimental: adapt the polling cadence to observed event completions
+// instead of sleeping a fixed polling_active_delay_usecs between polls.
+bool AdaptivePollingEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_EVENT_MGR_ADAPTIVE_POLLING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Experimental: collect a per-device histogram of event queue-to-completion
+// latencies and log it when the EventMgr is destroyed.
+bool EventMgrStatsEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_EVENT_MGR_STATS",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Experimental: coalesce ThenExecute callbacks for one stream under a
+// single event instead of recording one event per callback.
+bool FuncBatchingEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_EVENT_FUNC_BATCHING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Upper bound on the number of callbacks sharing one event, so a single
+// flush never schedules an unbounded amount of work.
+const int kAccumulatedFuncLimit = 64;
 }  // namespace
 
 namespace gpu_event_mgr {
@@ -97,10 +140,17 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
       polling_active_delay_usecs_(gpu_options.polling_active_delay_usecs()
                                       ? gpu_options.polling_active_delay_usecs()
                                       : 10),
+      adaptive_polling_(AdaptivePollingEnabled()),
+      func_batching_enabled_(FuncBatchingEnabled()),
       accumulated_stream_(nullptr),
       accumulated_tensors_(new TensorReferenceVector),
       accumulated_tensor_bytes_(0),
+      accumulated_func_stream_(nullptr),
+      accumulated_funcs_(new std::vector<std::function<void()>>),
       threadpool_(Env::Default(), "GPU_Event_Manager", kNumThreads) {
+  if (EventMgrStatsEnabled()) {
+    event_latency_histogram_.reset(new histogram::Histogram);
+  }
   gpu_event_mgr::InitThreadpoolLabels(&threadpool_);
   StartPollingLoop();
 }
@@ -108,6 +158,12 @@ EventMgr::EventMgr(se::StreamExecutor* se, const GPUOptions& gpu_options)
 EventMgr::~EventMgr() {
   StopPollingLoop();
 
+  if (event_latency_histogram_) {
+    LOG(INFO) << "EventMgr queue-to-completion latency (usecs) for GPU "
+              << exec_->device_ordinal() << ": "
+              << event_latency_histogram_->ToString();
+  }
+
   // Events are owned by this object.
   for (auto& e : free_events_) {
     delete e;
@@ -116,6 +172,12 @@ EventMgr::~EventMgr() {
     t.Unref();
   }
   delete accumulated_tensors_;
+  // Batched callbacks that never got an event are scheduled directly,
+  // matching the treatment of queued funcs in the drain loop below.
+  for (auto& f : *(accumulated_funcs_)) {
+    threadpool_.Schedule(f);
+  }
+  delete accumulated_funcs_;
   while (!used_events_.empty()) {
     InUse* ue = &used_events_[0];
     delete ue->event;
@@ -189,12 +251,44 @@ void EventMgr::FlushAccumulatedTensors() {
   accumulated_stream_ = nullptr;
 }
 
+void EventMgr::QueueFuncBatched(se::Stream* stream,
+                                std::function<void()> func) {
+  if (!accumulated_funcs_->empty() && stream != accumulated_func_stream_) {
+    FlushAccumulatedFuncs();
+  }
+  accumulated_func_stream_ = stream;
+  accumulated_funcs_->push_back(std::move(func));
+  if (static_cast<int>(accumulated_funcs_->size()) >= kAccumulatedFuncLimit) {
+    FlushAccumulatedFuncs();
+  }
+}
+
+void EventMgr::FlushAccumulatedFuncs() {
+  DCHECK(!accumulated_funcs_->empty());
+  DCHECK(accumulated_func_stream_ != nullptr);
+  std::vector<std::function<void()>>* funcs = accumulated_funcs_;
+  QueueFunc(accumulated_func_stream_, [funcs]() {
+    for (auto& f : *funcs) {
+      f();
+    }
+    delete funcs;
+  });
+  accumulated_funcs_ = new std::vector<std::function<void()>>;
+  accumulated_func_stream_ = nullptr;
+}
+
 // A polling loop to detect completion of GPU events.
 //
 // While one or more events is outstanding, poll for completed events.  When no
 // events are outstanding, we sleep until one is enqueued.
+//
+// In adaptive mode a completed event is taken as a sign that more completions
+// are imminent (kernels in a burst tend to retire together), so the loop
+// re-polls immediately, and while nothing completes the sleep backs off
+// exponentially from 1 usec up to polling_active_delay_usecs_.
 void EventMgr::PollLoop() {
   ToFreeVector to_free;
+  int64 sleep_usecs = polling_active_delay_usecs_;
   while (true) {
     bool events_still_pending;
     {
@@ -202,17 +296,36 @@ void EventMgr::PollLoop() {
       if (stop_polling_) {
         break;
       }
+      // Flush any batched callbacks before potentially sleeping, so a
+      // callback waits at most one polling cycle for its event.
+      if (!accumulated_funcs_->empty()) {
+        FlushAccumulatedFuncs();
+      }
       if (used_events_.empty()) {
         events_pending_.wait(l);
       }
       PollEvents(true, &to_free);
       events_still_pending = !used_events_.empty();
     }
+    const bool retired_any = !to_free.empty();
     FreeMemory(to_free);
     to_free.clear();
 
     if (events_still_pending) {
-      Env::Default()->SleepForMicroseconds(polling_active_delay_usecs_);
+      if (adaptive_polling_) {
+        if (retired_any) {
+          sleep_usecs = 0;  // Re-poll right away.
+        } else {
+          sleep_usecs = std::max<int64>(
+              1, std::min<int64>(polling_active_delay_usecs_,
+                                 sleep_usecs * 2));
+        }
+      } else {
+        sleep_usecs = polling_active_delay_usecs_;
+      }
+      if (sleep_usecs > 0) {
+        Env::Default()->SleepForMicroseconds(sleep_usecs);
+      }
     }
   }
   polling_stopped_->Notify();
@@ -231,6 +344,9 @@ void EventMgr::QueueInUse(se::Stream* stream, InUse iu) {
   free_events_.pop_back();
   stream->ThenRecordEvent(e);
   iu.event = e;
+  if (event_latency_histogram_) {
+    iu.queued_usec = Env::Default()->NowMicros();
+  }
   bool was_empty = used_events_.empty();
   used_events_.push_back(iu);
   // Maybe wake up the polling thread
@@ -276,6 +392,10 @@ void EventMgr::PollEvents(bool is_dedicated_poller,
         if (!is_dedicated_poller) return;  // quit processing queue
         break;
       case se::Event::Status::kComplete:
+        if (event_latency_histogram_) {
+          event_latency_histogram_->Add(
+              static_cast<double>(Env::Default()->NowMicros() - iu.queued_usec));
+        }
         // Make a copy of the InUse record so we can free it after releasing
         // the lock
         to_free->push_back(iu);
@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/lib/histogram/histogram.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/thread_annotations.h"
@@ -100,8 +101,14 @@ class EventMgr {
     ToFreeVector to_free;
     {
       mutex_lock l(mu_);
-      QueueFunc(stream, std::move(func));
-      PollEvents(false, &to_free);
+      if (func_batching_enabled_) {
+        // Accumulate instead of recording one event per callback; the
+        // dedicated polling loop flushes the batch under a single event.
+        QueueFuncBatched(stream, std::move(func));
+      } else {
+        QueueFunc(stream, std::move(func));
+        PollEvents(false, &to_free);
+      }
     }
     FreeMemory(to_free);
   }
@@ -111,16 +118,38 @@ class EventMgr {
   se::StreamExecutor* const exec_;
   const int64 deferred_bytes_threshold_;
   const int32 polling_active_delay_usecs_;
+  // If true, the polling loop re-polls immediately after retiring an event
+  // and backs off exponentially (up to polling_active_delay_usecs_) while
+  // events stay pending, instead of sleeping a fixed delay between polls.
+  const bool adaptive_polling_;
+  // If true, ThenExecute callbacks for one stream are coalesced under a
+  // single event instead of costing one event each.
+  const bool func_batching_enabled_;
   mutex mu_;
   condition_variable events_pending_ GUARDED_BY(mu_);
 
   void FlushAccumulatedTensors() EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
+  // Appends func to the batch of callbacks waiting to share one event,
+  // flushing first if the batch is for a different stream, and after if
+  // the batch has grown large.  The dedicated polling loop flushes any
+  // remainder, so a callback waits at most one polling cycle beyond its
+  // event's completion.  Callbacks only ever fire later than they would
+  // have unbatched, never earlier, since the shared event is recorded at
+  // or after each callback's enqueue point.
+  void QueueFuncBatched(se::Stream* stream, std::function<void()> func)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  void FlushAccumulatedFuncs() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   struct InUse {
     se::Event* event;
     TensorReferenceVector* mem;
     BufRec bufrec;
     std::function<void()> func;
+    // Time at which the event was queued, in microseconds.  Only populated
+    // when the event-latency histogram is enabled.
+    uint64 queued_usec;
   };
 
   typedef gtl::InlinedVector<InUse, 4> ToFreeVector;
@@ -192,9 +221,19 @@ class EventMgr {
   // Sum of the TotalBytes() of the tensors in "accumulated_tensors_"
   int64 accumulated_tensor_bytes_ GUARDED_BY(mu_);
 
+  // Buffered ThenExecute callbacks waiting to share one event; only used
+  // when func_batching_enabled_ is true.
+  se::Stream* accumulated_func_stream_ GUARDED_BY(mu_);
+  std::vector<std::function<void()>>* accumulated_funcs_ GUARDED_BY(mu_);
+
   // A FIFO queue of InUse events and associated tensors.
   std::deque<InUse> used_events_ GUARDED_BY(mu_);
 
+  // Distribution of queue-to-completion latencies (usecs) for this device's
+  // events.  Null unless TF_GPU_EVENT_MGR_STATS is set; dumped at shutdown.
+  std::unique_ptr<histogram::Histogram> event_latency_histogram_
+      GUARDED_BY(mu_);
+
   bool stop_polling_ GUARDED_BY(mu_);
   std::unique_ptr<Notification> polling_stopped_;
 
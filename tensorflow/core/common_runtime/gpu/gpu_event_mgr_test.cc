@@ -20,6 +20,7 @@ limitations under the License.
 #include <atomic>
 #include "tensorflow/core/common_runtime/gpu/gpu_init.h"
 #include "tensorflow/core/lib/core/notification.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/config.pb.h"
@@ -65,6 +66,23 @@ class TEST_EventMgrHelper {
     }
   }
 
+  void QueueFuncBatched(se::Stream* stream, std::function<void()> func) {
+    mutex_lock l(em_->mu_);
+    em_->QueueFuncBatched(stream, std::move(func));
+  }
+
+  void FlushAccumulatedFuncs() {
+    mutex_lock l(em_->mu_);
+    if (!em_->accumulated_funcs_->empty()) {
+      em_->FlushAccumulatedFuncs();
+    }
+  }
+
+  size_t accumulated_func_count() {
+    mutex_lock l(em_->mu_);
+    return em_->accumulated_funcs_->size();
+  }
+
   void StopPollingLoop() { em_->StopPollingLoop(); }
 
   void StartPollingLoop() { em_->StartPollingLoop(); }
@@ -244,6 +262,56 @@ TEST(EventMgr, NonEmptyShutdown) {
   }
 }
 
+// Batched callbacks accumulate without consuming events, then share a
+// single event once flushed.
+TEST(EventMgr, BatchedFuncsShareOneEvent) {
+  auto stream_exec = GPUMachineManager()->ExecutorForDevice(0).ValueOrDie();
+  EventMgr em(stream_exec, GPUOptions());
+  TEST_EventMgrHelper th(&em);
+  std::unique_ptr<se::Stream> stream(new se::Stream(stream_exec));
+  CHECK(stream);
+  stream->Init();
+  std::atomic<int> run_count(0);
+  for (int i = 0; i < 5; ++i) {
+    th.QueueFuncBatched(stream.get(), [&run_count]() { ++run_count; });
+  }
+  // All five callbacks are waiting in the batch; no event consumed yet.
+  EXPECT_EQ(0, th.queue_size());
+  EXPECT_EQ(5, th.accumulated_func_count());
+  th.FlushAccumulatedFuncs();
+  EXPECT_EQ(0, th.accumulated_func_count());
+  EXPECT_EQ(1, th.queue_size());
+  th.PollEvents(true);
+  while (run_count < 5) {
+    Env::Default()->SleepForMicroseconds(100);
+  }
+  EXPECT_EQ(5, run_count);
+}
+
+// A batched callback for a different stream flushes the open batch.
+TEST(EventMgr, BatchedFuncStreamSwitchFlushes) {
+  auto stream_exec = GPUMachineManager()->ExecutorForDevice(0).ValueOrDie();
+  EventMgr em(stream_exec, GPUOptions());
+  TEST_EventMgrHelper th(&em);
+  std::unique_ptr<se::Stream> stream1(new se::Stream(stream_exec));
+  std::unique_ptr<se::Stream> stream2(new se::Stream(stream_exec));
+  stream1->Init();
+  stream2->Init();
+  std::atomic<int> run_count(0);
+  th.QueueFuncBatched(stream1.get(), [&run_count]() { ++run_count; });
+  EXPECT_EQ(0, th.queue_size());
+  th.QueueFuncBatched(stream2.get(), [&run_count]() { ++run_count; });
+  // The first batch was flushed by the switch to stream2.
+  EXPECT_EQ(1, th.queue_size());
+  EXPECT_EQ(1, th.accumulated_func_count());
+  th.FlushAccumulatedFuncs();
+  th.PollEvents(true);
+  while (run_count < 2) {
+    Env::Default()->SleepForMicroseconds(100);
+  }
+  EXPECT_EQ(2, run_count);
+}
+
 // Tests that WarnIfInCallback() triggers correctly.
 TEST(EventMgr, WarnIfInCallback) {
   auto stream_exec = GPUMachineManager()->ExecutorForDevice(0).ValueOrDie();
@@ -0,0 +1,196 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_HOST_CACHING_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_HOST_CACHING_ALLOCATOR_H_
+
+#include <thread>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/core/bits.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Size-classed caching layer over the pinned-host allocator.  Allocations
+// up to kMaxCachedBytes are rounded up to power-of-two size classes and
+// retained in sharded free lists on deallocation (sharded by thread, so
+// concurrent input-pipeline threads rarely contend on a lock), letting
+// steady-state H2D staging be served from the cache without touching the
+// underlying allocator.  Cache hit/miss counts are tracked per shard and
+// logged when the allocator is destroyed.
+//
+// The underlying allocator must track allocation sizes (e.g. BFCAllocator),
+// since cached blocks are identified by their rounded requested size.
+class GpuHostCachingAllocator : public Allocator {
+ public:
+  // 'underlying' is not owned and must outlive this allocator.
+  explicit GpuHostCachingAllocator(Allocator* underlying)
+      : underlying_(underlying) {
+    CHECK(underlying_->TracksAllocationSizes());
+  }
+
+  ~GpuHostCachingAllocator() override {
+    int64 hits = 0;
+    int64 misses = 0;
+    for (Shard& shard : shards_) {
+      mutex_lock l(shard.mu);
+      hits += shard.hits;
+      misses += shard.misses;
+      for (auto& free_list : shard.free_lists) {
+        for (void* ptr : free_list) {
+          underlying_->DeallocateRaw(ptr);
+        }
+      }
+    }
+    if (hits + misses > 0) {
+      VLOG(1) << "GpuHostCachingAllocator: " << hits << " hits, " << misses
+              << " misses (hit rate "
+              << 100.0 * hits / static_cast<double>(hits + misses) << "%)";
+    }
+  }
+
+  string Name() override { return "gpu_host_cache"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    if (num_bytes == 0 || num_bytes > kMaxCachedBytes ||
+        alignment > Allocator::kAllocatorAlignment) {
+      return underlying_->AllocateRaw(alignment, num_bytes);
+    }
+    const int size_class = SizeClass(num_bytes);
+    Shard* shard = CurrentShard();
+    {
+      mutex_lock l(shard->mu);
+      std::vector<void*>& free_list = shard->free_lists[size_class];
+      if (!free_list.empty()) {
+        void* ptr = free_list.back();
+        free_list.pop_back();
+        shard->cached_bytes -= (1ULL << size_class);
+        ++shard->hits;
+        return ptr;
+      }
+      ++shard->misses;
+    }
+    return underlying_->AllocateRaw(Allocator::kAllocatorAlignment,
+                                    1ULL << size_class);
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    if (ptr == nullptr) return;
+    const size_t num_bytes = underlying_->RequestedSize(ptr);
+    // Only blocks this allocator rounded to a cacheable size class are
+    // recycled; everything else was a pass-through allocation.
+    if (num_bytes < kMinCachedBytes || num_bytes > kMaxCachedBytes ||
+        (num_bytes & (num_bytes - 1)) != 0) {
+      underlying_->DeallocateRaw(ptr);
+      return;
+    }
+    const int size_class = Log2Floor64(num_bytes);
+    Shard* shard = CurrentShard();
+    {
+      mutex_lock l(shard->mu);
+      if (shard->cached_bytes + num_bytes <= kMaxCachedBytesPerShard) {
+        shard->free_lists[size_class].push_back(ptr);
+        shard->cached_bytes += num_bytes;
+        return;
+      }
+    }
+    underlying_->DeallocateRaw(ptr);
+  }
+
+  bool TracksAllocationSizes() override { return true; }
+
+  size_t RequestedSize(const void* ptr) override {
+    return underlying_->RequestedSize(ptr);
+  }
+
+  size_t AllocatedSize(const void* ptr) override {
+    return underlying_->AllocatedSize(ptr);
+  }
+
+  int64 AllocationId(const void* ptr) override {
+    return underlying_->AllocationId(ptr);
+  }
+
+  absl::optional<AllocatorStats> GetStats() override {
+    return underlying_->GetStats();
+  }
+
+  void ClearStats() override { underlying_->ClearStats(); }
+
+  // Cumulative cache hit/miss counts, for tests and diagnostics.
+  int64 cache_hits() const {
+    int64 hits = 0;
+    for (const Shard& shard : shards_) {
+      mutex_lock l(shard.mu);
+      hits += shard.hits;
+    }
+    return hits;
+  }
+
+  int64 cache_misses() const {
+    int64 misses = 0;
+    for (const Shard& shard : shards_) {
+      mutex_lock l(shard.mu);
+      misses += shard.misses;
+    }
+    return misses;
+  }
+
+ private:
+  // Smallest and largest cached size classes.  Staging buffers larger than
+  // kMaxCachedBytes are rare enough that the underlying allocator's cost is
+  // amortized.
+  static constexpr size_t kMinCachedBytes = 256;
+  static constexpr size_t kMaxCachedBytes = 64 << 20;
+  // Bound on bytes retained per shard, to keep pinned memory (which is
+  // scarce) from accumulating in idle free lists.
+  static constexpr size_t kMaxCachedBytesPerShard = 256 << 20;
+  static constexpr int kNumShards = 16;
+  static constexpr int kNumSizeClasses = 27;  // Log2Ceiling64(kMaxCachedBytes)
+
+  struct Shard {
+    mutable mutex mu;
+    // Indexed by size class (log2 of the block size).
+    std::vector<void*> free_lists[kNumSizeClasses] GUARDED_BY(mu);
+    size_t cached_bytes GUARDED_BY(mu) = 0;
+    int64 hits GUARDED_BY(mu) = 0;
+    int64 misses GUARDED_BY(mu) = 0;
+  };
+
+  // Size class for an allocation: log2 of the rounded-up block size.
+  static int SizeClass(size_t num_bytes) {
+    if (num_bytes <= kMinCachedBytes) return Log2Floor64(kMinCachedBytes);
+    return Log2Ceiling64(num_bytes);
+  }
+
+  Shard* CurrentShard() {
+    const size_t id = std::hash<std::thread::id>()(std::this_thread::get_id());
+    return &shards_[id % kNumShards];
+  }
+
+  Allocator* underlying_;  // not owned
+  Shard shards_[kNumShards];
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GpuHostCachingAllocator);
+};
+
+}  // namespace tensorflow
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_HOST_CACHING_ALLOCATOR_H_
@@ -0,0 +1,87 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_launch_sequence_tracker.h"
+
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+/* static */ bool GpuLaunchSequenceTracker::Enabled() {
+  static const bool enabled = []() {
+    bool enabled = false;
+    Status s = ReadBoolFromEnvVar("TF_GPU_LAUNCH_SEQUENCE_BATCHING", false,
+                                  &enabled);
+    if (!s.ok()) {
+      LOG(ERROR) << s.error_message();
+    }
+    return enabled;
+  }();
+  return enabled;
+}
+
+GpuLaunchSequenceTracker::GpuLaunchSequenceTracker(int stable_steps_required)
+    : stable_steps_required_(stable_steps_required) {}
+
+bool GpuLaunchSequenceTracker::RecordLaunch(int64 step_id,
+                                            uint64 launch_fingerprint) {
+  mutex_lock l(mu_);
+  if (step_id != current_step_id_) {
+    FinalizeStep();
+    current_step_id_ = step_id;
+    current_xor_ = 0;
+    current_sum_ = 0;
+    current_count_ = 0;
+  }
+  current_xor_ ^= launch_fingerprint;
+  current_sum_ += launch_fingerprint;
+  ++current_count_;
+  if (stable_steps_ < stable_steps_required_) {
+    return false;
+  }
+  if (current_count_ > captured_count_) {
+    // The step grew past the captured sequence: divergence is known
+    // before the step finishes, so stop replaying right away.
+    stable_steps_ = 0;
+    return false;
+  }
+  return true;
+}
+
+int GpuLaunchSequenceTracker::stable_step_count() const {
+  mutex_lock l(mu_);
+  return stable_steps_;
+}
+
+void GpuLaunchSequenceTracker::FinalizeStep() {
+  if (current_step_id_ == -1) {
+    return;
+  }
+  // The xor alone would let pairs of identical launches cancel out, so
+  // mix in the additive accumulator as well.
+  const uint64 signature = Hash64Combine(current_xor_, current_sum_);
+  if (current_count_ == captured_count_ &&
+      signature == captured_signature_) {
+    ++stable_steps_;
+  } else {
+    stable_steps_ = 0;
+    captured_signature_ = signature;
+    captured_count_ = current_count_;
+  }
+}
+
+}  // namespace tensorflow
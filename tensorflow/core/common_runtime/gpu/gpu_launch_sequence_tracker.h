@@ -0,0 +1,81 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_LAUNCH_SEQUENCE_TRACKER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_LAUNCH_SEQUENCE_TRACKER_H_
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Detects when the per-step sequence of kernels launched on a GPU device
+// has settled into a steady state, so that BaseGPUDevice can drop
+// optional per-launch bookkeeping while the sequence replays and restore
+// it as soon as the sequence diverges -- a lightweight analogue of
+// HIP/CUDA graph capture at the TF runtime level.
+//
+// A step's signature combines every launch's fingerprint (kernel
+// identity and parameter sizes) with the launch count. The combination
+// is order independent because independent ops of one step may be
+// launched from different executor threads in a nondeterministic order;
+// a change in any kernel or its parameters still changes the signature.
+// After `stable_steps_required` consecutive steps with identical
+// signatures the sequence counts as captured. Divergence is noticed
+// immediately when a step launches more kernels than the captured
+// sequence, and otherwise at the next step boundary.
+class GpuLaunchSequenceTracker {
+ public:
+  // Returns true if TF_GPU_LAUNCH_SEQUENCE_BATCHING is set. Read once
+  // per process.
+  static bool Enabled();
+
+  explicit GpuLaunchSequenceTracker(int stable_steps_required = 3);
+
+  // Records one kernel launch belonging to `step_id` and returns true if
+  // the launch is part of a captured sequence, i.e. optional per-launch
+  // bookkeeping may be skipped. Seeing a step id other than the current
+  // one finalizes the running step's signature first.
+  bool RecordLaunch(int64 step_id, uint64 launch_fingerprint);
+
+  // Number of consecutive finalized steps whose signatures matched the
+  // captured sequence.
+  int stable_step_count() const;
+
+ private:
+  // Folds the running step into the stability bookkeeping.
+  void FinalizeStep() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  const int stable_steps_required_;
+
+  mutable mutex mu_;
+  int64 current_step_id_ GUARDED_BY(mu_) = -1;
+  // Order-independent accumulators over the running step's fingerprints.
+  uint64 current_xor_ GUARDED_BY(mu_) = 0;
+  uint64 current_sum_ GUARDED_BY(mu_) = 0;
+  int64 current_count_ GUARDED_BY(mu_) = 0;
+  // Signature and launch count of the candidate captured sequence.
+  uint64 captured_signature_ GUARDED_BY(mu_) = 0;
+  int64 captured_count_ GUARDED_BY(mu_) = -1;
+  int stable_steps_ GUARDED_BY(mu_) = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GpuLaunchSequenceTracker);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_LAUNCH_SEQUENCE_TRACKER_H_
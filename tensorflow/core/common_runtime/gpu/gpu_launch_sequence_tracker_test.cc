@@ -0,0 +1,83 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_launch_sequence_tracker.h"
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(GpuLaunchSequenceTrackerTest, CapturesAfterWarmup) {
+  GpuLaunchSequenceTracker tracker(/*stable_steps_required=*/3);
+
+  // Four identical steps: the first is the baseline and the next three
+  // match it, so the sequence is captured once they have finalized.
+  for (int64 step = 1; step <= 4; ++step) {
+    EXPECT_FALSE(tracker.RecordLaunch(step, 11));
+    EXPECT_FALSE(tracker.RecordLaunch(step, 22));
+    EXPECT_FALSE(tracker.RecordLaunch(step, 33));
+  }
+  EXPECT_TRUE(tracker.RecordLaunch(5, 11));
+  EXPECT_TRUE(tracker.RecordLaunch(5, 22));
+  EXPECT_TRUE(tracker.RecordLaunch(5, 33));
+  EXPECT_EQ(tracker.stable_step_count(), 3);
+}
+
+TEST(GpuLaunchSequenceTrackerTest, OrderIndependentWithinStep) {
+  GpuLaunchSequenceTracker tracker(/*stable_steps_required=*/2);
+
+  for (int64 step = 1; step <= 3; ++step) {
+    tracker.RecordLaunch(step, 11);
+    tracker.RecordLaunch(step, 22);
+  }
+  // Independent ops may be launched in any order by the executor
+  // threads; swapping them must not count as divergence.
+  EXPECT_TRUE(tracker.RecordLaunch(4, 22));
+  EXPECT_TRUE(tracker.RecordLaunch(4, 11));
+}
+
+TEST(GpuLaunchSequenceTrackerTest, ExtraLaunchStopsReplayImmediately) {
+  GpuLaunchSequenceTracker tracker(/*stable_steps_required=*/2);
+
+  for (int64 step = 1; step <= 3; ++step) {
+    tracker.RecordLaunch(step, 11);
+    tracker.RecordLaunch(step, 22);
+  }
+  EXPECT_TRUE(tracker.RecordLaunch(4, 11));
+  EXPECT_TRUE(tracker.RecordLaunch(4, 22));
+  // A third launch exceeds the captured count, so replay stops within
+  // the step instead of waiting for the boundary.
+  EXPECT_FALSE(tracker.RecordLaunch(4, 33));
+  EXPECT_FALSE(tracker.RecordLaunch(5, 11));
+}
+
+TEST(GpuLaunchSequenceTrackerTest, ChangedFingerprintRecapturesLater) {
+  GpuLaunchSequenceTracker tracker(/*stable_steps_required=*/2);
+
+  for (int64 step = 1; step <= 3; ++step) {
+    tracker.RecordLaunch(step, 11);
+  }
+  // A changed fingerprint (e.g. a resized input) is noticed at the next
+  // step boundary; the new sequence becomes the baseline and is captured
+  // again after it proves stable.
+  tracker.RecordLaunch(4, 77);
+  EXPECT_FALSE(tracker.RecordLaunch(5, 77));
+  EXPECT_FALSE(tracker.RecordLaunch(6, 77));
+  EXPECT_TRUE(tracker.RecordLaunch(7, 77));
+}
+
+}  // namespace
+}  // namespace tensorflow
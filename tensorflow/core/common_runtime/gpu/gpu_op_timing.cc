@@ -0,0 +1,86 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/gpu/gpu_op_timing.h"
+
+#include "tensorflow/core/lib/monitoring/sampler.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Exponential buckets from 1us to ~8.4s.
+auto* gpu_op_time_usecs = monitoring::Sampler<1>::New(
+    {"/tensorflow/core/gpu_op_time_usecs",
+     "Device-side execution time of GPU ops in microseconds, keyed by op "
+     "type.",
+     "op_type"},
+    monitoring::Buckets::Exponential(1, 2, 24));
+
+}  // namespace
+
+/* static */ bool GpuOpTimingRecorder::Enabled() {
+  static const bool enabled = []() {
+    bool enabled = false;
+    Status s = ReadBoolFromEnvVar("TF_GPU_OP_TIMING", false, &enabled);
+    if (!s.ok()) {
+      LOG(ERROR) << s.error_message();
+    }
+    return enabled;
+  }();
+  return enabled;
+}
+
+GpuOpTimingRecorder::GpuOpTimingRecorder(se::StreamExecutor* executor)
+    : executor_(executor) {}
+
+se::Timer* GpuOpTimingRecorder::StartTimer(se::Stream* stream) {
+  se::Timer* timer = nullptr;
+  {
+    mutex_lock l(mu_);
+    if (!free_timers_.empty()) {
+      timer = free_timers_.back().release();
+      free_timers_.pop_back();
+    }
+  }
+  if (timer == nullptr) {
+    timer = new se::Timer(executor_);
+    stream->InitTimer(timer);
+  }
+  stream->ThenStartTimer(timer);
+  return timer;
+}
+
+void GpuOpTimingRecorder::StopTimer(se::Stream* stream, se::Timer* timer) {
+  stream->ThenStopTimer(timer);
+}
+
+void GpuOpTimingRecorder::RecordElapsed(const string& op_type,
+                                        se::Timer* timer) {
+  gpu_op_time_usecs->GetCell(op_type)->Add(timer->Microseconds());
+  ReturnTimer(timer);
+}
+
+void GpuOpTimingRecorder::ReturnTimer(se::Timer* timer) {
+  mutex_lock l(mu_);
+  if (static_cast<int>(free_timers_.size()) < kMaxPooledTimers) {
+    free_timers_.emplace_back(timer);
+  } else {
+    delete timer;
+  }
+}
+
+}  // namespace tensorflow
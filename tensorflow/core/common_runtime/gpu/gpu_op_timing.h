@@ -0,0 +1,74 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_OP_TIMING_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_OP_TIMING_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Continuous per-op GPU timing, independent of the CUPTI/rocprofiler-style
+// device tracer. When enabled via TF_GPU_OP_TIMING=1, BaseGPUDevice
+// brackets every op's stream work with a pooled se::Timer (device-side
+// timestamp events; hipEvents on ROCm, cudaEvents on CUDA), has the
+// elapsed time read asynchronously once the stream drains past the stop
+// event, and aggregates the samples into a per-op-type histogram exported
+// through the monitoring registry as /tensorflow/core/gpu_op_time_usecs.
+class GpuOpTimingRecorder {
+ public:
+  // Returns true if TF_GPU_OP_TIMING is set. Read once per process.
+  static bool Enabled();
+
+  explicit GpuOpTimingRecorder(se::StreamExecutor* executor);
+
+  // Returns a timer whose start timestamp has been enqueued on 'stream',
+  // drawn from the pool when possible.
+  se::Timer* StartTimer(se::Stream* stream);
+
+  // Enqueues the stop timestamp for 'timer' on 'stream'. The caller must
+  // arrange for RecordElapsed() to run after the stream has drained past
+  // the stop event, e.g. via EventMgr::ThenExecute.
+  void StopTimer(se::Stream* stream, se::Timer* timer);
+
+  // Reads the elapsed time of a completed timer, records it under
+  // 'op_type' and returns the timer to the pool.
+  void RecordElapsed(const string& op_type, se::Timer* timer);
+
+  // Returns 'timer' to the pool without recording anything. Used when the
+  // op failed before its stream work was enqueued.
+  void ReturnTimer(se::Timer* timer);
+
+ private:
+  // Timers parked beyond this count are freed rather than pooled.
+  static const int kMaxPooledTimers = 64;
+
+  se::StreamExecutor* const executor_;  // Not owned.
+  mutex mu_;
+  std::vector<std::unique_ptr<se::Timer>> free_timers_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(GpuOpTimingRecorder);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_GPU_GPU_OP_TIMING_H_
@@ -18,8 +18,10 @@ limitations under the License.
 #include <cstring>
 #include <vector>
 
+#include "absl/memory/memory.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_host_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_bfc_allocator.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_host_caching_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_cudamalloc_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_debug_allocator.h"
 #include "tensorflow/core/common_runtime/gpu/gpu_id.h"
@@ -54,6 +56,31 @@ bool useCudaMemoryGuardAllocator() {
          std::strcmp(debug_allocator_str, "memory_guard") == 0;
 }
 
+// Experimental: layer a size-classed recycling cache over the pinned-host
+// allocator so steady-state input staging avoids the shared allocator.
+bool useGpuHostCachingAllocator() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_HOST_CACHING_ALLOCATOR",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Experimental: serve cudnn/MIOpen scratch workspaces from a dedicated
+// per-device arena instead of the main BFC pool (see
+// GetGPUWorkspaceAllocator).
+bool useGpuWorkspaceArena() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GPU_WORKSPACE_ARENA",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
 }  // namespace
 
 /*static*/ GPUProcessState* GPUProcessState::singleton(GPUProcessState* ps) {
@@ -105,16 +132,51 @@ Allocator* GPUProcessState::GetGPUAllocator(const GPUOptions& options,
     while (bus_id >= gpu_visitors_.size()) {
       gpu_visitors_.push_back({});
     }
-    GPUMemAllocator* sub_allocator = new GPUMemAllocator(
-        GpuIdUtil::ExecutorForPlatformGpuId(platform_gpu_id).ValueOrDie(),
-        platform_gpu_id,
+    const bool use_unified_memory =
         (options.per_process_gpu_memory_fraction() > 1.0 ||
-         options.experimental().use_unified_memory()),
-        gpu_visitors_[bus_id], {});
-    GPUBFCAllocator* gpu_bfc_allocator =
-        new GPUBFCAllocator(sub_allocator, total_bytes, options,
-                            strings::StrCat("GPU_", tf_gpu_id.value(), "_bfc"));
-    Allocator* gpu_allocator = gpu_bfc_allocator;
+         options.experimental().use_unified_memory());
+    auto new_sub_allocator = [&]() {
+      return new GPUMemAllocator(
+          GpuIdUtil::ExecutorForPlatformGpuId(platform_gpu_id).ValueOrDie(),
+          platform_gpu_id, use_unified_memory, gpu_visitors_[bus_id], {});
+    };
+
+    // If TF_GPU_BFC_NUM_SHARDS is set to k > 1, device memory is spread over
+    // k independent BFC arenas to reduce contention on the arena lock when
+    // many streams or threads allocate concurrently.  The sharded mode is
+    // incompatible with the timestamped allocator, which needs a single
+    // arena to observe all frees.
+    int64 num_shards = 1;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GPU_BFC_NUM_SHARDS", 1, &num_shards));
+    if (num_shards > 1 && options.experimental().timestamped_allocator()) {
+      LOG(WARNING) << "TF_GPU_BFC_NUM_SHARDS ignored because "
+                   << "timestamped_allocator is enabled.";
+      num_shards = 1;
+    }
+
+    GPUMemAllocator* sub_allocator = nullptr;
+    Allocator* gpu_allocator = nullptr;
+    GPUBFCAllocator* gpu_bfc_allocator = nullptr;
+    if (num_shards > 1) {
+      std::vector<std::unique_ptr<GPUBFCAllocator>> shards;
+      shards.reserve(num_shards);
+      for (int64 i = 0; i < num_shards; ++i) {
+        GPUMemAllocator* shard_sub_allocator = new_sub_allocator();
+        if (i == 0) sub_allocator = shard_sub_allocator;
+        shards.push_back(absl::make_unique<GPUBFCAllocator>(
+            shard_sub_allocator, total_bytes / num_shards, options,
+            strings::StrCat("GPU_", tf_gpu_id.value(), "_bfc_shard_", i)));
+      }
+      gpu_allocator = new ShardedGPUBFCAllocator(
+          std::move(shards),
+          strings::StrCat("GPU_", tf_gpu_id.value(), "_bfc"));
+    } else {
+      sub_allocator = new_sub_allocator();
+      gpu_bfc_allocator = new GPUBFCAllocator(
+          sub_allocator, total_bytes, options,
+          strings::StrCat("GPU_", tf_gpu_id.value(), "_bfc"));
+      gpu_allocator = gpu_bfc_allocator;
+    }
     SharedCounter* timing_counter = nullptr;
     if (options.experimental().timestamped_allocator()) {
       timing_counter = new SharedCounter;
@@ -176,6 +238,46 @@ SharedCounter* GPUProcessState::GPUAllocatorCounter(TfGpuId tf_gpu_id) {
 #endif
 }
 
+Allocator* GPUProcessState::GetGPUWorkspaceAllocator(
+    PlatformGpuId platform_gpu_id) {
+  CHECK(process_state_);
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+  if (!useGpuWorkspaceArena()) {
+    return nullptr;
+  }
+  mutex_lock lock(mu_);
+  if (platform_gpu_id.value() >=
+      static_cast<int64>(gpu_workspace_allocators_.size())) {
+    gpu_workspace_allocators_.resize(platform_gpu_id.value() + 1);
+  }
+  std::unique_ptr<Allocator>& allocator =
+      gpu_workspace_allocators_[platform_gpu_id.value()];
+  if (allocator == nullptr) {
+    GPUMemAllocator* sub_allocator = new GPUMemAllocator(
+        GpuIdUtil::ExecutorForPlatformGpuId(platform_gpu_id).ValueOrDie(),
+        platform_gpu_id, false /*use_unified_memory*/, {}, {});
+    int64 workspace_mem_limit_in_mb = -1;
+    Status status =
+        ReadInt64FromEnvVar("TF_GPU_WORKSPACE_MEM_LIMIT_IN_MB",
+                            1LL << 12 /*4GB max by default*/,
+                            &workspace_mem_limit_in_mb);
+    if (!status.ok()) {
+      LOG(ERROR) << "GetGPUWorkspaceAllocator: " << status.error_message();
+    }
+    int64 workspace_mem_limit = workspace_mem_limit_in_mb * (1LL << 20);
+    // Scratch requests repeat a small set of sizes once autotuning has
+    // settled, so with allow_growth the arena stops growing at the largest
+    // tuned workspace and then recycles those regions from its free bins.
+    allocator.reset(new BFCAllocator(
+        sub_allocator, workspace_mem_limit, true /*allow_growth*/,
+        strings::StrCat("GPU_", platform_gpu_id.value(), "_workspace_bfc")));
+  }
+  return allocator.get();
+#else
+  return nullptr;
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+}
+
 Allocator* GPUProcessState::GetGPUHostAllocator(int numa_node) {
   CHECK(process_state_);
   if (!HasGPUDevice() ||
@@ -243,6 +345,10 @@ Allocator* GPUProcessState::GetGPUHostAllocator(int numa_node) {
         new BFCAllocator(sub_allocator, gpu_host_mem_limit,
                          true /*allow_growth*/, "gpu_host_bfc" /*name*/);
 
+    if (useGpuHostCachingAllocator()) {
+      allocator = new GpuHostCachingAllocator(allocator);
+    }
+
     if (LogMemory::IsEnabled() && !allocator->TracksAllocationSizes()) {
       // Wrap the allocator to track allocation ids for better logging
       // at the cost of performance.
@@ -324,6 +430,7 @@ void GPUProcessState::TestOnlyReset() {
     gpu_device_enabled_ = false;
     gpu_allocators_.clear();
     gpu_visitors_.clear();
+    gpu_workspace_allocators_.clear();
     gpu_host_allocators_.clear();
     gpu_host_alloc_visitors_.clear();
     gpu_host_free_visitors_.clear();
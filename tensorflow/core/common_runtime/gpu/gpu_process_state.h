@@ -85,6 +85,21 @@ class GPUProcessState {
 
   virtual Allocator* GetGPUHostAllocator(int numa_node);
 
+  // Returns a dedicated per-device allocator for DNN scratch workspaces
+  // (cudnn/MIOpen convolution workspace buffers), or nullptr if the
+  // workspace arena is disabled, which is the default; set
+  // TF_GPU_WORKSPACE_ARENA=true to enable it.  The arena is a separate
+  // BFC region over its own device-memory SubAllocator, so per-call
+  // scratch churn neither fragments the main model-tensor arena nor
+  // contends for its lock.  It grows on demand up to
+  // TF_GPU_WORKSPACE_MEM_LIMIT_IN_MB (default 4GB) and settles at the
+  // largest tuned workspace, after which requests are served from the
+  // arena's free bins without touching the device.
+  //
+  // Keyed by platform GPU id: virtual devices created on the same
+  // physical GPU share one arena.
+  virtual Allocator* GetGPUWorkspaceAllocator(PlatformGpuId platform_gpu_id);
+
   // Registers a Visitor to be invoked on new chunks of memory allocated by the
   // SubAllocator of every GPU proximate to the specified bus.  The AllocVisitor
   // is provided with a memory pointer, a GPU id, and the size of the area it
@@ -143,6 +158,9 @@ class GPUProcessState {
   std::vector<AllocatorParts> gpu_allocators_ GUARDED_BY(mu_);
   std::vector<std::vector<SubAllocator::Visitor>> gpu_visitors_ GUARDED_BY(mu_);
 
+  std::vector<std::unique_ptr<Allocator>> gpu_workspace_allocators_
+      GUARDED_BY(mu_);
+
   std::vector<AllocatorParts> gpu_host_allocators_ GUARDED_BY(mu_);
   std::vector<std::vector<SubAllocator::Visitor>> gpu_host_alloc_visitors_
       GUARDED_BY(mu_);
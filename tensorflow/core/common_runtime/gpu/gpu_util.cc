@@ -15,6 +15,8 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/gpu/gpu_util.h"
 
+#include <atomic>
+
 #include "tensorflow/core/common_runtime/copy_tensor.h"
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
@@ -60,6 +62,25 @@ namespace tensorflow {
 using se::DeviceMemoryBase;
 using se::Stream;
 
+namespace {
+
+// Cumulative bytes dispatched per transfer class, for attributing copy
+// bandwidth between the latency (default) and bulk streams. Reported at
+// VLOG(2) as copies are issued.
+struct CopyClassStats {
+  std::atomic<int64> h2d_default_bytes{0};
+  std::atomic<int64> h2d_bulk_bytes{0};
+  std::atomic<int64> d2h_default_bytes{0};
+  std::atomic<int64> d2h_bulk_bytes{0};
+};
+
+CopyClassStats* GetCopyClassStats() {
+  static CopyClassStats* stats = new CopyClassStats();
+  return stats;
+}
+
+}  // namespace
+
 Status PrepareCopy(Device* device, const DeviceContext* ctx, const Tensor& src,
                    const Tensor* dst,
                    const DeviceBase::GpuDeviceInfo** dev_info,
@@ -266,9 +287,11 @@ void GPUUtil::CopyGPUTensorToCPU(Device* gpu_device,
     return;
   }
 
+  const int64 total_bytes = gpu_tensor->TotalBytes();
+  auto* gpu_device_context =
+      static_cast<const GPUDeviceContext*>(device_context);
   auto send_device_to_host_stream =
-      static_cast<const GPUDeviceContext*>(device_context)
-          ->device_to_host_stream();
+      gpu_device_context->device_to_host_stream(total_bytes);
   if (send_device_to_host_stream == nullptr) {
     done(errors::Internal("No send gpu copy-out-stream is available."));
     return;
@@ -276,12 +299,21 @@ void GPUUtil::CopyGPUTensorToCPU(Device* gpu_device,
   // Wait for the sender's main stream to make sure the data are available.
   send_device_to_host_stream->ThenWaitFor(send_stream);
 
-  const int64 total_bytes = gpu_tensor->TotalBytes();
   if (total_bytes > 0) {
     void* src_ptr = GetBase(gpu_tensor);
     DeviceMemoryBase gpu_src_ptr(src_ptr, total_bytes);
     void* dst_ptr = GetBase(cpu_tensor);
     send_device_to_host_stream->ThenMemcpy(dst_ptr, gpu_src_ptr, total_bytes);
+    if (VLOG_IS_ON(2)) {
+      CopyClassStats* stats = GetCopyClassStats();
+      const bool bulk = send_device_to_host_stream !=
+                        gpu_device_context->device_to_host_stream();
+      std::atomic<int64>* counter =
+          bulk ? &stats->d2h_bulk_bytes : &stats->d2h_default_bytes;
+      LOG(INFO) << "GPU copy class stats: d2h "
+                << (bulk ? "bulk" : "default") << " bytes="
+                << (counter->fetch_add(total_bytes) + total_bytes);
+    }
   }
   // Use of the input may outlive stack scope, so keep a ref.
   TensorReference input_ref(*gpu_tensor);
@@ -311,9 +343,11 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
     return;
   }
 
+  const int64 total_bytes = cpu_tensor->TotalBytes();
+  auto* gpu_device_context =
+      static_cast<const GPUDeviceContext*>(device_context);
   auto recv_host_to_device_stream =
-      static_cast<const GPUDeviceContext*>(device_context)
-          ->host_to_device_stream();
+      gpu_device_context->host_to_device_stream(total_bytes);
   if (recv_host_to_device_stream == nullptr) {
     done(errors::Internal("No send gpu copy-out-stream is available."));
     return;
@@ -321,13 +355,22 @@ void GPUUtil::CopyCPUTensorToGPU(const Tensor* cpu_tensor,
   // Wait for the recv-stream to make sure the buffer is truly available.
   recv_host_to_device_stream->ThenWaitFor(recv_stream);
 
-  const int64 total_bytes = cpu_tensor->TotalBytes();
   // Note that 0-size tensors have no backing buffer.
   if (total_bytes > 0) {
     void* src_ptr = GetBase(cpu_tensor);
     void* dst_ptr = GetBase(gpu_tensor);
     DeviceMemoryBase gpu_dst_ptr(dst_ptr, total_bytes);
     recv_host_to_device_stream->ThenMemcpy(&gpu_dst_ptr, src_ptr, total_bytes);
+    if (VLOG_IS_ON(2)) {
+      CopyClassStats* stats = GetCopyClassStats();
+      const bool bulk = recv_host_to_device_stream !=
+                        gpu_device_context->host_to_device_stream();
+      std::atomic<int64>* counter =
+          bulk ? &stats->h2d_bulk_bytes : &stats->h2d_default_bytes;
+      LOG(INFO) << "GPU copy class stats: h2d "
+                << (bulk ? "bulk" : "default") << " bytes="
+                << (counter->fetch_add(total_bytes) + total_bytes);
+    }
   }
   // Use of cpu_tensor may outlive stack scope, so keep a ref.
   TensorReference input_ref(*cpu_tensor);
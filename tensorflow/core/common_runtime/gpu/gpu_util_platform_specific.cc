@@ -20,9 +20,23 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/platform/stream_executor.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+/* static */ int64 GPUDeviceContext::BulkCopyThresholdBytes() {
+  static int64 threshold_bytes = []() -> int64 {
+    int64 mb = 0;
+    Status status =
+        ReadInt64FromEnvVar("TF_GPU_BULK_COPY_THRESHOLD_MB", 0, &mb);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return mb << 20;
+  }();
+  return threshold_bytes;
+}
+
 void GPUDeviceContext::CopyCPUTensorToDevice(const Tensor* cpu_tensor,
                                              Device* device,
                                              Tensor* device_tensor,
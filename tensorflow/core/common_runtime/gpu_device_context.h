@@ -28,27 +28,57 @@ namespace tensorflow {
 
 class GPUDeviceContext : public DeviceContext {
  public:
-  // Does not take ownership of streams.
+  // Does not take ownership of streams. The bulk copy streams may be
+  // nullptr, in which case all copies use the default copy streams.
   GPUDeviceContext(int stream_id, se::Stream* stream,
                    se::Stream* host_to_device_stream,
                    se::Stream* device_to_host_stream,
-                   gtl::InlinedVector<se::Stream*, 4> device_to_device_stream)
+                   gtl::InlinedVector<se::Stream*, 4> device_to_device_stream,
+                   se::Stream* host_to_device_bulk_stream = nullptr,
+                   se::Stream* device_to_host_bulk_stream = nullptr)
       : stream_id_(stream_id),
         stream_(stream),
         host_to_device_stream_(host_to_device_stream),
         device_to_host_stream_(device_to_host_stream),
-        device_to_device_stream_(device_to_device_stream) {}
+        device_to_device_stream_(device_to_device_stream),
+        host_to_device_bulk_stream_(host_to_device_bulk_stream),
+        device_to_host_bulk_stream_(device_to_host_bulk_stream) {}
 
   ~GPUDeviceContext() override {}
 
   se::Stream* stream() const override { return stream_; }
   se::Stream* host_to_device_stream() const { return host_to_device_stream_; }
   se::Stream* device_to_host_stream() const { return device_to_host_stream_; }
+  // Returns the stream to use for a copy of total_bytes in the given
+  // direction. Transfers at least as large as the bulk threshold are
+  // routed to a dedicated bulk stream when one exists, so large
+  // background copies (e.g. a checkpoint restore) do not head-of-line
+  // block small latency-sensitive transfers queued on the default copy
+  // stream.
+  se::Stream* host_to_device_stream(int64 total_bytes) const {
+    if (host_to_device_bulk_stream_ != nullptr &&
+        total_bytes >= BulkCopyThresholdBytes()) {
+      return host_to_device_bulk_stream_;
+    }
+    return host_to_device_stream_;
+  }
+  se::Stream* device_to_host_stream(int64 total_bytes) const {
+    if (device_to_host_bulk_stream_ != nullptr &&
+        total_bytes >= BulkCopyThresholdBytes()) {
+      return device_to_host_bulk_stream_;
+    }
+    return device_to_host_stream_;
+  }
   se::Stream* device_to_device_stream(int index) const {
     return device_to_device_stream_[index % device_to_device_stream_.size()];
   }
   int stream_id() const { return stream_id_; }
 
+  // Transfer size, in bytes, at which copies are classified as bulk.
+  // Read from TF_GPU_BULK_COPY_THRESHOLD_MB; zero (the default)
+  // disables the bulk copy streams entirely.
+  static int64 BulkCopyThresholdBytes();
+
   void CopyCPUTensorToDevice(const Tensor* cpu_tensor, Device* device,
                              Tensor* device_tensor,
                              StatusCallback done) const override;
@@ -78,6 +108,10 @@ class GPUDeviceContext : public DeviceContext {
   se::Stream* device_to_host_stream_;
   // Streams to use for copying data between GPUs.
   gtl::InlinedVector<se::Stream*, 4> device_to_device_stream_;
+  // Streams for bulk copies past the threshold, or nullptr when the
+  // bulk classes are disabled.
+  se::Stream* host_to_device_bulk_stream_;
+  se::Stream* device_to_host_bulk_stream_;
 };
 
 }  // namespace tensorflow
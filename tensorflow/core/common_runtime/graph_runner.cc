@@ -35,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/graph/node_builder.h"
 #include "tensorflow/core/graph/subgraph.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/public/session_options.h"
 
@@ -89,6 +90,74 @@ class SimpleRendezvous : public Rendezvous {
   Table table_ GUARDED_BY(mu_);
 };
 
+// Upper bounds on what gets memoized: total bytes of cached result
+// tensors per evaluation, and number of cached evaluations held by one
+// GraphRunner.  Shape/const evaluation results are almost always tiny.
+constexpr int64 kMaxMemoizedOutputBytes = 1 << 20;
+constexpr int64 kMaxMemoizedEvaluations = 1024;
+
+uint64 HashTensorContent(const Tensor& tensor, uint64 h) {
+  h = Hash64Combine(h, tensor.dtype());
+  for (int d = 0; d < tensor.dims(); ++d) {
+    h = Hash64Combine(h, tensor.dim_size(d));
+  }
+  if (tensor.dtype() == DT_STRING) {
+    auto flat = tensor.flat<string>();
+    for (int64 i = 0; i < flat.size(); ++i) {
+      h = Hash64Combine(h, Hash64(flat(i)));
+    }
+  } else {
+    const StringPiece data = tensor.tensor_data();
+    h = Hash64Combine(h, Hash64(data.data(), data.size()));
+  }
+  return h;
+}
+
+// Computes a fingerprint of the evaluation described by (graph, inputs,
+// output_names) and returns true if memoizing its results is safe.
+// Evaluations containing stateful ops, or fed tensors whose content
+// cannot be hashed by value, are not memoizable.
+bool TryComputeEvaluationFingerprint(
+    const Graph* graph, const GraphRunner::NamedTensorList& inputs,
+    const std::vector<string>& output_names, uint64* fingerprint) {
+  uint64 h = 0x2b992ddfa23249d6;  // Arbitrary initial seed.
+  for (const Node* n : graph->nodes()) {
+    if (n->op_def().is_stateful()) return false;
+    h = Hash64Combine(h, Hash64(n->name()));
+    h = Hash64Combine(h, Hash64(n->def().SerializeAsString()));
+  }
+  // Node names are unique within the graph, so hashing the endpoints of
+  // every edge by name captures the graph structure even where the
+  // serialized NodeDefs have not been kept in sync with added edges.
+  for (const Edge* e : graph->edges()) {
+    h = Hash64Combine(h, Hash64(e->src()->name()));
+    h = Hash64Combine(h, e->src_output());
+    h = Hash64Combine(h, Hash64(e->dst()->name()));
+    h = Hash64Combine(h, e->dst_input());
+  }
+  for (const auto& in : inputs) {
+    if (!DataTypeCanUseMemcpy(in.second.dtype()) &&
+        in.second.dtype() != DT_STRING) {
+      return false;
+    }
+    h = Hash64Combine(h, Hash64(in.first));
+    h = HashTensorContent(in.second, h);
+  }
+  for (const string& output_name : output_names) {
+    h = Hash64Combine(h, Hash64(output_name));
+  }
+  *fingerprint = h;
+  return true;
+}
+
+int64 TotalTensorBytes(const std::vector<Tensor>& tensors) {
+  int64 total = 0;
+  for (const Tensor& tensor : tensors) {
+    total += tensor.TotalBytes();
+  }
+  return total;
+}
+
 }  // namespace
 
 GraphRunner::GraphRunner(Env* env)
@@ -118,6 +187,23 @@ Status GraphRunner::Run(Graph* graph, FunctionLibraryRuntime* function_library,
     function_library = nullptr;
   }
 
+  // When the same evaluation has been run before, return the memoized
+  // results.  Evaluations against a function library are not memoized
+  // since the fingerprint does not cover function definitions.
+  uint64 fingerprint = 0;
+  const bool memoizable =
+      (function_library == nullptr) &&
+      TryComputeEvaluationFingerprint(graph, inputs, output_names,
+                                      &fingerprint);
+  if (memoizable) {
+    mutex_lock l(mu_);
+    auto it = memoized_outputs_.find(fingerprint);
+    if (it != memoized_outputs_.end()) {
+      *outputs = it->second;
+      return Status::OK();
+    }
+  }
+
   // TODO(vrv): Instead of copying the entire graph, consider modifying
   // the existing graph, and then removing those removed edges.
   // prior to returning.
@@ -200,6 +286,13 @@ Status GraphRunner::Run(Graph* graph, FunctionLibraryRuntime* function_library,
     (*outputs)[i] = tensor::DeepCopy(output_tensor);
   }
 
+  if (memoizable && TotalTensorBytes(*outputs) <= kMaxMemoizedOutputBytes) {
+    mutex_lock l(mu_);
+    if (memoized_outputs_.size() < kMaxMemoizedEvaluations) {
+      memoized_outputs_[fingerprint] = *outputs;
+    }
+  }
+
   return Status::OK();
 }
 
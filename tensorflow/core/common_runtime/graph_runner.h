@@ -25,7 +25,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 
@@ -63,6 +65,17 @@ class GraphRunner {
  private:
   std::unique_ptr<Device> device_deleter_;
   Device* const device_;
+
+  // Memoized results of previous evaluations, keyed by a fingerprint of
+  // the graph, the feeds and the fetches.  Shape inference and constant
+  // folding evaluate the same small subgraphs over and over while a
+  // large model is being loaded, and a hit here skips the graph copy,
+  // executor construction and execution entirely.  Evaluations
+  // involving stateful ops or non-hashable input types are never
+  // memoized.  The cached tensors are deep copies with the same
+  // lifetime as the ones returned to callers.
+  mutex mu_;
+  gtl::FlatMap<uint64, std::vector<Tensor>> memoized_outputs_ GUARDED_BY(mu_);
 };
 
 }  // namespace tensorflow
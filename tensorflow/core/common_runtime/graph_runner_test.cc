@@ -114,5 +114,38 @@ TEST(GraphRunnerTest, FeedAndFetch) {
   ExpectEqual(3.0f, outputs[0].scalar<float>()());
 }
 
+TEST(GraphRunnerTest, MemoizedRepeatedRuns) {
+  Scope root = Scope::NewRootScope();
+  auto p1 = ops::Placeholder(root.WithOpName("p1"), DT_FLOAT);
+  auto p2 = ops::Placeholder(root.WithOpName("p2"), DT_FLOAT);
+  auto add = ops::Add(root.WithOpName("add"), p1, p2);
+
+  Tensor p1_data(DT_FLOAT, TensorShape({}));
+  Tensor p2_data(DT_FLOAT, TensorShape({}));
+  p1_data.scalar<float>()() = 1.0f;
+  p2_data.scalar<float>()() = 2.0f;
+  std::vector<std::pair<string, Tensor>> inputs = {{"p1:0", p1_data},
+                                                   {"p2:0", p2_data}};
+
+  GraphRunner graph_runner(Env::Default());
+  // Repeated identical evaluations (the second of which is served from
+  // the memo) return the same results.
+  for (int i = 0; i < 2; ++i) {
+    std::vector<Tensor> outputs;
+    Status s =
+        graph_runner.Run(root.graph(), nullptr, inputs, {"add:0"}, &outputs);
+    TF_ASSERT_OK(s);
+    ExpectEqual(3.0f, outputs[0].scalar<float>()());
+  }
+  // Changing a feed value changes the fingerprint and the result.
+  p2_data.scalar<float>()() = 41.0f;
+  inputs[1].second = p2_data;
+  std::vector<Tensor> outputs;
+  Status s =
+      graph_runner.Run(root.graph(), nullptr, inputs, {"add:0"}, &outputs);
+  TF_ASSERT_OK(s);
+  ExpectEqual(42.0f, outputs[0].scalar<float>()());
+}
+
 }  // namespace
 }  // namespace tensorflow
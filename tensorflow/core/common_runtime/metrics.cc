@@ -59,6 +59,43 @@ auto* build_graph_time_usecs = monitoring::Counter<0>::New(
     "spent optimizing the graph with Grappler, and time spent pruning the "
     "sub-graph.");
 
+auto* allocator_retries = monitoring::Counter<0>::New(
+    "/tensorflow/core/allocator_retries",
+    "The number of times a raw allocation failed and was retried after "
+    "waiting for memory to be freed.");
+
+auto* allocator_retry_wait_usecs = monitoring::Counter<0>::New(
+    "/tensorflow/core/allocator_retry_wait_usecs",
+    "The total time allocating threads have spent waiting for memory to be "
+    "freed before retrying, in microseconds.");
+
+auto* bfc_allocator_extends = monitoring::Counter<0>::New(
+    "/tensorflow/core/bfc_allocator_extends",
+    "The number of times a BFC allocator grew its arena.");
+
+auto* bfc_allocator_extend_bytes = monitoring::Counter<0>::New(
+    "/tensorflow/core/bfc_allocator_extend_bytes",
+    "The total number of bytes by which BFC allocators grew their arenas.");
+
+auto* executor_nodes_scheduled = monitoring::Counter<0>::New(
+    "/tensorflow/core/executor_nodes_scheduled",
+    "The number of ready nodes executors submitted to the inter-op thread "
+    "pool.");
+
+auto* executor_nodes_inline = monitoring::Counter<0>::New(
+    "/tensorflow/core/executor_nodes_inline",
+    "The number of ready nodes executors processed on the calling thread "
+    "instead of handing them to the inter-op thread pool.");
+
+auto* inter_op_closures = monitoring::Counter<0>::New(
+    "/tensorflow/core/inter_op_closures",
+    "The number of closures submitted to the process-wide inter-op thread "
+    "pool.");
+
+auto* worker_recv_tensor_requests = monitoring::Counter<0>::New(
+    "/tensorflow/core/worker_recv_tensor_requests",
+    "The number of RecvTensor requests served by the gRPC worker.");
+
 }  // namespace
 
 void RecordTFDataAutotune(const string& name) {
@@ -91,5 +128,30 @@ void UpdateGraphBuildTime(const uint64 running_time_usecs) {
   }
 }
 
+void RecordAllocatorRetry(uint64 wait_usecs) {
+  allocator_retries->GetCell()->IncrementBy(1);
+  allocator_retry_wait_usecs->GetCell()->IncrementBy(wait_usecs);
+}
+
+void RecordBFCAllocatorExtend(int64 bytes) {
+  bfc_allocator_extends->GetCell()->IncrementBy(1);
+  bfc_allocator_extend_bytes->GetCell()->IncrementBy(bytes);
+}
+
+void RecordExecutorReadyNodes(int64 num_scheduled, int64 num_inline) {
+  if (num_scheduled > 0) {
+    executor_nodes_scheduled->GetCell()->IncrementBy(num_scheduled);
+  }
+  if (num_inline > 0) {
+    executor_nodes_inline->GetCell()->IncrementBy(num_inline);
+  }
+}
+
+void RecordInterOpClosure() { inter_op_closures->GetCell()->IncrementBy(1); }
+
+void RecordWorkerRecvTensor() {
+  worker_recv_tensor_requests->GetCell()->IncrementBy(1);
+}
+
 }  // namespace metrics
 }  // namespace tensorflow
@@ -60,6 +60,24 @@ void UpdateGraphExecTime(const uint64 running_time_usecs);
 // TODO(jtkeeling): Should we record building/optimizing tf.functions?
 void UpdateGraphBuildTime(const uint64 running_time_usecs);
 
+// Records that a raw allocation failed, the allocator waited `wait_usecs`
+// for memory to be freed, and the allocation was retried.
+void RecordAllocatorRetry(uint64 wait_usecs);
+
+// Records that a BFC allocator grew its arena by `bytes`.
+void RecordBFCAllocatorExtend(int64 bytes);
+
+// Records ready nodes handed off by an executor: `num_scheduled` were
+// submitted to the inter-op pool, `num_inline` were kept on the calling
+// thread. The ratio is a cheap proxy for inter-op pool saturation.
+void RecordExecutorReadyNodes(int64 num_scheduled, int64 num_inline);
+
+// Records a closure submitted to the process-wide inter-op thread pool.
+void RecordInterOpClosure();
+
+// Records a RecvTensor request served by the gRPC worker.
+void RecordWorkerRecvTensor();
+
 }  // namespace metrics
 }  // namespace tensorflow
 
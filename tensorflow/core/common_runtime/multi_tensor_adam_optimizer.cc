@@ -0,0 +1,233 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/common_runtime/optimization_registry.h"
+#include "tensorflow/core/graph/algorithm.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Number of data inputs of a ResourceApplyAdam node.
+constexpr int kNumAdamInputs = 10;
+// Offset of the first scalar hyperparameter input (beta1_power).
+constexpr int kFirstScalarInput = 3;
+// Number of scalar hyperparameter inputs (beta1_power..epsilon).
+constexpr int kNumScalarInputs = 6;
+
+// Groups ResourceApplyAdam nodes that share a device, dtype, attrs and
+// hyperparameter tensors into a single ResourceApplyAdamN node. Graphs that
+// apply Adam to thousands of small variables otherwise spend the optimizer
+// phase on per-op dispatch rather than arithmetic.
+//
+// The rewrite is opt-in via TF_FUSE_ADAM_UPDATES=true while it soaks;
+// per-variable gradient clipping or other transforms spliced between the
+// gradient and the apply op keep their semantics because grouping keys on
+// the exact hyperparameter input tensors and leaves gradients untouched.
+class MultiTensorAdamFusionPass : public GraphOptimizationPass {
+ public:
+  Status Run(const GraphOptimizationPassOptions& options) override {
+    if (options.graph == nullptr) {
+      // TODO(apassos) returning OK feels weird here as we can't do anything
+      // without a graph, but some tests require this.
+      return Status::OK();
+    }
+    bool enabled = false;
+    TF_RETURN_IF_ERROR(
+        ReadBoolFromEnvVar("TF_FUSE_ADAM_UPDATES", false, &enabled));
+    if (!enabled) {
+      return Status::OK();
+    }
+
+    Graph* g = options.graph->get();
+    if (g == nullptr) {
+      return errors::Internal(
+          "Adam update fusion should happen before partitioning and a "
+          "graph should be available.");
+    }
+
+    // Bucket the candidates first, *then* modify the graph.
+    std::unordered_map<string, std::vector<Node*>> groups;
+    for (Node* n : g->op_nodes()) {
+      if (n->type_string() != "ResourceApplyAdam") continue;
+      string key;
+      if (!GroupKey(n, &key)) continue;
+      groups[key].push_back(n);
+    }
+
+    for (const auto& it : groups) {
+      const std::vector<Node*>& members = it.second;
+      if (members.size() < 2) continue;
+      // A member that (transitively) depends on another member cannot be
+      // folded into the same node without creating a cycle; updates produced
+      // by tf.train.Optimizer are mutually independent, so simply leave such
+      // groups alone rather than partitioning them.
+      if (HasIntraGroupDependency(g, members)) continue;
+      TF_RETURN_IF_ERROR(RewriteGroup(g, members));
+    }
+    return Status::OK();
+  }
+
+ private:
+  // Computes the grouping key for a candidate node, or returns false if the
+  // node should not participate in fusion. Nodes fed by control-flow ops are
+  // skipped so that updates inside loops are never fused across frames.
+  static bool GroupKey(Node* n, string* key) {
+    std::vector<const Edge*> inputs(kNumAdamInputs, nullptr);
+    for (const Edge* e : n->in_edges()) {
+      if (e->IsControlEdge()) continue;
+      Node* src = e->src();
+      if (src->IsEnter() || src->IsExit() || src->IsSwitch() ||
+          src->IsMerge() || src->IsNextIteration()) {
+        return false;
+      }
+      if (e->dst_input() < 0 || e->dst_input() >= kNumAdamInputs) return false;
+      inputs[e->dst_input()] = e;
+    }
+    for (const Edge* e : inputs) {
+      if (e == nullptr) return false;
+    }
+
+    DataType dtype;
+    if (!GetNodeAttr(n->attrs(), "T", &dtype).ok()) return false;
+    bool use_locking, use_nesterov;
+    if (!GetNodeAttr(n->attrs(), "use_locking", &use_locking).ok()) {
+      return false;
+    }
+    if (!GetNodeAttr(n->attrs(), "use_nesterov", &use_nesterov).ok()) {
+      return false;
+    }
+    string colo;
+    GetNodeAttr(n->attrs(), kColocationAttrName, &colo).IgnoreError();
+
+    *key = strings::StrCat(n->requested_device(), "|", colo, "|",
+                           DataTypeString(dtype), "|", use_locking, "|",
+                           use_nesterov);
+    for (int i = kFirstScalarInput; i < kFirstScalarInput + kNumScalarInputs;
+         ++i) {
+      strings::StrAppend(key, "|", inputs[i]->src()->name(), ":",
+                         inputs[i]->src_output());
+    }
+    return true;
+  }
+
+  // Returns true if any member of the group transitively depends on another
+  // member (through data or control edges). Single forward sweep in
+  // topological order, so the cost is O(nodes + edges) per group.
+  static bool HasIntraGroupDependency(Graph* g,
+                                      const std::vector<Node*>& members) {
+    std::unordered_set<const Node*> member_set(members.begin(), members.end());
+    std::vector<Node*> order;
+    GetReversePostOrder(*g, &order);
+    std::vector<bool> reaches(g->num_node_ids(), false);
+    for (Node* node : order) {
+      bool reached = false;
+      for (const Edge* e : node->in_edges()) {
+        if (reaches[e->src()->id()]) {
+          reached = true;
+          break;
+        }
+      }
+      if (reached && member_set.count(node) > 0) return true;
+      reaches[node->id()] = reached || member_set.count(node) > 0;
+    }
+    return false;
+  }
+
+  // Replaces the group with one ResourceApplyAdamN node carrying the
+  // concatenated var/m/v/grad lists and the shared hyperparameters. Incoming
+  // and outgoing control edges of every member are rehomed to the fused node
+  // (ResourceApplyAdam has no data outputs).
+  static Status RewriteGroup(Graph* g, const std::vector<Node*>& members) {
+    Node* first = members[0];
+    AttrSlice first_attrs = first->attrs();
+    DataType dtype;
+    TF_RETURN_IF_ERROR(GetNodeAttr(first_attrs, "T", &dtype));
+    bool use_locking, use_nesterov;
+    TF_RETURN_IF_ERROR(GetNodeAttr(first_attrs, "use_locking", &use_locking));
+    TF_RETURN_IF_ERROR(
+        GetNodeAttr(first_attrs, "use_nesterov", &use_nesterov));
+
+    std::vector<NodeBuilder::NodeOut> vars, ms, vs, grads;
+    std::vector<NodeBuilder::NodeOut> scalars(kNumScalarInputs);
+    for (Node* n : members) {
+      for (int i = 0; i < kNumAdamInputs; ++i) {
+        const Edge* e;
+        TF_RETURN_IF_ERROR(n->input_edge(i, &e));
+        NodeBuilder::NodeOut src(e->src(), e->src_output());
+        switch (i) {
+          case 0:
+            vars.push_back(src);
+            break;
+          case 1:
+            ms.push_back(src);
+            break;
+          case 2:
+            vs.push_back(src);
+            break;
+          case kNumAdamInputs - 1:
+            grads.push_back(src);
+            break;
+          default:
+            // The hyperparameters are identical across the group by
+            // construction of the group key; record them once.
+            if (n == first) scalars[i - kFirstScalarInput] = src;
+        }
+      }
+    }
+
+    NodeDebugInfo debug_info(*first);
+    NodeBuilder builder(g->NewName(strings::StrCat(first->name(), "/fused")),
+                        "ResourceApplyAdamN", OpRegistry::Global(),
+                        &debug_info);
+    builder.Device(first->requested_device());
+    string colo;
+    if (GetNodeAttr(first_attrs, kColocationAttrName, &colo).ok()) {
+      builder.Attr(kColocationAttrName, colo);
+    }
+    builder.Input(vars).Input(ms).Input(vs);
+    for (int i = 0; i < kNumScalarInputs; ++i) {
+      builder.Input(scalars[i]);
+    }
+    builder.Input(grads)
+        .Attr("T", dtype)
+        .Attr("use_locking", use_locking)
+        .Attr("use_nesterov", use_nesterov);
+    Node* fused = nullptr;
+    TF_RETURN_IF_ERROR(builder.Finalize(g, &fused));
+
+    for (Node* n : members) {
+      for (const Edge* e : n->in_edges()) {
+        if (e->IsControlEdge()) {
+          g->AddControlEdge(e->src(), fused);
+        }
+      }
+      for (const Edge* e : n->out_edges()) {
+        if (e->IsControlEdge()) {
+          g->AddControlEdge(fused, e->dst());
+        }
+      }
+      g->RemoveNode(n);
+    }
+    return Status::OK();
+  }
+};
+REGISTER_OPTIMIZATION(OptimizationPassRegistry::PRE_PLACEMENT, 10,
+                      MultiTensorAdamFusionPass);
+
+}  // namespace
+}  // namespace tensorflow
@@ -91,6 +91,14 @@ class PendingCounts {
 
   ~PendingCounts() { delete[] bytes_; }
 
+  // Restores the counts from "other" without reallocating the byte
+  // array.  "other" must have the same layout as the one this object
+  // was created with.
+  void ResetFrom(const PendingCounts& other) {
+    DCHECK_EQ(num_bytes_, other.num_bytes_);
+    memcpy(bytes_, other.bytes_, other.num_bytes_);
+  }
+
   void set_initial_count(Handle h, size_t pending_count) {
     if (h.is_large_) {
       LargeCounts* c = Large(h);
@@ -22,10 +22,23 @@ limitations under the License.
 #endif  // INTEL_MKL
 #include <string.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#endif  // defined(__linux__)
+
+#include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/byte_order.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/platform/types.h"
 #include "tensorflow/core/util/util.h"
@@ -55,8 +68,100 @@ static thread::ThreadPool* InitComputePool(const SessionOptions& options) {
                                 inter_op_parallelism_threads);
 }
 
+#if defined(__linux__)
+// Parses a cpuset string of comma-separated entries like "0,2,4-7" into
+// `cpus`. Returns false if the string is malformed.
+bool ParseCpuset(const string& cpuset, cpu_set_t* cpus) {
+  CPU_ZERO(cpus);
+  for (const string& part : str_util::Split(cpuset, ',')) {
+    int32 first, last;
+    const size_t dash = part.find('-');
+    if (dash == string::npos) {
+      if (!strings::safe_strto32(part, &first)) return false;
+      last = first;
+    } else {
+      if (!strings::safe_strto32(part.substr(0, dash), &first) ||
+          !strings::safe_strto32(part.substr(dash + 1), &last)) {
+        return false;
+      }
+    }
+    if (first < 0 || last < first || last >= CPU_SETSIZE) return false;
+    for (int32 cpu = first; cpu <= last; ++cpu) {
+      CPU_SET(cpu, cpus);
+    }
+  }
+  return true;
+}
+#endif  // defined(__linux__)
+
+// Runs `fn` once on every thread of `pool`. Each task blocks until all
+// `num_threads` tasks have started, which forces every task onto a distinct
+// thread; returns once all of them have finished.
+void RunOnEveryThread(thread::ThreadPool* pool,
+                      const std::function<void()>& fn) {
+  const int num_threads = pool->NumThreads();
+  mutex mu;
+  condition_variable cv;
+  int started = 0;
+  int done = 0;
+  for (int i = 0; i < num_threads; ++i) {
+    pool->Schedule([&mu, &cv, &started, &done, &fn, num_threads]() {
+      {
+        mutex_lock l(mu);
+        ++started;
+        cv.notify_all();
+        while (started < num_threads) {
+          cv.wait(l);
+        }
+      }
+      fn();
+      mutex_lock l(mu);
+      ++done;
+      cv.notify_all();
+    });
+  }
+  mutex_lock l(mu);
+  while (done < num_threads) {
+    cv.wait(l);
+  }
+}
+
 }  // namespace
 
+void ApplyThreadPoolSchedulingOptions(
+    const ThreadPoolOptionProto& thread_pool_options,
+    thread::ThreadPool* pool) {
+  const int32 nice_value = thread_pool_options.nice_value();
+  const string& cpuset = thread_pool_options.cpuset();
+  if (nice_value == 0 && cpuset.empty()) return;
+#if defined(__linux__)
+  cpu_set_t cpus;
+  bool have_cpuset = false;
+  if (!cpuset.empty()) {
+    if (ParseCpuset(cpuset, &cpus)) {
+      have_cpuset = true;
+    } else {
+      LOG(WARNING) << "Ignoring malformed cpuset \"" << cpuset
+                   << "\" in thread pool options.";
+    }
+  }
+  RunOnEveryThread(pool, [nice_value, have_cpuset, &cpus]() {
+    const pid_t tid = syscall(SYS_gettid);
+    if (nice_value != 0 && setpriority(PRIO_PROCESS, tid, nice_value) != 0) {
+      LOG(WARNING) << "Could not set nice value " << nice_value
+                   << " for thread pool thread: " << strerror(errno);
+    }
+    if (have_cpuset && sched_setaffinity(tid, sizeof(cpus), &cpus) != 0) {
+      LOG(WARNING) << "Could not set CPU affinity for thread pool thread: "
+                   << strerror(errno);
+    }
+  });
+#else
+  LOG(WARNING) << "Thread pool nice_value/cpuset options are only supported "
+                  "on Linux; ignoring.";
+#endif  // defined(__linux__)
+}
+
 thread::ThreadPool* ComputePool(const SessionOptions& options) {
   static thread::ThreadPool* compute_pool = InitComputePool(options);
   return compute_pool;
@@ -107,6 +212,7 @@ thread::ThreadPool* NewThreadPoolFromSessionOptions(
 }
 
 void SchedClosure(std::function<void()> closure) {
+  metrics::RecordInterOpClosure();
   if (!tracing::EventCollector::IsEnabled()) {
     return Env::Default()->SchedClosure(std::move(closure));
   }
@@ -48,6 +48,13 @@ int32 NumInterOpThreadsFromSessionOptions(const SessionOptions& options);
 thread::ThreadPool* NewThreadPoolFromSessionOptions(
     const SessionOptions& options);
 
+// Applies the scheduling options in `thread_pool_options` -- thread priority
+// (nice value) and CPU affinity (cpuset) -- to every thread of `pool`. Must
+// be called right after the pool is created, before any work is scheduled on
+// it. Options the platform cannot honor are ignored with a warning.
+void ApplyThreadPoolSchedulingOptions(
+    const ThreadPoolOptionProto& thread_pool_options, thread::ThreadPool* pool);
+
 // Schedule "closure" in the default thread queue.
 void SchedClosure(std::function<void()> closure);
 
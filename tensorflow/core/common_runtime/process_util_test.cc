@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/common_runtime/process_util.h"
 
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/test.h"
 
 namespace tensorflow {
@@ -34,5 +35,36 @@ TEST(ProcessUtilTest, ThreadPool) {
   delete pool;
 }
 
+TEST(ProcessUtilTest, SchedulingOptions) {
+  thread::ThreadPool pool(Env::Default(), "SchedulingOptions", 4);
+
+  // Lowering priority needs no privileges, and the current CPU is always a
+  // valid pinning target; both must apply without disturbing the pool.
+  ThreadPoolOptionProto options;
+  options.set_nice_value(5);
+  options.set_cpuset("0");
+  ApplyThreadPoolSchedulingOptions(options, &pool);
+
+  // Malformed cpusets are ignored with a warning rather than failing.
+  ThreadPoolOptionProto bad_options;
+  bad_options.set_cpuset("zero,1--3");
+  ApplyThreadPoolSchedulingOptions(bad_options, &pool);
+
+  mutex mu;
+  int done = 0;
+  condition_variable cv;
+  for (int i = 0; i < 8; ++i) {
+    pool.Schedule([&mu, &done, &cv]() {
+      mutex_lock l(mu);
+      ++done;
+      cv.notify_all();
+    });
+  }
+  mutex_lock l(mu);
+  while (done < 8) {
+    cv.wait(l);
+  }
+}
+
 }  // anonymous namespace
 }  // namespace tensorflow
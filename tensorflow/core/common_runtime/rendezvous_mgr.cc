@@ -28,9 +28,80 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Returns true iff TF_RENDEZVOUS_BATCH_RECV_CALLBACKS is set.
+bool BatchRecvCallbacks() {
+  static bool enabled = [] {
+    bool value = false;
+    Status status = ReadBoolFromEnvVar("TF_RENDEZVOUS_BATCH_RECV_CALLBACKS",
+                                       false, &value);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return value;
+  }();
+  return enabled;
+}
+
+RecvCallbackBatcher* GlobalRecvCallbackBatcher() {
+  static RecvCallbackBatcher* batcher = new RecvCallbackBatcher;
+  return batcher;
+}
+
+}  // namespace
+
+// static
+Rendezvous::DoneCallback RecvCallbackBatcher::MaybeBatch(
+    Rendezvous::DoneCallback done) {
+  if (!BatchRecvCallbacks()) return done;
+  return [done](const Status& s, const Rendezvous::Args& send_args,
+                const Rendezvous::Args& recv_args, const Tensor& t,
+                bool is_dead) {
+    // The caller (e.g. LocalRendezvous) unrefs the device contexts as
+    // soon as this wrapper returns; hold them until actual delivery.
+    if (send_args.device_context) send_args.device_context->Ref();
+    if (recv_args.device_context) recv_args.device_context->Ref();
+    GlobalRecvCallbackBatcher()->Run(
+        [done, s, send_args, recv_args, t, is_dead]() {
+          done(s, send_args, recv_args, t, is_dead);
+          if (send_args.device_context) send_args.device_context->Unref();
+          if (recv_args.device_context) recv_args.device_context->Unref();
+        });
+  };
+}
+
+void RecvCallbackBatcher::Run(std::function<void()> cb) {
+  {
+    mutex_lock l(mu_);
+    if (draining_) {
+      pending_.push_back(std::move(cb));
+      return;
+    }
+    draining_ = true;
+  }
+  cb();
+  // Deliver whatever completed while we were delivering, until quiet.
+  for (;;) {
+    std::vector<std::function<void()>> batch;
+    {
+      mutex_lock l(mu_);
+      if (pending_.empty()) {
+        draining_ = false;
+        return;
+      }
+      batch.swap(pending_);
+    }
+    for (std::function<void()>& pending_cb : batch) {
+      pending_cb();
+    }
+  }
+}
+
 IntraProcessRendezvous::IntraProcessRendezvous(const DeviceMgr* device_mgr)
     : device_mgr_(device_mgr), local_(NewLocalRendezvous()) {}
 
@@ -46,7 +117,11 @@ Status IntraProcessRendezvous::Send(const ParsedKey& parsed,
   }
 
   // Buffers "val" and "device_context" in local_.
-  return local_->Send(parsed, args, val, is_dead);
+  Status s = local_->Send(parsed, args, val, is_dead);
+  if (s.ok()) {
+    num_outstanding_sends_.fetch_add(1, std::memory_order_relaxed);
+  }
+  return s;
 }
 
 Status IntraProcessRendezvous::ParseKey(const string& key, bool is_src,
@@ -118,6 +193,8 @@ void IntraProcessRendezvous::RecvAsync(const ParsedKey& parsed,
                                        DoneCallback done) {
   VLOG(1) << "IntraProcessRendezvous Recv " << this << " " << parsed.FullKey();
 
+  done = RecvCallbackBatcher::MaybeBatch(std::move(done));
+
   // Recv the tensor from local_.
   local_->RecvAsync(
       parsed, recv_args,
@@ -128,6 +205,10 @@ void IntraProcessRendezvous::RecvAsync(const ParsedKey& parsed,
                          const Rendezvous::Args& send_args,
                          const Rendezvous::Args& recv_args, const Tensor& in,
                          bool is_dead) {
+            if (status.ok()) {
+              // The recv was matched with a send (dead tensors included).
+              num_outstanding_sends_.fetch_sub(1, std::memory_order_relaxed);
+            }
             // If "in" is an uninitialized tensor, do copy-construction to
             // preserve the uninitialized state, along with data type and shape
             // info, which is useful for debugger purposes.
@@ -155,7 +236,17 @@ void IntraProcessRendezvous::RecvAsync(const ParsedKey& parsed,
 
 void IntraProcessRendezvous::StartAbort(const Status& s) {
   CHECK(!s.ok());
+  aborted_.store(true, std::memory_order_release);
   local_->StartAbort(s);
 }
 
+bool IntraProcessRendezvous::ReadyForReuse() const {
+  {
+    mutex_lock l(mu_);
+    if (!status_.ok()) return false;
+  }
+  return !aborted_.load(std::memory_order_acquire) &&
+         num_outstanding_sends_.load(std::memory_order_acquire) == 0;
+}
+
 }  // end namespace tensorflow
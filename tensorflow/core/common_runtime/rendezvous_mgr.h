@@ -16,8 +16,11 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_COMMON_RUNTIME_RENDEZVOUS_MGR_H_
 #define TENSORFLOW_CORE_COMMON_RUNTIME_RENDEZVOUS_MGR_H_
 
+#include <atomic>
+#include <functional>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/framework/rendezvous.h"
@@ -29,6 +32,36 @@ limitations under the License.
 
 namespace tensorflow {
 
+// Coalesces bursts of Recv completion callbacks onto one delivering
+// thread.  When many Sends complete pending Recvs together (the end of a
+// collective, a remote fetch fanning out at a step barrier), each
+// completion otherwise wakes the executor separately and schedules its
+// own closure on the inter-op pool.  With batching, the first completing
+// thread delivers its callback and then drains the completions that
+// arrive while it is delivering; the other completer threads enqueue and
+// return immediately, so the executor sees one activation per burst
+// instead of one per tensor.
+//
+// Shared process-wide; deferred callbacks may outlive the rendezvous
+// that produced them, so nothing here may reference one.
+class RecvCallbackBatcher {
+ public:
+  // Returns 'done' unchanged when batching is disabled
+  // (TF_RENDEZVOUS_BATCH_RECV_CALLBACKS, default off); otherwise wraps
+  // it so its delivery goes through the process-wide batcher.  Device
+  // contexts in the callback arguments are held alive until delivery.
+  static Rendezvous::DoneCallback MaybeBatch(Rendezvous::DoneCallback done);
+
+ private:
+  // Runs 'cb' inline if no delivery is in flight; otherwise hands it to
+  // the thread currently delivering completions.
+  void Run(std::function<void()> cb);
+
+  mutex mu_;
+  bool draining_ GUARDED_BY(mu_) = false;
+  std::vector<std::function<void()>> pending_ GUARDED_BY(mu_);
+};
+
 // IntraProcessRendezvous is a Rendezvous which expects all producers
 // and consumers to be devices immediately accessible within the
 // process.  That is, it will never be necessary to perform an RPC to
@@ -55,10 +88,21 @@ class IntraProcessRendezvous : public Rendezvous {
 
   void StartAbort(const Status& status) override;
 
+  // Returns true if this rendezvous can be reused for another step: it has
+  // never been aborted and every tensor sent through it has been received.
+  // Intended for callers that pool rendezvous objects across steps; only
+  // meaningful once the step using this rendezvous has fully completed.
+  bool ReadyForReuse() const;
+
  private:
   const DeviceMgr* device_mgr_;
   Rendezvous* local_;  // Owns a Ref on this object.
 
+  // Number of successful Sends not yet matched by a completed Recv, and
+  // whether StartAbort has ever been called; together they decide reuse.
+  std::atomic<int64> num_outstanding_sends_{0};
+  std::atomic<bool> aborted_{false};
+
   mutable mutex mu_;
 
   // Status given by StartAbort() if any.
@@ -17,6 +17,7 @@ limitations under the License.
 #include <stdlib.h>
 #include <atomic>
 #include <functional>
+#include <set>
 #include <utility>
 
 #include "tensorflow/core/common_runtime/collective_rma_local.h"
@@ -38,6 +39,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 // Set true for greater intelligibility of debug mode log messages.
 #define READABLE_KEYS false
@@ -71,6 +73,32 @@ string RingAlgBufKey(const string& name, const string& exec_key, int pass,
   }
 }
 
+// Wall-clock budget for a single ring collective, after which it is
+// aborted with an error identifying the rank(s) it is still waiting on.
+// 0 (the default) disables the watchdog.
+int64 CollectiveTimeoutMs() {
+  static int64 timeout_ms = [] {
+    int64 ms;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_COLLECTIVE_TIMEOUT_MS",
+                                    /*default_val=*/0, &ms));
+    return ms;
+  }();
+  return timeout_ms;
+}
+
+// Whether per-chunk completion events should be reported to the
+// CollectiveProgressRegistry.  Implied by a configured timeout, so a
+// timed-out collective always has progress state to dump.
+bool CollectiveProgressEventsEnabled() {
+  static bool enabled = [] {
+    bool b;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_COLLECTIVE_PROGRESS_EVENTS",
+                                   /*default_val=*/false, &b));
+    return b;
+  }();
+  return enabled || CollectiveTimeoutMs() > 0;
+}
+
 }  // namespace
 
 void RingAlg::PCQueue::Enqueue(RingField* rf) {
@@ -104,6 +132,13 @@ RingAlg::RingAlg(CollectiveType type, const string& name)
       group_size_(-1),
       num_subdivs_(-1) {}
 
+RingAlg::~RingAlg() {
+  if (timeout_state_) {
+    mutex_lock l(timeout_state_->mu);
+    timeout_state_->done = true;
+  }
+}
+
 namespace {
 Status GenerateSubdivsInCollectiveParams(CollectiveParams* col_params) {
   if (col_params->instance.shape.num_elements() == 0) {
@@ -244,9 +279,71 @@ Status RingAlg::InitializeCollectiveContext(CollectiveContext* col_ctx) {
   DCHECK(col_ctx->dev_mgr);
   col_ctx_ = col_ctx;
   col_params_ = &col_ctx->col_params;
-  return collective_util::InitializeDeviceAndLocality(
+  Status s = collective_util::InitializeDeviceAndLocality(
       col_ctx->dev_mgr, col_ctx->device_name, &col_ctx->device,
       &col_ctx->device_locality);
+  if (s.ok()) {
+    progress_enabled_ = CollectiveProgressEventsEnabled();
+    MaybeScheduleTimeout();
+  }
+  return s;
+}
+
+void RingAlg::MaybeScheduleTimeout() {
+  const int64 timeout_ms = CollectiveTimeoutMs();
+  if (timeout_ms <= 0) return;
+  timeout_state_.reset(new TimeoutState);
+  timeout_state_->alg = this;
+  std::shared_ptr<TimeoutState> state = timeout_state_;
+  SchedNonBlockingClosureAfter(timeout_ms * 1000, [state, timeout_ms]() {
+    mutex_lock l(state->mu);
+    if (state->done) return;
+    RingAlg* alg = state->alg;
+    const string pending = alg->StragglerDebugString();
+    LOG(ERROR) << "Ring" << alg->name_ << " exec " << alg->col_ctx_->exec_key
+               << " timed out after " << timeout_ms << " ms: " << pending
+               << "\n"
+               << CollectiveProgressRegistry::Get()->DebugString();
+    alg->StartAbort(errors::DeadlineExceeded(
+        "Ring", alg->name_, " exec ", alg->col_ctx_->exec_key,
+        " did not complete within ", timeout_ms, " ms: ", pending));
+  });
+}
+
+string RingAlg::StragglerDebugString() {
+  if (rfv_.empty()) return "no fields initialized yet";
+  int done_count = 0;
+  std::set<int> pending_recv_devs;
+  for (const RingField& rf : rfv_) {
+    if (rf.action == RF_DONE) ++done_count;
+    if (rf.action == RF_RECV) pending_recv_devs.insert(rf.recv_dev_idx);
+  }
+  string s =
+      strings::StrCat(done_count, " of ", rfv_.size(), " fields complete");
+  if (!pending_recv_devs.empty()) {
+    strings::StrAppend(&s, "; pending recv from:");
+    for (int dev_idx : pending_recv_devs) {
+      strings::StrAppend(&s, " ",
+                         col_params_->instance.device_names[dev_idx], " (",
+                         col_params_->instance.task_names[dev_idx], ")");
+    }
+  }
+  return s;
+}
+
+StatusCallback RingAlg::TrackProgress(const char* action, const RingField* rf,
+                                      const StatusCallback& done) {
+  const string event =
+      strings::StrCat(action, " pass=", rf->second_pass,
+                      " sc_idx=", rf->sc_idx, " rank=", rf->rank);
+  const string exec_key = col_ctx_->exec_key;
+  return [event, exec_key, done](const Status& s) {
+    CollectiveProgressRegistry::Get()->RecordProgress(
+        exec_key, s.ok() ? event
+                         : strings::StrCat(event,
+                                           " error=", s.error_message()));
+    done(s);
+  };
 }
 
 string RingAlg::TensorDebugString(const Tensor& tensor) {
@@ -387,12 +484,14 @@ void RingAlg::DispatchSend(RingField* rf, const StatusCallback& done) {
   int send_to_rank = (rf->rank + 1) % group_size_;
   int send_to_dev_idx = col_params_->instance.impl_details
                             .subdiv_permutations[rf->subdiv_idx][send_to_rank];
+  const StatusCallback done_cb =
+      progress_enabled_ ? TrackProgress("send", rf, done) : done;
   col_ctx_->col_exec->PostToPeer(
       col_params_->instance.device_names[send_to_dev_idx],
       col_params_->instance.task_names[send_to_dev_idx], send_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
       col_ctx_->op_ctx->output_alloc_attr(0), &rf->chunk,
-      col_ctx_->device_locality, done);
+      col_ctx_->device_locality, done_cb);
 }
 
 void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
@@ -406,13 +505,15 @@ void RingAlg::DispatchRecv(RingField* rf, const StatusCallback& done) {
   Tensor* dst_tensor = (!rf->second_pass && (col_params_->merge_op != nullptr))
                            ? &rf->tmp_chunk
                            : &rf->chunk;
+  const StatusCallback done_cb =
+      progress_enabled_ ? TrackProgress("recv", rf, done) : done;
   col_ctx_->col_exec->RecvFromPeer(
       col_params_->instance.device_names[rf->recv_dev_idx],
       col_params_->instance.task_names[rf->recv_dev_idx],
       col_params_->task.is_local[rf->recv_dev_idx], recv_buf_key,
       col_ctx_->device, col_ctx_->op_ctx->op_device_context(),
       col_ctx_->op_ctx->output_alloc_attr(0), dst_tensor,
-      col_ctx_->device_locality, rf->subdiv_idx, done);
+      col_ctx_->device_locality, rf->subdiv_idx, done_cb);
 }
 
 string RingAlg::FieldState() {
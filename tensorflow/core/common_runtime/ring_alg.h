@@ -31,7 +31,7 @@ class Device;
 class RingAlg : public CollectiveImplementationInterface {
  public:
   explicit RingAlg(CollectiveType type, const string& name);
-  ~RingAlg() override {}
+  ~RingAlg() override;
 
   // Establishes the requested number of subdivision permutations based on the
   // ring order implicit in the device order.
@@ -92,6 +92,23 @@ class RingAlg : public CollectiveImplementationInterface {
   string FieldState();
   string TensorDebugString(const Tensor& tensor);
 
+  // Arms a watchdog that aborts this collective with an error naming the
+  // ranks it is still waiting on if it does not finish within the budget
+  // configured by TF_COLLECTIVE_TIMEOUT_MS.  No-op when no budget is set.
+  void MaybeScheduleTimeout();
+
+  // Best-effort summary of how many fields have completed and which
+  // devices the remainder are waiting to receive from.  Reads the field
+  // states without synchronization, which is acceptable for a diagnostic
+  // taken while the ring appears hung.
+  string StragglerDebugString();
+
+  // Wraps a dispatch callback so its completion is reported to the
+  // CollectiveProgressRegistry.  Only called when progress events are
+  // enabled, so the extra per-chunk closure is normally not paid for.
+  StatusCallback TrackProgress(const char* action, const RingField* rf,
+                               const StatusCallback& done);
+
   // Producer/Consumer Queue of RingField structs.
   class PCQueue {
    public:
@@ -118,6 +135,16 @@ class RingAlg : public CollectiveImplementationInterface {
   mutex status_mu_;
   Status status_ GUARDED_BY(status_mu_);
   std::vector<RingField> rfv_;
+
+  // State shared with the timeout watchdog.  The destructor marks it
+  // done, so a timer that fires after this object is deleted is a no-op.
+  struct TimeoutState {
+    mutex mu;
+    bool done GUARDED_BY(mu) = false;
+    RingAlg* alg GUARDED_BY(mu) = nullptr;  // valid while !done
+  };
+  std::shared_ptr<TimeoutState> timeout_state_;
+  bool progress_enabled_ = false;
 };
 
 }  // namespace tensorflow
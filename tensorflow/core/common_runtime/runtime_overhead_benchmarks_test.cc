@@ -0,0 +1,189 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// End-to-end runtime dispatch overhead benchmarks.
+//
+// These benchmarks drive trivial graphs (chains of Identity ops on scalar
+// inputs) through the main execution entry points -- DirectSession::Run,
+// RunCallable and eager EagerExecute -- across inter-op thread counts, so
+// that per-op dispatch cost regressions surface as items/sec drops here
+// instead of in production.  The kernels are no-ops; everything measured
+// is runtime overhead.
+//
+// Methodology: run with CPU frequency scaling pinned (e.g. the
+// "performance" governor) and the benchmark process pinned to a fixed set
+// of cores, or run-to-run variance will swamp microsecond-level
+// regressions.  Set TEST_REPORT_FILE_PREFIX to have the benchmark runner
+// emit machine-readable BenchmarkEntries for tracking over time:
+//
+//   bazel run -c opt //tensorflow/core:runtime_overhead_benchmarks -- \
+//     --benchmarks=all
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/device_factory.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
+#include "tensorflow/core/common_runtime/eager/attr_builder.h"
+#include "tensorflow/core/common_runtime/eager/context.h"
+#include "tensorflow/core/common_runtime/eager/eager_operation.h"
+#include "tensorflow/core/common_runtime/eager/execute.h"
+#include "tensorflow/core/common_runtime/eager/tensor_handle.h"
+#include "tensorflow/core/common_runtime/rendezvous_mgr.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/graph.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+#include "tensorflow/core/public/session.h"
+#include "tensorflow/core/public/session_options.h"
+
+namespace tensorflow {
+namespace {
+
+// Number of chained Identity ops per step; items/sec is therefore ops/sec
+// through the executor.
+constexpr int kOpsPerStep = 8;
+
+// Builds feed -> Identity x kOpsPerStep -> fetch on /cpu:0, returning the
+// feed and fetch names.
+GraphDef TrivialGraph(string* feed_name, string* fetch_name) {
+  Graph g(OpRegistry::Global());
+  Node* placeholder;
+  TF_CHECK_OK(NodeBuilder(g.NewName("Placeholder"), "Placeholder")
+                  .Attr("shape", TensorShape())
+                  .Attr("dtype", DT_FLOAT)
+                  .Device("/cpu:0")
+                  .Finalize(&g, &placeholder));
+  Node* prev = placeholder;
+  for (int i = 0; i < kOpsPerStep; ++i) {
+    Node* identity;
+    TF_CHECK_OK(NodeBuilder(g.NewName("Identity"), "Identity")
+                    .Input(prev)
+                    .Attr("T", DT_FLOAT)
+                    .Device("/cpu:0")
+                    .Finalize(&g, &identity));
+    prev = identity;
+  }
+  *feed_name = placeholder->name() + ":0";
+  *fetch_name = prev->name() + ":0";
+  GraphDef gd;
+  g.ToGraphDef(&gd);
+  return gd;
+}
+
+std::unique_ptr<Session> TrivialSession(int num_threads, string* feed_name,
+                                        string* fetch_name) {
+  SessionOptions opts;
+  opts.config.set_inter_op_parallelism_threads(num_threads);
+  opts.config.set_use_per_session_threads(true);
+  std::unique_ptr<Session> session(NewSession(opts));
+  TF_CHECK_OK(session->Create(TrivialGraph(feed_name, fetch_name)));
+  return session;
+}
+
+Tensor ScalarInput() {
+  Tensor value(DT_FLOAT, TensorShape());
+  value.flat<float>()(0) = 37.0;
+  return value;
+}
+
+void BM_DirectSessionRun(int iters, int num_threads) {
+  testing::StopTiming();
+  string feed_name;
+  string fetch_name;
+  std::unique_ptr<Session> session =
+      TrivialSession(num_threads, &feed_name, &fetch_name);
+  std::vector<std::pair<string, Tensor>> inputs = {{feed_name, ScalarInput()}};
+  std::vector<string> outputs = {fetch_name};
+  {
+    // Absorb the first-run pruning/partitioning cost outside the timing.
+    std::vector<Tensor> output_values;
+    TF_CHECK_OK(session->Run(inputs, outputs, {}, &output_values));
+  }
+  testing::ItemsProcessed(static_cast<int64>(iters) * kOpsPerStep);
+  testing::StartTiming();
+  for (int i = 0; i < iters; ++i) {
+    std::vector<Tensor> output_values;
+    TF_CHECK_OK(session->Run(inputs, outputs, {}, &output_values));
+  }
+  testing::StopTiming();
+}
+BENCHMARK(BM_DirectSessionRun)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+void BM_DirectSessionRunCallable(int iters, int num_threads) {
+  testing::StopTiming();
+  string feed_name;
+  string fetch_name;
+  std::unique_ptr<Session> session =
+      TrivialSession(num_threads, &feed_name, &fetch_name);
+  CallableOptions callable_options;
+  callable_options.add_feed(feed_name);
+  callable_options.add_fetch(fetch_name);
+  Session::CallableHandle handle;
+  TF_CHECK_OK(session->MakeCallable(callable_options, &handle));
+  std::vector<Tensor> input_tensors = {ScalarInput()};
+  testing::ItemsProcessed(static_cast<int64>(iters) * kOpsPerStep);
+  testing::StartTiming();
+  for (int i = 0; i < iters; ++i) {
+    std::vector<Tensor> output_values;
+    TF_CHECK_OK(
+        session->RunCallable(handle, input_tensors, &output_values, nullptr));
+  }
+  testing::StopTiming();
+  TF_CHECK_OK(session->ReleaseCallable(handle));
+}
+BENCHMARK(BM_DirectSessionRunCallable)->Arg(1)->Arg(2)->Arg(4)->Arg(8);
+
+void BM_EagerExecuteIdentity(int iters) {
+  testing::StopTiming();
+  SessionOptions opts;
+  std::vector<std::unique_ptr<Device>> devices;
+  TF_CHECK_OK(DeviceFactory::AddDevices(
+      opts, "/job:localhost/replica:0/task:0", &devices));
+  std::unique_ptr<const DeviceMgr> device_mgr(
+      new DeviceMgr(std::move(devices)));
+  Rendezvous* rendezvous = new IntraProcessRendezvous(device_mgr.get());
+  EagerContext ctx(opts, DEVICE_PLACEMENT_SILENT, false /* async */,
+                   std::move(device_mgr), rendezvous);
+  TensorHandle* input =
+      new TensorHandle(ScalarInput(), nullptr, nullptr, nullptr);
+  const AttrTypeMap* attr_types;
+  bool is_function = false;
+  TF_CHECK_OK(AttrTypeMapForOp("Identity", &attr_types, &is_function));
+  CHECK(!is_function);
+  testing::ItemsProcessed(static_cast<int64>(iters));
+  testing::StartTiming();
+  for (int i = 0; i < iters; ++i) {
+    EagerOperation op(&ctx, "Identity", false /* is_function */, attr_types);
+    op.MutableAttrs()->Set("T", DT_FLOAT);
+    op.AddInput(input);
+    gtl::InlinedVector<TensorHandle*, 2> retvals;
+    int num_retvals = 1;
+    TF_CHECK_OK(EagerExecute(&op, &retvals, &num_retvals));
+    retvals[0]->Unref();
+  }
+  testing::StopTiming();
+  input->Unref();
+}
+BENCHMARK(BM_EagerExecuteIdentity);
+
+}  // namespace
+}  // namespace tensorflow
@@ -30,7 +30,10 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_constructor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/public/session.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -60,6 +63,18 @@ namespace {
 constexpr char kArgOp[] = "_Arg";
 constexpr char kRetvalOp[] = "_Retval";
 
+// Experimental: memoize shape inference results across nodes with identical
+// (op, attrs, input shapes) signatures.
+bool ShapeInferenceCacheEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SHAPE_INFERENCE_CACHE",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
 // Runs shape inference for the given node using the given ShapeRefiner.
 // The node must be a sub-node of a function node and the outer_context is
 // the inference context of that function node in the outer graph.
@@ -266,16 +281,83 @@ Status ShapeRefiner::AddNode(const Node* node) {
 
   std::unique_ptr<ExtendedInferenceContext> ec(
       new ExtendedInferenceContext(std::move(c), node));
+  InferenceContext* ic = ec->get_context();
+
+  // Experimental: reuse a previously computed result for an identical
+  // (op, attrs, input shapes) signature.  Inputs carrying handle
+  // shapes/types are not part of the fingerprint, so nodes with such
+  // inputs are not eligible.  Nested shape collection for functions is
+  // also excluded, since a cache hit would not reproduce the nested
+  // inference contexts.
+  uint64 cache_key = 0;
+  bool cache_eligible = ShapeInferenceCacheEnabled() &&
+                        !keep_nested_shape_inferences_ &&
+                        op_reg_data->shape_inference_fn != nullptr;
+  for (int i = 0; cache_eligible && i < ic->num_inputs(); ++i) {
+    if (ic->input_handle_shapes_and_types(i) != nullptr) {
+      cache_eligible = false;
+    }
+  }
+  if (cache_eligible) {
+    cache_key = InferenceCacheKey(node, ic);
+    auto it = inference_cache_.find(cache_key);
+    if (it != inference_cache_.end()) {
+      DCHECK_EQ(static_cast<int>(it->second.size()), ic->num_outputs());
+      for (int i = 0; i < ic->num_outputs(); ++i) {
+        ShapeHandle shape;
+        TF_RETURN_IF_ERROR(ic->MakeShapeFromShapeProto(it->second[i], &shape));
+        ic->set_output(i, shape);
+      }
+      node_to_context_[node].swap(ec);
+      return Status::OK();
+    }
+  }
 
   // Run the shape inference function, and return if there was an error.
   TF_RETURN_IF_ERROR(RunShapeFn(node, op_reg_data, ec.get()));
 
+  if (cache_eligible && CacheableInferenceResult(ic)) {
+    std::vector<TensorShapeProto> outputs(ic->num_outputs());
+    for (int i = 0; i < ic->num_outputs(); ++i) {
+      ic->ShapeHandleToProto(ic->output(i), &outputs[i]);
+    }
+    inference_cache_.emplace(cache_key, std::move(outputs));
+  }
+
   // Store the resulting context object in the map.
   node_to_context_[node].swap(ec);
 
   return Status::OK();
 }
 
+uint64 ShapeRefiner::InferenceCacheKey(const Node* node,
+                                       InferenceContext* c) const {
+  // SummarizeAttrs sorts attr names, so the signature is deterministic.
+  string signature =
+      strings::StrCat(node->type_string(), "|", SummarizeAttrs(node->def()));
+  for (int i = 0; i < c->num_inputs(); ++i) {
+    strings::StrAppend(&signature, "|", c->DebugString(c->input(i)));
+  }
+  return Fingerprint64(signature);
+}
+
+bool ShapeRefiner::CacheableInferenceResult(InferenceContext* c) {
+  for (int i = 0; i < c->num_inputs(); ++i) {
+    // A result that depended on input tensor values is not a function of
+    // the input shapes alone.
+    if (c->requested_input_tensor(i) ||
+        c->requested_input_tensor_as_partial_shape(i)) {
+      return false;
+    }
+  }
+  for (int i = 0; i < c->num_outputs(); ++i) {
+    if (c->output_handle_shapes_and_types(i) != nullptr) {
+      return false;
+    }
+  }
+  return true;
+}
+
 Status ShapeRefiner::SetShape(const Node* node, int output_port,
                               ShapeHandle shape) {
   auto c = GetContext(node);
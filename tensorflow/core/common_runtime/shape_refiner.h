@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/graph_runner.h"
 #include "tensorflow/core/framework/function.pb.h"
 #include "tensorflow/core/framework/shape_inference.h"
+#include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/macros.h"
@@ -260,6 +261,16 @@ class ShapeRefiner {
   Status RunShapeFn(const Node* node, const OpRegistrationData* op_reg_data,
                     ExtendedInferenceContext* ec);
 
+  // Returns a fingerprint of 'node's op, attrs and the input shapes in 'c',
+  // suitable as a key for inference_cache_.
+  uint64 InferenceCacheKey(const Node* node,
+                           shape_inference::InferenceContext* c) const;
+
+  // Returns true if the inference result stored in 'c' is a pure function of
+  // the fingerprinted inputs, i.e. the shape function never requested input
+  // tensor values and produced no handle shapes/types.
+  static bool CacheableInferenceResult(shape_inference::InferenceContext* c);
+
   int32 graph_def_version_;
   const OpRegistryInterface* const ops_registry_;
 
@@ -298,6 +309,14 @@ class ShapeRefiner {
   std::unordered_map<const FunctionDef*, std::unique_ptr<const Graph>>
       functions_;
 
+  // Experimental memoization of shape inference results, keyed by a
+  // fingerprint of (op, attrs, input shapes).  Avoids re-running shape
+  // functions for repeated instantiations of identical nodes, e.g. the
+  // bodies of functions that are called many times with the same
+  // signature.  Only results that depend solely on the fingerprinted
+  // inputs are cached; see CacheableInferenceResult().
+  std::unordered_map<uint64, std::vector<TensorShapeProto>> inference_cache_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(ShapeRefiner);
 };
 
@@ -0,0 +1,205 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <algorithm>
+#include <utility>
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+// Requests above this size are never planned; they are rare enough that
+// the wrapped allocator's cost does not matter and they would dominate
+// the arena.
+constexpr size_t kMaxPlannedAllocation = 16 * 1024 * 1024;
+
+// Upper bound on the arena; if the warmup peaks do not fit, the largest
+// classes are dropped from the plan.
+constexpr size_t kMaxArenaBytes = 256 * 1024 * 1024;
+
+}  // namespace
+
+// The allocator handed to the executor.  Forwards to the planner, which
+// records during warmup and serves planned slots afterwards.
+class PlannedStepAllocator : public Allocator {
+ public:
+  explicit PlannedStepAllocator(StaticMemoryPlanner* planner)
+      : planner_(planner) {}
+
+  string Name() override { return "static_memory_plan"; }
+
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    if (planner_->plan_installed_.load(std::memory_order_acquire)) {
+      void* ptr = planner_->PlannedAllocate(alignment, num_bytes);
+      if (ptr != nullptr) return ptr;
+      return planner_->wrapped_->AllocateRaw(alignment, num_bytes);
+    }
+    void* ptr = planner_->wrapped_->AllocateRaw(alignment, num_bytes);
+    if (ptr != nullptr) planner_->RecordAlloc(ptr, num_bytes);
+    return ptr;
+  }
+
+  void DeallocateRaw(void* ptr) override {
+    if (ptr == nullptr) return;
+    if (planner_->plan_installed_.load(std::memory_order_acquire)) {
+      if (planner_->PlannedDeallocate(ptr)) return;
+      planner_->wrapped_->DeallocateRaw(ptr);
+      return;
+    }
+    planner_->RecordDealloc(ptr);
+    planner_->wrapped_->DeallocateRaw(ptr);
+  }
+
+  bool TracksAllocationSizes() override { return false; }
+
+ private:
+  StaticMemoryPlanner* const planner_;  // Not owned.
+};
+
+StaticMemoryPlanner::StaticMemoryPlanner(Allocator* wrapped,
+                                         int64 warmup_steps)
+    : wrapped_(wrapped),
+      warmup_steps_(std::max(int64{1}, warmup_steps)),
+      step_allocator_(new PlannedStepAllocator(this)) {}
+
+StaticMemoryPlanner::~StaticMemoryPlanner() {
+  if (arena_ != nullptr) {
+    wrapped_->DeallocateRaw(arena_);
+  }
+}
+
+Allocator* StaticMemoryPlanner::step_allocator() {
+  return step_allocator_.get();
+}
+
+void StaticMemoryPlanner::StepDone() {
+  mutex_lock l(mu_);
+  ++steps_done_;
+  if (steps_done_ == warmup_steps_ && !plan_installed_.load()) {
+    InstallPlan();
+  }
+}
+
+size_t StaticMemoryPlanner::planned_bytes() const {
+  mutex_lock l(mu_);
+  return arena_bytes_;
+}
+
+size_t StaticMemoryPlanner::RoundToClass(size_t num_bytes) {
+  if (num_bytes == 0 || num_bytes > kMaxPlannedAllocation) return 0;
+  size_t rounded = Allocator::kAllocatorAlignment;
+  while (rounded < num_bytes) rounded <<= 1;
+  return rounded;
+}
+
+void StaticMemoryPlanner::RecordAlloc(void* ptr, size_t num_bytes) {
+  const size_t size_class = RoundToClass(num_bytes);
+  if (size_class == 0) return;
+  mutex_lock l(mu_);
+  if (plan_installed_.load()) return;
+  warmup_ptrs_[ptr] = size_class;
+  const int64 live = ++live_per_class_[size_class];
+  int64& peak = peak_per_class_[size_class];
+  peak = std::max(peak, live);
+}
+
+void StaticMemoryPlanner::RecordDealloc(void* ptr) {
+  mutex_lock l(mu_);
+  auto it = warmup_ptrs_.find(ptr);
+  if (it == warmup_ptrs_.end()) return;
+  --live_per_class_[it->second];
+  warmup_ptrs_.erase(it);
+}
+
+void StaticMemoryPlanner::InstallPlan() {
+  // Smallest classes first, so that dropping classes at the byte budget
+  // keeps as many (cheap, frequent) small slots as possible.
+  std::vector<std::pair<size_t, int64>> peaks(peak_per_class_.begin(),
+                                              peak_per_class_.end());
+  std::sort(peaks.begin(), peaks.end());
+  size_t offset = 0;
+  for (const auto& entry : peaks) {
+    const size_t slot_bytes = entry.first;
+    // Buffers still live at plan time (escaped temporaries) keep their
+    // warmup allocation; still reserve their slots for the next steps.
+    const int64 num_slots = entry.second;
+    if (num_slots <= 0) continue;
+    const size_t class_bytes = slot_bytes * static_cast<size_t>(num_slots);
+    if (offset + class_bytes > kMaxArenaBytes) break;
+    SizeClass size_class;
+    size_class.slot_bytes = slot_bytes;
+    size_class.num_slots = num_slots;
+    size_class.base_offset = offset;
+    size_class.claimed.reset(new std::atomic<bool>[num_slots]);
+    for (int64 i = 0; i < num_slots; ++i) {
+      size_class.claimed[i].store(false, std::memory_order_relaxed);
+    }
+    classes_.push_back(std::move(size_class));
+    offset += class_bytes;
+  }
+  if (offset == 0) {
+    classes_.clear();
+    return;
+  }
+  arena_ = static_cast<char*>(
+      wrapped_->AllocateRaw(Allocator::kAllocatorAlignment, offset));
+  if (arena_ == nullptr) {
+    classes_.clear();
+    return;
+  }
+  arena_bytes_ = offset;
+  VLOG(1) << "Installed static memory plan: " << arena_bytes_ << " bytes in "
+          << classes_.size() << " size classes";
+  plan_installed_.store(true, std::memory_order_release);
+}
+
+void* StaticMemoryPlanner::PlannedAllocate(size_t alignment,
+                                           size_t num_bytes) {
+  if (alignment > Allocator::kAllocatorAlignment) return nullptr;
+  const size_t size_class = RoundToClass(num_bytes);
+  if (size_class == 0) return nullptr;
+  for (SizeClass& c : classes_) {
+    if (c.slot_bytes != size_class) continue;
+    for (int64 i = 0; i < c.num_slots; ++i) {
+      bool expected = false;
+      if (c.claimed[i].compare_exchange_strong(expected, true,
+                                               std::memory_order_acquire)) {
+        return arena_ + c.base_offset + i * c.slot_bytes;
+      }
+    }
+    return nullptr;  // All slots of this class are in use.
+  }
+  return nullptr;  // No such class in the plan.
+}
+
+bool StaticMemoryPlanner::PlannedDeallocate(void* ptr) {
+  char* p = static_cast<char*>(ptr);
+  if (p < arena_ || p >= arena_ + arena_bytes_) return false;
+  const size_t offset = p - arena_;
+  for (SizeClass& c : classes_) {
+    const size_t class_bytes = c.slot_bytes * static_cast<size_t>(c.num_slots);
+    if (offset < c.base_offset || offset >= c.base_offset + class_bytes) {
+      continue;
+    }
+    const int64 slot = (offset - c.base_offset) / c.slot_bytes;
+    c.claimed[slot].store(false, std::memory_order_release);
+    return true;
+  }
+  return false;
+}
+
+}  // namespace tensorflow
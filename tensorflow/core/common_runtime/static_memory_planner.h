@@ -0,0 +1,126 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
+
+#include <atomic>
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// Plans a fixed arena layout for the temporary tensors of an executor
+// whose allocation behaviour repeats every step (fixed-shape inference).
+//
+// During a warmup period the planner observes the step allocator traffic
+// and records, per size class, the peak number of simultaneously live
+// allocations.  After warmup it carves one arena block out of the wrapped
+// allocator with that many slots per class; steady-state steps then claim
+// and release slots with a single compare-and-swap each, acquiring no
+// allocator mutex at all.  Requests the plan cannot serve (a size class
+// never seen in warmup, or more concurrent buffers than the plan
+// reserved, e.g. from overlapping steps) fall through to the wrapped
+// allocator.
+//
+// A per-node offset plan in the style of TFLite's arena planner would be
+// tighter, but the multi-threaded executor does not allocate in a
+// deterministic order, so offsets keyed by size class with measured peak
+// concurrency are used instead; a slot stays claimed until its buffer is
+// deallocated, so temporaries that escape a step remain valid.
+//
+// This class is thread-safe.
+class StaticMemoryPlanner {
+ public:
+  // 'wrapped' must outlive the planner.  'warmup_steps' is the number of
+  // completed steps observed before the plan is computed.
+  StaticMemoryPlanner(Allocator* wrapped, int64 warmup_steps);
+  ~StaticMemoryPlanner();
+
+  // Returns the allocator to install as the step arena allocator.  During
+  // warmup this records allocation traffic while forwarding to the
+  // wrapped allocator; once the plan is installed it serves planned
+  // slots.  The returned pointer is owned by the planner and valid for
+  // the planner's lifetime.
+  Allocator* step_allocator();
+
+  // Declares one step finished.  The call that ends the warmup period
+  // computes and installs the plan.
+  void StepDone();
+
+  // Bytes reserved by the installed plan, or 0 before installation (test
+  // and logging hook).
+  size_t planned_bytes() const;
+
+ private:
+  friend class PlannedStepAllocator;
+
+  struct SizeClass {
+    size_t slot_bytes = 0;
+    int64 num_slots = 0;
+    size_t base_offset = 0;
+    // One flag per slot; claimed and released with compare-and-swap.
+    std::unique_ptr<std::atomic<bool>[]> claimed;
+  };
+
+  // Rounds 'num_bytes' up to its size class, or returns 0 for requests
+  // too large to plan.
+  static size_t RoundToClass(size_t num_bytes);
+
+  // Warmup bookkeeping.
+  void RecordAlloc(void* ptr, size_t num_bytes);
+  void RecordDealloc(void* ptr);
+
+  // Computes slot offsets from the warmup peaks and carves the arena.
+  void InstallPlan() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Planned-path allocation; returns nullptr if the plan cannot serve
+  // the request.
+  void* PlannedAllocate(size_t alignment, size_t num_bytes);
+  // Returns true iff 'ptr' belongs to the arena, releasing its slot.
+  bool PlannedDeallocate(void* ptr);
+
+  Allocator* const wrapped_;  // Not owned.
+  const int64 warmup_steps_;
+
+  std::unique_ptr<Allocator> step_allocator_;  // PlannedStepAllocator.
+
+  // Set once InstallPlan() has run; the planned path reads the plan
+  // without taking mu_ afterwards.
+  std::atomic<bool> plan_installed_{false};
+
+  mutable mutex mu_;
+  int64 steps_done_ GUARDED_BY(mu_) = 0;
+  // Warmup traffic: live and peak allocation counts per size class, and
+  // the class of every outstanding warmup pointer.
+  gtl::FlatMap<size_t, int64> live_per_class_ GUARDED_BY(mu_);
+  gtl::FlatMap<size_t, int64> peak_per_class_ GUARDED_BY(mu_);
+  gtl::FlatMap<const void*, size_t> warmup_ptrs_ GUARDED_BY(mu_);
+
+  // The installed plan.  Immutable after plan_installed_ becomes true.
+  std::vector<SizeClass> classes_;
+  char* arena_ = nullptr;
+  size_t arena_bytes_ = 0;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StaticMemoryPlanner);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STATIC_MEMORY_PLANNER_H_
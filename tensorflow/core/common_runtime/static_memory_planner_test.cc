@@ -0,0 +1,128 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/static_memory_planner.h"
+
+#include <vector>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Wraps cpu_allocator() and counts raw allocation calls, so tests can
+// observe when the planned arena takes over.
+class CountingAllocator : public Allocator {
+ public:
+  string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_allocations_;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+  int64 num_allocations() const { return num_allocations_; }
+
+ private:
+  int64 num_allocations_ = 0;
+};
+
+// Runs one "step" of allocation traffic against the planner.
+std::vector<void*> AllocateStep(Allocator* a, int count, size_t bytes) {
+  std::vector<void*> ptrs;
+  for (int i = 0; i < count; ++i) {
+    void* ptr = a->AllocateRaw(Allocator::kAllocatorAlignment, bytes);
+    EXPECT_NE(ptr, nullptr);
+    ptrs.push_back(ptr);
+  }
+  return ptrs;
+}
+
+TEST(StaticMemoryPlannerTest, SteadyStateUsesArena) {
+  CountingAllocator underlying;
+  StaticMemoryPlanner planner(&underlying, 2 /* warmup_steps */);
+  Allocator* a = planner.step_allocator();
+
+  // Two warmup steps with identical traffic: 8 live 100-byte buffers.
+  for (int step = 0; step < 2; ++step) {
+    std::vector<void*> ptrs = AllocateStep(a, 8, 100);
+    for (void* ptr : ptrs) a->DeallocateRaw(ptr);
+    planner.StepDone();
+  }
+  EXPECT_GT(planner.planned_bytes(), 0);
+  const int64 allocs_after_warmup = underlying.num_allocations();
+
+  // Steady state: identical traffic is served entirely from the arena.
+  for (int step = 0; step < 3; ++step) {
+    std::vector<void*> ptrs = AllocateStep(a, 8, 100);
+    for (void* ptr : ptrs) a->DeallocateRaw(ptr);
+    planner.StepDone();
+  }
+  EXPECT_EQ(underlying.num_allocations(), allocs_after_warmup);
+}
+
+TEST(StaticMemoryPlannerTest, UnplannedTrafficFallsThrough) {
+  CountingAllocator underlying;
+  StaticMemoryPlanner planner(&underlying, 1 /* warmup_steps */);
+  Allocator* a = planner.step_allocator();
+
+  std::vector<void*> ptrs = AllocateStep(a, 2, 100);
+  for (void* ptr : ptrs) a->DeallocateRaw(ptr);
+  planner.StepDone();
+  const int64 allocs_after_warmup = underlying.num_allocations();
+
+  // A size class never seen in warmup goes to the wrapped allocator.
+  void* unplanned = a->AllocateRaw(Allocator::kAllocatorAlignment, 1 << 20);
+  ASSERT_NE(unplanned, nullptr);
+  EXPECT_EQ(underlying.num_allocations(), allocs_after_warmup + 1);
+  a->DeallocateRaw(unplanned);
+
+  // More concurrent buffers than the plan reserved: the excess falls
+  // through, and every pointer deallocates cleanly.
+  std::vector<void*> burst = AllocateStep(a, 4, 100);
+  EXPECT_EQ(underlying.num_allocations(), allocs_after_warmup + 3);
+  for (void* ptr : burst) a->DeallocateRaw(ptr);
+}
+
+TEST(StaticMemoryPlannerTest, SlotsStayClaimedAcrossSteps) {
+  CountingAllocator underlying;
+  StaticMemoryPlanner planner(&underlying, 1 /* warmup_steps */);
+  Allocator* a = planner.step_allocator();
+
+  std::vector<void*> ptrs = AllocateStep(a, 1, 100);
+  for (void* ptr : ptrs) a->DeallocateRaw(ptr);
+  planner.StepDone();
+
+  // A buffer that escapes its step keeps its slot; the next step's
+  // request for the same class cannot reuse it and falls through.
+  void* escaped = a->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  ASSERT_NE(escaped, nullptr);
+  planner.StepDone();
+  const int64 allocs_before = underlying.num_allocations();
+  void* next = a->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  ASSERT_NE(next, nullptr);
+  EXPECT_NE(next, escaped);
+  EXPECT_EQ(underlying.num_allocations(), allocs_before + 1);
+  a->DeallocateRaw(next);
+  a->DeallocateRaw(escaped);
+
+  // With the slot released, the arena serves the class again.
+  void* reused = a->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  EXPECT_EQ(reused, escaped);
+  a->DeallocateRaw(reused);
+}
+
+}  // namespace
+}  // namespace tensorflow
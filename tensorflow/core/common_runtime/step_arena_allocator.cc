@@ -0,0 +1,112 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+// Size of the blocks carved up by the bump allocator.
+constexpr size_t kBlockSize = 256 * 1024;
+
+// Allocations above this size go directly to the wrapped allocator; they
+// would fragment the blocks and are rare enough not to contend on malloc.
+constexpr size_t kMaxArenaAllocation = 32 * 1024;
+
+}  // namespace
+
+StepArenaAllocator::StepArenaAllocator(Allocator* wrapped)
+    : wrapped_(wrapped) {}
+
+StepArenaAllocator::~StepArenaAllocator() {
+  for (void* block : blocks_) {
+    wrapped_->DeallocateRaw(block);
+  }
+}
+
+void* StepArenaAllocator::AllocateRaw(size_t alignment, size_t num_bytes) {
+  if (num_bytes > kMaxArenaAllocation ||
+      alignment > Allocator::kAllocatorAlignment) {
+    void* ptr = wrapped_->AllocateRaw(alignment, num_bytes);
+    if (ptr != nullptr) {
+      mutex_lock l(mu_);
+      large_allocations_.insert(ptr);
+      ++outstanding_allocations_;
+    }
+    return ptr;
+  }
+  mutex_lock l(mu_);
+  // Keep subsequent allocations aligned within the block.
+  const size_t rounded_bytes =
+      (num_bytes + Allocator::kAllocatorAlignment - 1) &
+      ~(Allocator::kAllocatorAlignment - 1);
+  if (rounded_bytes > block_avail_) {
+    void* block = wrapped_->AllocateRaw(Allocator::kAllocatorAlignment,
+                                        kBlockSize);
+    if (block == nullptr) {
+      return nullptr;
+    }
+    blocks_.push_back(block);
+    block_ptr_ = static_cast<char*>(block);
+    block_avail_ = kBlockSize;
+  }
+  void* ptr = block_ptr_;
+  block_ptr_ += rounded_bytes;
+  block_avail_ -= rounded_bytes;
+  ++outstanding_allocations_;
+  return ptr;
+}
+
+void StepArenaAllocator::DeallocateRaw(void* ptr) {
+  if (ptr == nullptr) {
+    return;
+  }
+  bool should_delete;
+  {
+    mutex_lock l(mu_);
+    auto it = large_allocations_.find(ptr);
+    if (it != large_allocations_.end()) {
+      large_allocations_.erase(it);
+      wrapped_->DeallocateRaw(ptr);
+    }
+    // Arena memory is reclaimed in one shot when the arena is destroyed.
+    --outstanding_allocations_;
+    should_delete = UnRef();
+  }
+  if (should_delete) {
+    delete this;
+  }
+}
+
+void StepArenaAllocator::StepDone() {
+  bool should_delete;
+  {
+    mutex_lock l(mu_);
+    DCHECK(!step_done_);
+    step_done_ = true;
+    should_delete = UnRef();
+  }
+  if (should_delete) {
+    delete this;
+  }
+}
+
+bool StepArenaAllocator::UnRef() {
+  DCHECK_GE(outstanding_allocations_, 0);
+  return step_done_ && outstanding_allocations_ == 0;
+}
+
+}  // namespace tensorflow
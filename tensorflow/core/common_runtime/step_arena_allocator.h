@@ -0,0 +1,79 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+#define TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
+
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/lib/gtl/flatset.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// An arena allocator for the temporary tensors of a single executor step.
+//
+// Small allocations are bump-allocated from blocks obtained from the wrapped
+// allocator and are not recycled individually; the blocks are released in
+// one shot once the step has finished and every allocation has been
+// deallocated.  This turns the per-temp malloc/free traffic of small-op
+// graphs into a pointer bump, at the cost of retaining each block until the
+// whole arena drains.  Allocations too large to amortize in a block are
+// forwarded to the wrapped allocator.
+//
+// Like TrackingAllocator, an instance deletes itself after StepDone() has
+// been called and the last outstanding allocation has been deallocated, so
+// buffers that escape the step (e.g. a temp moved into an output) remain
+// valid for as long as they are referenced.
+//
+// This class is thread-safe.
+class StepArenaAllocator : public Allocator {
+ public:
+  explicit StepArenaAllocator(Allocator* wrapped);
+
+  string Name() override { return "step_arena"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override;
+  void DeallocateRaw(void* ptr) override;
+  bool TracksAllocationSizes() override { return false; }
+
+  // Declares that the executor has finished the step that owns this arena.
+  // The caller must not use the allocator afterwards; the arena destroys
+  // itself once all outstanding allocations have been deallocated.
+  void StepDone();
+
+ private:
+  ~StepArenaAllocator() override;
+
+  // Returns true if the arena can be destroyed.
+  bool UnRef() EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  Allocator* const wrapped_;  // Not owned.
+  mutex mu_;
+  // Blocks carved up by the bump allocator, owned by `wrapped_`.
+  std::vector<void*> blocks_ GUARDED_BY(mu_);
+  char* block_ptr_ GUARDED_BY(mu_) = nullptr;
+  size_t block_avail_ GUARDED_BY(mu_) = 0;
+  // Allocations forwarded to `wrapped_` because of their size.
+  gtl::FlatSet<void*> large_allocations_ GUARDED_BY(mu_);
+  int64 outstanding_allocations_ GUARDED_BY(mu_) = 0;
+  bool step_done_ GUARDED_BY(mu_) = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(StepArenaAllocator);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_ARENA_ALLOCATOR_H_
@@ -0,0 +1,92 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/common_runtime/step_arena_allocator.h"
+
+#include <cstring>
+#include <vector>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Wraps cpu_allocator() and counts outstanding raw allocations, so tests can
+// observe when the arena returns its blocks.
+class CountingAllocator : public Allocator {
+ public:
+  string Name() override { return "counting"; }
+  void* AllocateRaw(size_t alignment, size_t num_bytes) override {
+    ++num_outstanding_;
+    return cpu_allocator()->AllocateRaw(alignment, num_bytes);
+  }
+  void DeallocateRaw(void* ptr) override {
+    --num_outstanding_;
+    cpu_allocator()->DeallocateRaw(ptr);
+  }
+  int64 num_outstanding() const { return num_outstanding_; }
+
+ private:
+  int64 num_outstanding_ = 0;
+};
+
+TEST(StepArenaAllocatorTest, SmallAllocationsShareBlocks) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying);
+  std::vector<void*> ptrs;
+  for (int i = 0; i < 1024; ++i) {
+    void* ptr = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+    ASSERT_NE(ptr, nullptr);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(ptr) %
+                  Allocator::kAllocatorAlignment,
+              0);
+    ptrs.push_back(ptr);
+  }
+  // 1024 temps fit in a single 256KiB block.
+  EXPECT_EQ(underlying.num_outstanding(), 1);
+  for (void* ptr : ptrs) {
+    arena->DeallocateRaw(ptr);
+  }
+  // Blocks are retained until the step finishes.
+  EXPECT_EQ(underlying.num_outstanding(), 1);
+  arena->StepDone();
+  EXPECT_EQ(underlying.num_outstanding(), 0);
+}
+
+TEST(StepArenaAllocatorTest, LargeAllocationsPassThrough) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying);
+  void* large = arena->AllocateRaw(Allocator::kAllocatorAlignment, 1 << 20);
+  ASSERT_NE(large, nullptr);
+  EXPECT_EQ(underlying.num_outstanding(), 1);
+  arena->DeallocateRaw(large);
+  EXPECT_EQ(underlying.num_outstanding(), 0);
+  arena->StepDone();
+}
+
+TEST(StepArenaAllocatorTest, SurvivesAllocationsThatEscapeTheStep) {
+  CountingAllocator underlying;
+  StepArenaAllocator* arena = new StepArenaAllocator(&underlying);
+  void* escaped = arena->AllocateRaw(Allocator::kAllocatorAlignment, 100);
+  ASSERT_NE(escaped, nullptr);
+  arena->StepDone();
+  // The arena (and its block) must outlive the escaped allocation.
+  EXPECT_EQ(underlying.num_outstanding(), 1);
+  memset(escaped, 0xab, 100);
+  arena->DeallocateRaw(escaped);
+  EXPECT_EQ(underlying.num_outstanding(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
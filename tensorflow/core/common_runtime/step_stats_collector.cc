@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
+
+#include <atomic>
 #include "tensorflow/core/common_runtime/costmodel_manager.h"
 #include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -27,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -558,4 +561,136 @@ void StepStatsCollector::FinalizeInternal() {
     }
   }
 }
+SamplingStatsCollector::SamplingStatsCollector(int capacity) {
+  events_.resize(capacity);
+}
+
+bool SamplingStatsCollector::ShouldSampleStep() {
+  static const int64 sample_rate = []() {
+    int64 rate = 0;
+    Status s = ReadInt64FromEnvVar("TF_STEP_STATS_SAMPLE_RATE", 0, &rate);
+    if (!s.ok()) {
+      LOG(ERROR) << s.error_message();
+    }
+    return rate;
+  }();
+  if (sample_rate <= 0) {
+    return false;
+  }
+  static std::atomic<int64> step_counter(0);
+  return (step_counter.fetch_add(1) % sample_rate) == 0;
+}
+
+namespace {
+
+// Per-node recorder used by SamplingStatsCollector. Collects timestamps and
+// output byte counts into a fixed-size Event and hands it to the collector
+// in Done(); no protos or strings are touched while the node runs.
+class SampledNodeExecStats : public NodeExecStatsInterface {
+ public:
+  SampledNodeExecStats(const Node* node, SamplingStatsCollector* collector)
+      : collector_(collector) {
+    event_.node = node;
+  }
+
+  void Done(const string& device) override {
+    collector_->RecordEvent(device, event_);
+    delete this;
+  }
+
+  void RecordExecutorStarted() override {
+    event_.started_nanos = Env::Default()->NowNanos();
+  }
+
+  void RecordComputeStarted() override {}
+
+  void RecordComputeEnded() override {}
+
+  void RecordExecutorEnded() override {
+    event_.ended_nanos = Env::Default()->NowNanos();
+  }
+
+  bool TrackAllocations() const override { return false; }
+
+  void SetMemory(OpKernelContext* ctx) override {}
+
+  void SetOutput(int slot, const Tensor* tensor) override {
+    DCHECK(tensor);
+    event_.output_bytes += tensor->TotalBytes();
+  }
+
+  void SetReferencedTensors(const TensorReferenceVector& tensors) override {}
+
+  void SetScheduled(int64 nanos) override { event_.scheduled_nanos = nanos; }
+
+ private:
+  SamplingStatsCollector::Event event_;
+  SamplingStatsCollector* const collector_;  // Not owned.
+};
+
+}  // namespace
+
+NodeExecStatsInterface* SamplingStatsCollector::CreateNodeExecStats(
+    const Node* node) {
+  return new SampledNodeExecStats(node, this);
+}
+
+string SamplingStatsCollector::ReportAllocsOnResourceExhausted(
+    const string& err) {
+  // Allocations are not tracked in sampling mode.
+  return "";
+}
+
+void SamplingStatsCollector::RecordEvent(const string& device,
+                                         const Event& event) {
+  mutex_lock l(mu_);
+  int device_index = -1;
+  for (int i = 0; i < static_cast<int>(devices_.size()); ++i) {
+    if (devices_[i] == device) {
+      device_index = i;
+      break;
+    }
+  }
+  if (device_index < 0) {
+    device_index = devices_.size();
+    devices_.push_back(device);
+  }
+  Event& slot = events_[next_event_ % events_.size()];
+  slot = event;
+  slot.device_index = device_index;
+  ++next_event_;
+}
+
+void SamplingStatsCollector::Export(StepStats* step_stats) {
+  mutex_lock l(mu_);
+  std::map<int, DeviceStepStats*> dev_stats_pb;
+  const uint64 capacity = events_.size();
+  const uint64 num_events = std::min(next_event_, capacity);
+  // When the ring buffer has wrapped, start from the oldest surviving event
+  // so the exported stats stay in execution order.
+  const uint64 first = next_event_ > capacity ? next_event_ % capacity : 0;
+  for (uint64 i = 0; i < num_events; ++i) {
+    const Event& event = events_[(first + i) % capacity];
+    DeviceStepStats*& dss = dev_stats_pb[event.device_index];
+    if (dss == nullptr) {
+      dss = step_stats->add_dev_stats();
+      dss->set_device(devices_[event.device_index]);
+    }
+    NodeExecStats* ns = dss->add_node_stats();
+    ns->set_node_name(event.node->name());
+    ns->set_all_start_micros(event.started_nanos / EnvTime::kMicrosToNanos);
+    ns->set_all_start_nanos(event.started_nanos);
+    ns->set_all_end_rel_micros((event.ended_nanos - event.started_nanos) /
+                               EnvTime::kMicrosToNanos);
+    ns->set_all_end_rel_nanos(event.ended_nanos - event.started_nanos);
+    if (event.scheduled_nanos != 0) {
+      ns->set_scheduled_micros(event.scheduled_nanos /
+                               EnvTime::kMicrosToNanos);
+      ns->set_scheduled_nanos(event.scheduled_nanos);
+    }
+    ns->set_timeline_label(strings::StrCat(event.node->type_string(), " ",
+                                           event.output_bytes, "B"));
+  }
+}
+
 }  // namespace tensorflow
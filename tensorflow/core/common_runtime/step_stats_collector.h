@@ -207,6 +207,53 @@ class StepStatsCollector : public StepStatsCollectorInterface {
   uint64 collected_nodes_ GUARDED_BY(mu_) = 0;
 };
 
+// A low-overhead alternative to StepStatsCollector. Instead of building a
+// NodeExecStats proto per node inline, it records fixed-size events into a
+// preallocated ring buffer and defers all proto construction and string
+// copies to Export(). Node names are resolved from the recorded Node
+// pointers at export time, so the hot path performs no string work and no
+// allocation tracking.
+class SamplingStatsCollector : public StepStatsCollectorInterface {
+ public:
+  // One recorded node execution. 'node' is not owned; it must outlive
+  // Export(), which holds while the executor that produced the event is
+  // alive.
+  struct Event {
+    const Node* node = nullptr;
+    int device_index = 0;
+    int64 scheduled_nanos = 0;
+    uint64 started_nanos = 0;
+    uint64 ended_nanos = 0;
+    int64 output_bytes = 0;
+  };
+
+  static const int kDefaultCapacity = 4096;
+
+  explicit SamplingStatsCollector(int capacity = kDefaultCapacity);
+
+  // Returns true if TF_STEP_STATS_SAMPLE_RATE is set to N > 0 and the
+  // process-wide step counter selects the calling step (one in every N).
+  static bool ShouldSampleStep();
+
+  NodeExecStatsInterface* CreateNodeExecStats(const Node* node) override;
+  string ReportAllocsOnResourceExhausted(const string& err) override;
+
+  // Appends one event, interning 'device'. If the ring buffer is full the
+  // oldest event is overwritten.
+  void RecordEvent(const string& device, const Event& event);
+
+  // Converts the recorded events to NodeExecStats grouped per device and
+  // appends them to 'step_stats'. Intended to run off the hot path.
+  void Export(StepStats* step_stats);
+
+ private:
+  mutex mu_;
+  std::vector<Event> events_ GUARDED_BY(mu_);
+  uint64 next_event_ GUARDED_BY(mu_) = 0;
+  // Interned device names; Event::device_index points into this vector.
+  std::vector<string> devices_ GUARDED_BY(mu_);
+};
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_COMMON_RUNTIME_STEP_STATS_COLLECTOR_H_
@@ -23,6 +23,8 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
+#include "tensorflow/core/common_runtime/rendezvous_mgr.h"
+#include "tensorflow/core/distributed_runtime/request_id.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
 #include "tensorflow/core/framework/types.h"
@@ -32,9 +34,37 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+// Experimental push rendezvous mode.  When TF_PUSH_RENDEZVOUS is set on
+// every worker of a job, a producer pushes each cross-worker tensor
+// produced on a CPU device to its consumer as soon as the Send
+// executes, and the consumer satisfies the matching Recv from a local
+// staging rendezvous instead of issuing a RecvTensor RPC, removing the
+// request leg of the transfer for such edges.  Both sides decide
+// eligibility from the rendezvous key alone, so producer and consumer
+// always agree; tensors produced on non-CPU devices keep using the pull
+// path.  The mode must be enabled (or disabled) consistently across all
+// workers: a consumer with the mode on never pulls an eligible edge
+// from a producer with the mode off.
+static bool PushRendezvousEnabled() {
+  // Read per call: the cost is trivial next to the transfer itself, and
+  // tests exercise both modes in one process.
+  bool enabled;
+  TF_CHECK_OK(ReadBoolFromEnvVar("TF_PUSH_RENDEZVOUS",
+                                 /*default_val=*/false, &enabled));
+  return enabled;
+}
+
+// True if the tensor for "parsed" is produced in host memory and hence
+// can be pushed; must match on producer and consumer, so it may depend
+// only on the key.
+static bool PushEligible(const Rendezvous::ParsedKey& parsed) {
+  return parsed.src.type == "CPU";
+}
+
 static void StartAbortRendevous(Rendezvous* rendez, const Status& s) {
   rendez->StartAbort(s);
   rendez->Unref();
@@ -134,11 +164,13 @@ BaseRemoteRendezvous::BaseRemoteRendezvous(const WorkerEnv* env, int64 step_id)
     : env_(env),
       step_id_(step_id),
       local_(NewLocalRendezvous()),
+      staged_(NewLocalRendezvous()),
       session_(nullptr) {}
 
 BaseRemoteRendezvous::~BaseRemoteRendezvous() {
   CHECK(active_.empty());
   local_->Unref();
+  staged_->Unref();
 }
 
 // Returns true if "device_name" is a valid full name of local device
@@ -199,7 +231,131 @@ Status BaseRemoteRendezvous::Send(const Rendezvous::ParsedKey& parsed,
     }
   }
   // Buffers "val" and "device_context" in local_.
-  return local_->Send(parsed, args, val, is_dead);
+  Status s = local_->Send(parsed, args, val, is_dead);
+  if (s.ok() && PushRendezvousEnabled() && PushEligible(parsed) &&
+      !IsSameWorker(parsed.src, parsed.dst)) {
+    PushToRemoteConsumer(parsed, val, is_dead);
+  }
+  return s;
+}
+
+Status BaseRemoteRendezvous::StagePushedTensor(const ParsedKey& parsed,
+                                               const Rendezvous::Args& args,
+                                               const Tensor& val,
+                                               bool is_dead) {
+  VLOG(1) << "BaseRemoteRendezvous StagePushedTensor " << this << " "
+          << parsed.FullKey();
+  {
+    mutex_lock l(mu_);
+    if (!status_.ok()) return status_;
+  }
+  // Unlike Send(), the source device of "parsed" is remote, so no
+  // locality validation applies; staging may also legitimately happen
+  // before Initialize().
+  return staged_->Send(parsed, args, val, is_dead);
+}
+
+void BaseRemoteRendezvous::PushToRemoteConsumer(const ParsedKey& parsed,
+                                                const Tensor& val,
+                                                bool is_dead) {
+  WorkerSession* sess = session();
+  string dst_worker;
+  string unused;
+  if (!DeviceNameUtils::SplitDeviceName(parsed.dst_device, &dst_worker,
+                                        &unused)) {
+    // The consumer only ever looks in its staged_ store for push-eligible
+    // keys, so a dropped push would leave its Recv waiting forever.  Fail
+    // the step loudly instead.
+    StartAbort(errors::InvalidArgument(
+        "Push rendezvous: invalid destination device ", parsed.dst_device));
+    return;
+  }
+  WorkerInterface* wi = sess->worker_cache->CreateWorker(dst_worker);
+  if (wi == nullptr) {
+    StartAbort(
+        errors::Unavailable("Push rendezvous: no worker known as ",
+                            dst_worker));
+    return;
+  }
+  // State that must outlive this function; released when the push RPC
+  // completes.
+  struct PushCall {
+    CallOptions opts;
+    PushTensorRequest req;
+    PushTensorResponse resp;
+  };
+  PushCall* call = new PushCall;
+  call->req.set_step_id(step_id_);
+  call->req.set_rendezvous_key(string(parsed.FullKey()));
+  if (!is_dead) {
+    val.AsProtoTensorContent(call->req.mutable_tensor());
+  }
+  call->req.set_is_dead(is_dead);
+  call->req.set_request_id(GetUniqueRequestId());
+  WorkerCacheInterface* wc = sess->worker_cache.get();
+  // Keep this rendezvous alive until the push completes so a failed push
+  // can abort it.
+  Ref();
+  wi->PushTensorAsync(&call->opts, &call->req, &call->resp,
+                      [this, call, wi, wc, dst_worker](const Status& s) {
+                        if (!s.ok()) {
+                          // The consumer never falls back to pulling a
+                          // push-eligible key, so a transport error here
+                          // must abort the step rather than hang it.
+                          StartAbort(s);
+                        }
+                        wc->ReleaseWorker(dst_worker, wi);
+                        delete call;
+                        Unref();
+                      });
+}
+
+void BaseRemoteRendezvous::RecvFromStagedAsync(
+    const ParsedKey& parsed, const Rendezvous::Args& recv_args,
+    DoneCallback done) {
+  staged_->RecvAsync(
+      parsed, recv_args,
+      [this, parsed, done](const Status& status,
+                           const Rendezvous::Args& send_args,
+                           const Rendezvous::Args& recv_args, const Tensor& in,
+                           bool is_dead) {
+        // Staged tensors are host-resident, so only a Recv into a
+        // non-host device needs a copy.
+        const bool dst_host =
+            (recv_args.alloc_attrs.on_host() || parsed.dst.type == "CPU");
+        if (!status.ok() || is_dead || dst_host) {
+          done(status, send_args, recv_args, in, is_dead);
+          return;
+        }
+        WorkerSession* sess = session();
+        Device* dst_device = nullptr;
+        Status s =
+            sess->device_mgr()->LookupDevice(parsed.dst_device, &dst_device);
+        Device* cpu_dev = nullptr;
+        if (s.ok()) {
+          s = sess->device_mgr()->LookupDevice("CPU:0", &cpu_dev);
+        }
+        if (!s.ok()) {
+          done(s, send_args, recv_args, in, is_dead);
+          return;
+        }
+        AllocatorAttributes cpu_attr;
+        cpu_attr.set_gpu_compatible(true);
+        Tensor* in_copy = new Tensor(in);
+        Tensor* out = new Tensor(
+            dst_device->GetAllocator(recv_args.alloc_attrs), in.dtype(),
+            in.shape());
+        CopyTensor::ViaDMA(
+            parsed.edge_name, nullptr /*send_dev_ctx*/,
+            recv_args.device_context, cpu_dev, dst_device, cpu_attr,
+            recv_args.alloc_attrs, in_copy, out,
+            0 /*dev_to_dev_stream_index*/,
+            [done, send_args, recv_args, in_copy, out](const Status& s) {
+              done(s, send_args, recv_args, *out, false);
+              delete in_copy;
+              delete out;
+            });
+      });
 }
 
 Status BaseRemoteRendezvous::ValidateDevices(const ParsedKey& parsed,
@@ -303,6 +459,10 @@ void BaseRemoteRendezvous::RecvAsync(const ParsedKey& parsed,
     return;
   }
 
+  // Covers both the local and the remote completion path, so bursts of
+  // RecvTensor RPC completions coalesce as well.
+  done = RecvCallbackBatcher::MaybeBatch(std::move(done));
+
   // Are src and dst in the same worker?
   if (IsSameWorker(parsed.src, parsed.dst)) {
     // Recv the tensor from local_.
@@ -327,6 +487,12 @@ void BaseRemoteRendezvous::RecvAsync(const ParsedKey& parsed,
         });
     return;
   } else {
+    if (PushRendezvousEnabled() && PushEligible(parsed)) {
+      // The producer pushes this value; wait for it in staged_ rather
+      // than issuing a RecvTensor RPC.
+      RecvFromStagedAsync(parsed, recv_args, std::move(done));
+      return;
+    }
     RecvFromRemoteAsync(parsed, recv_args, std::move(done));
   }
 }
@@ -364,6 +530,7 @@ void BaseRemoteRendezvous::RecvLocalAsyncInternal(const ParsedKey& parsed,
 void BaseRemoteRendezvous::StartAbort(const Status& s) {
   CHECK(!s.ok());
   local_->StartAbort(s);
+  staged_->StartAbort(s);
   {
     // Aborts all active RecvTensor calls.
     mutex_lock l(mu_);
@@ -128,6 +128,13 @@ class BaseRemoteRendezvous : public RemoteRendezvous {
   Status Send(const ParsedKey& key, const Rendezvous::Args& args,
               const Tensor& val, const bool is_dead) override;
 
+  // Buffers a tensor pushed by a remote producer in staged_, from
+  // which RecvAsync will satisfy the matching Recv when the push
+  // rendezvous mode is enabled.
+  Status StagePushedTensor(const ParsedKey& parsed,
+                           const Rendezvous::Args& args, const Tensor& val,
+                           bool is_dead) override;
+
   // This method is called only by the RecvOp.  It tests to see
   // whether the value will be produced by a local or remote device
   // and handles accordingly.  In the local case it forwards to
@@ -177,6 +184,11 @@ class BaseRemoteRendezvous : public RemoteRendezvous {
  private:
   Rendezvous* local_;  // Owns a Ref on this object.
 
+  // Buffers tensors pushed by remote producers (push rendezvous mode)
+  // until the matching Recv runs here.  Tensors staged here are always
+  // host-resident.
+  Rendezvous* staged_;
+
   mutable mutex mu_;
 
   // Status given by StartAbort() if any.
@@ -216,6 +228,20 @@ class BaseRemoteRendezvous : public RemoteRendezvous {
   // Must be called only if fully initialized.
   void RecvLocalAsyncInternal(const ParsedKey& parsed, DoneCallback done);
 
+  // Pushes "val" to the worker owning the destination device of
+  // "parsed", where it will be staged until the consumer's Recv runs.
+  // Failures are logged; the push is advisory and errors surface as the
+  // consumer's step eventually aborting.
+  void PushToRemoteConsumer(const ParsedKey& parsed, const Tensor& val,
+                            bool is_dead);
+
+  // Satisfies a Recv whose value will arrive via PushToRemoteConsumer
+  // on the producer side, copying host-resident staged tensors to the
+  // destination device as needed.
+  void RecvFromStagedAsync(const ParsedKey& parsed,
+                           const Rendezvous::Args& recv_args,
+                           DoneCallback done);
+
   TF_DISALLOW_COPY_AND_ASSIGN(BaseRemoteRendezvous);
 };
 
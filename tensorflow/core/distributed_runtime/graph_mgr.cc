@@ -32,6 +32,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/rendezvous_util.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/distributed_runtime/rendezvous_mgr_interface.h"
+#include "tensorflow/core/distributed_runtime/scheduler.h"
 #include "tensorflow/core/framework/cancellation.h"
 #include "tensorflow/core/framework/collective.h"
 #include "tensorflow/core/framework/log_memory.h"
@@ -43,8 +44,11 @@ limitations under the License.
 #include "tensorflow/core/graph/graph_partition.h"
 #include "tensorflow/core/graph/validate.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
@@ -65,9 +69,39 @@ GraphMgr::GraphMgr(const WorkerEnv* worker_env, DeviceMgr* device_mgr)
 }
 
 GraphMgr::~GraphMgr() {
+  for (auto p : registration_cache_) p.second->Unref();
   for (auto p : table_) p.second->Unref();
 }
 
+// Whether identical graph registrations should reuse a previously
+// initialized item (including its executors).  Off by default: cached items
+// survive Deregister, which trades worker memory for fast re-registration.
+static bool GraphRegistrationCacheEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRAPH_REGISTRATION_CACHE",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Fingerprints everything that determines the behavior of a registered
+// graph.  cluster_flr is identity-hashed: items built against a different
+// cluster function library runtime must not be shared.
+static uint64 GraphRegistrationFingerprint(
+    const string& session, const GraphDef& gdef,
+    const GraphOptions& graph_options, const DebugOptions& debug_options,
+    int64 collective_graph_key,
+    DistributedFunctionLibraryRuntime* cluster_flr) {
+  uint64 key = Hash64(session);
+  key = DeterministicProtoHash64(gdef, key);
+  key = DeterministicProtoHash64(graph_options, key);
+  key = DeterministicProtoHash64(debug_options, key);
+  key = FingerprintCat64(key, static_cast<uint64>(collective_graph_key));
+  return FingerprintCat64(key, reinterpret_cast<uintptr_t>(cluster_flr));
+}
+
 GraphMgr::Item::~Item() {
   for (const auto& unit : this->units) {
     CHECK_NOTNULL(unit.device);
@@ -285,6 +319,25 @@ Status GraphMgr::Register(const string& session, const GraphDef& gdef,
                           int64 collective_graph_key,
                           DistributedFunctionLibraryRuntime* cluster_flr,
                           string* handle) {
+  uint64 fingerprint = 0;
+  if (GraphRegistrationCacheEnabled()) {
+    fingerprint =
+        GraphRegistrationFingerprint(session, gdef, graph_options,
+                                     debug_options, collective_graph_key,
+                                     cluster_flr);
+    mutex_lock l(mu_);
+    auto iter = registration_cache_.find(fingerprint);
+    if (iter != registration_cache_.end()) {
+      // Re-registration of an identical graph: hand out a new handle to
+      // the already-initialized item.
+      Item* item = iter->second;
+      item->Ref();
+      *handle = strings::Printf("%016llx", ++next_id_);
+      CHECK(table_.insert({*handle, item}).second);
+      return Status::OK();
+    }
+  }
+
   Item* item = new Item;
   Status s = InitItem(session, gdef, graph_options, debug_options,
                       collective_graph_key, cluster_flr, item);
@@ -299,6 +352,11 @@ Status GraphMgr::Register(const string& session, const GraphDef& gdef,
     *handle = strings::Printf("%016llx", ++next_id_);
     item->handle = *handle;
     CHECK(table_.insert({*handle, item}).second);
+    if (GraphRegistrationCacheEnabled() &&
+        registration_cache_.insert({fingerprint, item}).second) {
+      // The cache keeps the item initialized across Deregister.
+      item->Ref();
+    }
   }
   return Status::OK();
 }
@@ -322,13 +380,17 @@ Status GraphMgr::Deregister(const string& handle) {
 
 Status GraphMgr::DeregisterAll() {
   std::vector<Item*> items;
-  // Removes all items from table_.
+  // Removes all items from table_ and the registration cache.
   {
     mutex_lock l(mu_);
     for (const auto& entry : table_) {
       items.push_back(entry.second);
     }
     table_.clear();
+    for (const auto& entry : registration_cache_) {
+      items.push_back(entry.second);
+    }
+    registration_cache_.clear();
   }
   for (auto item : items) {
     item->Unref();
@@ -529,6 +591,14 @@ void GraphMgr::BuildCostModel(Item* item, StepStatsCollector* collector,
     }
     collector->BuildCostModel(&cost_model_manager_, device_to_graph);
 
+    // Refresh transfer priorities from the updated cost models, so the
+    // RPC layer can move critical-path tensors ahead of bulk transfers.
+    for (const auto& entry : device_to_graph) {
+      const Graph* graph = entry.second;
+      ComputeTransferPriorities(
+          graph, cost_model_manager_.FindOrCreateCostModel(graph));
+    }
+
     if (cost_graph != nullptr) {
       for (const auto& unit : item->units) {
         cost_model_manager_.AddToCostGraphDef(unit.graph, cost_graph)
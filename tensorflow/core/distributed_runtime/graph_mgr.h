@@ -162,6 +162,14 @@ class GraphMgr {
   // mechanism to gc these graphs.
   std::unordered_map<string, Item*> table_;
 
+  // If TF_GRAPH_REGISTRATION_CACHE is enabled, maps a fingerprint of
+  // (session, graph def, options) to an already-initialized item so that
+  // re-registration of an identical partition reuses its executors instead
+  // of re-running graph optimization.  Each entry holds a reference, which
+  // keeps the item alive across Deregister for later re-registration; the
+  // entries are released by DeregisterAll and the destructor.
+  std::unordered_map<uint64, Item*> registration_cache_ GUARDED_BY(mu_);
+
   void StartParallelExecutors(const string& handle, int64 step_id, Item* item,
                               Rendezvous* rendezvous,
                               CollectiveExecutor::Handle* ce_handle,
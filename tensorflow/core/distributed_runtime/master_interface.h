@@ -68,7 +68,7 @@ class MasterInterface {
   // `RunStep()` call on the same `MasterInterface` instance.
   virtual MutableRunStepRequestWrapper* CreateRunStepRequest() {
     MutableProtoRunStepRequest* ret = new MutableProtoRunStepRequest;
-    ret->request_.set_request_id(GetUniqueRequestId());
+    ret->request_->set_request_id(GetUniqueRequestId());
     return ret;
   }
 
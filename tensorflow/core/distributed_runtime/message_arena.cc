@@ -0,0 +1,82 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/message_arena.h"
+
+#include <algorithm>
+
+namespace tensorflow {
+
+const size_t MessageArenaPool::kMinBlockSize;
+const size_t MessageArenaPool::kMaxBlockSize;
+const size_t MessageArenaPool::kMaxPooledArenas;
+
+MessageArenaPool::PooledArena::PooledArena(MessageArenaPool* pool,
+                                           size_t block_size)
+    : pool_(pool),
+      block_size_(block_size),
+      initial_block_(new char[block_size]) {
+  protobuf::ArenaOptions options;
+  options.initial_block = initial_block_.get();
+  options.initial_block_size = block_size_;
+  arena_.reset(new protobuf::Arena(options));
+}
+
+void MessageArenaPool::PooledArenaDeleter::operator()(
+    PooledArena* arena) const {
+  if (arena != nullptr) {
+    arena->pool_->Release(arena);
+  }
+}
+
+/* static */ MessageArenaPool* MessageArenaPool::Global() {
+  static MessageArenaPool* pool = new MessageArenaPool;
+  return pool;
+}
+
+MessageArenaPool::Handle MessageArenaPool::Acquire() {
+  mutex_lock l(mu_);
+  if (!free_list_.empty()) {
+    PooledArena* arena = free_list_.back().release();
+    free_list_.pop_back();
+    return Handle(arena);
+  }
+  return Handle(new PooledArena(this, high_water_mark_));
+}
+
+size_t MessageArenaPool::high_water_mark() const {
+  mutex_lock l(mu_);
+  return high_water_mark_;
+}
+
+void MessageArenaPool::Release(PooledArena* arena) {
+  const size_t used = std::min(
+      static_cast<size_t>(arena->arena_->SpaceUsed()), kMaxBlockSize);
+  // Reset() frees any overflow blocks but keeps the pool-owned initial
+  // block, so a right-sized arena allocates nothing on later steps.
+  arena->arena_->Reset();
+  mutex_lock l(mu_);
+  high_water_mark_ = std::max(high_water_mark_, used);
+  if (arena->block_size_ >= high_water_mark_ &&
+      free_list_.size() < kMaxPooledArenas) {
+    free_list_.emplace_back(arena);
+  } else {
+    // Either steps have outgrown this arena's block or the pool is
+    // full; drop it so the next Acquire() builds a right-sized one.
+    delete arena;
+  }
+}
+
+}  // namespace tensorflow
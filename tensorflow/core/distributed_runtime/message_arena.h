@@ -0,0 +1,113 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MESSAGE_ARENA_H_
+#define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MESSAGE_ARENA_H_
+
+#include <memory>
+#include <vector>
+
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// A pool of protobuf arenas for the per-step request/response protos
+// that the master and worker runtimes create on every step.
+//
+// The proto-backed message wrappers (see message_wrappers.h) are
+// allocated once per partition per step, and at high step rates the
+// repeated allocation and destruction of their submessages is
+// measurable CPU. Backing each wrapper with a pooled arena amortizes
+// that cost: the arena's initial block is owned by the pool and reused
+// across steps, so a steady-state step performs no proto heap
+// allocation at all once the block is large enough.
+//
+// The pool sizes the initial block from a rolling high-water mark of
+// arena usage (clamped to [kMinBlockSize, kMaxBlockSize]). Arenas whose
+// block has been outgrown by the high-water mark are discarded on
+// release, so the pool converges on right-sized blocks after a few
+// steps even if early steps were small.
+//
+// This class is thread-safe.
+class MessageArenaPool {
+ public:
+  // An arena together with its pool-owned initial block. Obtained from
+  // `Acquire()` and returned to the pool when the handle is destroyed.
+  class PooledArena {
+   public:
+    protobuf::Arena* get() { return arena_.get(); }
+
+   private:
+    friend class MessageArenaPool;
+
+    PooledArena(MessageArenaPool* pool, size_t block_size);
+
+    MessageArenaPool* const pool_;
+    // The block must outlive the arena, so it is declared first.
+    const size_t block_size_;
+    std::unique_ptr<char[]> initial_block_;
+    std::unique_ptr<protobuf::Arena> arena_;
+
+    TF_DISALLOW_COPY_AND_ASSIGN(PooledArena);
+  };
+
+  struct PooledArenaDeleter {
+    void operator()(PooledArena* arena) const;
+  };
+
+  // While a handle is live, messages created on its arena remain valid;
+  // destroying the handle resets the arena and returns it to the pool.
+  typedef std::unique_ptr<PooledArena, PooledArenaDeleter> Handle;
+
+  // Returns the process-wide pool.
+  static MessageArenaPool* Global();
+
+  // Returns a pooled arena, creating one sized to the current
+  // high-water mark if the pool is empty.
+  Handle Acquire();
+
+  // The current block-size target, exposed for tests.
+  size_t high_water_mark() const;
+
+ private:
+  friend struct PooledArenaDeleter;
+
+  // Lower bound on block size, so that small early steps do not cause
+  // tiny blocks to be allocated and immediately outgrown.
+  static const size_t kMinBlockSize = 4 * 1024;
+
+  // Upper bound on the high-water mark, so that an occasional step with
+  // very large feeds does not pin megabytes in every pooled arena.
+  static const size_t kMaxBlockSize = 1024 * 1024;
+
+  // Upper bound on the number of idle arenas retained.
+  static const size_t kMaxPooledArenas = 32;
+
+  // Resets `arena` and either returns it to the free list or, if its
+  // block is undersized or the pool is full, deletes it.
+  void Release(PooledArena* arena);
+
+  mutable mutex mu_;
+  size_t high_water_mark_ GUARDED_BY(mu_) = kMinBlockSize;
+  std::vector<std::unique_ptr<PooledArena>> free_list_ GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MESSAGE_ARENA_H_
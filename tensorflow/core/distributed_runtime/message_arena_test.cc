@@ -0,0 +1,69 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/distributed_runtime/message_arena.h"
+
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(MessageArenaPoolTest, MessagesLiveOnTheArena) {
+  MessageArenaPool pool;
+  MessageArenaPool::Handle handle = pool.Acquire();
+  TensorProto* proto =
+      protobuf::Arena::CreateMessage<TensorProto>(handle->get());
+  proto->set_dtype(DT_FLOAT);
+  EXPECT_EQ(proto->GetArena(), handle->get());
+  EXPECT_GT(handle->get()->SpaceUsed(), 0);
+}
+
+TEST(MessageArenaPoolTest, ReleasedArenaIsResetAndReused) {
+  MessageArenaPool pool;
+  MessageArenaPool::Handle handle = pool.Acquire();
+  MessageArenaPool::PooledArena* raw = handle.get();
+  protobuf::Arena::CreateMessage<TensorProto>(handle->get())
+      ->set_dtype(DT_FLOAT);
+  handle.reset();
+
+  // The same arena comes back, with its space reclaimed.
+  handle = pool.Acquire();
+  EXPECT_EQ(handle.get(), raw);
+  EXPECT_EQ(handle->get()->SpaceUsed(), 0);
+}
+
+TEST(MessageArenaPoolTest, HighWaterMarkTracksUsageAndResizesArenas) {
+  MessageArenaPool pool;
+  const size_t initial_mark = pool.high_water_mark();
+
+  {
+    MessageArenaPool::Handle handle = pool.Acquire();
+    // Allocate submessages until the arena has grown well past its
+    // initial block.
+    while (handle->get()->SpaceUsed() < 4 * initial_mark) {
+      protobuf::Arena::CreateMessage<TensorProto>(handle->get());
+    }
+  }
+
+  // The large step raised the mark, so the undersized arena was dropped
+  // rather than pooled, and the next acquire sees the new target.
+  EXPECT_GT(pool.high_water_mark(), initial_mark);
+  MessageArenaPool::Handle handle = pool.Acquire();
+  EXPECT_EQ(handle->get()->SpaceUsed(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
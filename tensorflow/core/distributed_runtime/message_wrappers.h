@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MESSAGE_WRAPPERS_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_MESSAGE_WRAPPERS_H_
 
+#include "tensorflow/core/distributed_runtime/message_arena.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/cost_graph.pb.h"
 #include "tensorflow/core/framework/graph.pb.h"
@@ -163,8 +164,14 @@ class InMemoryRunStepRequest : public MutableRunStepRequestWrapper {
 //
 // This wrapper class should be used for RunStep requests between a
 // client and master in different address spaces.
+//
+// The underlying proto is allocated on a pooled arena (see
+// message_arena.h) so that the per-step message and its feed
+// submessages reuse the same blocks across steps.
 class MutableProtoRunStepRequest : public MutableRunStepRequestWrapper {
  public:
+  MutableProtoRunStepRequest();
+
   // RunStepRequestWrapper methods.
   const string& session_handle() const override;
   const string& partial_run_handle() const override;
@@ -192,7 +199,8 @@ class MutableProtoRunStepRequest : public MutableRunStepRequestWrapper {
   void set_store_errors_in_response_body(bool store_errors) override;
 
  private:
-  RunStepRequest request_;
+  MessageArenaPool::Handle arena_;
+  RunStepRequest* const request_;  // Owned by `arena_`.
   friend class MasterInterface;
 };
 
@@ -381,6 +389,8 @@ class InMemoryRunGraphRequest : public MutableRunGraphRequestWrapper {
 
 class MutableProtoRunGraphRequest : public MutableRunGraphRequestWrapper {
  public:
+  MutableProtoRunGraphRequest();
+
   // RunGraphRequestWrapper methods.
   const string& session_handle() const override;
   bool create_worker_session_called() const override;
@@ -415,7 +425,8 @@ class MutableProtoRunGraphRequest : public MutableRunGraphRequestWrapper {
   void set_store_errors_in_response_body(bool store_errors) override;
 
  private:
-  RunGraphRequest request_;
+  MessageArenaPool::Handle arena_;
+  RunGraphRequest* const request_;  // Owned by `arena_`.
 };
 
 class ProtoRunGraphRequest : public RunGraphRequestWrapper {
@@ -538,6 +549,8 @@ class InMemoryRunGraphResponse : public MutableRunGraphResponseWrapper {
 // Proto-based message wrapper for use on the client side of the RunGraph RPC.
 class OwnedProtoRunGraphResponse : public MutableRunGraphResponseWrapper {
  public:
+  OwnedProtoRunGraphResponse();
+
   // MutableRunGraphResponseWrapper methods.
   size_t num_recvs() const override;
   const string& recv_key(size_t i) const override;
@@ -557,7 +570,8 @@ class OwnedProtoRunGraphResponse : public MutableRunGraphResponseWrapper {
   RunGraphResponse* get_proto() override;
 
  private:
-  RunGraphResponse response_;
+  MessageArenaPool::Handle arena_;
+  RunGraphResponse* const response_;  // Owned by `arena_`.
 };
 
 // Proto-based message wrapper for use on the server side of the RunGraph RPC.
@@ -680,6 +694,8 @@ class InMemoryRunStepResponse : public MutableRunStepResponseWrapper {
 // Proto-based message wrapper for use on the client side of the RunStep RPC.
 class OwnedProtoRunStepResponse : public MutableRunStepResponseWrapper {
  public:
+  OwnedProtoRunStepResponse();
+
   // MutableRunStepResponseWrapper methods.
   size_t num_tensors() const override;
   const string& tensor_name(size_t i) const override;
@@ -697,7 +713,8 @@ class OwnedProtoRunStepResponse : public MutableRunStepResponseWrapper {
   RunStepResponse* get_proto() override;
 
  private:
-  RunStepResponse response_;
+  MessageArenaPool::Handle arena_;
+  RunStepResponse* const response_;  // Owned by `arena_`.
 };
 
 // Proto-based message wrapper for use on the server side of the RunStep RPC.
@@ -40,6 +40,12 @@ class RemoteRendezvous : public Rendezvous {
  public:
   // Fully construct the RemoteRendezvous.
   virtual Status Initialize(WorkerSession* session) = 0;
+
+  // Buffers a tensor pushed by a remote producer until the
+  // corresponding Recv runs locally.  Used by the push rendezvous mode;
+  // see base_rendezvous_mgr.cc.  May be called before Initialize().
+  virtual Status StagePushedTensor(const ParsedKey& parsed, const Args& args,
+                                   const Tensor& val, bool is_dead) = 0;
 };
 
 // RendezvousMgr keeps track of a set of local rendezvous instances.
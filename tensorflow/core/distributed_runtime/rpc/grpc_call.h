@@ -52,6 +52,11 @@ namespace tensorflow {
 //   `Call` type, in order to access its state, and invoke its
 //   `SendResponse()` method.
 //
+// * `ServerStreamingCall<Service, GrpcService, Req, Resp>`: Like `Call`,
+//   but for methods whose response is a stream of messages.  The handler
+//   sends messages with `SendPartialResponse()` and closes the stream with
+//   `Finish()`.
+//
 // The lifecycle of a call object is as follows.
 //
 // 1. A `Service` creates a `Call` for a particular method and
@@ -95,13 +100,23 @@ class UntypedCall : public core::RefCounted {
   // the `grpc::ServerContext` associated with the request.
   virtual void RequestCancelled(Service* service, bool ok) = 0;
 
+  // This method will be called when one message of a streamed response has
+  // been sent.  Only calls whose responses are streamed receive it; unary
+  // calls do not, hence the empty default implementation.
+  virtual void PartialResponseSent(Service* service, bool ok) {}
+
   // Associates a tag in a `::grpc::CompletionQueue` with a callback
   // for an incoming RPC.  An active Tag owns a reference on the corresponding
   // Call object.
   class Tag {
    public:
     // One enum value per supported callback.
-    enum Callback { kRequestReceived, kResponseSent, kCancelled };
+    enum Callback {
+      kRequestReceived,
+      kPartialResponseSent,
+      kResponseSent,
+      kCancelled
+    };
 
     Tag(UntypedCall* call, Callback cb) : call_(call), callback_(cb) {}
 
@@ -113,6 +128,9 @@ class UntypedCall : public core::RefCounted {
         case kRequestReceived:
           call_->RequestReceived(service, ok);
           break;
+        case kPartialResponseSent:
+          call_->PartialResponseSent(service, ok);
+          break;
         case kResponseSent:
           // No special handling needed apart from the Unref below.
           break;
@@ -263,6 +281,144 @@ class Call : public UntypedCall<Service> {
   std::function<void()> cancel_callback_ GUARDED_BY(mu_);
 };
 
+// Represents a pending call whose response is streamed: instead of a single
+// `SendResponse()`, the handler sends any number of response messages with
+// `SendPartialResponse()` and then closes the stream with `Finish()`.  At
+// most one message may be in flight at a time; the `on_sent` callback
+// passed to `SendPartialResponse()` signals when the next message (or the
+// final `Finish()`) may be issued.
+template <class Service, class GrpcService, class RequestMessage,
+          class ResponseMessage>
+class ServerStreamingCall : public UntypedCall<Service> {
+ public:
+  // Represents the generic signature of a `Service::HandleFoo()`
+  // method, where `Foo` is the name of an RPC method.
+  using HandleRequestFunction = void (Service::*)(
+      ServerStreamingCall<Service, GrpcService, RequestMessage,
+                          ResponseMessage>*);
+
+  ServerStreamingCall(HandleRequestFunction handle_request_function)
+      : handle_request_function_(handle_request_function), responder_(&ctx_) {}
+
+  virtual ~ServerStreamingCall() {}
+
+  void RequestReceived(Service* service, bool ok) override {
+    if (ok) {
+      this->Ref();
+      (service->*handle_request_function_)(this);
+    }
+  }
+
+  // Sends one message of the response stream.  `on_sent` is invoked, with
+  // the success of the write, once the message is on the wire and the next
+  // write may be issued.
+  void SendPartialResponse(const ResponseMessage& message,
+                           std::function<void(bool)> on_sent) {
+    {
+      mutex_lock l(mu_);
+      on_partial_response_sent_ = std::move(on_sent);
+    }
+    this->Ref();  // Ref for grpc; released in Tag callback.
+    responder_.Write(message, &partial_response_sent_tag_);
+  }
+
+  void PartialResponseSent(Service* service, bool ok) override {
+    std::function<void(bool)> on_sent;
+    {
+      mutex_lock l(mu_);
+      on_sent = std::move(on_partial_response_sent_);
+      on_partial_response_sent_ = nullptr;
+    }
+    if (on_sent) {
+      on_sent(ok);
+    }
+  }
+
+  // Closes the response stream with the given status, releasing the
+  // handler's reference on this call object (like `Call::SendResponse()`).
+  void Finish(::grpc::Status status) {
+    this->Ref();  // Ref for grpc; released in Tag callback.
+    responder_.Finish(status, &response_sent_tag_);
+    this->Unref();
+  }
+
+  void RequestCancelled(Service* service, bool ok) override {
+    if (ctx_.IsCancelled()) {
+      mutex_lock l(mu_);
+      if (cancel_callback_) {
+        cancel_callback_();
+      }
+    }
+  }
+
+  // Registers `callback` as the function that should be called if and when
+  // this call is canceled by the client.
+  void SetCancelCallback(std::function<void()> callback) {
+    mutex_lock l(mu_);
+    cancel_callback_ = std::move(callback);
+  }
+
+  // Clears any cancellation callback that has been registered for this call.
+  void ClearCancelCallback() {
+    mutex_lock l(mu_);
+    cancel_callback_ = nullptr;
+  }
+
+  // Enqueues a new request for the given service on the given
+  // completion queue, using the given `method_id`.
+  //
+  // The request will be handled with the given
+  // `handle_request_function`.
+  static void EnqueueRequestForMethod(
+      GrpcService* grpc_service, ::grpc::ServerCompletionQueue* cq,
+      int method_id, HandleRequestFunction handle_request_function,
+      bool supports_cancel) {
+    auto call = new ServerStreamingCall<Service, GrpcService, RequestMessage,
+                                        ResponseMessage>(
+        handle_request_function);
+    if (supports_cancel) {
+      call->RegisterCancellationHandler();
+    }
+
+    // Initial ref for call handed to grpc; released in Tag callback.
+    grpc_service->RequestAsyncServerStreaming(
+        method_id, &call->ctx_, &call->request, &call->responder_, cq, cq,
+        &call->request_received_tag_);
+  }
+
+  RequestMessage request;
+
+  const std::multimap<::grpc::string_ref, ::grpc::string_ref>& client_metadata()
+      const {
+    return ctx_.client_metadata();
+  }
+
+ private:
+  // Creates a completion queue tag for handling cancellation by the client.
+  // NOTE: This method must be called before this call is enqueued on a
+  // completion queue.
+  void RegisterCancellationHandler() {
+    this->Ref();  // Ref for grpc; released in Tag callback.
+    ctx_.AsyncNotifyWhenDone(&cancelled_tag_);
+  }
+
+  HandleRequestFunction handle_request_function_;
+  ::grpc::ServerContext ctx_;
+  ::grpc::ServerAsyncWriter<ResponseMessage> responder_;
+
+  // Used as void* completion markers from grpc to indicate different
+  // events of interest for a ServerStreamingCall.
+  typedef typename UntypedCall<Service>::Tag Tag;
+  Tag request_received_tag_{this, Tag::kRequestReceived};
+  Tag partial_response_sent_tag_{this, Tag::kPartialResponseSent};
+  Tag response_sent_tag_{this, Tag::kResponseSent};
+  Tag cancelled_tag_{this, Tag::kCancelled};
+
+  mutex mu_;
+  std::function<void(bool)> on_partial_response_sent_ GUARDED_BY(mu_);
+  std::function<void()> cancel_callback_ GUARDED_BY(mu_);
+};
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_CALL_H_
@@ -15,32 +15,355 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_remote_worker.h"
 
+#include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "grpcpp/generic/generic_stub.h"
 #include "grpcpp/grpcpp.h"
 
+#include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_client_cq_tag.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_state.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
 #include "tensorflow/core/distributed_runtime/rpc/grpc_worker_service_impl.h"
+#include "tensorflow/core/distributed_runtime/request_id.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 #include "tensorflow/core/distributed_runtime/worker_cache_logger.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/refcount.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 const int kMaxWorkerRpcRetries = 10;
 
+namespace {
+
+// If true, host-memory tensors are received via the server-streaming
+// RecvTensorStream method instead of the unary RecvTensor method, so that
+// transfer and deserialization of large tensors overlap.  Off by default.
+bool RecvTensorStreamEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_RECV_TENSOR_STREAMING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Client-side state for one RecvTensorStream call.  The server's first
+// frame is a RecvTensorResponse; when its metadata_only field is set the
+// tensor content follows as raw-bytes frames, which are copied into the
+// response tensor as they arrive so the copies overlap the transfer of
+// subsequent chunks.  Unlike RPCState, streamed calls are not retried.
+// Deletes itself when the call completes.
+class StreamingRecvTensorState : public GrpcClientCQTag {
+ public:
+  StreamingRecvTensorState(::grpc::GenericStub* stub,
+                           ::grpc::CompletionQueue* cq,
+                           const ::grpc::string& method,
+                           const protobuf::Message& request,
+                           TensorResponse* response, StatusCallback done,
+                           CallOptions* call_opts)
+      : response_(response), done_(std::move(done)), call_opts_(call_opts) {
+    ::grpc::Status s = GrpcMaybeUnparseProto(request, &request_buf_);
+    if (!s.ok()) {
+      LOG(ERROR) << "GrpcMaybeUnparseProto returned with non-ok status: "
+                 << s.error_message();
+      done_(FromGrpcStatus(s));
+      delete this;
+      return;
+    }
+    if (call_opts_) {
+      call_opts_->SetCancelCallback([this]() { context_.TryCancel(); });
+    }
+    call_ = stub->PrepareCall(&context_, method, cq);
+    next_step_ = Step::kCallStarted;
+    call_->StartCall(this);
+  }
+
+  void OnCompleted(bool ok) override {
+    switch (next_step_) {
+      case Step::kCallStarted:
+        if (!ok) {
+          Finish();
+          return;
+        }
+        next_step_ = Step::kRequestSent;
+        call_->Write(request_buf_,
+                     ::grpc::WriteOptions().set_last_message(), this);
+        return;
+      case Step::kRequestSent:
+        if (!ok) {
+          Finish();
+          return;
+        }
+        next_step_ = Step::kFirstFrame;
+        call_->Read(&frame_, this);
+        return;
+      case Step::kFirstFrame: {
+        if (!ok) {
+          // Stream closed without a frame; the final status says why.
+          Finish();
+          return;
+        }
+        RecvTensorResponse meta;
+        if (!GrpcMaybeParseProto(&frame_, &meta)) {
+          Abort(errors::Internal(
+              "Cannot parse first frame of RecvTensorStream response"));
+          return;
+        }
+        if (!meta.metadata_only()) {
+          // The complete response arrived in a single frame (dead tensor,
+          // string tensor).
+          parse_error_ = response_->InitFrom(&meta);
+          next_step_ = Step::kStreamEnd;
+          call_->Read(&frame_, this);
+          return;
+        }
+        if (!DataTypeCanUseMemcpy(meta.tensor().dtype())) {
+          Abort(errors::Internal(
+              "RecvTensorStream: chunked content for unexpected dtype ",
+              DataTypeString(meta.tensor().dtype())));
+          return;
+        }
+        meta.clear_metadata_only();
+        response_->InitPartial(meta, AllocationAttributes());
+        next_step_ = Step::kContentFrame;
+        frame_.Clear();
+        call_->Read(&frame_, this);
+        return;
+      }
+      case Step::kContentFrame: {
+        if (!ok) {
+          // End of stream: every content frame has arrived.
+          const size_t expected = response_->tensor().TotalBytes();
+          if (write_offset_ != expected) {
+            parse_error_ = errors::Internal(
+                "RecvTensorStream: expected ", expected,
+                " content bytes but received ", write_offset_);
+          }
+          Finish();
+          return;
+        }
+        Status s = CopyFrameToTensor();
+        if (!s.ok()) {
+          Abort(s);
+          return;
+        }
+        frame_.Clear();
+        call_->Read(&frame_, this);
+        return;
+      }
+      case Step::kStreamEnd:
+        if (ok) {
+          // The server sent frames after a complete response.
+          parse_error_ = errors::Internal(
+              "RecvTensorStream: unexpected frame after complete response");
+          context_.TryCancel();
+        }
+        Finish();
+        return;
+      case Step::kFinished: {
+        if (call_opts_) {
+          call_opts_->ClearCancelCallback();
+        }
+        Status s = FromGrpcStatus(status_);
+        if (s.ok() && !parse_error_.ok()) {
+          s = parse_error_;
+        }
+        StatusCallback done = std::move(done_);
+        delete this;
+        done(s);
+        return;
+      }
+    }
+  }
+
+ private:
+  enum class Step {
+    kCallStarted,
+    kRequestSent,
+    kFirstFrame,
+    kContentFrame,
+    kStreamEnd,
+    kFinished,
+  };
+
+  void Finish() {
+    next_step_ = Step::kFinished;
+    call_->Finish(&status_, this);
+  }
+
+  // Records "error", cancels the call, and retrieves the final status.
+  void Abort(const Status& error) {
+    parse_error_ = error;
+    context_.TryCancel();
+    Finish();
+  }
+
+  // Copies the content frame in frame_ into the response tensor at
+  // write_offset_.
+  Status CopyFrameToTensor() {
+    std::vector<::grpc::Slice> slices;
+    ::grpc::Status s = frame_.Dump(&slices);
+    if (!s.ok()) {
+      return FromGrpcStatus(s);
+    }
+    const Tensor& tensor = response_->tensor();
+    const size_t total_bytes = tensor.TotalBytes();
+    char* base = reinterpret_cast<char*>(
+        const_cast<void*>(DMAHelper::base(&tensor)));
+    for (const ::grpc::Slice& slice : slices) {
+      if (write_offset_ + slice.size() > total_bytes) {
+        return errors::Internal(
+            "RecvTensorStream: content overflows tensor of ", total_bytes,
+            " bytes");
+      }
+      memcpy(base + write_offset_, slice.begin(), slice.size());
+      write_offset_ += slice.size();
+    }
+    return Status::OK();
+  }
+
+  ::grpc::ClientContext context_;
+  std::unique_ptr<::grpc::GenericClientAsyncReaderWriter> call_;
+  ::grpc::ByteBuffer request_buf_;
+  ::grpc::ByteBuffer frame_;
+  ::grpc::Status status_;
+  Step next_step_;
+
+  TensorResponse* response_;
+  StatusCallback done_;
+  CallOptions* call_opts_;
+  Status parse_error_;
+  size_t write_offset_ = 0;
+};
+
+// If true, RecvTensor calls headed to the same worker and step are held
+// briefly and coalesced into one RecvBundledTensors RPC, trading a small
+// amount of latency for far fewer RPCs on steps that transfer many small
+// tensors.  Off by default.
+bool RecvTensorBundlingEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_RECV_TENSOR_BUNDLING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// How long the first RecvTensor call of a (worker, step) pair waits for
+// others to join its bundle.
+int64 RecvTensorBundleWindowMicros() {
+  static int64 result = [] {
+    int64 window_micros;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_RECV_TENSOR_BUNDLE_WINDOW_MICROS",
+                                    /*default_val=*/100, &window_micros));
+    return window_micros;
+  }();
+  return result;
+}
+
+// Collects RecvTensor calls for the same step so they can be issued as
+// one RecvBundledTensors RPC.  The first call for a step starts a flush
+// timer; the bundle is flushed when the timer fires or when it reaches
+// kMaxBundleSize, whichever comes first.
+//
+// The bundler is reference counted because the flush timer can outlive
+// the GrpcRemoteWorker that owns the bundler: the worker's destructor
+// calls WorkerGone() and drops its reference, and a timer that fires
+// afterwards finds nothing to do.  The flush function itself only runs
+// while at least one call is pending, and every pending call keeps the
+// worker alive through its rendezvous.
+class RecvTensorBundler : public core::RefCounted {
+ public:
+  struct Item {
+    RecvTensorRequest request;
+    TensorResponse* response;
+    StatusCallback done;
+    CallOptions* call_opts;
+  };
+  typedef std::function<void(std::unique_ptr<std::vector<Item>>)> FlushFn;
+
+  explicit RecvTensorBundler(FlushFn flush_fn)
+      : flush_fn_(std::move(flush_fn)) {}
+
+  void Add(const RecvTensorRequest* request, TensorResponse* response,
+           StatusCallback done, CallOptions* call_opts) {
+    const int64 step_id = request->step_id();
+    std::unique_ptr<std::vector<Item>> to_flush;
+    {
+      mutex_lock l(mu_);
+      std::unique_ptr<std::vector<Item>>& pending = pending_[step_id];
+      if (pending == nullptr) {
+        pending.reset(new std::vector<Item>);
+        Ref();  // Held by the timer closure; released in TimerFlush.
+        Env::Default()->SchedClosureAfter(
+            RecvTensorBundleWindowMicros(),
+            [this, step_id]() { TimerFlush(step_id); });
+      }
+      pending->push_back(Item{*request, response, std::move(done), call_opts});
+      if (pending->size() >= kMaxBundleSize) {
+        to_flush = std::move(pending);
+        pending_.erase(step_id);
+      }
+    }
+    if (to_flush != nullptr) {
+      flush_fn_(std::move(to_flush));
+    }
+  }
+
+  // Called by the owning GrpcRemoteWorker's destructor.  No calls can be
+  // pending at that point, since a pending call keeps the worker alive.
+  void WorkerGone() {
+    mutex_lock l(mu_);
+    worker_gone_ = true;
+  }
+
+ private:
+  void TimerFlush(int64 step_id) {
+    std::unique_ptr<std::vector<Item>> to_flush;
+    {
+      mutex_lock l(mu_);
+      if (!worker_gone_) {
+        auto it = pending_.find(step_id);
+        if (it != pending_.end()) {
+          to_flush = std::move(it->second);
+          pending_.erase(it);
+        }
+      }
+    }
+    if (to_flush != nullptr) {
+      flush_fn_(std::move(to_flush));
+    }
+    Unref();
+  }
+
+  static const size_t kMaxBundleSize = 64;
+
+  const FlushFn flush_fn_;  // Refers to the worker; see class comment.
+  mutex mu_;
+  bool worker_gone_ GUARDED_BY(mu_) = false;
+  std::unordered_map<int64, std::unique_ptr<std::vector<Item>>> pending_
+      GUARDED_BY(mu_);
+};
+
+}  // namespace
+
 class GrpcRemoteWorker : public WorkerInterface {
  public:
   explicit GrpcRemoteWorker(SharedGrpcChannelPtr channel,
@@ -60,15 +383,24 @@ class GrpcRemoteWorker : public WorkerInterface {
         cleanupgraph_(Method(GrpcWorkerMethod::kCleanupGraph)),
         cleanupall_(Method(GrpcWorkerMethod::kCleanupAll)),
         recvtensor_(Method(GrpcWorkerMethod::kRecvTensor)),
+        recvtensorstream_(Method(GrpcWorkerMethod::kRecvTensorStream)),
+        recvbundledtensors_(Method(GrpcWorkerMethod::kRecvBundledTensors)),
+        pushtensor_(Method(GrpcWorkerMethod::kPushTensor)),
         recvbuf_(Method(GrpcWorkerMethod::kRecvBuf)),
         logging_(Method(GrpcWorkerMethod::kLogging)),
         tracing_(Method(GrpcWorkerMethod::kTracing)),
         completegroup_(Method(GrpcWorkerMethod::kCompleteGroup)),
         instancesource_(Method(GrpcWorkerMethod::kCompleteInstance)),
         getstepsequence_(Method(GrpcWorkerMethod::kGetStepSequence)),
-        logger_(logger) {}
-
-  ~GrpcRemoteWorker() override {}
+        logger_(logger),
+        bundler_(new RecvTensorBundler(
+            [this](std::unique_ptr<std::vector<RecvTensorBundler::Item>>
+                       items) { FlushRecvTensorBundle(std::move(items)); })) {}
+
+  ~GrpcRemoteWorker() override {
+    bundler_->WorkerGone();
+    bundler_->Unref();
+  }
 
   void GetStatusAsync(const GetStatusRequest* request,
                       GetStatusResponse* response,
@@ -243,9 +575,29 @@ class GrpcRemoteWorker : public WorkerInterface {
       cb_to_use = &wrapper_done;
     }
 
+    // With bundling enabled, hold the call briefly so that other calls
+    // for the same step can share one RecvBundledTensors RPC.
+    if (RecvTensorBundlingEnabled()) {
+      bundler_->Add(request, response, *cb_to_use, call_opts);
+      return;
+    }
+    // Only host-memory tensors can be written incrementally as their
+    // content frames arrive; everything else takes the unary method.
+    if (RecvTensorStreamEnabled() && response->on_host()) {
+      new StreamingRecvTensorState(&stub_, cq_, recvtensorstream_, *request,
+                                   response, *cb_to_use, call_opts);
+      return;
+    }
     IssueRequest(request, response, recvtensor_, *cb_to_use, call_opts);
   }
 
+  void PushTensorAsync(CallOptions* call_opts,
+                       const PushTensorRequest* request,
+                       PushTensorResponse* response,
+                       StatusCallback done) override {
+    IssueRequest(request, response, pushtensor_, std::move(done), call_opts);
+  }
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override {
     IssueRequest(request, response, logging_, done);
@@ -276,6 +628,83 @@ class GrpcRemoteWorker : public WorkerInterface {
                                  callback_threadpool_, max_retries);
   }
 
+  // Issues one RecvBundledTensors RPC for a flushed bundle and scatters
+  // the per-tensor results to the original callers on completion.  A
+  // bundle of one call gains nothing from bundling and is forwarded to
+  // the regular unary method, keeping its zero-copy response encoding.
+  void FlushRecvTensorBundle(
+      std::unique_ptr<std::vector<RecvTensorBundler::Item>> items) {
+    if (items->size() == 1) {
+      RecvTensorBundler::Item* item =
+          new RecvTensorBundler::Item(std::move((*items)[0]));
+      IssueRequest(&item->request, item->response, recvtensor_,
+                   [item](const Status& s) {
+                     StatusCallback done = std::move(item->done);
+                     delete item;
+                     done(s);
+                   },
+                   item->call_opts);
+      return;
+    }
+    RecvBundledTensorsRequest* bundle_request = new RecvBundledTensorsRequest;
+    bundle_request->set_step_id((*items)[0].request.step_id());
+    bundle_request->set_request_id(GetUniqueRequestId());
+    for (const RecvTensorBundler::Item& item : *items) {
+      *bundle_request->add_requests() = item.request;
+    }
+    // Cancelling any bundled call cancels the whole RPC; in practice an
+    // abort cancels every pending call of the step anyway.
+    CallOptions* bundle_opts = new CallOptions;
+    for (const RecvTensorBundler::Item& item : *items) {
+      if (item.call_opts != nullptr) {
+        item.call_opts->SetCancelCallback(
+            [bundle_opts]() { bundle_opts->StartCancel(); });
+      }
+    }
+    RecvBundledTensorsResponse* bundle_response =
+        new RecvBundledTensorsResponse;
+    std::vector<RecvTensorBundler::Item>* items_raw = items.release();
+    IssueRequest(
+        bundle_request, bundle_response, recvbundledtensors_,
+        [items_raw, bundle_request, bundle_response,
+         bundle_opts](Status s) {
+          std::unique_ptr<std::vector<RecvTensorBundler::Item>> items(
+              items_raw);
+          for (RecvTensorBundler::Item& item : *items) {
+            if (item.call_opts != nullptr) {
+              item.call_opts->ClearCancelCallback();
+            }
+          }
+          if (s.ok() &&
+              bundle_response->results_size() !=
+                  static_cast<int>(items->size())) {
+            s = errors::Internal("RecvBundledTensors returned ",
+                                 bundle_response->results_size(),
+                                 " results for ", items->size(), " requests");
+          }
+          for (int i = 0; i < static_cast<int>(items->size()); ++i) {
+            RecvTensorBundler::Item& item = (*items)[i];
+            Status item_status = s;
+            if (s.ok()) {
+              RecvTensorBundleResult* result =
+                  bundle_response->mutable_results(i);
+              if (result->status_code() != error::OK) {
+                item_status = Status(result->status_code(),
+                                     result->status_error_message());
+              } else {
+                item_status = item.response->InitFrom(
+                    result->mutable_response());
+              }
+            }
+            item.done(item_status);
+          }
+          delete bundle_request;
+          delete bundle_response;
+          delete bundle_opts;
+        },
+        bundle_opts);
+  }
+
   // Helper function for initializing the RpcMethod objects below.
   const char* Method(GrpcWorkerMethod id) { return GrpcWorkerMethodName(id); }
 
@@ -293,6 +722,9 @@ class GrpcRemoteWorker : public WorkerInterface {
   const ::grpc::string cleanupgraph_;
   const ::grpc::string cleanupall_;
   const ::grpc::string recvtensor_;
+  const ::grpc::string recvtensorstream_;
+  const ::grpc::string recvbundledtensors_;
+  const ::grpc::string pushtensor_;
   const ::grpc::string recvbuf_;
   const ::grpc::string logging_;
   const ::grpc::string tracing_;
@@ -303,6 +735,10 @@ class GrpcRemoteWorker : public WorkerInterface {
   // Support for logging.
   WorkerCacheLogger* logger_;
 
+  // Coalesces RecvTensor calls when TF_GRPC_RECV_TENSOR_BUNDLING is set;
+  // see RecvTensorBundler for why it is reference counted.
+  RecvTensorBundler* bundler_;
+
   TF_DISALLOW_COPY_AND_ASSIGN(GrpcRemoteWorker);
 };
 
@@ -31,10 +31,23 @@ struct WorkerCacheEntry {
   ::grpc::ByteBuffer response_buf;
   Status response_status;
 
+  // For tensor-reference entries (LookupOrComputeTensor): the looked-up
+  // tensor, sharing its refcounted buffer with the original response,
+  // and its dead-ness.  Replays re-encode from here instead of keeping
+  // a serialized copy.
+  Tensor tensor;
+  bool is_dead = false;
+
+  // Bytes charged to the cache budget for this entry: the serialized
+  // length for proto entries, the tensor size for tensor entries.
+  int64 bytes = 0;
+
   // Additional retries may arrive while a request is still executing.  The
-  // callbacks for these calls are queued in `callbacks` and evaluated after
-  // the original request is completed.
+  // callbacks for these calls are queued in `callbacks` (proto entries)
+  // or `tensor_callbacks` (tensor entries) and evaluated after the
+  // original request is completed.
   std::vector<std::pair<RPCResponse, StatusCallback>> callbacks;
+  std::vector<std::pair<EncodeTensorFunc, StatusCallback>> tensor_callbacks;
 };
 
 void RPCResponse::Encode(::grpc::ByteBuffer* tgt) const {
@@ -92,6 +105,8 @@ void GrpcResponseCache::LookupOrCompute(const string& key, RPCResponse response,
       VLOG(1) << "Found expired cache entry for " << key;
       req->state = WorkerCacheEntry::State::PENDING;
       req->response_buf.Clear();
+      req->tensor = Tensor();
+      req->bytes = 0;
     }
 
     req->callbacks.push_back(std::make_pair(response, done_cb));
@@ -110,7 +125,8 @@ void GrpcResponseCache::LookupOrCompute(const string& key, RPCResponse response,
   compute_func([this, key, req, response](Status status) {
     mutex_lock m(mu_);
     response.Encode(&req->response_buf);
-    current_bytes_ += req->response_buf.Length();
+    req->bytes = req->response_buf.Length();
+    current_bytes_ += req->bytes;
 
     req->response_status = status;
     req->state = WorkerCacheEntry::State::FINISHED;
@@ -127,6 +143,81 @@ void GrpcResponseCache::LookupOrCompute(const string& key, RPCResponse response,
   });
 }
 
+void GrpcResponseCache::LookupOrComputeTensor(const string& key,
+                                              TensorComputeFunc compute_func,
+                                              EncodeTensorFunc encode_func,
+                                              StatusCallback done_cb) {
+  VLOG(1) << "Lookup " << key;
+  std::shared_ptr<WorkerCacheEntry> req;
+  MaybeCleanup();
+  {
+    mutex_lock m(mu_);
+
+    if (requests_.find(key) != requests_.end()) {
+      req = requests_[key];
+    } else {
+      req.reset(new WorkerCacheEntry);
+      requests_[key] = req;
+    }
+
+    if (req->state == WorkerCacheEntry::State::FINISHED) {
+      if (req->expires_seconds > Env::Default()->NowSeconds()) {
+        VLOG(1) << "Replay cached tensor for " << key;
+        if (req->response_status.ok()) {
+          encode_func(req->tensor, req->is_dead);
+        }
+        done_cb(req->response_status);
+        return;
+      }
+      VLOG(1) << "Found expired cache entry for " << key;
+      req->state = WorkerCacheEntry::State::PENDING;
+      req->response_buf.Clear();
+      req->tensor = Tensor();
+      req->bytes = 0;
+    }
+
+    req->tensor_callbacks.push_back(
+        std::make_pair(std::move(encode_func), std::move(done_cb)));
+
+    if (req->state == WorkerCacheEntry::State::ACTIVE) {
+      VLOG(1) << "Found active request for " << key
+              << ".  Adding entry to response queue.";
+      return;
+    }
+
+    VLOG(2) << "No cache entry for " << key << ", running user computation.";
+    req->state = WorkerCacheEntry::State::ACTIVE;
+    req->expires_seconds = Env::Default()->NowSeconds() + expire_time_seconds_;
+  }
+
+  compute_func(
+      [this, key, req](const Status& status, const Tensor& val, bool is_dead) {
+        mutex_lock m(mu_);
+        req->response_status = status;
+        if (status.ok()) {
+          // Keep a reference to the tensor rather than a serialized
+          // copy; Tensor assignment shares the refcounted buffer.
+          req->tensor = val;
+          req->is_dead = is_dead;
+          req->bytes = val.TotalBytes();
+          current_bytes_ += req->bytes;
+        }
+        req->state = WorkerCacheEntry::State::FINISHED;
+
+        VLOG(1) << "Operation for " << key << " finished. "
+                << "Status: " << status << ", " << req->bytes
+                << " tensor bytes, " << req->tensor_callbacks.size()
+                << " pending callbacks.";
+        for (auto& cb : req->tensor_callbacks) {
+          if (status.ok()) {
+            cb.first(req->tensor, req->is_dead);
+          }
+          cb.second(status);
+        }
+        req->tensor_callbacks.clear();
+      });
+}
+
 // Remove all stale or expired cache entries if the cache is full.
 void GrpcResponseCache::MaybeCleanup() {
   mutex_lock m(mu_);
@@ -169,7 +260,7 @@ void GrpcResponseCache::MaybeCleanup() {
 
     if (pair.second->state == WorkerCacheEntry::State::FINISHED) {
       kept.insert(pair);
-      bytes_used += pair.second->response_buf.Length();
+      bytes_used += pair.second->bytes;
     }
   }
 
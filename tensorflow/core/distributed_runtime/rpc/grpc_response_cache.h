@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/distributed_runtime/rpc/grpc_util.h"
+#include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/protobuf.h"
@@ -51,6 +52,15 @@ class RPCResponse {
 };
 
 typedef std::function<void(StatusCallback)> ComputeFunc;
+
+// Callback types for the tensor-reference cache path (see
+// LookupOrComputeTensor below).  TensorDoneCallback receives the
+// looked-up tensor, in host memory, and its dead-ness.
+typedef std::function<void(const Status&, const Tensor&, bool)>
+    TensorDoneCallback;
+typedef std::function<void(TensorDoneCallback)> TensorComputeFunc;
+typedef std::function<void(const Tensor&, bool)> EncodeTensorFunc;
+
 struct WorkerCacheEntry;
 
 // Track and cache the state of worker service RPCs.  An RPC can be in 3 states:
@@ -73,6 +83,17 @@ class GrpcResponseCache {
   void LookupOrCompute(const string& key, RPCResponse response,
                        ComputeFunc compute_func, StatusCallback done_cb);
 
+  // Tensor-reference variant of LookupOrCompute for RecvTensor RPCs.
+  // Instead of retaining a serialized copy of the response, the cache
+  // keeps a reference to the looked-up tensor (sharing its refcounted
+  // buffer) plus cheap metadata, and calls `encode_func` to re-encode
+  // it into gRPC slices zero-copy on every hit.  `compute_func` is
+  // invoked to produce the tensor on a miss; entries are charged to the
+  // byte budget by tensor size.
+  void LookupOrComputeTensor(const string& key, TensorComputeFunc compute_func,
+                             EncodeTensorFunc encode_func,
+                             StatusCallback done_cb);
+
   // Remove all stale or expired cache entries if the cache is full.
   void MaybeCleanup();
 
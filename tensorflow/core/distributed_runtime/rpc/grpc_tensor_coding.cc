@@ -17,6 +17,7 @@ limitations under the License.
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
+#include "tensorflow/core/framework/bfloat16.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_reference.h"
@@ -24,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/io/proto_encode_helper.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
 // (Omitted internal-only flag)
@@ -135,10 +137,45 @@ static void EncodeSkeleton(const Tensor& val, io::ProtoEncodeHelper* e) {
 #endif
 }
 
+// Compresses the raw tensor bytes in *tdata with "codec" into
+// *compression_buf, repointing *tdata at the compressed bytes.  Returns the
+// codec actually applied: TENSOR_COMPRESSION_NONE when the codec does not
+// apply to val's dtype or does not shrink the payload, in which case *tdata
+// is left untouched.
+static TensorCompressionCodec MaybeCompressTensorContent(
+    TensorCompressionCodec codec, const Tensor& val, StringPiece* tdata,
+    string* compression_buf) {
+  if (tdata->empty()) return TENSOR_COMPRESSION_NONE;
+  switch (codec) {
+    case TENSOR_COMPRESSION_SNAPPY:
+      if (!port::Snappy_Compress(tdata->data(), tdata->size(),
+                                 compression_buf) ||
+          compression_buf->size() >= tdata->size()) {
+        return TENSOR_COMPRESSION_NONE;
+      }
+      break;
+    case TENSOR_COMPRESSION_BFLOAT16: {
+      if (val.dtype() != DT_FLOAT) return TENSOR_COMPRESSION_NONE;
+      const int64 num_elements = val.NumElements();
+      compression_buf->resize(num_elements * sizeof(bfloat16));
+      FloatToBFloat16(reinterpret_cast<const float*>(tdata->data()),
+                      reinterpret_cast<bfloat16*>(&(*compression_buf)[0]),
+                      num_elements);
+      break;
+    }
+    default:
+      return TENSOR_COMPRESSION_NONE;
+  }
+  *tdata = StringPiece(*compression_buf);
+  return codec;
+}
+
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
+                              TensorCompressionCodec codec,
+                              const RecvTensorResponse& response_fields,
                               ::grpc::ByteBuffer* result) {
   const int kLargeTensorBytes = 1024;
-  RecvTensorResponse response;
+  RecvTensorResponse response = response_fields;
   if (is_dead) {
     response.set_is_dead(is_dead);
   }
@@ -159,6 +196,12 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
     EncodeSkeleton(val, &e_skeleton);
 
     StringPiece tdata = val.tensor_data();
+    string compression_buf;
+    const TensorCompressionCodec applied_codec =
+        MaybeCompressTensorContent(codec, val, &tdata, &compression_buf);
+    if (applied_codec != TENSOR_COMPRESSION_NONE) {
+      response.set_compression_codec(applied_codec);
+    }
     uint32 overall_tensor_proto_bytesize =
         (e_skeleton.size() +
          VarLengthEncodingSize(TensorProto::kTensorContentFieldNumber,
@@ -179,8 +222,12 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
     // backing store, with appropriate reference counts to keep the
     // backing store alive as needed.
     //
-    // We enable this behavior if the tensor is large.
-    bool share_tensor_slice_memory = (tdata.size() > kLargeTensorBytes);
+    // We enable this behavior if the tensor is large.  Compressed content
+    // lives in a local buffer rather than the tensor's backing store, so it
+    // is always copied.
+    bool share_tensor_slice_memory =
+        (tdata.size() > kLargeTensorBytes &&
+         applied_codec == TENSOR_COMPRESSION_NONE);
 
     // (Omitted internal-only conditional)
 
@@ -242,5 +289,34 @@ void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
   }
 }
 
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
+                              TensorCompressionCodec codec,
+                              ::grpc::ByteBuffer* result) {
+  EncodeTensorToByteBuffer(is_dead, val, codec, RecvTensorResponse(), result);
+}
+
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
+                              ::grpc::ByteBuffer* result) {
+  EncodeTensorToByteBuffer(is_dead, val, TENSOR_COMPRESSION_NONE, result);
+}
+
+void EncodeTensorContentChunkToByteBuffer(const Tensor& val, size_t offset,
+                                          size_t length,
+                                          ::grpc::ByteBuffer* result) {
+  StringPiece tdata = val.tensor_data();
+  CHECK_LE(offset + length, tdata.size());
+  // Share the backing store of "val", as in the large-tensor case of
+  // EncodeTensorToByteBuffer above.
+  const TensorBuffer* buf = DMAHelper::buffer(&val);
+  buf->Ref();
+  ::grpc::Slice slice(
+      const_cast<void*>(static_cast<const void*>(tdata.data() + offset)),
+      length,
+      [](void* backing) { static_cast<TensorBuffer*>(backing)->Unref(); },
+      const_cast<TensorBuffer*>(buf));
+  ::grpc::ByteBuffer tmp(&slice, 1);
+  result->Swap(&tmp);
+}
+
 }  // namespace grpc
 }  // namespace tensorflow
@@ -20,6 +20,8 @@ namespace grpc {
 class ByteBuffer;
 }  // namespace grpc
 
+#include "tensorflow/core/protobuf/worker.pb.h"
+
 namespace tensorflow {
 class Tensor;
 class RecvTensorResponse;
@@ -51,6 +53,33 @@ void EncodeRecvTensorResponseToByteBuffer(const RecvTensorResponse& proto,
 void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
                               ::grpc::ByteBuffer* result);
 
+// As above, but first compresses the tensor content with "codec", which
+// must be a codec the receiver advertised in
+// RecvTensorRequest.accepted_compression_codecs.  Falls back to an
+// uncompressed encoding when the codec does not apply to val's dtype or
+// does not shrink the payload.
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
+                              TensorCompressionCodec codec,
+                              ::grpc::ByteBuffer* result);
+
+// As above, but seeds the non-tensor fields of the encoded response from
+// "response_fields" (e.g. transport_options), in addition to the is_dead
+// and send_start_micros fields set here.
+void EncodeTensorToByteBuffer(bool is_dead, const Tensor& val,
+                              TensorCompressionCodec codec,
+                              const RecvTensorResponse& response_fields,
+                              ::grpc::ByteBuffer* result);
+
+// Encode "length" bytes of "val"'s content, starting at byte "offset",
+// as one raw-bytes frame of a RecvTensorStream response.  The frame
+// shares the backing store of "val" rather than copying it; *result
+// keeps the store alive until the bytes have been sent.
+//
+// Discards original contents of *result.
+void EncodeTensorContentChunkToByteBuffer(const Tensor& val, size_t offset,
+                                          size_t length,
+                                          ::grpc::ByteBuffer* result);
+
 }  // namespace grpc
 }  // namespace tensorflow
 
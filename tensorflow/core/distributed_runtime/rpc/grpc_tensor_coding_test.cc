@@ -17,10 +17,12 @@ limitations under the License.
 
 #include "grpcpp/support/byte_buffer.h"
 #include "grpcpp/support/slice.h"
+#include "tensorflow/core/framework/bfloat16.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_testutil.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/snappy.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
 
@@ -28,18 +30,24 @@ namespace tensorflow {
 
 class GrpcTensorCodingTest : public ::testing::Test {
  public:
+  // Flattens the contents of *buf into a string.
+  static string ToString(::grpc::ByteBuffer* buf) {
+    std::vector<::grpc::Slice> slices;
+    (void)buf->Dump(&slices);
+    string tmp;
+    for (const auto& s : slices) {
+      tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
+    }
+    return tmp;
+  }
+
   void Validate(const Tensor& t, bool is_dead) {
     // Check by encoding to a ByteBuffer
     ::grpc::ByteBuffer buf;
     grpc::EncodeTensorToByteBuffer(is_dead, t, &buf);
 
     // Make a string
-    std::vector<::grpc::Slice> slices;
-    (void)buf.Dump(&slices);
-    string tmp;
-    for (const auto& s : slices) {
-      tmp.append(reinterpret_cast<const char*>(s.begin()), s.size());
-    }
+    string tmp = ToString(&buf);
 
     RecvTensorResponse response;
     EXPECT_TRUE(response.ParseFromString(tmp));
@@ -100,4 +108,62 @@ TEST_F(GrpcTensorCodingTest, Simple) {
 
 TEST_F(GrpcTensorCodingTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(GrpcTensorCodingTest, SnappyCompressed) {
+  Tensor a(DT_INT32, TensorShape({1024}));
+  for (int i = 0; i < 1024; i++) {
+    a.flat<int32>()(i) = i % 4;  // Repetitive data compresses well.
+  }
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeTensorToByteBuffer(false, a, TENSOR_COMPRESSION_SNAPPY, &buf);
+  RecvTensorResponse response;
+  EXPECT_TRUE(response.ParseFromString(ToString(&buf)));
+  EXPECT_EQ(TENSOR_COMPRESSION_SNAPPY, response.compression_codec());
+  const string& content = response.tensor().tensor_content();
+  EXPECT_LT(content.size(), a.TotalBytes());
+  size_t uncompressed_length;
+  ASSERT_TRUE(port::Snappy_GetUncompressedLength(
+      content.data(), content.size(), &uncompressed_length));
+  ASSERT_EQ(a.TotalBytes(), uncompressed_length);
+  Tensor result(DT_INT32, a.shape());
+  ASSERT_TRUE(port::Snappy_Uncompress(
+      content.data(), content.size(),
+      const_cast<char*>(result.tensor_data().data())));
+  EXPECT_EQ(a.DebugString(), result.DebugString());
+}
+
+TEST_F(GrpcTensorCodingTest, Bfloat16Compressed) {
+  Tensor a(DT_FLOAT, TensorShape({256}));
+  for (int i = 0; i < 256; i++) {
+    a.flat<float>()(i) = static_cast<float>(i % 16);
+  }
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeTensorToByteBuffer(false, a, TENSOR_COMPRESSION_BFLOAT16, &buf);
+  RecvTensorResponse response;
+  EXPECT_TRUE(response.ParseFromString(ToString(&buf)));
+  EXPECT_EQ(TENSOR_COMPRESSION_BFLOAT16, response.compression_codec());
+  const string& content = response.tensor().tensor_content();
+  ASSERT_EQ(256 * sizeof(bfloat16), content.size());
+  Tensor result(DT_FLOAT, a.shape());
+  BFloat16ToFloat(reinterpret_cast<const bfloat16*>(content.data()),
+                  result.flat<float>().data(), 256);
+  test::ExpectTensorEqual<float>(a, result);  // i % 16 is bfloat16-exact.
+}
+
+// A codec that cannot be applied (wrong dtype) must fall back to an
+// uncompressed encoding.
+TEST_F(GrpcTensorCodingTest, Bfloat16FallsBackForNonFloat) {
+  Tensor a(DT_INT32, TensorShape({1024}));
+  for (int i = 0; i < 1024; i++) {
+    a.flat<int32>()(i) = i;
+  }
+  ::grpc::ByteBuffer buf;
+  grpc::EncodeTensorToByteBuffer(false, a, TENSOR_COMPRESSION_BFLOAT16, &buf);
+  RecvTensorResponse response;
+  EXPECT_TRUE(response.ParseFromString(ToString(&buf)));
+  EXPECT_EQ(TENSOR_COMPRESSION_NONE, response.compression_codec());
+  Tensor result_tensor;
+  EXPECT_TRUE(result_tensor.FromProto(response.tensor()));
+  EXPECT_EQ(a.DebugString(), result_tensor.DebugString());
+}
+
 }  // namespace tensorflow
@@ -17,6 +17,7 @@ limitations under the License.
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_RPC_GRPC_UTIL_H_
 
 #include <memory>
+#include <vector>
 
 #include "grpcpp/grpcpp.h"
 #include "grpcpp/impl/codegen/proto_utils.h"
@@ -53,6 +54,17 @@ class GrpcByteSource : public TensorResponse::Source {
     return stream_;
   }
 
+  std::function<void()> GetOwnedBufferReleaser() override {
+    // Slices are refcounted, so holding copies of them keeps the bytes of
+    // buffer_ alive even after buffer_ itself has been destroyed.
+    auto* slices = new std::vector<::grpc::Slice>;
+    if (!buffer_->Dump(slices).ok()) {
+      delete slices;
+      return nullptr;
+    }
+    return [slices] { delete slices; };
+  }
+
  private:
   void DeleteStream() {
     if (stream_) {
@@ -29,6 +29,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/local_device.h"
+#include "tensorflow/core/common_runtime/metrics.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/common_runtime/step_stats_collector.h"
 #include "tensorflow/core/distributed_runtime/graph_mgr.h"
@@ -55,6 +56,7 @@ limitations under the License.
 #include "tensorflow/core/platform/tracing.h"
 #include "tensorflow/core/protobuf/transport_options.pb.h"
 #include "tensorflow/core/protobuf/worker.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -93,6 +95,24 @@ namespace {
     ENQUEUE_REQUEST(method, supports_cancel);                                  \
   }
 
+// Frame size for RecvTensorStream content chunks.  Each chunk is sent as
+// its own gRPC message, so this bounds how much data is in flight ahead of
+// the receiver's copies and lets gRPC apply flow control per chunk.
+int64 RecvTensorStreamChunkBytes() {
+  static int64 result = [] {
+    int64 chunk_bytes;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_RECV_TENSOR_STREAM_CHUNK_BYTES",
+                                    /*default_val=*/4 << 20, &chunk_bytes));
+    return chunk_bytes;
+  }();
+  return result;
+}
+
+// Defined below: encodes a RecvTensor response, applying compression and
+// row-delta transfer when the request allows them.
+void EncodeTensorMaybeDelta(const RecvTensorRequest& request, bool is_dead,
+                            const Tensor& val, ::grpc::ByteBuffer* result);
+
 // GrpcWorkerService spawns one or more GrpcWorkerServiceThreads to service
 // requests.  Each thread operates on an independent completion queue.
 class GrpcWorkerServiceThread {
@@ -144,6 +164,8 @@ class GrpcWorkerServiceThread {
     SETUP_FOR_REQUEST(CompleteInstance, 10, true);
     SETUP_FOR_REQUEST(GetStepSequence, 10, true);
     SETUP_FOR_REQUEST(RecvBuf, 500, true);
+    SETUP_FOR_REQUEST(RecvBundledTensors, 10, true);
+    SETUP_FOR_REQUEST(PushTensor, 100, true);
     SETUP_FOR_REQUEST(RunGraph, 100, true);
     SETUP_FOR_REQUEST(CleanupGraph, 100, false);
 
@@ -156,6 +178,13 @@ class GrpcWorkerServiceThread {
          ++i) {
       EnqueueRecvTensorRequestRaw();
     }
+    for (int i = 0;
+         i < gtl::FindWithDefault(
+                 queue_depth_,
+                 static_cast<int>(GrpcWorkerMethod::kRecvTensorStream), 100);
+         ++i) {
+      EnqueueRecvTensorStreamRequest();
+    }
 
     void* tag;
     bool ok;
@@ -184,6 +213,11 @@ class GrpcWorkerServiceThread {
       Call<GrpcWorkerServiceThread, grpc::WorkerService::AsyncService,
            RequestMessage, ResponseMessage>;
 
+  using RecvTensorStreamCall =
+      ServerStreamingCall<GrpcWorkerServiceThread,
+                          grpc::WorkerService::AsyncService, RecvTensorRequest,
+                          ::grpc::ByteBuffer>;
+
   // Handle all non-cancellable simple methods with a standard wrapper.
 #define HANDLE_CALL(method)                                                   \
   void method##Handler(WorkerCall<method##Request, method##Response>* call) { \
@@ -274,22 +308,129 @@ class GrpcWorkerServiceThread {
         call->SendResponse(ToGrpcStatus(s));
       };
 
-      auto compute_fn = [this, &call_opts, &call](StatusCallback done) {
-        worker_->GrpcRecvTensorAsync(call_opts, &call->request, &call->response,
-                                     done);
-      };
-
       if (cache_) {
+        // The cache retains the looked-up (host-memory) tensor by
+        // reference rather than a serialized copy of the response, and
+        // re-encodes it zero-copy on replay.
         string request_key = call->request.ShortDebugString();
-        cache_->LookupOrCompute(request_key, RPCResponse(&call->response),
-                                compute_fn, done_cb);
+        cache_->LookupOrComputeTensor(
+            request_key,
+            [this, call_opts, call](TensorDoneCallback done) {
+              worker_->GrpcRecvTensorStreamAsync(call_opts, &call->request,
+                                                 std::move(done));
+            },
+            [call](const Tensor& val, bool is_dead) {
+              EncodeTensorMaybeDelta(call->request, is_dead, val,
+                                     &call->response);
+            },
+            done_cb);
       } else {
-        compute_fn(done_cb);
+        worker_->GrpcRecvTensorAsync(call_opts, &call->request, &call->response,
+                                     done_cb);
       }
     });
     EnqueueRecvTensorRequestRaw();
   }
 
+  void RecvTensorStreamHandler(RecvTensorStreamCall* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+      worker_->GrpcRecvTensorStreamAsync(
+          call_opts, &call->request,
+          [this, call, call_opts](const Status& s, const Tensor& val,
+                                  bool is_dead) {
+            call->ClearCancelCallback();
+            delete call_opts;
+            if (!s.ok()) {
+              VLOG(1) << "Bad response from RecvTensorStream:" << s;
+              call->Finish(ToGrpcStatus(s));
+              return;
+            }
+            StreamTensorResponse(call, val, is_dead);
+          });
+    });
+    EnqueueRecvTensorStreamRequest();
+  }
+
+  // Sends the first frame of a RecvTensorStream response.  For tensors
+  // whose content cannot be sent as raw bytes (dead tensors, string
+  // tensors) this is a complete RecvTensorResponse and the stream ends
+  // after it; otherwise it announces dtype and shape (metadata_only) and
+  // the content follows in fixed-size chunks.
+  void StreamTensorResponse(RecvTensorStreamCall* call, const Tensor& val,
+                            bool is_dead) {
+    RecvTensorResponse meta;
+    if (is_dead) {
+      meta.set_is_dead(is_dead);
+    }
+    meta.set_send_start_micros(worker_->env()->env->NowMicros());
+    if (is_dead || !DataTypeCanUseMemcpy(val.dtype())) {
+      val.AsProtoTensorContent(meta.mutable_tensor());
+      ::grpc::ByteBuffer frame;
+      grpc::EncodeRecvTensorResponseToByteBuffer(meta, &frame);
+      call->SendPartialResponse(frame, [call](bool ok) {
+        call->Finish(ok ? ::grpc::Status::OK
+                        : ::grpc::Status(::grpc::StatusCode::INTERNAL,
+                                         "RecvTensorStream write failed"));
+      });
+      return;
+    }
+    meta.set_metadata_only(true);
+    meta.mutable_tensor()->set_dtype(val.dtype());
+    val.shape().AsProto(meta.mutable_tensor()->mutable_tensor_shape());
+    ::grpc::ByteBuffer frame;
+    grpc::EncodeRecvTensorResponseToByteBuffer(meta, &frame);
+    const int64 total_bytes = static_cast<int64>(val.TotalBytes());
+    call->SendPartialResponse(frame, [this, call, val, total_bytes](bool ok) {
+      StreamTensorContentChunk(call, val, 0, total_bytes, ok);
+    });
+  }
+
+  // Writes the content chunk of "val" starting at byte "offset", then
+  // chains the next chunk behind its completion so only one chunk is ever
+  // in flight.  Capturing "val" by value keeps its buffer alive until the
+  // last chunk has been sent.
+  void StreamTensorContentChunk(RecvTensorStreamCall* call, const Tensor& val,
+                                int64 offset, int64 total_bytes, bool ok) {
+    if (!ok) {
+      call->Finish(::grpc::Status(::grpc::StatusCode::INTERNAL,
+                                  "RecvTensorStream write failed"));
+      return;
+    }
+    if (offset >= total_bytes) {
+      call->Finish(::grpc::Status::OK);
+      return;
+    }
+    const int64 len =
+        std::min(RecvTensorStreamChunkBytes(), total_bytes - offset);
+    ::grpc::ByteBuffer frame;
+    grpc::EncodeTensorContentChunkToByteBuffer(val, offset, len, &frame);
+    call->SendPartialResponse(
+        frame, [this, call, val, offset, len, total_bytes](bool ok) {
+          StreamTensorContentChunk(call, val, offset + len, total_bytes, ok);
+        });
+  }
+
+  void RecvBundledTensorsHandler(
+      WorkerCall<RecvBundledTensorsRequest, RecvBundledTensorsResponse>* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+      worker_->RecvBundledTensorsAsync(
+          call_opts, &call->request, &call->response,
+          [call, call_opts](const Status& s) {
+            call->ClearCancelCallback();
+            delete call_opts;
+            if (!s.ok()) {
+              VLOG(1) << "Bad response from RecvBundledTensors:" << s;
+            }
+            call->SendResponse(ToGrpcStatus(s));
+          });
+    });
+    ENQUEUE_REQUEST(RecvBundledTensors, true);
+  }
+
   void RecvBufHandler(WorkerCall<RecvBufRequest, RecvBufResponse>* call) {
     Schedule([this, call]() {
       CallOptions* call_opts = new CallOptions;
@@ -307,6 +448,25 @@ class GrpcWorkerServiceThread {
     ENQUEUE_REQUEST(RecvBuf, true);
   }
 
+  void PushTensorHandler(
+      WorkerCall<PushTensorRequest, PushTensorResponse>* call) {
+    Schedule([this, call]() {
+      CallOptions* call_opts = new CallOptions;
+      call->SetCancelCallback([call_opts]() { call_opts->StartCancel(); });
+      worker_->PushTensorAsync(call_opts, &call->request, &call->response,
+                               [call, call_opts](const Status& s) {
+                                 call->ClearCancelCallback();
+                                 delete call_opts;
+                                 if (!s.ok()) {
+                                   VLOG(1)
+                                       << "Bad response from PushTensor:" << s;
+                                 }
+                                 call->SendResponse(ToGrpcStatus(s));
+                               });
+    });
+    ENQUEUE_REQUEST(PushTensor, true);
+  }
+
   void CompleteGroupHandler(
       WorkerCall<CompleteGroupRequest, CompleteGroupResponse>* call) {
     Schedule([this, call]() {
@@ -359,6 +519,17 @@ class GrpcWorkerServiceThread {
     }
   }
 
+  void EnqueueRecvTensorStreamRequest() {
+    mutex_lock l(shutdown_mu_);
+    if (!is_shutdown_) {
+      RecvTensorStreamCall::EnqueueRequestForMethod(
+          worker_service_, cq_.get(),
+          static_cast<int>(GrpcWorkerMethod::kRecvTensorStream),
+          &GrpcWorkerServiceThread::RecvTensorStreamHandler,
+          true /* supports cancel*/);
+    }
+  }
+
   GrpcWorker* const worker_ = nullptr;  // Not owned.
   std::unique_ptr<::grpc::ServerCompletionQueue> cq_;
   std::unique_ptr<Thread> thread_;
@@ -438,6 +609,182 @@ GrpcWorker::GrpcWorker(WorkerEnv* worker_env, const ConfigProto& config)
               ? config.experimental().recv_buf_max_chunk()
               : (config.experimental().recv_buf_max_chunk() < 0 ? 0 : 4096)) {}
 
+namespace {
+
+// Tensors smaller than this are never compressed; the codec overhead would
+// outweigh the bytes saved.  Overridable for tuning.
+int64 TensorCompressionMinBytes() {
+  static int64 result = [] {
+    int64 min_bytes;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_TENSOR_COMPRESSION_MIN_BYTES",
+                                    /*default_val=*/16 << 10, &min_bytes));
+    return min_bytes;
+  }();
+  return result;
+}
+
+// Picks the codec for returning "val" to a client that advertised the
+// codecs in request.accepted_compression_codecs.  Prefers bfloat16
+// truncation for float32 tensors (the client opted into the precision
+// loss by advertising it) and falls back to lossless snappy.
+TensorCompressionCodec ChooseTensorCompressionCodec(
+    const RecvTensorRequest& request, const Tensor& val) {
+  if (request.accepted_compression_codecs().empty() ||
+      !DataTypeCanUseMemcpy(val.dtype()) ||
+      static_cast<int64>(val.TotalBytes()) < TensorCompressionMinBytes()) {
+    return TENSOR_COMPRESSION_NONE;
+  }
+  bool snappy_ok = false;
+  bool bfloat16_ok = false;
+  for (int codec : request.accepted_compression_codecs()) {
+    if (codec == TENSOR_COMPRESSION_SNAPPY) snappy_ok = true;
+    if (codec == TENSOR_COMPRESSION_BFLOAT16) bfloat16_ok = true;
+  }
+  if (bfloat16_ok && val.dtype() == DT_FLOAT) {
+    return TENSOR_COMPRESSION_BFLOAT16;
+  }
+  if (snappy_ok) {
+    return TENSOR_COMPRESSION_SNAPPY;
+  }
+  return TENSOR_COMPRESSION_NONE;
+}
+
+// Remembers the last tensor value sent for each rendezvous key to a
+// client that accepts row deltas, so that the next send for the same key
+// can transmit only the rows that changed.  Values are deep copies; the
+// cache must not alias buffers the runtime may reuse.
+class TensorDeltaCache {
+ public:
+  static TensorDeltaCache* Get() {
+    static TensorDeltaCache* cache = new TensorDeltaCache;
+    return cache;
+  }
+
+  bool Lookup(const string& key, int64* version, Tensor* value) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *version = it->second.version;
+    *value = it->second.value;
+    return true;
+  }
+
+  // Records a deep copy of "value" as the latest tensor sent for "key"
+  // and returns the version assigned to it, or 0 if the cache is full.
+  int64 Record(const string& key, const Tensor& value) {
+    Tensor copy(cpu_allocator(), value.dtype(), value.shape());
+    if (copy.TotalBytes() > 0) {
+      memcpy(DMAHelper::base(&copy), value.tensor_data().data(),
+             copy.TotalBytes());
+    }
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) {
+      if (entries_.size() >= kMaxEntries) return 0;
+      it = entries_.emplace(key, Entry()).first;
+    }
+    it->second.version = ++next_version_;
+    it->second.value = std::move(copy);
+    return it->second.version;
+  }
+
+ private:
+  struct Entry {
+    int64 version = 0;
+    Tensor value;
+  };
+
+  static const size_t kMaxEntries = 256;
+
+  mutex mu_;
+  int64 next_version_ GUARDED_BY(mu_) = 0;
+  std::unordered_map<string, Entry> entries_ GUARDED_BY(mu_);
+};
+
+// Encodes "val" into *result for the client behind "request".  When the
+// client accepts row deltas and advertises the version of the tensor this
+// process last sent for the key, only rows that differ from that base are
+// transmitted (with their indices in a RecvTensorDeltaInfo); whenever the
+// delta would not be smaller, or versions do not match, the full tensor
+// is sent along with a fresh version for the client to cache.
+void EncodeTensorMaybeDelta(const RecvTensorRequest& request, bool is_dead,
+                            const Tensor& val, ::grpc::ByteBuffer* result) {
+  const TensorCompressionCodec codec =
+      ChooseTensorCompressionCodec(request, val);
+  if (!request.accept_tensor_delta() || is_dead ||
+      !DataTypeCanUseMemcpy(val.dtype()) || val.dims() < 1 ||
+      val.NumElements() == 0) {
+    grpc::EncodeTensorToByteBuffer(is_dead, val, codec, result);
+    return;
+  }
+  TensorDeltaCache* cache = TensorDeltaCache::Get();
+  const string& key = request.rendezvous_key();
+  int64 base_version = 0;
+  Tensor base;
+  if (request.delta_base_version() != 0 &&
+      cache->Lookup(key, &base_version, &base) &&
+      base_version == request.delta_base_version() &&
+      base.dtype() == val.dtype() && base.shape() == val.shape()) {
+    const int64 num_rows = val.dim_size(0);
+    const int64 bytes_per_row = val.TotalBytes() / num_rows;
+    const char* new_data = val.tensor_data().data();
+    const char* old_data = base.tensor_data().data();
+    std::vector<int64> dirty_rows;
+    for (int64 r = 0; r < num_rows; ++r) {
+      if (memcmp(new_data + r * bytes_per_row, old_data + r * bytes_per_row,
+                 bytes_per_row) != 0) {
+        dirty_rows.push_back(r);
+      }
+    }
+    const int64 delta_bytes =
+        static_cast<int64>(dirty_rows.size()) *
+        (bytes_per_row + static_cast<int64>(sizeof(int64)));
+    if (delta_bytes < static_cast<int64>(val.TotalBytes())) {
+      // An unchanged tensor reuses the version the client already holds
+      // instead of recording a new cache entry, so steady-state re-fetches
+      // of a variable that changes only every few steps cost no copy and no
+      // version churn on either side.
+      const int64 version =
+          dirty_rows.empty() ? base_version : cache->Record(key, val);
+      if (version != 0) {
+        TensorShape rows_shape = val.shape();
+        rows_shape.set_dim(0, dirty_rows.size());
+        Tensor rows(cpu_allocator(), val.dtype(), rows_shape);
+        char* rows_data = reinterpret_cast<char*>(DMAHelper::base(&rows));
+        RecvTensorDeltaInfo info;
+        info.set_is_delta(true);
+        info.set_base_version(base_version);
+        info.set_version(version);
+        for (size_t i = 0; i < dirty_rows.size(); ++i) {
+          memcpy(rows_data + i * bytes_per_row,
+                 new_data + dirty_rows[i] * bytes_per_row, bytes_per_row);
+          info.add_row_indices(dirty_rows[i]);
+        }
+        RecvTensorResponse response_fields;
+        response_fields.mutable_transport_options()->PackFrom(info);
+        grpc::EncodeTensorToByteBuffer(
+            false /* is_dead */, rows,
+            ChooseTensorCompressionCodec(request, rows), response_fields,
+            result);
+        return;
+      }
+    }
+  }
+  // Full send, versioned so the client can be sent a delta next time.
+  const int64 version = cache->Record(key, val);
+  if (version == 0) {
+    grpc::EncodeTensorToByteBuffer(is_dead, val, codec, result);
+    return;
+  }
+  RecvTensorDeltaInfo info;
+  info.set_version(version);
+  RecvTensorResponse response_fields;
+  response_fields.mutable_transport_options()->PackFrom(info);
+  grpc::EncodeTensorToByteBuffer(is_dead, val, codec, response_fields, result);
+}
+
+}  // namespace
+
 // GrpcRecvTensorAsync: unlike the other Worker methods, which use protocol
 // buffers for a response object, to avoid extra protocol buffer serialization
 // overhead we generate our response directly into a ::grpc::ByteBuffer object
@@ -445,6 +792,7 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
                                      const RecvTensorRequest* request,
                                      ::grpc::ByteBuffer* response,
                                      StatusCallback done) {
+  metrics::RecordWorkerRecvTensor();
   Status s = recent_request_ids_.TrackUnique(
       request->request_id(), "RecvTensor (GrpcWorker)", *request);
   if (!s.ok()) {
@@ -503,10 +851,10 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
                   << " gpu_info: " << src_dev->tensorflow_gpu_device_info();
               // "val" is on an accelerator device. Uses the device_context to
               // fill the copy on host.
-              StatusCallback copy_ready = [response, done, copy,
+              StatusCallback copy_ready = [request, response, done, copy,
                                            is_dead](const Status& s) {
                 // The value is now ready to be returned on the wire.
-                grpc::EncodeTensorToByteBuffer(is_dead, *copy, response);
+                EncodeTensorMaybeDelta(*request, is_dead, *copy, response);
                 done(s);
                 delete copy;
               };
@@ -514,7 +862,7 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
               send_dev_context->CopyDeviceTensorToCPU(
                   &val, request->rendezvous_key(), src_dev, copy, copy_ready);
             } else {
-              grpc::EncodeTensorToByteBuffer(is_dead, val, response);
+              EncodeTensorMaybeDelta(*request, is_dead, val, response);
               done(Status::OK());
             }
           }
@@ -525,6 +873,216 @@ void GrpcWorker::GrpcRecvTensorAsync(CallOptions* opts,
       });
 }
 
+// GrpcRecvTensorStreamAsync: looks up the tensor for a RecvTensorStream
+// call just like GrpcRecvTensorAsync, but instead of serializing it into a
+// single ::grpc::ByteBuffer hands the (host-memory) tensor back to the
+// caller, which streams its content in fixed-size chunks.
+void GrpcWorker::GrpcRecvTensorStreamAsync(CallOptions* opts,
+                                           const RecvTensorRequest* request,
+                                           StreamedTensorCallback done) {
+  Status s = recent_request_ids_.TrackUnique(
+      request->request_id(), "RecvTensorStream (GrpcWorker)", *request);
+  if (!s.ok()) {
+    done(s, Tensor(), false);
+    return;
+  }
+
+  const int64 step_id = request->step_id();
+  const string& key = request->rendezvous_key();
+  TRACEPRINTF("RecvTensorStream: %lld %s", step_id, key.c_str());
+  Rendezvous::ParsedKey parsed;
+  s = Rendezvous::ParseKey(key, &parsed);
+  Device* src_dev = nullptr;
+  if (s.ok()) {
+    s = PrepareRecvTensor(parsed, &src_dev);
+  }
+  if (!s.ok()) {
+    done(s, Tensor(), false);
+    return;
+  }
+
+  // As in GrpcRecvTensorAsync, log cancellations but do not abort the
+  // current step, to preserve the opportunity for client side retries.
+  opts->SetCancelCallback([step_id]() {
+    LOG(WARNING) << "RecvTensorStream cancelled for " << step_id;
+  });
+  env_->rendezvous_mgr->RecvLocalAsync(
+      step_id, parsed,
+      [opts, done, src_dev, request](const Status& status,
+                                     const Rendezvous::Args& send_args,
+                                     const Rendezvous::Args& recv_args,
+                                     const Tensor& val, const bool is_dead) {
+        opts->ClearCancelCallback();
+        if (!status.ok()) {
+          done(status, Tensor(), false);
+          return;
+        }
+        const bool on_host = send_args.alloc_attrs.on_host();
+        if (src_dev->tensorflow_gpu_device_info() && (!on_host)) {
+          DeviceContext* send_dev_context = send_args.device_context;
+          AllocatorAttributes alloc_attrs;
+          alloc_attrs.set_gpu_compatible(true);
+          alloc_attrs.set_on_host(true);
+          Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
+          Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
+          CHECK(send_dev_context)
+              << "send dev name: " << src_dev->name()
+              << " gpu_info: " << src_dev->tensorflow_gpu_device_info();
+          // "val" is on an accelerator device.  Bring a copy to host
+          // memory before it can be streamed out.
+          send_dev_context->CopyDeviceTensorToCPU(
+              &val, request->rendezvous_key(), src_dev, copy,
+              [done, copy, is_dead](const Status& s) {
+                done(s, *copy, is_dead);
+                delete copy;
+              });
+        } else {
+          done(Status::OK(), val, is_dead);
+        }
+      });
+}
+
+namespace {
+
+// Records a per-tensor failure in one entry of a
+// RecvBundledTensorsResponse.
+void SetBundleItemError(const Status& s, RecvTensorBundleResult* result) {
+  result->set_status_code(s.code());
+  result->set_status_error_message(s.error_message());
+}
+
+}  // namespace
+
+// RecvBundledTensorsAsync: looks up every bundled transfer concurrently
+// and completes when the last one has been serialized into its response
+// entry.  Unlike GrpcRecvTensorAsync there is no ByteBuffer shortcut here:
+// tensors are serialized as ordinary protos, which is acceptable because
+// bundling targets steps that move many small tensors, where per-RPC
+// overhead rather than serialization dominates.
+void GrpcWorker::RecvBundledTensorsAsync(
+    CallOptions* opts, const RecvBundledTensorsRequest* request,
+    RecvBundledTensorsResponse* response, StatusCallback done) {
+  Status s = recent_request_ids_.TrackUnique(
+      request->request_id(), "RecvBundledTensors (GrpcWorker)", *request);
+  if (!s.ok()) {
+    done(s);
+    return;
+  }
+
+  const int num_tensors = request->requests_size();
+  if (num_tensors == 0) {
+    done(Status::OK());
+    return;
+  }
+  const int64 step_id = request->step_id();
+  TRACEPRINTF("RecvBundledTensors: %lld %d tensors", step_id, num_tensors);
+  // Size the results up front so the concurrent lookups below can fill
+  // their entries by index, in whatever order they complete.
+  for (int i = 0; i < num_tensors; ++i) {
+    response->add_results();
+  }
+
+  // As in GrpcRecvTensorAsync, log cancellations but do not abort the
+  // current step, to preserve the opportunity for client side retries.
+  opts->SetCancelCallback([step_id]() {
+    LOG(WARNING) << "RecvBundledTensors cancelled for " << step_id;
+  });
+
+  // Completion counter shared by the per-tensor lookups; the RPC is done
+  // when the last one finishes.
+  struct BundleState {
+    mutex mu;
+    int pending;
+    StatusCallback done;
+  };
+  BundleState* state = new BundleState;
+  state->pending = num_tensors;
+  state->done = std::move(done);
+  auto finish_one = [state, opts]() {
+    bool last = false;
+    {
+      mutex_lock l(state->mu);
+      last = (--state->pending == 0);
+    }
+    if (last) {
+      opts->ClearCancelCallback();
+      StatusCallback done = std::move(state->done);
+      delete state;
+      done(Status::OK());
+    }
+  };
+
+  for (int i = 0; i < num_tensors; ++i) {
+    const RecvTensorRequest* item_request = &request->requests(i);
+    RecvTensorBundleResult* result = response->mutable_results(i);
+    if (item_request->step_id() != step_id) {
+      SetBundleItemError(
+          errors::InvalidArgument("RecvBundledTensors: bundled request for "
+                                  "step ",
+                                  item_request->step_id(),
+                                  " in a bundle for step ", step_id),
+          result);
+      finish_one();
+      continue;
+    }
+    Rendezvous::ParsedKey parsed;
+    Status item_status =
+        Rendezvous::ParseKey(item_request->rendezvous_key(), &parsed);
+    Device* src_dev = nullptr;
+    if (item_status.ok()) {
+      item_status = PrepareRecvTensor(parsed, &src_dev);
+    }
+    if (!item_status.ok()) {
+      SetBundleItemError(item_status, result);
+      finish_one();
+      continue;
+    }
+    env_->rendezvous_mgr->RecvLocalAsync(
+        step_id, parsed,
+        [this, item_request, result, src_dev, finish_one](
+            const Status& status, const Rendezvous::Args& send_args,
+            const Rendezvous::Args& recv_args, const Tensor& val,
+            const bool is_dead) {
+          if (!status.ok()) {
+            SetBundleItemError(status, result);
+            finish_one();
+            return;
+          }
+          RecvTensorResponse* item = result->mutable_response();
+          item->set_is_dead(is_dead);
+          item->set_send_start_micros(env_->env->NowMicros());
+          const bool on_host = send_args.alloc_attrs.on_host();
+          if (src_dev->tensorflow_gpu_device_info() && (!on_host)) {
+            DeviceContext* send_dev_context = send_args.device_context;
+            AllocatorAttributes alloc_attrs;
+            alloc_attrs.set_gpu_compatible(true);
+            alloc_attrs.set_on_host(true);
+            Allocator* alloc = src_dev->GetAllocator(alloc_attrs);
+            Tensor* copy = new Tensor(alloc, val.dtype(), val.shape());
+            CHECK(send_dev_context)
+                << "send dev name: " << src_dev->name()
+                << " gpu_info: " << src_dev->tensorflow_gpu_device_info();
+            // "val" is on an accelerator device.  Bring a copy to host
+            // memory before it can be serialized.
+            send_dev_context->CopyDeviceTensorToCPU(
+                &val, item_request->rendezvous_key(), src_dev, copy,
+                [result, item, copy, finish_one](const Status& s) {
+                  if (s.ok()) {
+                    copy->AsProtoTensorContent(item->mutable_tensor());
+                  } else {
+                    SetBundleItemError(s, result);
+                  }
+                  delete copy;
+                  finish_one();
+                });
+          } else {
+            val.AsProtoTensorContent(item->mutable_tensor());
+            finish_one();
+          }
+        });
+  }
+}
+
 namespace {
 // If RecvBufRespExtra.tensor_content is a single large string, then gRPC
 // can stall on the recv side when the string buffer needs to be enlarged,
@@ -45,6 +45,26 @@ class GrpcWorker : public Worker {
                                    ::grpc::ByteBuffer* response,
                                    StatusCallback done);
 
+  // Callback for GrpcRecvTensorStreamAsync: receives the looked-up tensor
+  // (in host memory) and its dead-ness, or a non-OK status.
+  typedef std::function<void(const Status&, const Tensor&, bool)>
+      StreamedTensorCallback;
+
+  // Variant of GrpcRecvTensorAsync for the server-streaming
+  // RecvTensorStream method: instead of serializing the tensor here, hands
+  // it back to the caller, which streams its content in fixed-size chunks.
+  virtual void GrpcRecvTensorStreamAsync(CallOptions* opts,
+                                         const RecvTensorRequest* request,
+                                         StreamedTensorCallback done);
+
+  // Serves several coalesced RecvTensor transfers for one step.  The RPC
+  // fails only if the bundle itself is malformed; per-tensor lookup
+  // failures are recorded in the corresponding response entries.
+  virtual void RecvBundledTensorsAsync(CallOptions* opts,
+                                       const RecvBundledTensorsRequest* request,
+                                       RecvBundledTensorsResponse* response,
+                                       StatusCallback done);
+
   virtual void LoggingAsync(const LoggingRequest* request,
                             LoggingResponse* response, StatusCallback done);
 
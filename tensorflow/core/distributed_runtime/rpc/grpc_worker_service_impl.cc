@@ -58,6 +58,12 @@ const char* GrpcWorkerMethodName(GrpcWorkerMethod id) {
       return "/tensorflow.WorkerService/CompleteInstance";
     case GrpcWorkerMethod::kGetStepSequence:
       return "/tensorflow.WorkerService/GetStepSequence";
+    case GrpcWorkerMethod::kRecvTensorStream:
+      return "/tensorflow.WorkerService/RecvTensorStream";
+    case GrpcWorkerMethod::kRecvBundledTensors:
+      return "/tensorflow.WorkerService/RecvBundledTensors";
+    case GrpcWorkerMethod::kPushTensor:
+      return "/tensorflow.WorkerService/PushTensor";
   }
   // Shouldn't be reached.
   LOG(FATAL) << "Invalid id: this line shouldn't be reached.";
@@ -68,9 +74,13 @@ namespace grpc {
 
 WorkerService::AsyncService::AsyncService() {
   for (int i = 0; i < kGrpcNumWorkerMethods; ++i) {
+    const GrpcWorkerMethod method = static_cast<GrpcWorkerMethod>(i);
     AddMethod(new ::grpc::internal::RpcServiceMethod(
-        GrpcWorkerMethodName(static_cast<GrpcWorkerMethod>(i)),
-        ::grpc::internal::RpcMethod::NORMAL_RPC, nullptr));
+        GrpcWorkerMethodName(method),
+        method == GrpcWorkerMethod::kRecvTensorStream
+            ? ::grpc::internal::RpcMethod::SERVER_STREAMING
+            : ::grpc::internal::RpcMethod::NORMAL_RPC,
+        nullptr));
     ::grpc::Service::MarkMethodAsync(i);
   }
 }
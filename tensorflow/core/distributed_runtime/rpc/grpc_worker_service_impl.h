@@ -87,10 +87,13 @@ enum class GrpcWorkerMethod {
   kCompleteGroup,
   kCompleteInstance,
   kGetStepSequence,
+  kRecvTensorStream,
+  kRecvBundledTensors,
+  kPushTensor,
 };
 
 static const int kGrpcNumWorkerMethods =
-    static_cast<int>(GrpcWorkerMethod::kGetStepSequence) + 1;
+    static_cast<int>(GrpcWorkerMethod::kPushTensor) + 1;
 
 const char* GrpcWorkerMethodName(GrpcWorkerMethod id);
 
@@ -107,7 +110,9 @@ class WorkerService final {
     AsyncService();
     virtual ~AsyncService();
 
-    // Make RequestAsyncUnary public for grpc_call.h
+    // Make RequestAsyncUnary and RequestAsyncServerStreaming public for
+    // grpc_call.h
+    using ::grpc::Service::RequestAsyncServerStreaming;
     using ::grpc::Service::RequestAsyncUnary;
   };
 };
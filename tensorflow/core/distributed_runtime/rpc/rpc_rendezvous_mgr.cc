@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/rpc/rpc_rendezvous_mgr.h"
 
+#include <queue>
+#include <tuple>
+#include <unordered_map>
 #include <unordered_set>
 
 #include "tensorflow/core/common_runtime/device.h"
@@ -22,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/dma_helper.h"
 #include "tensorflow/core/common_runtime/process_util.h"
 #include "tensorflow/core/distributed_runtime/request_id.h"
+#include "tensorflow/core/distributed_runtime/scheduler.h"
 #include "tensorflow/core/distributed_runtime/tensor_coding.h"
 #include "tensorflow/core/distributed_runtime/worker_cache.h"
 #include "tensorflow/core/distributed_runtime/worker_interface.h"
@@ -32,11 +36,254 @@ limitations under the License.
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/protobuf/transport_options.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
 
+// Codecs this process advertises in RecvTensorRequest, letting the remote
+// worker compress tensor content on the wire.  Configured with
+// TF_GRPC_TENSOR_COMPRESSION as a comma-separated list of codec names,
+// e.g. "snappy" or "snappy,bfloat16".  Note that bfloat16 truncates
+// float32 tensors and is therefore lossy; listing it opts in to that.
+const std::vector<TensorCompressionCodec>& AcceptedTensorCompressionCodecs() {
+  static const std::vector<TensorCompressionCodec>* codecs = [] {
+    auto* result = new std::vector<TensorCompressionCodec>;
+    const char* env = getenv("TF_GRPC_TENSOR_COMPRESSION");
+    if (env != nullptr) {
+      for (const string& name : str_util::Split(env, ',')) {
+        if (name == "snappy") {
+          result->push_back(TENSOR_COMPRESSION_SNAPPY);
+        } else if (name == "bfloat16") {
+          result->push_back(TENSOR_COMPRESSION_BFLOAT16);
+        } else if (!name.empty()) {
+          LOG(WARNING) << "Unknown codec in TF_GRPC_TENSOR_COMPRESSION: "
+                       << name;
+        }
+      }
+    }
+    return result;
+  }();
+  return *codecs;
+}
+
+// Experimental: pre-allocate RecvTensor destination buffers from shapes
+// seen in earlier steps, so that wire data is parsed directly into place
+// instead of into a buffer allocated on the arrival path.
+bool PreAllocateRecvTensorsEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_RECV_PREALLOCATE_TENSORS",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Records the dtype and shape of the most recent tensor received for
+// each rendezvous key.  Recv shapes are usually stable across steps, so
+// the next RecvTensor call for the same key can allocate its destination
+// tensor before issuing the RPC and let TensorResponse parse the wire
+// data directly into it.  A stale entry merely wastes one speculative
+// allocation: TensorResponse ignores a pre-allocated tensor that does
+// not match the incoming dtype and shape, and a subsequent successful
+// receive overwrites the entry.
+class RecvTensorShapeCache {
+ public:
+  static RecvTensorShapeCache* Get() {
+    static RecvTensorShapeCache* cache = new RecvTensorShapeCache;
+    return cache;
+  }
+
+  bool Lookup(const string& key, DataType* dtype, TensorShape* shape) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *dtype = it->second.first;
+    *shape = it->second.second;
+    return true;
+  }
+
+  void Record(const string& key, DataType dtype, const TensorShape& shape) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      it->second = std::make_pair(dtype, shape);
+    } else if (entries_.size() < kMaxEntries) {
+      entries_.emplace(key, std::make_pair(dtype, shape));
+    }
+  }
+
+ private:
+  static const size_t kMaxEntries = 4096;
+
+  mutex mu_;
+  std::unordered_map<string, std::pair<DataType, TensorShape>> entries_
+      GUARDED_BY(mu_);
+};
+
+// Experimental: cache the last full tensor received for each rendezvous
+// key and let the sender transmit only the rows that changed since then.
+// This cuts egress drastically for large embedding tables of which few
+// rows change per step, at the cost of keeping a host-memory copy of each
+// cached tensor on both sides of the connection.
+bool RecvTensorDeltaEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_RECV_TENSOR_DELTA",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Client-side peer of the sender's delta cache: the full value and
+// version of the last tensor received for each rendezvous key.  Values
+// are deep copies, since the tensors handed to consumers may have their
+// buffers reused downstream (e.g. by forwarding into in-place ops).
+class RecvTensorDeltaCache {
+ public:
+  static RecvTensorDeltaCache* Get() {
+    static RecvTensorDeltaCache* cache = new RecvTensorDeltaCache;
+    return cache;
+  }
+
+  bool Lookup(const string& key, int64* version, Tensor* value) {
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it == entries_.end()) return false;
+    *version = it->second.version;
+    *value = it->second.value;
+    return true;
+  }
+
+  void Record(const string& key, int64 version, const Tensor& value) {
+    Tensor copy(cpu_allocator(), value.dtype(), value.shape());
+    if (copy.TotalBytes() > 0) {
+      memcpy(DMAHelper::base(&copy), value.tensor_data().data(),
+             copy.TotalBytes());
+    }
+    mutex_lock l(mu_);
+    auto it = entries_.find(key);
+    if (it != entries_.end()) {
+      it->second.version = version;
+      it->second.value = std::move(copy);
+    } else if (entries_.size() < kMaxEntries) {
+      entries_.emplace(key, Entry{version, std::move(copy)});
+    }
+  }
+
+ private:
+  struct Entry {
+    int64 version;
+    Tensor value;
+  };
+
+  static const size_t kMaxEntries = 256;
+
+  mutex mu_;
+  std::unordered_map<string, Entry> entries_ GUARDED_BY(mu_);
+};
+
+// Experimental: issue RecvTensor RPCs in slack order, so that transfers
+// on the critical path are not head-of-line-blocked behind bulk
+// transfers on the same channel.  Priorities come from the
+// TransferPriorities registry, which GraphMgr fills from SlackAnalysis
+// over measured step times.
+bool SlackTransferSchedulingEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_SLACK_TRANSFER_SCHEDULING",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Maximum number of prioritized transfers in flight per remote worker
+// before further ones queue behind the most critical.
+int64 SlackTransfersInFlight() {
+  static int64 result = [] {
+    int64 in_flight;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRPC_SLACK_TRANSFERS_IN_FLIGHT",
+                                    /*default_val=*/4, &in_flight));
+    return in_flight;
+  }();
+  return result;
+}
+
+// Orders the issue of RecvTensor RPCs by slack.  Each remote worker gets
+// a bounded window of in-flight prioritized transfers; when the window
+// is full, further transfers queue and are issued lowest-slack-first as
+// in-flight ones complete.  Transfers without a recorded priority (e.g.
+// before the first cost model is built) bypass the scheduler entirely,
+// so warmup behavior is unchanged.
+class TransferIssueScheduler {
+ public:
+  static TransferIssueScheduler* Get() {
+    static TransferIssueScheduler* scheduler = new TransferIssueScheduler;
+    return scheduler;
+  }
+
+  // Runs "start" now if the window for "worker" has room, otherwise
+  // queues it for TransferDone() to issue later.
+  void ScheduleTransfer(const string& worker, int64 priority,
+                        std::function<void()> start) {
+    {
+      mutex_lock l(mu_);
+      WorkerState& state = workers_[worker];
+      if (state.in_flight >= SlackTransfersInFlight()) {
+        state.queue.push(Pending{priority, next_seq_++, std::move(start)});
+        return;
+      }
+      state.in_flight++;
+    }
+    start();
+  }
+
+  // Marks one transfer for "worker" complete and issues the most
+  // critical queued one, if any.
+  void TransferDone(const string& worker) {
+    std::function<void()> next;
+    {
+      mutex_lock l(mu_);
+      WorkerState& state = workers_[worker];
+      if (!state.queue.empty()) {
+        next = std::move(const_cast<Pending&>(state.queue.top()).start);
+        state.queue.pop();
+      } else {
+        state.in_flight--;
+      }
+    }
+    if (next != nullptr) {
+      next();
+    }
+  }
+
+ private:
+  struct Pending {
+    int64 priority;
+    int64 seq;  // Breaks ties in arrival order.
+    std::function<void()> start;
+
+    bool operator>(const Pending& other) const {
+      return std::tie(priority, seq) > std::tie(other.priority, other.seq);
+    }
+  };
+
+  struct WorkerState {
+    int64 in_flight = 0;
+    std::priority_queue<Pending, std::vector<Pending>, std::greater<Pending>>
+        queue;
+  };
+
+  mutex mu_;
+  int64 next_seq_ GUARDED_BY(mu_) = 0;
+  std::unordered_map<string, WorkerState> workers_ GUARDED_BY(mu_);
+};
+
 class RpcRemoteRendezvous : public BaseRemoteRendezvous {
  public:
   RpcRemoteRendezvous(const WorkerEnv* env, int64 step_id)
@@ -69,6 +316,23 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     req_.set_step_id(step_id);
     req_.set_rendezvous_key(key.data(), key.size());
     req_.set_request_id(GetUniqueRequestId());
+    // Only advertise compression for host-memory receives; the device
+    // response path cannot decompress.
+    if (dst_device->attributes().device_type() == "CPU" ||
+        alloc_attrs.on_host()) {
+      for (TensorCompressionCodec codec : AcceptedTensorCompressionCodecs()) {
+        req_.add_accepted_compression_codecs(codec);
+      }
+      if (RecvTensorDeltaEnabled()) {
+        req_.set_accept_tensor_delta(true);
+        int64 version;
+        Tensor unused;
+        if (RecvTensorDeltaCache::Get()->Lookup(req_.rendezvous_key(),
+                                                &version, &unused)) {
+          req_.set_delta_base_version(version);
+        }
+      }
+    }
   }
 
   void Reset() {
@@ -83,6 +347,8 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     // opts_ appropriately.
     req_.Clear();
     resp_.Clear();
+    delta_full_tensor_ = Tensor();
+    delta_reconstructed_ = false;
     {
       mutex_lock l(mu_);
       status_ = Status::OK();
@@ -122,7 +388,9 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     wi_ = nullptr;
   }
 
-  const Tensor& tensor() const { return resp_.tensor(); }
+  const Tensor& tensor() const {
+    return delta_reconstructed_ ? delta_full_tensor_ : resp_.tensor();
+  }
 
   bool is_dead() const { return resp_.metadata().is_dead(); }
 
@@ -134,8 +402,23 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   friend class RpcRemoteRendezvous;
 
   // Start the main RecvTensor call, checking for an async abort.
+  // Returns true if the received tensor will land in host memory, in
+  // which case TensorResponse can parse into a pre-allocated buffer.
+  bool recv_on_host() const {
+    return dst_device_->attributes().device_type() == "CPU" ||
+           alloc_attrs_.on_host();
+  }
+
   void StartRTCall(std::function<void()> recv_done) {
     resp_.InitAlloc(dst_device_, alloc_attrs_);
+    if (PreAllocateRecvTensorsEnabled() && recv_on_host()) {
+      DataType dtype;
+      TensorShape shape;
+      if (RecvTensorShapeCache::Get()->Lookup(req_.rendezvous_key(), &dtype,
+                                              &shape)) {
+        resp_.PreAllocate(dtype, shape);
+      }
+    }
     using namespace std::placeholders;
     StatusCallback cb = std::bind(
         [this](std::function<void()> recv_done,
@@ -144,6 +427,20 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
           if (!s.ok()) {
             mutex_lock l(mu_);
             status_.Update(s);
+          } else {
+            if (req_.accept_tensor_delta()) {
+              Status delta_status = ProcessDeltaResponse();
+              if (!delta_status.ok()) {
+                mutex_lock l(mu_);
+                status_.Update(delta_status);
+              }
+            }
+            if (PreAllocateRecvTensorsEnabled() && recv_on_host() &&
+                !resp_.metadata().is_dead() &&
+                DataTypeCanUseMemcpy(tensor().dtype())) {
+              RecvTensorShapeCache::Get()->Record(
+                  req_.rendezvous_key(), tensor().dtype(), tensor().shape());
+            }
           }
           recv_done();
         },
@@ -151,6 +448,74 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
     wi_->RecvTensorAsync(&opts_, &req_, &resp_, std::move(cb));
   }
 
+  // Delta-transfer bookkeeping after a successful receive: caches full
+  // tensors so the sender's next response for this key can carry only
+  // changed rows, and reconstructs the full value when this response is
+  // such a delta.
+  Status ProcessDeltaResponse() {
+    if (resp_.metadata().is_dead() ||
+        !resp_.metadata().has_transport_options()) {
+      return Status::OK();
+    }
+    RecvTensorDeltaInfo info;
+    if (!resp_.metadata().transport_options().UnpackTo(&info)) {
+      // Options for some other transport feature.
+      return Status::OK();
+    }
+    const string& key = req_.rendezvous_key();
+    if (!info.is_delta()) {
+      if (DataTypeCanUseMemcpy(resp_.tensor().dtype()) &&
+          info.version() != 0) {
+        RecvTensorDeltaCache::Get()->Record(key, info.version(),
+                                            resp_.tensor());
+      }
+      return Status::OK();
+    }
+    int64 base_version = 0;
+    Tensor base;
+    if (!RecvTensorDeltaCache::Get()->Lookup(key, &base_version, &base) ||
+        base_version != info.base_version()) {
+      return errors::Internal(
+          "RecvTensor delta received for unknown base version ",
+          info.base_version(), " of key ", key);
+    }
+    const Tensor& rows = resp_.tensor();
+    if (base.dims() < 1 || base.dim_size(0) == 0 ||
+        rows.dtype() != base.dtype() || rows.dims() != base.dims()) {
+      return errors::Internal("RecvTensor delta does not match base for key ",
+                              key);
+    }
+    const int64 num_rows = base.dim_size(0);
+    const int64 bytes_per_row = base.TotalBytes() / num_rows;
+    if (rows.dim_size(0) != info.row_indices_size() ||
+        static_cast<int64>(rows.TotalBytes()) !=
+            info.row_indices_size() * bytes_per_row) {
+      return errors::Internal("RecvTensor delta does not match base for key ",
+                              key);
+    }
+    Tensor full(cpu_allocator(), base.dtype(), base.shape());
+    memcpy(DMAHelper::base(&full), base.tensor_data().data(),
+           base.TotalBytes());
+    char* dst = reinterpret_cast<char*>(DMAHelper::base(&full));
+    const char* src = rows.tensor_data().data();
+    for (int i = 0; i < info.row_indices_size(); ++i) {
+      const int64 r = info.row_indices(i);
+      if (r < 0 || r >= num_rows) {
+        return errors::Internal("RecvTensor delta row index ", r,
+                                " out of range for key ", key);
+      }
+      memcpy(dst + r * bytes_per_row, src + i * bytes_per_row, bytes_per_row);
+    }
+    // An empty delta against the version we already hold means the value is
+    // unchanged; the cache entry is already current, so skip re-recording it.
+    if (info.version() != base_version) {
+      RecvTensorDeltaCache::Get()->Record(key, info.version(), full);
+    }
+    delta_full_tensor_ = std::move(full);
+    delta_reconstructed_ = true;
+    return Status::OK();
+  }
+
   string src_worker_;
   string src_rel_device_;
   WorkerInterface* wi_;  // Not owned.
@@ -159,6 +524,10 @@ class RpcRecvTensorCall : public BaseRecvTensorCall {
   CallOptions opts_;
   RecvTensorRequest req_;
   TensorResponse resp_;
+  // Full tensor rebuilt from a delta response; delivered by tensor() in
+  // place of resp_.tensor() when delta_reconstructed_ is set.
+  Tensor delta_full_tensor_;
+  bool delta_reconstructed_ = false;
   Rendezvous::Args recv_args_;
   Rendezvous::DoneCallback done_;
 
@@ -267,9 +636,22 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
     return;
   }
 
+  // With slack transfer scheduling enabled, transfers with a recorded
+  // priority go through a per-worker issue window so critical-path
+  // tensors are not queued behind bulk ones on the same channel.
+  int64 priority = 0;
+  const bool prioritized =
+      SlackTransferSchedulingEnabled() &&
+      TransferPriorities::Get()->Lookup(string(parsed.edge_name), &priority);
+
   // Start "call".
   Ref();
-  call->Start([this, call]() {
+  const string sched_worker = prioritized ? call->src_worker_ : string();
+  std::function<void()> recv_done = [this, call, prioritized,
+                                     sched_worker]() {
+    if (prioritized) {
+      TransferIssueScheduler::Get()->TransferDone(sched_worker);
+    }
     // Removes "call" from active_. Prevent StartAbort().
     DeregisterCall(call);
     // If StartAbort was called prior to DeregisterCall, then the
@@ -282,7 +664,20 @@ void RpcRemoteRendezvous::RecvFromRemoteAsync(
     call->done()(s, Args(), call->recv_args(), call->tensor(), call->is_dead());
     get_call_freelist()->Release(call);
     Unref();
-  });
+  };
+  if (prioritized) {
+    TransferIssueScheduler::Get()->ScheduleTransfer(
+        sched_worker, priority, [call, recv_done]() {
+          if (!call->status().ok()) {
+            // The step was aborted while the transfer was queued.
+            recv_done();
+            return;
+          }
+          call->Start(recv_done);
+        });
+  } else {
+    call->Start(std::move(recv_done));
+  }
 }
 
 }  // namespace
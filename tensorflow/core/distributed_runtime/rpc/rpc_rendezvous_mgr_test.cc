@@ -104,6 +104,41 @@ TEST_F(RpcRendezvousMgrTest, LocalSendRecv) {
   rmgr_.Cleanup(step_id);
 }
 
+TEST_F(RpcRendezvousMgrTest, PushStagedRecv) {
+  setenv("TF_PUSH_RENDEZVOUS", "1", 1);
+  const int64 step_id = 321;
+  const Rendezvous::ParsedKey key = MakeKey(Rendezvous::CreateKey(
+      "/job:mnist/replica:1/task:3/cpu:0", 7890,
+      "/job:mnist/replica:1/task:2/cpu:0", "bar", FrameAndIter(0, 0)));
+  {
+    RemoteRendezvous* rendez = rmgr_.Find(step_id);
+    core::ScopedUnref unref(rendez);
+    // A push may arrive before the rendezvous is initialized.
+    TF_ASSERT_OK(
+        rendez->StagePushedTensor(key, Rendezvous::Args(), V("plum"), false));
+    TF_ASSERT_OK(rendez->Initialize(&worker_session_));
+    Notification n;
+    Status status;
+    Tensor val;
+    bool is_dead = false;
+    rendez->RecvAsync(key, Rendezvous::Args(),
+                      [&n, &status, &val, &is_dead](
+                          const Status& s, const Rendezvous::Args&,
+                          const Rendezvous::Args&, const Tensor& v, bool dead) {
+                        status = s;
+                        val = v;
+                        is_dead = dead;
+                        n.Notify();
+                      });
+    n.WaitForNotification();
+    TF_ASSERT_OK(status);
+    EXPECT_EQ(V(val), "plum");
+    EXPECT_FALSE(is_dead);
+  }
+  rmgr_.Cleanup(step_id);
+  unsetenv("TF_PUSH_RENDEZVOUS");
+}
+
 TEST_F(RpcRendezvousMgrTest, LocalAbort) {
   const Rendezvous::ParsedKey key = MakeKey(Rendezvous::CreateKey(
       "/job:mnist/replica:1/task:2/cpu:0", 7890,
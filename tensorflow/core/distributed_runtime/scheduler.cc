@@ -19,6 +19,7 @@ limitations under the License.
 
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_set.h"
+#include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/util/util.h"
 
@@ -315,4 +316,39 @@ Microseconds PriorityScheduler::AssignPriorities(
   return makespan;
 }
 
+TransferPriorities* TransferPriorities::Get() {
+  static TransferPriorities* instance = new TransferPriorities;
+  return instance;
+}
+
+void TransferPriorities::Record(const string& edge_name, int64 priority) {
+  mutex_lock l(mu_);
+  priorities_[edge_name] = priority;
+}
+
+bool TransferPriorities::Lookup(const string& edge_name,
+                                int64* priority) const {
+  mutex_lock l(mu_);
+  auto it = priorities_.find(edge_name);
+  if (it == priorities_.end()) {
+    return false;
+  }
+  *priority = it->second;
+  return true;
+}
+
+void ComputeTransferPriorities(const Graph* g, const CostModel* cost_model) {
+  std::vector<int64> slacks;
+  SlackAnalysis slack(g, cost_model);
+  slack.ComputeSlack(&slacks);
+  for (const Node* n : g->nodes()) {
+    if (!IsTransferNode(n)) continue;
+    string edge_name;
+    if (!GetNodeAttr(n->attrs(), "tensor_name", &edge_name).ok()) continue;
+    if (n->id() < static_cast<int>(slacks.size())) {
+      TransferPriorities::Get()->Record(edge_name, slacks[n->id()]);
+    }
+  }
+}
+
 }  // namespace tensorflow
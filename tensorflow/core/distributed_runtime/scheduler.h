@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/device.h"
 #include "tensorflow/core/common_runtime/device_set.h"
 #include "tensorflow/core/graph/costmodel.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 
@@ -113,6 +114,33 @@ class PriorityScheduler {
   TF_DISALLOW_COPY_AND_ASSIGN(PriorityScheduler);
 };
 
+// Process-wide registry of transfer priorities derived from slack
+// analysis.  GraphMgr publishes a priority for every _Send/_Recv edge
+// whenever it rebuilds cost models from measured step times; the RPC
+// layer may consult the registry to issue critical transfers ahead of
+// bulk ones.  Priorities are keyed by the rendezvous edge name (the
+// "tensor_name" attr of the _Send/_Recv pair); lower values mean less
+// slack, i.e. closer to the critical path.
+class TransferPriorities {
+ public:
+  static TransferPriorities* Get();
+
+  void Record(const string& edge_name, int64 priority);
+
+  // Returns true and sets *priority iff a priority has been recorded
+  // for "edge_name".
+  bool Lookup(const string& edge_name, int64* priority) const;
+
+ private:
+  mutable mutex mu_;
+  std::unordered_map<string, int64> priorities_ GUARDED_BY(mu_);
+};
+
+// Runs SlackAnalysis over "g" with the measured node times in
+// "cost_model" and records the slack of every _Send and _Recv node in
+// the TransferPriorities registry.
+void ComputeTransferPriorities(const Graph* g, const CostModel* cost_model);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_SCHEDULER_H_
@@ -18,11 +18,56 @@ limitations under the License.
 #include "google/protobuf/any.pb.h"
 
 #include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/framework/allocation_description.pb.h"
+#include "tensorflow/core/framework/bfloat16.h"
 #include "tensorflow/core/framework/tensor.pb.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/snappy.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Experimental: when parsing a RecvTensorResponse for a CPU tensor, alias
+// the tensor content in place inside the transport's receive buffer
+// instead of copying it into a freshly allocated buffer.
+bool AliasTensorContentEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRPC_RECV_ALIAS_TENSOR_CONTENT",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// A TensorBuffer backed by transport-owned memory.  Invokes the releaser
+// obtained from TensorResponse::Source when the last reference drops.
+class AliasedTensorBuffer : public TensorBuffer {
+ public:
+  AliasedTensorBuffer(void* data, size_t size, std::function<void()> releaser)
+      : TensorBuffer(data), size_(size), releaser_(std::move(releaser)) {}
+
+  size_t size() const override { return size_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size_);
+    proto->set_allocated_bytes(size_);
+    proto->set_allocator_name("aliased_rpc_buffer");
+  }
+
+ private:
+  ~AliasedTensorBuffer() override { releaser_(); }
+
+  const size_t size_;
+  std::function<void()> releaser_;
+};
+
+}  // namespace
+
 TensorResponse::Source::~Source() {}
 
 void TensorResponse::Clear() {
@@ -31,6 +76,7 @@ void TensorResponse::Clear() {
   alloc_attrs_ = AllocatorAttributes();
   allocator_ = nullptr;
   already_used_ = false;
+  prealloc_ = Tensor();
   ClearTensor();
 }
 
@@ -50,6 +96,14 @@ void TensorResponse::InitAlloc(DeviceBase* d, const AllocatorAttributes& aa) {
   allocator_ = device_->GetAllocator(alloc_attrs_);
 }
 
+void TensorResponse::PreAllocate(DataType dtype, const TensorShape& shape) {
+  // Only the host fast path can parse into a caller-provided buffer.
+  if (!on_host_ || allocator_ == nullptr || !DataTypeCanUseMemcpy(dtype)) {
+    return;
+  }
+  prealloc_ = Tensor(allocator_, dtype, shape);
+}
+
 Status TensorResponse::InitFrom(RecvTensorResponse* response) {
   Status s;
   meta_.Swap(response);
@@ -88,6 +142,11 @@ Status TensorResponse::ParseFrom(Source* source) {
     if (!meta_.ParseFromCodedStream(&input) || !input.ConsumedEntireMessage()) {
       return errors::InvalidArgument("Cannot parse tensor from response");
     }
+    if (meta_.compression_codec() != TENSOR_COMPRESSION_NONE) {
+      // Compression is only negotiated for host-memory receives.
+      return errors::InvalidArgument(
+          "Unexpected compressed tensor content in device response");
+    }
     Status s =
         device_->MakeTensorFromProto(meta_.tensor(), alloc_attrs_, &tensor_);
     // Reduce memory usage for big tensors.
@@ -144,8 +203,85 @@ bool ReadNestedMessage(protobuf::io::CodedInputStream* input,
 
 }  // namespace
 
+bool TensorResponse::TryAliasTensorContent(Source* source,
+                                           protobuf::io::CodedInputStream* input,
+                                           DataType dtype,
+                                           const TensorShape& shape,
+                                           int num_bytes) {
+  if (!AliasTensorContentEnabled()) return false;
+  // Only plain CPU tensors may alias transport memory; anything with
+  // special allocation semantics (e.g. gpu-compatible pinned memory) must
+  // go through allocator_.
+  if (device_ == nullptr || device_->attributes().device_type() != "CPU" ||
+      alloc_attrs_.gpu_compatible()) {
+    return false;
+  }
+  if (num_bytes == 0 || static_cast<int64>(num_bytes) !=
+                            shape.num_elements() * DataTypeSize(dtype)) {
+    return false;
+  }
+  const void* data;
+  int size;
+  // The content must lie contiguously in the current buffer, suitably
+  // aligned for use as a tensor backing store.
+  if (!input->GetDirectBufferPointer(&data, &size) || size < num_bytes) {
+    return false;
+  }
+  if (reinterpret_cast<uintptr_t>(data) % Allocator::kAllocatorAlignment != 0) {
+    return false;
+  }
+  std::function<void()> releaser = source->GetOwnedBufferReleaser();
+  if (releaser == nullptr) return false;
+  TensorBuffer* buf = new AliasedTensorBuffer(
+      const_cast<void*>(data), num_bytes, std::move(releaser));
+  tensor_ = Tensor(dtype, shape, buf);
+  buf->Unref();
+  return input->Skip(num_bytes);
+}
+
+bool TensorResponse::ReadCompressedTensorContent(
+    protobuf::io::CodedInputStream* input, DataType dtype,
+    const TensorShape& shape, int num_bytes) {
+  Tensor t(allocator_, dtype, shape);
+  StringPiece buf = t.tensor_data();
+  gtl::InlinedVector<char, 128> scratch(num_bytes);
+  if (!input->ReadRaw(scratch.data(), num_bytes)) return false;
+  switch (meta_.compression_codec()) {
+    case TENSOR_COMPRESSION_SNAPPY: {
+      size_t uncompressed_length;
+      if (!port::Snappy_GetUncompressedLength(scratch.data(), num_bytes,
+                                              &uncompressed_length) ||
+          uncompressed_length != buf.size()) {
+        return false;
+      }
+      if (!port::Snappy_Uncompress(scratch.data(), num_bytes,
+                                   const_cast<char*>(buf.data()))) {
+        return false;
+      }
+      break;
+    }
+    case TENSOR_COMPRESSION_BFLOAT16: {
+      if (dtype != DT_FLOAT ||
+          static_cast<int64>(num_bytes) !=
+              shape.num_elements() * static_cast<int64>(sizeof(bfloat16))) {
+        return false;
+      }
+      BFloat16ToFloat(reinterpret_cast<const bfloat16*>(scratch.data()),
+                      const_cast<float*>(
+                          reinterpret_cast<const float*>(buf.data())),
+                      shape.num_elements());
+      break;
+    }
+    default:
+      return false;
+  }
+  tensor_ = std::move(t);
+  return true;
+}
+
 bool TensorResponse::ParseTensorSubmessage(
-    protobuf::io::CodedInputStream* input, TensorProto* tensor_meta) {
+    Source* source, protobuf::io::CodedInputStream* input,
+    TensorProto* tensor_meta) {
   bool seen_tensor_content = false;
   while (true) {
     auto p = input->ReadTagWithCutoff(127);
@@ -196,6 +332,31 @@ bool TensorResponse::ParseTensorSubmessage(
         if (!ReadVarintSizeAsInt(input, &num_bytes)) return false;
         seen_tensor_content = true;
         TensorShape shape(tensor_meta->tensor_shape());
+        if (meta_.compression_codec() != TENSOR_COMPRESSION_NONE) {
+          if (!ReadCompressedTensorContent(input, tensor_meta->dtype(), shape,
+                                           num_bytes)) {
+            return false;
+          }
+          break;
+        }
+        if (TryAliasTensorContent(source, input, tensor_meta->dtype(), shape,
+                                  num_bytes)) {
+          break;
+        }
+        if (num_bytes > 0 && prealloc_.dtype() == tensor_meta->dtype() &&
+            prealloc_.shape() == shape) {
+          // Parse directly into the pre-allocated destination.
+          StringPiece prealloc_buf = prealloc_.tensor_data();
+          if (static_cast<size_t>(num_bytes) == prealloc_buf.size()) {
+            if (!input->ReadRaw(const_cast<char*>(prealloc_buf.data()),
+                                num_bytes)) {
+              return false;
+            }
+            tensor_ = std::move(prealloc_);
+            prealloc_ = Tensor();
+            break;
+          }
+        }
         Tensor t(allocator_, tensor_meta->dtype(), shape);
         StringPiece buf = t.tensor_data();
         if (static_cast<size_t>(num_bytes) != buf.size()) return false;
@@ -235,7 +396,7 @@ bool TensorResponse::ParseFast(Source* source) {
         std::pair<protobuf::io::CodedInputStream::Limit, int> p =
             input.IncrementRecursionDepthAndPushLimit(length);
         if (p.second < 0 ||
-            !ParseTensorSubmessage(&input, meta_.mutable_tensor())) {
+            !ParseTensorSubmessage(source, &input, meta_.mutable_tensor())) {
           return false;
         }
         if (!input.DecrementRecursionDepthAndPopLimit(p.first)) {
@@ -261,6 +422,14 @@ bool TensorResponse::ParseFast(Source* source) {
           return false;
         break;
       }
+      case RecvTensorResponse::kCompressionCodecFieldNumber: {
+        uint32 v;
+        if ((wt != WIRETYPE_VARINT) || !input.ReadVarint32(&v)) return false;
+        if (!TensorCompressionCodec_IsValid(static_cast<int>(v))) return false;
+        meta_.set_compression_codec(
+            static_cast<TensorCompressionCodec>(static_cast<int>(v)));
+        break;
+      }
       default: {
         // Unknown tag, so don't handle we can't handle on the fast path
         return false;
@@ -276,6 +445,12 @@ bool TensorResponse::ParseSlow(Source* source) {
     return false;
   }
 
+  // Compressed content is only ever produced for memcpy-able dtypes, which
+  // the fast path handles; a compressed response landing here is malformed.
+  if (meta_.compression_codec() != TENSOR_COMPRESSION_NONE) {
+    return false;
+  }
+
   Tensor parsed(meta_.tensor().dtype());
   if (!parsed.FromProto(allocator_, meta_.tensor())) {
     return false;
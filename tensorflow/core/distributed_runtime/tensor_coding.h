@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_CODING_H_
 #define TENSORFLOW_CORE_DISTRIBUTED_RUNTIME_TENSOR_CODING_H_
 
+#include <functional>
+
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/status.h"
@@ -46,6 +48,15 @@ class TensorResponse {
   // Initialize memory allocation related members.
   void InitAlloc(DeviceBase* d, const AllocatorAttributes& aa);
 
+  // Allocates a destination tensor of the given dtype and shape ahead of
+  // the next ParseFrom.  If the incoming response is an uncompressed
+  // host-memory tensor whose dtype and shape match exactly, its content
+  // is parsed directly into the pre-allocated buffer and no allocation
+  // happens on the receive path; otherwise the pre-allocated tensor is
+  // discarded and parsing proceeds as usual.  Must be called after
+  // InitAlloc; a no-op for device-memory responses.
+  void PreAllocate(DataType dtype, const TensorShape& shape);
+
   // Source provides a way for a particular RPC implementation to provide
   // received data to ParseFrom.
   class Source {
@@ -64,6 +75,14 @@ class TensorResponse {
     // Ownership of the returned stream is retained by the Source and
     // should not be deleted by the caller.
     virtual ::tensorflow::protobuf::io::ZeroCopyInputStream* contents() = 0;
+
+    // If the Source can guarantee that the bytes yielded by contents()
+    // stay valid after the Source itself is destroyed, returns a closure
+    // that releases that guarantee; the caller must invoke it once the
+    // bytes are no longer needed.  Returns nullptr (the default) when no
+    // such guarantee can be made, in which case ParseFrom must copy any
+    // data it wants to retain.
+    virtual std::function<void()> GetOwnedBufferReleaser() { return nullptr; }
   };
 
   // Parse the RecvTensorResponse encoded in the data yielded by
@@ -91,9 +110,30 @@ class TensorResponse {
   // Return pointer to the device hosting the tensor.
   DeviceBase* device() const { return device_; }
 
+  // Return true iff the tensor is destined for host memory, i.e. content
+  // bytes can be written directly into tensor() backing storage.
+  bool on_host() const { return on_host_; }
+
  private:
-  bool ParseTensorSubmessage(protobuf::io::CodedInputStream* input,
+  bool ParseTensorSubmessage(Source* source,
+                             protobuf::io::CodedInputStream* input,
                              TensorProto* tensor_meta);
+  // Attempts to make tensor_ reference "num_bytes" of tensor content
+  // directly inside the source's buffer instead of copying it out, which
+  // is possible only when the source owns its buffer, the content lies
+  // contiguously in the stream with suitable alignment, and the tensor is
+  // destined for ordinary CPU memory.  On success the input stream is
+  // advanced past the content.
+  bool TryAliasTensorContent(Source* source,
+                             protobuf::io::CodedInputStream* input,
+                             DataType dtype, const TensorShape& shape,
+                             int num_bytes);
+  // Reads "num_bytes" of tensor content compressed with
+  // meta_.compression_codec() and decompresses it into a freshly allocated
+  // tensor of the given dtype and shape.
+  bool ReadCompressedTensorContent(protobuf::io::CodedInputStream* input,
+                                   DataType dtype, const TensorShape& shape,
+                                   int num_bytes);
   bool ParseFast(Source* source);
   bool ParseSlow(Source* source);
 
@@ -103,6 +143,7 @@ class TensorResponse {
   Allocator* allocator_ = nullptr;
   bool already_used_ = false;
   Tensor tensor_;
+  Tensor prealloc_;
   RecvTensorResponse meta_;
 };
 
@@ -156,6 +156,38 @@ TEST_F(TensorResponseTest, Simple) {
 
 TEST_F(TensorResponseTest, StringTensor) { DoTestForStrings(DT_STRING); }
 
+TEST_F(TensorResponseTest, PreAllocated) {
+  Tensor src(DT_FLOAT, TensorShape({2, 3}));
+  test::FillValues<float>(&src, {1, 2, 3, 4, 5, 6});
+  RecvTensorResponse proto;
+  proto.set_is_dead(false);
+  src.AsProtoTensorContent(proto.mutable_tensor());
+  string encoded;
+  proto.AppendToString(&encoded);
+
+  DummyDevice cpu_device(Env::Default());
+  {
+    // Matching pre-allocation: content is parsed into the supplied buffer.
+    TensorResponse response;
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    response.PreAllocate(DT_FLOAT, TensorShape({2, 3}));
+    StringSource source(&encoded, 1024);
+    Status s = response.ParseFrom(&source);
+    EXPECT_TRUE(s.ok());
+    test::ExpectTensorEqual<float>(src, response.tensor());
+  }
+  {
+    // Mismatched pre-allocation: parsing falls back to a fresh allocation.
+    TensorResponse response;
+    response.InitAlloc(&cpu_device, AllocatorAttributes());
+    response.PreAllocate(DT_FLOAT, TensorShape({4, 3}));
+    StringSource source(&encoded, 1024);
+    Status s = response.ParseFrom(&source);
+    EXPECT_TRUE(s.ok());
+    test::ExpectTensorEqual<float>(src, response.tensor());
+  }
+}
+
 string MakeFloatTensorTestCase(int num_elems) {
   std::vector<int8> v(num_elems);
   for (int i = 0; i < num_elems; i++) {
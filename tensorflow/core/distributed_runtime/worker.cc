@@ -458,4 +458,28 @@ void Worker::RecvTensorAsync(CallOptions* opts,
   done(errors::Unimplemented("Worker::RecvTensorAsync()"));
 }
 
+void Worker::PushTensorAsync(CallOptions* opts,
+                             const PushTensorRequest* request,
+                             PushTensorResponse* response,
+                             StatusCallback done) {
+  Rendezvous::ParsedKey parsed;
+  Status s = Rendezvous::ParseKey(request->rendezvous_key(), &parsed);
+  Tensor val;
+  if (s.ok() && !request->is_dead() && !val.FromProto(request->tensor())) {
+    s = errors::InvalidArgument("PushTensor: could not parse tensor for key ",
+                                request->rendezvous_key());
+  }
+  if (s.ok()) {
+    // The producer pushes only for steps it is itself executing, so the
+    // step's rendezvous either already exists or is about to be created
+    // and initialized by the corresponding RunGraph request.
+    RemoteRendezvous* rendezvous =
+        env_->rendezvous_mgr->Find(request->step_id());
+    s = rendezvous->StagePushedTensor(parsed, Rendezvous::Args(), val,
+                                      request->is_dead());
+    rendezvous->Unref();
+  }
+  done(s);
+}
+
 }  // namespace tensorflow
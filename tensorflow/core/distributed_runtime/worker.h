@@ -84,6 +84,10 @@ class Worker : public WorkerInterface {
   void RecvTensorAsync(CallOptions* opts, const RecvTensorRequest* request,
                        TensorResponse* response, StatusCallback done) override;
 
+  void PushTensorAsync(CallOptions* opts, const PushTensorRequest* request,
+                       PushTensorResponse* response,
+                       StatusCallback done) override;
+
   void LoggingAsync(const LoggingRequest* request, LoggingResponse* response,
                     StatusCallback done) override;
 
@@ -20,6 +20,7 @@ limitations under the License.
 
 #include "tensorflow/core/distributed_runtime/call_options.h"
 #include "tensorflow/core/distributed_runtime/message_wrappers.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/types.h"
@@ -106,6 +107,16 @@ class WorkerInterface {
                                TensorResponse* response,
                                StatusCallback done) = 0;
 
+  // Stages a producer-pushed tensor on the remote worker (see the push
+  // rendezvous mode in base_rendezvous_mgr.cc).  Defaulted rather than
+  // pure so that transports which never push need not implement it.
+  virtual void PushTensorAsync(CallOptions* opts,
+                               const PushTensorRequest* request,
+                               PushTensorResponse* response,
+                               StatusCallback done) {
+    done(errors::Unimplemented("PushTensorAsync"));
+  }
+
   virtual void LoggingAsync(const LoggingRequest* request,
                             LoggingResponse* response, StatusCallback done) = 0;
 
@@ -0,0 +1,121 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/framework/dataset_stage_trace.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Spans written to the trace file before recording stops; the gauges
+// keep aggregating past the cap.
+constexpr int64 kMaxTraceEvents = 1 << 20;
+// Spans between flushes of the trace file.
+constexpr int64 kFlushInterval = 512;
+
+}  // namespace
+
+DataStageTrace* DataStageTrace::Global() {
+  static DataStageTrace* singleton = new DataStageTrace;
+  return singleton;
+}
+
+DataStageTrace::DataStageTrace() {
+  string trace_file_path;
+  TF_CHECK_OK(
+      ReadStringFromEnvVar("TF_DATA_TRACE_FILE", "", &trace_file_path));
+  int64 gauge_interval_secs = 0;
+  TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_TRACE_GAUGE_INTERVAL_SECS", 0,
+                                  &gauge_interval_secs));
+  gauge_interval_us_ = gauge_interval_secs * 1000000;
+  if (!trace_file_path.empty()) {
+    Status s = Env::Default()->NewWritableFile(trace_file_path, &trace_file_);
+    if (!s.ok()) {
+      LOG(WARNING) << "Could not open tf.data trace file '" << trace_file_path
+                   << "': " << s;
+    }
+  }
+  enabled_ = trace_file_ != nullptr || gauge_interval_us_ > 0;
+  window_start_us_ = Env::Default()->NowMicros();
+}
+
+void DataStageTrace::RecordSpan(const string& prefix, uint64 start_us,
+                                uint64 end_us, bool produced_element) {
+  const int64 duration_us = static_cast<int64>(end_us - start_us);
+  const int64 thread_id = Env::Default()->GetCurrentThreadId();
+  mutex_lock l(mu_);
+  StageStats& stats = stages_[prefix];
+  ++stats.spans;
+  if (produced_element) ++stats.elements;
+  stats.total_us += duration_us;
+  stats.max_us = std::max(stats.max_us, duration_us);
+  if (trace_file_ != nullptr && events_written_ < kMaxTraceEvents) {
+    // One chrome-trace "complete" event per span.  The array is never
+    // terminated; the trace viewer accepts that.
+    string event =
+        strings::StrCat(events_written_ == 0 ? "[\n" : ",\n", "{\"name\": \"",
+                        prefix, "\", \"ph\": \"X\", \"pid\": 0, \"tid\": ",
+                        thread_id, ", \"ts\": ", start_us,
+                        ", \"dur\": ", duration_us, "}");
+    if (trace_file_->Append(event).ok()) {
+      ++events_written_;
+      if (events_written_ % kFlushInterval == 0 ||
+          events_written_ == kMaxTraceEvents) {
+        trace_file_->Flush().IgnoreError();
+      }
+    }
+  }
+  if (gauge_interval_us_ > 0 &&
+      end_us - window_start_us_ >= static_cast<uint64>(gauge_interval_us_)) {
+    LogGauges(end_us);
+  }
+}
+
+void DataStageTrace::LogGauges(uint64 now_us) {
+  const double window_secs =
+      static_cast<double>(now_us - window_start_us_) * 1e-6;
+  string line = strings::StrCat("data_stage_gauges: {\"window_secs\": ",
+                                window_secs, ", \"stages\": {");
+  bool first = true;
+  for (const auto& entry : stages_) {
+    const StageStats& stats = entry.second;
+    if (stats.spans == 0) continue;
+    // Utilization is the fraction of the window this stage spent inside
+    // GetNext(); a stage near 1.0 with low throughput is the bottleneck,
+    // while its downstream stages show high latency but low utilization
+    // of their own (they are waiting, i.e. backpressured).
+    strings::StrAppend(
+        &line, first ? "" : ", ", "\"", entry.first,
+        "\": {\"elements\": ", stats.elements, ", \"spans\": ", stats.spans,
+        ", \"avg_us\": ", stats.total_us / stats.spans,
+        ", \"max_us\": ", stats.max_us, ", \"throughput_eps\": ",
+        static_cast<double>(stats.elements) / window_secs,
+        ", \"utilization\": ",
+        static_cast<double>(stats.total_us) * 1e-6 / window_secs, "}");
+    first = false;
+  }
+  strings::StrAppend(&line, "}}");
+  LOG(INFO) << line;
+  stages_.clear();
+  window_start_us_ = now_us;
+}
+
+}  // namespace data
+}  // namespace tensorflow
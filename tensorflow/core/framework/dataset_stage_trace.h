@@ -0,0 +1,120 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_FRAMEWORK_DATASET_STAGE_TRACE_H_
+#define TENSORFLOW_CORE_FRAMEWORK_DATASET_STAGE_TRACE_H_
+
+#include <memory>
+
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace data {
+
+// A process-wide recorder of tf.data GetNext() spans, for attributing a
+// slow input pipeline to the dataset stage that stalls it.
+//
+// Every DatasetBaseIterator::GetNext() call reports one span named by the
+// iterator's prefix, which identifies the stage's position in the
+// iterator stack.  When TF_DATA_TRACE_FILE is set the spans are streamed
+// to that file in chrome-trace JSON array format (loadable in
+// chrome://tracing even without the closing bracket), capped at
+// kMaxTraceEvents.  Independently of the file, per-stage gauges
+// (throughput, latency, utilization) are aggregated and logged as one
+// machine-readable line every TF_DATA_TRACE_GAUGE_INTERVAL_SECS seconds,
+// so steady-state behavior can be polled from logs in production without
+// collecting a full trace.
+//
+// Disabled (and nearly free) unless at least one of the two environment
+// variables is set.
+class DataStageTrace {
+ public:
+  // Returns the process-wide recorder.  Never null.
+  static DataStageTrace* Global();
+
+  bool enabled() const { return enabled_; }
+
+  // Records one completed GetNext() span of the stage named by `prefix`.
+  // `produced_element` is false for spans that ended in end-of-sequence
+  // or an error.  Times are in microseconds since the epoch.
+  void RecordSpan(const string& prefix, uint64 start_us, uint64 end_us,
+                  bool produced_element);
+
+ private:
+  DataStageTrace();
+
+  struct StageStats {
+    int64 spans = 0;
+    int64 elements = 0;
+    int64 total_us = 0;
+    int64 max_us = 0;
+  };
+
+  // Logs the per-stage gauges of the window that just ended and starts a
+  // new window.
+  void LogGauges(uint64 now_us) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  bool enabled_ = false;
+  int64 gauge_interval_us_ = 0;
+
+  mutex mu_;
+  // Null unless TF_DATA_TRACE_FILE was set and the file could be opened.
+  std::unique_ptr<WritableFile> trace_file_ GUARDED_BY(mu_);
+  int64 events_written_ GUARDED_BY(mu_) = 0;
+  uint64 window_start_us_ GUARDED_BY(mu_) = 0;
+  gtl::FlatMap<string, StageStats> stages_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(DataStageTrace);
+};
+
+// Measures one GetNext() span and reports it to DataStageTrace.  A no-op
+// when tracing is disabled.  `prefix` must outlive the span.
+class DataStageTraceSpan {
+ public:
+  explicit DataStageTraceSpan(const string& prefix) {
+    if (DataStageTrace::Global()->enabled()) {
+      prefix_ = &prefix;
+      start_us_ = Env::Default()->NowMicros();
+    }
+  }
+
+  // Marks that the span produced an element (rather than ending in
+  // end-of-sequence or an error).
+  void MarkProducedElement() { produced_element_ = true; }
+
+  ~DataStageTraceSpan() {
+    if (prefix_ != nullptr) {
+      DataStageTrace::Global()->RecordSpan(
+          *prefix_, start_us_, Env::Default()->NowMicros(),
+          produced_element_);
+    }
+  }
+
+ private:
+  const string* prefix_ = nullptr;
+  uint64 start_us_ = 0;
+  bool produced_element_ = false;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(DataStageTraceSpan);
+};
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_DATASET_STAGE_TRACE_H_
@@ -622,6 +622,10 @@ class FunctionLibraryRuntime {
 
     std::function<void(std::function<void()>)>* runner = nullptr;
 
+    // If true, the executor for this function processes all kernels on the
+    // scheduling thread (see Executor::Args::run_all_kernels_inline).
+    bool run_all_kernels_inline = false;
+
     // Parameters for remote function execution.
     bool remote_execution = false;
     string source_device = "";  // Fully specified device name.
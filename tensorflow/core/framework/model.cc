@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/framework/model.h"
 
+#include <algorithm>
 #include <memory>
 
 namespace tensorflow {
@@ -411,6 +412,9 @@ void Model::Optimize(int64 cpu_budget) {
   std::shared_ptr<Node> snapshot;
   {
     tf_shared_lock lock(mu_);
+    if (!output_) {
+      return;
+    }
     snapshot = output_->Snapshot(nullptr);
   }
   const int64 processing_time = ProcessingTime(snapshot);
@@ -524,6 +528,94 @@ int64 Model::ProcessingTime(std::shared_ptr<Node> node) {
   return node->ProcessingTime();
 }
 
+int64 Model::TotalProcessingTime() {
+  std::shared_ptr<Node> snapshot;
+  {
+    tf_shared_lock l(mu_);
+    if (!output_) {
+      return 0;
+    }
+    snapshot = output_->Snapshot(nullptr);
+  }
+  return ProcessingTime(snapshot);
+}
+
+namespace {
+
+constexpr int64 kCoordinatorPeriodThresholdMs = 60 * 1000;
+
+}  // namespace
+
+// static
+ModelCoordinator* ModelCoordinator::Global() {
+  static ModelCoordinator* coordinator = new ModelCoordinator;
+  return coordinator;
+}
+
+void ModelCoordinator::Register(std::shared_ptr<Model> model) {
+  mutex_lock l(mu_);
+  models_.push_back(std::move(model));
+  if (!thread_) {
+    thread_.reset(Env::Default()->StartThread({}, "tf_data_model_coordinator",
+                                              [this]() {
+                                                CoordinatorThread();
+                                              }));
+  }
+  cond_var_.notify_all();
+}
+
+void ModelCoordinator::Unregister(const std::shared_ptr<Model>& model) {
+  mutex_lock l(mu_);
+  models_.erase(std::remove(models_.begin(), models_.end(), model),
+                models_.end());
+}
+
+void ModelCoordinator::CoordinatorThread() {
+  int64 optimization_period_ms = 10;
+  while (true) {
+    std::vector<std::shared_ptr<Model>> models;
+    {
+      mutex_lock l(mu_);
+      while (models_.empty()) {
+        cond_var_.wait(l);
+        // Pipelines registered after an idle period restart with frequent
+        // optimization so that they are tuned quickly.
+        optimization_period_ms = 10;
+      }
+      models = models_;
+    }
+    // Divide the schedulable CPUs across pipelines in proportion to the
+    // per-element work each performs, so that a busy pipeline is allotted
+    // more parallelism than a mostly idle one. Every pipeline receives a
+    // budget of at least 1 to keep its parameters from collapsing entirely.
+    const int64 cpu_budget = port::NumSchedulableCPUs();
+    std::vector<int64> processing_times;
+    processing_times.reserve(models.size());
+    int64 total_processing_time = 0;
+    for (auto& model : models) {
+      processing_times.push_back(model->TotalProcessingTime());
+      total_processing_time += processing_times.back();
+    }
+    for (size_t i = 0; i < models.size(); ++i) {
+      int64 budget;
+      if (total_processing_time > 0) {
+        budget = std::max<int64>(
+            1, cpu_budget * processing_times[i] / total_processing_time);
+      } else {
+        budget = std::max<int64>(1, cpu_budget / models.size());
+      }
+      models[i]->Optimize(budget);
+    }
+    // Exponentially increase the period of running the optimization until a
+    // threshold is reached, mirroring the per-pipeline optimization loop.
+    if (optimization_period_ms < kCoordinatorPeriodThresholdMs) {
+      optimization_period_ms =
+          std::min(optimization_period_ms << 1, kCoordinatorPeriodThresholdMs);
+    }
+    Env::Default()->SleepForMicroseconds(optimization_period_ms * 1000);
+  }
+}
+
 }  // namespace model
 }  // namespace data
 }  // namespace tensorflow
@@ -400,6 +400,10 @@ class Model {
   // Removes the given node.
   void RemoveNode(const string& name) LOCKS_EXCLUDED(mu_);
 
+  // Returns the aggregate per-element processing time for the pipeline, or 0
+  // if the model does not have an output node yet.
+  int64 TotalProcessingTime() LOCKS_EXCLUDED(mu_);
+
  private:
   // Collects tunable parameters in the tree rooted in the given node.
   std::vector<std::shared_ptr<Parameter>> CollectTunableParameters(
@@ -431,6 +435,42 @@ class Model {
   const NodeHook remove_node_hook_;
 };
 
+// Process-wide coordinator that arbitrates the CPU budget across all
+// registered models. When multiple input pipelines run in one process, tuning
+// each of them against the full machine makes them collectively oversubscribe
+// cores; the coordinator instead runs a single optimization loop that divides
+// the schedulable CPUs across pipelines in proportion to the per-element work
+// each performs, optimizing for aggregate throughput.
+//
+// The coordinator thread is started lazily when the first model is registered
+// and parks itself while no models are registered.
+class ModelCoordinator {
+ public:
+  // Returns the process-wide coordinator instance.
+  static ModelCoordinator* Global();
+
+  // Registers the given model for coordinated optimization. The caller should
+  // not run the model's own optimization loop while it is registered.
+  void Register(std::shared_ptr<Model> model) LOCKS_EXCLUDED(mu_);
+
+  // Unregisters the given model. The model may still be optimized once more
+  // if an optimization round is already in progress.
+  void Unregister(const std::shared_ptr<Model>& model) LOCKS_EXCLUDED(mu_);
+
+ private:
+  ModelCoordinator() = default;
+
+  // The body of the coordinator thread; never returns.
+  void CoordinatorThread();
+
+  mutex mu_;
+  condition_variable cond_var_;
+  std::vector<std::shared_ptr<Model>> models_ GUARDED_BY(mu_);
+  std::unique_ptr<Thread> thread_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(ModelCoordinator);
+};
+
 }  // namespace model
 }  // namespace data
 }  // namespace tensorflow
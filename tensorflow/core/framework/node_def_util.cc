@@ -189,6 +189,20 @@ Status AttrSlice::Find(StringPiece attr_name,
   return s;
 }
 
+void AttrSlots::Bind(const AttrSlice& attrs) {
+  std::fill(values_.begin(), values_.end(), nullptr);
+  // One pass over the node's attrs; each attr does a linear probe of the
+  // slot names, which are few by construction.
+  for (const auto& attr : attrs) {
+    for (size_t i = 0; i < names_.size(); ++i) {
+      if (values_[i] == nullptr && names_[i] == attr.first) {
+        values_[i] = &attr.second;
+        break;
+      }
+    }
+  }
+}
+
 bool AttrSlice::EqualAttrs(AttrSlice other, Scratch* scratch) const {
   if (size() != other.size()) return false;
 
@@ -208,26 +222,34 @@ bool AttrSlice::EqualAttrs(AttrSlice other, Scratch* scratch) const {
 // The ... is to allow the caller to inject some value validation code.  Use
 // just ; if no additional validation code is needed.
 #define DEFINE_GET_ATTR(TYPE, FIELD, ATTR_TYPE, APPEND_OP, CAST, ...)         \
-  Status GetNodeAttr(const AttrSlice& attrs, StringPiece attr_name,           \
+  Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,      \
                      TYPE* value) {                                           \
-    const AttrValue* attr_value;                                              \
-    TF_RETURN_IF_ERROR(attrs.Find(attr_name, &attr_value));                   \
-    TF_RETURN_IF_ERROR(AttrValueHasType(*attr_value, ATTR_TYPE));             \
-    const auto& v = attr_value->FIELD();                                      \
+    TF_RETURN_IF_ERROR(AttrValueHasType(attr_value, ATTR_TYPE));              \
+    const auto& v = attr_value.FIELD();                                       \
     __VA_ARGS__;                                                              \
     *value = CAST;                                                            \
     return Status::OK();                                                      \
   }                                                                           \
   Status GetNodeAttr(const AttrSlice& attrs, StringPiece attr_name,           \
-                     std::vector<TYPE>* value) {                              \
+                     TYPE* value) {                                           \
     const AttrValue* attr_value;                                              \
     TF_RETURN_IF_ERROR(attrs.Find(attr_name, &attr_value));                   \
-    TF_RETURN_IF_ERROR(AttrValueHasType(*attr_value, "list(" ATTR_TYPE ")")); \
-    for (const auto& v : attr_value->list().FIELD()) {                        \
+    return AttrValueTo(*attr_value, attr_name, value);                        \
+  }                                                                           \
+  Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,      \
+                     std::vector<TYPE>* value) {                              \
+    TF_RETURN_IF_ERROR(AttrValueHasType(attr_value, "list(" ATTR_TYPE ")"));  \
+    for (const auto& v : attr_value.list().FIELD()) {                         \
       __VA_ARGS__;                                                            \
       value->APPEND_OP(CAST);                                                 \
     }                                                                         \
     return Status::OK();                                                      \
+  }                                                                           \
+  Status GetNodeAttr(const AttrSlice& attrs, StringPiece attr_name,           \
+                     std::vector<TYPE>* value) {                              \
+    const AttrValue* attr_value;                                              \
+    TF_RETURN_IF_ERROR(attrs.Find(attr_name, &attr_value));                   \
+    return AttrValueTo(*attr_value, attr_name, value);                        \
   }
 
 #define DEFINE_GET_ATTR_SIMPLE(TYPE, FIELD, ATTR_TYPE, APPEND_OP, CAST, ...) \
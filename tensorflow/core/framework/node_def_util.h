@@ -21,8 +21,10 @@ limitations under the License.
 
 #include "tensorflow/core/framework/attr_value_util.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/protobuf.h"
 
@@ -172,6 +174,101 @@ class AttrSlice {
   const AttrValueMap* attrs_;
 };
 
+// Converts an already-resolved AttrValue to a typed value, performing the
+// same type checking and validation as the GetNodeAttr overloads below.
+// `attr_name` is used in error messages only.
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   string* value);  // type: "string"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   int64* value);  // type: "int"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   int32* value);  // type: "int"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   float* value);  // type: "float"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   bool* value);  // type: "bool"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   DataType* value);  // type: "type"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   TensorShapeProto* value);  // type: "shape"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   TensorShape* value);  // type: "shape"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   PartialTensorShape* value);  // type: "shape"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   Tensor* value);  // type: "tensor"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   NameAttrList* value);  // type: "func"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<string>* value);  // type "list(string)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<int64>* value);  // type "list(int)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<int32>* value);  // type "list(int)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<float>* value);  // type "list(float)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<bool>* value);  // type "list(bool)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<DataType>* value);  // type "list(type)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<TensorShapeProto>* value);  // type "list(shape)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<TensorShape>* value);  // type "list(shape)"
+Status AttrValueTo(
+    const AttrValue& attr_value, StringPiece attr_name,
+    std::vector<PartialTensorShape>* value);  // type "list(shape)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<Tensor>* value);  // type: "list(tensor)"
+Status AttrValueTo(const AttrValue& attr_value, StringPiece attr_name,
+                   std::vector<NameAttrList>* value);  // type: "list(func)"
+
+// Resolves a fixed list of attr names to integer slots once, then serves
+// typed attr lookups by slot index with no per-lookup string comparisons.
+// Intended for hot loops that query the same attrs for many nodes (e.g.
+// executor initialization); bind the slots to each node in turn:
+//
+//   AttrSlots slots({"frame_name", "is_constant"});
+//   for (const Node* n : g->nodes()) {
+//     slots.Bind(n->attrs());
+//     if (slots.Has(0)) { ... }
+//   }
+//
+// The bound AttrValue pointers are only valid until the next Bind() call
+// and must not outlive the bound node.
+class AttrSlots {
+ public:
+  explicit AttrSlots(std::initializer_list<StringPiece> attr_names)
+      : names_(attr_names.begin(), attr_names.end()),
+        values_(names_.size(), nullptr) {}
+
+  // Points the slots at `attrs`' values with a single pass over its attrs.
+  // Slots whose attr is missing read as not found.
+  void Bind(const AttrSlice& attrs);
+
+  // Returns true if the slot's attr was present in the last Bind().
+  bool Has(int slot) const { return values_[slot] != nullptr; }
+
+  // Returns the bound AttrValue for `slot`, or nullptr if absent.
+  const AttrValue* Find(int slot) const { return values_[slot]; }
+
+  // Typed accessor mirroring GetNodeAttr: returns NotFound if the attr was
+  // absent, or the AttrValueTo conversion result otherwise.
+  template <typename T>
+  Status Get(int slot, T* value) const {
+    const AttrValue* attr_value = values_[slot];
+    if (attr_value == nullptr) {
+      return errors::NotFound("No attr named '", names_[slot],
+                              "' in NodeDef");
+    }
+    return AttrValueTo(*attr_value, names_[slot], value);
+  }
+
+ private:
+  gtl::InlinedVector<StringPiece, 4> names_;
+  gtl::InlinedVector<const AttrValue*, 4> values_;
+};
+
 // Return true if the attr with the name attr_name is defined in node_def.
 bool HasNodeAttr(const NodeDef& node_def, StringPiece attr_name);
 
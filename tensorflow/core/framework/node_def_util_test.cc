@@ -573,6 +573,46 @@ TEST(FormatNodeForErrorTest, NodeDef) {
   EXPECT_EQ("{{node enter}}", FormatNodeDefForError(node_def));
 }
 
+TEST(AttrSlotsTest, BindAndGet) {
+  NodeDef node_def;
+  node_def.set_name("enter");
+  node_def.set_op("Enter");
+  AddNodeAttr("frame_name", "test_frame", &node_def);
+  AddNodeAttr("is_constant", true, &node_def);
+
+  AttrSlots slots({"frame_name", "is_constant", "missing"});
+  slots.Bind(node_def);
+
+  EXPECT_TRUE(slots.Has(0));
+  EXPECT_TRUE(slots.Has(1));
+  EXPECT_FALSE(slots.Has(2));
+  EXPECT_EQ(nullptr, slots.Find(2));
+
+  string frame_name;
+  TF_ASSERT_OK(slots.Get(0, &frame_name));
+  EXPECT_EQ("test_frame", frame_name);
+  bool is_constant = false;
+  TF_ASSERT_OK(slots.Get(1, &is_constant));
+  EXPECT_TRUE(is_constant);
+
+  // Absent slots report NotFound; type mismatches are still caught.
+  Status status = slots.Get(2, &frame_name);
+  EXPECT_TRUE(errors::IsNotFound(status)) << status;
+  int64 as_int;
+  EXPECT_FALSE(slots.Get(0, &as_int).ok());
+
+  // Rebinding drops values from the previous node.
+  NodeDef other;
+  other.set_name("other");
+  other.set_op("Enter");
+  AddNodeAttr("frame_name", "other_frame", &other);
+  slots.Bind(other);
+  EXPECT_TRUE(slots.Has(0));
+  EXPECT_FALSE(slots.Has(1));
+  TF_ASSERT_OK(slots.Get(0, &frame_name));
+  EXPECT_EQ("other_frame", frame_name);
+}
+
 TEST(AttachDef, AllowMultipleFormattedNode) {
   NodeDef a;
   a.set_name("a");
@@ -44,6 +44,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/platform_strings.h"
@@ -106,7 +107,9 @@ OpKernel::OpKernel(OpKernelConstruction* context,
       is_internal_(str_util::StartsWith(type_string(), "_")),
       input_name_map_(context->num_inputs()),
       output_name_map_(context->num_outputs()),
-      cost_estimate_(OpKernel::kInitialCostEstimateCycles) {
+      cost_estimate_(OpKernel::kInitialCostEstimateCycles),
+      is_expensive_(true),
+      run_count_(0) {
   OP_REQUIRES_OK(context,
                  NameRangesForNode(*def_, *context->op_def_, &input_name_map_,
                                    &output_name_map_));
@@ -123,7 +126,9 @@ OpKernel::~OpKernel() {}
 
 const uint64 OpKernel::kInitialCostEstimateCycles;
 const uint64 OpKernel::kOpIsExpensiveThresholdCycles;
+const uint64 OpKernel::kOpIsInexpensiveThresholdCycles;
 const uint64 OpKernel::kCostDecay;
+const uint32 OpKernel::kCostSamplePeriod;
 
 const string& OpKernel::name() const { return def_->name(); }
 const string& OpKernel::type_string() const { return def_->op(); }
@@ -319,6 +324,9 @@ Allocator* OpKernelContext::get_allocator(AllocatorAttributes attr) {
   if (TF_PREDICT_FALSE(attr.scope_id > 0)) {
     allocator = params_->device->GetScopedAllocator(attr, step_id());
     CHECK(allocator);
+  } else if (TF_PREDICT_FALSE(params_->allocator_override != nullptr &&
+                              attr.value == 0)) {
+    allocator = params_->allocator_override;
   } else {
     allocator = params_->device->GetAllocator(attr);
   }
@@ -702,7 +710,13 @@ Status OpKernelContext::allocate_output(StringPiece name,
 Status OpKernelContext::allocate_tensor(
     DataType type, const TensorShape& shape, Tensor* out_tensor,
     AllocatorAttributes attr, const AllocationAttributes& allocation_attr) {
-  Allocator* a = get_allocator(attr);
+  return allocate_tensor_with_allocator(get_allocator(attr), type, shape,
+                                        out_tensor, allocation_attr);
+}
+
+Status OpKernelContext::allocate_tensor_with_allocator(
+    Allocator* a, DataType type, const TensorShape& shape, Tensor* out_tensor,
+    const AllocationAttributes& allocation_attr) {
   AllocationAttributes logged_attr(allocation_attr);
   logged_attr.allocation_will_be_logged = true;
   Tensor new_tensor(a, type, shape, logged_attr);
@@ -739,12 +753,28 @@ Status OpKernelContext::allocate_output(int index, const TensorShape& shape,
   return s;
 }
 
+Allocator* OpKernelContext::step_arena_allocator(
+    AllocatorAttributes attr) const {
+  // Allocations with non-default attributes (e.g. gpu_compatible host
+  // memory) or scoped allocation must go through get_allocator(), and the
+  // allocation-tracking bookkeeping expects the device allocators.
+  if (attr.value != 0 || attr.scope_id != 0 || track_allocations()) {
+    return nullptr;
+  }
+  return params_->step_arena_allocator;
+}
+
 Status OpKernelContext::allocate_temp(
     DataType type, const TensorShape& shape, Tensor* out_temp,
     AllocatorAttributes allocator_attr,
     const AllocationAttributes& allocation_attr) {
+  Allocator* arena = step_arena_allocator(allocator_attr);
   Status s =
-      allocate_tensor(type, shape, out_temp, allocator_attr, allocation_attr);
+      arena != nullptr
+          ? allocate_tensor_with_allocator(arena, type, shape, out_temp,
+                                           allocation_attr)
+          : allocate_tensor(type, shape, out_temp, allocator_attr,
+                            allocation_attr);
   if (track_allocations() && s.ok() && out_temp->TotalBytes() > 0) {
     Allocator* a = get_allocator(allocator_attr);
     if (a->TracksAllocationSizes()) {
@@ -948,10 +978,12 @@ struct KernelRegistration {
   std::unique_ptr<kernel_factory::OpKernelFactory> factory;
 };
 
-// This maps from 'op_type' + DeviceType to the set of KernelDefs and
-// factory functions for instantiating the OpKernel that matches the
-// KernelDef.
-typedef std::unordered_multimap<string, KernelRegistration> KernelRegistry;
+// This maps from a fingerprint of 'op_type' + DeviceType + label to the set
+// of KernelDefs and factory functions for instantiating the OpKernel that
+// matches the KernelDef.  Keying by fingerprint rather than by a composed
+// string avoids allocating and hashing a fresh key string on every lookup;
+// graph instantiation of large models performs millions of such probes.
+typedef std::unordered_multimap<uint64, KernelRegistration> KernelRegistry;
 
 #if defined(_WIN32)
 static const char kKernelLibPattern[] = "libtfkernel*.dll";
@@ -1057,10 +1089,23 @@ static KernelRegistry* GlobalKernelRegistryTyped() {
   return reinterpret_cast<KernelRegistry*>(GlobalKernelRegistry());
 }
 
-static string Key(StringPiece op_type, const DeviceType& device_type,
+static uint64 Key(StringPiece op_type, const DeviceType& device_type,
                   StringPiece label) {
-  return strings::StrCat(op_type, ":", DeviceTypeString(device_type), ":",
-                         label);
+  return FingerprintCat64(
+      FingerprintCat64(Fingerprint64(op_type),
+                       Fingerprint64(device_type.type_string())),
+      Fingerprint64(label));
+}
+
+// Returns true if 'registration' was registered under exactly the
+// (op, device type, label) triple that produced the fingerprint used to
+// find it.  Guards attr matching against fingerprint collisions.
+static bool KeyMatches(const KernelRegistration& registration,
+                       StringPiece op_type, const DeviceType& device_type,
+                       StringPiece label) {
+  return registration.def.op() == op_type &&
+         registration.def.device_type() == device_type.type_string() &&
+         registration.def.label() == label;
 }
 
 namespace kernel_factory {
@@ -1070,7 +1115,7 @@ void OpKernelRegistrar::InitInternal(const KernelDef* kernel_def,
                                      std::unique_ptr<OpKernelFactory> factory) {
   // See comments in register_kernel::Name in header for info on _no_register.
   if (kernel_def->op() != "_no_register") {
-    const string key =
+    const uint64 key =
         Key(kernel_def->op(), DeviceType(kernel_def->device_type()),
             kernel_def->label());
 
@@ -1109,9 +1154,14 @@ Status FindKernelRegistration(const DeviceType& device_type,
   // Label defaults to empty if not found in NodeDef.
   const string& label = GetNodeAttrString(node_def, kKernelAttr);
 
-  const string key = Key(node_def.op(), device_type, label);
+  const uint64 key = Key(node_def.op(), device_type, label);
   auto regs = GlobalKernelRegistryTyped()->equal_range(key);
   for (auto iter = regs.first; iter != regs.second; ++iter) {
+    if (!KeyMatches(iter->second, node_def.op(), device_type, label)) {
+      // Fingerprint collision with a registration for a different
+      // (op, device type, label) triple.
+      continue;
+    }
     // If there is a kernel registered for the op and device_type,
     // check that the attrs match.
     bool match;
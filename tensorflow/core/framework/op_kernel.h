@@ -36,6 +36,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"  // TODO(b/62899350): Remove
+#include "tensorflow/core/framework/thread_scratchpad.h"
 #include "tensorflow/core/framework/tracking_allocator.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
@@ -122,15 +123,36 @@ class OpKernel {
   // determine whether an operation should be place in a threadpool.  Operations
   // start out "expensive".
   static const uint64 kInitialCostEstimateCycles = 100 * 1000 * 1000;
+  // Classification thresholds, with hysteresis: an expensive kernel becomes
+  // inexpensive once its cost estimate drops below the lower threshold, and
+  // an inexpensive one becomes expensive again only after the estimate rises
+  // above the upper threshold.  The gap keeps kernels whose cost hovers near
+  // a single threshold from flapping between inline and scheduled execution.
   static const uint64 kOpIsExpensiveThresholdCycles = 5000;
+  static const uint64 kOpIsInexpensiveThresholdCycles = 2000;
   static const uint64 kCostDecay = 10;
+  // Inexpensive kernels are re-timed once every kCostSamplePeriod runs so a
+  // kernel that was misclassified (or whose workload grows over time) can
+  // migrate back to scheduled execution.
+  static const uint32 kCostSamplePeriod = 16;
 
   // Returns true iff this op kernel is considered "expensive". The
   // runtime may use this flag to optimize graph execution for example
   // to "inline" inexpensive kernels.
   virtual bool IsExpensive() {
-    return expensive_ && (cost_estimate_.load(std::memory_order_relaxed) >
-                          kOpIsExpensiveThresholdCycles);
+    return expensive_ && is_expensive_.load(std::memory_order_relaxed);
+  }
+
+  // Returns true if this run of the kernel should be timed and the result
+  // fed back through UpdateCostEstimate().  Expensive kernels are always
+  // timed; inexpensive kernels are only sampled, so the common fast path
+  // does not pay for the clock reads.
+  bool ShouldTimeExecution() {
+    if (IsExpensive()) return true;
+    return expensive_ &&
+           (run_count_.fetch_add(1, std::memory_order_relaxed) %
+                kCostSamplePeriod ==
+            0);
   }
 
   // Updates the dynamic cost estimate, which is used to determine whether this
@@ -140,11 +162,18 @@ class OpKernel {
     // N.B. Updates to `cost_estimate_` are atomic but unlocked.  Simulataneous
     // updates may result in one or more updates being ignored.  This does not
     // affect correctness but may slow down the update frequency.
-    cost_estimate_.store(
+    const uint64 new_estimate =
         (kCostDecay - 1) * cost_estimate_.load(std::memory_order_relaxed) /
-                kCostDecay +
-            (elapsed_cycles / kCostDecay),
-        std::memory_order_relaxed);
+            kCostDecay +
+        (elapsed_cycles / kCostDecay);
+    cost_estimate_.store(new_estimate, std::memory_order_relaxed);
+    if (is_expensive_.load(std::memory_order_relaxed)) {
+      if (new_estimate < kOpIsInexpensiveThresholdCycles) {
+        is_expensive_.store(false, std::memory_order_relaxed);
+      }
+    } else if (new_estimate > kOpIsExpensiveThresholdCycles) {
+      is_expensive_.store(true, std::memory_order_relaxed);
+    }
   }
 
   // Accessors.
@@ -211,6 +240,10 @@ class OpKernel {
   NameRangeMap output_name_map_;
   bool expensive_;
   std::atomic_uint_fast64_t cost_estimate_;
+  // Cached classification derived from cost_estimate_, with hysteresis.
+  std::atomic<bool> is_expensive_;
+  // Counts runs of an inexpensive kernel for cost re-sampling.
+  std::atomic<uint32> run_count_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(OpKernel);
 };
@@ -626,6 +659,16 @@ class OpKernelContext {
     // stored in this container..
     ScopedStepContainer* step_container = nullptr;
 
+    // If non-null, an arena owned by the executor from which allocate_temp()
+    // serves allocations with default attributes; the executor releases the
+    // arena at the end of the step.
+    Allocator* step_arena_allocator = nullptr;
+
+    // If non-null, allocations made with default allocator attributes are
+    // served from this allocator instead of the device's. Used by the eager
+    // runtime to recycle same-sized output buffers across ops.
+    Allocator* allocator_override = nullptr;
+
     // Mechanism used by this op kernel invocation to communicate with
     // computations running on other devices.
     Rendezvous* rendezvous = nullptr;
@@ -666,6 +709,10 @@ class OpKernelContext {
     CallFrameInterface* call_frame = nullptr;
     FunctionLibraryRuntime* function_library = nullptr;
     std::function<void(std::function<void()>)>* runner = nullptr;
+    // If true, the executor running this kernel processes all kernels on
+    // the scheduling thread; function-calling kernels should propagate the
+    // hint into nested executions.
+    bool run_all_kernels_inline = false;
     StepStatsCollectorInterface* stats_collector = nullptr;
     GraphCollector* graph_collector = nullptr;
 
@@ -977,6 +1024,16 @@ class OpKernelContext {
     return allocate_temp(type, shape, out_temp, AllocatorAttributes());
   }
 
+  // Checks out a reusable per-thread scratch buffer of at least num_bytes
+  // for raw workspace used entirely within Compute(), e.g. im2col patch
+  // buffers or sort scratch.  Cheaper than allocate_temp() for CPU kernels
+  // that request the same size on every call; the buffer is untyped, not
+  // tracked, and returns to the calling thread's cache when the handle is
+  // destroyed.  See ThreadScratchpad.
+  ThreadScratchpad::Handle scratchpad(size_t num_bytes) const {
+    return ThreadScratchpad::Checkout(num_bytes);
+  }
+
   // Allocates a Tensor of the specified type and shape which the Op
   // plans to maintain as persistent state. out_persistent holds the
   // PersistentTensor which is the object the caller should store. For
@@ -1093,6 +1150,9 @@ class OpKernelContext {
   std::function<void(std::function<void()>)>* runner() const {
     return params_->runner;
   }
+  bool run_all_kernels_inline() const {
+    return params_->run_all_kernels_inline;
+  }
   StepStatsCollectorInterface* stats_collector() const {
     return params_->stats_collector;
   }
@@ -1247,6 +1307,16 @@ class OpKernelContext {
                          Tensor* out_tensor, AllocatorAttributes allocator_attr,
                          const AllocationAttributes& allocation_attr);
 
+  // Variant of the above that allocates from the given allocator instead of
+  // the one selected by `get_allocator()`.
+  Status allocate_tensor_with_allocator(
+      Allocator* a, DataType type, const TensorShape& shape,
+      Tensor* out_tensor, const AllocationAttributes& allocation_attr);
+
+  // Returns the executor's per-step arena if allocations with `attr` may be
+  // served from it, otherwise nullptr.
+  Allocator* step_arena_allocator(AllocatorAttributes attr) const;
+
   // This is called by PersistentTensor::AccessTensor whenever the
   // wrapped tensor is retrieved, to ensure the runtime knows that the
   // Tensor is being accessed within an Op. This is necessary for
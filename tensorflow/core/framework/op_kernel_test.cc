@@ -204,6 +204,50 @@ TEST_F(OpKernelTest, SuccessBothCpuAndGpu) {
   ExpectSuccess("Test3", DEVICE_GPU, {DT_FLOAT, DT_FLOAT}, {});
 }
 
+TEST_F(OpKernelTest, CostEstimateHysteresis) {
+  DeviceBase device(Env::Default());
+  Status status;
+  std::unique_ptr<OpKernel> op(
+      CreateOpKernel(DEVICE_CPU, &device, cpu_allocator(),
+                     CreateNodeDef("Test1", {DT_FLOAT, DT_INT32}),
+                     TF_GRAPH_DEF_VERSION, &status));
+  TF_ASSERT_OK(status);
+
+  // Kernels start out expensive and are always timed while expensive.
+  EXPECT_TRUE(op->IsExpensive());
+  EXPECT_TRUE(op->ShouldTimeExecution());
+
+  // Repeated fast runs drive the decayed estimate below the lower threshold
+  // and demote the kernel to inexpensive.
+  for (int i = 0; i < 200; ++i) {
+    op->UpdateCostEstimate(1);
+  }
+  EXPECT_FALSE(op->IsExpensive());
+
+  // One slow run leaves the estimate inside the hysteresis band, which must
+  // not flip the classification back.
+  op->UpdateCostEstimate(10 * OpKernel::kOpIsInexpensiveThresholdCycles);
+  EXPECT_FALSE(op->IsExpensive());
+
+  // Sustained slow runs push the estimate above the upper threshold and
+  // promote the kernel back to expensive.
+  for (int i = 0; i < 200; ++i) {
+    op->UpdateCostEstimate(100 * OpKernel::kOpIsExpensiveThresholdCycles);
+  }
+  EXPECT_TRUE(op->IsExpensive());
+
+  // While inexpensive, only one run per sample period is timed.
+  for (int i = 0; i < 200; ++i) {
+    op->UpdateCostEstimate(1);
+  }
+  EXPECT_FALSE(op->IsExpensive());
+  int timed = 0;
+  for (uint32 i = 0; i < OpKernel::kCostSamplePeriod; ++i) {
+    if (op->ShouldTimeExecution()) ++timed;
+  }
+  EXPECT_EQ(1, timed);
+}
+
 TEST_F(OpKernelTest, CpuTypeRegistered) {
   NodeDef ndef = CreateNodeDef("Test1", {DT_FLOAT, DT_INT32});
   PrioritizedDeviceTypeVector devs;
@@ -80,6 +80,7 @@ Status ValidateDevice(OpKernelContext* ctx, const ResourceHandle& p) {
 
 Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
                                         const string& type_name) {
+  mutex_lock l(debug_mu_);
   auto iter = debug_type_names_.emplace(hash_code, type_name);
   if (iter.first->second != type_name) {
     return errors::AlreadyExists("Duplicate hash code found for type ",
@@ -89,6 +90,9 @@ Status ResourceMgr::InsertDebugTypeName(uint64 hash_code,
 }
 
 const char* ResourceMgr::DebugTypeName(uint64 hash_code) const {
+  // Entries are never removed, so the returned pointer stays valid after
+  // the lock is released.
+  mutex_lock l(debug_mu_);
   auto type_name_iter = debug_type_names_.find(hash_code);
   if (type_name_iter == debug_type_names_.end()) {
     return "<unknown>";
@@ -97,63 +101,70 @@ const char* ResourceMgr::DebugTypeName(uint64 hash_code) const {
   }
 }
 
-ResourceMgr::ResourceMgr() : default_container_("localhost") {}
+ResourceMgr::ResourceMgr() : default_container_("localhost"), generation_(0) {}
 
 ResourceMgr::ResourceMgr(const string& default_container)
-    : default_container_(default_container) {}
+    : default_container_(default_container), generation_(0) {}
 
 ResourceMgr::~ResourceMgr() { Clear(); }
 
 void ResourceMgr::Clear() {
-  mutex_lock l(mu_);
-  for (const auto& p : containers_) {
-    for (const auto& q : *p.second) {
-      q.second->Unref();
+  for (int i = 0; i < kNumShards; ++i) {
+    mutex_lock l(shards_[i].mu);
+    for (const auto& p : shards_[i].containers) {
+      for (const auto& q : *p.second) {
+        q.second->Unref();
+      }
+      delete p.second;
     }
-    delete p.second;
+    shards_[i].containers.clear();
   }
-  containers_.clear();
+  BumpGeneration();
 }
 
 string ResourceMgr::DebugString() const {
-  mutex_lock l(mu_);
   struct Line {
-    const string* container;
+    const string container;
     const string type;
-    const string* resource;
+    const string resource;
     const string detail;
   };
   std::vector<Line> lines;
-  for (const auto& p : containers_) {
-    const string& container = p.first;
-    for (const auto& q : *p.second) {
-      const Key& key = q.first;
-      const char* type = DebugTypeName(key.first);
-      const string& resource = key.second;
-      Line l{&container, port::Demangle(type), &resource,
-             q.second->DebugString()};
-      lines.push_back(l);
+  for (int i = 0; i < kNumShards; ++i) {
+    mutex_lock l(shards_[i].mu);
+    for (const auto& p : shards_[i].containers) {
+      const string& container = p.first;
+      for (const auto& q : *p.second) {
+        const Key& key = q.first;
+        const char* type = DebugTypeName(key.first);
+        const string& resource = key.second;
+        Line l{container, port::Demangle(type), resource,
+               q.second->DebugString()};
+        lines.push_back(l);
+      }
     }
   }
   std::vector<string> text;
   text.reserve(lines.size());
   for (const Line& line : lines) {
     text.push_back(strings::Printf(
-        "%-20s | %-40s | %-40s | %-s", line.container->c_str(),
-        line.type.c_str(), line.resource->c_str(), line.detail.c_str()));
+        "%-20s | %-40s | %-40s | %-s", line.container.c_str(),
+        line.type.c_str(), line.resource.c_str(), line.detail.c_str()));
   }
   std::sort(text.begin(), text.end());
   return str_util::Join(text, "\n");
 }
 
-Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
-                             const string& name, ResourceBase* resource) {
-  Container** b = &containers_[container];
+Status ResourceMgr::DoCreate(ResourceShard* shard, const string& container,
+                             TypeIndex type, const string& name,
+                             ResourceBase* resource) {
+  Container** b = &shard->containers[container];
   if (*b == nullptr) {
     *b = new Container;
   }
   if ((*b)->insert({{type.hash_code(), name}, resource}).second) {
     TF_RETURN_IF_ERROR(InsertDebugTypeName(type.hash_code(), type.name()));
+    BumpGeneration();
     return Status::OK();
   }
   resource->Unref();
@@ -161,10 +172,10 @@ Status ResourceMgr::DoCreate(const string& container, TypeIndex type,
                                type.name());
 }
 
-Status ResourceMgr::DoLookup(const string& container, TypeIndex type,
-                             const string& name,
+Status ResourceMgr::DoLookup(ResourceShard* shard, const string& container,
+                             TypeIndex type, const string& name,
                              ResourceBase** resource) const {
-  const Container* b = gtl::FindPtrOrNull(containers_, container);
+  const Container* b = gtl::FindPtrOrNull(shard->containers, container);
   if (b == nullptr) {
     return errors::NotFound("Container ", container,
                             " does not exist. (Could not find resource: ",
@@ -185,8 +196,9 @@ Status ResourceMgr::DoDelete(const string& container, uint64 type_hash_code,
                              const string& type_name) {
   ResourceBase* base = nullptr;
   {
-    mutex_lock l(mu_);
-    Container* b = gtl::FindPtrOrNull(containers_, container);
+    ResourceShard* s = shard(container);
+    mutex_lock l(s->mu);
+    Container* b = gtl::FindPtrOrNull(s->containers, container);
     if (b == nullptr) {
       return errors::NotFound("Container ", container, " does not exist.");
     }
@@ -199,6 +211,7 @@ Status ResourceMgr::DoDelete(const string& container, uint64 type_hash_code,
     b->erase(iter);
   }
   CHECK(base != nullptr);
+  BumpGeneration();
   base->Unref();
   return Status::OK();
 }
@@ -214,25 +227,27 @@ Status ResourceMgr::Delete(const ResourceHandle& handle) {
 }
 
 Status ResourceMgr::Cleanup(const string& container) {
+  ResourceShard* s = shard(container);
   {
-    tf_shared_lock l(mu_);
-    if (!gtl::FindOrNull(containers_, container)) {
+    tf_shared_lock l(s->mu);
+    if (!gtl::FindOrNull(s->containers, container)) {
       // Nothing to cleanup.
       return Status::OK();
     }
   }
   Container* b = nullptr;
   {
-    mutex_lock l(mu_);
-    auto iter = containers_.find(container);
-    if (iter == containers_.end()) {
+    mutex_lock l(s->mu);
+    auto iter = s->containers.find(container);
+    if (iter == s->containers.end()) {
       // Nothing to cleanup, it's OK (concurrent cleanup).
       return Status::OK();
     }
     b = iter->second;
-    containers_.erase(iter);
+    s->containers.erase(iter);
   }
   CHECK(b != nullptr);
+  BumpGeneration();
   for (const auto& p : *b) {
     p.second->Unref();
   }
@@ -16,6 +16,7 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 #define TENSORFLOW_CORE_FRAMEWORK_RESOURCE_MGR_H_
 
+#include <atomic>
 #include <memory>
 #include <string>
 #include <typeindex>
@@ -136,9 +137,10 @@ class ResourceMgr {
   Status Lookup(const string& container, const string& name,
                 T** resource) const TF_MUST_USE_RESULT;
 
-  // Similar to Lookup, but looks up multiple resources at once, with only a
-  // single lock acquisition.  If containers_and_names[i] is uninitialized
-  // then this function does not modify resources[i].
+  // Similar to Lookup, but looks up multiple resources at once, taking each
+  // container's shard lock at most once per entry.  If
+  // containers_and_names[i] is uninitialized then this function does not
+  // modify resources[i].
   template <typename T, bool use_dynamic_cast = false>
   Status LookupMany(absl::Span<std::pair<const string*, const string*> const>
                         containers_and_names,
@@ -178,6 +180,11 @@ class ResourceMgr {
   // Returns a text description for all resources.
   string DebugString() const;
 
+  // Returns a counter that is bumped by every successful mutation (Create,
+  // Delete, Cleanup, Clear). Kernels may cache the result of a lookup and
+  // keep serving it for as long as the generation is unchanged.
+  int64 generation() const { return generation_.load(); }
+
  private:
   typedef std::pair<uint64, string> Key;
   struct KeyHash {
@@ -192,22 +199,38 @@ class ResourceMgr {
   };
   typedef std::unordered_map<Key, ResourceBase*, KeyHash, KeyEqual> Container;
 
+  // Containers are partitioned into shards keyed by a hash of the container
+  // name, each with its own mutex, so that accesses to resources in
+  // different containers do not all contend on one global lock.
+  struct ResourceShard {
+    mutable mutex mu;
+    std::unordered_map<string, Container*> containers GUARDED_BY(mu);
+  };
+  static const int kNumShards = 16;
+
   const string default_container_;
-  mutable mutex mu_;
-  std::unordered_map<string, Container*> containers_ GUARDED_BY(mu_);
+  mutable ResourceShard shards_[kNumShards];
+  std::atomic<int64> generation_;
+
+  ResourceShard* shard(const string& container) const {
+    return &shards_[Hash64(container.data(), container.size()) % kNumShards];
+  }
+
+  void BumpGeneration() { generation_.fetch_add(1); }
 
   template <typename T, bool use_dynamic_cast = false>
-  Status LookupInternal(const string& container, const string& name,
-                        T** resource) const
-      SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status LookupInternal(ResourceShard* shard, const string& container,
+                        const string& name, T** resource) const
+      SHARED_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
 
-  Status DoCreate(const string& container, TypeIndex type, const string& name,
-                  ResourceBase* resource)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+  Status DoCreate(ResourceShard* shard, const string& container,
+                  TypeIndex type, const string& name, ResourceBase* resource)
+      EXCLUSIVE_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
 
-  Status DoLookup(const string& container, TypeIndex type, const string& name,
+  Status DoLookup(ResourceShard* shard, const string& container,
+                  TypeIndex type, const string& name,
                   ResourceBase** resource) const
-      SHARED_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      SHARED_LOCKS_REQUIRED(shard->mu) TF_MUST_USE_RESULT;
 
   Status DoDelete(const string& container, uint64 type_hash_code,
                   const string& resource_name,
@@ -217,16 +240,16 @@ class ResourceMgr {
 
   // Inserts the type name for 'hash_code' into the hash_code to type name map.
   Status InsertDebugTypeName(uint64 hash_code, const string& type_name)
-      EXCLUSIVE_LOCKS_REQUIRED(mu_) TF_MUST_USE_RESULT;
+      LOCKS_EXCLUDED(debug_mu_) TF_MUST_USE_RESULT;
 
   // Returns the type name for the 'hash_code'.
   // Returns "<unknown>" if a resource with such a type was never inserted into
   // the container.
-  const char* DebugTypeName(uint64 hash_code) const
-      EXCLUSIVE_LOCKS_REQUIRED(mu_);
+  const char* DebugTypeName(uint64 hash_code) const LOCKS_EXCLUDED(debug_mu_);
 
   // Map from type hash_code to type name.
-  std::unordered_map<uint64, string> debug_type_names_ GUARDED_BY(mu_);
+  mutable mutex debug_mu_;
+  std::unordered_map<uint64, string> debug_type_names_ GUARDED_BY(debug_mu_);
 
   TF_DISALLOW_COPY_AND_ASSIGN(ResourceMgr);
 };
@@ -433,16 +456,18 @@ Status ResourceMgr::Create(const string& container, const string& name,
                            T* resource) {
   CheckDeriveFromResourceBase<T>();
   CHECK(resource != nullptr);
-  mutex_lock l(mu_);
-  return DoCreate(container, MakeTypeIndex<T>(), name, resource);
+  ResourceShard* s = shard(container);
+  mutex_lock l(s->mu);
+  return DoCreate(s, container, MakeTypeIndex<T>(), name, resource);
 }
 
 template <typename T, bool use_dynamic_cast>
 Status ResourceMgr::Lookup(const string& container, const string& name,
                            T** resource) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
-  return LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  ResourceShard* s = shard(container);
+  tf_shared_lock l(s->mu);
+  return LookupInternal<T, use_dynamic_cast>(s, container, name, resource);
 }
 
 template <typename T, bool use_dynamic_cast>
@@ -451,14 +476,15 @@ Status ResourceMgr::LookupMany(
         containers_and_names,
     std::vector<std::unique_ptr<T, core::RefCountDeleter>>* resources) const {
   CheckDeriveFromResourceBase<T>();
-  tf_shared_lock l(mu_);
   resources->resize(containers_and_names.size());
   for (size_t i = 0; i < containers_and_names.size(); ++i) {
     T* resource;
-    Status s = LookupInternal<T, use_dynamic_cast>(
-        *containers_and_names[i].first, *containers_and_names[i].second,
+    ResourceShard* s = shard(*containers_and_names[i].first);
+    tf_shared_lock l(s->mu);
+    Status status = LookupInternal<T, use_dynamic_cast>(
+        s, *containers_and_names[i].first, *containers_and_names[i].second,
         &resource);
-    if (s.ok()) {
+    if (status.ok()) {
       (*resources)[i].reset(resource);
     }
   }
@@ -477,10 +503,11 @@ struct TypeCastFunctor<T, true> {
 };
 
 template <typename T, bool use_dynamic_cast>
-Status ResourceMgr::LookupInternal(const string& container, const string& name,
+Status ResourceMgr::LookupInternal(ResourceShard* shard,
+                                   const string& container, const string& name,
                                    T** resource) const {
   ResourceBase* found = nullptr;
-  Status s = DoLookup(container, MakeTypeIndex<T>(), name, &found);
+  Status s = DoLookup(shard, container, MakeTypeIndex<T>(), name, &found);
   if (s.ok()) {
     // It's safe to down cast 'found' to T* since
     // typeid(T).hash_code() is part of the map key.
@@ -496,16 +523,17 @@ Status ResourceMgr::LookupOrCreate(const string& container, const string& name,
   CheckDeriveFromResourceBase<T>();
   *resource = nullptr;
   Status s;
+  ResourceShard* sh = shard(container);
   {
-    tf_shared_lock l(mu_);
-    s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+    tf_shared_lock l(sh->mu);
+    s = LookupInternal<T, use_dynamic_cast>(sh, container, name, resource);
     if (s.ok()) return s;
   }
-  mutex_lock l(mu_);
-  s = LookupInternal<T, use_dynamic_cast>(container, name, resource);
+  mutex_lock l(sh->mu);
+  s = LookupInternal<T, use_dynamic_cast>(sh, container, name, resource);
   if (s.ok()) return s;
   TF_RETURN_IF_ERROR(creator(resource));
-  s = DoCreate(container, MakeTypeIndex<T>(), name, *resource);
+  s = DoCreate(sh, container, MakeTypeIndex<T>(), name, *resource);
   if (!s.ok()) {
     return errors::Internal("LookupOrCreate failed unexpectedly");
   }
@@ -586,6 +614,73 @@ Status LookupResource(OpKernelContext* ctx, const ResourceHandle& p,
                                                               p.name(), value);
 }
 
+// Caches the result of looking up a resource by handle so that kernels on a
+// hot path (e.g. ReadVariableOp) resolve steady-state lookups without
+// touching the resource manager's locks. The cache holds one reference on
+// the resource and is invalidated whenever the resource manager's generation
+// changes, i.e. whenever any resource is created or deleted, so it can never
+// serve a resource that has since been replaced or removed.
+//
+// A kernel embeds one instance per looked-up input and calls Lookup() in
+// place of LookupResource(); the contract is the same.
+template <typename T>
+class CachedResourceLookup {
+ public:
+  CachedResourceLookup()
+      : generation_(-1), mgr_(nullptr), hash_code_(0), cached_(nullptr) {}
+
+  ~CachedResourceLookup() {
+    mutex_lock l(mu_);
+    if (cached_ != nullptr) cached_->Unref();
+  }
+
+  // On success the caller takes the ownership of one ref on "*value".
+  Status Lookup(OpKernelContext* ctx, const ResourceHandle& p, T** value) {
+    TF_RETURN_IF_ERROR(internal::ValidateDeviceAndType<T>(ctx, p));
+    ResourceMgr* mgr = ctx->resource_manager();
+    // The generation is read before the lookup: a mutation racing with the
+    // lookup below at worst leaves a stale generation behind, which forces
+    // the next call to look the resource up again.
+    const int64 generation = mgr->generation();
+    {
+      mutex_lock l(mu_);
+      if (cached_ != nullptr && generation_ == generation && mgr_ == mgr &&
+          hash_code_ == p.hash_code() && name_ == p.name() &&
+          container_ == p.container()) {
+        cached_->Ref();
+        *value = cached_;
+        return Status::OK();
+      }
+    }
+    T* found = nullptr;
+    TF_RETURN_IF_ERROR(mgr->Lookup(p.container(), p.name(), &found));
+    {
+      mutex_lock l(mu_);
+      if (cached_ != nullptr) cached_->Unref();
+      found->Ref();
+      cached_ = found;
+      generation_ = generation;
+      mgr_ = mgr;
+      container_ = p.container();
+      name_ = p.name();
+      hash_code_ = p.hash_code();
+    }
+    *value = found;
+    return Status::OK();
+  }
+
+ private:
+  mutex mu_;
+  int64 generation_ GUARDED_BY(mu_);
+  ResourceMgr* mgr_ GUARDED_BY(mu_);
+  string container_ GUARDED_BY(mu_);
+  string name_ GUARDED_BY(mu_);
+  uint64 hash_code_ GUARDED_BY(mu_);
+  T* cached_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CachedResourceLookup);
+};
+
 template <typename T>
 Status LookupResources(
     OpKernelContext* ctx, absl::Span<ResourceHandle const* const> p,
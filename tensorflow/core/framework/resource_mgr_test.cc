@@ -161,6 +161,23 @@ TEST(ResourceMgrTest, CreateOrLookupRaceCondition) {
   EXPECT_EQ(1, atomic_int);
 }
 
+TEST(ResourceMgrTest, GenerationBumpsOnMutation) {
+  ResourceMgr rm;
+  const int64 gen0 = rm.generation();
+  TF_CHECK_OK(rm.Create("foo", "bar", new Resource("cat")));
+  const int64 gen1 = rm.generation();
+  EXPECT_GT(gen1, gen0);
+  // Lookups do not change the generation.
+  EXPECT_EQ("R/cat", Find<Resource>(rm, "foo", "bar"));
+  EXPECT_EQ(gen1, rm.generation());
+  TF_CHECK_OK(rm.Delete<Resource>("foo", "bar"));
+  const int64 gen2 = rm.generation();
+  EXPECT_GT(gen2, gen1);
+  TF_CHECK_OK(rm.Create("foo", "bar", new Resource("dog")));
+  TF_CHECK_OK(rm.Cleanup("foo"));
+  EXPECT_GT(rm.generation(), gen2);
+}
+
 Status ComputePolicy(const string& attr_container,
                      const string& attr_shared_name,
                      bool use_node_name_as_default, string* result) {
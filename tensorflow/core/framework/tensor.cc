@@ -29,6 +29,9 @@ limitations under the License.
 
 #include "tensorflow/core/framework/tensor.h"
 
+#include <stdlib.h>
+#include <string.h>
+
 #include "tensorflow/core/framework/allocation_description.pb.h"
 #include "tensorflow/core/framework/log_memory.h"
 #include "tensorflow/core/framework/resource_handle.pb.h"
@@ -119,6 +122,105 @@ class Buffer : public BufferBase {
   TF_DISALLOW_COPY_AND_ASSIGN(Buffer);
 };
 
+// A ref-counted buffer for small host tensors whose element storage lives in
+// the same heap allocation as the buffer object itself, halving the number of
+// allocations for the scalar and small index tensors that dominate allocation
+// counts in many graphs. Refcount semantics are unchanged: the storage lives
+// exactly as long as the buffer, which may outlive the Tensor that created
+// it. Only used for simple element types, so no element constructors or
+// destructors need to run.
+template <typename T>
+class InlineBuffer : public TensorBuffer {
+ public:
+  static InlineBuffer* Make(int64 n) {
+    char* base = static_cast<char*>(port::AlignedMalloc(
+        DataOffset() + n * sizeof(T), EIGEN_MAX_ALIGN_BYTES));
+    return new (base) InlineBuffer(n, base + DataOffset());
+  }
+
+  size_t size() const override { return sizeof(T) * elem_; }
+  TensorBuffer* root_buffer() override { return this; }
+  void FillAllocationDescription(AllocationDescription* proto) const override {
+    proto->set_requested_bytes(size());
+    proto->set_allocator_name("InlineTensorBuffer");
+    proto->set_ptr(reinterpret_cast<uintptr_t>(data()));
+  }
+
+  // Calling `delete this` in core::RefCounted::Unref() must free the combined
+  // allocation made by Make().
+  static void operator delete(void* ptr) { port::AlignedFree(ptr); }
+  static void operator delete(void*, void*) {
+    // Some compilers require an overridden class-specific deallocation
+    // function, which will be called if placement `new` throws an exception.
+  }
+
+ private:
+  InlineBuffer(int64 n, void* data) : TensorBuffer(data), elem_(n) {}
+  ~InlineBuffer() override {}
+
+  // Offset of the element storage from the start of the allocation, keeping
+  // the elements suitably aligned for Eigen.
+  static constexpr size_t DataOffset() {
+    return (sizeof(InlineBuffer) + EIGEN_MAX_ALIGN_BYTES - 1) /
+           EIGEN_MAX_ALIGN_BYTES * EIGEN_MAX_ALIGN_BYTES;
+  }
+
+  const int64 elem_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(InlineBuffer);
+};
+
+// If true, small simple-typed tensors allocated from the default CPU
+// allocator store their elements inline in the buffer object's allocation
+// instead of making a separate allocator allocation.
+bool InlineSmallTensorsEnabled() {
+  static const bool enabled = [] {
+    const char* val = getenv("TF_TENSOR_INLINE_SMALL_BUFFER");
+    return val != nullptr && strcmp(val, "1") == 0;
+  }();
+  return enabled;
+}
+
+// Upper bound on the payload size for which Tensor construction uses an
+// InlineBuffer. Large enough for the shape vector of an 8-D int64 tensor.
+constexpr int64 kMaxInlineTensorBytes = 64;
+
+template <typename T>
+TensorBuffer* MaybeMakeInlineBuffer(Allocator* a, int64 n, std::true_type) {
+  if (a != cpu_allocator() || LogMemory::IsEnabled()) return nullptr;
+  if (n * static_cast<int64>(sizeof(T)) > kMaxInlineTensorBytes) return nullptr;
+  return InlineBuffer<T>::Make(n);
+}
+
+template <typename T>
+TensorBuffer* MaybeMakeInlineBuffer(Allocator* a, int64 n, std::false_type) {
+  return nullptr;
+}
+
+// Returns a buffer holding `n` elements of type T from `a`, preferring the
+// inline small-tensor representation when it applies.
+template <typename T>
+TensorBuffer* MakeBuffer(Allocator* a, int64 n) {
+  if (InlineSmallTensorsEnabled()) {
+    TensorBuffer* buf = MaybeMakeInlineBuffer<T>(
+        a, n, std::integral_constant<bool, is_simple_type<T>::value>());
+    if (buf != nullptr) return buf;
+  }
+  return new Buffer<T>(a, n);
+}
+
+template <typename T>
+TensorBuffer* MakeBuffer(Allocator* a, int64 n,
+                         const AllocationAttributes& allocation_attr) {
+  if (InlineSmallTensorsEnabled() &&
+      !allocation_attr.allocation_will_be_logged) {
+    TensorBuffer* buf = MaybeMakeInlineBuffer<T>(
+        a, n, std::integral_constant<bool, is_simple_type<T>::value>());
+    if (buf != nullptr) return buf;
+  }
+  return new Buffer<T>(a, n, allocation_attr);
+}
+
 void LogUnexpectedSize(int64 actual, int64 expected) {
   LOG(ERROR) << "Input size was " << actual << " and expected " << expected;
 }
@@ -735,7 +837,7 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape)
   set_dtype(type);
   CHECK_NOTNULL(a);
   if (shape_.num_elements() > 0 || a->ShouldAllocateEmptyTensors()) {
-    CASES(type, buf_ = new Buffer<T>(a, shape.num_elements()));
+    CASES(type, buf_ = MakeBuffer<T>(a, shape.num_elements()));
   }
   if (buf_ != nullptr && buf_->data() != nullptr && LogMemory::IsEnabled()) {
     LogMemory::RecordTensorAllocation("Unknown", LogMemory::UNKNOWN_STEP_ID,
@@ -749,7 +851,8 @@ Tensor::Tensor(Allocator* a, DataType type, const TensorShape& shape,
   set_dtype(type);
   CHECK_NOTNULL(a);
   if (shape_.num_elements() > 0 || a->ShouldAllocateEmptyTensors()) {
-    CASES(type, buf_ = new Buffer<T>(a, shape.num_elements(), allocation_attr));
+    CASES(type,
+          buf_ = MakeBuffer<T>(a, shape.num_elements(), allocation_attr));
   }
   if (!allocation_attr.allocation_will_be_logged && buf_ != nullptr &&
       buf_->data() != nullptr && LogMemory::IsEnabled()) {
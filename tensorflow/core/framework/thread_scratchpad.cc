@@ -0,0 +1,203 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/framework/thread_scratchpad.h"
+
+#include <vector>
+
+#include "tensorflow/core/framework/allocator.h"
+#include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace {
+
+// Experimental: opt into per-thread caching of kernel scratch buffers.
+// When unset, every checkout is a plain allocation.
+bool ThreadScratchpadEnabled() {
+  static bool enabled = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_THREAD_SCRATCHPAD", false, &enabled));
+    return enabled;
+  }();
+  return enabled;
+}
+
+// Per-thread cap on cached bytes; buffers checked in beyond the cap are
+// freed instead of cached.
+size_t ThreadScratchpadMaxBytes() {
+  static size_t max_bytes = [] {
+    int64 max_mb = 0;
+    TF_CHECK_OK(
+        ReadInt64FromEnvVar("TF_THREAD_SCRATCHPAD_MAX_MB", 32, &max_mb));
+    return static_cast<size_t>(max_mb) << 20;
+  }();
+  return max_bytes;
+}
+
+// Buffers are cached in power-of-two size classes from 1KiB to 16MiB;
+// larger requests bypass the cache.
+constexpr size_t kMinClassBytes = 1 << 10;
+constexpr size_t kMaxClassBytes = 16 << 20;
+constexpr int kNumClasses = 15;
+// Cached buffers per size class; a kernel rarely holds more than two
+// same-sized workspaces at once.
+constexpr int kMaxBuffersPerClass = 2;
+// Checkouts between trim sweeps of idle size classes.
+constexpr int kTrimInterval = 256;
+
+// Returns the index of the smallest size class holding num_bytes, or -1
+// if the request is too large to cache.
+int SizeClassIndex(size_t num_bytes) {
+  if (num_bytes > kMaxClassBytes) return -1;
+  int index = 0;
+  size_t bytes = kMinClassBytes;
+  while (bytes < num_bytes) {
+    bytes <<= 1;
+    ++index;
+  }
+  return index;
+}
+
+size_t SizeClassBytes(int index) { return kMinClassBytes << index; }
+
+struct ThreadCache {
+  struct SizeClass {
+    std::vector<void*> buffers;
+    bool used_since_trim = false;
+  };
+  SizeClass classes[kNumClasses];
+  size_t cached_bytes = 0;
+  int checkouts_until_trim = kTrimInterval;
+
+  ~ThreadCache() {
+    for (SizeClass& size_class : classes) {
+      for (void* buffer : size_class.buffers) {
+        cpu_allocator()->DeallocateRaw(buffer);
+      }
+    }
+  }
+};
+
+ThreadCache* Cache() {
+  static thread_local ThreadCache cache;
+  return &cache;
+}
+
+// Frees the cached buffers of every size class with no checkout since the
+// previous sweep, so the cache tracks recent demand.
+void TrimIdleClasses(ThreadCache* cache) {
+  for (int i = 0; i < kNumClasses; ++i) {
+    ThreadCache::SizeClass& size_class = cache->classes[i];
+    if (size_class.used_since_trim) {
+      size_class.used_since_trim = false;
+      continue;
+    }
+    for (void* buffer : size_class.buffers) {
+      cpu_allocator()->DeallocateRaw(buffer);
+    }
+    cache->cached_bytes -= SizeClassBytes(i) * size_class.buffers.size();
+    size_class.buffers.clear();
+  }
+}
+
+// Hands a checked-out buffer back to the calling thread's cache, or to
+// the allocator if the buffer's class is full or over the byte cap.
+void ReturnBuffer(void* data, int size_class_index) {
+  if (size_class_index >= 0) {
+    ThreadCache* cache = Cache();
+    ThreadCache::SizeClass& size_class = cache->classes[size_class_index];
+    const size_t bytes = SizeClassBytes(size_class_index);
+    if (size_class.buffers.size() < kMaxBuffersPerClass &&
+        cache->cached_bytes + bytes <= ThreadScratchpadMaxBytes()) {
+      size_class.buffers.push_back(data);
+      cache->cached_bytes += bytes;
+      return;
+    }
+  }
+  cpu_allocator()->DeallocateRaw(data);
+}
+
+}  // namespace
+
+ThreadScratchpad::Handle::Handle(Handle&& other)
+    : data_(other.data_), size_(other.size_), size_class_(other.size_class_) {
+  other.data_ = nullptr;
+  other.size_ = 0;
+  other.size_class_ = -1;
+}
+
+ThreadScratchpad::Handle& ThreadScratchpad::Handle::operator=(Handle&& other) {
+  if (this != &other) {
+    if (data_ != nullptr) ReturnBuffer(data_, size_class_);
+    data_ = other.data_;
+    size_ = other.size_;
+    size_class_ = other.size_class_;
+    other.data_ = nullptr;
+    other.size_ = 0;
+    other.size_class_ = -1;
+  }
+  return *this;
+}
+
+ThreadScratchpad::Handle::~Handle() {
+  if (data_ != nullptr) ReturnBuffer(data_, size_class_);
+}
+
+ThreadScratchpad::Handle ThreadScratchpad::Checkout(size_t num_bytes) {
+  if (num_bytes == 0) return Handle();
+  const int size_class_index =
+      ThreadScratchpadEnabled() ? SizeClassIndex(num_bytes) : -1;
+  if (size_class_index < 0) {
+    void* data = cpu_allocator()->AllocateRaw(Allocator::kAllocatorAlignment,
+                                              num_bytes);
+    return Handle(data, data != nullptr ? num_bytes : 0, -1);
+  }
+  ThreadCache* cache = Cache();
+  if (--cache->checkouts_until_trim <= 0) {
+    TrimIdleClasses(cache);
+    cache->checkouts_until_trim = kTrimInterval;
+  }
+  ThreadCache::SizeClass& size_class = cache->classes[size_class_index];
+  size_class.used_since_trim = true;
+  const size_t bytes = SizeClassBytes(size_class_index);
+  void* data;
+  if (!size_class.buffers.empty()) {
+    data = size_class.buffers.back();
+    size_class.buffers.pop_back();
+    cache->cached_bytes -= bytes;
+  } else {
+    data =
+        cpu_allocator()->AllocateRaw(Allocator::kAllocatorAlignment, bytes);
+    if (data == nullptr) return Handle();
+  }
+  return Handle(data, bytes, size_class_index);
+}
+
+void ThreadScratchpad::TrimThreadCache() {
+  ThreadCache* cache = Cache();
+  for (int i = 0; i < kNumClasses; ++i) {
+    ThreadCache::SizeClass& size_class = cache->classes[i];
+    for (void* buffer : size_class.buffers) {
+      cpu_allocator()->DeallocateRaw(buffer);
+    }
+    size_class.buffers.clear();
+    size_class.used_since_trim = false;
+  }
+  cache->cached_bytes = 0;
+}
+
+size_t ThreadScratchpad::ThreadCacheBytes() { return Cache()->cached_bytes; }
+
+}  // namespace tensorflow
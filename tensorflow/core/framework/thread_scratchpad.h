@@ -0,0 +1,98 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_FRAMEWORK_THREAD_SCRATCHPAD_H_
+#define TENSORFLOW_CORE_FRAMEWORK_THREAD_SCRATCHPAD_H_
+
+#include <stddef.h>
+
+#include "tensorflow/core/platform/macros.h"
+
+namespace tensorflow {
+
+// A registry of reusable scratch buffers kept in thread-local storage.
+//
+// Many CPU kernels need a workspace of the same size on every invocation:
+// im2col patch buffers, sort and selection scratch, histogram bin arrays.
+// Obtaining it through the allocator costs a malloc/free round trip per
+// call even though the same worker thread keeps asking for the same size.
+// ThreadScratchpad instead keeps a small, size-classed cache of buffers in
+// thread-local storage, so a hot kernel checks an equally sized buffer in
+// and out with no locking and no allocator traffic.
+//
+// Checked-out buffers are returned through an RAII handle.  A handle may
+// be destroyed on any thread (the buffer then joins that thread's cache),
+// but reuse only pays off when checkout and check-in happen on the same
+// thread, as they do for scratch used inside Compute().  The cache is
+// trimmed on a fixed checkout cadence: size classes that saw no use since
+// the previous sweep are released back to the allocator, so a thread's
+// cache follows the high-water mark of its recent demand rather than its
+// all-time peak.
+//
+// Caching is enabled with TF_THREAD_SCRATCHPAD=true; otherwise Checkout()
+// degenerates to a plain allocation that is freed when the handle dies.
+class ThreadScratchpad {
+ public:
+  // Owns one checked-out buffer; returns it to the per-thread cache (or
+  // the allocator) on destruction.  Movable but not copyable.
+  class Handle {
+   public:
+    Handle() {}
+    Handle(Handle&& other);
+    Handle& operator=(Handle&& other);
+    ~Handle();
+
+    // The buffer, aligned suitably for any tensor element type.  Null for
+    // a default-constructed or moved-from handle, a zero-byte checkout,
+    // or a failed allocation.
+    void* data() const { return data_; }
+
+    template <typename T>
+    T* data_as() const {
+      return static_cast<T*>(data_);
+    }
+
+    // Usable capacity in bytes; at least the number of bytes requested.
+    size_t size() const { return size_; }
+
+   private:
+    friend class ThreadScratchpad;
+    Handle(void* data, size_t size, int size_class)
+        : data_(data), size_(size), size_class_(size_class) {}
+
+    void* data_ = nullptr;
+    size_t size_ = 0;
+    // Index of the size class the buffer belongs to, or -1 if the buffer
+    // bypassed the cache and goes straight back to the allocator.
+    int size_class_ = -1;
+
+    TF_DISALLOW_COPY_AND_ASSIGN(Handle);
+  };
+
+  // Returns a buffer of at least num_bytes, reusing one cached by the
+  // calling thread when possible.  Requests too large to cache are served
+  // directly from the allocator.  Thread-safe.
+  static Handle Checkout(size_t num_bytes);
+
+  // Releases every buffer cached by the calling thread.  Mainly for
+  // tests.
+  static void TrimThreadCache();
+
+  // Bytes currently cached by the calling thread.  Mainly for tests.
+  static size_t ThreadCacheBytes();
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_FRAMEWORK_THREAD_SCRATCHPAD_H_
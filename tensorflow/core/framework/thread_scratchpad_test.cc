@@ -0,0 +1,103 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/framework/thread_scratchpad.h"
+
+#include <stdlib.h>
+
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// Caching is read from the environment once, so every test enables it
+// before the first checkout.
+void EnableScratchpad() { setenv("TF_THREAD_SCRATCHPAD", "true", 1); }
+
+TEST(ThreadScratchpadTest, ReusesBufferOfSameClass) {
+  EnableScratchpad();
+  ThreadScratchpad::TrimThreadCache();
+  void* first;
+  {
+    ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(4096);
+    ASSERT_NE(h.data(), nullptr);
+    EXPECT_EQ(h.size(), 4096);
+    first = h.data();
+  }
+  EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 4096);
+  {
+    ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(4000);
+    EXPECT_EQ(h.data(), first);
+    EXPECT_EQ(h.size(), 4096);
+    EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 0);
+  }
+  ThreadScratchpad::TrimThreadCache();
+}
+
+TEST(ThreadScratchpadTest, RoundsUpToSizeClass) {
+  EnableScratchpad();
+  ThreadScratchpad::TrimThreadCache();
+  ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(3000);
+  EXPECT_EQ(h.size(), 4096);
+  ThreadScratchpad::Handle tiny = ThreadScratchpad::Checkout(1);
+  EXPECT_EQ(tiny.size(), 1024);
+}
+
+TEST(ThreadScratchpadTest, LargeRequestBypassesCache) {
+  EnableScratchpad();
+  ThreadScratchpad::TrimThreadCache();
+  const size_t large = 64u << 20;
+  {
+    ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(large);
+    ASSERT_NE(h.data(), nullptr);
+    EXPECT_EQ(h.size(), large);
+  }
+  EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 0);
+}
+
+TEST(ThreadScratchpadTest, MoveTransfersOwnership) {
+  EnableScratchpad();
+  ThreadScratchpad::TrimThreadCache();
+  ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(2048);
+  void* data = h.data();
+  ThreadScratchpad::Handle moved = std::move(h);
+  EXPECT_EQ(h.data(), nullptr);
+  EXPECT_EQ(moved.data(), data);
+  EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 0);
+}
+
+TEST(ThreadScratchpadTest, TrimSweepFreesIdleClasses) {
+  EnableScratchpad();
+  ThreadScratchpad::TrimThreadCache();
+  // Populate the 1KiB class once, then keep only the 4KiB class busy long
+  // enough for two trim sweeps to pass; the idle class should be freed.
+  { ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(1024); }
+  EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 1024);
+  for (int i = 0; i < 600; ++i) {
+    ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(4096);
+  }
+  EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 4096);
+  ThreadScratchpad::TrimThreadCache();
+  EXPECT_EQ(ThreadScratchpad::ThreadCacheBytes(), 0);
+}
+
+TEST(ThreadScratchpadTest, ZeroByteCheckoutIsEmpty) {
+  EnableScratchpad();
+  ThreadScratchpad::Handle h = ThreadScratchpad::Checkout(0);
+  EXPECT_EQ(h.data(), nullptr);
+  EXPECT_EQ(h.size(), 0);
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -54,7 +54,10 @@ class EdgeSet {
  private:
   // Up to kInline elements are stored directly in ptrs_ (nullptr means none).
   // If ptrs_[0] == this then ptrs_[1] points to a set<const Edge*>.
-  static const int kInline = 4;  // Must be >= 2.
+  // kInline is chosen to fill one cache line: almost all nodes have at most
+  // this many in or out edges, so iterating them is a contiguous scan
+  // instead of a pointer chase through a std::set.
+  static constexpr int kInline = 64 / sizeof(const void*);  // Must be >= 2.
   const void* ptrs_[kInline];
 
   std::set<const Edge*>* get_set() const {
@@ -35,17 +35,34 @@ limitations under the License.
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/graph/tensor_id.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/flatmap.h"
 #include "tensorflow/core/lib/gtl/flatset.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/scanner.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/public/version.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
 namespace {
+
+// Experimental: validate imported NodeDefs across a threadpool before the
+// (inherently serial) node-construction loop.
+bool ParallelImportValidationEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRAPH_CONSTRUCTOR_PARALLEL_VALIDATION",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
 inline bool IsMerge(const NodeDef& node_def) {
   return node_def.op() == "Merge" || node_def.op() == "RefMerge";
 }
@@ -180,6 +197,11 @@ class GraphConstructor {
   Status ValidateInputMapAndControlDependencies();
   Status BuildNodeIndex();
   Status InitFromEdges();
+  // When enabled and the import performs no per-node rewriting (no input
+  // map, control dependencies, prefixing, uniquification or default
+  // device), runs ModifyNodeDefForImport over copies of all NodeDefs on a
+  // threadpool so Convert() can consume pre-validated defs.
+  Status MaybePreprocessNodeDefs();
   Status Convert();
   Status AddBackEdges();
   Status UpdateVersionDef();
@@ -297,6 +319,12 @@ class GraphConstructor {
   // all nodes it outputs to.
   std::vector<gtl::InlinedVector<int, 4>> outputs_;
 
+  // Populated by MaybePreprocessNodeDefs(); parallel to node_defs_.  When
+  // use_preprocessed_defs_ is true, Convert() builds nodes from these
+  // already-validated defs instead of copying and validating per node.
+  std::vector<NodeDef> preprocessed_node_defs_;
+  bool use_preprocessed_defs_ = false;
+
   // Used in the conversion from node_defs_ to g_ to represent the ith input
   // of a node.
   struct InputInfo {
@@ -907,6 +935,46 @@ Status GraphConstructor::IsNodeFullyMapped(const NodeDef& node_def,
   return Status::OK();
 }
 
+Status GraphConstructor::MaybePreprocessNodeDefs() {
+  // Only eligible when the import applies no per-node rewriting, so the def
+  // handed to MakeNode() is exactly the original plus defaults.  The
+  // eligibility mirrors the rewriting steps in Convert().
+  if (!ParallelImportValidationEnabled() || !opts_.importing ||
+      !opts_.input_map.empty() || !opts_.control_dependencies.empty() ||
+      !opts_.default_device.empty() || !prefix_.empty() ||
+      opts_.uniquify_names) {
+    return Status::OK();
+  }
+  const int num_nodes = node_defs_.size();
+  if (num_nodes < 2) return Status::OK();
+
+  preprocessed_node_defs_.resize(num_nodes);
+  mutex status_mu;
+  Status status;
+  const int num_threads =
+      std::min<int>(port::NumSchedulableCPUs(), num_nodes);
+  thread::ThreadPool pool(Env::Default(), "graph_import_validate",
+                          num_threads);
+  // Op lookup, attr defaulting and validation are per-node independent;
+  // OpRegistry lookups are thread-safe.
+  pool.ParallelFor(num_nodes, 10000 /* cost_per_unit: ns, roughly */,
+                   [this, &status_mu, &status](int64 begin, int64 end) {
+                     for (int64 i = begin; i < end; ++i) {
+                       preprocessed_node_defs_[i] = *node_defs_[i];
+                       Status s =
+                           ModifyNodeDefForImport(&preprocessed_node_defs_[i]);
+                       if (!s.ok()) {
+                         mutex_lock l(status_mu);
+                         status.Update(s);
+                         return;
+                       }
+                     }
+                   });
+  TF_RETURN_IF_ERROR(status);
+  use_preprocessed_defs_ = true;
+  return Status::OK();
+}
+
 Status GraphConstructor::Convert() {
   // Import functions before adding nodes, since imported nodes may refer to
   // functions
@@ -914,6 +982,10 @@ Status GraphConstructor::Convert() {
     TF_RETURN_IF_ERROR(g_->AddFunctionLibrary(*library_));
   }
 
+  // Must run after AddFunctionLibrary() so function ops resolve in the op
+  // registry during validation.
+  TF_RETURN_IF_ERROR(MaybePreprocessNodeDefs());
+
   std::vector<InputInfo> inputs;
   int processed = 0;
 
@@ -941,7 +1013,12 @@ Status GraphConstructor::Convert() {
     input_already_exists.clear();
     input_already_exists.resize(original_node_def.input_size(), false);
 
-    if (opts_.importing) {
+    if (use_preprocessed_defs_) {
+      // Eligibility for preprocessing guarantees no input map, control
+      // dependencies, default device, prefixing or uniquification, so the
+      // preprocessed def is what the rewriting steps below would produce.
+      node_def = &preprocessed_node_defs_[o];
+    } else if (opts_.importing) {
       if (opts_.skip_mapped_nodes) {
         bool is_node_mapped = false;
         TF_RETURN_IF_ERROR(
@@ -1014,7 +1091,7 @@ Status GraphConstructor::Convert() {
     }
 
     Node* node;
-    if (opts_.importing) {
+    if (opts_.importing && !use_preprocessed_defs_) {
       if (!prefix_.empty()) {
         AddPrefixToNodeDef(input_already_exists, &imported_node_def);
       }
@@ -971,7 +971,15 @@ Status Partition(const PartitionOptions& opts, Graph* g,
   status = BuildMemoryDeviceInfo(*g, &g_info);
   if (!status.ok()) return status;
 
-  string dstp;
+  // Cache the partition GraphDef for every node up front.  node_to_loc
+  // composes a location string and the partitions lookup hashes it; the
+  // edge loop below would otherwise repeat that work once per edge.  The
+  // map's entries are stable, so the pointers stay valid as it grows.
+  std::vector<GraphDef*> node_graph(g->num_node_ids(), nullptr);
+  for (const Node* node : g->op_nodes()) {
+    node_graph[node->id()] = &(*partitions)[opts.node_to_loc(node)];
+  }
+
   std::vector<const Edge*> inputs;
   DupRecvTable dup_recv(3);
   // For a node dst, 'ref_recvs' remembers the recvs introduced by a ref
@@ -984,8 +992,7 @@ Status Partition(const PartitionOptions& opts, Graph* g,
   int32 num_data = 0;
   int32 num_control = 0;
   for (const Node* dst : g->op_nodes()) {
-    dstp = opts.node_to_loc(dst);
-    GraphDef* dst_graph = &(*partitions)[dstp];
+    GraphDef* dst_graph = node_graph[dst->id()];
     NodeDef* dst_def = dst_graph->add_node();
     *dst_def = dst->def();
     MergeDebugInfo(NodeDebugInfo(dst->def()), dst_def);
@@ -1042,7 +1049,7 @@ Status Partition(const PartitionOptions& opts, Graph* g,
       const Node* src = edge->src();
       if (!src->IsOp()) continue;  // Skip Sink/Source nodes.
 
-      GraphDef* src_graph = &(*partitions)[opts.node_to_loc(src)];
+      GraphDef* src_graph = node_graph[src->id()];
       if (src_graph == dst_graph && !NeedSameDeviceSendRecv(edge, g_info)) {
         // Same partition and compatible memory types:
         AddInput(dst_def, src->name(), edge->src_output());
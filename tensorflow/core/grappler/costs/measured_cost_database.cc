@@ -0,0 +1,126 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
+
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace grappler {
+namespace {
+
+// Builds the database key for an op: device type (and model, unless
+// `include_model` is false), op name, and the type and shape of each
+// input. Ops whose timing depends on their inputs' values rather than
+// shapes are inherently averaged.
+string OpSignature(const OpInfo& op_info, bool include_model) {
+  string signature = strings::StrCat(
+      op_info.device().type(), "/",
+      include_model ? op_info.device().model() : "", "/", op_info.op());
+  for (const auto& input : op_info.inputs()) {
+    strings::StrAppend(&signature, "/", DataTypeString(input.dtype()),
+                       PartialTensorShape::DebugString(input.shape()));
+  }
+  return signature;
+}
+
+}  // namespace
+
+const string& MeasuredCostDatabasePath() {
+  static const string* path = [] {
+    string value;
+    TF_CHECK_OK(
+        ReadStringFromEnvVar("TF_GRAPPLER_MEASURED_COST_DB", "", &value));
+    return new string(value);
+  }();
+  return *path;
+}
+
+MeasuredCostDatabase* MeasuredCostDatabase::Get() {
+  static MeasuredCostDatabase* database = [] {
+    MeasuredCostDatabase* db = new MeasuredCostDatabase;
+    const string& path = MeasuredCostDatabasePath();
+    if (!path.empty() && Env::Default()->FileExists(path).ok()) {
+      Status s = db->Load(path);
+      if (!s.ok()) {
+        LOG(WARNING) << "Failed to load measured cost database from " << path
+                     << ": " << s;
+      }
+    }
+    return db;
+  }();
+  return database;
+}
+
+void MeasuredCostDatabase::AddMeasurements(const OpPerformanceList& perf_list) {
+  mutex_lock lock(mu_);
+  for (const OpPerformance& perf : perf_list.op_performance()) {
+    if (perf.compute_cost() <= 0) {
+      // No timing was recorded for this node (e.g. it was never executed).
+      continue;
+    }
+    Entry& entry = entries_[OpSignature(perf.op(), /*include_model=*/true)];
+    if (entry.count == 0) {
+      entry.perf = perf;
+    }
+    ++entry.count;
+    entry.total_cost_ns += perf.compute_cost();
+    entry.perf.set_compute_cost(entry.total_cost_ns / entry.count);
+  }
+}
+
+bool MeasuredCostDatabase::LookupCost(const OpInfo& op_info,
+                                      int64* compute_cost_ns) const {
+  mutex_lock lock(mu_);
+  if (entries_.empty()) {
+    return false;
+  }
+  auto it = entries_.find(OpSignature(op_info, /*include_model=*/true));
+  if (it == entries_.end() && !op_info.device().model().empty()) {
+    it = entries_.find(OpSignature(op_info, /*include_model=*/false));
+  }
+  if (it == entries_.end()) {
+    return false;
+  }
+  *compute_cost_ns = it->second.perf.compute_cost();
+  return true;
+}
+
+Status MeasuredCostDatabase::Load(const string& filename) {
+  OpPerformanceList perf_list;
+  TF_RETURN_IF_ERROR(ReadBinaryProto(Env::Default(), filename, &perf_list));
+  AddMeasurements(perf_list);
+  VLOG(1) << "Loaded " << perf_list.op_performance_size()
+          << " measured op costs from " << filename;
+  return Status::OK();
+}
+
+Status MeasuredCostDatabase::Save(const string& filename) const {
+  OpPerformanceList perf_list;
+  {
+    mutex_lock lock(mu_);
+    for (const auto& entry : entries_) {
+      *perf_list.add_op_performance() = entry.second.perf;
+    }
+  }
+  return WriteBinaryProto(Env::Default(), filename, perf_list);
+}
+
+}  // end namespace grappler
+}  // end namespace tensorflow
@@ -0,0 +1,86 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
+#define TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
+
+#include <unordered_map>
+
+#include "tensorflow/core/grappler/costs/op_performance_data.pb.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace grappler {
+
+// Returns the value of TF_GRAPPLER_MEASURED_COST_DB, the path of the
+// measured cost database file, or the empty string when calibration is
+// disabled.
+const string& MeasuredCostDatabasePath();
+
+// Database of measured per-op execution times, keyed by device and op
+// signature (op name plus input types and shapes). Measurements come from
+// profiled runs -- the cost graphs that StepStatsCollector builds from
+// real step timings -- and are consulted by OpLevelCostEstimator before
+// it falls back to its analytic roofline formulas, so that scheduling and
+// memory decisions derived from the estimator match the actual hardware.
+//
+// When TF_GRAPPLER_MEASURED_COST_DB is set to a file path,
+// MeasuringCostEstimator saves the measurements it records there, and the
+// database loads the file on first use so it can be reused across
+// sessions.
+class MeasuredCostDatabase {
+ public:
+  static MeasuredCostDatabase* Get();
+
+  // Records the measurements in `perf_list`, typically produced by
+  // CostGraphToOpPerformanceData from a profiled run. Repeated
+  // measurements of the same op signature are averaged.
+  void AddMeasurements(const OpPerformanceList& perf_list);
+
+  // Looks up the measured execution time, in nanoseconds, of an op with
+  // the given signature. Returns false if no measurement was recorded.
+  // Falls back to a model-agnostic entry for the device type if the exact
+  // device model was never profiled.
+  bool LookupCost(const OpInfo& op_info, int64* compute_cost_ns) const;
+
+  // Merges the measurements stored in `filename` into the database, and
+  // writes the database out, respectively. The on-disk format is a binary
+  // OpPerformanceList proto.
+  Status Load(const string& filename);
+  Status Save(const string& filename) const;
+
+ private:
+  MeasuredCostDatabase() {}
+
+  struct Entry {
+    // Representative measurement; compute_cost holds the running mean.
+    OpPerformance perf;
+    int64 count = 0;
+    double total_cost_ns = 0.0;
+  };
+
+  mutable mutex mu_;
+  std::unordered_map<string, Entry> entries_ GUARDED_BY(mu_);
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MeasuredCostDatabase);
+};
+
+}  // end namespace grappler
+}  // end namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_GRAPPLER_COSTS_MEASURED_COST_DATABASE_H_
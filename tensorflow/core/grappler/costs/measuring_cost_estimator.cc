@@ -20,7 +20,9 @@ limitations under the License.
 #include "tensorflow/core/framework/cost_graph.pb.h"
 #include "tensorflow/core/framework/step_stats.pb.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
 #include "tensorflow/core/grappler/costs/robust_stats.h"
+#include "tensorflow/core/grappler/costs/utils.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/blocking_counter.h"
@@ -57,6 +59,12 @@ Status MeasuringCostEstimator::PredictCosts(const GraphDef& optimized_graph,
   if (run_metadata) {
     cost_graph = run_metadata->mutable_cost_graph();
   }
+  // When calibrating a measured cost database, keep the cost graph from
+  // the last measurement step even if the caller didn't ask for metadata.
+  CostGraphDef local_cost_graph;
+  if (cost_graph == nullptr && !MeasuredCostDatabasePath().empty()) {
+    cost_graph = &local_cost_graph;
+  }
   const bool running_simulation = (cluster_->type() == "virtual");
 
   std::vector<double> times(measurement_steps_);
@@ -146,6 +154,21 @@ Status MeasuringCostEstimator::PredictCosts(const GraphDef& optimized_graph,
   RobustStats stats(times);
   costs->execution_time = Costs::Duration(stats.mean());
 
+  // Record the per-op timings that StepStatsCollector gathered into the
+  // measured cost database and persist it, so that later sessions can
+  // base their OpLevelCostEstimator predictions on real hardware timings.
+  const string& db_path = MeasuredCostDatabasePath();
+  if (!db_path.empty() && cost_graph != nullptr && !running_simulation &&
+      cost_graph->node_size() > 0) {
+    MeasuredCostDatabase::Get()->AddMeasurements(
+        CostGraphToOpPerformanceData(*cost_graph, optimized_graph));
+    const Status save_status = MeasuredCostDatabase::Get()->Save(db_path);
+    if (!save_status.ok()) {
+      LOG(WARNING) << "Failed to save measured cost database to " << db_path
+                   << ": " << save_status;
+    }
+  }
+
   return Status::OK();
 }
 }  // end namespace grappler
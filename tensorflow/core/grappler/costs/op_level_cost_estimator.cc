@@ -22,6 +22,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/grappler/clusters/utils.h"
+#include "tensorflow/core/grappler/costs/measured_cost_database.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -369,6 +370,21 @@ OpLevelCostEstimator::OpLevelCostEstimator() {
 
 Costs OpLevelCostEstimator::PredictCosts(const OpContext& op_context) const {
   const auto& op_info = op_context.op_info;
+
+  // Calibrated timings, when available, take precedence over the analytic
+  // estimates below: the roofline model can be far off for
+  // library-provided kernels (e.g. MIOpen convolutions), while the
+  // measurements reflect the actual hardware.
+  int64 measured_cost_ns;
+  if (MeasuredCostDatabase::Get()->LookupCost(op_info, &measured_cost_ns)) {
+    Costs costs;
+    costs.compute_time = Costs::NanoSeconds(measured_cost_ns);
+    costs.execution_time = costs.compute_time;
+    VLOG(1) << "Operation " << op_info.op() << " measured at "
+            << costs.execution_time.count() << " ns.";
+    return costs;
+  }
+
   auto it = device_cost_impl_.find(op_info.op());
   if (it != device_cost_impl_.end()) {
     std::function<Costs(const OpContext&)> estimator = it->second;
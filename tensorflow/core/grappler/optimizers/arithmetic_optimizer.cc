@@ -3241,6 +3241,23 @@ class UniqueNodes {
     return node;
   }
 
+  // Removes `node` from the set of representatives and forgets its
+  // memoized signature. Must be called when the inputs of `node` change,
+  // so that the node can be re-registered under its new signature.
+  void RemoveRepresentative(NodeDef* node) {
+    auto it = memoized_signatures_.find(node);
+    if (it == memoized_signatures_.end()) return;
+    std::vector<NodeDef*>& candidates = rep_[it->second];
+    for (int i = 0; i < candidates.size(); ++i) {
+      if (candidates[i] == node) {
+        std::swap(candidates[i], candidates[candidates.size() - 1]);
+        candidates.resize(candidates.size() - 1);
+        break;
+      }
+    }
+    memoized_signatures_.erase(node);
+  }
+
  private:
   uint64 ComputeSignature(const NodeDef& node);
   bool SameNode(const NodeDef& node1, const NodeDef& node2) const;
@@ -3373,57 +3390,76 @@ void ArithmeticOptimizer::DedupComputations() {
     }
   }
 
-  bool stop = true;
+  // Process the graph with a worklist instead of repeated full sweeps:
+  // rewiring the fanout of a deduped node only changes the signatures of
+  // the fanout nodes, so only those need to be revisited.
   std::set<int> duplicates;
   UniqueNodes nodes;
-  do {
-    stop = true;
-    for (int i = 0; i < optimized_graph_->node_size(); ++i) {
-      if (duplicates.find(i) != duplicates.end()) {
-        continue;
-      }
-      NodeDef* node = optimized_graph_->mutable_node(i);
-      if (!CanDedup(*node) ||
-          feeds_inplace_op.find(node) != feeds_inplace_op.end()) {
-        continue;
-      }
-      NodeDef* rep = nodes.FindOrAddRepresentative(node);
-      if (rep == node) {
-        continue;
-      }
-      // If either node or rep feeds an inplace op, deduping them may cause data
-      // races. For example: If we dedup nodes initializing two independent
-      // inplace accumulations, they will write to the same buffer, clobbering
-      // each other's results.
-      if (feeds_inplace_op.find(rep) != feeds_inplace_op.end()) {
-        continue;
+  absl::flat_hash_map<const NodeDef*, int> node_index;
+  std::deque<NodeDef*> worklist;
+  absl::flat_hash_set<const NodeDef*> in_worklist;
+  for (int i = 0; i < optimized_graph_->node_size(); ++i) {
+    NodeDef* node = optimized_graph_->mutable_node(i);
+    node_index[node] = i;
+    worklist.push_back(node);
+    in_worklist.insert(node);
+  }
+  while (!worklist.empty()) {
+    NodeDef* node = worklist.front();
+    worklist.pop_front();
+    in_worklist.erase(node);
+    if (duplicates.find(node_index[node]) != duplicates.end()) {
+      continue;
+    }
+    if (!CanDedup(*node) ||
+        feeds_inplace_op.find(node) != feeds_inplace_op.end()) {
+      continue;
+    }
+    NodeDef* rep = nodes.FindOrAddRepresentative(node);
+    if (rep == node) {
+      continue;
+    }
+    // If either node or rep feeds an inplace op, deduping them may cause data
+    // races. For example: If we dedup nodes initializing two independent
+    // inplace accumulations, they will write to the same buffer, clobbering
+    // each other's results.
+    if (feeds_inplace_op.find(rep) != feeds_inplace_op.end()) {
+      continue;
+    }
+    VLOG(3) << "Remove duplicated node: node=" << node->name()
+            << " representative=" << rep->name();
+    const std::set<NodeDef*>& tmp = node_map_->GetOutputs(node->name());
+    std::vector<NodeDef*> fanouts(tmp.begin(), tmp.end());
+    for (NodeDef* fanout : fanouts) {
+      bool updated_fanout = false;
+      for (int i = 0; i < fanout->input_size(); ++i) {
+        string* fanout_input = fanout->mutable_input(i);
+        const int position =
+            NodePositionIfSameNode(*fanout_input, node->name());
+        // Update name in-place.
+        if (position < -1) {
+          continue;
+        } else if (position > 0) {
+          *fanout_input = StrCat(rep->name(), ":", position);
+        } else if (position == 0) {
+          *fanout_input = rep->name();
+        } else {
+          *fanout_input = StrCat("^", rep->name());
+        }
+        updated_fanout = true;
+        node_map_->AddOutput(rep->name(), fanout->name());
       }
-      VLOG(3) << "Remove duplicated node: node=" << node->name()
-              << " representative=" << rep->name();
-      const std::set<NodeDef*>& tmp = node_map_->GetOutputs(node->name());
-      std::vector<NodeDef*> fanouts(tmp.begin(), tmp.end());
-      for (NodeDef* fanout : fanouts) {
-        for (int i = 0; i < fanout->input_size(); ++i) {
-          string* fanout_input = fanout->mutable_input(i);
-          const int position =
-              NodePositionIfSameNode(*fanout_input, node->name());
-          // Update name in-place.
-          if (position < -1) {
-            continue;
-          } else if (position > 0) {
-            *fanout_input = StrCat(rep->name(), ":", position);
-          } else if (position == 0) {
-            *fanout_input = rep->name();
-          } else {
-            *fanout_input = StrCat("^", rep->name());
-          }
-          node_map_->AddOutput(rep->name(), fanout->name());
+      if (updated_fanout) {
+        // The fanout's signature changed: it may now be a duplicate of
+        // another node, so revisit it.
+        nodes.RemoveRepresentative(fanout);
+        if (in_worklist.insert(fanout).second) {
+          worklist.push_back(fanout);
         }
       }
-      duplicates.insert(i);
-      stop = false;
     }
-  } while (!stop);
+    duplicates.insert(node_index[node]);
+  }
 
   // Delete duplicates
   if (fetch_nodes_known_ && !duplicates.empty()) {
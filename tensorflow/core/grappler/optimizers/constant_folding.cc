@@ -39,8 +39,10 @@ limitations under the License.
 #include "tensorflow/core/grappler/optimizers/evaluation_utils.h"
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/symbolic_shapes.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
 #include "tensorflow/core/lib/strings/numbers.h"
@@ -48,6 +50,7 @@ limitations under the License.
 #include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/denormal.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/fingerprint.h"
 #include "tensorflow/core/platform/setround.h"
 #include "tensorflow/core/platform/tensor_coding.h"
 #include "tensorflow/core/public/version.h"
@@ -1162,20 +1165,25 @@ Status ConstantFolding::EvaluateNode(const NodeDef& node,
 Status ConstantFolding::EvaluateOneFoldable(const NodeDef& node,
                                             std::vector<NodeDef>* outputs,
                                             bool* result_too_large) {
-  TensorVector inputs;
-  TensorVector output_tensors;
-  auto inputs_cleanup = gtl::MakeCleanup([&inputs, &output_tensors] {
-    for (const auto& input : inputs) {
-      delete input.tensor;
-    }
-    for (const auto& output : output_tensors) {
-      if (output.tensor) {
-        delete output.tensor;
-      }
-    }
-  });
-
-  size_t total_inputs_size = 0;
+  // Fingerprint the computation: the op, its attrs, and the values of its
+  // constant inputs. Folding proceeds bottom-up, so identical constant
+  // subgraphs (common across function instantiations) reduce to identical
+  // fingerprints and only need to be evaluated once.
+  uint64 fingerprint = Fingerprint64(node.op());
+  std::vector<string> attr_names;
+  attr_names.reserve(node.attr().size());
+  for (const auto& attr : node.attr()) {
+    attr_names.push_back(attr.first);
+  }
+  std::sort(attr_names.begin(), attr_names.end());
+  for (const string& attr_name : attr_names) {
+    fingerprint = FingerprintCat64(fingerprint, Fingerprint64(attr_name));
+    fingerprint = FingerprintCat64(
+        fingerprint,
+        Fingerprint64(node.attr().at(attr_name).SerializeAsString()));
+  }
+
+  std::vector<const TensorProto*> input_values;
   for (const auto& input : node.input()) {
     const TensorId input_tensor = ParseTensorName(input);
     if (input_tensor.index() < 0) {
@@ -1190,8 +1198,50 @@ Status ConstantFolding::EvaluateOneFoldable(const NodeDef& node,
     }
     TF_RETURN_IF_ERROR(CheckAttrExists(*input_node, "value"));
     const TensorProto& raw_val = input_node->attr().at("value").tensor();
-    Tensor* value = new Tensor(raw_val.dtype(), raw_val.tensor_shape());
-    CHECK(value->FromProto(raw_val));
+    input_values.push_back(&raw_val);
+    fingerprint = FingerprintCat64(fingerprint,
+                                   Fingerprint64(raw_val.SerializeAsString()));
+  }
+
+  {
+    mutex_lock lock(folded_memo_mu_);
+    auto it = folded_memo_.find(fingerprint);
+    if (it != folded_memo_.end()) {
+      // Replay a previous evaluation of an identical computation; only the
+      // output node names need to be regenerated for this node. Dead
+      // outputs are cached as empty NodeDefs and stay empty.
+      *outputs = it->second;
+      for (size_t i = 0; i < outputs->size(); ++i) {
+        if (outputs->at(i).name().empty()) {
+          continue;
+        }
+        string node_name = OptimizedNodeName(node, "-folded");
+        if (outputs->size() > 1) {
+          node_name = strings::StrCat(node_name, "-", i);
+        }
+        outputs->at(i).set_name(node_name);
+      }
+      return Status::OK();
+    }
+  }
+
+  TensorVector inputs;
+  TensorVector output_tensors;
+  auto inputs_cleanup = gtl::MakeCleanup([&inputs, &output_tensors] {
+    for (const auto& input : inputs) {
+      delete input.tensor;
+    }
+    for (const auto& output : output_tensors) {
+      if (output.tensor) {
+        delete output.tensor;
+      }
+    }
+  });
+
+  size_t total_inputs_size = 0;
+  for (const TensorProto* raw_val : input_values) {
+    Tensor* value = new Tensor(raw_val->dtype(), raw_val->tensor_shape());
+    CHECK(value->FromProto(*raw_val));
     inputs.emplace_back(value);
     total_inputs_size += value->TotalBytes();
   }
@@ -1220,6 +1270,16 @@ Status ConstantFolding::EvaluateOneFoldable(const NodeDef& node,
       outputs->at(i) = NodeDef();
     }
   }
+
+  {
+    // Cache the result for replay by identical computations. The memo is
+    // bounded to keep the extra memory in check on huge graphs.
+    constexpr int64 kMaxFoldedMemoEntries = 4096;
+    mutex_lock lock(folded_memo_mu_);
+    if (folded_memo_.size() < kMaxFoldedMemoEntries) {
+      folded_memo_[fingerprint] = *outputs;
+    }
+  }
   return Status::OK();
 }
 
@@ -1314,21 +1374,14 @@ Status ConstantFolding::FoldMergeNode(NodeDef* node, GraphDef* output_graph) {
   return Status::OK();
 }
 
-Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
-                                 bool* result_too_large) {
-  *result_too_large = false;
-  if (IsMerge(*node)) {
-    return FoldMergeNode(node, output_graph);
-  }
-
-  std::vector<NodeDef> const_nodes;
-  TF_RETURN_IF_ERROR(
-      EvaluateOneFoldable(*node, &const_nodes, result_too_large));
+Status ConstantFolding::ReplaceFoldedNode(NodeDef* node,
+                                          GraphDef* output_graph,
+                                          std::vector<NodeDef>* const_nodes) {
   VLOG(1) << "Folded node:\n" << node->DebugString();
 
   NodeDef* constant_output = nullptr;
-  for (int i = 0; i < const_nodes.size(); i++) {
-    NodeDef* const_node = &const_nodes[i];
+  for (int i = 0; i < const_nodes->size(); i++) {
+    NodeDef* const_node = &(*const_nodes)[i];
     VLOG(1) << "Generated constant node:\n" << const_node->DebugString();
     if (const_node->name().empty()) {
       // Dead output: we can't create a constant to encode its value, so we'll
@@ -1358,7 +1411,7 @@ Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
 
     // We rewrite the existing node if it only has a single output, and
     // create new nodes otherwise.
-    if (const_nodes.size() == 1) {
+    if (const_nodes->size() == 1) {
       node->set_op("Const");
       // Note we need to clear the inputs in NodeMap before we clear the inputs
       // in the node, otherwise NodeMap would see empty inputs and effectively
@@ -1391,7 +1444,7 @@ Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
     }
   }
 
-  if (const_nodes.size() > 1) {
+  if (const_nodes->size() > 1) {
     auto outputs = node_map_->GetOutputs(node->name());
     for (NodeDef* output : outputs) {
       for (int i = 0; i < output->input_size(); i++) {
@@ -1406,12 +1459,12 @@ Status ConstantFolding::FoldNode(NodeDef* node, GraphDef* output_graph,
                                      constant_output->name());
               *output->mutable_input(i) = AsControlDependency(*constant_output);
             }
-          } else if (port < const_nodes.size() &&
-                     !const_nodes[port].name().empty()) {
+          } else if (port < const_nodes->size() &&
+                     !(*const_nodes)[port].name().empty()) {
             // Replace alive outputs with the corresponding constant.
             node_map_->UpdateInput(output->name(), NodeName(output->input(i)),
-                                   const_nodes[port].name());
-            *output->mutable_input(i) = const_nodes[port].name();
+                                   (*const_nodes)[port].name());
+            *output->mutable_input(i) = (*const_nodes)[port].name();
           } else {
             // Leave this edge alone.
             VLOG(1) << "Preserving edge from " << node->name() << ":" << port
@@ -1440,34 +1493,99 @@ Status ConstantFolding::FoldGraph(
       queue.push_back(graph_->mutable_node(i));
     }
   }
+  // The nodes in the queue at any point are mutually independent: a node is
+  // only foldable once all its data inputs are constant. We can therefore
+  // fold the graph in waves: drain the queue, evaluate the whole wave on a
+  // threadpool, then apply the rewrites serially. The rewrites mutate the
+  // graph and node_map_, and enqueue newly foldable fanout for the next
+  // wave.
+  struct WaveItem {
+    NodeDef* node;
+    bool is_merge = false;
+    std::vector<NodeDef> const_nodes;
+    Status eval_status;
+    bool result_too_large = false;
+  };
+  std::unique_ptr<thread::ThreadPool> pool;
   while (!queue.empty()) {
-    NodeDef* node = queue.front();
-    queue.pop_front();
-    if (processed_nodes.count(node->name())) {
-      continue;
+    std::vector<WaveItem> wave;
+    while (!queue.empty()) {
+      NodeDef* node = queue.front();
+      queue.pop_front();
+      if (processed_nodes.count(node->name())) {
+        continue;
+      }
+      processed_nodes.insert(node->name());
+      WaveItem item;
+      item.node = node;
+      item.is_merge = IsMerge(*node);
+      wave.push_back(std::move(item));
+    }
+
+    // Evaluate the non-Merge members of the wave, in parallel if the wave
+    // is large enough to amortize the dispatch overhead. Evaluation only
+    // reads the graph; all mutation happens in the apply phase below.
+    // (Merge nodes don't evaluate anything, see FoldMergeNode.)
+    std::vector<WaveItem*> to_evaluate;
+    for (WaveItem& item : wave) {
+      if (!item.is_merge) {
+        to_evaluate.push_back(&item);
+      }
+    }
+    constexpr int kMinNodesPerParallelWave = 8;
+    if (to_evaluate.size() >= kMinNodesPerParallelWave) {
+      if (pool == nullptr) {
+        pool.reset(new thread::ThreadPool(Env::Default(), "constant_folding",
+                                          port::NumSchedulableCPUs()));
+      }
+      BlockingCounter counter(to_evaluate.size());
+      for (WaveItem* item : to_evaluate) {
+        pool->Schedule([this, item, &counter] {
+          item->eval_status = EvaluateOneFoldable(
+              *item->node, &item->const_nodes, &item->result_too_large);
+          counter.DecrementCount();
+        });
+      }
+      counter.Wait();
+    } else {
+      for (WaveItem* item : to_evaluate) {
+        item->eval_status = EvaluateOneFoldable(
+            *item->node, &item->const_nodes, &item->result_too_large);
+      }
     }
-    // We need to record a copy of output nodes before FoldNode() modifies it.
-    // We also need to ensure that the fanout is sorted deterministically.
-    const std::set<NodeDef*>& outputs = node_map_->GetOutputs(node->name());
-    std::vector<NodeDef*> fanout(outputs.begin(), outputs.end());
-    std::sort(fanout.begin(), fanout.end(),
-              [](const NodeDef* n1, const NodeDef* n2) {
-                return n1->name() < n2->name();
-              });
 
-    bool result_too_large = false;
-    Status s = FoldNode(node, output, &result_too_large);
-    processed_nodes.insert(node->name());
-    if (!s.ok()) {
-      VLOG(1) << "Failed to fold node " << node->DebugString()
-              << "\nError message: " << s;
-      if (result_too_large) {
-        nodes_to_not_simplify->emplace(node->name());
+    // Apply the rewrites serially, in wave order.
+    for (WaveItem& item : wave) {
+      NodeDef* node = item.node;
+      // We need to record a copy of output nodes before the rewrite
+      // modifies it. We also need to ensure that the fanout is sorted
+      // deterministically.
+      const std::set<NodeDef*>& outputs = node_map_->GetOutputs(node->name());
+      std::vector<NodeDef*> fanout(outputs.begin(), outputs.end());
+      std::sort(fanout.begin(), fanout.end(),
+                [](const NodeDef* n1, const NodeDef* n2) {
+                  return n1->name() < n2->name();
+                });
+
+      Status s;
+      if (item.is_merge) {
+        s = FoldMergeNode(node, output);
+      } else if (item.eval_status.ok()) {
+        s = ReplaceFoldedNode(node, output, &item.const_nodes);
+      } else {
+        s = item.eval_status;
       }
-    } else {
-      for (auto& output : fanout) {
-        if (IsFoldable(*output)) {
-          queue.push_back(output);
+      if (!s.ok()) {
+        VLOG(1) << "Failed to fold node " << node->DebugString()
+                << "\nError message: " << s;
+        if (item.result_too_large) {
+          nodes_to_not_simplify->emplace(node->name());
+        }
+      } else {
+        for (auto& output : fanout) {
+          if (IsFoldable(*output)) {
+            queue.push_back(output);
+          }
         }
       }
     }
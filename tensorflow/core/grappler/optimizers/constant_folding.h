@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/costs/graph_properties.h"
 #include "tensorflow/core/grappler/optimizers/graph_optimizer.h"
 #include "tensorflow/core/grappler/utils.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/protobuf/rewriter_config.pb.h"
 
 namespace tensorflow {
@@ -81,8 +82,12 @@ class ConstantFolding : public GraphOptimizer {
                              bool* result_too_large);
 
   Status FoldMergeNode(NodeDef* node, GraphDef* output_graph);
-  Status FoldNode(NodeDef* node, GraphDef* output_graph,
-                  bool* result_too_large);
+
+  // Rewrites "node" and its fanout to use the constant nodes in
+  // "const_nodes", which must have been produced for "node" by
+  // EvaluateOneFoldable.
+  Status ReplaceFoldedNode(NodeDef* node, GraphDef* output_graph,
+                           std::vector<NodeDef>* const_nodes);
 
   bool IsOnes(const NodeDef& node) const;
   bool IsZeros(const NodeDef& node) const;
@@ -253,6 +258,16 @@ class ConstantFolding : public GraphOptimizer {
   bool has_fetch_;
   bool graph_modified_;
   bool graph_contains_assign_or_inplace_op_;
+
+  // Memoized EvaluateOneFoldable results, keyed by a fingerprint of the
+  // evaluated node's op, attrs and constant input values.  Identical
+  // foldable subgraphs (common across function instantiations) are
+  // evaluated once; replays only regenerate the output node names.
+  // Guarded by a mutex because FoldGraph evaluates waves of independent
+  // foldable nodes in parallel.
+  mutex folded_memo_mu_;
+  std::unordered_map<uint64, std::vector<NodeDef>> folded_memo_
+      GUARDED_BY(folded_memo_mu_);
 };
 
 }  // end namespace grappler
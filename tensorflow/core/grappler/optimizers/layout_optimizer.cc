@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/grappler/clusters/cluster.h"
+#include "tensorflow/core/grappler/costs/analytical_cost_estimator.h"
 #include "tensorflow/core/grappler/devices.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/op_types.h"
@@ -34,6 +35,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace grappler {
@@ -2141,15 +2143,45 @@ class DataLayoutOptimizer : GraphProcessor {
   }
 
   // Remove all node pairs, where a NCHW-to-NHWC node is followed by
-  // a NHWC-to-NCHW node.
+  // a NHWC-to-NCHW node. Iterates to a fixed point, since removing a
+  // pair can bring another NCHW-to-NHWC node and NHWC-to-NCHW node
+  // next to each other.
   Status Collapse() {
+    for (int i = 0; i < graph_->node_size(); i++) {
+      graph_->mutable_node(i)->mutable_attr()->erase("_output_shapes");
+    }
+    // The collapsed nodes are erased from the graph only once at the end,
+    // so that the node map stays valid while pairs are being rewired.
     std::unordered_set<string> nodes_removable;
+    while (CollapseOnePass(&nodes_removable)) {
+    }
+    graph_->mutable_node()->erase(
+        std::remove_if(
+            graph_->mutable_node()->begin(), graph_->mutable_node()->end(),
+            [nodes_removable](const NodeDef& node) {
+              return nodes_removable.find(node.name()) != nodes_removable.end();
+            }),
+        graph_->mutable_node()->end());
+    return Status::OK();
+  }
+
+  // Collapses the node pairs that are currently adjacent. Returns true if
+  // at least one pair was found, since rewiring a pair's consumer can
+  // bring another NCHW-to-NHWC node and NHWC-to-NCHW node next to each
+  // other.
+  bool CollapseOnePass(std::unordered_set<string>* nodes_removable) {
+    bool collapsed = false;
     for (int i = 0; i < graph_->node_size(); i++) {
       auto node = graph_->mutable_node(i);
-      node->mutable_attr()->erase("_output_shapes");
+      if (nodes_removable->find(node->name()) != nodes_removable->end()) {
+        continue;
+      }
       if (IsTransposeNHWCToNCHW(node->name()) ||
           IsDimMapNHWCToNCHW(node->name()) ||
           IsVecPermuteNHWCToNCHW(node->name())) {
+        if (nodes_removable->find(node->input(0)) != nodes_removable->end()) {
+          continue;
+        }
         bool transpose_pair = IsTransposeNHWCToNCHW(node->name()) &&
                               IsTransposeNCHWToNHWC(node->input(0));
         bool dim_map_pair = IsDimMapNHWCToNCHW(node->name()) &&
@@ -2171,19 +2203,13 @@ class DataLayoutOptimizer : GraphProcessor {
               break;
             }
           }
-          nodes_removable.insert(trans_first);
-          nodes_removable.insert(trans_second);
+          nodes_removable->insert(trans_first);
+          nodes_removable->insert(trans_second);
+          collapsed = true;
         }
       }
     }
-    graph_->mutable_node()->erase(
-        std::remove_if(
-            graph_->mutable_node()->begin(), graph_->mutable_node()->end(),
-            [nodes_removable](const NodeDef& node) {
-              return nodes_removable.find(node.name()) != nodes_removable.end();
-            }),
-        graph_->mutable_node()->end());
-    return Status::OK();
+    return collapsed;
   }
 
   const LayoutOptimizer::TuningConfig& config_;
@@ -2199,6 +2225,40 @@ int GetNumGPUs(const Cluster& cluster) {
   }
   return num_gpus;
 }
+
+bool LayoutCostSelectionEnabled() {
+  static bool result = [] {
+    bool result = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_LAYOUT_OPTIMIZER_COST_SELECT", false,
+                                   &result));
+    return result;
+  }();
+  return result;
+}
+
+// Compares the predicted execution time of the original and the converted
+// graphs, and reverts to the original graph if the conversion is predicted
+// to be a regression. The predictions consult the measured cost database
+// when one has been calibrated for this machine.
+Status SelectCheaperGraph(Cluster* cluster, const GrapplerItem& item,
+                          GraphDef* output) {
+  AnalyticalCostEstimator estimator(cluster, /*use_static_shapes=*/true);
+  TF_RETURN_IF_ERROR(estimator.Initialize(item));
+  Costs original_costs;
+  TF_RETURN_IF_ERROR(
+      estimator.PredictCosts(item.graph, nullptr, &original_costs));
+  Costs converted_costs;
+  TF_RETURN_IF_ERROR(
+      estimator.PredictCosts(*output, nullptr, &converted_costs));
+  VLOG(1) << "Layout selection: original graph predicted at "
+          << original_costs.execution_time.count()
+          << " ns, converted graph predicted at "
+          << converted_costs.execution_time.count() << " ns";
+  if (converted_costs.execution_time > original_costs.execution_time) {
+    *output = item.graph;
+  }
+  return Status::OK();
+}
 }  // namespace
 
 Status LayoutOptimizer::Tune(const GrapplerItem& item,
@@ -2248,6 +2308,15 @@ Status LayoutOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   status = Tune(item, graph_properties, config, output);
   if (!status.ok()) {
     *output = item.graph;
+    return status;
+  }
+
+  if (LayoutCostSelectionEnabled()) {
+    Status select_status = SelectCheaperGraph(cluster, item, output);
+    if (!select_status.ok()) {
+      // Keep the converted graph if the costs couldn't be predicted.
+      VLOG(1) << "Layout cost selection failed: " << select_status.ToString();
+    }
   }
   return status;
 }
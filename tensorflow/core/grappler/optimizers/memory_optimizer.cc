@@ -771,6 +771,12 @@ struct SwapInfo {
   Costs::NanoSeconds time_to_swap = 0;
 };
 
+// Assumed bandwidth of the link between a GPU and host memory: PCIe
+// running at 16 GBps, i.e. 16 bytes per nanosecond. Used both to decide
+// which tensors can be swapped without delaying the computation and to
+// place the swap triggers.
+constexpr int64 kSwapBytesPerNanoSecond = 16;
+
 static const NodeDef* FindSwapInTrigger(
     const NodeDef* node, const SwapInfo& swap_info,
     const std::unordered_map<string, const NodeDef*>& name_map,
@@ -1017,9 +1023,14 @@ static bool IdentifySwappingCandidates(
         // Don't bother with small tensors.
         continue;
       }
+      // Time needed to move the tensor over the PCIe link, in each
+      // direction.
+      const Costs::Duration swap_time(live_tensor.memory_used /
+                                      kSwapBytesPerNanoSecond);
       if (live_tensor.deallocation_time - live_tensor.allocation_time <=
-          Costs::Duration(1e6)) {
-        // Not enough time to swap.
+          std::max<Costs::Duration>(Costs::Duration(1e6), 2 * swap_time)) {
+        // The tensor doesn't live long enough to amortize the two
+        // transfers.
         VLOG(1) << "Not enough time to swap: skipping " << live_tensor.node;
         continue;
       }
@@ -1069,6 +1080,19 @@ static bool IdentifySwappingCandidates(
         earliest_use = std::min(earliest_use, it->second);
       }
       if (valid && !mem_info.uses_left.empty()) {
+        // Only swap tensors whose swap-in can be hidden behind other
+        // computation on the schedule estimated by the virtual scheduler:
+        // there must be enough computation between the peak and the first
+        // remaining use to bring the tensor back over PCIe. Swapping a
+        // tensor that is reused right after the peak stalls the step on
+        // the swap-in instead of saving memory. The margin is doubled
+        // since the trigger placement below is only approximate.
+        if (earliest_use - peak_time <= 2 * swap_time) {
+          VLOG(1) << "Not enough time to hide the swap-in of "
+                  << live_tensor.node << ":" << live_tensor.output_id
+                  << ": skipping";
+          continue;
+        }
         // Compute the fitness: we need the tensor to be generated way away of
         // the time of peak memory usage (to ensure there is enough time to swap
         // it out). We also need to ensure it's used way after the peak time, to
@@ -1157,7 +1181,7 @@ bool SwappingPass(RewriterConfig::MemOptType optimization_level,
       bytes_to_swap += CalculateTensorSize(t);
     }
     // Let's assume we're going to swap over PCIe running at 16 GBps.
-    swap_info.time_to_swap = bytes_to_swap / 16;
+    swap_info.time_to_swap = bytes_to_swap / kSwapBytesPerNanoSecond;
   }
 
   std::unordered_map<const NodeDef*, Costs::NanoSeconds> execution_times;
@@ -14,6 +14,9 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/grappler/optimizers/meta_optimizer.h"
+
+#include <algorithm>
+
 #include "absl/strings/substitute.h"
 #include "tensorflow/core/common_runtime/function.h"
 #include "tensorflow/core/framework/function.pb.h"
@@ -41,8 +44,14 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils/topological_sort.h"
 #include "tensorflow/core/grappler/verifiers/structure_verifier.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/map_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/proto_serialization.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/util/dump_graph.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -74,6 +83,97 @@ int NumIterations(const RewriterConfig& cfg) {
              : cfg.meta_optimizer_iterations();
 }
 
+// Per-optimizer wall-time budget in microseconds, from
+// TF_GRAPPLER_PER_OPTIMIZER_TIMEOUT_MS.  Zero means no budget.  An optimizer
+// that exceeds its budget is handed a tighter deadline and is skipped in
+// subsequent meta-optimizer iterations.
+int64 PerOptimizerBudgetUsec() {
+  static int64 budget_usec = [] {
+    int64 timeout_ms = 0;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_GRAPPLER_PER_OPTIMIZER_TIMEOUT_MS", 0,
+                                    &timeout_ms));
+    return timeout_ms * 1000;
+  }();
+  return budget_usec;
+}
+
+// Returns true if optimized function bodies should be reused across
+// optimization runs (and sessions) for functions whose fingerprint has not
+// changed.  Controlled by TF_GRAPPLER_FUNCTION_OPTIMIZATION_CACHE.
+bool FunctionOptimizationCacheEnabled() {
+  static bool enabled = [] {
+    bool result = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRAPPLER_FUNCTION_OPTIMIZATION_CACHE",
+                                   false, &result));
+    return result;
+  }();
+  return enabled;
+}
+
+// Process-wide cache of optimized function bodies.  Keys fingerprint the
+// FunctionDef contents together with the optimization context (rewriter
+// config, graph producer version and device set), so repeated
+// Session::Create/Extend cycles reuse prior results for the part of the
+// function library that did not change between model versions.
+class FunctionOptimizationCache {
+ public:
+  struct OptimizedFunction {
+    FunctionDef optimized_func;
+    // Specialized functions created while optimizing the function body,
+    // which must be added to the library along with `optimized_func`.
+    std::vector<FunctionDef> specialized_funcs;
+  };
+
+  static FunctionOptimizationCache* Global() {
+    static FunctionOptimizationCache* cache = new FunctionOptimizationCache;
+    return cache;
+  }
+
+  bool Lookup(uint64 key, OptimizedFunction* result) {
+    mutex_lock l(mu_);
+    auto it = cache_.find(key);
+    if (it == cache_.end()) return false;
+    *result = it->second;
+    return true;
+  }
+
+  void Insert(uint64 key, OptimizedFunction result) {
+    mutex_lock l(mu_);
+    cache_.emplace(key, std::move(result));
+  }
+
+ private:
+  mutex mu_;
+  absl::flat_hash_map<uint64, OptimizedFunction> cache_ GUARDED_BY(mu_);
+};
+
+// Fingerprints the parts of the optimization context that affect the
+// optimized form of a function body.
+uint64 FunctionOptimizationContextHash(const ConfigProto& config_proto,
+                                       const GrapplerItem& item,
+                                       int graph_def_version) {
+  uint64 h = DeterministicProtoHash64(config_proto);
+  h = Hash64Combine(h, graph_def_version);
+  std::vector<string> devices(item.devices().begin(), item.devices().end());
+  std::sort(devices.begin(), devices.end());
+  for (const string& device : devices) {
+    h = Hash64Combine(h, Hash64(device));
+  }
+  return h;
+}
+
+// Returns true if independent function-library items should be optimized
+// concurrently across a threadpool.
+bool OptimizeFunctionLibraryInParallel() {
+  static bool enabled = [] {
+    bool result = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_GRAPPLER_PARALLEL_FUNCTION_OPTIMIZATION",
+                                   false, &result));
+    return result;
+  }();
+  return enabled;
+}
+
 // Check if optimizer is allowed to run only once.
 bool IsRunOnceOptimizer(const string& name) {
   return name == "layout" || name == "memory_optimizer" ||
@@ -361,6 +461,9 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
   GraphOptimizationResult optimization_result(item.id);
   GraphOptimizer* fusion_optimizer = nullptr;
   GraphOptimizer* sa_optimizer = nullptr;
+  // Optimizers that blew their per-optimizer time budget; they are not run
+  // again in later iterations.
+  absl::flat_hash_set<string> over_budget_optimizers;
 
   for (int iteration = 0; iteration < NumIterations(cfg_); ++iteration) {
     // Don't bother optimizing further if the graph is already tiny.
@@ -391,7 +494,21 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
         if (fusion_optimizer == nullptr) fusion_optimizer = optimizer.get();
         continue;
       }
+      if (over_budget_optimizers.count(optimizer->name()) > 0) {
+        VLOG(2) << "Skipping optimizer " << optimizer->name()
+                << ", it exceeded its time budget in an earlier iteration.";
+        continue;
+      }
+      const uint64 pass_start_us = Env::Default()->NowMicros();
       RUN_OPTIMIZER_OR_RETURN_IF_ERROR(optimizer.get());
+      if (PerOptimizerBudgetUsec() > 0 &&
+          Env::Default()->NowMicros() - pass_start_us >
+              static_cast<uint64>(PerOptimizerBudgetUsec())) {
+        VLOG(1) << "Optimizer " << optimizer->name()
+                << " exceeded its time budget; it will not run again for "
+                << "this item.";
+        over_budget_optimizers.insert(optimizer->name());
+      }
 
       if (VLOG_IS_ON(4)) {
         DumpGraphDefToFile(
@@ -433,7 +550,10 @@ Status MetaOptimizer::OptimizeGraph(Cluster* cluster, const GrapplerItem& item,
   }
 
   // Record graph optimization result.
-  optimization_results_.push_back(optimization_result);
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.push_back(optimization_result);
+  }
 
   if (is_optimized) {
     TF_RETURN_IF_ERROR(TopologicalSort(optimized_graph));
@@ -456,7 +576,14 @@ Status MetaOptimizer::RunOptimizer(
   // resets optimized_graph to an empty graph.
   optimized_graph->Swap(&optimized_item->graph);
   *optimized_graph = GraphDef();
-  optimizer->set_deadline_usec(this->deadline_usec());
+  uint64 pass_deadline_usec = this->deadline_usec();
+  if (PerOptimizerBudgetUsec() > 0) {
+    const uint64 budget_deadline = start_us + PerOptimizerBudgetUsec();
+    pass_deadline_usec = pass_deadline_usec == 0
+                             ? budget_deadline
+                             : std::min(pass_deadline_usec, budget_deadline);
+  }
+  optimizer->set_deadline_usec(pass_deadline_usec);
   Status status =
       optimizer->Optimize(cluster, *optimized_item, optimized_graph);
   uint64 end_us = Env::Default()->NowMicros();
@@ -481,7 +608,10 @@ Status MetaOptimizer::RunOptimizer(
 Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
                                GraphDef* optimized_graph) {
   VLOG(1) << "Starting optimization for grappler item: " << item.id;
-  optimization_results_.clear();
+  {
+    mutex_lock l(optimization_results_mu_);
+    optimization_results_.clear();
+  }
 
   // Constructs a FunctionLibraryDefinition with functions that are reachable
   // from the nodes of the graph.
@@ -551,12 +681,22 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
   bool optimize_function_library =
       item.optimization_options().optimize_function_library;
 
+  const bool use_function_cache = FunctionOptimizationCacheEnabled();
+  const uint64 function_cache_context_hash =
+      use_function_cache
+          ? FunctionOptimizationContextHash(
+                config_proto_, item, trimmed_item.graph.versions().producer())
+          : 0;
+
   while (optimize_function_library) {
     optimize_function_library = false;
+    GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
 
+    // Collect the functions to optimize in this library pass.  All of them
+    // are optimized against the same function library snapshot, so they are
+    // independent of each other and can be optimized concurrently.
+    std::vector<const FunctionDef*> funcs_to_optimize;
     for (const FunctionDef& func : optimized_graph->library().function()) {
-      GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
-
       const string& func_name = func.signature().name();
 
       // Skip functions that are not reachable from the optimized graph.
@@ -571,28 +711,55 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       // the function optimizer, before we can optimize function body.
       if (IsParametrized(func)) continue;
 
-      VLOG(3) << "Optimize function: function=" << func_name;
+      funcs_to_optimize.push_back(&func);
+    }
 
-      // Function optimization might specialize nested function calls, so we
-      // have to reset the flag and do at least one more pass over the library.
-      optimize_function_library = true;
-      optimized_funcs.insert(func_name);
+    // Optimize the body of each collected function.
+    struct FunctionOptimizationResult {
+      GrapplerFunctionItem func_item;
+      GraphDef optimized_func_graph;
+      Status status;
+      uint64 cache_key = 0;
+      bool from_cache = false;
+      FunctionOptimizationCache::OptimizedFunction cached;
+    };
+    std::vector<FunctionOptimizationResult> func_results(
+        funcs_to_optimize.size());
+
+    auto optimize_function = [&](int i) {
+      const FunctionDef& func = *funcs_to_optimize[i];
+      const string& func_name = func.signature().name();
+      FunctionOptimizationResult& result = func_results[i];
+
+      if (use_function_cache) {
+        result.cache_key = Hash64Combine(function_cache_context_hash,
+                                         DeterministicProtoHash64(func));
+        if (FunctionOptimizationCache::Global()->Lookup(result.cache_key,
+                                                        &result.cached)) {
+          VLOG(1) << "Function optimization cache hit: function=" << func_name;
+          result.from_cache = true;
+          return;
+        }
+      }
+
+      VLOG(3) << "Optimize function: function=" << func_name;
 
       // Make a GrapplerItem from a FunctionDef.
-      GrapplerFunctionItem func_item;
-      TF_RETURN_IF_ERROR(MakeGrapplerFunctionItem(
-          func, flib, trimmed_item.graph.versions().producer(), &func_item));
+      result.status = MakeGrapplerFunctionItem(
+          func, flib, trimmed_item.graph.versions().producer(),
+          &result.func_item);
+      if (!result.status.ok()) return;
 
-      // If we need to compute the gradient of optimized function at runtime, we
-      // can't perform non-differentiable rewrites.
+      // If we need to compute the gradient of optimized function at runtime,
+      // we can't perform non-differentiable rewrites.
       if (differentiable_functions.find(func_name) !=
           differentiable_functions.end()) {
-        func_item.optimization_options().allow_non_differentiable_rewrites =
-            false;
+        result.func_item.optimization_options()
+            .allow_non_differentiable_rewrites = false;
       }
 
       // Function item is allowed to use all devices from the main graph.
-      Status added_devices = func_item.AddDevices(item);
+      Status added_devices = result.func_item.AddDevices(item);
       if (!added_devices.ok()) {
         VLOG(3) << added_devices.error_message();
       }
@@ -601,30 +768,85 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
       // instantiated by the function definition, because we must guarantee
       // function execution semantics wrt side effects (see
       // function_optimizer.cc).
-      func_item.optimization_options().allow_pruning_stateful_and_dataset_ops =
-          false;
+      result.func_item.optimization_options()
+          .allow_pruning_stateful_and_dataset_ops = false;
 
       // Optimize function body graph.
-      GraphDef optimized_func_graph;
-      TF_RETURN_IF_ERROR(
-          OptimizeGraph(cluster, func_item, &optimized_func_graph));
+      result.status =
+          OptimizeGraph(cluster, result.func_item, &result.optimized_func_graph);
+    };
+
+    if (OptimizeFunctionLibraryInParallel() && funcs_to_optimize.size() > 1) {
+      const int num_threads =
+          std::min<int>(funcs_to_optimize.size(), port::NumSchedulableCPUs());
+      thread::ThreadPool pool(Env::Default(), "grappler_function_optimizer",
+                              num_threads);
+      BlockingCounter counter(funcs_to_optimize.size());
+      for (int i = 0; i < funcs_to_optimize.size(); ++i) {
+        pool.Schedule([&optimize_function, &counter, i]() {
+          optimize_function(i);
+          counter.DecrementCount();
+        });
+      }
+      counter.Wait();
+    } else {
+      for (int i = 0; i < funcs_to_optimize.size(); ++i) {
+        GRAPPLER_RETURN_IF_DEADLINE_EXCEEDED();
+        optimize_function(i);
+      }
+    }
+
+    // Merge the optimized function bodies back into the library.
+    for (int i = 0; i < funcs_to_optimize.size(); ++i) {
+      const string& func_name = funcs_to_optimize[i]->signature().name();
+      FunctionOptimizationResult& result = func_results[i];
+      TF_RETURN_IF_ERROR(result.status);
+
+      // Function optimization might specialize nested function calls, so we
+      // have to reset the flag and do at least one more pass over the library.
+      optimize_function_library = true;
+      optimized_funcs.insert(func_name);
+
+      if (result.from_cache) {
+        // Reuse the previously optimized body and its specializations.
+        for (const FunctionDef& func_def : result.cached.specialized_funcs) {
+          if (flib.Find(func_def.signature().name()) == nullptr) {
+            TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+          }
+        }
+        TF_RETURN_IF_ERROR(
+            flib.ReplaceFunction(func_name, result.cached.optimized_func));
+        continue;
+      }
 
       // Function body optimization might have created new specialized
       // functions for each instantiation context. Add them to the library.
+      FunctionOptimizationCache::OptimizedFunction cache_entry;
       for (const FunctionDef& func_def :
-           optimized_func_graph.library().function()) {
+           result.optimized_func_graph.library().function()) {
         if (flib.Find(func_def.signature().name()) == nullptr) {
           TF_RETURN_IF_ERROR(flib.AddFunctionDef(func_def));
+          if (use_function_cache) {
+            cache_entry.specialized_funcs.push_back(func_def);
+          }
         }
       }
 
       // Convert optimized graph back to FunctionDef.
       FunctionDef optimized_func;
-      func_item.SwapFunctionBody(std::move(optimized_func_graph));
-      TF_RETURN_IF_ERROR(MakeFunctionDef(func_item, flib, &optimized_func));
+      result.func_item.SwapFunctionBody(
+          std::move(result.optimized_func_graph));
+      TF_RETURN_IF_ERROR(MakeFunctionDef(result.func_item, flib,
+                                         &optimized_func));
 
       // Replace optimized function with a new FunctionDef.
       TF_RETURN_IF_ERROR(flib.ReplaceFunction(func_name, optimized_func));
+
+      if (use_function_cache) {
+        cache_entry.optimized_func = optimized_func;
+        FunctionOptimizationCache::Global()->Insert(result.cache_key,
+                                                    std::move(cache_entry));
+      }
     }
 
     // If optimized at least one function, update the graph library.
@@ -646,6 +868,7 @@ Status MetaOptimizer::Optimize(Cluster* cluster, const GrapplerItem& item,
 }
 
 void MetaOptimizer::PrintResult() {
+  mutex_lock l(optimization_results_mu_);
   for (const GraphOptimizationResult& graph_result : optimization_results_) {
     LOG(INFO) << "Optimization results for grappler item: " << graph_result.id;
     for (const OptimizerResult& result : graph_result.results) {
@@ -18,6 +18,10 @@ limitations under the License.
 #include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/tensor_shape.pb.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/grappler/costs/cost_estimator.h"
+#include "tensorflow/core/grappler/costs/op_context.h"
+#include "tensorflow/core/grappler/costs/op_level_cost_estimator.h"
+#include "tensorflow/core/grappler/costs/utils.h"
 #include "tensorflow/core/grappler/graph_view.h"
 #include "tensorflow/core/grappler/grappler_item.h"
 #include "tensorflow/core/grappler/op_types.h"
@@ -35,6 +39,11 @@ namespace internal {
 // dynamically determined.
 constexpr int64 kTensorMaxSize = 64;
 
+// A kernel whose compute time is below this is cheaper to run on the host
+// than to dispatch to an accelerator: the launch overhead alone exceeds
+// its compute time.
+constexpr int64 kGpuDispatchOverheadNanos = 10000;
+
 // All the nodes that should be blacklisted and not swapped.
 bool IsBlacklisted(const NodeDef& node) {
   return
@@ -46,11 +55,10 @@ bool IsBlacklisted(const NodeDef& node) {
       IsNoOp(node);
 }
 
-// Check if Tensor is integer and small size.
-bool IsTensorIntegerAndSmall(const OpInfo::TensorProperties& prop) {
-  // Check type to be int32 or int64.
-  if (prop.dtype() != DataType::DT_INT32 &&
-      prop.dtype() != DataType::DT_INT64) {
+// Check if Tensor is small size, regardless of element type.
+bool IsTensorSmall(const OpInfo::TensorProperties& prop) {
+  if (prop.dtype() == DataType::DT_RESOURCE ||
+      prop.dtype() == DataType::DT_VARIANT) {
     return false;
   }
 
@@ -63,6 +71,51 @@ bool IsTensorIntegerAndSmall(const OpInfo::TensorProperties& prop) {
   return true;
 }
 
+// Check if Tensor is integer and small size.
+bool IsTensorIntegerAndSmall(const OpInfo::TensorProperties& prop) {
+  // Check type to be int32 or int64.
+  if (prop.dtype() != DataType::DT_INT32 &&
+      prop.dtype() != DataType::DT_INT64) {
+    return false;
+  }
+
+  return IsTensorSmall(prop);
+}
+
+// Estimates whether the compute time of `node` is dwarfed by the overhead
+// of dispatching it to an accelerator. Calibrated timings from the
+// measured cost database take precedence inside OpLevelCostEstimator, so
+// profiled graphs are judged by their real kernel times; otherwise the
+// analytic estimates are used. Ops the estimator doesn't understand are
+// never considered cheap.
+Status IsNodeCheaperThanDispatch(GraphProperties* properties,
+                                 const NodeDef& node, bool* is_cheap) {
+  *is_cheap = false;
+  static const OpLevelCostEstimator* estimator = new OpLevelCostEstimator();
+
+  OpContext op_context;
+  op_context.name = node.name();
+  op_context.device_name = node.device();
+  auto& op_info = op_context.op_info;
+  op_info.set_op(node.op());
+  *op_info.mutable_attr() = node.attr();
+  for (const auto& input : properties->GetInputProperties(node.name())) {
+    *op_info.add_inputs() = input;
+  }
+  for (const auto& output : properties->GetOutputProperties(node.name())) {
+    *op_info.add_outputs() = output;
+  }
+  *op_info.mutable_device() = GetDeviceInfo(node.device());
+
+  const Costs costs = estimator->PredictCosts(op_context);
+  if (costs.inaccurate) {
+    return Status::OK();
+  }
+  *is_cheap =
+      costs.compute_time <= Costs::NanoSeconds(kGpuDispatchOverheadNanos);
+  return Status::OK();
+}
+
 // Find KernelDef for `node`, greedily return first found from `devices`.
 Status TryFindKernelDef(const std::vector<DeviceType>& devices,
                         const NodeDef& node, const KernelDef** kdef) {
@@ -82,9 +135,13 @@ Status TryFindKernelDef(const std::vector<DeviceType>& devices,
 
 // Checks if a node's output port is host friendly.
 // Roughly this means checking if the output port is on Host memory.
+// When `require_integer_tensor` is false, any small tensor qualifies;
+// this is used for the cost-driven path, where host residency rather
+// than element type is what matters.
 Status IsNodeOutputPortHostFriendly(const GraphView& graph,
                                     GraphProperties* properties,
                                     const NodeDef& node, int port_id,
+                                    bool require_integer_tensor,
                                     bool* is_candidate) {
   *is_candidate = false;
 
@@ -107,7 +164,9 @@ Status IsNodeOutputPortHostFriendly(const GraphView& graph,
                  << node.DebugString();
     return Status::OK();
   }
-  if (!IsTensorIntegerAndSmall(output_properties[port_id])) {
+  if (require_integer_tensor
+          ? !IsTensorIntegerAndSmall(output_properties[port_id])
+          : !IsTensorSmall(output_properties[port_id])) {
     return Status::OK();
   }
 
@@ -117,7 +176,8 @@ Status IsNodeOutputPortHostFriendly(const GraphView& graph,
     for (const auto& fanin : graph.GetFanins(node, false)) {
       bool fanin_candidate = false;
       TF_RETURN_IF_ERROR(IsNodeOutputPortHostFriendly(
-          graph, properties, *fanin.node, fanin.port_id, &fanin_candidate));
+          graph, properties, *fanin.node, fanin.port_id,
+          require_integer_tensor, &fanin_candidate));
       if (!fanin_candidate) {
         return Status::OK();
       }
@@ -211,6 +271,10 @@ bool IsNodeInputPortHostFriendly(const NodeDef& node, int port_id) {
 // 2] Check if node can run on Host.
 // 3] Check all input/outputs are Host "friendly" (atm, friendly means small,
 //    ints, and pinned to Host).
+// Nodes with small non-integer outputs can also qualify, but only when
+// they are placed on an accelerator, their estimated kernel time is below
+// the dispatch overhead, and all their consumers read from host memory,
+// so that the move cannot introduce new host<->device transfers.
 Status IsNodeHostCandidate(const GraphView& graph, GraphProperties* properties,
                            const NodeDef& node, bool* is_candidate) {
   *is_candidate = false;
@@ -232,25 +296,50 @@ Status IsNodeHostCandidate(const GraphView& graph, GraphProperties* properties,
     return Status::OK();
   }
 
-  // Check all inputs are Host friendly.
-  for (const GraphView::OutputPort& fanin :
-       graph.GetFanins(node, /*include_controlling_nodes=*/false)) {
-    bool fanin_candidate = false;
-    TF_RETURN_IF_ERROR(IsNodeOutputPortHostFriendly(
-        graph, properties, *fanin.node, fanin.port_id, &fanin_candidate));
-    if (!fanin_candidate) {
-      return Status::OK();
-    }
-  }
-
   // Check all outputs are Host friendly.
   if (!properties->has_properties()) {
     // This is an expensive call, call it lazily.
     TF_RETURN_IF_ERROR(properties->InferStatically(
         /*assume_valid_feeds=*/false));
   }
+  bool integer_outputs = true;
   for (const auto& prop : properties->GetOutputProperties(node.name())) {
-    if (!IsTensorIntegerAndSmall(prop)) {
+    if (!IsTensorSmall(prop)) {
+      return Status::OK();
+    }
+    if (prop.dtype() != DataType::DT_INT32 &&
+        prop.dtype() != DataType::DT_INT64) {
+      integer_outputs = false;
+    }
+  }
+
+  if (!integer_outputs) {
+    // Small non-integer outputs take the cost-driven path: only relocate
+    // accelerator-placed nodes that are cheaper to run than to dispatch.
+    if (!str_util::StrContains(node.device(), DEVICE_GPU)) {
+      return Status::OK();
+    }
+    bool is_cheap = false;
+    TF_RETURN_IF_ERROR(IsNodeCheaperThanDispatch(properties, node, &is_cheap));
+    if (!is_cheap) {
+      return Status::OK();
+    }
+    for (const GraphView::InputPort& fanout :
+         graph.GetFanouts(node, /*include_controlled_nodes=*/false)) {
+      if (!IsNodeInputPortHostFriendly(*fanout.node, fanout.port_id)) {
+        return Status::OK();
+      }
+    }
+  }
+
+  // Check all inputs are Host friendly.
+  for (const GraphView::OutputPort& fanin :
+       graph.GetFanins(node, /*include_controlling_nodes=*/false)) {
+    bool fanin_candidate = false;
+    TF_RETURN_IF_ERROR(IsNodeOutputPortHostFriendly(
+        graph, properties, *fanin.node, fanin.port_id,
+        /*require_integer_tensor=*/integer_outputs, &fanin_candidate));
+    if (!fanin_candidate) {
       return Status::OK();
     }
   }
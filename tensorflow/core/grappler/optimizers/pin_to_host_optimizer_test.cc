@@ -99,6 +99,47 @@ TEST_F(PinToHostOptimizerTest, OptimizeSmallOpsToHost) {
   EXPECT_EQ(found, 4);
 }
 
+TEST_F(PinToHostOptimizerTest, OptimizeCheapGpuOpsToHost) {
+  tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+  Output a =
+      ops::Const(s.WithOpName("a").WithDevice("/device:CPU:0"), 1.0f, {1});
+  Output b =
+      ops::Const(s.WithOpName("b").WithDevice("/device:CPU:0"), 2.0f, {1});
+  // A scalar float add whose kernel time is far below dispatch overhead,
+  // with host-resident inputs and no device consumers: it should be
+  // relocated even though its output is not an integer.
+  Output add = ops::Add(s.WithOpName("add").WithDevice("/device:GPU:0"), a, b);
+  // A reduction over a large tensor keeps its placement: either its
+  // estimated time exceeds the dispatch overhead or its input is not
+  // host friendly.
+  Output big = ops::Const(s.WithOpName("big").WithDevice("/device:CPU:0"),
+                          1.0f, {1024, 1024});
+  Output axes = ops::Const(s.WithOpName("axes").WithDevice("/device:CPU:0"),
+                           {0, 1}, {2});
+  Output sum =
+      ops::Sum(s.WithOpName("sum").WithDevice("/device:GPU:0"), big, axes);
+
+  GrapplerItem item;
+  item.fetch = {"add", "sum"};
+  TF_CHECK_OK(s.ToGraphDef(&item.graph));
+
+  GraphDef output;
+  PinToHostOptimizer optimizer(RewriterConfig::ON);
+  TF_EXPECT_OK(optimizer.Optimize(nullptr, item, &output));
+
+  int found = 0;
+  for (const NodeDef& node : output.node()) {
+    if (node.name() == "add") {
+      EXPECT_EQ(node.device(), "/device:CPU:0");
+      ++found;
+    } else if (node.name() == "sum") {
+      EXPECT_EQ(node.device(), "/device:GPU:0");
+      ++found;
+    }
+  }
+  EXPECT_EQ(found, 2);
+}
+
 TEST_F(PinToHostOptimizerTest, TopologicalSort) {
   tensorflow::Scope s = tensorflow::Scope::NewRootScope();
   Output a = ops::Const(s.WithOpName("a"), 1, {1024, 1024});
@@ -25,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/utils.h"
 #include "tensorflow/core/grappler/utils/symbolic_shapes.h"
 #include "tensorflow/core/grappler/utils/topological_sort.h"
+#include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/platform/logging.h"
 
 namespace tensorflow {
@@ -33,6 +34,8 @@ namespace grappler {
 namespace {
 
 constexpr char kFusedConv2D[] = "_FusedConv2D";
+constexpr char kFusedMatMul[] = "_FusedMatMul";
+constexpr char kFusedUnaryChain[] = "_FusedUnaryChain";
 
 constexpr char kDataFormat[] = "data_format";
 constexpr char kIsTraining[] = "is_training";
@@ -78,16 +81,48 @@ struct Conv2DWithBiasAdd {
   const NodeDef* bias_add = nullptr;
 };
 
-// Conv2D node followed by a BiasAdd and Relu.
-struct Conv2DWithBiasAddAndRelu {
-  Conv2DWithBiasAddAndRelu() = default;
-  Conv2DWithBiasAddAndRelu(const NodeDef* conv2d, const NodeDef* bias_add,
-                           const NodeDef* relu)
-      : conv2d(conv2d), bias_add(bias_add), relu(relu) {}
+// Conv2D node followed by a BiasAdd and Activation (Relu, Relu6 or Elu).
+struct Conv2DWithBiasAddAndActivation {
+  Conv2DWithBiasAddAndActivation() = default;
+  Conv2DWithBiasAddAndActivation(const NodeDef* conv2d, const NodeDef* bias_add,
+                                 const NodeDef* activation)
+      : conv2d(conv2d), bias_add(bias_add), activation(activation) {}
 
   const NodeDef* conv2d = nullptr;
   const NodeDef* bias_add = nullptr;
-  const NodeDef* relu = nullptr;
+  const NodeDef* activation = nullptr;
+};
+
+// MatMul node followed by a BiasAdd.
+struct MatMulWithBiasAdd {
+  MatMulWithBiasAdd() = default;
+  MatMulWithBiasAdd(const NodeDef* matmul, const NodeDef* bias_add)
+      : matmul(matmul), bias_add(bias_add) {}
+
+  const NodeDef* matmul = nullptr;
+  const NodeDef* bias_add = nullptr;
+};
+
+// MatMul node followed by a BiasAdd and Activation (Relu, Relu6 or Elu).
+struct MatMulWithBiasAddAndActivation {
+  MatMulWithBiasAddAndActivation() = default;
+  MatMulWithBiasAddAndActivation(const NodeDef* matmul, const NodeDef* bias_add,
+                                 const NodeDef* activation)
+      : matmul(matmul), bias_add(bias_add), activation(activation) {}
+
+  const NodeDef* matmul = nullptr;
+  const NodeDef* bias_add = nullptr;
+  const NodeDef* activation = nullptr;
+};
+
+// Chain of two or more elementwise unary ops, stored in application order
+// (first op of the chain first).
+struct UnaryElementwiseChain {
+  UnaryElementwiseChain() = default;
+  explicit UnaryElementwiseChain(std::vector<const NodeDef*> chain)
+      : chain(std::move(chain)) {}
+
+  std::vector<const NodeDef*> chain;
 };
 
 // Conv2D node followed by a Squeeze and BiasAdd.
@@ -114,23 +149,43 @@ struct Conv2DWithBatchNorm {
   float epsilon = 0.0;
 };
 
-// Conv2D node followed by a FusedBatchNorm and Relu.
-struct Conv2DWithBatchNormAndRelu {
-  Conv2DWithBatchNormAndRelu() = default;
-  Conv2DWithBatchNormAndRelu(const NodeDef* conv2d,
-                             const NodeDef* fused_batch_norm,
-                             const NodeDef* relu, float epsilon = 0.0)
+// Conv2D node followed by a FusedBatchNorm and Activation (Relu, Relu6 or
+// Elu).
+struct Conv2DWithBatchNormAndActivation {
+  Conv2DWithBatchNormAndActivation() = default;
+  Conv2DWithBatchNormAndActivation(const NodeDef* conv2d,
+                                   const NodeDef* fused_batch_norm,
+                                   const NodeDef* activation,
+                                   float epsilon = 0.0)
       : conv2d(conv2d),
         fused_batch_norm(fused_batch_norm),
-        relu(relu),
+        activation(activation),
         epsilon(epsilon) {}
 
   const NodeDef* conv2d = nullptr;
   const NodeDef* fused_batch_norm = nullptr;
-  const NodeDef* relu = nullptr;
+  const NodeDef* activation = nullptr;
   float epsilon = 0.0;
 };
 
+// Activation node that can be fused as an epilogue into a contraction (Conv2D
+// or MatMul) output kernel. GPU supports only the Relu activation (see
+// `IsGpuCompatible` below).
+bool IsSupportedActivation(const NodeDef& node) {
+  return IsRelu(node) || IsRelu6(node) || IsElu(node);
+}
+
+// Elementwise unary ops that have an interpreter stage in the
+// _FusedUnaryChain kernel (see kernels/cwise_op_fused_chain.cc).
+bool IsSupportedUnaryElementwise(const NodeDef& node) {
+  const string& op = node.op();
+  return op == "Abs" || op == "Ceil" || op == "Exp" || op == "Expm1" ||
+         op == "Floor" || op == "Log" || op == "Log1p" || op == "Neg" ||
+         op == "Reciprocal" || op == "Round" || op == "Rsqrt" ||
+         op == "Sigmoid" || op == "Sign" || op == "Sqrt" || op == "Square" ||
+         op == "Tanh";
+}
+
 bool IsInPreserveSet(const RemapperContext& ctx, const NodeDef* node) {
   return ctx.nodes_to_preserve.count(node->name()) > 0;
 }
@@ -186,15 +241,32 @@ bool IsGpuCompatibleConv2D(const NodeDef* conv2d) {
          IsGpuCompatibleDataFormat(conv2d);
 }
 
+bool IsCpuCompatibleMatMul(const NodeDef* matmul) {
+  DCHECK(IsMatMul(*matmul)) << "Expected MatMul op";
+  return NodeIsOnCpu(matmul) && IsCpuCompatibleDataType(matmul);
+}
+
 // Checks if we can rewrite a pattern to the `_FusedConv2D` on CPU device.
 template <typename Pattern>
 bool IsCpuCompatible(const Pattern& matched) {
   return IsCpuCompatibleConv2D(matched.conv2d);
 }
 
+// Checks if we can rewrite a pattern to the `_FusedMatMul` on CPU device.
+bool IsCpuCompatible(const MatMulWithBiasAdd& matched) {
+  return IsCpuCompatibleMatMul(matched.matmul);
+}
+bool IsCpuCompatible(const MatMulWithBiasAddAndActivation& matched) {
+  return IsCpuCompatibleMatMul(matched.matmul);
+}
+
 // Checks if we can rewrite a pattern to the `_FusedConv2D` on GPU device.
 bool IsGpuCompatible(const RemapperContext& ctx,
-                     const Conv2DWithBiasAddAndRelu& matched) {
+                     const Conv2DWithBiasAddAndActivation& matched) {
+  // The GPU kernel supports only the Relu activation (cuDNN
+  // `cudnnConvolutionBiasActivationForward` does not do Relu6/Elu).
+  if (!IsRelu(*matched.activation)) return false;
+
   const std::vector<OpInfo::TensorProperties>& input_props =
       ctx.graph_properties.GetInputProperties(matched.conv2d->name());
   const TensorShapeProto& filter_shape =
@@ -219,6 +291,15 @@ bool IsGpuCompatible(const RemapperContext& ctx,
                      const Conv2DWithSqueezeAndBiasAdd& matched) {
   return false;
 }
+// There is no GPU kernel for the `_FusedMatMul` op.
+bool IsGpuCompatible(const RemapperContext& ctx,
+                     const MatMulWithBiasAdd& matched) {
+  return false;
+}
+bool IsGpuCompatible(const RemapperContext& ctx,
+                     const MatMulWithBiasAddAndActivation& matched) {
+  return false;
+}
 
 // Returns true if the given pattern is supported on the assigned device.
 template <typename Pattern>
@@ -259,36 +340,144 @@ bool FindConv2DWithBias(const RemapperContext& ctx, const NodeDef* bias_add,
   return true;
 }
 
-bool FindConv2DWithBiasAndRelu(const RemapperContext& ctx, const NodeDef* relu,
-                               Conv2DWithBiasAddAndRelu* matched) {
+bool FindConv2DWithBiasAndActivation(const RemapperContext& ctx,
+                                     const NodeDef* activation,
+                                     Conv2DWithBiasAddAndActivation* matched) {
   if (!EigenSupportsContractionOutputKernel()) return false;
 
-  // Root of the pattern must be a Relu.
-  if (!relu || !IsRelu(*relu) || HasControlFaninOrFanout(ctx.graph_view, relu))
+  // Root of the pattern must be an activation node.
+  if (!activation || !IsSupportedActivation(*activation) ||
+      HasControlFaninOrFanout(ctx.graph_view, activation))
     return false;
 
-  // And input to Relu must match Conv2DWithBiasAdd pattern.
-  const auto input_port = GraphView::InputPort(relu, 0);
+  // And input to the activation node must match Conv2DWithBiasAdd pattern.
+  const auto input_port = GraphView::InputPort(activation, 0);
   const auto bias_add = ctx.graph_view.GetRegularFanin(input_port);
 
   Conv2DWithBiasAdd base;
   if (!FindConv2DWithBias(ctx, bias_add.node, &base,
                           /*check_device_compatible=*/false) ||
       !HasSingleFanoutNode(ctx.graph_view, base.bias_add) ||
-      !HaveSameDataType(relu, base.bias_add) ||
+      !HaveSameDataType(activation, base.bias_add) ||
       IsInPreserveSet(ctx, base.bias_add))
     return false;
 
   // Check that data type and data format are supported on assigned device.
-  const Conv2DWithBiasAddAndRelu pattern{base.conv2d, base.bias_add, relu};
+  const Conv2DWithBiasAddAndActivation pattern{base.conv2d, base.bias_add,
+                                               activation};
   if (!IsDeviceCompatible(ctx, pattern)) return false;
 
-  // We successfully found a Conv2D+BiasAdd+Relu pattern.
+  // We successfully found a Conv2D+BiasAdd+Activation pattern.
   *matched = pattern;
 
   return true;
 }
 
+bool FindMatMulWithBias(const RemapperContext& ctx, const NodeDef* bias_add,
+                        MatMulWithBiasAdd* matched,
+                        bool check_device_compatible = true) {
+  if (!EigenSupportsContractionOutputKernel()) return false;
+
+  // Root of the pattern must be a BiasAdd.
+  if (bias_add == nullptr || !IsBiasAdd(*bias_add) ||
+      HasControlFaninOrFanout(ctx.graph_view, bias_add))
+    return false;
+
+  // Input to the BiasAdd must be a MatMul.
+  const auto input_port = GraphView::InputPort(bias_add, 0);
+  const auto matmul = ctx.graph_view.GetRegularFanin(input_port);
+
+  if (!matmul.node || !IsMatMul(*matmul.node) ||
+      !HaveSameDataType(bias_add, matmul.node) ||
+      HasControlFaninOrFanout(ctx.graph_view, matmul.node) ||
+      !HasSingleFanoutNode(ctx.graph_view, matmul.node) ||
+      IsInPreserveSet(ctx, matmul.node))
+    return false;
+
+  // Check that data type is supported on assigned device.
+  const MatMulWithBiasAdd pattern{matmul.node, bias_add};
+  if (check_device_compatible && !IsDeviceCompatible(ctx, pattern)) {
+    return false;
+  }
+
+  // We successfully found a MatMul+BiasAdd pattern.
+  *matched = pattern;
+
+  return true;
+}
+
+bool FindMatMulWithBiasAndActivation(const RemapperContext& ctx,
+                                     const NodeDef* activation,
+                                     MatMulWithBiasAddAndActivation* matched) {
+  if (!EigenSupportsContractionOutputKernel()) return false;
+
+  // Root of the pattern must be an activation node.
+  if (!activation || !IsSupportedActivation(*activation) ||
+      HasControlFaninOrFanout(ctx.graph_view, activation))
+    return false;
+
+  // And input to the activation node must match MatMulWithBiasAdd pattern.
+  const auto input_port = GraphView::InputPort(activation, 0);
+  const auto bias_add = ctx.graph_view.GetRegularFanin(input_port);
+
+  MatMulWithBiasAdd base;
+  if (!FindMatMulWithBias(ctx, bias_add.node, &base,
+                          /*check_device_compatible=*/false) ||
+      !HasSingleFanoutNode(ctx.graph_view, base.bias_add) ||
+      !HaveSameDataType(activation, base.bias_add) ||
+      IsInPreserveSet(ctx, base.bias_add))
+    return false;
+
+  // Check that data type is supported on assigned device.
+  const MatMulWithBiasAddAndActivation pattern{base.matmul, base.bias_add,
+                                               activation};
+  if (!IsDeviceCompatible(ctx, pattern)) return false;
+
+  // We successfully found a MatMul+BiasAdd+Activation pattern.
+  *matched = pattern;
+
+  return true;
+}
+
+bool FindUnaryElementwiseChain(const RemapperContext& ctx, const NodeDef* node,
+                               UnaryElementwiseChain* matched) {
+  // Root of the pattern is the last op of the chain. It is the only node that
+  // is allowed to have multiple consumers (its name survives the fusion).
+  if (node == nullptr || !IsSupportedUnaryElementwise(*node) ||
+      !NodeIsOnCpu(node) || !IsCpuCompatibleDataType(node) ||
+      HasControlFaninOrFanout(ctx.graph_view, node))
+    return false;
+
+  // Walk up through producers as long as they stay inside the chain: a
+  // supported unary op of the same type, feeding only the next chain node.
+  std::vector<const NodeDef*> chain = {node};
+  const NodeDef* tail = node;
+  while (true) {
+    const auto input_port = GraphView::InputPort(tail, 0);
+    const auto producer = ctx.graph_view.GetRegularFanin(input_port);
+
+    if (!producer.node || !IsSupportedUnaryElementwise(*producer.node) ||
+        !NodeIsOnCpu(producer.node) ||
+        !HaveSameDataType(tail, producer.node) ||
+        HasControlFaninOrFanout(ctx.graph_view, producer.node) ||
+        !HasSingleFanoutNode(ctx.graph_view, producer.node) ||
+        IsInPreserveSet(ctx, producer.node))
+      break;
+
+    chain.push_back(producer.node);
+    tail = producer.node;
+  }
+
+  // A chain of one op is just the op itself.
+  if (chain.size() < 2) return false;
+
+  // We found a chain of elementwise unary ops; store it in application order.
+  std::reverse(chain.begin(), chain.end());
+  matched->chain = std::move(chain);
+
+  return true;
+}
+
 bool FindConv2DWithSqueezeAndBias(const RemapperContext& ctx,
                                   const NodeDef* bias_add,
                                   Conv2DWithSqueezeAndBiasAdd* matched) {
@@ -387,16 +576,17 @@ bool FindConv2DWithBatchNorm(const RemapperContext& ctx,
   return true;
 }
 
-bool FindConv2DWithBatchNormAndRelu(const RemapperContext& ctx,
-                                    const NodeDef* node,
-                                    Conv2DWithBatchNormAndRelu* matched) {
+bool FindConv2DWithBatchNormAndActivation(
+    const RemapperContext& ctx, const NodeDef* node,
+    Conv2DWithBatchNormAndActivation* matched) {
   if (!EigenSupportsContractionOutputKernel()) return false;
 
-  // Root of the pattern must be a Relu.
-  if (!node || !IsRelu(*node) || HasControlFaninOrFanout(ctx.graph_view, node))
+  // Root of the pattern must be an activation node.
+  if (!node || !IsSupportedActivation(*node) ||
+      HasControlFaninOrFanout(ctx.graph_view, node))
     return false;
 
-  // And input to Relu must match Conv2DWithBatchNorm pattern.
+  // And input to the activation node must match Conv2DWithBatchNorm pattern.
   const auto input_port = GraphView::InputPort(node, 0);
   const auto batch_norm = ctx.graph_view.GetRegularFanin(input_port);
 
@@ -407,10 +597,10 @@ bool FindConv2DWithBatchNormAndRelu(const RemapperContext& ctx,
       IsInPreserveSet(ctx, base.fused_batch_norm))
     return false;
 
-  // We successfully found a Conv2D+FusedBatchNorm+Relu pattern.
+  // We successfully found a Conv2D+FusedBatchNorm+Activation pattern.
   matched->conv2d = base.conv2d;
   matched->fused_batch_norm = base.fused_batch_norm;
-  matched->relu = node;
+  matched->activation = node;
   matched->epsilon = base.epsilon;
 
   return true;
@@ -484,6 +674,23 @@ void SetFusedConv2DAttributes(
   SetAttrValue(epsilon, &(*attr)["epsilon"]);  // required only for BatchNorm
 }
 
+void CopyMatMulAttributes(const NodeDef* matmul, NodeDef* fused_matmul) {
+  auto* attr = fused_matmul->mutable_attr();
+  auto src_attr = matmul->attr();
+
+  (*attr)["T"] = src_attr.at("T");
+  (*attr)["transpose_a"] = src_attr.at("transpose_a");
+  (*attr)["transpose_b"] = src_attr.at("transpose_b");
+}
+
+void SetFusedMatMulAttributes(
+    NodeDef* fused_matmul, const absl::Span<const absl::string_view> fused_ops,
+    int num_args = 1) {
+  auto* attr = fused_matmul->mutable_attr();
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+  SetAttrValue(num_args, &(*attr)["num_args"]);
+}
+
 void AddFusedConv2DNode(
     const RemapperContext& ctx, const Conv2DWithBiasAdd& matched,
     GraphDef* optimized_graph,
@@ -511,19 +718,19 @@ void AddFusedConv2DNode(
 }
 
 void AddFusedConv2DNode(
-    const RemapperContext& ctx, const Conv2DWithBiasAddAndRelu& matched,
+    const RemapperContext& ctx, const Conv2DWithBiasAddAndActivation& matched,
     GraphDef* optimized_graph,
     absl::flat_hash_set<const NodeDef*>* invalidated_nodes) {
   DCHECK(IsDeviceCompatible(ctx, matched))
       << "Unsupported fused Conv2D pattern";
 
-  VLOG(2) << "Fuse Conv2D with BiasAdd and Relu: "
-          << " relu=" << matched.relu->name()
+  VLOG(2) << "Fuse Conv2D with BiasAdd and " << matched.activation->op() << ": "
+          << " activation=" << matched.activation->name()
           << " bias_add=" << matched.bias_add->name()
           << " conv2d=" << matched.conv2d->name();
 
   NodeDef* fused_conv2d = optimized_graph->add_node();
-  fused_conv2d->set_name(matched.relu->name());
+  fused_conv2d->set_name(matched.activation->name());
   fused_conv2d->set_op(kFusedConv2D);
   fused_conv2d->set_device(matched.conv2d->device());
   fused_conv2d->add_input(matched.conv2d->input(0));    // 0: input
@@ -531,9 +738,10 @@ void AddFusedConv2DNode(
   fused_conv2d->add_input(matched.bias_add->input(1));  // 2: bias
 
   CopyConv2DAttributes(matched.conv2d, fused_conv2d);
-  SetFusedConv2DAttributes(fused_conv2d, {"BiasAdd", "Relu"});
+  SetFusedConv2DAttributes(fused_conv2d,
+                           {"BiasAdd", matched.activation->op()});
 
-  invalidated_nodes->insert(matched.relu);
+  invalidated_nodes->insert(matched.activation);
   invalidated_nodes->insert(matched.bias_add);
   invalidated_nodes->insert(matched.conv2d);
 }
@@ -601,15 +809,15 @@ void AddFusedConv2DNode(
 }
 
 void AddFusedConv2DNode(
-    const Conv2DWithBatchNormAndRelu& matched, GraphDef* optimized_graph,
+    const Conv2DWithBatchNormAndActivation& matched, GraphDef* optimized_graph,
     absl::flat_hash_set<const NodeDef*>* invalidated_nodes) {
-  VLOG(2) << "Fuse Conv2D with BatchNorm and Relu: relu="
-          << matched.relu->name()
+  VLOG(2) << "Fuse Conv2D with BatchNorm and " << matched.activation->op()
+          << ": activation=" << matched.activation->name()
           << " batch_norm=" << matched.fused_batch_norm->name()
           << " conv2d=" << matched.conv2d->name();
 
   NodeDef* fused_conv2d = optimized_graph->add_node();
-  fused_conv2d->set_name(matched.relu->name());
+  fused_conv2d->set_name(matched.activation->name());
   fused_conv2d->set_op(kFusedConv2D);
   fused_conv2d->set_device(matched.conv2d->device());
   fused_conv2d->add_input(matched.conv2d->input(0));            // 0: input
@@ -620,14 +828,104 @@ void AddFusedConv2DNode(
   fused_conv2d->add_input(matched.fused_batch_norm->input(4));  // 5: variance
 
   CopyConv2DAttributes(matched.conv2d, fused_conv2d);
-  SetFusedConv2DAttributes(fused_conv2d, {"FusedBatchNorm", "Relu"},
-                           /*num_args=*/4, /*epsilon=*/matched.epsilon);
+  SetFusedConv2DAttributes(
+      fused_conv2d, {"FusedBatchNorm", matched.activation->op()},
+      /*num_args=*/4, /*epsilon=*/matched.epsilon);
 
-  invalidated_nodes->insert(matched.relu);
+  invalidated_nodes->insert(matched.activation);
   invalidated_nodes->insert(matched.fused_batch_norm);
   invalidated_nodes->insert(matched.conv2d);
 }
 
+void AddFusedMatMulNode(
+    const RemapperContext& ctx, const MatMulWithBiasAdd& matched,
+    GraphDef* optimized_graph,
+    absl::flat_hash_set<const NodeDef*>* invalidated_nodes) {
+  DCHECK(IsDeviceCompatible(ctx, matched))
+      << "Unsupported fused MatMul pattern";
+
+  VLOG(2) << "Fuse MatMul with BiasAdd: "
+          << " bias_add=" << matched.bias_add->name()
+          << " matmul=" << matched.matmul->name();
+
+  NodeDef* fused_matmul = optimized_graph->add_node();
+  fused_matmul->set_op(kFusedMatMul);
+  fused_matmul->set_name(matched.bias_add->name());
+  fused_matmul->set_device(matched.matmul->device());
+  fused_matmul->add_input(matched.matmul->input(0));    // 0: a
+  fused_matmul->add_input(matched.matmul->input(1));    // 1: b
+  fused_matmul->add_input(matched.bias_add->input(1));  // 2: bias
+
+  CopyMatMulAttributes(matched.matmul, fused_matmul);
+  SetFusedMatMulAttributes(fused_matmul, {"BiasAdd"});
+
+  invalidated_nodes->insert(matched.bias_add);
+  invalidated_nodes->insert(matched.matmul);
+}
+
+void AddFusedMatMulNode(
+    const RemapperContext& ctx, const MatMulWithBiasAddAndActivation& matched,
+    GraphDef* optimized_graph,
+    absl::flat_hash_set<const NodeDef*>* invalidated_nodes) {
+  DCHECK(IsDeviceCompatible(ctx, matched))
+      << "Unsupported fused MatMul pattern";
+
+  VLOG(2) << "Fuse MatMul with BiasAdd and " << matched.activation->op() << ": "
+          << " activation=" << matched.activation->name()
+          << " bias_add=" << matched.bias_add->name()
+          << " matmul=" << matched.matmul->name();
+
+  NodeDef* fused_matmul = optimized_graph->add_node();
+  fused_matmul->set_op(kFusedMatMul);
+  fused_matmul->set_name(matched.activation->name());
+  fused_matmul->set_device(matched.matmul->device());
+  fused_matmul->add_input(matched.matmul->input(0));    // 0: a
+  fused_matmul->add_input(matched.matmul->input(1));    // 1: b
+  fused_matmul->add_input(matched.bias_add->input(1));  // 2: bias
+
+  CopyMatMulAttributes(matched.matmul, fused_matmul);
+  SetFusedMatMulAttributes(fused_matmul,
+                           {"BiasAdd", matched.activation->op()});
+
+  invalidated_nodes->insert(matched.activation);
+  invalidated_nodes->insert(matched.bias_add);
+  invalidated_nodes->insert(matched.matmul);
+}
+
+void AddFusedUnaryChainNode(
+    const RemapperContext& ctx, const UnaryElementwiseChain& matched,
+    GraphDef* optimized_graph,
+    absl::flat_hash_set<const NodeDef*>* invalidated_nodes) {
+  const NodeDef* first = matched.chain.front();
+  const NodeDef* last = matched.chain.back();
+
+  std::vector<string> fused_ops;
+  fused_ops.reserve(matched.chain.size());
+  for (const NodeDef* node : matched.chain) {
+    fused_ops.push_back(node->op());
+  }
+
+  VLOG(2) << "Fuse unary elementwise chain: ops=["
+          << str_util::Join(fused_ops, ",") << "] last=" << last->name();
+
+  NodeDef* fused_chain = optimized_graph->add_node();
+  fused_chain->set_op(kFusedUnaryChain);
+  fused_chain->set_name(last->name());
+  fused_chain->set_device(last->device());
+  fused_chain->add_input(first->input(0));  // 0: x
+
+  auto* attr = fused_chain->mutable_attr();
+  (*attr)["T"] = last->attr().at("T");
+  SetAttrValue(fused_ops, &(*attr)["fused_ops"]);
+
+  // All chain nodes but the last one are invalidated; the last node is
+  // replaced by the fused op with the same name.
+  const int num_fused = static_cast<int>(matched.chain.size());
+  for (int i = 0; i < num_fused - 1; ++i) {
+    invalidated_nodes->insert(matched.chain[i]);
+  }
+}
+
 void AddBatchNormNodes(const FusedBatchNorm& matched,
                        GraphDef* optimized_graph) {
   const NodeDef& fused_node = *matched.fused_batch_norm;
@@ -776,12 +1074,15 @@ Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
                           GraphDef* optimized_graph) {
   // Supported graph patterns.
   // clang-format off
-  FusedBatchNorm              fused_batch_norm;
-  Conv2DWithBiasAdd           conv2d_with_bias;
-  Conv2DWithBiasAddAndRelu    conv2d_with_bias_and_relu;
-  Conv2DWithBatchNorm         conv2d_with_batch_norm;
-  Conv2DWithBatchNormAndRelu  conv2d_with_batch_norm_and_relu;
-  Conv2DWithSqueezeAndBiasAdd conv2d_with_squeeze_and_bias;
+  FusedBatchNorm                   fused_batch_norm;
+  Conv2DWithBiasAdd                conv2d_with_bias;
+  Conv2DWithBiasAddAndActivation   conv2d_with_bias_and_activation;
+  Conv2DWithBatchNorm              conv2d_with_batch_norm;
+  Conv2DWithBatchNormAndActivation conv2d_with_batch_norm_and_activation;
+  Conv2DWithSqueezeAndBiasAdd      conv2d_with_squeeze_and_bias;
+  MatMulWithBiasAdd                matmul_with_bias;
+  MatMulWithBiasAddAndActivation   matmul_with_bias_and_activation;
+  UnaryElementwiseChain            unary_elementwise_chain;
   // clang-format on
 
   // Processing graph in reverse-topological sorted order allows to remap
@@ -811,9 +1112,10 @@ Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
                          &invalidated_nodes);
       continue;
     }
-    // Remap Conv2D+BiasAdd+Relu into the _FusedConv2D.
-    if (FindConv2DWithBiasAndRelu(ctx, &node, &conv2d_with_bias_and_relu)) {
-      AddFusedConv2DNode(ctx, conv2d_with_bias_and_relu, optimized_graph,
+    // Remap Conv2D+BiasAdd+Activation into the _FusedConv2D.
+    if (FindConv2DWithBiasAndActivation(ctx, &node,
+                                        &conv2d_with_bias_and_activation)) {
+      AddFusedConv2DNode(ctx, conv2d_with_bias_and_activation, optimized_graph,
                          &invalidated_nodes);
       continue;
     }
@@ -837,15 +1139,38 @@ Status Remapper::Optimize(Cluster* /*cluster*/, const GrapplerItem& item,
       continue;
     }
 
-    // Remap Conv2D+FusedBatchNorm+Relu into the _FusedConv2D;
-    if (FindConv2DWithBatchNormAndRelu(ctx, &node,
-                                       &conv2d_with_batch_norm_and_relu)) {
-      AddFusedConv2DNode(conv2d_with_batch_norm_and_relu, optimized_graph,
+    // Remap Conv2D+FusedBatchNorm+Activation into the _FusedConv2D;
+    if (FindConv2DWithBatchNormAndActivation(
+            ctx, &node, &conv2d_with_batch_norm_and_activation)) {
+      AddFusedConv2DNode(conv2d_with_batch_norm_and_activation, optimized_graph,
+                         &invalidated_nodes);
+      continue;
+    }
+
+    // Remap MatMul+BiasAdd into the _FusedMatMul.
+    if (FindMatMulWithBias(ctx, &node, &matmul_with_bias)) {
+      AddFusedMatMulNode(ctx, matmul_with_bias, optimized_graph,
+                         &invalidated_nodes);
+      continue;
+    }
+
+    // Remap MatMul+BiasAdd+Activation into the _FusedMatMul.
+    if (FindMatMulWithBiasAndActivation(ctx, &node,
+                                        &matmul_with_bias_and_activation)) {
+      AddFusedMatMulNode(ctx, matmul_with_bias_and_activation, optimized_graph,
                          &invalidated_nodes);
       continue;
     }
 #endif  // !INTEL_MKL
 
+    // Remap chains of elementwise unary ops into the _FusedUnaryChain, which
+    // evaluates the whole chain in a single pass over the data.
+    if (FindUnaryElementwiseChain(ctx, &node, &unary_elementwise_chain)) {
+      AddFusedUnaryChainNode(ctx, unary_elementwise_chain, optimized_graph,
+                             &invalidated_nodes);
+      continue;
+    }
+
     // Infer properties lazily in case they are not needed.
     if (!ctx.inferred_graph_properties && IsFusedBatchNormCandidate(node)) {
       TF_RETURN_IF_ERROR(ctx.graph_properties.InferStatically(false));
@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/scoped_allocator_mgr.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/op.h"
 #include "tensorflow/core/framework/node_def_util.h"
 #include "tensorflow/core/graph/graph.h"
 #include "tensorflow/core/grappler/costs/graph_properties.h"
@@ -25,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/grappler/op_types.h"
 #include "tensorflow/core/grappler/utils/frame.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/util/env_var.h"
 
 // Like TF_RETURN_IF_ERROR, but also logs a WARNING.
 #define LOG_WARNING_AND_RETURN_IF_ERROR(...)            \
@@ -196,6 +198,44 @@ Status RemoveEdge(const string& input_edge_name, const string& from_node_name,
   inputs->DeleteSubrange(edge_index, 1);
   return Status::OK();
 }
+
+// Build the ScopedAllocator node that will be assigned to allocate the
+// tensors described by inputs, then add control edges from it to the
+// producing nodes and mark them for allocation from the backing tensor.
+Status ConstructScopedAllocatorNode(
+    GraphDef* graph, NodeMap* node_map, const string& device_name,
+    DataType dtype, int sa_id, const string& sa_name,
+    const std::vector<TensorShape>& input_shapes,
+    const std::vector<InputDesc>& inputs, const TensorShape& sa_shape,
+    int64 expected_call_count) {
+  VLOG(2) << "ConstructScopedAllocatorNode " << sa_name;
+  NodeDefBuilder sa_builder(sa_name, "_ScopedAllocator");
+  sa_builder.Device(device_name);
+  sa_builder.Attr("sa_name", sa_name);
+  sa_builder.Attr("T", dtype);
+  sa_builder.Attr("id", sa_id);
+  sa_builder.Attr("shapes", input_shapes);
+  sa_builder.Attr("shape", sa_shape);
+  sa_builder.Attr("expected_call_count", expected_call_count);
+  NodeDef* sa_node = graph->add_node();
+  LOG_WARNING_AND_RETURN_IF_ERROR(sa_builder.Finalize(sa_node));
+  node_map->AddNode(sa_name, sa_node);
+
+  for (int i = 0; i < inputs.size(); ++i) {
+    auto& nd = inputs[i];
+    VLOG(2) << "To input " << i << ": " << nd.from_node_def->name()
+            << " add control input "
+            << "^" << sa_name;
+    nd.from_node_def->add_input(strings::StrCat("^", sa_name));
+    // This attribute says: allocate output_slot from
+    // ScopedAllocator instance sa_id + 1 + i.
+    ScopedAllocatorOptimizer::ExtendNodeAttr("_scoped_allocator",
+                                             {nd.output_slot, sa_id + 1 + i},
+                                             nd.from_node_def);
+    node_map->AddOutput(sa_name, nd.from_node_def->name());
+  }
+  return Status::OK();
+}
 }  // namespace
 
 void ScopedAllocatorOptimizer::ExtendNodeAttr(StringPiece name,
@@ -308,45 +348,6 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
     return Status::OK();
   }
 
-  // Build the ScopedAllocator node that will be assigned to allocate
-  // the output tensors of the input node set.
-  Status ConstructScopedAllocatorNode(
-      ScopedAllocatorOptimizer* sa_opti, GraphDef* graph, NodeMap* node_map,
-      const std::vector<NodeDef*>& ops, const string& device_name,
-      DataType dtype, int sa_id, const string& sa_name,
-      const std::vector<TensorShape>& input_shapes,
-      const std::vector<InputDesc>& inputs, const TensorShape& sa_shape) {
-    VLOG(2) << "ConstructScopedAllocatorNode " << sa_name;
-    NodeDefBuilder sa_builder(sa_name, "_ScopedAllocator");
-    sa_builder.Device(device_name);
-    sa_builder.Attr("sa_name", sa_name);
-    sa_builder.Attr("T", dtype);
-    sa_builder.Attr("id", sa_id);
-    sa_builder.Attr("shapes", input_shapes);
-    sa_builder.Attr("shape", sa_shape);
-    sa_builder.Attr("expected_call_count", static_cast<int64>(ops.size()));
-    NodeDef* sa_node = graph->add_node();
-    LOG_WARNING_AND_RETURN_IF_ERROR(sa_builder.Finalize(sa_node));
-    node_map->AddNode(sa_name, sa_node);
-
-    // Add control edges from the ScopedAllocatorOp to all of the
-    // input nodes and mark them for allocation from backing tensor.
-    for (int i = 0; i < inputs.size(); ++i) {
-      auto& nd = inputs[i];
-      VLOG(2) << "To input " << i << ": " << nd.from_node_def->name()
-              << " add control input "
-              << "^" << sa_name;
-      nd.from_node_def->add_input(strings::StrCat("^", sa_name));
-      // This attribute says: allocate output_slot from
-      // ScopedAllocator instance sa_id + 1 + i.
-      ScopedAllocatorOptimizer::ExtendNodeAttr("_scoped_allocator",
-                                               {nd.output_slot, sa_id + 1 + i},
-                                               nd.from_node_def);
-      node_map->AddOutput(sa_name, nd.from_node_def->name());
-    }
-    return Status::OK();
-  }
-
   Status BuildSAConcatNode(GraphDef* graph, NodeMap* node_map,
                            const std::vector<NodeDef*>& ops,
                            const std::set<string>& op_instance_names,
@@ -598,8 +599,8 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
     int sa_id = sa_opti->NewScopedAllocatorId(input_shapes.size());
     string sa_name = strings::StrCat("scoped_allocator_", sa_id);
     TF_RETURN_IF_ERROR(ConstructScopedAllocatorNode(
-        sa_opti, graph, node_map, ops, device_name, dtype, sa_id, sa_name,
-        input_shapes, inputs, sa_shape));
+        graph, node_map, device_name, dtype, sa_id, sa_name, input_shapes,
+        inputs, sa_shape, static_cast<int64>(ops.size())));
 
     // TODO(tucker): Maybe add control edges to delay execution of the
     // ScopedAllocatorOp until just before first use in order to
@@ -649,22 +650,252 @@ class UnaryElementwiseRewriter : public ScopedAllocatorOptimizer::Rewriter {
   }
 };
 
+// Rewrites a single axis-0 ConcatV2 or Pack node so that its inputs
+// are allocated from consecutive fields of one ScopedAllocator backing
+// tensor.  The node itself is then mutated in place into a
+// _ScopedAllocatorConcat, which only validates and reshapes the backing
+// tensor, so the concatenation copy is eliminated entirely.
+//
+// The rewrite applies only when the fields are naturally contiguous,
+// i.e. every input except the last occupies a whole multiple of
+// Allocator::kAllocatorAlignment bytes, because PopulateFields aligns
+// each field boundary up to that value and interior padding would break
+// the pure-reshape equivalence.  Patterns that do not qualify are left
+// untouched.
+class ConcatRewriter : public ScopedAllocatorOptimizer::Rewriter {
+ public:
+  ~ConcatRewriter() override {}
+
+  bool RewritesSingleNodes() const override { return true; }
+
+  // Returns true if the node's kernel may emit an output buffer that it
+  // did not allocate itself in the current step, e.g. by forwarding a
+  // reference, a constant, or a persistent tensor.  Such nodes cannot
+  // be redirected to allocate from a ScopedAllocator backing tensor.
+  static bool MayEmitUnownedBuffer(const NodeDef& n) {
+    static const std::set<string>* const kUnowned = new std::set<string>(
+        {"Const", "HostConst", "Identity", "IdentityN", "RefIdentity",
+         "Reshape", "Squeeze", "ExpandDims", "Snapshot", "StopGradient",
+         "PreventGradient", "Enter", "RefEnter", "Exit", "RefExit",
+         "NextIteration", "RefNextIteration", "Switch", "RefSwitch", "Merge",
+         "RefMerge", "Placeholder", "PlaceholderV2", "PlaceholderWithDefault",
+         "_Arg", "_Recv", "_ScopedAllocator", "_ScopedAllocatorConcat",
+         "_ScopedAllocatorSplit"});
+    if (kUnowned->find(n.op()) != kUnowned->end()) return true;
+    const OpDef* op_def = nullptr;
+    Status s = OpRegistry::Global()->LookUpOpDef(n.op(), &op_def);
+    // Unknown ops might forward; stateful ops may hold outputs across
+    // steps, violating the per-step expected_call_count.
+    return !s.ok() || op_def->is_stateful();
+  }
+
+  Status Rewrite(ScopedAllocatorOptimizer* sa_opti, GraphDef* graph,
+                 const string& op_name, const std::vector<NodeDef*>& ops,
+                 bool* applied) override {
+    CHECK_EQ(1, ops.size());
+    NodeDef* concat = ops[0];
+    *applied = false;
+    NodeMap* node_map = sa_opti->node_map();
+    CHECK(graph_properties_);
+    VLOG(1) << "ConcatRewriter::Rewrite " << concat->name();
+
+    if (concat->device().empty()) {
+      VLOG(1) << "Skipping " << concat->name() << ": no assigned device";
+      return Status::OK();
+    }
+    if (HasNodeAttr(*concat, "_scoped_allocator")) {
+      // The output is already committed to another ScopedAllocator;
+      // mutating the node would bypass that allocation.
+      VLOG(1) << "Skipping " << concat->name()
+              << ": output already assigned to a ScopedAllocator";
+      return Status::OK();
+    }
+    const bool is_pack = (concat->op() == "Pack");
+    AttrSlice concat_attrs(*concat);
+    DataType dtype;
+    int num_inputs = 0;
+    if (!GetNodeAttr(concat_attrs, "T", &dtype).ok() ||
+        !GetNodeAttr(concat_attrs, "N", &num_inputs).ok()) {
+      return Status::OK();
+    }
+    if (num_inputs < 2 || DataTypeSize(dtype) == 0 ||
+        (Allocator::kAllocatorAlignment % DataTypeSize(dtype)) != 0) {
+      VLOG(1) << "Skipping " << concat->name() << ": unsuitable N or dtype";
+      return Status::OK();
+    }
+    // Only an axis-0 concatenation maps onto the flat layout of the
+    // backing tensor.
+    if (is_pack) {
+      int axis = 0;
+      if (!GetNodeAttr(concat_attrs, "axis", &axis).ok() || axis != 0) {
+        VLOG(1) << "Skipping " << concat->name() << ": axis != 0";
+        return Status::OK();
+      }
+    } else {
+      if (concat->input_size() < num_inputs + 1) {
+        return Status::OK();
+      }
+      NodeDef* axis_node = node_map->GetNode(concat->input(num_inputs));
+      Tensor axis_tensor;
+      if (axis_node == nullptr || !IsConstant(*axis_node) ||
+          !GetNodeAttr(AttrSlice(*axis_node), "value", &axis_tensor).ok() ||
+          axis_tensor.NumElements() != 1 ||
+          (axis_tensor.dtype() != DT_INT32 &&
+           axis_tensor.dtype() != DT_INT64)) {
+        VLOG(1) << "Skipping " << concat->name() << ": non-Const axis";
+        return Status::OK();
+      }
+      const int64 axis = axis_tensor.dtype() == DT_INT64
+                             ? axis_tensor.flat<int64>()(0)
+                             : static_cast<int64>(axis_tensor.flat<int32>()(0));
+      if (axis != 0) {
+        VLOG(1) << "Skipping " << concat->name() << ": axis " << axis;
+        return Status::OK();
+      }
+    }
+    // The output shape must be fully known so the backing tensor can be
+    // validated against it.
+    if (!graph_properties_->HasOutputProperties(concat->name())) {
+      return Status::OK();
+    }
+    const std::vector<OpInfo::TensorProperties>& concat_props =
+        graph_properties_->GetOutputProperties(concat->name());
+    if (concat_props.size() != 1 ||
+        concat_props[0].shape().unknown_rank() ||
+        !TensorShape::IsValid(concat_props[0].shape())) {
+      VLOG(1) << "Skipping " << concat->name() << ": unknown output shape";
+      return Status::OK();
+    }
+    TensorShape output_shape(concat_props[0].shape());
+
+    std::vector<InputDesc> inputs;
+    std::vector<TensorShape> input_shapes;
+    std::set<string> seen_inputs;
+    int64 total_elements = 0;
+    for (int i = 0; i < num_inputs; ++i) {
+      const string& input_name = concat->input(i);
+      if (IsControlInput(input_name)) {
+        return errors::Internal("Node ", concat->name(),
+                                " has control input before data input ",
+                                input_name);
+      }
+      if (!seen_inputs.insert(input_name).second) {
+        // A tensor consumed twice would need two fields but would make
+        // only one allocation.
+        VLOG(1) << "Skipping " << concat->name() << ": duplicate input "
+                << input_name;
+        return Status::OK();
+      }
+      int output_slot = 0;
+      string producer_name = ParseNodeName(input_name, &output_slot);
+      NodeDef* producer = node_map->GetNode(input_name);
+      if (producer == nullptr || producer->device() != concat->device() ||
+          MayEmitUnownedBuffer(*producer) ||
+          HasNodeAttr(*producer, "_scoped_allocator")) {
+        VLOG(1) << "Skipping " << concat->name() << ": input " << input_name
+                << " cannot allocate from a ScopedAllocator";
+        return Status::OK();
+      }
+      if (!graph_properties_->HasOutputProperties(producer_name)) {
+        return Status::OK();
+      }
+      const std::vector<OpInfo::TensorProperties>& props =
+          graph_properties_->GetOutputProperties(producer_name);
+      if (output_slot >= static_cast<int>(props.size()) ||
+          props[output_slot].dtype() != dtype ||
+          props[output_slot].shape().unknown_rank() ||
+          !TensorShape::IsValid(props[output_slot].shape())) {
+        VLOG(1) << "Skipping " << concat->name() << ": input " << input_name
+                << " lacks a known shape";
+        return Status::OK();
+      }
+      TensorShape input_shape(props[output_slot].shape());
+      const int64 input_bytes =
+          input_shape.num_elements() * DataTypeSize(dtype);
+      if (i < num_inputs - 1 &&
+          (input_bytes % Allocator::kAllocatorAlignment) != 0) {
+        VLOG(1) << "Skipping " << concat->name() << ": input " << input_name
+                << " is not a multiple of kAllocatorAlignment bytes";
+        return Status::OK();
+      }
+      total_elements += input_shape.num_elements();
+      input_shapes.push_back(input_shape);
+      inputs.emplace_back(producer, output_slot, concat);
+    }
+    if (total_elements != output_shape.num_elements()) {
+      VLOG(1) << "Skipping " << concat->name()
+              << ": input/output element count mismatch";
+      return Status::OK();
+    }
+
+    // All checks passed; commit to the rewrite.
+    int sa_id = sa_opti->NewScopedAllocatorId(num_inputs);
+    string sa_name = strings::StrCat("scoped_allocator_", sa_id);
+    TF_RETURN_IF_ERROR(ConstructScopedAllocatorNode(
+        graph, node_map, concat->device(), dtype, sa_id, sa_name, input_shapes,
+        inputs, TensorShape({total_elements}),
+        static_cast<int64>(num_inputs)));
+
+    // Mutate the concat node in place into a _ScopedAllocatorConcat so
+    // that consumers and fetches of its name are unaffected.  The axis
+    // input edge of ConcatV2 is dropped; if the Const becomes dangling
+    // the dependency optimizer will remove it.
+    gtl::InlinedVector<string, 4> data_inputs;
+    gtl::InlinedVector<string, 4> ctl_inputs;
+    for (int i = 0; i < concat->input_size(); ++i) {
+      const string& input_name = concat->input(i);
+      if (IsControlInput(input_name)) {
+        ctl_inputs.push_back(input_name);
+      } else if (i < num_inputs) {
+        data_inputs.push_back(input_name);
+      } else {
+        node_map->RemoveOutput(NodeName(input_name), concat->name());
+      }
+    }
+    concat->set_op("_ScopedAllocatorConcat");
+    concat->clear_attr();
+    AddNodeAttr("sa_name", sa_name, concat);
+    AddNodeAttr("id", sa_id, concat);
+    AddNodeAttr("T", dtype, concat);
+    AddNodeAttr("shape", output_shape, concat);
+    AddNodeAttr("reshape", true, concat);
+    AddNodeAttr("N", num_inputs, concat);
+    concat->clear_input();
+    concat->add_input(sa_name);
+    for (const string& input_name : data_inputs) {
+      concat->add_input(input_name);
+    }
+    for (const string& input_name : ctl_inputs) {
+      concat->add_input(input_name);
+    }
+    node_map->AddOutput(sa_name, concat->name());
+
+    *applied = true;
+    return Status::OK();
+  }
+};
+
 ScopedAllocatorOptimizer::ScopedAllocatorOptimizer(
     RewriterConfig::Toggle opt_level, const ScopedAllocatorOptions& opts)
     : opt_level_(opt_level) {
   VLOG(1) << "ScopedAllocatorOptimizer::ScopedAllocatorOptimizer";
-  Rewriter* r = new UnaryElementwiseRewriter();
-  to_delete_.push_back(r);
+  Rewriter* unary = new UnaryElementwiseRewriter();
+  to_delete_.push_back(unary);
+  Rewriter* concat = new ConcatRewriter();
+  to_delete_.push_back(concat);
+  auto assign_rewriter = [this, unary, concat](const string& op_name) {
+    op_name_set_.insert(op_name);
+    rewriters_[op_name] =
+        (op_name == "ConcatV2" || op_name == "Pack") ? concat : unary;
+  };
   if (opts.enable_op_size() == 0) {
     // Opts handled by default:
-    for (const auto& op_name : {"CollectiveReduce"}) {
-      op_name_set_.insert(op_name);
-      rewriters_[op_name] = r;
+    for (const auto& op_name : {"CollectiveReduce", "ConcatV2", "Pack"}) {
+      assign_rewriter(op_name);
     }
   } else {
     for (const auto& op_name : opts.enable_op()) {
-      op_name_set_.insert(op_name);
-      rewriters_[op_name] = r;
+      assign_rewriter(op_name);
     }
   }
 }
@@ -809,6 +1040,55 @@ void PartitionByLoopStructure(const FrameView& frame_view,
   }
 }
 
+// Upper bound, in bytes, on the summed output sizes of the ops placed in a
+// single ScopedAllocator group, settable via
+// TF_SCOPED_ALLOCATOR_MAX_GROUP_BYTES.  Zero (the default) leaves grouping
+// unbounded.  Bounding the group size turns one graph-wide fusion of e.g.
+// gradient reductions into several size-targeted buckets, so the first
+// bucket's collective can launch while gradients destined for later buckets
+// are still being computed, and bounds the scratch memory held by any one
+// backing tensor.
+int64 MaxBytesPerGroup() {
+  // Read per call rather than cached: this runs once per candidate group
+  // during graph optimization, and tests exercise multiple settings in one
+  // process.
+  int64 max_bytes;
+  TF_CHECK_OK(
+      ReadInt64FromEnvVar("TF_SCOPED_ALLOCATOR_MAX_GROUP_BYTES", 0,
+                          &max_bytes));
+  return max_bytes;
+}
+
+// Splits "nodes" into consecutive groups whose summed output sizes do not
+// exceed "max_bytes"; a group always contains at least one node, so an op
+// larger than the budget gets a bucket of its own.  Nodes whose output shape
+// is not fully known contribute zero bytes here; the rewriter diagnoses them
+// when it later examines the group.
+void PartitionBySize(const GraphProperties& graph_properties, int64 max_bytes,
+                     const std::vector<NodeDef*>& nodes,
+                     std::vector<std::vector<NodeDef*>>* size_groups) {
+  size_groups->push_back(std::vector<NodeDef*>());
+  int64 group_bytes = 0;
+  for (NodeDef* nd : nodes) {
+    int64 node_bytes = 0;
+    if (graph_properties.HasOutputProperties(nd->name())) {
+      const std::vector<OpInfo::TensorProperties>& props =
+          graph_properties.GetOutputProperties(nd->name());
+      if (props.size() == 1 && TensorShape::IsValid(props[0].shape())) {
+        TensorShape shape(props[0].shape());
+        node_bytes = shape.num_elements() * DataTypeSize(props[0].dtype());
+      }
+    }
+    if (!size_groups->back().empty() &&
+        group_bytes + node_bytes > max_bytes) {
+      size_groups->push_back(std::vector<NodeDef*>());
+      group_bytes = 0;
+    }
+    size_groups->back().push_back(nd);
+    group_bytes += node_bytes;
+  }
+}
+
 }  // namespace
 
 Status ScopedAllocatorOptimizer::ProcessGraphDef(
@@ -835,11 +1115,23 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
           continue;
         }
         rewriter->SetGraphProperties(graph_properties);
+        if (rewriter->RewritesSingleNodes()) {
+          for (NodeDef* nd : it.second) {
+            // Rewrites inside loop bodies are not supported.
+            if (!frame_view.Frames(*nd).empty()) continue;
+            bool applied = false;
+            VLOG(1) << "Applying Rewriter for single node " << nd->name();
+            status = rewriter->Rewrite(this, graph, op_name, {nd}, &applied);
+            LOG_WARNING_AND_RETURN_IF_ERROR(status);
+          }
+          continue;
+        }
         std::unique_ptr<Tree> root(ComputeScopeTree(it.first, it.second));
         // Nodes with a common depth and root path are now grouped
         // in the same Tree struct.  Split those groups into subgroups that
         // share identical loop nesting.
         status = ApplyToAll(root.get(), [this, rewriter, graph, &frame_view,
+                                         &graph_properties,
                                          &op_name](Tree* t) {
           VLOG(2) << "applied to tree node " << t->edge_ << " at depth "
                   << t->depth_ << " of size " << t->nodes_.size();
@@ -848,12 +1140,27 @@ Status ScopedAllocatorOptimizer::ProcessGraphDef(
             PartitionByLoopStructure(frame_view, t->nodes_, &loop_groups);
             for (auto& lg : loop_groups) {
               if (lg.size() > 1) {
-                bool applied = false;
                 Status s = OrderNodeSet(&lg);
                 TF_RETURN_IF_ERROR(s);
-                VLOG(1) << "Applying Rewriter for " << op_name;
-                s = rewriter->Rewrite(this, graph, op_name, lg, &applied);
-                LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                // Optionally split the group into size-targeted buckets so
+                // that each backing tensor, and hence each fused op (e.g. a
+                // fused CollectiveReduce), stays below a byte budget.
+                const int64 max_bytes = MaxBytesPerGroup();
+                std::vector<std::vector<NodeDef*>> size_groups;
+                if (max_bytes > 0) {
+                  PartitionBySize(graph_properties, max_bytes, lg,
+                                  &size_groups);
+                } else {
+                  size_groups.push_back(std::move(lg));
+                }
+                for (auto& sg : size_groups) {
+                  if (sg.size() > 1) {
+                    bool applied = false;
+                    VLOG(1) << "Applying Rewriter for " << op_name;
+                    s = rewriter->Rewrite(this, graph, op_name, sg, &applied);
+                    LOG_WARNING_AND_RETURN_IF_ERROR(s);
+                  }
+                }
               }
             }
           }
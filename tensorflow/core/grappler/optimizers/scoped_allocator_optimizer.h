@@ -80,6 +80,11 @@ class ScopedAllocatorOptimizer : public GraphOptimizer {
                            const std::vector<NodeDef*>& nodes,
                            bool* applied) = 0;
 
+    // If true, Rewrite is invoked once per node rather than once per
+    // same-op group, i.e. the rewrite targets a single node and its
+    // producers rather than a set of sibling ops.
+    virtual bool RewritesSingleNodes() const { return false; }
+
     void SetGraphProperties(const GraphProperties& graph_properties) {
       graph_properties_ = &graph_properties;
       CHECK(graph_properties_);
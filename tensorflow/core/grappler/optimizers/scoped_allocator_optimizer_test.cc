@@ -94,6 +94,41 @@ class ScopedAllocatorOptimizerTest : public ::testing::Test {
     TF_CHECK_OK(s.ToGraphDef(graph_def));
   }
 
+  // Constructs the following graph.
+  //
+  // The intended optimization is to have m1 and m2 allocate from a new
+  // ScopedAllocator, then turn concat into a _ScopedAllocatorConcat
+  // view of the backing tensor.  Each input is 16 floats = 64 bytes,
+  // a multiple of Allocator::kAllocatorAlignment, as the rewrite
+  // requires.
+  /*
+        a    b    c
+         \  / \  /
+          m1   m2
+           \   /
+          concat
+  */
+  void BuildConcatGraph(GraphDef* graph_def) {
+    tensorflow::Scope s = tensorflow::Scope::NewRootScope();
+    s = s.WithDevice("/job:localhost/replica:0/task:0/device:CPU:0");
+
+    std::vector<float> a_vals(16);
+    std::vector<float> b_vals(16);
+    std::vector<float> c_vals(16);
+    for (int i = 0; i < 16; ++i) {
+      a_vals[i] = i;
+      b_vals[i] = (i % 2 == 0) ? 1.0 : -1.0;
+      c_vals[i] = 2.0;
+    }
+    Output a = ops::Const(s.WithOpName("a"), test::AsTensor<float>(a_vals));
+    Output b = ops::Const(s.WithOpName("b"), test::AsTensor<float>(b_vals));
+    Output c = ops::Const(s.WithOpName("c"), test::AsTensor<float>(c_vals));
+    Output m1 = ops::Mul(s.WithOpName("m1"), a, b);
+    Output m2 = ops::Mul(s.WithOpName("m2"), b, c);
+    Output concat = ops::Concat(s.WithOpName("concat"), {m1, m2}, 0);
+    TF_CHECK_OK(s.ToGraphDef(graph_def));
+  }
+
   void SetShapes(GraphDef* graph_def) {
     TensorShapeProto shape_proto;
     shape_proto.add_dim()->set_size(2);
@@ -217,8 +252,128 @@ TEST_F(ScopedAllocatorOptimizerTest, UnaryExecute) {
   }
 }
 
+TEST_F(ScopedAllocatorOptimizerTest, ConcatRewriteOnly) {
+  // Tests that an axis-0 ConcatV2 is turned in place into a
+  // _ScopedAllocatorConcat whose inputs allocate from the backing
+  // tensor.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph);
+  item.fetch.push_back("concat");
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("ConcatV2");
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+
+  // Examine the resulting graph def.
+  NodeMap node_map(&optimized_graph);
+  NodeDef* sa = node_map.GetNode("scoped_allocator_1");
+  ASSERT_TRUE(sa);
+  {
+    auto& sa_set = node_map.GetOutputs(sa->name());
+    ASSERT_EQ(3, sa_set.size());
+    std::unordered_set<string> expected = {"m1", "m2", "concat"};
+    for (auto it : sa_set) {
+      ASSERT_NE(expected.find(it->name()), expected.end())
+          << "Failed to find " << it->name();
+    }
+  }
+  // The producers should be marked for allocation from consecutive
+  // fields of the ScopedAllocator.
+  for (const auto& iap : std::vector<std::pair<string, int>>(
+           {{"m1", 2}, {"m2", 3}})) {
+    NodeDef* input_node = node_map.GetNode(iap.first);
+    ASSERT_TRUE(input_node);
+    std::vector<int32> scope_ids;
+    TF_ASSERT_OK(GetNodeAttr(AttrSlice(*input_node), "_scoped_allocator",
+                             &scope_ids));
+    ASSERT_EQ(2, scope_ids.size());
+    EXPECT_EQ(0, scope_ids[0]);
+    EXPECT_EQ(iap.second, scope_ids[1]);
+  }
+  // The fetched node keeps its name but now only reshapes the backing
+  // tensor; the axis input is gone.
+  NodeDef* concat = node_map.GetNode("concat");
+  ASSERT_TRUE(concat);
+  EXPECT_EQ("_ScopedAllocatorConcat", concat->op());
+  ASSERT_EQ(3, concat->input_size());
+  EXPECT_EQ("scoped_allocator_1", concat->input(0));
+  EXPECT_EQ("m1", concat->input(1));
+  EXPECT_EQ("m2", concat->input(2));
+  bool reshape = false;
+  TF_ASSERT_OK(GetNodeAttr(AttrSlice(*concat), "reshape", &reshape));
+  EXPECT_TRUE(reshape);
+}
+
+TEST_F(ScopedAllocatorOptimizerTest, ConcatExecute) {
+  // Constructs the same graph as ConcatRewriteOnly, but actually
+  // executes it and verifies the fetched concat value.
+  GrapplerItem item;
+  BuildConcatGraph(&item.graph);
+
+  ConfigProto config;
+  GraphOptions* gopt = config.mutable_graph_options();
+  OptimizerOptions* opts = gopt->mutable_optimizer_options();
+  opts->set_do_common_subexpression_elimination(false);
+  opts->set_do_constant_folding(false);
+  opts->set_do_function_inlining(false);
+  opts->set_opt_level(OptimizerOptions::L0);
+  RewriterConfig* rwcfg = gopt->mutable_rewrite_options();
+  rwcfg->clear_optimizers();
+  (*rwcfg->add_optimizers()) = "scoped_allocator";
+  rwcfg->mutable_scoped_allocator_opts()->add_enable_op("ConcatV2");
+  std::unique_ptr<Session> session(CreateSession(item.graph, config));
+
+  std::vector<std::pair<string, Tensor>> inputs;
+  std::vector<string> output_names = {"concat:0"};
+  std::vector<string> target_nodes = {};
+  std::vector<Tensor> outputs;
+  Status s = session->Run(inputs, output_names, target_nodes, &outputs);
+  TF_ASSERT_OK(s);
+  ASSERT_EQ(1, outputs.size());
+  ASSERT_EQ(32, outputs[0].NumElements());
+  for (int i = 0; i < 16; ++i) {
+    // m1 = a * b
+    float expected = i * ((i % 2 == 0) ? 1.0 : -1.0);
+    EXPECT_EQ(expected, outputs[0].flat<float>()(i));
+    // m2 = b * c
+    expected = ((i % 2 == 0) ? 1.0 : -1.0) * 2.0;
+    EXPECT_EQ(expected, outputs[0].flat<float>()(16 + i));
+  }
+}
+
 // Tests static ScopedAllocatorOptimizer::ExtendNodeAttr.
 // Maybe this should be moved elsewhere?
+TEST_F(ScopedAllocatorOptimizerTest, SizeTargetedBuckets) {
+  // With a byte budget smaller than two Abs outputs (16 bytes each), the
+  // candidate group splits into single-node buckets, and single-node buckets
+  // are not rewritten.
+  GrapplerItem item;
+  BuildAbsGraph(&item.graph);
+  SetShapes(&item.graph);
+
+  ScopedAllocatorOptions opts;
+  opts.add_enable_op("Abs");
+
+  setenv("TF_SCOPED_ALLOCATOR_MAX_GROUP_BYTES", "16", 1);
+  ScopedAllocatorOptimizer sao(RewriterConfig::ON, opts);
+  GraphDef optimized_graph;
+  TF_ASSERT_OK(sao.Optimize(nullptr /*cluster*/, item, &optimized_graph));
+  NodeMap node_map(&optimized_graph);
+  EXPECT_EQ(nullptr, node_map.GetNode("scoped_allocator_1"));
+
+  // A budget large enough for both outputs leaves the fusion intact.
+  setenv("TF_SCOPED_ALLOCATOR_MAX_GROUP_BYTES", "64", 1);
+  ScopedAllocatorOptimizer sao2(RewriterConfig::ON, opts);
+  GraphDef optimized_graph2;
+  TF_ASSERT_OK(sao2.Optimize(nullptr /*cluster*/, item, &optimized_graph2));
+  unsetenv("TF_SCOPED_ALLOCATOR_MAX_GROUP_BYTES");
+  NodeMap node_map2(&optimized_graph2);
+  EXPECT_NE(nullptr, node_map2.GetNode("scoped_allocator_1"));
+}
+
 TEST_F(ScopedAllocatorOptimizerTest, Extend) {
   NodeDef nd;
   ScopedAllocatorOptimizer::ExtendNodeAttr("_scoped_allocator", {0, 2}, &nd);
@@ -0,0 +1,93 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/async_checkpoint_engine.h"
+
+#include <utility>
+
+#include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+
+/* static */ bool AsyncCheckpointEngine::Enabled() {
+  static const bool enabled = []() {
+    bool enabled = false;
+    Status s = ReadBoolFromEnvVar("TF_ASYNC_CHECKPOINT", false, &enabled);
+    if (!s.ok()) {
+      LOG(ERROR) << s.error_message();
+    }
+    return enabled;
+  }();
+  return enabled;
+}
+
+/* static */ AsyncCheckpointEngine* AsyncCheckpointEngine::Global() {
+  static AsyncCheckpointEngine* engine =
+      new AsyncCheckpointEngine(Env::Default());
+  return engine;
+}
+
+AsyncCheckpointEngine::AsyncCheckpointEngine(Env* env)
+    : pool_(env, "async_checkpoint", 1) {}
+
+AsyncCheckpointEngine::~AsyncCheckpointEngine() {
+  WaitForPendingSaves();
+  mutex_lock l(mu_);
+  if (!last_status_.ok()) {
+    LOG(ERROR) << "Unreported async checkpoint failure: " << last_status_;
+  }
+}
+
+/* static */ Tensor AsyncCheckpointEngine::Snapshot(const Tensor& tensor) {
+  return tensor::DeepCopy(tensor);
+}
+
+void AsyncCheckpointEngine::ScheduleSave(std::function<Status()> save_fn) {
+  {
+    mutex_lock l(mu_);
+    ++pending_;
+  }
+  // NOTE: std::bind rather than a capturing lambda, so that `save_fn`
+  // is moved instead of copied into the scheduled closure.
+  pool_.Schedule(std::bind(
+      [this](std::function<Status()>& fn) {
+        const Status s = fn();
+        mutex_lock l(mu_);
+        if (!s.ok() && last_status_.ok()) {
+          last_status_ = s;
+        }
+        --pending_;
+        pending_cv_.notify_all();
+      },
+      std::move(save_fn)));
+}
+
+Status AsyncCheckpointEngine::ConsumeLastStatus() {
+  mutex_lock l(mu_);
+  Status s = last_status_;
+  last_status_ = Status::OK();
+  return s;
+}
+
+void AsyncCheckpointEngine::WaitForPendingSaves() {
+  mutex_lock l(mu_);
+  while (pending_ > 0) {
+    pending_cv_.wait(l);
+  }
+}
+
+}  // namespace tensorflow
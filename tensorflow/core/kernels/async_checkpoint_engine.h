@@ -0,0 +1,91 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_KERNELS_ASYNC_CHECKPOINT_ENGINE_H_
+#define TENSORFLOW_CORE_KERNELS_ASYNC_CHECKPOINT_ENGINE_H_
+
+#include <functional>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/platform/thread_annotations.h"
+
+namespace tensorflow {
+
+// Runs checkpoint writes on a background thread so that the step thread
+// only pays for snapshotting the tensors being saved.
+//
+// A save kernel using the engine splits its work in two phases:
+//
+//   1. Snapshot, on the step thread: copy the tensors to save with
+//      `Snapshot()` so the bytes written are the values at the step
+//      boundary, isolated from later in-place variable updates.
+//   2. Serialize and write, on the engine thread: `ScheduleSave()` a
+//      closure that owns the snapshots and performs the actual
+//      serialization and file I/O while training continues.
+//
+// Saves execute in submission order on a single thread, so successive
+// checkpoints cannot interleave their writes. A failed save is reported
+// on the step thread by calling `ConsumeLastStatus()` before scheduling
+// the next one, mirroring how other deferred-error paths surface
+// failures on the subsequent call.
+//
+// This class is thread-safe.
+class AsyncCheckpointEngine {
+ public:
+  // Whether async checkpointing was requested via TF_ASYNC_CHECKPOINT.
+  static bool Enabled();
+
+  // Returns the process-wide engine, creating it on first use.
+  static AsyncCheckpointEngine* Global();
+
+  explicit AsyncCheckpointEngine(Env* env);
+
+  // Blocks until all scheduled saves have finished.
+  ~AsyncCheckpointEngine();
+
+  // Returns a copy of `tensor` that shares no buffer with it. Variable
+  // buffers are updated in place by assign ops, so a plain (buffer
+  // refcounting) Tensor copy is not sufficient isolation for a tensor
+  // that may alias one; the deep copy is the snapshot.
+  static Tensor Snapshot(const Tensor& tensor);
+
+  // Runs `save_fn` on the background thread. The closure must own all
+  // the state it needs; in particular it must not reference an
+  // OpKernelContext, which dies when the scheduling kernel returns.
+  void ScheduleSave(std::function<Status()> save_fn);
+
+  // Returns the first error produced by a completed save since the last
+  // call, or OK. The error is cleared, so it is reported exactly once.
+  Status ConsumeLastStatus();
+
+  // Blocks until all scheduled saves have finished.
+  void WaitForPendingSaves();
+
+ private:
+  thread::ThreadPool pool_;
+
+  mutable mutex mu_;
+  condition_variable pending_cv_;
+  int64 pending_ GUARDED_BY(mu_) = 0;
+  Status last_status_ GUARDED_BY(mu_);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_ASYNC_CHECKPOINT_ENGINE_H_
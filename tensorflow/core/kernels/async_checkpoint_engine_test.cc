@@ -0,0 +1,77 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/kernels/async_checkpoint_engine.h"
+
+#include <vector>
+
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(AsyncCheckpointEngineTest, SnapshotDoesNotAliasSource) {
+  Tensor original(DT_FLOAT, TensorShape({2}));
+  original.flat<float>()(0) = 1.0f;
+  original.flat<float>()(1) = 2.0f;
+
+  Tensor snapshot = AsyncCheckpointEngine::Snapshot(original);
+  // An in-place update after the snapshot (as an assign op would do to
+  // a variable buffer) must not be visible in the snapshot.
+  original.flat<float>()(0) = -1.0f;
+
+  test::ExpectTensorEqual<float>(snapshot,
+                                 test::AsTensor<float>({1.0f, 2.0f}));
+}
+
+TEST(AsyncCheckpointEngineTest, RunsSavesInSubmissionOrder) {
+  AsyncCheckpointEngine engine(Env::Default());
+
+  mutex mu;
+  std::vector<int> completed;
+  for (int i = 0; i < 8; ++i) {
+    engine.ScheduleSave([&mu, &completed, i]() {
+      mutex_lock l(mu);
+      completed.push_back(i);
+      return Status::OK();
+    });
+  }
+  engine.WaitForPendingSaves();
+
+  ASSERT_EQ(completed.size(), 8);
+  for (int i = 0; i < 8; ++i) {
+    EXPECT_EQ(completed[i], i);
+  }
+  TF_EXPECT_OK(engine.ConsumeLastStatus());
+}
+
+TEST(AsyncCheckpointEngineTest, ConsumeLastStatusReportsFailureOnce) {
+  AsyncCheckpointEngine engine(Env::Default());
+
+  engine.ScheduleSave(
+      []() { return errors::DataLoss("disk on fire"); });
+  engine.WaitForPendingSaves();
+
+  Status s = engine.ConsumeLastStatus();
+  EXPECT_TRUE(errors::IsDataLoss(s));
+  // The error is cleared once consumed.
+  TF_EXPECT_OK(engine.ConsumeLastStatus());
+}
+
+}  // namespace
+}  // namespace tensorflow
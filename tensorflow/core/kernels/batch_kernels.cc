@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
@@ -204,6 +205,20 @@ Status Split(OpKernelContext* context, const Tensor& input,
   return SplitCPU<T>(context, input, sizes, outputs);
 }
 
+// Experimental: assemble batches of memcpy-able tensors with one copy per
+// task directly into the preallocated batch tensor, instead of going
+// through the generic concat machinery. See
+// BatchResource::DirectAssembleInputTensor().
+static bool DirectBatchAssemblyEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_BATCH_DIRECT_ASSEMBLY",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
 // A class encapsulating the state and logic for batching tensors.
 class BatchResource : public ResourceBase {
  public:
@@ -327,6 +342,68 @@ class BatchResource : public ResourceBase {
     return batch_size;
   }
 
+  // Copies the tasks' 'input_index'th tensors row-contiguously into a
+  // preallocated padded batch tensor, with one memcpy per task. This
+  // bypasses the generic concat machinery, whose per-input setup and
+  // sharding overheads dominate for batches of many tiny feature
+  // tensors. Padding rows replicate the first task's first row, matching
+  // the padding behavior of ConcatInputTensors(). The caller must ensure
+  // the tensors' element type is memcpy-able; all batch kernels run on
+  // host memory.
+  Status DirectAssembleInputTensor(const Batch& batch, int input_index,
+                                   int padded_batch_size,
+                                   OpKernelContext* context,
+                                   Tensor* output) const {
+    const Tensor& first = batch.task(0).inputs.at(input_index);
+    TensorShape output_shape(first.shape());
+    output_shape.set_dim(0, padded_batch_size);
+    TF_RETURN_IF_ERROR(
+        context->allocate_temp(first.dtype(), output_shape, output));
+    if (output->NumElements() == 0) {
+      return Status::OK();
+    }
+
+    char* out = const_cast<char*>(output->tensor_data().data());
+    int64 offset = 0;
+    for (int task_idx = 0; task_idx < batch.num_tasks(); ++task_idx) {
+      const Tensor& input = batch.task(task_idx).inputs.at(input_index);
+      if (input.dims() != first.dims()) {
+        return errors::InvalidArgument(
+            "Ranks of all input tensors should match: shape[0] = ",
+            first.shape().DebugString(), " vs. shape[", task_idx,
+            "] = ", input.shape().DebugString());
+      }
+      for (int j = 1; j < input.dims(); ++j) {
+        if (input.dim_size(j) != first.dim_size(j)) {
+          return errors::InvalidArgument(
+              "Dimensions of inputs should match: shape[0] = ",
+              first.shape().DebugString(), " vs. shape[", task_idx,
+              "] = ", input.shape().DebugString());
+        }
+      }
+      const StringPiece data = input.tensor_data();
+      memcpy(out + offset, data.data(), data.size());
+      offset += data.size();
+    }
+
+    // Replicate the first row of the first task's tensor into any padding
+    // rows.
+    const int64 total_bytes = output->tensor_data().size();
+    const int64 row_bytes = total_bytes / padded_batch_size;
+    const StringPiece padding_row = first.tensor_data().substr(0, row_bytes);
+    if (offset < total_bytes &&
+        static_cast<int64>(padding_row.size()) < row_bytes) {
+      return errors::InvalidArgument(
+          "Cannot pad an empty task's input: shape[0] = ",
+          first.shape().DebugString());
+    }
+    while (offset < total_bytes) {
+      memcpy(out + offset, padding_row.data(), row_bytes);
+      offset += row_bytes;
+    }
+    return Status::OK();
+  }
+
   Status ConcatInputTensors(const Batch& batch, OpKernelContext* context,
                             std::vector<Tensor>* concatenated_tensors) const {
     if (batch.num_tasks() == 0) {
@@ -342,6 +419,15 @@ class BatchResource : public ResourceBase {
 
     // Process each input one at a time (the typical case has just one).
     for (int i = 0; i < num_inputs; ++i) {
+      if (DirectBatchAssemblyEnabled() &&
+          DataTypeCanUseMemcpy(batch.task(0).inputs.at(i).dtype())) {
+        Tensor assembled;
+        TF_RETURN_IF_ERROR(DirectAssembleInputTensor(
+            batch, i, padded_batch_size, context, &assembled));
+        concatenated_tensors->push_back(assembled);
+        continue;
+      }
+
       // Concatenate the tasks ith input tensors into a big output tensor.
       std::vector<Tensor> to_concatenate;
       to_concatenate.reserve(batch.num_tasks());
@@ -312,6 +312,37 @@ struct LaunchBatchMatMul<GPUDevice, Scalar> {
     OP_REQUIRES(context, stream, errors::Internal("No GPU stream available."));
 
     typedef se::DeviceMemory<Scalar> DeviceMemoryType;
+    typedef Scalar Coefficient;
+
+    // The batch slices of a BatchMatMul are always regularly strided, so
+    // for real types the whole batch can be issued as one strided-batched
+    // GEMM on the base pointers. This avoids building a pointer array and
+    // uploading it through a scratch allocation on every step, which
+    // dominates launch overhead for large batches of small matrices.
+    // Complex types stay on the pointer-array interface below.
+    if (batch_size > 1 && !is_complex<Scalar>::value) {
+      auto a_device = AsDeviceMemory(in_x.template flat<Scalar>().data());
+      auto b_device = AsDeviceMemory(in_y.template flat<Scalar>().data());
+      auto c_device = AsDeviceMemory(out->template flat<Scalar>().data());
+      bool blas_launch_status =
+          stream
+              ->ThenBlasGemmStridedBatched(
+                  blas_transpose_b, blas_transpose_a, n, m, k,
+                  static_cast<Coefficient>(1.0), b_device, adj_y ? k : n,
+                  static_cast<int64>(k * n), a_device, adj_x ? m : k,
+                  static_cast<int64>(m * k), static_cast<Coefficient>(0.0),
+                  &c_device, n, static_cast<int64>(m * n), batch_size)
+              .ok();
+      if (!blas_launch_status) {
+        context->SetStatus(errors::Internal(
+            "Blas xGEMMStridedBatched launch failed : a.shape=",
+            in_x.shape().DebugString(),
+            ", b.shape=", in_y.shape().DebugString(), ", m=", m, ", n=", n,
+            ", k=", k, ", batch_size=", batch_size));
+      }
+      return;
+    }
+
     std::vector<DeviceMemoryType> a_device_memory;
     std::vector<DeviceMemoryType> b_device_memory;
     std::vector<DeviceMemoryType> c_device_memory;
@@ -336,8 +367,6 @@ struct LaunchBatchMatMul<GPUDevice, Scalar> {
       c_ptrs.push_back(&c_device_memory.back());
     }
 
-    typedef Scalar Coefficient;
-
     // Blas does
     // C = A x B
     // where A, B and C are assumed to be in column major.
@@ -429,72 +458,60 @@ struct LaunchBatchMatMul<GPUDevice, Eigen::half> {
     OP_REQUIRES(context, stream, errors::Internal("No GPU stream available."));
 
     typedef perftools::gputools::DeviceMemory<Scalar> DeviceMemoryType;
-    std::vector<DeviceMemoryType> a_device_memory;
-    std::vector<DeviceMemoryType> b_device_memory;
-    std::vector<DeviceMemoryType> c_device_memory;
-    std::vector<DeviceMemoryType*> a_ptrs;
-    std::vector<DeviceMemoryType*> b_ptrs;
-    std::vector<DeviceMemoryType*> c_ptrs;
-    a_device_memory.reserve(batch_size);
-    b_device_memory.reserve(batch_size);
-    c_device_memory.reserve(batch_size);
-    a_ptrs.reserve(batch_size);
-    b_ptrs.reserve(batch_size);
-    c_ptrs.reserve(batch_size);
-    auto* a_base_ptr = in_x.template flat<Scalar>().data();
-    auto* b_base_ptr = in_y.template flat<Scalar>().data();
-    auto* c_base_ptr = out->template flat<Scalar>().data();
-    for (int64 i = 0; i < batch_size; ++i) {
-      a_device_memory.push_back(AsDeviceMemory(a_base_ptr + i * m * k));
-      b_device_memory.push_back(AsDeviceMemory(b_base_ptr + i * k * n));
-      c_device_memory.push_back(AsDeviceMemory(c_base_ptr + i * m * n));
-      a_ptrs.push_back(&a_device_memory.back());
-      b_ptrs.push_back(&b_device_memory.back());
-      c_ptrs.push_back(&c_device_memory.back());
-    }
-
     typedef float Coefficient;
 
-    // Blas does
-    // C = A x B
-    // where A, B and C are assumed to be in column major.
-    // We want the output to be in row-major, so we can compute
-    // C' = B' x A', where ' stands for transpose (not adjoint).
-    // TODO(yangzihao): Choose the best of the three strategies using autotune.
-    if (batch_size == 1) {
-      // This is a regular matrix*matrix or matrix*vector multiply. Avoid the
-      // overhead of the scratch allocator and the batch interface.
-      // TODO(benbarsdell): Use fp16 Gemv if it becomes supported by CUBLAS
+    // See the comment in the generic launcher above: the slices are
+    // regularly strided, so one strided-batched GEMM replaces the per-step
+    // pointer-array setup and upload.
+    if (batch_size > 1) {
+      auto a_device = AsDeviceMemory(in_x.template flat<Scalar>().data());
+      auto b_device = AsDeviceMemory(in_y.template flat<Scalar>().data());
+      auto c_device = AsDeviceMemory(out->template flat<Scalar>().data());
       bool blas_launch_status =
           stream
-              ->ThenBlasGemm(blas_transpose_b, blas_transpose_a, n, m, k,
-                             static_cast<Coefficient>(1.0), *(b_ptrs[0]),
-                             adj_y ? k : n, *(a_ptrs[0]), adj_x ? m : k,
-                             static_cast<Coefficient>(0.0), c_ptrs[0], n)
+              ->ThenBlasGemmStridedBatched(
+                  blas_transpose_b, blas_transpose_a, n, m, k,
+                  static_cast<Coefficient>(1.0), b_device, adj_y ? k : n,
+                  static_cast<int64>(k * n), a_device, adj_x ? m : k,
+                  static_cast<int64>(m * k), static_cast<Coefficient>(0.0),
+                  &c_device, n, static_cast<int64>(m * n), batch_size)
               .ok();
       if (!blas_launch_status) {
         context->SetStatus(errors::Internal(
-            "Blas xGEMM launch failed : a.shape=", in_x.shape().DebugString(),
+            "Blas xGEMMStridedBatched launch failed : a.shape=",
+            in_x.shape().DebugString(),
             ", b.shape=", in_y.shape().DebugString(), ", m=", m, ", n=", n,
-            ", k=", k));
-      }
-    } else {
-      BlasScratchAllocator scratch_allocator(context);
-      bool blas_launch_status =
-          stream
-              ->ThenBlasGemmBatchedWithScratch(
-                  blas_transpose_b, blas_transpose_a, n, m, k,
-                  static_cast<Coefficient>(1.0), b_ptrs, adj_y ? k : n, a_ptrs,
-                  adj_x ? m : k, static_cast<Coefficient>(0.0), c_ptrs, n,
-                  batch_size, &scratch_allocator)
-              .ok();
-      if (!blas_launch_status) {
-        context->SetStatus(
-            errors::Internal("Blas xGEMMBatched launch failed : a.shape=",
-                             in_x.shape().DebugString(), ", b.shape=",
-                             in_y.shape().DebugString(), ", m=", m, ", n=", n,
-                             ", k=", k, ", batch_size=", batch_size));
+            ", k=", k, ", batch_size=", batch_size));
       }
+      return;
+    }
+
+    // This is a regular matrix*matrix or matrix*vector multiply. Avoid the
+    // overhead of the scratch allocator and the batch interface.
+    // Blas does
+    // C = A x B
+    // where A, B and C are assumed to be in column major.
+    // We want the output to be in row-major, so we can compute
+    // C' = B' x A', where ' stands for transpose (not adjoint).
+    // TODO(benbarsdell): Use fp16 Gemv if it becomes supported by CUBLAS
+    DeviceMemoryType a_device =
+        AsDeviceMemory(in_x.template flat<Scalar>().data());
+    DeviceMemoryType b_device =
+        AsDeviceMemory(in_y.template flat<Scalar>().data());
+    DeviceMemoryType c_device =
+        AsDeviceMemory(out->template flat<Scalar>().data());
+    bool blas_launch_status =
+        stream
+            ->ThenBlasGemm(blas_transpose_b, blas_transpose_a, n, m, k,
+                           static_cast<Coefficient>(1.0), b_device,
+                           adj_y ? k : n, a_device, adj_x ? m : k,
+                           static_cast<Coefficient>(0.0), &c_device, n)
+            .ok();
+    if (!blas_launch_status) {
+      context->SetStatus(errors::Internal(
+          "Blas xGEMM launch failed : a.shape=", in_x.shape().DebugString(),
+          ", b.shape=", in_y.shape().DebugString(), ", m=", m, ", n=", n,
+          ", k=", k));
     }
   }
 };
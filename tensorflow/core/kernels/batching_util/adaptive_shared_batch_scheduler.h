@@ -69,6 +69,12 @@ class ASBSQueue;
 // CPU utilization - If the batch processing is cpu dominated, you can reap
 //   latency gains when underutilized by increasing the processing rate, but
 //   back the rate off when the load increases to avoid overload.
+//
+// Queues co-hosted on one scheduler need not be equal: a queue can be given a
+// static scheduling boost so its batches win processing slots over bulk
+// queues, and/or a target tail latency which the scheduler enforces by
+// growing the queue's boost while the target is being missed (trading batch
+// fullness for latency only on the queues that need it).  See QueueOptions.
 
 template <typename TaskType>
 class AdaptiveSharedBatchScheduler
@@ -129,6 +135,19 @@ class AdaptiveSharedBatchScheduler
     // A non-zero value can improve performance by limiting the scheduling of
     // nearly empty batches.
     int64 batch_timeout_micros = 0;
+    // Static scheduling priority, expressed in microseconds of batch age.
+    // When competing for a processing slot, this queue's batches are treated
+    // as if they were this much older than they actually are, so
+    // latency-critical queues are scheduled ahead of bulk queues.
+    int64 scheduling_boost_micros = 0;
+    // Target tail batch latency (from batch creation to completed
+    // processing) for this queue.  When non-zero, the scheduler measures the
+    // max batch latency over windows of kSloLatencyWindowSize batches (an
+    // approximate p99) and grows an additional scheduling boost while the
+    // target is being missed, decaying it once the target is comfortably
+    // met.  This trades batch fullness for latency only on this queue,
+    // leaving other queues' scheduling unaffected when the target is met.
+    int64 target_latency_micros = 0;
   };
 
   using BatchProcessor = std::function<void(std::unique_ptr<Batch<TaskType>>)>;
@@ -170,6 +189,17 @@ class AdaptiveSharedBatchScheduler
   // Removes queue from scheduler.
   void RemoveQueue(const internal::ASBSQueue<TaskType>* queue);
 
+  // Returns the scheduling boost for 'queue': its static boost plus any
+  // SLO-driven boost.
+  int64 QueueSchedulingBoostMicros(const internal::ASBSQueue<TaskType>* queue)
+      const EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
+  // Updates 'queue's latency-SLO state with an observed batch latency, and
+  // adjusts the queue's boost at the end of each measurement window.  No-op
+  // for queues without a latency target.
+  void RecordBatchLatency(const internal::ASBSQueue<TaskType>* queue,
+                          int64 latency_micros) EXCLUSIVE_LOCKS_REQUIRED(mu_);
+
   Env* GetEnv() const { return options_.env; }
 
   const Options options_;
@@ -182,6 +212,27 @@ class AdaptiveSharedBatchScheduler
   std::unordered_map<const internal::ASBSQueue<TaskType>*, BatchProcessor>
       queues_and_callbacks_ GUARDED_BY(mu_);
 
+  // Latency-SLO tracking state for queues with a non-zero
+  // target_latency_micros.  Entries are removed with their queue in
+  // RemoveQueue().
+  struct QueueSloState {
+    int64 target_latency_micros = 0;
+    // Additional scheduling boost currently applied to the queue.
+    int64 slo_boost_micros = 0;
+    // Max batch latency observed in the current measurement window;
+    // approximates the queue's tail latency.
+    int64 window_max_latency_micros = 0;
+    // Number of batches observed in the current measurement window.
+    int64 window_count = 0;
+  };
+  std::unordered_map<const internal::ASBSQueue<TaskType>*, QueueSloState>
+      queue_slo_states_ GUARDED_BY(mu_);
+  // Number of batches per tail latency measurement window; the window max
+  // approximates a p99 batch latency.
+  constexpr static int64 kSloLatencyWindowSize = 100;
+  // Cap on slo_boost_micros, as a multiple of the queue's latency target.
+  constexpr static int64 kMaxSloBoostMultiplier = 10;
+
   mutex mu_;
 
   // Responsible for running the batch processing callbacks.
@@ -256,6 +307,11 @@ class ASBSQueue : public BatchScheduler<TaskType> {
 
   size_t max_task_size() const override { return options_.max_batch_size; }
 
+  // Static scheduling boost configured for this queue.
+  int64 scheduling_boost_micros() const {
+    return options_.scheduling_boost_micros;
+  }
+
  private:
   std::shared_ptr<AdaptiveSharedBatchScheduler<TaskType>> scheduler_;
   const QueueOptions options_;
@@ -301,6 +357,12 @@ constexpr double AdaptiveSharedBatchScheduler<TaskType>::kMaxStepSizeMultiplier;
 template <typename TaskType>
 constexpr double AdaptiveSharedBatchScheduler<TaskType>::kMinStepSizeMultiplier;
 
+template <typename TaskType>
+constexpr int64 AdaptiveSharedBatchScheduler<TaskType>::kSloLatencyWindowSize;
+
+template <typename TaskType>
+constexpr int64 AdaptiveSharedBatchScheduler<TaskType>::kMaxSloBoostMultiplier;
+
 template <typename TaskType>
 Status AdaptiveSharedBatchScheduler<TaskType>::Create(
     const Options& options,
@@ -373,11 +435,25 @@ Status AdaptiveSharedBatchScheduler<TaskType>::AddQueue(
         "max_enqueued_batches must be positive; was ",
         options.max_enqueued_batches);
   }
+  if (options.scheduling_boost_micros < 0) {
+    return errors::InvalidArgument(
+        "scheduling_boost_micros can't be negative; was ",
+        options.scheduling_boost_micros);
+  }
+  if (options.target_latency_micros < 0) {
+    return errors::InvalidArgument(
+        "target_latency_micros can't be negative; was ",
+        options.target_latency_micros);
+  }
   internal::ASBSQueue<TaskType>* asbs_queue_raw;
   queue->reset(asbs_queue_raw = new internal::ASBSQueue<TaskType>(
                    this->shared_from_this(), options));
   mutex_lock l(mu_);
   queues_and_callbacks_[asbs_queue_raw] = process_batch_callback;
+  if (options.target_latency_micros > 0) {
+    queue_slo_states_[asbs_queue_raw].target_latency_micros =
+        options.target_latency_micros;
+  }
   return Status::OK();
 }
 
@@ -403,6 +479,44 @@ void AdaptiveSharedBatchScheduler<TaskType>::RemoveQueue(
     const internal::ASBSQueue<TaskType>* queue) {
   mutex_lock l(mu_);
   queues_and_callbacks_.erase(queue);
+  queue_slo_states_.erase(queue);
+}
+
+template <typename TaskType>
+int64 AdaptiveSharedBatchScheduler<TaskType>::QueueSchedulingBoostMicros(
+    const internal::ASBSQueue<TaskType>* queue) const {
+  int64 boost = queue->scheduling_boost_micros();
+  auto it = queue_slo_states_.find(queue);
+  if (it != queue_slo_states_.end()) {
+    boost += it->second.slo_boost_micros;
+  }
+  return boost;
+}
+
+template <typename TaskType>
+void AdaptiveSharedBatchScheduler<TaskType>::RecordBatchLatency(
+    const internal::ASBSQueue<TaskType>* queue, int64 latency_micros) {
+  auto it = queue_slo_states_.find(queue);
+  if (it == queue_slo_states_.end()) return;
+  QueueSloState& state = it->second;
+  state.window_max_latency_micros =
+      std::max(state.window_max_latency_micros, latency_micros);
+  if (++state.window_count < kSloLatencyWindowSize) return;
+  const int64 tail_latency_micros = state.window_max_latency_micros;
+  if (tail_latency_micros > state.target_latency_micros) {
+    // Missing the target; grow the boost proportionally to the overshoot so
+    // this queue's batches win processing slots sooner.
+    state.slo_boost_micros = std::min(
+        state.slo_boost_micros +
+            (tail_latency_micros - state.target_latency_micros),
+        kMaxSloBoostMultiplier * state.target_latency_micros);
+  } else if (tail_latency_micros < 4 * state.target_latency_micros / 5) {
+    // Comfortably under target; decay the boost to restore batch fullness
+    // for the other queues.
+    state.slo_boost_micros /= 2;
+  }
+  state.window_count = 0;
+  state.window_max_latency_micros = 0;
 }
 
 template <typename TaskType>
@@ -422,6 +536,7 @@ void AdaptiveSharedBatchScheduler<TaskType>::MaybeScheduleNextBatch() {
     if ((*it)->schedulable_time_micros() > now_micros) continue;
     const double score =
         (*it)->creation_time_micros() -
+        QueueSchedulingBoostMicros((*it)->queue()) -
         options_.full_batch_scheduling_boost_micros * (*it)->size() /
             static_cast<double>((*it)->queue()->max_task_size());
     if (best_it == batches_.end() || score < best_score) {
@@ -467,10 +582,15 @@ void AdaptiveSharedBatchScheduler<TaskType>::CallbackWrapper(
     AdaptiveSharedBatchScheduler<TaskType>::BatchProcessor callback,
     bool is_express) {
   int64 start_time = batch->creation_time_micros();
+  // The queue pointer is recorded before the callback consumes the batch; it
+  // is only used as a lookup key afterwards since the queue may have been
+  // destroyed during processing.
+  const internal::ASBSQueue<TaskType>* queue = batch->queue();
   callback(std::unique_ptr<Batch<TaskType>>(
       const_cast<internal::ASBSBatch<TaskType>*>(batch)));
   int64 end_time = GetEnv()->NowMicros();
   mutex_lock l(mu_);
+  RecordBatchLatency(queue, end_time - start_time);
   if (is_express) {
     in_flight_express_batches_--;
     MaybeScheduleClosedBatch();
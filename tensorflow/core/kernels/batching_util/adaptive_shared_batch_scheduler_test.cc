@@ -263,6 +263,70 @@ TEST(AdaptiveSharedBatchSchedulerTest, FullBatchSchedulingBoostMicros) {
   stop_teardown.Notify();
 }
 
+TEST(AdaptiveSharedBatchSchedulerTest, SchedulingBoostMicros) {
+  test_util::FakeClockEnv env(Env::Default());
+  Notification start_teardown, stop_teardown;
+  std::unique_ptr<Thread> teardown_thread =
+      CreateFakeClockAdvancerThread(&env, &start_teardown, &stop_teardown);
+  {
+    AdaptiveSharedBatchScheduler<FakeTask>::Options options;
+    options.env = &env;
+    options.initial_in_flight_batches_limit = 1;
+    options.batches_to_average_over = 1000;
+    mutex mu;
+    int processed_batches = 0;
+    Notification finish_processing;
+    auto queue_callback = [&mu, &processed_batches, &finish_processing](
+                              std::unique_ptr<Batch<FakeTask>> batch) {
+      ASSERT_TRUE(batch->IsClosed());
+      finish_processing.WaitForNotification();
+      mutex_lock l(mu);
+      processed_batches++;
+      switch (processed_batches) {
+        case 1:
+          EXPECT_EQ(100, batch->size());
+          break;
+        case 2:
+          // Although the bulk queue's batch is older, the boosted queue's
+          // batch must be processed first.
+          EXPECT_EQ(50, batch->size());
+          break;
+        case 3:
+          EXPECT_EQ(100, batch->size());
+          break;
+        default:
+          EXPECT_TRUE(false) << "Should only have 3 batches";
+      }
+    };
+    std::shared_ptr<AdaptiveSharedBatchScheduler<FakeTask>> scheduler;
+    TF_ASSERT_OK(
+        AdaptiveSharedBatchScheduler<FakeTask>::Create(options, &scheduler));
+    AdaptiveSharedBatchScheduler<FakeTask>::QueueOptions queue_options;
+    std::unique_ptr<BatchScheduler<FakeTask>> bulk_queue;
+    std::unique_ptr<BatchScheduler<FakeTask>> boosted_queue;
+    queue_options.max_batch_size = 100;
+    TF_ASSERT_OK(
+        scheduler->AddQueue(queue_options, queue_callback, &bulk_queue));
+    queue_options.max_batch_size = 50;
+    queue_options.scheduling_boost_micros = 100;
+    TF_ASSERT_OK(
+        scheduler->AddQueue(queue_options, queue_callback, &boosted_queue));
+
+    // First batch immediately processed.
+    TF_ASSERT_OK(ScheduleTask(100, bulk_queue.get()));
+
+    // Second batch - creation time: 0, sched score: 0.
+    TF_ASSERT_OK(ScheduleTask(100, bulk_queue.get()));
+    env.AdvanceByMicroseconds(10);
+    // Third batch - creation time: 10, sched score: 10 - 100 = -90.
+    TF_ASSERT_OK(ScheduleTask(50, boosted_queue.get()));
+
+    finish_processing.Notify();
+    start_teardown.Notify();
+  }
+  stop_teardown.Notify();
+}
+
 TEST(AdaptiveSharedBatchSchedulerTest, DeleteQueue) {
   AdaptiveSharedBatchScheduler<FakeTask>::Options options;
   options.initial_in_flight_batches_limit = 1;
@@ -46,6 +46,46 @@ void ConcatCPUImpl(
   }
 
   auto worker_threads = d->tensorflow_cpu_worker_threads();
+
+  // Many-input specialization (e.g. feature-column concats with hundreds of
+  // inputs): build a flat destination-ordered copy plan once and shard over
+  // whole rows.  The generic path below pays for partial-row bookkeeping and
+  // a bounds min() per segment per row, which dominates when segments are
+  // small and numerous; rows are plenty fine-grained for sharding when there
+  // are this many inputs.
+  constexpr size_t kManyInputs = 64;
+  if (num_inputs >= kManyInputs && row_size > 0) {
+    struct CopySegment {
+      const T* src;       // Source of the segment's first row.
+      ptrdiff_t len;      // Elements per row.
+      ptrdiff_t dst_off;  // Offset of the segment within an output row.
+      int input_index;
+    };
+    std::vector<CopySegment> plan;
+    plan.reserve(num_inputs);
+    ptrdiff_t off = 0;
+    for (size_t j = 0; j < num_inputs; ++j) {
+      if (sizes[j] > 0) {
+        plan.push_back({&(*inputs[j])(0, 0), sizes[j], off,
+                        static_cast<int>(j)});
+      }
+      off += sizes[j];
+    }
+    auto work = [&plan, &output, &copier, row_size](int64 row_start,
+                                                    int64 row_end) {
+      T* out = output->data() + row_start * row_size;
+      for (int64 i = row_start; i < row_end; ++i, out += row_size) {
+        for (const CopySegment& segment : plan) {
+          copier.Copy(out + segment.dst_off, segment.src + i * segment.len,
+                      segment.input_index, segment.len);
+        }
+      }
+    };
+    Shard(worker_threads->num_threads, worker_threads->workers,
+          output->dimension(0), cost_per_unit * row_size, work);
+    return;
+  }
+
   int num_threads = std::min(4, worker_threads->num_threads);
   // strings define a different amount of work (generally much more) compared
   // with standard POD, so we parallelize differently.
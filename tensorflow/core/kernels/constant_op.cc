@@ -34,7 +34,11 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/variant_op_registry.h"
 #include "tensorflow/core/kernels/fill_functor.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/macros.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 #ifdef TENSORFLOW_USE_SYCL
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
@@ -65,6 +69,97 @@ std::unique_ptr<const NodeDef> StripTensorDataFromNodeDef(
   return std::unique_ptr<const NodeDef>(ret);
 }
 
+// Returns true iff TF_SHARE_CONSTANT_TENSORS is set.  Read per kernel
+// construction (not cached) so tests can toggle it; Const kernels are
+// constructed once per graph, so the getenv cost is irrelevant.
+bool ShareConstantTensors() {
+  bool enabled = false;
+  Status status =
+      ReadBoolFromEnvVar("TF_SHARE_CONSTANT_TENSORS", false, &enabled);
+  if (!status.ok()) {
+    LOG(ERROR) << status.error_message();
+  }
+  return enabled;
+}
+
+// Process-wide content-addressed store of host constant tensor buffers.
+// Sessions loading replicas of the same frozen model materialize identical
+// weight tensors once per session; deduplicating them here leaves one
+// physical copy per distinct content, refcounted by the Const kernels that
+// reference it.  Sharing across processes is out of scope -- use
+// ImmutableConstOp for file-backed (mmap) weights.
+class ConstTensorRegistry {
+ public:
+  static ConstTensorRegistry* Get() {
+    static ConstTensorRegistry* registry = new ConstTensorRegistry;
+    return registry;
+  }
+
+  // If a tensor with identical dtype, shape and contents is registered,
+  // points *tensor at the shared copy (releasing the caller's buffer);
+  // otherwise registers *tensor as the shared copy.  Returns the key the
+  // caller must pass to Unref() on destruction, or 0 if the tensor is not
+  // shareable (non-memcpy dtype or too small to be worth a lock).
+  uint64 Ref(Tensor* tensor) {
+    if (!DataTypeCanUseMemcpy(tensor->dtype())) return 0;
+    const StringPiece data = tensor->tensor_data();
+    if (data.size() < kMinBytesToShare) return 0;
+    uint64 fp = Hash64Combine(static_cast<uint64>(tensor->dtype()),
+                              Hash64(data.data(), data.size()));
+    for (int d = 0; d < tensor->dims(); ++d) {
+      fp = Hash64Combine(fp, tensor->dim_size(d));
+    }
+    if (fp == 0) fp = 1;  // 0 means "not shared".
+    mutex_lock l(mu_);
+    std::vector<Entry>& entries = tensors_[fp];
+    for (Entry& e : entries) {
+      if (e.tensor.dtype() == tensor->dtype() &&
+          e.tensor.shape() == tensor->shape() &&
+          e.tensor.tensor_data() == data) {
+        ++e.refs;
+        VLOG(1) << "Sharing constant tensor buffer (" << data.size()
+                << " bytes, " << e.refs << " refs)";
+        *tensor = e.tensor;
+        return fp;
+      }
+    }
+    entries.push_back(Entry{*tensor, 1});
+    return fp;
+  }
+
+  // Drops one reference to the shared copy backing 'tensor' and forgets
+  // the content once the last Const kernel referencing it is destroyed.
+  void Unref(uint64 fp, const Tensor& tensor) {
+    mutex_lock l(mu_);
+    auto it = tensors_.find(fp);
+    if (it == tensors_.end()) return;
+    std::vector<Entry>& entries = it->second;
+    for (size_t i = 0; i < entries.size(); ++i) {
+      if (entries[i].tensor.tensor_data().data() ==
+          tensor.tensor_data().data()) {
+        if (--entries[i].refs == 0) {
+          entries.erase(entries.begin() + i);
+          if (entries.empty()) tensors_.erase(it);
+        }
+        return;
+      }
+    }
+  }
+
+ private:
+  struct Entry {
+    Tensor tensor;
+    int64 refs;
+  };
+
+  // Tiny constants are not worth the lock or the hash.
+  static constexpr int64 kMinBytesToShare = 1024;
+
+  mutex mu_;
+  // Keyed by content fingerprint; the vector disambiguates collisions.
+  gtl::FlatMap<uint64, std::vector<Entry>> tensors_ GUARDED_BY(mu_);
+};
+
 }  // namespace
 
 ConstantOp::ConstantOp(OpKernelConstruction* ctx)
@@ -79,6 +174,9 @@ ConstantOp::ConstantOp(OpKernelConstruction* ctx)
       errors::InvalidArgument("Type mismatch between value (",
                               DataTypeString(tensor_.dtype()), ") and dtype (",
                               DataTypeString(ctx->output_type(0)), ")"));
+  if (ctx->device_type() == DeviceType(DEVICE_CPU) && ShareConstantTensors()) {
+    shared_fingerprint_ = ConstTensorRegistry::Get()->Ref(&tensor_);
+  }
 }
 
 void ConstantOp::Compute(OpKernelContext* ctx) {
@@ -88,7 +186,11 @@ void ConstantOp::Compute(OpKernelContext* ctx) {
   }
 }
 
-ConstantOp::~ConstantOp() {}
+ConstantOp::~ConstantOp() {
+  if (shared_fingerprint_ != 0) {
+    ConstTensorRegistry::Get()->Unref(shared_fingerprint_, tensor_);
+  }
+}
 
 REGISTER_KERNEL_BUILDER(Name("Const").Device(DEVICE_CPU), ConstantOp);
 
@@ -33,6 +33,9 @@ class ConstantOp : public OpKernel {
 
  private:
   Tensor tensor_;
+  // Non-zero iff tensor_ shares a buffer registered in the process-wide
+  // constant tensor store (see TF_SHARE_CONSTANT_TENSORS).
+  uint64 shared_fingerprint_ = 0;
   TF_DISALLOW_COPY_AND_ASSIGN(ConstantOp);
 };
 
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <stdlib.h>
+
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/node_def_builder.h"
 #include "tensorflow/core/framework/op.h"
@@ -91,6 +93,57 @@ TEST_F(ConstantOpTest, PersistentMemoryTracking) {
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 }
 
+TEST_F(ConstantOpTest, SharedConstantBuffers) {
+  setenv("TF_SHARE_CONSTANT_TENSORS", "true", 1 /* overwrite */);
+
+  Tensor tensor(DT_FLOAT, TensorShape({1024}));
+  for (int i = 0; i < 1024; ++i) {
+    tensor.flat<float>()(i) = i;
+  }
+  Tensor other(DT_FLOAT, TensorShape({1024}));
+  for (int i = 0; i < 1024; ++i) {
+    other.flat<float>()(i) = -i;
+  }
+
+  std::unique_ptr<Device> device(DeviceFactory::NewDevice(
+      "CPU", {}, "/job:worker/replica:0/task:0"));
+
+  auto make_const = [&](const string& name, const Tensor& value) {
+    NodeDef const_node;
+    TF_CHECK_OK(NodeDefBuilder(name, "Const")
+                    .Attr("dtype", DT_FLOAT)
+                    .Attr("value", value)
+                    .Finalize(&const_node));
+    Status status;
+    std::unique_ptr<OpKernel> op(CreateOpKernel(DEVICE_CPU, device.get(),
+                                                cpu_allocator(), const_node,
+                                                TF_GRAPH_DEF_VERSION, &status));
+    TF_CHECK_OK(status);
+    return op;
+  };
+
+  auto op0 = make_const("shared_a", tensor);
+  auto op1 = make_const("shared_b", tensor);
+  auto op2 = make_const("unshared", other);
+
+  auto run = [&](OpKernel* op) {
+    OpKernelContext::Params params;
+    params.device = device.get();
+    params.frame_iter = FrameAndIter(0, 0);
+    params.op_kernel = op;
+    OpKernelContext ctx(&params);
+    op->Compute(&ctx);
+    TF_CHECK_OK(ctx.status());
+    return ctx.mutable_output(0)->tensor_data().data();
+  };
+
+  // Identical contents share one physical buffer; different contents don't.
+  EXPECT_EQ(run(op0.get()), run(op1.get()));
+  EXPECT_NE(run(op0.get()), run(op2.get()));
+
+  unsetenv("TF_SHARE_CONSTANT_TENSORS");
+}
+
 // Returns graph containing "num" const nodes.  If 'sequential' is
 // true, make sure all constants are executed sequentially in the
 // graph by adding control dependencies.
@@ -49,6 +49,8 @@ limitations under the License.
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/kernels/conv_ops_gpu.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -814,6 +816,11 @@ void LaunchConv2DBackpropFilterOp<Eigen::GpuDevice, T>::operator()(
       "TF_CUDNN_WORKSPACE_LIMIT_IN_MB", 1LL << 32  // 4GB by default
   );
   int device_id = stream->parent()->device_ordinal();
+  // Null unless the dedicated workspace arena is enabled; see
+  // GPUProcessState::GetGPUWorkspaceAllocator.
+  Allocator* workspace_allocator =
+      GPUProcessState::singleton()->GetGPUWorkspaceAllocator(
+          PlatformGpuId(device_id));
   DataType dtype = input.dtype();
   ConvParameters conv_parameters = {
       dims.batch_size,                     // batch
@@ -848,7 +855,7 @@ void LaunchConv2DBackpropFilterOp<Eigen::GpuDevice, T>::operator()(
       // TODO(zhengxq): profile each algorithm multiple times to better
       // accuracy.
       DnnScratchAllocator scratch_allocator(ConvolveBackwardFilterScratchSize,
-                                            ctx);
+                                            ctx, workspace_allocator);
       ProfileResult profile_result;
       bool cudnn_launch_status =
           stream
@@ -884,8 +891,8 @@ void LaunchConv2DBackpropFilterOp<Eigen::GpuDevice, T>::operator()(
     }
 #elif TENSORFLOW_USE_ROCM
     LOG(INFO) << "running auto-tune for Backward-Filter";
-    DnnScratchAllocator scratch_allocator(
-        ConvolveBackwardFilterScratchSize, ctx);
+    DnnScratchAllocator scratch_allocator(ConvolveBackwardFilterScratchSize,
+                                          ctx, workspace_allocator);
     bool miopen_find_status =
         stream
             ->ThenConvolveBackwardFilterWithAlgorithm(
@@ -901,7 +908,8 @@ void LaunchConv2DBackpropFilterOp<Eigen::GpuDevice, T>::operator()(
     AutoTuneConvBwdFilter::GetInstance()->Insert(conv_parameters,
                                                  algorithm_config);
   }
-  DnnScratchAllocator scratch_allocator(ConvolveBackwardFilterScratchSize, ctx);
+  DnnScratchAllocator scratch_allocator(ConvolveBackwardFilterScratchSize, ctx,
+                                        workspace_allocator);
   bool cudnn_launch_status =
       stream
           ->ThenConvolveBackwardFilterWithAlgorithm(
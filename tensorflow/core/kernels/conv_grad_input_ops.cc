@@ -49,6 +49,8 @@ limitations under the License.
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/kernels/conv_ops_gpu.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -924,8 +926,14 @@ void LaunchConv2DBackpropInputOp<GPUDevice, T>::operator()(
   static int64 ConvolveBackwardDataScratchSize = GetDnnWorkspaceLimit(
       "TF_CUDNN_WORKSPACE_LIMIT_IN_MB", 1LL << 32  // 4GB by default
   );
-  DnnScratchAllocator scratch_allocator(ConvolveBackwardDataScratchSize, ctx);
   int device_id = stream->parent()->device_ordinal();
+  // Null unless the dedicated workspace arena is enabled; see
+  // GPUProcessState::GetGPUWorkspaceAllocator.
+  Allocator* workspace_allocator =
+      GPUProcessState::singleton()->GetGPUWorkspaceAllocator(
+          PlatformGpuId(device_id));
+  DnnScratchAllocator scratch_allocator(ConvolveBackwardDataScratchSize, ctx,
+                                        workspace_allocator);
   DataType dtype = out_backprop.dtype();
   ConvParameters conv_parameters = {
       dims.batch_size,                     // batch
@@ -960,7 +968,7 @@ void LaunchConv2DBackpropInputOp<GPUDevice, T>::operator()(
       // TODO(zhengxq): profile each algorithm multiple times to better
       // accuracy.
       DnnScratchAllocator scratch_allocator(ConvolveBackwardDataScratchSize,
-                                            ctx);
+                                            ctx, workspace_allocator);
       ProfileResult profile_result;
       bool cudnn_launch_status =
           stream
@@ -997,8 +1005,8 @@ void LaunchConv2DBackpropInputOp<GPUDevice, T>::operator()(
     LOG(INFO) << "running auto-tune for Backward-Data";
     // MIOpen has its own Find and autotuner so use it here, passing
     // default AlgorithmConfig to force a search
-    DnnScratchAllocator scratch_allocator(ConvolveBackwardDataScratchSize,
-                                              ctx);
+    DnnScratchAllocator scratch_allocator(ConvolveBackwardDataScratchSize, ctx,
+                                          workspace_allocator);
     bool miopen_find_status =
         stream
             ->ThenConvolveBackwardDataWithAlgorithm(
@@ -53,6 +53,8 @@ limitations under the License.
 #endif
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+#include "tensorflow/core/common_runtime/gpu/gpu_id.h"
+#include "tensorflow/core/common_runtime/gpu/gpu_process_state.h"
 #include "tensorflow/core/kernels/conv_ops_gpu.h"
 #include "tensorflow/core/platform/stream_executor.h"
 #endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
@@ -457,12 +459,16 @@ class Conv2DOp : public BinaryOp<T> {
     const Tensor& filter = context->input(1);
 
     Conv2DDimensions dimensions;
-    OP_REQUIRES_OK(context,
-                   ComputeConv2DDimension(params_, input, filter, &dimensions));
-
-    TensorShape out_shape = ShapeFromFormat(
-        params_.data_format, dimensions.batch, dimensions.out_rows,
-        dimensions.out_cols, dimensions.out_depth);
+    TensorShape out_shape;
+    if (!GetCachedConvPlan(input.shape(), filter.shape(), &dimensions,
+                           &out_shape)) {
+      OP_REQUIRES_OK(
+          context, ComputeConv2DDimension(params_, input, filter, &dimensions));
+      out_shape = ShapeFromFormat(params_.data_format, dimensions.batch,
+                                  dimensions.out_rows, dimensions.out_cols,
+                                  dimensions.out_depth);
+      CacheConvPlan(input.shape(), filter.shape(), dimensions, out_shape);
+    }
 
     // Output tensor is of the following dimensions:
     // [ in_batch, out_rows, out_cols, out_depth ]
@@ -519,10 +525,56 @@ class Conv2DOp : public BinaryOp<T> {
   }
 
  private:
+  // Serving workloads run the same kernel with identical shapes every step,
+  // and ComputeConv2DDimension revalidates and re-derives the full dimension
+  // set on each call. Cache the derived plan per (input shape, filter shape)
+  // -- strides, dilations and padding are fixed attributes -- so steady-state
+  // calls go straight to the launch.
+  struct ConvPlan {
+    TensorShape input_shape;
+    TensorShape filter_shape;
+    Conv2DDimensions dimensions;
+    TensorShape out_shape;
+  };
+
+  bool GetCachedConvPlan(const TensorShape& input_shape,
+                         const TensorShape& filter_shape,
+                         Conv2DDimensions* dimensions, TensorShape* out_shape) {
+    mutex_lock l(plan_mu_);
+    for (size_t i = 0; i < plans_.size(); ++i) {
+      if (plans_[i].input_shape == input_shape &&
+          plans_[i].filter_shape == filter_shape) {
+        *dimensions = plans_[i].dimensions;
+        *out_shape = plans_[i].out_shape;
+        // Keep the hot plan in front.
+        if (i != 0) std::swap(plans_[0], plans_[i]);
+        return true;
+      }
+    }
+    return false;
+  }
+
+  void CacheConvPlan(const TensorShape& input_shape,
+                     const TensorShape& filter_shape,
+                     const Conv2DDimensions& dimensions,
+                     const TensorShape& out_shape) {
+    mutex_lock l(plan_mu_);
+    if (plans_.size() >= kMaxCachedConvPlans) {
+      plans_.pop_back();
+    }
+    plans_.insert(plans_.begin(),
+                  ConvPlan{input_shape, filter_shape, dimensions, out_shape});
+  }
+
+  static constexpr size_t kMaxCachedConvPlans = 8;
+
   Conv2DParameters params_;
   bool use_cudnn_;
   bool cudnn_use_autotune_;
 
+  mutex plan_mu_;
+  std::vector<ConvPlan> plans_ GUARDED_BY(plan_mu_);
+
   LaunchConv2DOp<Device, T> launcher_;
 
   TF_DISALLOW_COPY_AND_ASSIGN(Conv2DOp);
@@ -822,6 +874,11 @@ void LaunchConv2DOp<GPUDevice, T>::operator()(
   );
 
   int device_id = stream->parent()->device_ordinal();
+  // Null unless the dedicated workspace arena is enabled; see
+  // GPUProcessState::GetGPUWorkspaceAllocator.
+  Allocator* workspace_allocator =
+      GPUProcessState::singleton()->GetGPUWorkspaceAllocator(
+          PlatformGpuId(device_id));
   DataType dtype = input.dtype();
   ConvParameters conv_parameters = {
       in_batch,                 // batch
@@ -861,7 +918,8 @@ void LaunchConv2DOp<GPUDevice, T>::operator()(
     for (auto profile_algorithm : algorithms) {
       // TODO(zhengxq): profile each algorithm multiple times to better
       // accuracy.
-      DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx);
+      DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx,
+                                            workspace_allocator);
       ProfileResult profile_result;
       bool cudnn_launch_status =
           stream
@@ -899,7 +957,8 @@ void LaunchConv2DOp<GPUDevice, T>::operator()(
 #elif TENSORFLOW_USE_ROCM
     // MIOpen has its own Find and autotuner so use it here, passing
     // default AlgorithmConfig to force a search
-    DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx);
+    DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx,
+                                          workspace_allocator);
     bool miopen_find_status =
         stream
             ->ThenConvolveWithAlgorithm(input_desc, input_ptr, filter_desc,
@@ -917,7 +976,8 @@ void LaunchConv2DOp<GPUDevice, T>::operator()(
     AutoTuneConv::GetInstance()->Insert(conv_parameters, algorithm_config);
   }
 
-  DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx);
+  DnnScratchAllocator scratch_allocator(ConvolveScratchSize, ctx,
+                                        workspace_allocator);
   bool cudnn_launch_status =
       stream
           ->ThenConvolveWithAlgorithm(input_desc, input_ptr, filter_desc,
@@ -26,7 +26,7 @@ namespace tensorflow {
 TF_CALL_float(REGISTER_FUSED_CPU_CONV2D);
 #endif  // !USE_GEMM_FOR_CONV
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 namespace functor {
 DECLARE_FUNCTOR_GPU_SPEC(float);
@@ -34,6 +34,6 @@ DECLARE_FUNCTOR_GPU_SPEC(float);
 
 TF_CALL_float(REGISTER_FUSED_GPU_CONV2D);
 
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 }  // namespace tensorflow
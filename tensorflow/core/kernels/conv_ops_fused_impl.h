@@ -55,11 +55,13 @@ limitations under the License.
 #include "tensorflow/core/util/tensor_format.h"
 #include "tensorflow/core/util/use_cudnn.h"
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #if GOOGLE_CUDA
 #include "cuda/include/cudnn.h"
+#endif  // GOOGLE_CUDA
 #include "tensorflow/core/kernels/conv_ops_gpu.h"
 #include "tensorflow/core/platform/stream_executor.h"
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 namespace tensorflow {
 
@@ -72,10 +74,14 @@ enum class FusedComputationType {
   // identity activation function, it in theory should allow to fuse convolution
   // with BiasAdd, but in practice it doesn't work, cuDNN ignores this parameter
   // and always does Relu activation.
-  kBiasAdd,                // CPU
-  kBiasAddWithRelu,        // CPU and GPU
-  kFusedBatchNorm,         // CPU only
-  kFusedBatchNormWithRelu  // CPU only
+  kBiasAdd,                  // CPU
+  kBiasAddWithRelu,          // CPU and GPU
+  kBiasAddWithRelu6,         // CPU only
+  kBiasAddWithElu,           // CPU only
+  kFusedBatchNorm,           // CPU only
+  kFusedBatchNormWithRelu,   // CPU only
+  kFusedBatchNormWithRelu6,  // CPU only
+  kFusedBatchNormWithElu     // CPU only
 };
 
 // We have to pass around additional arguments for all possible fusion types.
@@ -130,6 +136,32 @@ struct Relu {
   };
 };
 
+// Applies `Relu6` to the passed input expression.
+struct Relu6 {
+  template <typename XprType>
+  static auto apply(XprType expr)
+      -> decltype(expr.cwiseMax(std::declval<typename XprType::Scalar>())
+                      .cwiseMin(std::declval<typename XprType::Scalar>())) {
+    return expr.cwiseMax(static_cast<typename XprType::Scalar>(0))
+        .cwiseMin(static_cast<typename XprType::Scalar>(6));
+  };
+};
+
+// Applies `Elu` to the passed input expression.
+struct Elu {
+  template <typename XprType>
+  static auto apply(XprType expr) -> decltype(
+      (expr < std::declval<XprType>())
+          .select(expr.exp() -
+                      expr.constant(std::declval<typename XprType::Scalar>()),
+                  expr)) {
+    return (expr < static_cast<typename XprType::Scalar>(0))
+        .select(expr.exp() -
+                    expr.constant(static_cast<typename XprType::Scalar>(1)),
+                expr);
+  };
+};
+
 // TensorContraction swaps lhs with rhs, and changes layout from RowMajor
 // (default in Tensorflow) to ColMajor (preferred in Eigen), and computes matmul
 // using these tensors.
@@ -229,9 +261,17 @@ using WithBiasAdd = BiasAddOutputKernel<T>;
 template <typename T>
 using WithBiasAddAndRelu = BiasAddOutputKernel<T, Relu>;
 template <typename T>
+using WithBiasAddAndRelu6 = BiasAddOutputKernel<T, Relu6>;
+template <typename T>
+using WithBiasAddAndElu = BiasAddOutputKernel<T, Elu>;
+template <typename T>
 using WithFusedBatchNorm = FusedBatchNormOutputKernel<T>;
 template <typename T>
 using WithFusedBatchNormAndRelu = FusedBatchNormOutputKernel<T, Relu>;
+template <typename T>
+using WithFusedBatchNormAndRelu6 = FusedBatchNormOutputKernel<T, Relu6>;
+template <typename T>
+using WithFusedBatchNormAndElu = FusedBatchNormOutputKernel<T, Elu>;
 
 // This is CPU-only implementation that uses Eigen contraction output kernels.
 //
@@ -339,6 +379,18 @@ struct LaunchFusedConv2DOp<CPUDevice, T> {
                filter, output);
         break;
 
+      case FusedComputationType::kBiasAddWithRelu6:
+        OP_REQUIRES_OK(context, InitBiasAddArgs(context, &bias_add));
+        conv2d(WithBiasAddAndRelu6<T>(bias_add.bias_add_data), context, input,
+               filter, output);
+        break;
+
+      case FusedComputationType::kBiasAddWithElu:
+        OP_REQUIRES_OK(context, InitBiasAddArgs(context, &bias_add));
+        conv2d(WithBiasAddAndElu<T>(bias_add.bias_add_data), context, input,
+               filter, output);
+        break;
+
       case FusedComputationType::kFusedBatchNorm:
         OP_REQUIRES_OK(context,
                        InitFusedBatchNormArgs(context, fusion_args.epsilon,
@@ -360,6 +412,28 @@ struct LaunchFusedConv2DOp<CPUDevice, T> {
                    fused_batch_norm.estimated_mean_data),
                context, input, filter, output);
         break;
+
+      case FusedComputationType::kFusedBatchNormWithRelu6:
+        OP_REQUIRES_OK(context,
+                       InitFusedBatchNormArgs(context, fusion_args.epsilon,
+                                              &fused_batch_norm));
+        conv2d(WithFusedBatchNormAndRelu6<T>(
+                   fusion_args.epsilon, fused_batch_norm.scaling_factor.data(),
+                   fused_batch_norm.offset_data,
+                   fused_batch_norm.estimated_mean_data),
+               context, input, filter, output);
+        break;
+
+      case FusedComputationType::kFusedBatchNormWithElu:
+        OP_REQUIRES_OK(context,
+                       InitFusedBatchNormArgs(context, fusion_args.epsilon,
+                                              &fused_batch_norm));
+        conv2d(WithFusedBatchNormAndElu<T>(
+                   fusion_args.epsilon, fused_batch_norm.scaling_factor.data(),
+                   fused_batch_norm.offset_data,
+                   fused_batch_norm.estimated_mean_data),
+               context, input, filter, output);
+        break;
     }
   }
 
@@ -436,6 +510,8 @@ struct LaunchFusedConv2DOp<CPUDevice, T> {
 #undef TF_REQUIRES
 };
 
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
 #if GOOGLE_CUDA
 
 // Encapsulate the default shape information that is used by the convolution
@@ -556,6 +632,49 @@ Status FindBestConvolveAlgorithm(const FusedConvParameters& params,
   return Status::OK();
 }
 
+#elif TENSORFLOW_USE_ROCM
+
+// MIOpen exposes conv+bias+activation as a compiled fusion plan rather
+// than a convolution algorithm; the compiled plan is cached per shape
+// inside the DNN backend (see CachedFusionPlans in rocm_dnn.cc), so
+// there is no algorithm to autotune here.  Fusion plans currently only
+// support float, which the non-template overload below resolves to; any
+// other element type falls through to the failing template.
+inline bool LaunchFusedConvBiasActivationOnROCm(
+    se::Stream* stream, const se::dnn::BatchDescriptor& input_desc,
+    const se::DeviceMemory<float>& input_ptr,
+    const se::dnn::FilterDescriptor& filter_desc,
+    const se::DeviceMemory<float>& filter_ptr,
+    const se::dnn::ConvolutionDescriptor& conv_desc,
+    const se::dnn::BatchDescriptor& bias_desc,
+    const se::DeviceMemory<float>& bias_ptr,
+    se::dnn::ActivationMode activation_mode,
+    const se::dnn::BatchDescriptor& output_desc,
+    se::DeviceMemory<float>* output_ptr) {
+  return stream
+      ->ThenFusedConvolutionBiasActivation(
+          input_desc, input_ptr, filter_desc, filter_ptr, conv_desc,
+          bias_desc, bias_ptr, activation_mode, output_desc, output_ptr)
+      .ok();
+}
+
+template <typename T>
+bool LaunchFusedConvBiasActivationOnROCm(
+    se::Stream* stream, const se::dnn::BatchDescriptor& input_desc,
+    const se::DeviceMemory<T>& input_ptr,
+    const se::dnn::FilterDescriptor& filter_desc,
+    const se::DeviceMemory<T>& filter_ptr,
+    const se::dnn::ConvolutionDescriptor& conv_desc,
+    const se::dnn::BatchDescriptor& bias_desc,
+    const se::DeviceMemory<T>& bias_ptr,
+    se::dnn::ActivationMode activation_mode,
+    const se::dnn::BatchDescriptor& output_desc,
+    se::DeviceMemory<T>* output_ptr) {
+  return false;
+}
+
+#endif  // GOOGLE_CUDA
+
 template <typename T>
 struct LaunchFusedConv2DOp<GPUDevice, T> {
   void operator()(OpKernelContext* context, bool use_cudnn,
@@ -582,6 +701,12 @@ struct LaunchFusedConv2DOp<GPUDevice, T> {
         errors::Unimplemented("FusedConv2D implementation only supports "
                               "fusing with `BiasAdd + Relu` for now."));
 
+#if TENSORFLOW_USE_ROCM
+    OP_REQUIRES(context, DataTypeToEnum<T>::value == DT_FLOAT,
+                errors::Unimplemented("MIOpen fused convolution is only "
+                                      "supported for float tensors."));
+#endif  // TENSORFLOW_USE_ROCM
+
     Tensor input = input_param;
 
     const int64 in_batch = GetTensorDim(input, params.data_format, 'N');
@@ -748,6 +873,7 @@ struct LaunchFusedConv2DOp<GPUDevice, T> {
     se::DeviceMemory<T> bias_ptr = tensor_on_device(bias);
     se::DeviceMemory<T> output_ptr = tensor_on_device(transformed_output);
 
+#if GOOGLE_CUDA
     // We do not use side inputs, so we can safely pass nullptr.
     se::DeviceMemory<T> side_input_ptr =
         AsDeviceMemory(static_cast<T*>(nullptr), 0);
@@ -811,6 +937,20 @@ struct LaunchFusedConv2DOp<GPUDevice, T> {
         errors::Internal(absl::Substitute(
             "cuDNN launch failure: input shape($0) filter shape($1)",
             input.shape().DebugString(), filter.shape().DebugString())));
+#elif TENSORFLOW_USE_ROCM
+    // A single MIOpen fusion plan replaces the conv+bias+activation
+    // sequence; the backend compiles and caches the plan per shape so
+    // repeated launches only pay for the kernel.
+    bool miopen_launch_status = LaunchFusedConvBiasActivationOnROCm(
+        stream, input_desc, input_ptr, filter_desc, filter_ptr, conv_desc,
+        bias_desc, bias_ptr, dnn_activation_mode, output_desc, &output_ptr);
+    OP_REQUIRES(
+        context, miopen_launch_status,
+        errors::Internal(absl::Substitute(
+            "MIOpen fused conv launch failure: input shape($0) filter "
+            "shape($1)",
+            input.shape().DebugString(), filter.shape().DebugString())));
+#endif  // GOOGLE_CUDA
 
     // Convert the output tensor back from NCHW to NHWC.
     if (params.data_format == FORMAT_NHWC) {
@@ -822,7 +962,7 @@ struct LaunchFusedConv2DOp<GPUDevice, T> {
   }
 };
 
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 template <typename Device, typename T>
 class FusedConv2DOp : public OpKernel {
@@ -856,6 +996,13 @@ class FusedConv2DOp : public OpKernel {
     } else if (FusedOpsMatchAndSupportedOnDevice(fused_ops, {"BiasAdd", "Relu"},
                                                  /*cpu_only=*/false)) {
       fused_computation_ = FusedComputationType::kBiasAddWithRelu;
+    } else if (FusedOpsMatchAndSupportedOnDevice(fused_ops,
+                                                 {"BiasAdd", "Relu6"},
+                                                 /*cpu_only=*/true)) {
+      fused_computation_ = FusedComputationType::kBiasAddWithRelu6;
+    } else if (FusedOpsMatchAndSupportedOnDevice(fused_ops, {"BiasAdd", "Elu"},
+                                                 /*cpu_only=*/true)) {
+      fused_computation_ = FusedComputationType::kBiasAddWithElu;
     } else if (FusedOpsMatchAndSupportedOnDevice(fused_ops, {"FusedBatchNorm"},
                                                  /*cpu_only=*/true)) {
       fused_computation_ = FusedComputationType::kFusedBatchNorm;
@@ -863,6 +1010,14 @@ class FusedConv2DOp : public OpKernel {
                                                  {"FusedBatchNorm", "Relu"},
                                                  /*cpu_only=*/true)) {
       fused_computation_ = FusedComputationType::kFusedBatchNormWithRelu;
+    } else if (FusedOpsMatchAndSupportedOnDevice(fused_ops,
+                                                 {"FusedBatchNorm", "Relu6"},
+                                                 /*cpu_only=*/true)) {
+      fused_computation_ = FusedComputationType::kFusedBatchNormWithRelu6;
+    } else if (FusedOpsMatchAndSupportedOnDevice(fused_ops,
+                                                 {"FusedBatchNorm", "Elu"},
+                                                 /*cpu_only=*/true)) {
+      fused_computation_ = FusedComputationType::kFusedBatchNormWithElu;
     } else {
       OP_REQUIRES(context, false,
                   errors::Unimplemented("Fusion is not implemented: [",
@@ -872,14 +1027,18 @@ class FusedConv2DOp : public OpKernel {
     // Depending on a picked fusion type validate fusion-specific arguments.
 
     if (fused_computation_ == FusedComputationType::kBiasAdd ||
-        fused_computation_ == FusedComputationType::kBiasAddWithRelu) {
+        fused_computation_ == FusedComputationType::kBiasAddWithRelu ||
+        fused_computation_ == FusedComputationType::kBiasAddWithRelu6 ||
+        fused_computation_ == FusedComputationType::kBiasAddWithElu) {
       OP_REQUIRES(context, num_args == 1,
                   errors::InvalidArgument(
                       "Fused Conv2D must have one extra argument: bias."));
     }
 
     if (fused_computation_ == FusedComputationType::kFusedBatchNorm ||
-        fused_computation_ == FusedComputationType::kFusedBatchNormWithRelu) {
+        fused_computation_ == FusedComputationType::kFusedBatchNormWithRelu ||
+        fused_computation_ == FusedComputationType::kFusedBatchNormWithRelu6 ||
+        fused_computation_ == FusedComputationType::kFusedBatchNormWithElu) {
       OP_REQUIRES(
           context, num_args == 4,
           errors::InvalidArgument("Fused FusedBatchNorm must have four extra "
@@ -962,7 +1121,7 @@ class FusedConv2DOp : public OpKernel {
       Name("_FusedConv2D").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
       FusedConv2DOp<CPUDevice, T>);
 
-#if GOOGLE_CUDA
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 #define DECLARE_FUNCTOR_GPU_SPEC(T)                                      \
   template <>                                                            \
@@ -985,7 +1144,7 @@ class FusedConv2DOp : public OpKernel {
       Name("_FusedConv2D").Device(DEVICE_GPU).TypeConstraint<T>("T"), \
       FusedConv2DOp<GPUDevice, T>);
 
-#endif  // GOOGLE_CUDA
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 
 }  // namespace tensorflow
 
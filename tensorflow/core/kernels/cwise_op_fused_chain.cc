@@ -0,0 +1,232 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Implements _FusedUnaryChain, which evaluates a chain of elementwise unary
+// ops in a single pass over the data. Stand-alone cwise kernels each read and
+// write the full tensor, so a chain of them is bound by memory bandwidth;
+// here every worker walks its range in cache-sized blocks and applies all
+// stages to a block before moving on, so intermediate values never travel to
+// main memory. Each stage is evaluated with the vectorized Eigen functors
+// from cwise_ops.h. The op is created by the Grappler Remapper optimizer
+// (see grappler/optimizers/remapper.cc).
+
+#define EIGEN_USE_THREADS
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/cwise_ops_common.h"
+#include "tensorflow/core/util/work_sharder.h"
+
+namespace tensorflow {
+namespace {
+
+// One interpreter stage per supported unary op. The list mirrors
+// IsSupportedUnaryElementwise in grappler/optimizers/remapper.cc.
+enum class UnaryChainStage {
+  kAbs,
+  kCeil,
+  kExp,
+  kExpm1,
+  kFloor,
+  kLog,
+  kLog1p,
+  kNeg,
+  kReciprocal,
+  kRound,
+  kRsqrt,
+  kSigmoid,
+  kSign,
+  kSqrt,
+  kSquare,
+  kTanh,
+};
+
+Status StageFromOpName(const string& op, UnaryChainStage* stage) {
+  if (op == "Abs") {
+    *stage = UnaryChainStage::kAbs;
+  } else if (op == "Ceil") {
+    *stage = UnaryChainStage::kCeil;
+  } else if (op == "Exp") {
+    *stage = UnaryChainStage::kExp;
+  } else if (op == "Expm1") {
+    *stage = UnaryChainStage::kExpm1;
+  } else if (op == "Floor") {
+    *stage = UnaryChainStage::kFloor;
+  } else if (op == "Log") {
+    *stage = UnaryChainStage::kLog;
+  } else if (op == "Log1p") {
+    *stage = UnaryChainStage::kLog1p;
+  } else if (op == "Neg") {
+    *stage = UnaryChainStage::kNeg;
+  } else if (op == "Reciprocal") {
+    *stage = UnaryChainStage::kReciprocal;
+  } else if (op == "Round") {
+    *stage = UnaryChainStage::kRound;
+  } else if (op == "Rsqrt") {
+    *stage = UnaryChainStage::kRsqrt;
+  } else if (op == "Sigmoid") {
+    *stage = UnaryChainStage::kSigmoid;
+  } else if (op == "Sign") {
+    *stage = UnaryChainStage::kSign;
+  } else if (op == "Sqrt") {
+    *stage = UnaryChainStage::kSqrt;
+  } else if (op == "Square") {
+    *stage = UnaryChainStage::kSquare;
+  } else if (op == "Tanh") {
+    *stage = UnaryChainStage::kTanh;
+  } else {
+    return errors::Unimplemented("Unsupported op in fused unary chain: ", op);
+  }
+  return Status::OK();
+}
+
+// Number of elements a block holds; sized so that a block of any supported
+// type stays within the L1 cache between stages.
+constexpr int64 kBlockSize = 4096;
+
+// Applies one functor stage in place over a (cache resident) block. The
+// assignment goes through Eigen's vectorized evaluation path.
+template <typename T, typename Functor>
+void ApplyStage(T* block, int64 len) {
+  typename TTypes<T>::Flat buf(block, len);
+  buf = buf.unaryExpr(typename Functor::func());
+}
+
+template <typename T>
+class FusedUnaryChainOp : public OpKernel {
+ public:
+  explicit FusedUnaryChainOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES(ctx, fused_ops.size() >= 2,
+                errors::InvalidArgument(
+                    "Fused unary chain must have at least two ops."));
+    for (const string& op : fused_ops) {
+      UnaryChainStage stage;
+      OP_REQUIRES_OK(ctx, StageFromOpName(op, &stage));
+      stages_.push_back(stage);
+    }
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const Tensor& inp = ctx->input(0);
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(
+        ctx, ctx->forward_input_or_allocate_output({0}, 0, inp.shape(), &out));
+    const int64 num_elements = inp.NumElements();
+    if (num_elements == 0) return;
+
+    const T* in_data = inp.flat<T>().data();
+    T* out_data = out->flat<T>().data();
+    auto* worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+
+    auto work = [this, in_data, out_data](int64 begin, int64 end) {
+      for (int64 pos = begin; pos < end; pos += kBlockSize) {
+        const int64 len = std::min(kBlockSize, end - pos);
+        // The output block doubles as the scratch buffer for all stages (the
+        // input may have been forwarded, in which case this is a no-op).
+        if (out_data != in_data) {
+          std::memcpy(out_data + pos, in_data + pos, len * sizeof(T));
+        }
+        for (UnaryChainStage stage : stages_) {
+          ApplyStageDispatch(stage, out_data + pos, len);
+        }
+      }
+    };
+    // A handful of cycles per element and stage; the blocks are L1 resident
+    // after the first stage.
+    const int64 cost_per_element = 10 * stages_.size();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_elements,
+          cost_per_element, work);
+  }
+
+ private:
+  static void ApplyStageDispatch(UnaryChainStage stage, T* block, int64 len) {
+    switch (stage) {
+      case UnaryChainStage::kAbs:
+        ApplyStage<T, functor::abs<T>>(block, len);
+        break;
+      case UnaryChainStage::kCeil:
+        ApplyStage<T, functor::ceil<T>>(block, len);
+        break;
+      case UnaryChainStage::kExp:
+        ApplyStage<T, functor::exp<T>>(block, len);
+        break;
+      case UnaryChainStage::kExpm1:
+        ApplyStage<T, functor::expm1<T>>(block, len);
+        break;
+      case UnaryChainStage::kFloor:
+        ApplyStage<T, functor::floor<T>>(block, len);
+        break;
+      case UnaryChainStage::kLog:
+        ApplyStage<T, functor::log<T>>(block, len);
+        break;
+      case UnaryChainStage::kLog1p:
+        ApplyStage<T, functor::log1p<T>>(block, len);
+        break;
+      case UnaryChainStage::kNeg:
+        ApplyStage<T, functor::neg<T>>(block, len);
+        break;
+      case UnaryChainStage::kReciprocal:
+        ApplyStage<T, functor::inverse<T>>(block, len);
+        break;
+      case UnaryChainStage::kRound:
+        ApplyStage<T, functor::round<T>>(block, len);
+        break;
+      case UnaryChainStage::kRsqrt:
+        ApplyStage<T, functor::rsqrt<T>>(block, len);
+        break;
+      case UnaryChainStage::kSigmoid:
+        ApplyStage<T, functor::sigmoid<T>>(block, len);
+        break;
+      case UnaryChainStage::kSign:
+        ApplyStage<T, functor::sign<T>>(block, len);
+        break;
+      case UnaryChainStage::kSqrt:
+        ApplyStage<T, functor::sqrt<T>>(block, len);
+        break;
+      case UnaryChainStage::kSquare:
+        ApplyStage<T, functor::square<T>>(block, len);
+        break;
+      case UnaryChainStage::kTanh:
+        ApplyStage<T, functor::tanh<T>>(block, len);
+        break;
+    }
+  }
+
+  std::vector<UnaryChainStage> stages_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FusedUnaryChainOp);
+};
+
+}  // namespace
+
+#define REGISTER_FUSED_UNARY_CHAIN(T)                                     \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("_FusedUnaryChain").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedUnaryChainOp<T>);
+
+TF_CALL_float(REGISTER_FUSED_UNARY_CHAIN);
+TF_CALL_double(REGISTER_FUSED_UNARY_CHAIN);
+
+#undef REGISTER_FUSED_UNARY_CHAIN
+
+}  // namespace tensorflow
@@ -0,0 +1,85 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/kernels/data/batch_copy_util.h"
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Minimum number of bytes each shard should copy.  Chosen to amortize the
+// cost of scheduling a closure on the runner threadpool; below this the
+// copies run inline.
+constexpr int64 kMinBlockBytes = 1 << 15;  // 32KiB
+
+}  // namespace
+
+bool ParallelBatchCopyEnabled() {
+  static bool enabled = [] {
+    bool result = false;
+    TF_CHECK_OK(
+        ReadBoolFromEnvVar("TF_DATA_PARALLEL_BATCH_COPY", false, &result));
+    return result;
+  }();
+  return enabled;
+}
+
+Status ParallelCopyBatchElements(
+    IteratorContext* ctx, int64 num_elements, int64 bytes_per_element,
+    const std::function<Status(int64)>& copy_element_fn) {
+  const int64 total_bytes = num_elements * bytes_per_element;
+  int64 num_blocks =
+      std::min<int64>(ctx->runner_threadpool_size(),
+                      std::max<int64>(1, total_bytes / kMinBlockBytes));
+  num_blocks = std::min(num_blocks, num_elements);
+  if (num_blocks <= 1) {
+    for (int64 i = 0; i < num_elements; ++i) {
+      TF_RETURN_IF_ERROR(copy_element_fn(i));
+    }
+    return Status::OK();
+  }
+  const int64 block_size = (num_elements + num_blocks - 1) / num_blocks;
+  Status status;
+  mutex status_mu;
+  BlockingCounter counter(num_blocks);
+  for (int64 block = 0; block < num_blocks; ++block) {
+    const int64 start = block * block_size;
+    const int64 end = std::min(start + block_size, num_elements);
+    (*ctx->runner())(
+        [start, end, &status, &status_mu, &counter, &copy_element_fn]() {
+          for (int64 i = start; i < end; ++i) {
+            Status s = copy_element_fn(i);
+            if (!s.ok()) {
+              mutex_lock l(status_mu);
+              status.Update(s);
+              break;
+            }
+          }
+          counter.DecrementCount();
+        });
+  }
+  // The final DecrementCount() synchronizes with Wait(), so `status` can be
+  // read without holding `status_mu` once Wait() returns.
+  counter.Wait();
+  return status;
+}
+
+}  // namespace data
+}  // namespace tensorflow
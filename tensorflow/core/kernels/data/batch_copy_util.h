@@ -0,0 +1,48 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#ifndef TENSORFLOW_CORE_KERNELS_DATA_BATCH_COPY_UTIL_H_
+#define TENSORFLOW_CORE_KERNELS_DATA_BATCH_COPY_UTIL_H_
+
+#include <functional>
+
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/lib/core/status.h"
+
+namespace tensorflow {
+namespace data {
+
+// Returns true if batch assembly should shard element copies across the
+// runner threadpool.  Controlled by the TF_DATA_PARALLEL_BATCH_COPY
+// environment variable, which defaults to false.
+bool ParallelBatchCopyEnabled();
+
+// Invokes `copy_element_fn(i)` for each `i` in `[0, num_elements)`, sharding
+// contiguous blocks of elements across the runner threadpool of `ctx` and
+// blocking until all copies have completed.  `bytes_per_element` is used to
+// choose the degree of parallelism, in the manner of `Shard()` in
+// tensorflow/core/util/work_sharder.h; batches whose total size does not
+// amortize the scheduling overhead are copied inline on the calling thread.
+//
+// Each invocation of `copy_element_fn` must write only to the slice for its
+// own index.  Returns the first non-OK status produced by any invocation, in
+// which case the contents of the output are unspecified.
+Status ParallelCopyBatchElements(
+    IteratorContext* ctx, int64 num_elements, int64 bytes_per_element,
+    const std::function<Status(int64)>& copy_element_fn);
+
+}  // namespace data
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_KERNELS_DATA_BATCH_COPY_UTIL_H_
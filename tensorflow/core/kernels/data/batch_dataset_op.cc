@@ -15,6 +15,7 @@ limitations under the License.
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/kernels/data/batch_copy_util.h"
 #include "tensorflow/core/util/batch_util.h"
 
 namespace tensorflow {
@@ -189,8 +190,6 @@ class BatchDatasetOp : public UnaryDatasetOpKernel {
                 component_index);
           }
           Tensor& batch_component = out_tensors->back();
-          // Build the output tuple component by copying one slice
-          // from each input element in the batch.
           for (size_t i = 0; i < num_batch_elements; ++i) {
             if (batch_elements[i][component_index].shape() !=
                 first_element.shape()) {
@@ -202,9 +201,23 @@ class BatchDatasetOp : public UnaryDatasetOpKernel {
                   batch_elements[i][component_index].shape().DebugString(),
                   ".");
             }
-            TF_RETURN_IF_ERROR(batch_util::CopyElementToSlice(
-                std::move(batch_elements[i][component_index]), &batch_component,
-                i));
+          }
+          // Build the output tuple component by copying one slice
+          // from each input element in the batch.
+          auto copy_element_fn = [&batch_elements, &batch_component,
+                                  component_index](int64 index) {
+            return batch_util::CopyElementToSlice(
+                std::move(batch_elements[index][component_index]),
+                &batch_component, index);
+          };
+          if (ParallelBatchCopyEnabled()) {
+            TF_RETURN_IF_ERROR(ParallelCopyBatchElements(
+                ctx, num_batch_elements,
+                first_element.AllocatedBytes(), copy_element_fn));
+          } else {
+            for (int64 i = 0; i < num_batch_elements; ++i) {
+              TF_RETURN_IF_ERROR(copy_element_fn(i));
+            }
           }
         }
         *end_of_sequence = false;
@@ -0,0 +1,323 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/partial_tensor_shape.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/lib/jpeg/jpeg_mem.h"
+#include "tensorflow/core/platform/cpu_info.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// Decodes batches of JPEG bitstreams into a single [N, H, W, C] uint8
+// tensor, fanning the per-image decodes out over a dedicated thread pool.
+// The decode happens as part of the input pipeline rather than in the
+// training graph, so chaining this with prefetching (in particular
+// prefetch-to-device) overlaps decode with the training step and makes
+// the decoded batch device-resident before it is needed.
+
+class DecodeJpegDatasetOp : public UnaryDatasetOpKernel {
+ public:
+  explicit DecodeJpegDatasetOp(OpKernelConstruction* ctx)
+      : UnaryDatasetOpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("channels", &channels_));
+    OP_REQUIRES(ctx, channels_ == 1 || channels_ == 3,
+                errors::InvalidArgument("channels must be 1 or 3."));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("ratio", &ratio_));
+    OP_REQUIRES(ctx, ratio_ == 1 || ratio_ == 2 || ratio_ == 4 || ratio_ == 8,
+                errors::InvalidArgument("ratio must be 1, 2, 4, or 8."));
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("num_decode_threads", &num_decode_threads_));
+    OP_REQUIRES(ctx, num_decode_threads_ >= 0,
+                errors::InvalidArgument(
+                    "num_decode_threads must be non-negative."));
+    if (num_decode_threads_ == 0) {
+      num_decode_threads_ = port::NumSchedulableCPUs();
+    }
+  }
+
+  void MakeDataset(OpKernelContext* ctx, DatasetBase* input,
+                   DatasetBase** output) override {
+    const DataTypeVector& input_dtypes = input->output_dtypes();
+    OP_REQUIRES(
+        ctx,
+        (input_dtypes.size() == 1 && input_dtypes[0] == DT_STRING) ||
+            (input_dtypes.size() == 2 && input_dtypes[0] == DT_STRING &&
+             input_dtypes[1] == DT_INT32),
+        errors::InvalidArgument("DecodeJpegDataset expects an input dataset "
+                                "of 1-D string tensors, optionally paired "
+                                "with a [batch, 4] int32 tensor of crop "
+                                "windows."));
+    *output =
+        new Dataset(ctx, input, channels_, ratio_, num_decode_threads_);
+  }
+
+ private:
+  class Dataset : public DatasetBase {
+   public:
+    Dataset(OpKernelContext* ctx, const DatasetBase* input, int64 channels,
+            int64 ratio, int64 num_decode_threads)
+        : DatasetBase(DatasetContext(ctx)),
+          input_(input),
+          channels_(channels),
+          ratio_(ratio),
+          num_decode_threads_(num_decode_threads),
+          output_shapes_({PartialTensorShape({-1, -1, -1, channels})}),
+          thread_pool_(new thread::ThreadPool(
+              Env::Default(), ThreadOptions(), "data_decode_jpeg",
+              num_decode_threads,
+              /*low_latency_hint=*/false)) {
+      input_->Ref();
+    }
+
+    ~Dataset() override { input_->Unref(); }
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return absl::make_unique<Iterator>(
+          Iterator::Params{this, strings::StrCat(prefix, "::DecodeJpeg")});
+    }
+
+    const DataTypeVector& output_dtypes() const override {
+      static DataTypeVector* dtypes = new DataTypeVector({DT_UINT8});
+      return *dtypes;
+    }
+
+    const std::vector<PartialTensorShape>& output_shapes() const override {
+      return output_shapes_;
+    }
+
+    string DebugString() const override {
+      return "DecodeJpegDatasetOp::Dataset";
+    }
+
+    int64 Cardinality() const override { return input_->Cardinality(); }
+
+   protected:
+    Status AsGraphDefInternal(SerializationContext* ctx,
+                              DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      Node* input_graph_node = nullptr;
+      TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph_node));
+      AttrValue channels_attr;
+      b->BuildAttrValue(channels_, &channels_attr);
+      AttrValue ratio_attr;
+      b->BuildAttrValue(ratio_, &ratio_attr);
+      AttrValue num_decode_threads_attr;
+      b->BuildAttrValue(num_decode_threads_, &num_decode_threads_attr);
+      TF_RETURN_IF_ERROR(b->AddDataset(
+          this, {input_graph_node},
+          {{"channels", channels_attr},
+           {"ratio", ratio_attr},
+           {"num_decode_threads", num_decode_threads_attr}},
+          output));
+      return Status::OK();
+    }
+
+   private:
+    class Iterator : public DatasetIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : DatasetIterator<Dataset>(params) {}
+
+      Status Initialize(IteratorContext* ctx) override {
+        return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
+      }
+
+      Status GetNextInternal(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        std::vector<Tensor> input_element;
+        TF_RETURN_IF_ERROR(
+            input_impl_->GetNext(ctx, &input_element, end_of_sequence));
+        if (*end_of_sequence) {
+          return Status::OK();
+        }
+        if (!TensorShapeUtils::IsVector(input_element[0].shape())) {
+          return errors::InvalidArgument(
+              "DecodeJpegDataset expects each input element to be a 1-D "
+              "string tensor of encoded JPEG images.");
+        }
+        const auto encoded = input_element[0].vec<string>();
+        const int64 batch_size = encoded.size();
+        const int64 channels = dataset()->channels_;
+
+        jpeg::UncompressFlags flags;
+        flags.components = channels;
+        flags.ratio = dataset()->ratio_;
+
+        // An optional second component carries one [y, x, height, width]
+        // crop window per image (in the scaled image's coordinates, like
+        // DecodeAndCropJpeg). The window is pushed down into the ROI
+        // scanline decode, so discarded pixels are never decoded.
+        const bool has_crop_windows = input_element.size() > 1;
+        if (has_crop_windows &&
+            (!TensorShapeUtils::IsMatrix(input_element[1].shape()) ||
+             input_element[1].dim_size(0) != batch_size ||
+             input_element[1].dim_size(1) != 4)) {
+          return errors::InvalidArgument(
+              "DecodeJpegDataset expects crop windows of shape [batch, 4], "
+              "got ",
+              input_element[1].shape().DebugString(), ".");
+        }
+        const int32* crop_data =
+            has_crop_windows ? input_element[1].flat<int32>().data() : nullptr;
+        auto crop_windows = [crop_data](int64 row, int64 col) {
+          return crop_data[row * 4 + col];
+        };
+
+        // All images in a batch must decode to the same dimensions, so the
+        // whole batch can be written into one allocation. With crop
+        // windows that dimension is the (uniform) crop size; otherwise it
+        // is read off the first image's header.
+        int width = 0;
+        int height = 0;
+        if (batch_size > 0) {
+          if (has_crop_windows) {
+            height = crop_windows(0, 2);
+            width = crop_windows(0, 3);
+            if (height <= 0 || width <= 0) {
+              return errors::InvalidArgument(
+                  "Crop window heights and widths must be positive, got [",
+                  height, ", ", width, "].");
+            }
+          } else if (jpeg::GetImageInfo(encoded(0).data(), encoded(0).size(),
+                                        &width, &height, nullptr)) {
+            width = (width + flags.ratio - 1) / flags.ratio;
+            height = (height + flags.ratio - 1) / flags.ratio;
+          } else {
+            return errors::InvalidArgument(
+                "Could not parse the JPEG header of image 0.");
+          }
+        }
+
+        Tensor output(ctx->allocator({}), DT_UINT8,
+                      TensorShape({batch_size, height, width, channels}));
+        uint8* output_base = output.flat<uint8>().data();
+        const int64 image_bytes = height * width * channels;
+
+        // Fan the per-image decodes out over the dataset's thread pool
+        // and wait for the batch to complete.
+        mutex status_mu;
+        Status decode_status;
+        BlockingCounter counter(batch_size);
+        for (int64 i = 0; i < batch_size; ++i) {
+          jpeg::UncompressFlags image_flags = flags;
+          if (has_crop_windows) {
+            if (crop_windows(i, 2) != height || crop_windows(i, 3) != width) {
+              counter.DecrementCount();
+              mutex_lock sl(status_mu);
+              decode_status.Update(errors::InvalidArgument(
+                  "All crop windows in a batch must have the same size; "
+                  "window ",
+                  i, " does not match window 0."));
+              continue;
+            }
+            image_flags.crop = true;
+            image_flags.crop_y = crop_windows(i, 0);
+            image_flags.crop_x = crop_windows(i, 1);
+            image_flags.crop_height = crop_windows(i, 2);
+            image_flags.crop_width = crop_windows(i, 3);
+          }
+          dataset()->thread_pool_->Schedule([&, image_flags, i]() {
+            Status s = DecodeOneImage(encoded(i), image_flags, height, width,
+                                      output_base + i * image_bytes, i);
+            if (!s.ok()) {
+              mutex_lock sl(status_mu);
+              decode_status.Update(s);
+            }
+            counter.DecrementCount();
+          });
+        }
+        counter.Wait();
+        TF_RETURN_IF_ERROR(decode_status);
+
+        out_tensors->push_back(std::move(output));
+        return Status::OK();
+      }
+
+     protected:
+      std::shared_ptr<model::Node> CreateNode(
+          IteratorContext* ctx, model::Node::Args args) const override {
+        return model::MakeKnownRatioNode(std::move(args), /*ratio=*/1);
+      }
+
+      Status SaveInternal(IteratorStateWriter* writer) override {
+        mutex_lock l(mu_);
+        return SaveInput(writer, input_impl_);
+      }
+
+      Status RestoreInternal(IteratorContext* ctx,
+                             IteratorStateReader* reader) override {
+        mutex_lock l(mu_);
+        return RestoreInput(ctx, reader, input_impl_);
+      }
+
+     private:
+      Status DecodeOneImage(const string& encoded,
+                            const jpeg::UncompressFlags& flags,
+                            int expected_height, int expected_width,
+                            uint8* destination, int64 index) {
+        bool size_mismatch = false;
+        uint8* decoded = jpeg::Uncompress(
+            encoded.data(), encoded.size(), flags, nullptr /* nwarn */,
+            [&size_mismatch, expected_height, expected_width, destination](
+                int width, int height, int components) -> uint8* {
+              if (height != expected_height || width != expected_width) {
+                size_mismatch = true;
+                return nullptr;
+              }
+              return destination;
+            });
+        if (size_mismatch) {
+          return errors::InvalidArgument(
+              "All JPEG images in a batch must have the same dimensions; "
+              "image ", index, " does not match image 0.");
+        }
+        if (decoded == nullptr) {
+          return errors::InvalidArgument("Could not decode JPEG image ",
+                                         index, ".");
+        }
+        return Status::OK();
+      }
+
+      mutex mu_;
+      std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
+    };
+
+    const DatasetBase* const input_;
+    const int64 channels_;
+    const int64 ratio_;
+    const int64 num_decode_threads_;
+    const std::vector<PartialTensorShape> output_shapes_;
+    const std::unique_ptr<thread::ThreadPool> thread_pool_;
+  };
+
+  int64 channels_;
+  int64 ratio_;
+  int64 num_decode_threads_;
+};
+
+REGISTER_KERNEL_BUILDER(
+    Name("ExperimentalDecodeJpegDataset").Device(DEVICE_CPU),
+    DecodeJpegDatasetOp);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
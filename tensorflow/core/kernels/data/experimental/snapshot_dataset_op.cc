@@ -0,0 +1,535 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+#include <deque>
+
+#include "absl/memory/memory.h"
+#include "tensorflow/core/framework/dataset.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/graph/graph_def_builder.h"
+#include "tensorflow/core/lib/gtl/cleanup.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
+#include "tensorflow/core/lib/random/random.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/protobuf/data/experimental/snapshot.pb.h"
+
+namespace tensorflow {
+namespace data {
+namespace {
+
+// The snapshot is stored under <path>/<graph_hash>/: a metadata file
+// describing the run that produced it, and one compressed record file per
+// writer thread ("<run_id>-<thread>.snapshot") holding the serialized
+// elements. A snapshot becomes readable once the metadata is rewritten
+// with `finalized` set; until then concurrent jobs fall through to the
+// input pipeline instead of waiting for the writer.
+
+constexpr char kSnapshotFilename[] = "snapshot.metadata";
+constexpr char kShardSuffix[] = ".snapshot";
+
+// Maximum number of serialized elements the writer threads may have
+// buffered before the producer blocks.
+constexpr int64 kMaxPendingRecords = 64;
+
+enum SnapshotMode { READER = 0, WRITER = 1, PASSTHROUGH = 2 };
+
+string MetadataFilename(const string& hash_dir) {
+  return io::JoinPath(hash_dir, kSnapshotFilename);
+}
+
+Status ReadMetadataFile(Env* env, const string& hash_dir,
+                        experimental::SnapshotMetadataRecord* metadata) {
+  TF_RETURN_IF_ERROR(env->FileExists(MetadataFilename(hash_dir)));
+  return ReadBinaryProto(env, MetadataFilename(hash_dir), metadata);
+}
+
+Status WriteMetadataFile(
+    Env* env, const string& hash_dir,
+    const experimental::SnapshotMetadataRecord& metadata) {
+  string tmp_filename =
+      strings::StrCat(MetadataFilename(hash_dir), "-tmp-", random::New64());
+  TF_RETURN_IF_ERROR(WriteBinaryProto(env, tmp_filename, metadata));
+  return env->RenameFile(tmp_filename, MetadataFilename(hash_dir));
+}
+
+class SnapshotDatasetOp : public UnaryDatasetOpKernel {
+ public:
+  explicit SnapshotDatasetOp(OpKernelConstruction* ctx)
+      : UnaryDatasetOpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("compression", &compression_));
+    OP_REQUIRES_OK(ctx,
+                   ctx->GetAttr("num_writer_threads", &num_writer_threads_));
+    OP_REQUIRES(ctx, num_writer_threads_ > 0,
+                errors::InvalidArgument(
+                    "num_writer_threads must be greater than zero."));
+  }
+
+  void MakeDataset(OpKernelContext* ctx, DatasetBase* input,
+                   DatasetBase** output) override {
+    string path;
+    OP_REQUIRES_OK(ctx, ParseScalarArgument<string>(ctx, "path", &path));
+
+    // Fingerprint the input pipeline so that snapshots written by a
+    // different pipeline (or a changed version of this one) are never
+    // served for it.
+    GraphDefBuilder b;
+    DatasetGraphDefBuilder db(&b);
+    Node* input_node = nullptr;
+    SerializationContext::Params params;
+    std::vector<std::pair<string, Tensor>> input_list;
+    params.flib_def = ctx->function_library()->GetFunctionLibraryDefinition();
+    params.input_list = &input_list;
+    params.optimization_only = true;
+    SerializationContext serialization_ctx(params);
+    OP_REQUIRES_OK(ctx,
+                   db.AddInputDataset(&serialization_ctx, input, &input_node));
+    GraphDef graph_def;
+    OP_REQUIRES_OK(ctx, b.ToGraphDef(&graph_def));
+    string graph_hash = strings::StrCat(
+        strings::Hex(Hash64(graph_def.SerializeAsString()),
+                     strings::kZeroPad16));
+
+    *output = new Dataset(ctx, input, path, graph_hash, compression_,
+                          num_writer_threads_);
+  }
+
+ private:
+  class Dataset : public DatasetBase {
+   public:
+    explicit Dataset(OpKernelContext* ctx, const DatasetBase* input,
+                     string path, string graph_hash, string compression,
+                     int64 num_writer_threads)
+        : DatasetBase(DatasetContext(ctx)),
+          input_(input),
+          path_(std::move(path)),
+          graph_hash_(std::move(graph_hash)),
+          compression_(std::move(compression)),
+          num_writer_threads_(num_writer_threads) {
+      input_->Ref();
+    }
+
+    ~Dataset() override { input_->Unref(); }
+
+    std::unique_ptr<IteratorBase> MakeIteratorInternal(
+        const string& prefix) const override {
+      return absl::make_unique<Iterator>(
+          Iterator::Params{this, strings::StrCat(prefix, "::Snapshot")});
+    }
+
+    const DataTypeVector& output_dtypes() const override {
+      return input_->output_dtypes();
+    }
+
+    const std::vector<PartialTensorShape>& output_shapes() const override {
+      return input_->output_shapes();
+    }
+
+    string DebugString() const override {
+      return "SnapshotDatasetOp::Dataset";
+    }
+
+    int64 Cardinality() const override { return input_->Cardinality(); }
+
+   protected:
+    Status AsGraphDefInternal(SerializationContext* ctx,
+                              DatasetGraphDefBuilder* b,
+                              Node** output) const override {
+      Node* input_graph_node = nullptr;
+      TF_RETURN_IF_ERROR(b->AddInputDataset(ctx, input_, &input_graph_node));
+      Node* path = nullptr;
+      TF_RETURN_IF_ERROR(b->AddScalar(path_, &path));
+      AttrValue compression_attr;
+      b->BuildAttrValue(compression_, &compression_attr);
+      AttrValue num_writer_threads_attr;
+      b->BuildAttrValue(num_writer_threads_, &num_writer_threads_attr);
+      TF_RETURN_IF_ERROR(b->AddDataset(
+          this, {input_graph_node, path},
+          {{"compression", compression_attr},
+           {"num_writer_threads", num_writer_threads_attr}},
+          output));
+      return Status::OK();
+    }
+
+   private:
+    class Iterator : public DatasetIterator<Dataset> {
+     public:
+      explicit Iterator(const Params& params)
+          : DatasetIterator<Dataset>(params) {}
+
+      Status Initialize(IteratorContext* ctx) override {
+        mutex_lock l(mu_);
+        hash_dir_ = io::JoinPath(dataset()->path_, dataset()->graph_hash_);
+        TF_RETURN_IF_ERROR(DetermineOpMode(ctx->env(), &mode_));
+        switch (mode_) {
+          case READER:
+            iterator_ = absl::make_unique<SnapshotReaderIterator>(
+                SnapshotReaderIterator::Params{
+                    dataset(), strings::StrCat(prefix(), "Reader")},
+                hash_dir_);
+            break;
+          case WRITER:
+            iterator_ = absl::make_unique<SnapshotWriterIterator>(
+                SnapshotWriterIterator::Params{
+                    dataset(), strings::StrCat(prefix(), "Writer")},
+                hash_dir_);
+            break;
+          case PASSTHROUGH:
+            return dataset()->input_->MakeIterator(
+                ctx, strings::StrCat(prefix(), "Passthrough"), &iterator_);
+        }
+        return iterator_->Initialize(ctx);
+      }
+
+      Status GetNextInternal(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence) override {
+        mutex_lock l(mu_);
+        return iterator_->GetNext(ctx, out_tensors, end_of_sequence);
+      }
+
+     protected:
+      Status SaveInternal(IteratorStateWriter* writer) override {
+        return errors::Unimplemented(
+            "Checkpointing snapshot datasets is not supported.");
+      }
+
+      Status RestoreInternal(IteratorContext* ctx,
+                             IteratorStateReader* reader) override {
+        return errors::Unimplemented(
+            "Checkpointing snapshot datasets is not supported.");
+      }
+
+     private:
+      // Serves from an existing finalized snapshot, re-runs the input
+      // pipeline if a writer is still in flight, and otherwise becomes
+      // the writer itself.
+      Status DetermineOpMode(Env* env, SnapshotMode* mode)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        experimental::SnapshotMetadataRecord metadata;
+        Status s = ReadMetadataFile(env, hash_dir_, &metadata);
+        if (errors::IsNotFound(s)) {
+          *mode = WRITER;
+          return Status::OK();
+        }
+        TF_RETURN_IF_ERROR(s);
+        if (metadata.finalized()) {
+          *mode = READER;
+        } else {
+          LOG(INFO) << "Snapshot at " << hash_dir_
+                    << " is still being written; re-running the input "
+                    << "pipeline instead.";
+          *mode = PASSTHROUGH;
+        }
+        return Status::OK();
+      }
+
+      class SnapshotReaderIterator : public DatasetIterator<Dataset> {
+       public:
+        explicit SnapshotReaderIterator(const Params& params, string hash_dir)
+            : DatasetIterator<Dataset>(params),
+              hash_dir_(std::move(hash_dir)) {}
+
+        Status Initialize(IteratorContext* ctx) override {
+          mutex_lock l(mu_);
+          TF_RETURN_IF_ERROR(
+              ReadMetadataFile(ctx->env(), hash_dir_, &metadata_));
+          if (metadata_.graph_hash() != dataset()->graph_hash_) {
+            return errors::DataLoss(
+                "Snapshot metadata at ", hash_dir_, " records graph hash ",
+                metadata_.graph_hash(), " but the input pipeline hashes to ",
+                dataset()->graph_hash_, ".");
+          }
+          TF_RETURN_IF_ERROR(ctx->env()->GetMatchingPaths(
+              io::JoinPath(hash_dir_, strings::StrCat(metadata_.run_id(), "-*",
+                                                      kShardSuffix)),
+              &filenames_));
+          std::sort(filenames_.begin(), filenames_.end());
+          return Status::OK();
+        }
+
+        Status GetNextInternal(IteratorContext* ctx,
+                               std::vector<Tensor>* out_tensors,
+                               bool* end_of_sequence) override {
+          mutex_lock l(mu_);
+          while (true) {
+            if (reader_ == nullptr) {
+              if (next_file_index_ >= filenames_.size()) {
+                *end_of_sequence = true;
+                return Status::OK();
+              }
+              TF_RETURN_IF_ERROR(ctx->env()->NewRandomAccessFile(
+                  filenames_[next_file_index_], &file_));
+              reader_ = absl::make_unique<io::SequentialRecordReader>(
+                  file_.get(),
+                  io::RecordReaderOptions::CreateRecordReaderOptions(
+                      metadata_.compression()));
+            }
+            string record_bytes;
+            Status s = reader_->ReadRecord(&record_bytes);
+            if (errors::IsOutOfRange(s)) {
+              // Move on to the next shard.
+              reader_.reset();
+              file_.reset();
+              ++next_file_index_;
+              continue;
+            }
+            TF_RETURN_IF_ERROR(s);
+            experimental::SnapshotRecord record;
+            if (!record.ParseFromString(record_bytes)) {
+              return errors::DataLoss("Unable to parse snapshot record from ",
+                                      filenames_[next_file_index_], ".");
+            }
+            out_tensors->reserve(record.tensors_size());
+            for (const TensorProto& proto : record.tensors()) {
+              Tensor tensor;
+              if (!tensor.FromProto(proto)) {
+                return errors::DataLoss(
+                    "Unable to parse tensor from snapshot record in ",
+                    filenames_[next_file_index_], ".");
+              }
+              out_tensors->push_back(std::move(tensor));
+            }
+            *end_of_sequence = false;
+            return Status::OK();
+          }
+        }
+
+       protected:
+        Status SaveInternal(IteratorStateWriter* writer) override {
+          return errors::Unimplemented(
+              "Checkpointing snapshot datasets is not supported.");
+        }
+
+        Status RestoreInternal(IteratorContext* ctx,
+                               IteratorStateReader* reader) override {
+          return errors::Unimplemented(
+              "Checkpointing snapshot datasets is not supported.");
+        }
+
+       private:
+        const string hash_dir_;
+
+        mutex mu_;
+        experimental::SnapshotMetadataRecord metadata_ GUARDED_BY(mu_);
+        std::vector<string> filenames_ GUARDED_BY(mu_);
+        size_t next_file_index_ GUARDED_BY(mu_) = 0;
+        std::unique_ptr<RandomAccessFile> file_ GUARDED_BY(mu_);
+        std::unique_ptr<io::SequentialRecordReader> reader_ GUARDED_BY(mu_);
+      };
+
+      class SnapshotWriterIterator : public DatasetIterator<Dataset> {
+       public:
+        explicit SnapshotWriterIterator(const Params& params, string hash_dir)
+            : DatasetIterator<Dataset>(params),
+              hash_dir_(std::move(hash_dir)) {}
+
+        ~SnapshotWriterIterator() override {
+          mutex_lock l(mu_);
+          cancelled_ = true;
+          cond_var_.notify_all();
+          while (num_active_threads_ > 0) {
+            cond_var_.wait(l);
+          }
+        }
+
+        Status Initialize(IteratorContext* ctx) override {
+          mutex_lock l(mu_);
+          TF_RETURN_IF_ERROR(ctx->env()->RecursivelyCreateDir(hash_dir_));
+          run_id_ = strings::StrCat(
+              strings::Hex(random::New64(), strings::kZeroPad4));
+
+          // Mark the snapshot as in progress so that concurrent jobs fall
+          // through to the input pipeline instead of reading a partial
+          // snapshot.
+          experimental::SnapshotMetadataRecord metadata;
+          metadata.set_graph_hash(dataset()->graph_hash_);
+          metadata.set_run_id(run_id_);
+          metadata.set_creation_timestamp(ctx->env()->NowMicros());
+          metadata.set_compression(dataset()->compression_);
+          TF_RETURN_IF_ERROR(
+              WriteMetadataFile(ctx->env(), hash_dir_, metadata));
+
+          Env* env = ctx->env();
+          for (int64 i = 0; i < dataset()->num_writer_threads_; ++i) {
+            ++num_active_threads_;
+            writer_threads_.emplace_back(ctx->env()->StartThread(
+                {}, strings::StrCat("snapshot_writer_thread_", i),
+                [this, env, i]() { WriterThread(env, i); }));
+          }
+          return dataset()->input_->MakeIterator(ctx, prefix(), &input_impl_);
+        }
+
+        Status GetNextInternal(IteratorContext* ctx,
+                               std::vector<Tensor>* out_tensors,
+                               bool* end_of_sequence) override {
+          {
+            mutex_lock l(mu_);
+            TF_RETURN_IF_ERROR(writer_status_);
+          }
+          // The input is consumed without holding `mu_` so that the writer
+          // threads can keep draining their buffer in the meantime.
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, out_tensors, end_of_sequence));
+          mutex_lock l(mu_);
+          if (*end_of_sequence) {
+            if (!end_of_input_) {
+              end_of_input_ = true;
+              cond_var_.notify_all();
+              // Wait for the background writers to drain their buffers
+              // before publishing the snapshot.
+              while (num_active_threads_ > 0) {
+                cond_var_.wait(l);
+              }
+              TF_RETURN_IF_ERROR(writer_status_);
+              experimental::SnapshotMetadataRecord metadata;
+              TF_RETURN_IF_ERROR(
+                  ReadMetadataFile(ctx->env(), hash_dir_, &metadata));
+              metadata.set_finalized(true);
+              TF_RETURN_IF_ERROR(
+                  WriteMetadataFile(ctx->env(), hash_dir_, metadata));
+            }
+            return Status::OK();
+          }
+
+          experimental::SnapshotRecord record;
+          for (const Tensor& tensor : *out_tensors) {
+            tensor.AsProtoTensorContent(record.add_tensors());
+          }
+          while (pending_records_.size() >= kMaxPendingRecords &&
+                 !cancelled_ && writer_status_.ok()) {
+            cond_var_.wait(l);
+          }
+          TF_RETURN_IF_ERROR(writer_status_);
+          pending_records_.push_back(record.SerializeAsString());
+          cond_var_.notify_all();
+          return Status::OK();
+        }
+
+       protected:
+        Status SaveInternal(IteratorStateWriter* writer) override {
+          return errors::Unimplemented(
+              "Checkpointing snapshot datasets is not supported.");
+        }
+
+        Status RestoreInternal(IteratorContext* ctx,
+                               IteratorStateReader* reader) override {
+          return errors::Unimplemented(
+              "Checkpointing snapshot datasets is not supported.");
+        }
+
+       private:
+        // Each writer thread owns one shard file and appends serialized
+        // elements to it as they are produced, so shards can be written in
+        // parallel with the training step that consumes the elements.
+        void WriterThread(Env* env, int64 thread_index) {
+          auto finalize = gtl::MakeCleanup([this]() {
+            mutex_lock l(mu_);
+            --num_active_threads_;
+            cond_var_.notify_all();
+          });
+
+          string filename;
+          {
+            mutex_lock l(mu_);
+            filename = io::JoinPath(
+                hash_dir_, strings::StrCat(run_id_, "-", thread_index,
+                                           kShardSuffix));
+          }
+          std::unique_ptr<WritableFile> file;
+          Status s = env->NewWritableFile(filename, &file);
+          if (!s.ok()) {
+            SignalWriterError(s);
+            return;
+          }
+          io::RecordWriter writer(
+              file.get(), io::RecordWriterOptions::CreateRecordWriterOptions(
+                              dataset()->compression_));
+          while (true) {
+            string record_bytes;
+            {
+              mutex_lock l(mu_);
+              while (pending_records_.empty() && !end_of_input_ &&
+                     !cancelled_) {
+                cond_var_.wait(l);
+              }
+              if (cancelled_ || (pending_records_.empty() && end_of_input_)) {
+                break;
+              }
+              record_bytes = std::move(pending_records_.front());
+              pending_records_.pop_front();
+              cond_var_.notify_all();
+            }
+            s = writer.WriteRecord(record_bytes);
+            if (!s.ok()) {
+              SignalWriterError(s);
+              return;
+            }
+          }
+          s = writer.Close();
+          if (s.ok()) {
+            s = file->Close();
+          }
+          if (!s.ok()) {
+            SignalWriterError(s);
+          }
+        }
+
+        void SignalWriterError(const Status& s) {
+          mutex_lock l(mu_);
+          writer_status_.Update(s);
+          cond_var_.notify_all();
+        }
+
+        const string hash_dir_;
+
+        mutex mu_;
+        condition_variable cond_var_;
+        string run_id_ GUARDED_BY(mu_);
+        // Only accessed by the single thread calling GetNextInternal.
+        std::unique_ptr<IteratorBase> input_impl_;
+        std::deque<string> pending_records_ GUARDED_BY(mu_);
+        Status writer_status_ GUARDED_BY(mu_);
+        bool end_of_input_ GUARDED_BY(mu_) = false;
+        bool cancelled_ GUARDED_BY(mu_) = false;
+        int64 num_active_threads_ GUARDED_BY(mu_) = 0;
+        std::vector<std::unique_ptr<Thread>> writer_threads_ GUARDED_BY(mu_);
+      };
+
+      mutex mu_;
+      string hash_dir_ GUARDED_BY(mu_);
+      SnapshotMode mode_ GUARDED_BY(mu_) = PASSTHROUGH;
+      std::unique_ptr<IteratorBase> iterator_ GUARDED_BY(mu_);
+    };
+
+    const DatasetBase* const input_;
+    const string path_;
+    const string graph_hash_;
+    const string compression_;
+    const int64 num_writer_threads_;
+  };
+
+  string compression_;
+  int64 num_writer_threads_;
+};
+
+REGISTER_KERNEL_BUILDER(Name("ExperimentalSnapshotDataset").Device(DEVICE_CPU),
+                        SnapshotDatasetOp);
+
+}  // namespace
+}  // namespace data
+}  // namespace tensorflow
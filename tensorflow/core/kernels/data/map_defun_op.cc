@@ -18,6 +18,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/data/dataset_utils.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -28,6 +29,10 @@ namespace tensorflow {
 namespace data {
 namespace {
 
+// Upper bound on the number of call frames kept for reuse across
+// `ComputeAsync` invocations.
+constexpr size_t kMaxPooledCallFrames = 1024;
+
 void SetRunOptions(OpKernelContext* ctx, FunctionLibraryRuntime::Options* opts,
                    bool always_collect_stats) {
   opts->step_id = ctx->step_id();
@@ -46,6 +51,7 @@ class MapDefunOp : public AsyncOpKernel {
                 errors::Internal("No function library."));
     const NameAttrList* func;
     OP_REQUIRES_OK(ctx, ctx->GetAttr("f", &func));
+    func_ = *func;
     OP_REQUIRES_OK(ctx,
                    func_lib->Instantiate(func->name(), AttrSlice(&func->attr()),
                                          &func_handle_));
@@ -67,7 +73,19 @@ class MapDefunOp : public AsyncOpKernel {
 
     OP_REQUIRES_OK_ASYNC(ctx, SetupArgs(ctx, &compute_opts), done);
 
-    Status s = SetupOutputs(ctx, compute_opts);
+    // If the function body only rearranges its inputs, produce the outputs
+    // directly from the batched inputs instead of fanning out one function
+    // run per batch element.
+    bool short_circuited = false;
+    Status s = TryShortCircuit(ctx, compute_opts, &short_circuited);
+    if (!s.ok() || short_circuited) {
+      delete compute_opts;
+      OP_REQUIRES_OK_ASYNC(ctx, s, done);
+      done();
+      return;
+    }
+
+    s = SetupOutputs(ctx, compute_opts);
     if (!s.ok()) delete compute_opts;
     OP_REQUIRES_OK_ASYNC(ctx, s, done);
 
@@ -105,18 +123,21 @@ class MapDefunOp : public AsyncOpKernel {
         break;
       }
 
-      auto* call_frame = new MapFunctionCallFrame(compute_opts, this, i);
+      MapFunctionCallFrame* call_frame =
+          BorrowCallFrame(compute_opts, i).release();
 
       refcounted->Ref();
-      ctx->function_library()->Run(opts, func_handle_, call_frame,
-                                   [call_frame, refcounted, c_mgr, parent_mgr,
-                                    token](const Status& func_status) {
-                                     parent_mgr->DeregisterCallback(token);
-                                     delete c_mgr;
-                                     delete call_frame;
-                                     refcounted->UpdateStatus(func_status);
-                                     refcounted->Unref();
-                                   });
+      ctx->function_library()->Run(
+          opts, func_handle_, call_frame,
+          [this, call_frame, refcounted, c_mgr, parent_mgr,
+           token](const Status& func_status) {
+            parent_mgr->DeregisterCallback(token);
+            delete c_mgr;
+            ReturnCallFrame(
+                std::unique_ptr<MapFunctionCallFrame>(call_frame));
+            refcounted->UpdateStatus(func_status);
+            refcounted->Unref();
+          });
     }
 
     // Unref 1 because refcounted is initialized with refcount = 1
@@ -124,9 +145,23 @@ class MapDefunOp : public AsyncOpKernel {
   }
 
  private:
+  class MapFunctionCallFrame;
+
+  NameAttrList func_;
   FunctionLibraryRuntime::Handle func_handle_;
   std::vector<PartialTensorShape> output_shapes_;
 
+  mutex mu_;
+  // Lazily computed by `TryShortCircuit`. When `short_circuit_indices_` is
+  // non-empty, output `i` of the function is its input
+  // `short_circuit_indices_[i]`.
+  bool short_circuit_computed_ GUARDED_BY(mu_) = false;
+  std::vector<int> short_circuit_indices_ GUARDED_BY(mu_);
+  // Call frames kept for reuse across `ComputeAsync` invocations to avoid
+  // one allocation per batch element.
+  std::vector<std::unique_ptr<MapFunctionCallFrame>> frame_pool_
+      GUARDED_BY(mu_);
+
   struct ComputeOptions {
     // These vary per MapDefunOp::ComputeAsync call, but must persist until
     // all calls to the function are complete. This struct also encapsulates
@@ -206,6 +241,103 @@ class MapDefunOp : public AsyncOpKernel {
     return Status::OK();
   }
 
+  // Sets `*handled` to true and produces all outputs directly from the
+  // batched inputs when every function output is one of its inputs (e.g.
+  // `f(x, y) = (y, x)`). Batched arguments are forwarded whole; captured
+  // inputs are tiled along the new leading dimension.
+  Status TryShortCircuit(OpKernelContext* ctx, ComputeOptions* opts,
+                         bool* handled) {
+    *handled = false;
+    std::vector<int> indices;
+    {
+      mutex_lock l(mu_);
+      if (!short_circuit_computed_) {
+        TF_RETURN_IF_ERROR(
+            ComputeShortCircuitIndices(ctx, func_, &short_circuit_indices_));
+        short_circuit_computed_ = true;
+      }
+      if (short_circuit_indices_.empty()) {
+        return Status::OK();
+      }
+      indices = short_circuit_indices_;
+    }
+
+    OpOutputList output;
+    TF_RETURN_IF_ERROR(ctx->output_list("output", &output));
+    const int num_args = opts->args.size();
+    for (size_t i = 0; i < indices.size(); ++i) {
+      const int index = indices[i];
+      if (index < 0 ||
+          index >= num_args + static_cast<int>(opts->captured_inputs.size())) {
+        return errors::Internal("Short-circuit index ", index,
+                                " is out of range.");
+      }
+      if (index < num_args) {
+        const Tensor& batched = opts->args[index];
+        if (batched.dtype() != output_type(i)) {
+          return errors::InvalidArgument(
+              "Mismatch in function return type and expected output type "
+              "for output: ",
+              i);
+        }
+        TensorShape element_shape = batched.shape();
+        element_shape.RemoveDim(0);
+        if (!output_shapes_.at(i).IsCompatibleWith(element_shape)) {
+          return errors::InvalidArgument(
+              "Mismatch in function retval shape, ",
+              element_shape.DebugString(), ", and expected output shape, ",
+              output_shapes_.at(i).DebugString(), ".");
+        }
+        output.set(i, batched);
+      } else {
+        const Tensor& captured = opts->captured_inputs[index - num_args];
+        if (captured.dtype() != output_type(i)) {
+          return errors::InvalidArgument(
+              "Mismatch in function return type and expected output type "
+              "for output: ",
+              i);
+        }
+        if (!output_shapes_.at(i).IsCompatibleWith(captured.shape())) {
+          return errors::InvalidArgument(
+              "Mismatch in function retval shape, ",
+              captured.shape().DebugString(), ", and expected output shape, ",
+              output_shapes_.at(i).DebugString(), ".");
+        }
+        Tensor* out = nullptr;
+        TensorShape out_shape = captured.shape();
+        out_shape.InsertDim(0, opts->batch_size);
+        TF_RETURN_IF_ERROR(output.allocate(i, out_shape, &out));
+        for (int64 b = 0; b < opts->batch_size; ++b) {
+          TF_RETURN_IF_ERROR(batch_util::CopyElementToSlice(captured, out, b));
+        }
+      }
+    }
+    *handled = true;
+    return Status::OK();
+  }
+
+  std::unique_ptr<MapFunctionCallFrame> BorrowCallFrame(ComputeOptions* opts,
+                                                        size_t iter) {
+    {
+      mutex_lock l(mu_);
+      if (!frame_pool_.empty()) {
+        std::unique_ptr<MapFunctionCallFrame> frame =
+            std::move(frame_pool_.back());
+        frame_pool_.pop_back();
+        frame->Reset(opts, iter);
+        return frame;
+      }
+    }
+    return absl::make_unique<MapFunctionCallFrame>(opts, this, iter);
+  }
+
+  void ReturnCallFrame(std::unique_ptr<MapFunctionCallFrame> frame) {
+    mutex_lock l(mu_);
+    if (frame_pool_.size() < kMaxPooledCallFrames) {
+      frame_pool_.push_back(std::move(frame));
+    }
+  }
+
   class MapFunctionCallFrame : public CallFrameInterface {
    public:
     MapFunctionCallFrame(ComputeOptions* compute_opts, OpKernel* kernel,
@@ -214,6 +346,12 @@ class MapDefunOp : public AsyncOpKernel {
 
     ~MapFunctionCallFrame() override {}
 
+    // Re-targets a pooled frame at a new compute call and batch element.
+    void Reset(ComputeOptions* compute_opts, size_t iter) {
+      compute_opts_ = compute_opts;
+      iter_ = iter;
+    }
+
     size_t num_args() const override { return compute_opts_->args.size(); }
 
     size_t num_retvals() const override {
@@ -285,9 +423,9 @@ class MapDefunOp : public AsyncOpKernel {
     }
 
    private:
-    ComputeOptions* const compute_opts_;  // Not owned
+    ComputeOptions* compute_opts_;  // Not owned
     const OpKernel* kernel_;
-    const size_t iter_;
+    size_t iter_;
   };
 };
 
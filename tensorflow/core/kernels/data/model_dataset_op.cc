@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/ptr_util.h"
 
 namespace tensorflow {
@@ -28,6 +29,19 @@ namespace {
 
 constexpr int kOptimizationPeriodThresholdMs = 60 * EnvTime::kSecondsToMicros;
 
+// Whether autotuning should be delegated to the process-wide coordinator,
+// which arbitrates the CPU budget across all pipelines in the process, rather
+// than tuning each pipeline against the full machine in its own thread.
+bool SharedAutotuneEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_SHARED_AUTOTUNE",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
 class ModelDatasetOp : public UnaryDatasetOpKernel {
  public:
   explicit ModelDatasetOp(OpKernelConstruction* ctx)
@@ -92,6 +106,9 @@ class ModelDatasetOp : public UnaryDatasetOpKernel {
         mutex_lock l(mu_);
         cancelled_ = true;
         cond_var_.notify_all();
+        if (registered_) {
+          model::ModelCoordinator::Global()->Unregister(model_);
+        }
       }
 
       Status Initialize(IteratorContext* ctx) override {
@@ -137,6 +154,13 @@ class ModelDatasetOp : public UnaryDatasetOpKernel {
      private:
       Status EnsureOptimizeThreadStarted(IteratorContext* ctx)
           EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (SharedAutotuneEnabled()) {
+          if (!registered_) {
+            model::ModelCoordinator::Global()->Register(model_);
+            registered_ = true;
+          }
+          return Status::OK();
+        }
         if (!optimize_thread_) {
           std::shared_ptr<IteratorContext> new_ctx =
               std::make_shared<IteratorContext>(*ctx);
@@ -183,6 +207,7 @@ class ModelDatasetOp : public UnaryDatasetOpKernel {
       std::shared_ptr<model::Model> model_;
       std::unique_ptr<Thread> optimize_thread_ GUARDED_BY(mu_);
       bool cancelled_ GUARDED_BY(mu_) = false;
+      bool registered_ GUARDED_BY(mu_) = false;
       std::unique_ptr<IteratorBase> input_impl_;
     };
 
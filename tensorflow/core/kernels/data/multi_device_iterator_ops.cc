@@ -14,17 +14,22 @@ limitations under the License.
 ==============================================================================*/
 #include <deque>
 
+#include "tensorflow/core/common_runtime/device.h"
+#include "tensorflow/core/common_runtime/device_mgr.h"
 #include "tensorflow/core/common_runtime/process_function_library_runtime.h"
 #include "tensorflow/core/framework/dataset.h"
 #include "tensorflow/core/framework/function.h"
 #include "tensorflow/core/framework/function_handle_cache.h"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/resource_op_kernel.h"
+#include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/data/dataset_utils.h"
 #include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/util/device_name_utils.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -34,11 +39,124 @@ struct HostBufferElement {
   Status status;
   bool end_of_sequence;
   std::vector<Tensor> value;
+  // True iff 'value' has been staged into the memory of the shard's target
+  // device by the background thread.
+  bool value_on_device = false;
 };
 
 using MultiDeviceIteratorCallback =
     std::function<void(const HostBufferElement&)>;
 
+// Experimental: eagerly stage each shard's elements into its target
+// device's memory from the background thread, so the H2D copy runs on the
+// device's copy stream and overlaps compute instead of happening
+// synchronously inside the training step.  Requires the
+// MultiDeviceIteratorGetNextFromShard ops to be placed on the target
+// devices.
+bool StagePrefetchToDeviceEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_MULTI_DEVICE_PREFETCH_TO_DEVICE",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Returns true if every tensor in 'value' can live in device memory.
+bool ElementCanBeStaged(const std::vector<Tensor>& value) {
+  for (const Tensor& t : value) {
+    if (!DataTypeCanUseMemcpy(t.dtype())) return false;
+  }
+  return true;
+}
+
+// Copies 'elem's tensors into 'device's memory via the device's
+// DeviceContext (on GPU, the dedicated host-to-device copy stream),
+// blocking until the copies complete.  On success 'elem' holds the device
+// tensors; on failure it is left unchanged so the caller can fall back to
+// delivering host tensors.
+Status CopyElementToDevice(Device* device, HostBufferElement* elem) {
+  const DeviceBase::GpuDeviceInfo* info = device->tensorflow_gpu_device_info();
+  if (info == nullptr || info->default_context == nullptr) {
+    return errors::Internal("Device ", device->name(),
+                            " does not support tensor staging");
+  }
+  Allocator* allocator = device->GetAllocator(AllocatorAttributes());
+  std::vector<Tensor> device_value(elem->value.size());
+  for (size_t i = 0; i < elem->value.size(); ++i) {
+    const Tensor& host_tensor = elem->value[i];
+    Tensor copy(allocator, host_tensor.dtype(), host_tensor.shape());
+    if (!copy.IsInitialized()) {
+      return errors::ResourceExhausted(
+          "Failed to allocate device memory to stage tensor of shape ",
+          host_tensor.shape().DebugString());
+    }
+    Notification done;
+    Status copy_status;
+    info->default_context->CopyCPUTensorToDevice(
+        &host_tensor, device, &copy, [&done, &copy_status](const Status& s) {
+          copy_status = s;
+          done.Notify();
+        });
+    done.WaitForNotification();
+    TF_RETURN_IF_ERROR(copy_status);
+    device_value[i] = std::move(copy);
+  }
+  elem->value = std::move(device_value);
+  elem->value_on_device = true;
+  return Status::OK();
+}
+
+// Emits 'elem's tensors as the outputs of a GetNextFromShard kernel,
+// copying host tensors to the op's device when the kernel is placed on a
+// GPU.  Device-staged tensors are emitted without a copy; they were staged
+// on the shard's target device, which is where the per-shard kernel runs.
+Status ProduceGetNextOutputs(OpKernelContext* ctx,
+                             const HostBufferElement& elem) {
+  DeviceContext* device_ctx = ctx->op_device_context();
+  if (device_ctx == nullptr) {
+    // Host-placed kernel.
+    if (elem.value_on_device) {
+      return errors::Internal(
+          "Received a device-staged element on a host-placed "
+          "MultiDeviceIteratorGetNextFromShard kernel; unset "
+          "TF_DATA_MULTI_DEVICE_PREFETCH_TO_DEVICE or place the op on the "
+          "target device.");
+    }
+    for (size_t i = 0; i < elem.value.size(); ++i) {
+      ctx->set_output(i, elem.value[i]);
+    }
+    return Status::OK();
+  }
+  Device* device = static_cast<Device*>(ctx->device());
+  for (size_t i = 0; i < elem.value.size(); ++i) {
+    const Tensor& t = elem.value[i];
+    if (elem.value_on_device) {
+      ctx->set_output(i, t);
+      continue;
+    }
+    if (!DataTypeCanUseMemcpy(t.dtype())) {
+      return errors::InvalidArgument(
+          "Cannot copy dataset element of type ", DataTypeString(t.dtype()),
+          " to a ", device->device_type(),
+          " device; place MultiDeviceIteratorGetNextFromShard on the CPU");
+    }
+    Tensor* output = nullptr;
+    TF_RETURN_IF_ERROR(ctx->allocate_output(i, t.shape(), &output));
+    Notification done;
+    Status copy_status;
+    device_ctx->CopyCPUTensorToDevice(
+        &t, device, output, [&done, &copy_status](const Status& s) {
+          copy_status = s;
+          done.Notify();
+        });
+    done.WaitForNotification();
+    TF_RETURN_IF_ERROR(copy_status);
+  }
+  return Status::OK();
+}
+
 class MultiDeviceIterator : public ResourceBase {
  public:
   MultiDeviceIterator(
@@ -81,8 +199,23 @@ class MultiDeviceIterator : public ResourceBase {
     ++incarnation_id_;
     *incarnation_id = incarnation_id_;
 
+    // When device staging is enabled, resolve each shard's target device so
+    // the background thread can copy elements into device memory eagerly.
+    // Shards whose device cannot stage tensors (e.g. CPU) keep host buffers.
+    std::vector<Device*> shard_devices(devices_.size(), nullptr);
+    if (StagePrefetchToDeviceEnabled() && lib_->device_mgr() != nullptr) {
+      for (size_t i = 0; i < devices_.size(); ++i) {
+        Device* device;
+        if (lib_->device_mgr()->LookupDevice(devices_[i], &device).ok() &&
+            device->tensorflow_gpu_device_info() != nullptr) {
+          shard_devices[i] = device;
+        }
+      }
+    }
+
     multi_device_buffer_ = absl::make_unique<MultiDeviceBuffer>(
-        devices_.size(), max_buffer_size, incarnation_id_, std::move(iterator));
+        devices_.size(), max_buffer_size, incarnation_id_, std::move(iterator),
+        std::move(shard_devices));
     return Status::OK();
   }
 
@@ -133,12 +266,14 @@ class MultiDeviceIterator : public ResourceBase {
   class MultiDeviceBuffer {
    public:
     MultiDeviceBuffer(size_t size, int64 max_buffer_size, int64 incarnation_id,
-                      std::unique_ptr<IteratorBase> host_iterator)
+                      std::unique_ptr<IteratorBase> host_iterator,
+                      std::vector<Device*> shard_devices)
         : buffer_(size),
           size_(size),
           max_buffer_size_(max_buffer_size),
           incarnation_id_(incarnation_id),
-          host_iterator_(std::move(host_iterator)) {}
+          host_iterator_(std::move(host_iterator)),
+          shard_devices_(std::move(shard_devices)) {}
 
     ~MultiDeviceBuffer() {
       {
@@ -290,6 +425,21 @@ class MultiDeviceIterator : public ResourceBase {
           end_of_iterator = true;
         }
 
+        // Eagerly stage the element on the shard's target device, so the
+        // H2D copy overlaps compute rather than delaying the consuming
+        // step.  On failure fall back to delivering the host tensors.
+        if (elem.status.ok() && !elem.end_of_sequence &&
+            shard_devices_[shard_to_fetch] != nullptr &&
+            ElementCanBeStaged(elem.value)) {
+          Status copy_status =
+              CopyElementToDevice(shard_devices_[shard_to_fetch], &elem);
+          if (!copy_status.ok()) {
+            LOG(WARNING) << "Failed to stage dataset element on "
+                         << shard_devices_[shard_to_fetch]->name() << ": "
+                         << copy_status;
+          }
+        }
+
         {
           mutex_lock l(mu_);
           // Try to find a callback, else just push stuff into buffer.
@@ -342,6 +492,9 @@ class MultiDeviceIterator : public ResourceBase {
     const int64 max_buffer_size_;
     const int64 incarnation_id_;
     const std::unique_ptr<IteratorBase> host_iterator_;
+    // Per-shard target devices for eager staging; nullptr entries keep the
+    // corresponding shard's elements in host memory.  Not owned.
+    const std::vector<Device*> shard_devices_;
   };
 
   mutex mu_;
@@ -549,8 +702,9 @@ class MultiDeviceIteratorGetNextFromShardOp : public AsyncOpKernel {
                 } else if (elem.end_of_sequence) {
                   ctx->SetStatus(errors::OutOfRange("End of sequence"));
                 } else {
-                  for (int i = 0; i < elem.value.size(); ++i) {
-                    ctx->set_output(i, elem.value[i]);
+                  s = ProduceGetNextOutputs(ctx, elem);
+                  if (!s.ok()) {
+                    ctx->SetStatus(s);
                   }
                 }
                 done();
@@ -571,9 +725,17 @@ class MultiDeviceIteratorGetNextFromShardOp : public AsyncOpKernel {
   BackgroundWorker background_worker_;
 };
 
-REGISTER_KERNEL_BUILDER(
-    Name("MultiDeviceIteratorGetNextFromShard").Device(DEVICE_CPU),
-    MultiDeviceIteratorGetNextFromShardOp);
+REGISTER_KERNEL_BUILDER(Name("MultiDeviceIteratorGetNextFromShard")
+                            .Device(DEVICE_CPU)
+                            .Priority(2),
+                        MultiDeviceIteratorGetNextFromShardOp);
+REGISTER_KERNEL_BUILDER(Name("MultiDeviceIteratorGetNextFromShard")
+                            .Device(DEVICE_GPU)
+                            .HostMemory("multi_device_iterator")
+                            .HostMemory("shard_num")
+                            .HostMemory("incarnation_id")
+                            .Priority(1),
+                        MultiDeviceIteratorGetNextFromShardOp);
 
 class MultiDeviceIteratorToStringHandleOp : public OpKernel {
  public:
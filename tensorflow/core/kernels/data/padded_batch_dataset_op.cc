@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_util.h"
+#include "tensorflow/core/kernels/data/batch_copy_util.h"
 #include "tensorflow/core/util/batch_util.h"
 
 namespace tensorflow {
@@ -330,14 +331,28 @@ class PaddedBatchDatasetOp : public UnaryDatasetOpKernel {
           for (int i = 1; i < batch_component_shape.dims(); ++i) {
             component_shape.AddDim(batch_component_shape.dim_size(i));
           }
-          for (int64 i = 0; i < num_batch_elements; ++i) {
+          auto copy_element_fn = [&batch_elements, &batch_component,
+                                  &component_shape,
+                                  component_index](int64 index) {
             // Take the fast path if possible.
-            if (batch_elements[i][component_index].shape() == component_shape) {
-              TF_RETURN_IF_ERROR(batch_util::CopyElementToSlice(
-                  batch_elements[i][component_index], &batch_component, i));
-            } else {
-              TF_RETURN_IF_ERROR(batch_util::CopyElementToLargerSlice(
-                  batch_elements[i][component_index], &batch_component, i));
+            if (batch_elements[index][component_index].shape() ==
+                component_shape) {
+              return batch_util::CopyElementToSlice(
+                  batch_elements[index][component_index], &batch_component,
+                  index);
+            }
+            return batch_util::CopyElementToLargerSlice(
+                batch_elements[index][component_index], &batch_component,
+                index);
+          };
+          if (ParallelBatchCopyEnabled()) {
+            TF_RETURN_IF_ERROR(ParallelCopyBatchElements(
+                ctx, num_batch_elements,
+                batch_component.AllocatedBytes() / num_batch_elements,
+                copy_element_fn));
+          } else {
+            for (int64 i = 0; i < num_batch_elements; ++i) {
+              TF_RETURN_IF_ERROR(copy_element_fn(i));
             }
           }
         }
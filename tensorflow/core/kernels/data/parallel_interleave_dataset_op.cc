@@ -30,6 +30,7 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -37,6 +38,21 @@ namespace {
 
 constexpr char kDatasetName[] = "ParallelInterleaveV2";
 
+// Per-source readahead depth for interleaved inputs. When positive, worker
+// threads keep up to this many results buffered for every cycle element
+// instead of at most `block_length`, hiding the latency of slow storage
+// (e.g. GCS) behind concurrent reads across sources. The interleave order of
+// consumed elements is unaffected.
+int64 PerElementPrefetchDepth() {
+  static int64 result = [] {
+    int64 depth;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_INTERLEAVE_PREFETCH_DEPTH",
+                                    /*default_val=*/0, &depth));
+    return depth;
+  }();
+  return result;
+}
+
 // See documentation in ../../ops/dataset_ops.cc for a high-level
 // description of the following op.
 
@@ -343,6 +359,16 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
         bool in_use = false;
       };
 
+      // Returns the number of results to keep buffered for each cycle
+      // element. Defaults to `block_length`, so that by the time the cycle
+      // reaches an element a full block is typically ready; a deeper
+      // per-source readahead can be requested via
+      // TF_DATA_INTERLEAVE_PREFETCH_DEPTH.
+      int64 ElementBufferDepth() const {
+        const int64 depth = PerElementPrefetchDepth();
+        return depth > 0 ? depth : dataset()->block_length_;
+      }
+
       // Advances the position in the interleave cycle to the next cycle
       // element.
       void AdvanceToNextInCycle() EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
@@ -438,7 +464,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
         auto busy = [this]() EXCLUSIVE_LOCKS_REQUIRED(*mu_) -> bool {
           const bool has_more_elements =
               !future_elements_.empty() || !end_of_input_;
-          const int block_length = dataset()->block_length_;
+          const int64 buffer_depth = ElementBufferDepth();
           bool all_elements_busy = true;
           for (auto& element : current_elements_) {
             if (!element) {
@@ -449,7 +475,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
             } else {
               mutex_lock l(element->mu);
               if (!element->in_use && element->iterator &&
-                  element->results.size() < block_length) {
+                  element->results.size() < buffer_depth) {
                 all_elements_busy = false;
                 break;
               }
@@ -491,8 +517,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
               int64 num_results;
               {
                 mutex_lock l(element->mu);
-                num_results =
-                    dataset()->block_length_ - element->results.size();
+                num_results = ElementBufferDepth() - element->results.size();
               }
               if (num_results > 0) {
                 num_calls_++;
@@ -532,7 +557,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
         }
       }
 
-      // Fetches up to `dataset()->block_length_` results from `element`.
+      // Fetches up to `num_results` results from `element`.
       void FetchResults(const std::shared_ptr<IteratorContext>& ctx,
                         const std::shared_ptr<Element>& element,
                         int64 num_results) LOCKS_EXCLUDED(*mu_) {
@@ -615,7 +640,7 @@ class ParallelInterleaveDatasetOp : public UnaryDatasetOpKernel {
             element->in_use = true;
             thread_pool_->Schedule(
                 std::bind(&ParallelInterleaveIterator::FetchResults, this, ctx,
-                          std::move(element), dataset()->block_length_));
+                          std::move(element), ElementBufferDepth()));
           }
           const auto& stats_aggregator = ctx->stats_aggregator();
           if (stats_aggregator) {
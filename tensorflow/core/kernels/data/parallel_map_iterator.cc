@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/kernels/data/parallel_map_iterator.h"
 
+#include <algorithm>
 #include <atomic>
 #include <deque>
 #include <functional>
@@ -22,13 +23,30 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/core/framework/stats_aggregator.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/cleanup.h"
 #include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
 namespace {
 
+// Returns true if map function invocations should run on a thread pool that
+// is private to the iterator instead of the shared runner pool.  The private
+// pool (a work-stealing Eigen pool, like all thread::ThreadPools) keeps map
+// calls from queueing behind unrelated long-running work, so one straggling
+// element does not hold up the scheduling of its successors.
+bool UsePrivateThreadPool() {
+  static bool use_private_pool = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_DATA_PARALLEL_MAP_PRIVATE_THREADPOOL",
+                                   false, &enabled));
+    return enabled;
+  }();
+  return use_private_pool;
+}
+
 class ParallelMapIterator : public DatasetBaseIterator {
  public:
   struct Params {
@@ -78,6 +96,12 @@ class ParallelMapIterator : public DatasetBaseIterator {
     if (num_parallel_calls_->value == model::kAutoTune) {
       num_parallel_calls_->value = ctx->runner_threadpool_size();
     }
+    if (UsePrivateThreadPool()) {
+      thread_pool_.reset(new thread::ThreadPool(
+          ctx->env(), ThreadOptions(), "tf_data_parallel_map",
+          std::max<int64>(1, num_parallel_calls_->value),
+          /*low_latency_hint=*/false));
+    }
     TF_RETURN_IF_ERROR(
         input_dataset_->MakeIterator(ctx, prefix(), &input_impl_));
     return parallel_map_functor_->InitFunc(ctx);
@@ -191,7 +215,21 @@ class ParallelMapIterator : public DatasetBaseIterator {
   void EnsureRunnerThreadStarted(IteratorContext* ctx)
       EXCLUSIVE_LOCKS_REQUIRED(*mu_) {
     if (!runner_thread_) {
-      auto ctx_copy = std::make_shared<IteratorContext>(*ctx);
+      std::shared_ptr<IteratorContext> ctx_copy;
+      if (thread_pool_) {
+        // Run map function invocations on the private pool rather than the
+        // shared runner so that they cannot queue behind (or be starved by)
+        // unrelated work scheduled on the shared pool.
+        IteratorContext::Params params(ctx);
+        thread::ThreadPool* pool = thread_pool_.get();
+        params.runner = [pool](std::function<void()> fn) {
+          pool->Schedule(std::move(fn));
+        };
+        params.runner_threadpool_size = pool->NumThreads();
+        ctx_copy = std::make_shared<IteratorContext>(std::move(params));
+      } else {
+        ctx_copy = std::make_shared<IteratorContext>(*ctx);
+      }
       runner_thread_.reset(ctx->env()->StartThread(
           {}, "tf_data_parallel_map",
           std::bind(&ParallelMapIterator::RunnerThread, this, ctx_copy)));
@@ -397,6 +435,10 @@ class ParallelMapIterator : public DatasetBaseIterator {
   // Buffer for storing the invocation results.
   std::deque<std::shared_ptr<InvocationResult>> invocation_results_
       GUARDED_BY(*mu_);
+  // Optional pool for running map function invocations; see
+  // `UsePrivateThreadPool()`. Destroyed after the destructor has waited for
+  // all in-flight calls to complete.
+  std::unique_ptr<thread::ThreadPool> thread_pool_;
   std::unique_ptr<Thread> runner_thread_ GUARDED_BY(*mu_);
   bool cancelled_ GUARDED_BY(*mu_) = false;
   string key_prefix_;
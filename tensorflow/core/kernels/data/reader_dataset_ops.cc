@@ -18,10 +18,12 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
+#include "tensorflow/core/lib/io/memory_region_file.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
 #include "tensorflow/core/lib/io/record_reader.h"
 #include "tensorflow/core/lib/io/zlib_compression_options.h"
 #include "tensorflow/core/lib/io/zlib_inputstream.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -30,6 +32,21 @@ namespace {
 // See documentation in ../../ops/dataset_ops.cc for a high-level
 // description of the following ops.
 
+// Returns true if uncompressed TFRecord files should be read through a
+// memory-mapped region instead of buffered read() calls.  Mapped reads hand
+// RecordReader views directly into the page cache, eliminating the read
+// syscalls and the copy into the read buffer.  Opt-in because mapping is
+// only a win for local files that are (or will be) resident in memory.
+bool TFRecordUseMmap() {
+  static bool use_mmap = [] {
+    bool enabled = false;
+    TF_CHECK_OK(
+        ReadBoolFromEnvVar("TF_DATA_TFRECORD_USE_MMAP", false, &enabled));
+    return enabled;
+  }();
+  return use_mmap;
+}
+
 constexpr char kTextLineDatasetName[] = "TextLine";
 
 class TextLineDatasetOp : public DatasetOpKernel {
@@ -915,6 +932,26 @@ class TFRecordDatasetOp : public DatasetOpKernel {
         // Actually move on to next file.
         const string& next_filename =
             dataset()->filenames_[current_file_index_];
+        if (TFRecordUseMmap() && dataset()->compression_type_.empty()) {
+          std::unique_ptr<ReadOnlyMemoryRegion> region;
+          Status s = env->NewReadOnlyMemoryRegionFromFile(next_filename,
+                                                          &region);
+          if (s.ok()) {
+            file_ = absl::make_unique<io::MemoryRegionRandomAccessFile>(
+                std::move(region));
+            // Reads are already served out of the mapped region, so
+            // buffering would only add a copy.
+            io::RecordReaderOptions options = dataset()->options_;
+            options.buffer_size = 0;
+            reader_ = absl::make_unique<io::SequentialRecordReader>(file_.get(),
+                                                                    options);
+            return Status::OK();
+          }
+          // Not every file system supports memory mapping (e.g. remote
+          // object stores); fall back to the regular read path.
+          VLOG(1) << "Could not memory-map " << next_filename << ": " << s
+                  << "; falling back to buffered reads.";
+        }
         TF_RETURN_IF_ERROR(env->NewRandomAccessFile(next_filename, &file_));
         reader_ = absl::make_unique<io::SequentialRecordReader>(
             file_.get(), dataset()->options_);
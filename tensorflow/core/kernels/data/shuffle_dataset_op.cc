@@ -20,9 +20,15 @@ limitations under the License.
 #include "tensorflow/core/framework/partial_tensor_shape.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor.pb.h"
+#include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/lib/io/record_reader.h"
+#include "tensorflow/core/lib/io/record_writer.h"
 #include "tensorflow/core/lib/random/philox_random.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
+#include "tensorflow/core/protobuf/data/experimental/snapshot.pb.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace data {
@@ -32,6 +38,47 @@ const int64 kLogIntervalMicros = 10 * 1000000;  // 10 seconds.
 
 const int64 kMaxEpochsInBuffer = 3;
 
+// When TF_DATA_EXTERNAL_SHUFFLE_DIR is set, shuffling is performed as an
+// external (spill-to-disk) shuffle instead of an in-memory buffer: every
+// input element is appended to one of TF_DATA_EXTERNAL_SHUFFLE_NUM_BUCKETS
+// sequentially-written spill files chosen uniformly at random, and buckets
+// are then read back one at a time and shuffled in memory. Since the bucket
+// assignment is a uniform multinomial split and each bucket is permuted
+// uniformly, the emitted order is a uniform random permutation of the whole
+// input, at a constant RAM footprint of roughly one bucket.
+const string& ExternalShuffleDir() {
+  static const string* dir = [] {
+    string result;
+    TF_CHECK_OK(
+        ReadStringFromEnvVar("TF_DATA_EXTERNAL_SHUFFLE_DIR", "", &result));
+    return new string(result);
+  }();
+  return *dir;
+}
+
+int64 ExternalShuffleNumBuckets() {
+  static const int64 num_buckets = [] {
+    int64 result;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_EXTERNAL_SHUFFLE_NUM_BUCKETS",
+                                    128, &result));
+    return std::max<int64>(1, result);
+  }();
+  return num_buckets;
+}
+
+// In-memory budget (in bytes) for the read-back phase. The next bucket is
+// prefetched from disk in the background only when it fits in the budget
+// alongside the bucket currently being drained.
+int64 ExternalShuffleMemoryBudget() {
+  static const int64 budget = [] {
+    int64 result;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_DATA_EXTERNAL_SHUFFLE_MEMORY_BUDGET",
+                                    1LL << 30, &result));
+    return result;
+  }();
+  return budget;
+}
+
 // See documentation in ../../ops/dataset_ops.cc for a high-level
 // description of the following op.
 
@@ -84,10 +131,27 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         slices_.push_back(absl::make_unique<Slice>(0, 0));
       }
 
+      ~Iterator() override {
+        // Wait for an in-flight bucket prefetch before tearing down.
+        prefetch_thread_.reset();
+        if (!spill_dir_.empty()) {
+          int64 undeleted_files, undeleted_dirs;
+          Status s = Env::Default()->DeleteRecursively(
+              spill_dir_, &undeleted_files, &undeleted_dirs);
+          if (!s.ok()) {
+            LOG(WARNING) << "Failed to delete shuffle spill directory "
+                         << spill_dir_ << ": " << s;
+          }
+        }
+      }
+
       Status GetNextInternal(IteratorContext* ctx,
                              std::vector<Tensor>* out_tensors,
                              bool* end_of_sequence) override {
         mutex_lock l(mu_);
+        if (ExternalShuffleActive()) {
+          return ExternalGetNext(ctx, out_tensors, end_of_sequence);
+        }
         int64 start_micros = ctx->env()->NowMicros();
         int64 num_log_entries = 0;
         bool first_call = false;
@@ -195,6 +259,11 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
 
       Status SaveInternal(IteratorStateWriter* writer) override {
         mutex_lock l(mu_);
+        if (ExternalShuffleActive()) {
+          return errors::Unimplemented(
+              "Checkpointing is not supported while an external shuffle "
+              "spill is in use.");
+        }
         // Save state needed to restore the random number generators.
         TF_RETURN_IF_ERROR(writer->WriteScalar(
             this->full_name("num_random_samples"), num_random_samples_));
@@ -244,6 +313,11 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
       Status RestoreInternal(IteratorContext* ctx,
                              IteratorStateReader* reader) override {
         mutex_lock l(mu_);
+        if (ExternalShuffleActive()) {
+          return errors::Unimplemented(
+              "Checkpointing is not supported while an external shuffle "
+              "spill is in use.");
+        }
         // Restore the random number generators.
         TF_RETURN_IF_ERROR(reader->ReadScalar(
             this->full_name("num_random_samples"), &num_random_samples_));
@@ -325,6 +399,219 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
         return out;
       }
 
+      // Whether this iterator should spill to disk instead of buffering in
+      // memory. Multiple epochs worth of elements cannot share one spill,
+      // so `count_ != 1` falls back to the in-memory shuffle.
+      bool ExternalShuffleActive() EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (ExternalShuffleDir().empty()) {
+          return false;
+        }
+        if (this->dataset()->count_ != 1) {
+          if (!warned_external_unsupported_) {
+            warned_external_unsupported_ = true;
+            LOG(WARNING) << "TF_DATA_EXTERNAL_SHUFFLE_DIR is set, but the "
+                         << "external shuffle only supports a repeat count "
+                         << "of 1; falling back to the in-memory shuffle.";
+          }
+          return false;
+        }
+        return true;
+      }
+
+      Status ExternalGetNext(IteratorContext* ctx,
+                             std::vector<Tensor>* out_tensors,
+                             bool* end_of_sequence)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        if (!spilled_) {
+          TF_RETURN_IF_ERROR(SpillToBuckets(ctx));
+          spilled_ = true;
+        }
+        while (bucket_index_ >= bucket_elements_.size()) {
+          if (next_bucket_to_load_ >= num_buckets_) {
+            *end_of_sequence = true;
+            return Status::OK();
+          }
+          TF_RETURN_IF_ERROR(NextBucket(ctx->env()));
+        }
+        *out_tensors = std::move(bucket_elements_[bucket_index_++]);
+        *end_of_sequence = false;
+        return Status::OK();
+      }
+
+      // Drains the input, appending each element to a uniformly random
+      // bucket's spill file. One RNG draw is consumed per input element, so
+      // the assignment is deterministic for a given seed pair.
+      Status SpillToBuckets(IteratorContext* ctx)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        Env* env = ctx->env();
+        num_buckets_ = ExternalShuffleNumBuckets();
+        spill_dir_ = io::JoinPath(
+            ExternalShuffleDir(),
+            strings::StrCat("tf_data_shuffle_", random::New64()));
+        TF_RETURN_IF_ERROR(env->RecursivelyCreateDir(spill_dir_));
+        std::vector<std::unique_ptr<WritableFile>> files(num_buckets_);
+        std::vector<std::unique_ptr<io::RecordWriter>> writers(num_buckets_);
+        for (int64 b = 0; b < num_buckets_; ++b) {
+          TF_RETURN_IF_ERROR(
+              env->NewWritableFile(BucketFilename(b), &files[b]));
+          writers[b] = absl::make_unique<io::RecordWriter>(files[b].get());
+        }
+        bucket_bytes_.assign(num_buckets_, 0);
+        TF_RETURN_IF_ERROR(this->dataset()->input_->MakeIterator(
+            ctx, this->prefix(), &input_impl_));
+        int64 start_micros = env->NowMicros();
+        int64 num_log_entries = 0;
+        int64 num_spilled = 0;
+        while (true) {
+          if (env->NowMicros() >
+              ((num_log_entries + 1) * kLogIntervalMicros) + start_micros) {
+            num_log_entries++;
+            LOG(INFO) << "Spilling shuffle buckets (this may take a while): "
+                      << num_spilled << " elements";
+          }
+          std::vector<Tensor> element;
+          bool end_of_input = false;
+          TF_RETURN_IF_ERROR(
+              input_impl_->GetNext(ctx, &element, &end_of_input));
+          if (end_of_input) {
+            break;
+          }
+          // The spill reuses the snapshot element record format.
+          experimental::SnapshotRecord record;
+          for (const Tensor& tensor : element) {
+            tensor.AsProtoTensorContent(record.add_tensors());
+          }
+          const int64 bucket = Random() % num_buckets_;
+          string serialized = record.SerializeAsString();
+          TF_RETURN_IF_ERROR(writers[bucket]->WriteRecord(serialized));
+          bucket_bytes_[bucket] += serialized.size();
+          ++num_spilled;
+        }
+        input_impl_.reset();
+        int64 max_bucket_bytes = 0;
+        for (int64 b = 0; b < num_buckets_; ++b) {
+          TF_RETURN_IF_ERROR(writers[b]->Close());
+          TF_RETURN_IF_ERROR(files[b]->Close());
+          max_bucket_bytes = std::max(max_bucket_bytes, bucket_bytes_[b]);
+        }
+        if (max_bucket_bytes > ExternalShuffleMemoryBudget()) {
+          LOG(WARNING) << "The largest shuffle spill bucket holds "
+                       << max_bucket_bytes << " bytes, which is above the "
+                       << "memory budget of " << ExternalShuffleMemoryBudget()
+                       << "; consider raising "
+                       << "TF_DATA_EXTERNAL_SHUFFLE_NUM_BUCKETS.";
+        }
+        if (num_log_entries > 0) {
+          LOG(INFO) << "Shuffle spill finished: " << num_spilled
+                    << " elements in " << num_buckets_ << " buckets.";
+        }
+        return Status::OK();
+      }
+
+      string BucketFilename(int64 bucket) const {
+        return io::JoinPath(spill_dir_, strings::StrCat("bucket-", bucket));
+      }
+
+      // Reads one bucket's spill file back into memory. Called both from
+      // the iterator thread and from the prefetch thread; it only touches
+      // `spill_dir_`, which is constant once the spill has been written.
+      Status LoadBucket(Env* env, int64 bucket,
+                        std::vector<std::vector<Tensor>>* out) {
+        std::unique_ptr<RandomAccessFile> file;
+        TF_RETURN_IF_ERROR(
+            env->NewRandomAccessFile(BucketFilename(bucket), &file));
+        io::SequentialRecordReader reader(file.get());
+        while (true) {
+          string record_bytes;
+          Status s = reader.ReadRecord(&record_bytes);
+          if (errors::IsOutOfRange(s)) {
+            return Status::OK();
+          }
+          TF_RETURN_IF_ERROR(s);
+          experimental::SnapshotRecord record;
+          if (!record.ParseFromString(record_bytes)) {
+            return errors::DataLoss(
+                "Unable to parse spilled shuffle record.");
+          }
+          std::vector<Tensor> element;
+          element.reserve(record.tensors_size());
+          for (const TensorProto& proto : record.tensors()) {
+            Tensor tensor;
+            if (!tensor.FromProto(proto)) {
+              return errors::DataLoss(
+                  "Unable to parse spilled shuffle tensor.");
+            }
+            element.push_back(std::move(tensor));
+          }
+          out->push_back(std::move(element));
+        }
+      }
+
+      // Makes the next bucket current: takes the prefetched copy if one is
+      // in flight, otherwise reads it synchronously, then shuffles it. The
+      // prefetch thread never consumes RNG samples, so the sample sequence
+      // is independent of prefetch timing.
+      Status NextBucket(Env* env) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        const int64 bucket = next_bucket_to_load_++;
+        std::vector<std::vector<Tensor>> elements;
+        bool used_prefetched = false;
+        {
+          mutex_lock pl(prefetch_mu_);
+          if (prefetched_bucket_ == bucket) {
+            while (prefetch_active_) {
+              prefetch_cv_.wait(pl);
+            }
+            TF_RETURN_IF_ERROR(prefetch_status_);
+            elements = std::move(prefetched_elements_);
+            prefetched_bucket_ = -1;
+            used_prefetched = true;
+          }
+        }
+        if (!used_prefetched) {
+          TF_RETURN_IF_ERROR(LoadBucket(env, bucket, &elements));
+        }
+        // Overlap the read of the next bucket with draining this one, but
+        // only when the two buckets fit in the memory budget together.
+        const int64 next = next_bucket_to_load_;
+        if (next < num_buckets_ &&
+            bucket_bytes_[bucket] + bucket_bytes_[next] <=
+                ExternalShuffleMemoryBudget()) {
+          StartPrefetch(env, next);
+        }
+        // Fisher-Yates over the bucket.
+        for (int64 i = elements.size() - 1; i > 0; --i) {
+          int64 j = Random() % (i + 1);
+          std::swap(elements[i], elements[j]);
+        }
+        bucket_elements_ = std::move(elements);
+        bucket_index_ = 0;
+        return Status::OK();
+      }
+
+      void StartPrefetch(Env* env, int64 bucket)
+          EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+        // Join the previous prefetch thread; its result has already been
+        // consumed by this point.
+        prefetch_thread_.reset();
+        {
+          mutex_lock pl(prefetch_mu_);
+          prefetch_active_ = true;
+          prefetched_bucket_ = bucket;
+          prefetch_status_ = Status::OK();
+          prefetched_elements_.clear();
+        }
+        prefetch_thread_.reset(env->StartThread(
+            {}, "tf_data_shuffle_spill_prefetch", [this, env, bucket]() {
+              std::vector<std::vector<Tensor>> elements;
+              Status s = LoadBucket(env, bucket, &elements);
+              mutex_lock pl(prefetch_mu_);
+              prefetch_status_ = s;
+              prefetched_elements_ = std::move(elements);
+              prefetch_active_ = false;
+              prefetch_cv_.notify_all();
+            }));
+      }
+
       std::unique_ptr<std::vector<Tensor>[]> buffer_ GUARDED_BY(mu_);
       std::unique_ptr<IteratorBase> input_impl_ GUARDED_BY(mu_);
       int64 epoch_ GUARDED_BY(mu_);
@@ -334,6 +621,25 @@ class ShuffleDatasetOpBase : public UnaryDatasetOpKernel {
       random::SingleSampleAdapter<random::PhiloxRandom> generator_
           GUARDED_BY(mu_);
       int64 num_random_samples_ GUARDED_BY(mu_) = 0;
+
+      // External (spill-to-disk) shuffle state.
+      bool spilled_ GUARDED_BY(mu_) = false;
+      string spill_dir_;  // Constant once the spill has been written.
+      int64 num_buckets_ GUARDED_BY(mu_) = 0;
+      std::vector<int64> bucket_bytes_ GUARDED_BY(mu_);
+      int64 next_bucket_to_load_ GUARDED_BY(mu_) = 0;
+      std::vector<std::vector<Tensor>> bucket_elements_ GUARDED_BY(mu_);
+      size_t bucket_index_ GUARDED_BY(mu_) = 0;
+      bool warned_external_unsupported_ GUARDED_BY(mu_) = false;
+
+      mutex prefetch_mu_;
+      condition_variable prefetch_cv_;
+      bool prefetch_active_ GUARDED_BY(prefetch_mu_) = false;
+      int64 prefetched_bucket_ GUARDED_BY(prefetch_mu_) = -1;
+      Status prefetch_status_ GUARDED_BY(prefetch_mu_);
+      std::vector<std::vector<Tensor>> prefetched_elements_
+          GUARDED_BY(prefetch_mu_);
+      std::unique_ptr<Thread> prefetch_thread_;
     };
 
     const DatasetBase* const input_;
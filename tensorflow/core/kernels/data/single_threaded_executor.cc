@@ -19,6 +19,7 @@ limitations under the License.
 #include "tensorflow/core/common_runtime/executor_factory.h"
 #include "tensorflow/core/graph/algorithm.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/notification.h"
 #include "tensorflow/core/lib/core/status.h"
 
 namespace tensorflow {
@@ -76,12 +77,6 @@ class SingleThreadedExecutorImpl : public Executor {
             "control flow node ",
             n->name());
       }
-      if (n->IsSend() || n->IsHostSend() || n->IsRecv() || n->IsHostRecv()) {
-        return errors::Unimplemented(
-            "Single-threaded executor does not support partitioned graphs.  "
-            "But saw send/recv node ",
-            n->name());
-      }
       if (n->IsCollective()) {
         return errors::Unimplemented(
             "Single-threaded executor does not support collective ops.  But "
@@ -91,6 +86,7 @@ class SingleThreadedExecutorImpl : public Executor {
 
       KernelState& kernel_state = kernels_[i];
       TF_RETURN_IF_ERROR(params_.create_kernel(n->def(), &kernel_state.kernel));
+      kernel_state.is_async = (kernel_state.kernel->AsAsync() != nullptr);
       kernel_state.num_inputs = n->num_inputs();
       kernel_state.num_outputs = n->num_outputs();
 
@@ -259,8 +255,18 @@ class SingleThreadedExecutorImpl : public Executor {
       params.output_attr_array = kernel_state.output_alloc_attrs.data();
       OpKernelContext ctx(&params, num_outputs);
 
-      // Actually execute the kernel.
-      device->Compute(kernel_state.kernel, &ctx);
+      // Actually execute the kernel. Asynchronous kernels (e.g. "_Recv" and
+      // function calls) are executed by blocking this thread until they
+      // complete, which preserves the single-stream execution model.
+      if (kernel_state.is_async) {
+        AsyncOpKernel* async_kernel = kernel_state.kernel->AsAsync();
+        Notification kernel_done;
+        device->ComputeAsync(async_kernel, &ctx,
+                             [&kernel_done]() { kernel_done.Notify(); });
+        kernel_done.WaitForNotification();
+      } else {
+        device->Compute(kernel_state.kernel, &ctx);
+      }
 
       if (!ctx.status().ok()) {
         // On failure, we must manually free all intermediate tensors. We have
@@ -324,6 +330,10 @@ class SingleThreadedExecutorImpl : public Executor {
     // `params_.delete_kernel()`.
     OpKernel* kernel;
 
+    // True iff `kernel` is an `AsyncOpKernel`, in which case it is executed
+    // via `Device::ComputeAsync()` and this thread blocks on its completion.
+    bool is_async;
+
     // These fields determine the range of elements in `inputs` that corresponds
     // to the inputs of `kernel`.
     size_t input_start_index;
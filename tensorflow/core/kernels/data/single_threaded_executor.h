@@ -39,19 +39,27 @@ namespace data {
 //    currently supported. The current plan is to extend support to "functional"
 //    control flow after the TensorFlow APIs transition to building graphs in
 //    that form (e.g. `tf.cond_v2()`).
-// 3. Partitioned graphs (containing "_Recv" nodes) are not currently supported.
-//    The present implementation executes kernels one at a time in topological
-//    order, and cannot currently distinguish between disconnected subgraphs
-//    that are logically connected by subgraphs on a different device.
-// 4. Memory logging is not currently supported.
-// 5. Allocation forwarding is not currently supported.
-// 6. Non-default device contexts are not currently supported. In effect, this
+// 3. Memory logging is not currently supported.
+// 4. Allocation forwarding is not currently supported.
+// 5. Non-default device contexts are not currently supported. In effect, this
 //    limits the executor to CPU devices.
-// 7. Ops that rely on `OpKernelContext::slice_reader_cache()` being non-null
+// 6. Ops that rely on `OpKernelContext::slice_reader_cache()` being non-null
 //    are not currently supported.
 //
-// The single-threaded executor is primarily suitable for executing simple
-// TensorFlow functions, such as one might find in a `tf.data` pipeline.
+// Asynchronous kernels (including "_Recv", "_Send" and function-call kernels)
+// are supported by blocking the calling thread until the kernel completes, so
+// partitioned graphs and graphs that call functions remain single-stream but
+// pay no scheduling overhead. Because kernels execute one at a time in
+// topological order, a graph whose "_Recv" completion depends on a "_Send"
+// that is ordered after it in the same partition will deadlock; such graphs
+// should use the default executor instead.
+//
+// The single-threaded executor is suitable for executing simple TensorFlow
+// functions, such as one might find in a `tf.data` pipeline, and for serving
+// small feed-forward inference graphs where the default executor's scheduling
+// overhead dominates the useful work. It can be selected for a `DirectSession`
+// graph by registering it under an executor type (see `executor_factory.h`);
+// it is registered as "SINGLE_THREADED_EXECUTOR".
 Status NewSingleThreadedExecutor(const LocalExecutorParams& params,
                                  std::unique_ptr<const Graph> graph,
                                  Executor** executor);
@@ -154,6 +154,28 @@ TEST_F(ExecutorTest, SimpleAdd) {
   EXPECT_EQ(2.0, V(retvals[0]));  // out = 1.0 + 1.0 = 2.0
 }
 
+TEST_F(ExecutorTest, SimpleSendRecv) {
+  // c = a + b, with the inputs and output communicated over a Rendezvous as
+  // in a partitioned graph.
+  const char* const kAlice = "/job:j/replica:0/task:0/cpu:0";
+  const char* const kBob = "/job:j/replica:0/task:0/device:GPU:0";
+  std::unique_ptr<Graph> g = absl::make_unique<Graph>(OpRegistry::Global());
+  auto in0 = test::graph::Recv(g.get(), "a", "float", kAlice, 1, kBob);
+  auto in1 = test::graph::Recv(g.get(), "b", "float", kAlice, 1, kBob);
+  auto tmp = test::graph::Add(g.get(), in0, in1);
+  test::graph::Send(g.get(), tmp, "c", kBob, 1, kAlice);
+  FixupSourceAndSinkEdges(g.get());
+  Create(std::move(g));
+  Rendezvous::Args args;
+  TF_ASSERT_OK(rendez_->Send(Key(kAlice, 1, kBob, "a"), args, V(1.0), false));
+  TF_ASSERT_OK(rendez_->Send(Key(kAlice, 1, kBob, "b"), args, V(1.0), false));
+  TF_ASSERT_OK(Run(rendez_));
+  Tensor out = V(-1);
+  bool is_dead = false;
+  TF_ASSERT_OK(rendez_->Recv(Key(kBob, 1, kAlice, "c"), args, &out, &is_dead));
+  EXPECT_EQ(2.0, V(out));  // out = 1.0 + 1.0 = 2.0
+}
+
 TEST_F(ExecutorTest, SelfAdd) {
   // v0 <- a
   // v1 = v0 + v0
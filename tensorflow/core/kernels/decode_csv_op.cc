@@ -21,6 +21,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/strings/numbers.h"
+#include "tensorflow/core/util/compact_string_array.h"
 
 namespace tensorflow {
 
@@ -81,9 +82,13 @@ class DecodeCSVOp : public OpKernel {
       OP_REQUIRES_OK(ctx, output.allocate(i, records->shape(), &out));
     }
 
+    // The fields of each record are accumulated in one contiguous buffer;
+    // clearing it keeps the capacity, so after the first few records field
+    // extraction allocates nothing.
+    CompactStringArray fields;
     for (int64 i = 0; i < records_size; ++i) {
       const StringPiece record(records_t(i));
-      std::vector<string> fields;
+      fields.Clear();
       ExtractFields(ctx, record, &fields);
       OP_REQUIRES(ctx, fields.size() == out_type_.size(),
                   errors::InvalidArgument("Expect ", out_type_.size(),
@@ -93,11 +98,12 @@ class DecodeCSVOp : public OpKernel {
       // Check each field in the record
       for (int f = 0; f < static_cast<int>(out_type_.size()); ++f) {
         const DataType& dtype = out_type_[f];
+        const StringPiece field = fields.view(f);
         switch (dtype) {
           case DT_INT32: {
             // If this field is empty or NA value, check if default is given:
             // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
+            if (field.empty() || field == na_value_) {
               OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
                           errors::InvalidArgument(
                               "Field ", f,
@@ -106,10 +112,10 @@ class DecodeCSVOp : public OpKernel {
               output[f]->flat<int32>()(i) = record_defaults[f].flat<int32>()(0);
             } else {
               int32 value;
-              OP_REQUIRES(ctx, strings::safe_strto32(fields[f], &value),
+              OP_REQUIRES(ctx, strings::safe_strto32(field, &value),
                           errors::InvalidArgument(
                               "Field ", f, " in record ", i,
-                              " is not a valid int32: ", fields[f]));
+                              " is not a valid int32: ", field));
               output[f]->flat<int32>()(i) = value;
             }
             break;
@@ -117,7 +123,7 @@ class DecodeCSVOp : public OpKernel {
           case DT_INT64: {
             // If this field is empty or NA value, check if default is given:
             // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
+            if (field.empty() || field == na_value_) {
               OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
                           errors::InvalidArgument(
                               "Field ", f,
@@ -126,10 +132,10 @@ class DecodeCSVOp : public OpKernel {
               output[f]->flat<int64>()(i) = record_defaults[f].flat<int64>()(0);
             } else {
               int64 value;
-              OP_REQUIRES(ctx, strings::safe_strto64(fields[f], &value),
+              OP_REQUIRES(ctx, strings::safe_strto64(field, &value),
                           errors::InvalidArgument(
                               "Field ", f, " in record ", i,
-                              " is not a valid int64: ", fields[f]));
+                              " is not a valid int64: ", field));
               output[f]->flat<int64>()(i) = value;
             }
             break;
@@ -137,7 +143,7 @@ class DecodeCSVOp : public OpKernel {
           case DT_FLOAT: {
             // If this field is empty or NA value, check if default is given:
             // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
+            if (field.empty() || field == na_value_) {
               OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
                           errors::InvalidArgument(
                               "Field ", f,
@@ -145,10 +151,10 @@ class DecodeCSVOp : public OpKernel {
               output[f]->flat<float>()(i) = record_defaults[f].flat<float>()(0);
             } else {
               float value;
-              OP_REQUIRES(ctx, strings::safe_strtof(fields[f], &value),
+              OP_REQUIRES(ctx, strings::safe_strtof(field, &value),
                           errors::InvalidArgument(
                               "Field ", f, " in record ", i,
-                              " is not a valid float: ", fields[f]));
+                              " is not a valid float: ", field));
               output[f]->flat<float>()(i) = value;
             }
             break;
@@ -156,7 +162,7 @@ class DecodeCSVOp : public OpKernel {
           case DT_DOUBLE: {
             // If this field is empty or NA value, check if default is given:
             // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
+            if (field.empty() || field == na_value_) {
               OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
                           errors::InvalidArgument(
                               "Field ", f,
@@ -165,10 +171,10 @@ class DecodeCSVOp : public OpKernel {
                   record_defaults[f].flat<double>()(0);
             } else {
               double value;
-              OP_REQUIRES(ctx, strings::safe_strtod(fields[f], &value),
+              OP_REQUIRES(ctx, strings::safe_strtod(field, &value),
                           errors::InvalidArgument(
                               "Field ", f, " in record ", i,
-                              " is not a valid double: ", fields[f]));
+                              " is not a valid double: ", field));
               output[f]->flat<double>()(i) = value;
             }
             break;
@@ -176,7 +182,7 @@ class DecodeCSVOp : public OpKernel {
           case DT_STRING: {
             // If this field is empty or NA value, check if default is given:
             // If yes, use default value; Otherwise report error.
-            if (fields[f].empty() || fields[f] == na_value_) {
+            if (field.empty() || field == na_value_) {
               OP_REQUIRES(ctx, record_defaults[f].NumElements() == 1,
                           errors::InvalidArgument(
                               "Field ", f,
@@ -184,7 +190,7 @@ class DecodeCSVOp : public OpKernel {
               output[f]->flat<string>()(i) =
                   record_defaults[f].flat<string>()(0);
             } else {
-              output[f]->flat<string>()(i) = fields[f];
+              output[f]->flat<string>()(i).assign(field.data(), field.size());
             }
             break;
           }
@@ -206,7 +212,7 @@ class DecodeCSVOp : public OpKernel {
   string na_value_;
 
   void ExtractFields(OpKernelContext* ctx, StringPiece input,
-                     std::vector<string>* result) {
+                     CompactStringArray* result) {
     int64 current_idx = 0;
     int64 num_fields_parsed = 0;
     int64 selector_idx = 0;  // Keep track of index into select_cols
@@ -228,9 +234,11 @@ class DecodeCSVOp : public OpKernel {
           current_idx++;
         }
 
-        // This is the body of the field;
-        string field;
+        // This is the body of the field. Unquoted fields are contiguous in
+        // the record and are appended as a single slice; quoted fields may
+        // need unescaping and are built byte by byte.
         if (!quoted) {
+          const int64 field_start = current_idx;
           while (static_cast<size_t>(current_idx) < input.size() &&
                  input[current_idx] != delim_) {
             OP_REQUIRES(ctx,
@@ -239,26 +247,29 @@ class DecodeCSVOp : public OpKernel {
                             input[current_idx] != '\r',
                         errors::InvalidArgument(
                             "Unquoted fields cannot have quotes/CRLFs inside"));
-            if (include) field += input[current_idx];
             current_idx++;
           }
+          if (include) {
+            result->Add(input.substr(field_start, current_idx - field_start));
+          }
 
           // Go to next field or the end
           current_idx++;
         } else if (use_quote_delim_) {
+          if (include) result->BeginString();
           // Quoted field needs to be ended with '"' and delim or end
           while (
               (static_cast<size_t>(current_idx) < input.size() - 1) &&
               (input[current_idx] != '"' || input[current_idx + 1] != delim_)) {
             if (input[current_idx] != '"') {
-              if (include) field += input[current_idx];
+              if (include) result->AppendByte(input[current_idx]);
               current_idx++;
             } else {
               OP_REQUIRES(
                   ctx, input[current_idx + 1] == '"',
                   errors::InvalidArgument("Quote inside a string has to be "
                                           "escaped by another quote"));
-              if (include) field += '"';
+              if (include) result->AppendByte('"');
               current_idx += 2;
             }
           }
@@ -273,11 +284,11 @@ class DecodeCSVOp : public OpKernel {
                                       "followed by delim or end"));
 
           current_idx += 2;
+          if (include) result->EndString();
         }
 
         num_fields_parsed++;
         if (include) {
-          result->push_back(field);
           selector_idx++;
           if (selector_idx == select_cols_.size()) return;
         }
@@ -288,7 +299,7 @@ class DecodeCSVOp : public OpKernel {
                                    static_cast<size_t>(num_fields_parsed));
       // Check if the last field is missing
       if (include && input[input.size() - 1] == delim_)
-        result->push_back(string());
+        result->Add(StringPiece());
     }
   }
 };
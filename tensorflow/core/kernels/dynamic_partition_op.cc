@@ -15,6 +15,8 @@ limitations under the License.
 
 // See docs in ../ops/data_flow_ops.cc.
 
+#include <algorithm>
+#include <cstring>
 #include <vector>
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -22,7 +24,9 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/gtl/inlined_vector.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -39,9 +43,10 @@ class DynamicPartitionOp_Shared : public OpKernel {
     //   in the graph?
   }
 
-  void ValidateAndAllocateOutputs(OpKernelContext* c, const Tensor** data,
-                                  const Tensor** partitions,
-                                  OpOutputList* Tout) {
+  void ValidateAndAllocateOutputs(
+      OpKernelContext* c, const Tensor** data, const Tensor** partitions,
+      OpOutputList* Tout,
+      std::vector<gtl::InlinedVector<int64, 32>>* segment_counts) {
     OP_REQUIRES_OK(c, c->input("data", data));
     OP_REQUIRES_OK(c, c->input("partitions", partitions));
     OP_REQUIRES(
@@ -52,24 +57,70 @@ class DynamicPartitionOp_Shared : public OpKernel {
             "got data.shape = ", (*data)->shape().DebugString(),
             ", partitions.shape = ", (*partitions)->shape().DebugString()));
 
-    // Count how many occurrences of each partition id we have in partitions
-    gtl::InlinedVector<int, 32> partition_count(num_partitions_);
+    // Count how many occurrences of each partition id we have in partitions.
+    // For large inputs the histogram pass is sharded over contiguous segments
+    // of the input, and the per-segment counts are returned so that Compute
+    // can turn them into per-segment output offsets and scatter in parallel.
     auto e_partitions = (*partitions)->flat<int32>();
     const int64 N = e_partitions.dimension(0);
-    for (int64 i = 0; i < N; i++) {
-      const int32 p = internal::SubtleMustCopy(e_partitions(i));
-      OP_REQUIRES(c, FastBoundsCheck(p, num_partitions_),
-                  errors::InvalidArgument(
-                      "partitions", SliceDebugString((*partitions)->shape(), i),
-                      " = ", p, " is not in [0, ", num_partitions_, ")"));
-      partition_count[p]++;
+    const int64 num_segments = NumScatterSegments(c, N);
+    segment_counts->clear();
+    segment_counts->resize(num_segments,
+                           gtl::InlinedVector<int64, 32>(num_partitions_));
+    if (num_segments == 1) {
+      auto& counts = (*segment_counts)[0];
+      for (int64 i = 0; i < N; i++) {
+        const int32 p = internal::SubtleMustCopy(e_partitions(i));
+        OP_REQUIRES(
+            c, FastBoundsCheck(p, num_partitions_),
+            errors::InvalidArgument(
+                "partitions", SliceDebugString((*partitions)->shape(), i),
+                " = ", p, " is not in [0, ", num_partitions_, ")"));
+        counts[p]++;
+      }
+    } else {
+      mutex mu;
+      int64 first_bad_index = -1;
+      int32 first_bad_value = 0;
+      auto count_segment = [&](int64 seg_begin, int64 seg_end) {
+        for (int64 s = seg_begin; s < seg_end; ++s) {
+          auto& counts = (*segment_counts)[s];
+          const int64 begin = s * N / num_segments;
+          const int64 end = (s + 1) * N / num_segments;
+          for (int64 i = begin; i < end; i++) {
+            const int32 p = internal::SubtleMustCopy(e_partitions(i));
+            if (!FastBoundsCheck(p, num_partitions_)) {
+              mutex_lock l(mu);
+              if (first_bad_index < 0 || i < first_bad_index) {
+                first_bad_index = i;
+                first_bad_value = p;
+              }
+              return;
+            }
+            counts[p]++;
+          }
+        }
+      };
+      auto worker_threads = *(c->device()->tensorflow_cpu_worker_threads());
+      Shard(worker_threads.num_threads, worker_threads.workers, num_segments,
+            /*cost_per_unit=*/2 * (N / num_segments), count_segment);
+      OP_REQUIRES(
+          c, first_bad_index < 0,
+          errors::InvalidArgument(
+              "partitions",
+              SliceDebugString((*partitions)->shape(), first_bad_index), " = ",
+              first_bad_value, " is not in [0, ", num_partitions_, ")"));
     }
 
     // Allocate output tensors of the right size
     OP_REQUIRES_OK(c, c->output_list("outputs", Tout));
     for (int p = 0; p < num_partitions_; p++) {
+      int64 partition_count = 0;
+      for (const auto& counts : *segment_counts) {
+        partition_count += counts[p];
+      }
       TensorShape shape;
-      shape.AddDim(partition_count[p]);
+      shape.AddDim(partition_count);
       for (int i = (*partitions)->dims(); i < (*data)->dims(); i++) {
         shape.AddDim((*data)->dim_size(i));
       }
@@ -79,6 +130,16 @@ class DynamicPartitionOp_Shared : public OpKernel {
   }
 
  protected:
+  // Number of contiguous input segments the histogram and scatter passes are
+  // sharded over; one segment selects the serial path.
+  static int64 NumScatterSegments(OpKernelContext* c, int64 N) {
+    constexpr int64 kMinParallelElements = 64 * 1024;
+    const int num_threads =
+        c->device()->tensorflow_cpu_worker_threads()->num_threads;
+    if (num_threads <= 1 || N < kMinParallelElements) return 1;
+    return std::min<int64>(num_threads, N / (kMinParallelElements / 8));
+  }
+
   int num_partitions_;
 };
 
@@ -91,10 +152,17 @@ class DynamicPartitionOp : public DynamicPartitionOp_Shared {
     const Tensor* data;
     const Tensor* partitions;
     OpOutputList outputs;
-    ValidateAndAllocateOutputs(c, &data, &partitions, &outputs);
+    std::vector<gtl::InlinedVector<int64, 32>> segment_counts;
+    ValidateAndAllocateOutputs(c, &data, &partitions, &outputs,
+                               &segment_counts);
     if (!c->status().ok()) return;
     if (num_partitions_ == 0 || data->NumElements() == 0) return;
 
+    if (segment_counts.size() > 1) {
+      ParallelScatter(c, data, partitions, &outputs, segment_counts);
+      return;
+    }
+
     auto e_partitions = partitions->flat<int32>();
     const int64 N = e_partitions.dimension(0);
     gtl::InlinedVector<int, 32> output_index(num_partitions_);
@@ -156,6 +224,82 @@ class DynamicPartitionOp : public DynamicPartitionOp_Shared {
       }
     }
   }
+
+ private:
+  // Scatter pass over the same contiguous input segments the histogram was
+  // computed on. Exclusive prefix sums of the per-segment counts give every
+  // segment a disjoint, contiguous range of each output to write, so the
+  // parallel result is identical to the serial walk.
+  void ParallelScatter(
+      OpKernelContext* c, const Tensor* data, const Tensor* partitions,
+      OpOutputList* outputs,
+      const std::vector<gtl::InlinedVector<int64, 32>>& segment_counts) {
+    auto e_partitions = partitions->flat<int32>();
+    const int64 N = e_partitions.dimension(0);
+    const int64 num_segments = segment_counts.size();
+    const int64 slice_size = data->NumElements() / N;
+    const auto data_flat = data->shaped<T, 2>({N, slice_size});
+
+    std::vector<Eigen::TensorMap<Eigen::Tensor<T, 2, Eigen::RowMajor>,
+                                 Eigen::Aligned> >
+        out_flat;
+    out_flat.reserve(num_partitions_);
+    for (int p = 0; p < num_partitions_; p++) {
+      out_flat.push_back((*outputs)[p]->flat_outer_dims<T>());
+    }
+
+    // segment_base[s][p] is the first row segment s writes in output p.
+    std::vector<gtl::InlinedVector<int64, 32>> segment_base(
+        num_segments, gtl::InlinedVector<int64, 32>(num_partitions_));
+    gtl::InlinedVector<int64, 32> running(num_partitions_);
+    for (int64 s = 0; s < num_segments; ++s) {
+      for (int p = 0; p < num_partitions_; p++) {
+        segment_base[s][p] = running[p];
+        running[p] += segment_counts[s][p];
+      }
+    }
+
+    mutex mu;
+    int64 first_bad_index = -1;
+    auto scatter_segment = [&](int64 seg_begin, int64 seg_end) {
+      for (int64 s = seg_begin; s < seg_end; ++s) {
+        const int64 begin = s * N / num_segments;
+        const int64 end = (s + 1) * N / num_segments;
+        gtl::InlinedVector<int64, 32> output_index(segment_base[s]);
+        for (int64 i = begin; i < end; i++) {
+          // If `partitions` is asynchronously overwritten after the counting
+          // pass, the id or the derived offset can fall out of range; fail
+          // the op like the serial path rather than write out of bounds.
+          const int32 p = internal::SubtleMustCopy(e_partitions(i));
+          if (!FastBoundsCheck(p, num_partitions_) ||
+              output_index[p] >= out_flat[p].dimension(0)) {
+            mutex_lock l(mu);
+            if (first_bad_index < 0 || i < first_bad_index) {
+              first_bad_index = i;
+            }
+            return;
+          }
+          const int64 oi = output_index[p]++;
+          if (DataTypeCanUseMemcpy(DataTypeToEnum<T>::v())) {
+            memcpy(out_flat[p].data() + oi * slice_size,
+                   data_flat.data() + i * slice_size, slice_size * sizeof(T));
+          } else {
+            for (int64 e = 0; e < slice_size; ++e) {
+              out_flat[p](oi, e) = data_flat(i, e);
+            }
+          }
+        }
+      }
+    };
+    auto worker_threads = *(c->device()->tensorflow_cpu_worker_threads());
+    Shard(worker_threads.num_threads, worker_threads.workers, num_segments,
+          /*cost_per_unit=*/(N / num_segments) * slice_size * sizeof(T),
+          scatter_segment);
+    OP_REQUIRES(c, first_bad_index < 0,
+                errors::InvalidArgument("indices[", first_bad_index,
+                                        "] has been asynchronously overwritten "
+                                        "and is no longer in range!"));
+  }
 };
 
 #define REGISTER_DYNAMIC_PARTITION(T)                                     \
@@ -15,6 +15,7 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/allocator.h"
@@ -146,6 +147,33 @@ TEST_F(DynamicPartitionOpTest, SomeOutputsEmpty) {
   }
 }
 
+// Large enough to engage the sharded histogram and parallel scatter; the
+// result must match the serial walk, with rows kept in input order.
+TEST_F(DynamicPartitionOpTest, Large_OneD) {
+  MakeOp();
+
+  const int kRows = 100000;
+  std::vector<float> data(kRows);
+  std::vector<int32> partitions(kRows);
+  std::vector<std::vector<float>> expected(4);
+  for (int i = 0; i < kRows; ++i) {
+    data[i] = static_cast<float>(i);
+    partitions[i] = (i * 7919) % 4;
+    expected[partitions[i]].push_back(data[i]);
+  }
+  AddInputFromArray<float>(TensorShape({kRows}), data);
+  AddInputFromArray<int32>(TensorShape({kRows}), partitions);
+  TF_ASSERT_OK(RunOpKernel());
+
+  for (int p = 0; p < 4; ++p) {
+    Tensor expected_tensor(
+        allocator(), DT_FLOAT,
+        TensorShape({static_cast<int64>(expected[p].size())}));
+    test::FillValues<float>(&expected_tensor, expected[p]);
+    test::ExpectTensorEqual<float>(expected_tensor, *GetOutput(p));
+  }
+}
+
 TEST_F(DynamicPartitionOpTest, Error_IndexOutOfRange) {
   MakeOp();
 
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/lib/core/threadpool.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/core/kernels/gpu_device_array.h"
@@ -239,6 +240,58 @@ class DynamicStitchOpImplCPU : public DynamicStitchOpImplBase<T> {
       auto merged_flat = merged->flat_outer_dims<T>();
       const int slice_size = merged_flat.dimension(1);
       const size_t slice_bytes = slice_size * sizeof(T);
+
+      // For large stitches, shard over disjoint ranges of the merged first
+      // dimension instead of over input lists: every worker scans all index
+      // lists in input order and copies only the rows it owns. A duplicated
+      // index resolves to its last occurrence exactly as in the serial walk,
+      // and no two workers write the same output row.
+      constexpr int64 kMinParallelStitchElements = 1 << 20;
+      int64 total_indices = 0;
+      for (const Tensor& indices : indices_inputs) {
+        total_indices += indices.NumElements();
+      }
+      auto worker_threads = *(c->device()->tensorflow_cpu_worker_threads());
+      if (worker_threads.num_threads > 1 &&
+          DataTypeCanUseMemcpy(DataTypeToEnum<T>::v()) &&
+          total_indices * slice_size >= kMinParallelStitchElements) {
+        // Validate all indices up front so the error matches the serial
+        // path; the workers then clamp to their own range, which also keeps
+        // an asynchronously overwritten index from escaping the output.
+        for (int input_num = 0; input_num < indices_inputs.size();
+             ++input_num) {
+          auto indices_vec = indices_inputs[input_num].flat<int32>();
+          for (int i = 0; i < indices_vec.size(); i++) {
+            const int32 index = internal::SubtleMustCopy(indices_vec(i));
+            OP_REQUIRES(
+                c, FastBoundsCheck(index, first_dim_size),
+                errors::InvalidArgument("indices[", i, "] is out of range"));
+          }
+        }
+        T* merged_base = merged_flat.data();
+        auto stitch_range = [&](int64 out_begin, int64 out_end) {
+          for (int input_num = 0; input_num < indices_inputs.size();
+               ++input_num) {
+            auto indices_vec = indices_inputs[input_num].flat<int32>();
+            const T* data_base =
+                data_inputs[input_num].template flat<T>().data();
+            for (int i = 0; i < indices_vec.size(); i++) {
+              const int32 index = internal::SubtleMustCopy(indices_vec(i));
+              if (index < out_begin || index >= out_end) continue;
+              memcpy(merged_base + index * slice_size,
+                     data_base + i * slice_size, slice_bytes);
+            }
+          }
+        };
+        // Each output row costs one slice copy plus its share of scanning
+        // every index list.
+        const int64 cost_per_row =
+            slice_bytes + 3 * total_indices / first_dim_size;
+        Shard(worker_threads.num_threads, worker_threads.workers,
+              first_dim_size, cost_per_row, stitch_range);
+        return;
+      }
+
       auto OnInputNumber = [&](int input_num) {
         const Tensor& indices = indices_inputs[input_num];
         auto indices_vec = indices.flat<int32>();
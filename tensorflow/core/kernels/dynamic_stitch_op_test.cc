@@ -15,7 +15,9 @@ limitations under the License.
 
 #include <functional>
 #include <memory>
+#include <vector>
 
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
 #include "tensorflow/core/framework/allocator.h"
 #include "tensorflow/core/framework/fake_input.h"
 #include "tensorflow/core/framework/node_def_builder.h"
@@ -23,6 +25,8 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
 #include "tensorflow/core/kernels/ops_testutil.h"
 #include "tensorflow/core/kernels/ops_util.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
@@ -30,6 +34,7 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
 
 namespace tensorflow {
 namespace {
@@ -80,6 +85,38 @@ TEST_F(DynamicStitchOpTest, Simple_TwoD) {
   test::ExpectTensorEqual<float>(expected, *GetOutput(0));
 }
 
+// Large enough to engage the sharded-by-output-range path; the merged
+// result must be identical to the serial walk.
+TEST_F(DynamicStitchOpTest, Large_OneD) {
+  MakeOp(2, DT_FLOAT);
+
+  const int kRows = 1 << 20;
+  std::vector<int32> indices[2];
+  std::vector<float> data[2];
+  std::vector<float> expected(kRows);
+  for (int i = 0; i < kRows; ++i) {
+    const int input_num = (i * 7919) % 2;
+    indices[input_num].push_back(i);
+    data[input_num].push_back(static_cast<float>(i) * 0.5f);
+    expected[i] = static_cast<float>(i) * 0.5f;
+  }
+  for (int input_num = 0; input_num < 2; ++input_num) {
+    AddInputFromArray<int32>(
+        TensorShape({static_cast<int64>(indices[input_num].size())}),
+        indices[input_num]);
+  }
+  for (int input_num = 0; input_num < 2; ++input_num) {
+    AddInputFromArray<float>(
+        TensorShape({static_cast<int64>(data[input_num].size())}),
+        data[input_num]);
+  }
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor expected_tensor(allocator(), DT_FLOAT, TensorShape({kRows}));
+  test::FillValues<float>(&expected_tensor, expected);
+  test::ExpectTensorEqual<float>(expected_tensor, *GetOutput(0));
+}
+
 TEST_F(DynamicStitchOpTest, Error_IndicesMultiDimensional) {
   MakeOp(2, DT_FLOAT);
 
@@ -142,5 +179,49 @@ TEST_F(DynamicStitchOpTest, Error_DataAndIndicesSizeMismatch) {
       << s;
 }
 
+// Stitches `num_inputs` disjoint round-robin partitions of kStitchRows rows
+// back together, the inverse of the DynamicPartition benchmark shapes.
+template <typename T>
+static Graph* DynamicStitchGraph(int num_inputs, int dim) {
+  Graph* g = new Graph(OpRegistry::Global());
+  const int kStitchRows = 1 << 20;
+  std::vector<NodeBuilder::NodeOut> indices_inputs;
+  std::vector<NodeBuilder::NodeOut> data_inputs;
+  for (int input_num = 0; input_num < num_inputs; ++input_num) {
+    const int rows =
+        (kStitchRows - input_num + num_inputs - 1) / num_inputs;
+    Tensor indices(DT_INT32, TensorShape({rows}));
+    for (int i = 0; i < rows; ++i) {
+      indices.flat<int32>()(i) = i * num_inputs + input_num;
+    }
+    Tensor data(DataTypeToEnum<T>::value, TensorShape({rows, dim}));
+    data.flat<T>().setRandom();
+    indices_inputs.push_back(test::graph::Constant(g, indices));
+    data_inputs.push_back(test::graph::Constant(g, data));
+  }
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "DynamicStitch")
+                  .Input(indices_inputs)
+                  .Input(data_inputs)
+                  .Finalize(g, &ret));
+  return g;
+}
+
+#define BM_DYNAMIC_STITCH(DEVICE, T, num)                              \
+  static void BM_##DEVICE##_dynstitch_##T##_##num(int iters, int dim) { \
+    const int64 items = static_cast<int64>(1 << 20) * dim;             \
+    const int64 tot = static_cast<int64>(iters) * items;               \
+    testing::ItemsProcessed(tot);                                      \
+    testing::UseRealTime();                                            \
+    test::Benchmark(#DEVICE, DynamicStitchGraph<T>(num, dim))          \
+        .Run(iters);                                                   \
+  }                                                                    \
+  BENCHMARK(BM_##DEVICE##_dynstitch_##T##_##num)->Arg(1)->Arg(256)
+
+BM_DYNAMIC_STITCH(cpu, float, 2);
+BM_DYNAMIC_STITCH(cpu, float, 100);
+BM_DYNAMIC_STITCH(cpu, double, 2);
+BM_DYNAMIC_STITCH(cpu, double, 100);
+
 }  // namespace
 }  // namespace tensorflow
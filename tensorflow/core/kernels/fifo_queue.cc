@@ -17,6 +17,7 @@ limitations under the License.
 
 #include <algorithm>
 #include <deque>
+#include <memory>
 #include <vector>
 
 #include "tensorflow/core/framework/node_def.pb.h"
@@ -107,6 +108,30 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
     return;
   }
 
+  // Split the batch into per-element tensors up front, outside the
+  // critical section.  The attempt callback below then only moves
+  // already-materialized elements into the queue, so the per-element
+  // allocation and copy work does not run under mu_, where it would
+  // serialize all producers and consumers of the queue.
+  auto elements =
+      std::make_shared<std::vector<std::vector<PersistentTensor>>>();
+  elements->reserve(batch_size);
+  for (int64 index = 0; index < batch_size; ++index) {
+    elements->emplace_back();
+    std::vector<PersistentTensor>& element = elements->back();
+    element.reserve(num_components());
+    for (int i = 0; i < num_components(); ++i) {
+      PersistentTensor component;
+      Status s = GetElementComponentFromBatch(tuple, index, i, ctx, &component);
+      if (!s.ok()) {
+        ctx->SetStatus(s);
+        callback();
+        return;
+      }
+      element.push_back(component);
+    }
+  }
+
   CancellationManager* cm = ctx->cancellation_manager();
   CancellationToken token = cm->get_cancellation_token();
   bool already_cancelled;
@@ -117,7 +142,7 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
     if (!already_cancelled) {
       enqueue_attempts_.emplace_back(
           batch_size, callback, ctx, cm, token,
-          [tuple, this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+          [elements, this](Attempt* attempt) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
             if (closed_) {
               attempt->context->SetStatus(
                   errors::Cancelled("FIFOQueue '", name_, "' is closed."));
@@ -126,14 +151,10 @@ void FIFOQueue::TryEnqueueMany(const Tuple& tuple, OpKernelContext* ctx,
             RunResult result = kNoProgress;
             while (queues_[0].size() < static_cast<size_t>(capacity_)) {
               result = kProgress;
-              const int64 index =
-                  tuple[0].dim_size(0) - attempt->elements_requested;
+              const int64 index = static_cast<int64>(elements->size()) -
+                                  attempt->elements_requested;
               for (int i = 0; i < num_components(); ++i) {
-                PersistentTensor element;
-                attempt->context->SetStatus(GetElementComponentFromBatch(
-                    tuple, index, i, attempt->context, &element));
-                if (!attempt->context->status().ok()) return kComplete;
-                queues_[i].push_back(element);
+                queues_[i].push_back((*elements)[index][i]);
               }
               --attempt->elements_requested;
               if (attempt->elements_requested == 0) {
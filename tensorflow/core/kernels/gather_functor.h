@@ -88,13 +88,38 @@ SliceIndex HandleCopies(OpKernelContext* ctx,
       // TODO(cwhipkey): avoid linking to framework to get Allocator (to improve
       // ahead-of-time compilation binary size).
       if (is_simple_type<T>::value) {
+        // Embedding lookups often gather runs of adjacent rows (e.g. indices
+        // produced by a range or a sorted lookup). Coalesce such runs into a
+        // single larger memcpy, as long as they stay within the range assigned
+        // to this worker.
+        SliceIndex run_len = 1;
+        const SliceIndex indices_seg_end =
+            (batch_idx == batch_idx_end) ? indices_idx_end : indices_size;
+        while (indices_idx + run_len < indices_seg_end) {
+          const Index next_index =
+              internal::SubtleMustCopy(indices(indices_idx + run_len));
+          if (!FastBoundsCheck(next_index, limit) ||
+              next_index != index + static_cast<Index>(run_len))
+            break;
+          ++run_len;
+        }
         // Avoid auto-promotion to Index from SliceIndex by casting.
         memcpy(
             out_base + (batch_idx * indices_size + indices_idx) * slice_elems,
             params_base + (batch_idx * static_cast<SliceIndex>(limit) +
                            static_cast<SliceIndex>(index)) *
                               slice_elems,
-            slice_bytes);
+            run_len * slice_bytes);
+        if (run_len > 1) {
+          // Skip over the coalesced indices (prefetches issued above for the
+          // single-index step are wasted but harmless).
+          i_next = indices_idx + run_len;
+          b_next = batch_idx;
+          if (i_next == indices_size) {
+            i_next = 0;
+            b_next = batch_idx + 1;
+          }
+        }
       } else {
         // For non-"simple" types (e.g. strings).
         out.template chip<1>(indices_idx) = params.template chip<1>(index);
@@ -100,6 +100,24 @@ TEST_F(GatherOpTest, Simple_TwoD32_Axis0) {
   test::ExpectTensorEqual<float>(expected, *GetOutput(0));
 }
 
+TEST_F(GatherOpTest, ContiguousIndices_TwoD32) {
+  MakeOp(DT_FLOAT, DT_INT32);
+
+  // Runs of adjacent indices are coalesced into single copies; make sure the
+  // coalesced path produces the same result as per-index copies.
+  AddInputFromArray<float>(TensorShape({5, 3}),
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+  AddInputFromArray<int32>(TensorShape({6}), {1, 2, 3, 4, 0, 1});
+  AddInputFromArray<int32>(TensorShape({}), {0});
+  TF_ASSERT_OK(RunOpKernel());
+
+  // Check the output.
+  Tensor expected(allocator(), DT_FLOAT, TensorShape({6, 3}));
+  test::FillValues<float>(&expected, {3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14,
+                                      0, 1, 2, 3, 4, 5});
+  test::ExpectTensorEqual<float>(expected, *GetOutput(0));
+}
+
 TEST_F(GatherOpTest, Simple_TwoD32_Axis1) {
   MakeOp(DT_FLOAT, DT_INT32);
 
@@ -176,6 +194,21 @@ TEST_F(GatherOpTest, Error_IndexOutOfRange) {
       << s;
 }
 
+TEST_F(GatherOpTest, Error_IndexOutOfRangeAfterRun) {
+  MakeOp(DT_FLOAT, DT_INT32);
+
+  // The out-of-bounds index follows a run of adjacent indices; it must still
+  // be reported and not folded into the coalesced copy.
+  AddInputFromArray<float>(TensorShape({5, 3}),
+                           {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14});
+  AddInputFromArray<int32>(TensorShape({4}), {3, 4, 5, 0});
+  AddInputFromArray<int32>(TensorShape({}), {0});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "indices[2] = 5 is not in [0, 5)"))
+      << s;
+}
+
 constexpr int kLookups = 2000;
 
 template <typename Index>
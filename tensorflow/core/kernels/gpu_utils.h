@@ -20,9 +20,13 @@ limitations under the License.
 
 #include <unordered_map>
 
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/lib/strings/numbers.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/lib/strings/stringprintf.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/stream_executor.h"
 
@@ -48,7 +52,21 @@ class DnnScratchAllocator : public se::ScratchAllocator {
  public:
   virtual ~DnnScratchAllocator() {}
   DnnScratchAllocator(int64 memory_limit, OpKernelContext* context)
-      : memory_limit_(memory_limit), total_byte_size_(0), context_(context) {}
+      : memory_limit_(memory_limit),
+        total_byte_size_(0),
+        context_(context),
+        workspace_allocator_(nullptr) {}
+  // Variant that serves requests from 'workspace_allocator' (e.g. the
+  // dedicated workspace arena owned by GPUProcessState) when it is
+  // non-null, keeping scratch churn out of the device's main allocator.
+  // Falls back to the main allocator for requests the arena cannot
+  // satisfy.
+  DnnScratchAllocator(int64 memory_limit, OpKernelContext* context,
+                      Allocator* workspace_allocator)
+      : memory_limit_(memory_limit),
+        total_byte_size_(0),
+        context_(context),
+        workspace_allocator_(workspace_allocator) {}
   int64 GetMemoryLimitInBytes(se::Stream* stream) override {
     return memory_limit_;
   }
@@ -64,6 +82,17 @@ class DnnScratchAllocator : public se::ScratchAllocator {
     }
     AllocationAttributes allocation_attr;
     allocation_attr.no_retry_on_failure = true;
+    if (workspace_allocator_ != nullptr) {
+      Tensor arena_memory(workspace_allocator_, DT_UINT8,
+                          TensorShape({byte_size}), allocation_attr);
+      if (arena_memory.IsInitialized()) {
+        allocated_tensors_.push_back(arena_memory);
+        total_byte_size_ += byte_size;
+        return se::port::StatusOr<se::DeviceMemory<uint8>>(
+            AsDeviceMemory(arena_memory.flat<uint8>().data(),
+                           arena_memory.flat<uint8>().size()));
+      }
+    }
     Status allocation_status(context_->allocate_temp(
         DT_UINT8, TensorShape({byte_size}), &temporary_memory,
         AllocatorAttributes(), allocation_attr));
@@ -84,9 +113,88 @@ class DnnScratchAllocator : public se::ScratchAllocator {
   int64 memory_limit_;
   int64 total_byte_size_;
   OpKernelContext* context_;
+  Allocator* workspace_allocator_;  // not owned; may be null
   std::vector<Tensor> allocated_tensors_;
 };
 
+// Serialization hooks used by AutoTuneMap to persist accepted configs
+// across process restarts.  The unspecialized version declines to
+// serialize, which disables persistence for that config type; specialize
+// it for config types that can be round-tripped through a string.
+template <typename Config>
+struct AutoTuneConfigSerializer {
+  static bool Serialize(const Config& config, string* out) { return false; }
+  static bool Deserialize(const string& in, Config* config) { return false; }
+};
+
+template <>
+struct AutoTuneConfigSerializer<se::dnn::AlgorithmConfig> {
+  // Format: "<algo_id>,<tensor_ops> <algo_id>,<tensor_ops>" for the main
+  // and no-scratch algorithms, with "-" for an unset algorithm.
+  static bool Serialize(const se::dnn::AlgorithmConfig& config, string* out) {
+    *out = strings::StrCat(DescToString(config.algorithm()), " ",
+                           DescToString(config.algorithm_no_scratch()));
+    return true;
+  }
+
+  static bool Deserialize(const string& in, se::dnn::AlgorithmConfig* config) {
+    std::vector<string> parts = str_util::Split(in, ' ');
+    if (parts.size() != 2) return false;
+    absl::optional<se::dnn::AlgorithmDesc> algorithm;
+    absl::optional<se::dnn::AlgorithmDesc> algorithm_no_scratch;
+    if (!DescFromString(parts[0], &algorithm) ||
+        !DescFromString(parts[1], &algorithm_no_scratch)) {
+      return false;
+    }
+    *config = se::dnn::AlgorithmConfig();
+    if (algorithm) config->set_algorithm(*algorithm);
+    if (algorithm_no_scratch) {
+      config->set_algorithm_no_scratch(*algorithm_no_scratch);
+    }
+    return true;
+  }
+
+ private:
+  static string DescToString(
+      const absl::optional<se::dnn::AlgorithmDesc>& desc) {
+    if (!desc) return "-";
+    return strings::StrCat(desc->algo_id(), ",",
+                           desc->tensor_ops_enabled() ? 1 : 0);
+  }
+
+  static bool DescFromString(const string& in,
+                             absl::optional<se::dnn::AlgorithmDesc>* desc) {
+    if (in == "-") {
+      desc->reset();
+      return true;
+    }
+    std::vector<string> fields = str_util::Split(in, ',');
+    int64 algo_id;
+    int32 tensor_ops;
+    if (fields.size() != 2 || !strings::safe_strto64(fields[0], &algo_id) ||
+        !strings::safe_strto32(fields[1], &tensor_ops)) {
+      return false;
+    }
+    *desc = se::dnn::AlgorithmDesc(algo_id, tensor_ops != 0);
+    return true;
+  }
+};
+
+template <>
+struct AutoTuneConfigSerializer<se::blas::AlgorithmConfig> {
+  static bool Serialize(const se::blas::AlgorithmConfig& config, string* out) {
+    *out = strings::StrCat(config.algorithm());
+    return true;
+  }
+
+  static bool Deserialize(const string& in, se::blas::AlgorithmConfig* config) {
+    int64 algorithm;
+    if (!strings::safe_strto64(in, &algorithm)) return false;
+    *config = se::blas::AlgorithmConfig(algorithm);
+    return true;
+  }
+};
+
 // A helper class that looks up the best autotuned config from parameters.
 // Due to the noisy nature of autotune, especially with multiple devices, it
 // only accepts a config if its margin exceeds a threshold.
@@ -100,12 +208,26 @@ class DnnScratchAllocator : public se::ScratchAllocator {
 template <typename Parameters, typename Config>
 class AutoTuneMap {
  public:
-  bool Find(const Parameters& params, Config* config) const {
+  bool Find(const Parameters& params, Config* config) {
     mutex_lock lock(mu_);
     auto iter = params_config_map_.find(params);
     if (iter == params_config_map_.end() ||
         (iter->second.score < min_score_threshold_ &&
          iter->second.count <= max_autotune_count_)) {
+      // Fall back to a config persisted by a previous process, if any.  A
+      // restored config is inserted as already accepted so it is not
+      // re-tuned (or re-persisted) in this process.
+      if (iter == params_config_map_.end() && !persisted_configs_.empty()) {
+        auto piter = persisted_configs_.find(Hash64(params.ToString()));
+        if (piter != persisted_configs_.end()) {
+          VLOG(1) << GetActionSummary("restores", params, piter->second);
+          params_config_map_.insert(std::make_pair(
+              params, ValueType{piter->second, min_score_threshold_,
+                                max_autotune_count_ + 1}));
+          *config = piter->second;
+          return true;
+        }
+      }
       return false;
     }
     *config = iter->second.config;
@@ -142,6 +264,7 @@ class AutoTuneMap {
     }
     if (new_score >= min_score_threshold_) {
       VLOG(1) << GetActionSummary("accepts", params, config);
+      PersistConfig(params, config);
     }
   }
 
@@ -161,6 +284,77 @@ class AutoTuneMap {
     min_score_threshold_ = std::max(min_score_threshold_, 1);
     max_autotune_count_ = std::max(
         5 * min_score_threshold_ * min_score_threshold_, min_warmup_iterations);
+    const char* cache_dir = getenv("TF_AUTOTUNE_CACHE_DIR");
+    if (cache_dir != nullptr) {
+      cache_path_ = strings::StrCat(cache_dir, "/", name_, ".autotune");
+      LoadPersistedConfigs();
+    }
+  }
+
+  // Reads accepted configs written by previous processes from cache_path_.
+  // Each line is "<hex key> <serialized config>"; later lines win so
+  // appended updates supersede older entries.  Unparseable lines (e.g. from
+  // an older build with different serialization) are skipped.
+  void LoadPersistedConfigs() {
+    string contents;
+    Status s = ReadFileToString(Env::Default(), cache_path_, &contents);
+    if (!s.ok()) {
+      if (!errors::IsNotFound(s)) {
+        LOG(WARNING) << "Could not read autotune cache " << cache_path_ << ": "
+                     << s;
+      }
+      return;
+    }
+    int num_loaded = 0;
+    for (const string& line : str_util::Split(contents, '\n')) {
+      if (line.empty()) continue;
+      const size_t space = line.find(' ');
+      if (space == string::npos) continue;
+      uint64 key;
+      Config config;
+      if (!strings::HexStringToUint64(line.substr(0, space), &key) ||
+          !AutoTuneConfigSerializer<Config>::Deserialize(line.substr(space + 1),
+                                                         &config)) {
+        continue;
+      }
+      persisted_configs_[key] = config;
+      ++num_loaded;
+    }
+    VLOG(1) << "autotune_map " << name_ << ": loaded " << num_loaded
+            << " persisted configs from " << cache_path_;
+  }
+
+  // Appends an accepted config to the cache file, if persistence is enabled
+  // and the config type is serializable.
+  void PersistConfig(const Parameters& params, const Config& config)
+      EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (cache_path_.empty()) return;
+    string serialized;
+    if (!AutoTuneConfigSerializer<Config>::Serialize(config, &serialized)) {
+      return;
+    }
+    const uint64 key = Hash64(params.ToString());
+    auto iter = persisted_configs_.find(key);
+    if (iter != persisted_configs_.end() && iter->second == config) return;
+    persisted_configs_[key] = config;
+    if (cache_file_ == nullptr) {
+      Status s = Env::Default()->NewAppendableFile(cache_path_, &cache_file_);
+      if (!s.ok()) {
+        LOG(WARNING) << "Could not open autotune cache " << cache_path_
+                     << " for writing: " << s;
+        cache_path_.clear();
+        return;
+      }
+    }
+    Status s = cache_file_->Append(
+        strings::StrCat(strings::Printf("%llx", static_cast<unsigned long long>(
+                                                    key)),
+                        " ", serialized, "\n"));
+    if (s.ok()) s = cache_file_->Flush();
+    if (!s.ok()) {
+      LOG(WARNING) << "Could not append to autotune cache " << cache_path_
+                   << ": " << s;
+    }
   }
 
   template <class Group, class Params, class Cfg>
@@ -191,6 +385,13 @@ class AutoTuneMap {
   int32 min_score_threshold_;
   int32 max_autotune_count_;
 
+  // Persistent cache state; see TF_AUTOTUNE_CACHE_DIR.  Keys are
+  // Hash64(params.ToString()).  Empty cache_path_ means persistence is
+  // disabled.
+  string cache_path_ GUARDED_BY(mu_);
+  std::unordered_map<uint64, Config> persisted_configs_ GUARDED_BY(mu_);
+  std::unique_ptr<WritableFile> cache_file_ GUARDED_BY(mu_);
+
   TF_DISALLOW_COPY_AND_ASSIGN(AutoTuneMap);
 };
 
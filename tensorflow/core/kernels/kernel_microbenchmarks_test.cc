@@ -0,0 +1,285 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Consolidated microbenchmark suite for the kernels we track across ROCm
+// releases: matmul, conv, segment reductions, gather and parse_example.
+//
+// Every benchmark reports FLOPs via testing::ItemsProcessed and the tensor
+// bytes moved via testing::BytesProcessed, and attaches a "key=value" label
+// describing op, dtype and shape so the output rows can be diffed
+// mechanically between runs. Warmup runs and timing separation are handled
+// by test::Benchmark (see kernel_benchmark_testlib.cc).
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/example/example.pb.h"
+#include "tensorflow/core/example/feature.pb.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/lib/random/simple_philox.h"
+#include "tensorflow/core/lib/strings/strcat.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+template <typename T>
+Graph* MatMulGraph(int m, int k, int n) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor a(DataTypeToEnum<T>::value, TensorShape({m, k}));
+  a.flat<T>().setRandom();
+  Tensor b(DataTypeToEnum<T>::value, TensorShape({k, n}));
+  b.flat<T>().setRandom();
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("matmul"), "MatMul")
+                  .Input(test::graph::Constant(g, a))
+                  .Input(test::graph::Constant(g, b))
+                  .Attr("transpose_a", false)
+                  .Attr("transpose_b", false)
+                  .Finalize(g, &ret));
+  return g;
+}
+
+template <typename T>
+Graph* Conv2DGraph(int batch, int height, int width, int in_depth,
+                   int filter_size, int out_depth) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DataTypeToEnum<T>::value,
+               TensorShape({batch, height, width, in_depth}));
+  input.flat<T>().setRandom();
+  Tensor filter(DataTypeToEnum<T>::value,
+                TensorShape({filter_size, filter_size, in_depth, out_depth}));
+  filter.flat<T>().setRandom();
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("conv"), "Conv2D")
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, filter))
+                  .Attr("strides", {1, 1, 1, 1})
+                  .Attr("padding", "SAME")
+                  .Attr("data_format", "NHWC")
+                  .Finalize(g, &ret));
+  return g;
+}
+
+template <typename T>
+Graph* SegmentReductionGraph(const string& op, int num_rows, int row_size,
+                             int num_segments) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor data(DataTypeToEnum<T>::value, TensorShape({num_rows, row_size}));
+  data.flat<T>().setRandom();
+  // Sorted ids, evenly partitioning the rows, valid for both the sorted and
+  // the unsorted reduction ops.
+  Tensor segment_ids(DT_INT32, TensorShape({num_rows}));
+  for (int i = 0; i < num_rows; ++i) {
+    segment_ids.flat<int32>()(i) = (i * num_segments) / num_rows;
+  }
+  NodeBuilder builder(g->NewName("segment"), op);
+  builder.Input(test::graph::Constant(g, data))
+      .Input(test::graph::Constant(g, segment_ids));
+  if (op == "UnsortedSegmentSum") {
+    Tensor num_segments_t(DT_INT32, TensorShape({}));
+    num_segments_t.scalar<int32>()() = num_segments;
+    builder.Input(test::graph::Constant(g, num_segments_t));
+  }
+  Node* ret;
+  TF_CHECK_OK(builder.Finalize(g, &ret));
+  return g;
+}
+
+template <typename T>
+Graph* GatherGraph(int num_rows, int row_size, int num_indices) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor params(DataTypeToEnum<T>::value, TensorShape({num_rows, row_size}));
+  params.flat<T>().setRandom();
+  Tensor indices(DT_INT32, TensorShape({num_indices}));
+  random::PhiloxRandom philox(301, 17);
+  random::SimplePhilox rnd(&philox);
+  for (int i = 0; i < num_indices; ++i) {
+    indices.flat<int32>()(i) = rnd.Uniform(num_rows);
+  }
+  Tensor axis(DT_INT32, TensorShape({}));
+  axis.scalar<int32>()() = 0;
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("gather"), "GatherV2")
+                  .Input(test::graph::Constant(g, params))
+                  .Input(test::graph::Constant(g, indices))
+                  .Input(test::graph::Constant(g, axis))
+                  .Finalize(g, &ret));
+  return g;
+}
+
+Graph* ParseExampleGraph(int batch_size, int feature_size) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor serialized(DT_STRING, TensorShape({batch_size}));
+  Example example;
+  auto* feature_list =
+      (*example.mutable_features()->mutable_feature())["values"]
+          .mutable_float_list();
+  for (int i = 0; i < feature_size; ++i) {
+    feature_list->add_value(i);
+  }
+  const string serialized_proto = example.SerializeAsString();
+  for (int b = 0; b < batch_size; ++b) {
+    serialized.flat<string>()(b) = serialized_proto;
+  }
+  Tensor names(DT_STRING, TensorShape({0}));
+  Tensor key(DT_STRING, TensorShape({}));
+  key.scalar<string>()() = "values";
+  Tensor dense_default(DT_FLOAT, TensorShape({feature_size}));
+  dense_default.flat<float>().setZero();
+  std::vector<NodeBuilder::NodeOut> sparse_keys;
+  std::vector<NodeBuilder::NodeOut> dense_keys = {
+      test::graph::Constant(g, key)};
+  std::vector<NodeBuilder::NodeOut> dense_defaults = {
+      test::graph::Constant(g, dense_default)};
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("parse"), "ParseExample")
+                  .Input(test::graph::Constant(g, serialized))
+                  .Input(test::graph::Constant(g, names))
+                  .Input(sparse_keys)
+                  .Input(dense_keys)
+                  .Input(dense_defaults)
+                  .Attr("sparse_types", std::vector<DataType>())
+                  .Attr("dense_shapes", {TensorShape({feature_size})})
+                  .Finalize(g, &ret));
+  return g;
+}
+
+// Attaches a machine-readable "key=value ..." label to the current
+// benchmark row.
+void LabelRun(const string& op, const string& dtype, const string& shape) {
+  testing::SetLabel(
+      strings::StrCat("op=", op, " dtype=", dtype, " shape=", shape));
+}
+
+// MatMul: FLOPs = 2*M*K*N, bytes = inputs + output.
+#define BM_MatMul(DEVICE, M, K, N, T, DTYPE_NAME)                           \
+  static void BM_MatMul_##DEVICE##_##M##_##K##_##N##_##DTYPE_NAME(          \
+      int iters) {                                                          \
+    testing::UseRealTime();                                                 \
+    testing::ItemsProcessed(static_cast<int64>(iters) * M * K * N * 2);     \
+    testing::BytesProcessed(static_cast<int64>(iters) *                     \
+                            (M * K + K * N + M * N) * sizeof(T));           \
+    LabelRun("MatMul", #DTYPE_NAME,                                         \
+             strings::StrCat(M, "x", K, "x", N));                           \
+    test::Benchmark(#DEVICE, MatMulGraph<T>(M, K, N)).Run(iters);           \
+  }                                                                         \
+  BENCHMARK(BM_MatMul_##DEVICE##_##M##_##K##_##N##_##DTYPE_NAME)
+
+// Conv2D, SAME padding, stride 1: FLOPs = 2*N*H*W*C*F*F*OC.
+#define BM_Conv2D(DEVICE, N, H, W, C, F, OC, T, DTYPE_NAME)                 \
+  static void                                                               \
+      BM_Conv2D_##DEVICE##_##N##_##H##_##W##_##C##_##F##_##OC##_##DTYPE_NAME( \
+          int iters) {                                                      \
+    testing::UseRealTime();                                                 \
+    testing::ItemsProcessed(static_cast<int64>(iters) * N * H * W * C * F * \
+                            F * OC * 2);                                    \
+    testing::BytesProcessed(static_cast<int64>(iters) *                     \
+                            (N * H * W * C + F * F * C * OC +               \
+                             N * H * W * OC) *                              \
+                            sizeof(T));                                     \
+    LabelRun("Conv2D", #DTYPE_NAME,                                         \
+             strings::StrCat(N, "x", H, "x", W, "x", C, "_f", F, "_o", OC)); \
+    test::Benchmark(#DEVICE, Conv2DGraph<T>(N, H, W, C, F, OC)).Run(iters); \
+  }                                                                         \
+  BENCHMARK(                                                                \
+      BM_Conv2D_##DEVICE##_##N##_##H##_##W##_##C##_##F##_##OC##_##DTYPE_NAME)
+
+// Segment reductions: one add per element, data read + output written.
+#define BM_SegmentReduction(DEVICE, OP, ROWS, COLS, SEGMENTS, T, DTYPE_NAME) \
+  static void                                                                \
+      BM_##OP##_##DEVICE##_##ROWS##_##COLS##_##SEGMENTS##_##DTYPE_NAME(      \
+          int iters) {                                                       \
+    testing::UseRealTime();                                                  \
+    testing::ItemsProcessed(static_cast<int64>(iters) * ROWS * COLS);        \
+    testing::BytesProcessed(static_cast<int64>(iters) *                      \
+                            (ROWS + SEGMENTS) * COLS * sizeof(T));           \
+    LabelRun(#OP, #DTYPE_NAME,                                               \
+             strings::StrCat(ROWS, "x", COLS, "_s", SEGMENTS));              \
+    test::Benchmark(#DEVICE,                                                 \
+                    SegmentReductionGraph<T>(#OP, ROWS, COLS, SEGMENTS))     \
+        .Run(iters);                                                         \
+  }                                                                          \
+  BENCHMARK(BM_##OP##_##DEVICE##_##ROWS##_##COLS##_##SEGMENTS##_##DTYPE_NAME)
+
+// Gather: bytes = rows gathered (read) + output (written).
+#define BM_Gather(DEVICE, ROWS, COLS, INDICES, T, DTYPE_NAME)               \
+  static void BM_Gather_##DEVICE##_##ROWS##_##COLS##_##INDICES##_##DTYPE_NAME( \
+      int iters) {                                                          \
+    testing::UseRealTime();                                                 \
+    testing::ItemsProcessed(static_cast<int64>(iters) * INDICES * COLS);    \
+    testing::BytesProcessed(static_cast<int64>(iters) * 2 * INDICES * COLS * \
+                            sizeof(T));                                     \
+    LabelRun("GatherV2", #DTYPE_NAME,                                       \
+             strings::StrCat(ROWS, "x", COLS, "_i", INDICES));              \
+    test::Benchmark(#DEVICE, GatherGraph<T>(ROWS, COLS, INDICES))           \
+        .Run(iters);                                                        \
+  }                                                                         \
+  BENCHMARK(BM_Gather_##DEVICE##_##ROWS##_##COLS##_##INDICES##_##DTYPE_NAME)
+
+// ParseExample: one dense float feature per example.
+#define BM_ParseExample(BATCH, FEATURES)                                    \
+  static void BM_ParseExample_cpu_##BATCH##_##FEATURES(int iters) {         \
+    testing::UseRealTime();                                                 \
+    testing::ItemsProcessed(static_cast<int64>(iters) * BATCH * FEATURES);  \
+    testing::BytesProcessed(static_cast<int64>(iters) * BATCH * FEATURES *  \
+                            sizeof(float));                                 \
+    LabelRun("ParseExample", "DT_FLOAT",                                    \
+             strings::StrCat(BATCH, "x", FEATURES));                        \
+    test::Benchmark("cpu", ParseExampleGraph(BATCH, FEATURES)).Run(iters);  \
+  }                                                                         \
+  BENCHMARK(BM_ParseExample_cpu_##BATCH##_##FEATURES)
+
+// Standardized shape matrix: small / square / skinny / large per op, so
+// successive ROCm releases are compared on identical rows.
+BM_MatMul(cpu, 128, 128, 128, float, DT_FLOAT);
+BM_MatMul(cpu, 1024, 1024, 1024, float, DT_FLOAT);
+BM_MatMul(cpu, 64, 4096, 64, float, DT_FLOAT);
+
+BM_Conv2D(cpu, 8, 56, 56, 64, 3, 64, float, DT_FLOAT);
+
+BM_SegmentReduction(cpu, SegmentSum, 65536, 64, 256, float, DT_FLOAT);
+BM_SegmentReduction(cpu, UnsortedSegmentSum, 65536, 64, 256, float, DT_FLOAT);
+
+BM_Gather(cpu, 1048576, 64, 65536, float, DT_FLOAT);
+
+BM_ParseExample(128, 16);
+BM_ParseExample(512, 128);
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+BM_MatMul(gpu, 128, 128, 128, float, DT_FLOAT);
+BM_MatMul(gpu, 1024, 1024, 1024, float, DT_FLOAT);
+BM_MatMul(gpu, 4096, 4096, 4096, float, DT_FLOAT);
+BM_MatMul(gpu, 1024, 1024, 1024, Eigen::half, DT_HALF);
+
+// Conv2D on GPU exercises the MIOpen (ROCm) / cuDNN (CUDA) backend,
+// including algorithm selection.
+BM_Conv2D(gpu, 8, 56, 56, 64, 3, 64, float, DT_FLOAT);
+BM_Conv2D(gpu, 32, 28, 28, 128, 3, 128, float, DT_FLOAT);
+BM_Conv2D(gpu, 32, 14, 14, 256, 3, 256, float, DT_FLOAT);
+BM_Conv2D(gpu, 32, 28, 28, 128, 1, 512, float, DT_FLOAT);
+BM_Conv2D(gpu, 32, 28, 28, 128, 3, 128, Eigen::half, DT_HALF);
+
+BM_SegmentReduction(gpu, UnsortedSegmentSum, 65536, 64, 256, float,
+                    DT_FLOAT);
+BM_SegmentReduction(gpu, UnsortedSegmentSum, 1048576, 32, 1024, float,
+                    DT_FLOAT);
+
+BM_Gather(gpu, 1048576, 64, 65536, float, DT_FLOAT);
+#endif  // GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+
+}  // namespace
+}  // namespace tensorflow
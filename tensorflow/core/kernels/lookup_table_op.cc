@@ -16,6 +16,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/lookup_table_op.h"
 #define EIGEN_USE_THREADS
 
+#include <memory>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -292,6 +293,142 @@ class MutableHashTableOfTensors final : public LookupInterface {
   std::unordered_map<K, ValueArray> table_ GUARDED_BY(mu_);
 };
 
+// Lookup table that serves Find from an immutable snapshot which is
+// republished on every mutation. Behaves like MutableHashTableOfScalars,
+// except that reads hold the lock only long enough to copy a reference to
+// the snapshot, so parallel lookups never serialize on the scan over the
+// keys and are never blocked behind a writer mutating the map. In exchange,
+// every Insert/Remove/ImportValues pays a full copy of the table, so this
+// variant is intended for tables that are built once or updated rarely and
+// then read at high rates, e.g. vocabularies in serving.
+template <class K, class V>
+class ReadOptimizedHashTableOfScalars final : public LookupInterface {
+ public:
+  ReadOptimizedHashTableOfScalars(OpKernelContext* ctx, OpKernel* kernel)
+      : snapshot_(std::make_shared<TableMap>()) {}
+
+  size_t size() const override { return Snapshot()->size(); }
+
+  Status Find(OpKernelContext* ctx, const Tensor& key, Tensor* value,
+              const Tensor& default_value) override {
+    const V default_val = default_value.flat<V>()(0);
+    const auto key_values = key.flat<K>();
+    auto value_values = value->flat<V>();
+
+    const std::shared_ptr<const TableMap> snapshot = Snapshot();
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      value_values(i) = gtl::FindWithDefault(
+          *snapshot, SubtleMustCopyIfIntegral(key_values(i)), default_val);
+    }
+
+    return Status::OK();
+  }
+
+  Status DoInsert(bool clear, const Tensor& keys, const Tensor& values) {
+    const auto key_values = keys.flat<K>();
+    const auto value_values = values.flat<V>();
+
+    // Writers are serialized by write_mu_, so the snapshot cannot change
+    // between reading it and publishing its replacement. The copy and the
+    // updates happen outside of mu_, which is only held long enough to swap
+    // the snapshot pointer.
+    mutex_lock writer(write_mu_);
+    std::shared_ptr<TableMap> updated(clear ? new TableMap
+                                            : new TableMap(*Snapshot()));
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      gtl::InsertOrUpdate(updated.get(),
+                          SubtleMustCopyIfIntegral(key_values(i)),
+                          SubtleMustCopyIfIntegral(value_values(i)));
+    }
+    Publish(std::move(updated));
+    return Status::OK();
+  }
+
+  Status Insert(OpKernelContext* ctx, const Tensor& keys,
+                const Tensor& values) override {
+    return DoInsert(false, keys, values);
+  }
+
+  Status Remove(OpKernelContext* ctx, const Tensor& keys) override {
+    const auto key_values = keys.flat<K>();
+
+    mutex_lock writer(write_mu_);
+    std::shared_ptr<TableMap> updated(new TableMap(*Snapshot()));
+    for (int64 i = 0; i < key_values.size(); ++i) {
+      updated->erase(SubtleMustCopyIfIntegral(key_values(i)));
+    }
+    Publish(std::move(updated));
+    return Status::OK();
+  }
+
+  Status ImportValues(OpKernelContext* ctx, const Tensor& keys,
+                      const Tensor& values) override {
+    return DoInsert(true, keys, values);
+  }
+
+  Status ExportValues(OpKernelContext* ctx) override {
+    const std::shared_ptr<const TableMap> snapshot = Snapshot();
+    int64 size = snapshot->size();
+
+    Tensor* keys;
+    Tensor* values;
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("keys", TensorShape({size}), &keys));
+    TF_RETURN_IF_ERROR(
+        ctx->allocate_output("values", TensorShape({size}), &values));
+
+    auto keys_data = keys->flat<K>();
+    auto values_data = values->flat<V>();
+    int64 i = 0;
+    for (auto it = snapshot->begin(); it != snapshot->end(); ++it, ++i) {
+      keys_data(i) = it->first;
+      values_data(i) = it->second;
+    }
+    return Status::OK();
+  }
+
+  DataType key_dtype() const override { return DataTypeToEnum<K>::v(); }
+
+  DataType value_dtype() const override { return DataTypeToEnum<V>::v(); }
+
+  TensorShape key_shape() const final { return TensorShape(); }
+
+  TensorShape value_shape() const override { return TensorShape(); }
+
+  int64 MemoryUsed() const override {
+    int64 ret = 0;
+    const std::shared_ptr<const TableMap> snapshot = Snapshot();
+    for (unsigned i = 0; i < snapshot->bucket_count(); ++i) {
+      size_t bucket_size = snapshot->bucket_size(i);
+      if (bucket_size == 0) {
+        ret++;
+      } else {
+        ret += bucket_size;
+      }
+    }
+    return sizeof(ReadOptimizedHashTableOfScalars) + ret;
+  }
+
+ private:
+  typedef std::unordered_map<K, V> TableMap;
+
+  std::shared_ptr<const TableMap> Snapshot() const {
+    tf_shared_lock l(mu_);
+    return snapshot_;
+  }
+
+  void Publish(std::shared_ptr<TableMap> updated) {
+    mutex_lock l(mu_);
+    snapshot_ = std::move(updated);
+  }
+
+  // Serializes writers; never held while a reader is blocked.
+  mutex write_mu_;
+  // Guards the snapshot pointer only, never the map behind it.
+  mutable mutex mu_;
+  std::shared_ptr<const TableMap> snapshot_ GUARDED_BY(mu_);
+};
+
 namespace {
 
 template <typename T>
@@ -1031,6 +1168,34 @@ REGISTER_KERNEL(string, int64);
 
 #undef REGISTER_KERNEL
 
+// Register the ReadOptimizedMutableHashTable op.
+#define REGISTER_KERNEL(key_dtype, value_dtype)                       \
+  REGISTER_KERNEL_BUILDER(                                            \
+      Name("ReadOptimizedMutableHashTable")                           \
+          .Device(DEVICE_CPU)                                         \
+          .TypeConstraint<key_dtype>("key_dtype")                     \
+          .TypeConstraint<value_dtype>("value_dtype"),                \
+      LookupTableOp<                                                  \
+          lookup::ReadOptimizedHashTableOfScalars<key_dtype,          \
+                                                  value_dtype>,       \
+          key_dtype, value_dtype>)
+
+REGISTER_KERNEL(int32, double);
+REGISTER_KERNEL(int32, float);
+REGISTER_KERNEL(int32, int32);
+REGISTER_KERNEL(int64, double);
+REGISTER_KERNEL(int64, float);
+REGISTER_KERNEL(int64, int32);
+REGISTER_KERNEL(int64, int64);
+REGISTER_KERNEL(int64, string);
+REGISTER_KERNEL(string, bool);
+REGISTER_KERNEL(string, double);
+REGISTER_KERNEL(string, float);
+REGISTER_KERNEL(string, int32);
+REGISTER_KERNEL(string, int64);
+
+#undef REGISTER_KERNEL
+
 // Register the MutableHashTableOfTensors op.
 #define REGISTER_KERNEL(key_dtype, value_dtype)                                \
   REGISTER_KERNEL_BUILDER(                                                     \
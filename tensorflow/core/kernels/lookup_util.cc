@@ -18,7 +18,11 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/io/inputbuffer.h"
+#include "tensorflow/core/platform/cpu_info.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 namespace lookup {
@@ -27,6 +31,76 @@ namespace {
 static const int kInputBufferSize = 1 * 1024 * 1024; /* bytes */
 static const int kLineNumber = -1;
 static const int kWholeLine = -2;
+static const int64 kImportBatchSize = 64 * 1024; /* lines */
+
+// Whether InitializeTableFromTextFile should parse the vocabulary file in
+// parallel. Off by default; the parallel path produces the same table as the
+// sequential one, so this is purely a startup-time optimization for large
+// vocabularies.
+bool UseParallelVocabImport() {
+  static const bool enabled = [] {
+    bool b = false;
+    Status s = ReadBoolFromEnvVar("TF_PARALLEL_VOCAB_IMPORT", false, &b);
+    if (!s.ok()) LOG(ERROR) << s;
+    return b;
+  }();
+  return enabled;
+}
+
+// Sets element 'offset' of the tensor 't' from 'line' or 'tokens' based on
+// 'index'. The value is converted to the data type of the tensor;
+// 'line_number' provides the line-number key and is used in error messages.
+Status SetTensorValue(const string& line, const std::vector<string>& tokens,
+                      int64 index, int64 line_number, int64 offset,
+                      Tensor* tensor) {
+  if (index == kLineNumber) {
+    tensor->flat<int64>()(offset) = line_number;
+    return Status::OK();
+  }
+  const string& token = (index == kWholeLine) ? line : tokens[index];
+  const DataType& dtype = tensor->dtype();
+  switch (dtype) {
+    case DT_INT32: {
+      int32 value;
+      if (!strings::safe_strto32(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid int32.");
+      }
+      tensor->flat<int32>()(offset) = value;
+    } break;
+    case DT_INT64: {
+      int64 value;
+      if (!strings::safe_strto64(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid int64.");
+      }
+      tensor->flat<int64>()(offset) = value;
+    } break;
+    case DT_FLOAT: {
+      float value;
+      if (!strings::safe_strtof(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid float.");
+      }
+      tensor->flat<float>()(offset) = value;
+    } break;
+    case DT_DOUBLE: {
+      double value;
+      if (!strings::safe_strtod(token.c_str(), &value)) {
+        return errors::InvalidArgument("Field ", token, " in line ",
+                                       line_number, " is not a valid double.");
+      }
+      tensor->flat<double>()(offset) = value;
+    } break;
+    case DT_STRING:
+      tensor->flat<string>()(offset) = token;
+      break;
+    default:
+      return errors::InvalidArgument("Data type ", DataTypeString(dtype),
+                                     " not supported.");
+  }
+  return Status::OK();
+}
 
 Status GetNumLinesInTextFile(Env* env, const string& vocab_file,
                              int64* num_lines) {
@@ -194,61 +268,220 @@ class TextFileLineIterator
   // tensor 't'. The value is transformed to the given data type 'dtype'.
   Status SetValue(const string& line, const std::vector<string>& tokens,
                   int64 index, Tensor* tensor) {
-    if (index == kLineNumber) {
-      tensor->flat<int64>()(0) = next_id_;
-      return Status::OK();
+    Status s = SetTensorValue(line, tokens, index, next_id_, 0, tensor);
+    if (!s.ok()) valid_ = false;
+    return s;
+  }
+
+  TF_DISALLOW_COPY_AND_ASSIGN(TextFileLineIterator);
+};
+
+// Iterator that reads a text file in batches. Each iteration reads a slab of
+// up to kImportBatchSize lines, parses the lines in parallel on a thread
+// pool, and populates vector keys and values tensors with one element per
+// line. Every line writes its parsed key and value into its own slot and
+// batches are yielded in file order, so the table this iterator builds
+// (including line-number keys and duplicate-key handling) is identical to
+// the one TextFileLineIterator builds, independent of thread scheduling.
+class TextFileBatchIterator
+    : public InitializableLookupTable::InitTableIterator {
+ public:
+  TextFileBatchIterator()
+      : valid_(false),
+        vocab_size_(-1),
+        status_(errors::FailedPrecondition("Not initialized")) {}
+
+  // Initialize iterator. The arguments have the same meaning as for
+  // TextFileLineIterator::Init.
+  Status Init(const string& filename, int64 vocab_size, char delimiter,
+              DataType key_dtype, int64 key_index, DataType value_dtype,
+              int64 value_index, Env* env) {
+    filename_ = filename;
+    vocab_size_ = vocab_size;
+    delimiter_ = delimiter;
+    key_dtype_ = key_dtype;
+    value_dtype_ = value_dtype;
+    key_index_ = key_index;
+    value_index_ = value_index;
+    env_ = env;
+
+    status_ = env->NewRandomAccessFile(filename_, &file_);
+    if (!status_.ok()) return status_;
+
+    input_buffer_.reset(new io::InputBuffer(file_.get(), kInputBufferSize));
+    pool_.reset(new thread::ThreadPool(env, "parallel_vocab_import",
+                                       port::NumSchedulableCPUs()));
+    valid_ = true;
+    next_id_ = 0;
+    at_end_ = false;
+    ignore_split_ = std::max(key_index_, value_index_) < 0;
+    Next();
+    return status_;
+  }
+
+  void Next() override {
+    if (!valid_) return;
+    if (at_end_) {
+      status_ = end_status_;
+      valid_ = false;
+      return;
     }
-    const string& token = (index == kWholeLine) ? line : tokens[index];
-    const DataType& dtype = tensor->dtype();
-    switch (dtype) {
-      case DT_INT32: {
-        int32 value;
-        if (!strings::safe_strto32(token.c_str(), &value)) {
-          valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid int32.");
-        }
-        tensor->flat<int32>()(0) = value;
-      } break;
-      case DT_INT64: {
-        int64 value;
-        if (!strings::safe_strto64(token.c_str(), &value)) {
+
+    // Read the next slab of lines sequentially; line numbers are assigned
+    // here, before any parallelism.
+    std::vector<string> lines;
+    lines.reserve(kImportBatchSize);
+    while (static_cast<int64>(lines.size()) < kImportBatchSize) {
+      const int64 line_number = next_id_ + lines.size();
+      if (vocab_size_ != -1 && line_number >= vocab_size_) {
+        // Matches the sequential path: warn if the file continues past the
+        // requested vocab_size.
+        string extra;
+        Status s = input_buffer_->ReadLine(&extra);
+        if (s.ok()) {
+          LOG(WARNING) << "Truncated " << filename_ << " before its end at "
+                       << vocab_size_ << " records.";
+          LOG(WARNING) << "next_id_  : " << line_number;
+        } else if (!errors::IsOutOfRange(s)) {
+          status_ = s;
           valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid int64.");
+          return;
         }
-        tensor->flat<int64>()(0) = value;
-      } break;
-      case DT_FLOAT: {
-        float value;
-        if (!strings::safe_strtof(token.c_str(), &value)) {
+        at_end_ = true;
+        end_status_ = errors::OutOfRange("Finished reading ", vocab_size_,
+                                         " of lines from ", filename_);
+        break;
+      }
+      string line;
+      Status s = input_buffer_->ReadLine(&line);
+      if (!s.ok()) {
+        if (!errors::IsOutOfRange(s)) {
+          status_ = s;
           valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid float.");
+          return;
         }
-        tensor->flat<float>()(0) = value;
-      } break;
-      case DT_DOUBLE: {
-        double value;
-        if (!strings::safe_strtod(token.c_str(), &value)) {
+        if (vocab_size_ != -1 && line_number != vocab_size_) {
+          status_ = errors::InvalidArgument("Invalid vocab_size in ",
+                                            filename_, ": expected ",
+                                            vocab_size_, " but got ",
+                                            line_number);
           valid_ = false;
-          return errors::InvalidArgument("Field ", token, " in line ", next_id_,
-                                         " is not a valid double.");
+          return;
         }
-        tensor->flat<double>()(0) = value;
-      } break;
-      case DT_STRING:
-        tensor->flat<string>()(0) = token;
+        at_end_ = true;
+        end_status_ = s;
         break;
-      default:
-        valid_ = false;
-        return errors::InvalidArgument("Data type ", DataTypeString(dtype),
-                                       " not supported.");
+      }
+      lines.push_back(std::move(line));
     }
-    return Status::OK();
+
+    if (lines.empty()) {
+      status_ = end_status_;
+      valid_ = false;
+      return;
+    }
+
+    const int64 num_lines = lines.size();
+    key_ = Tensor(key_dtype_, TensorShape({num_lines}));
+    value_ = Tensor(value_dtype_, TensorShape({num_lines}));
+
+    // Parse the slab in parallel. On failure, report the error of the
+    // smallest failing line number so the outcome does not depend on thread
+    // scheduling.
+    mutex parse_mu;
+    int64 first_bad_line = -1;
+    Status parse_status;
+    pool_->ParallelFor(
+        num_lines, 300 /* cycles per line */,
+        [this, &lines, &parse_mu, &first_bad_line, &parse_status](int64 begin,
+                                                                  int64 end) {
+          for (int64 i = begin; i < end; ++i) {
+            Status s = ParseLine(lines[i], next_id_ + i, i);
+            if (!s.ok()) {
+              mutex_lock l(parse_mu);
+              if (first_bad_line == -1 || next_id_ + i < first_bad_line) {
+                first_bad_line = next_id_ + i;
+                parse_status = s;
+              }
+              return;
+            }
+          }
+        });
+    if (first_bad_line != -1) {
+      status_ = parse_status;
+      valid_ = false;
+      return;
+    }
+
+    next_id_ += num_lines;
   }
 
-  TF_DISALLOW_COPY_AND_ASSIGN(TextFileLineIterator);
+  bool Valid() const override { return valid_; }
+
+  const Tensor& keys() const override { return key_; }
+
+  const Tensor& values() const override { return value_; }
+
+  Status status() const override { return status_; }
+
+  int64 total_size() const override {
+    if (vocab_size_ == -1) {
+      int64 new_size = -1;
+      Status status = GetNumLinesInTextFile(env_, filename_, &new_size);
+      if (!status.ok()) {
+        LOG(WARNING) << "Unable to get line count: " << status;
+        new_size = -1;
+      }
+      *const_cast<int64*>(&vocab_size_) = new_size;
+    }
+    return vocab_size_;
+  }
+
+ private:
+  Tensor key_;
+  Tensor value_;
+  bool valid_;  // true if the iterator points to an existing range.
+  int64 key_index_;
+  int64 value_index_;
+  DataType key_dtype_;
+  DataType value_dtype_;
+  Env* env_;
+  int64 next_id_;
+  int64 vocab_size_;
+  string filename_;
+  char delimiter_;
+  Status status_;
+  Status end_status_;  // status to report once the final batch is consumed.
+  bool at_end_;
+  bool ignore_split_;
+  std::unique_ptr<RandomAccessFile> file_;  // must outlive input_buffer_
+  std::unique_ptr<io::InputBuffer> input_buffer_;
+  std::unique_ptr<thread::ThreadPool> pool_;
+
+  // Parses one line into element 'offset' of the keys and values tensors.
+  Status ParseLine(const string& line, int64 line_number, int64 offset) {
+    if (line.empty()) {
+      return errors::InvalidArgument("Invalid content in ", filename_,
+                                     ": empty line found at line ",
+                                     line_number, ".");
+    }
+    std::vector<string> tokens;
+    if (!ignore_split_) {
+      tokens = str_util::Split(line, delimiter_);
+      if (std::max(key_index_, value_index_) >= tokens.size()) {
+        return errors::InvalidArgument(
+            "Invalid number of columns in ", filename_, " line ", line_number,
+            " (", line, ") : expected ", std::max(key_index_, value_index_),
+            " got ", tokens.size());
+      }
+    }
+    TF_RETURN_IF_ERROR(SetTensorValue(line, tokens, key_index_, line_number,
+                                      offset, &key_));
+    return SetTensorValue(line, tokens, value_index_, line_number, offset,
+                          &value_);
+  }
+
+  TF_DISALLOW_COPY_AND_ASSIGN(TextFileBatchIterator);
 };
 
 Status GetTableHandle(const string& input_name, OpKernelContext* ctx,
@@ -364,14 +597,22 @@ Status InitializeTableFromTextFile(const string& filename, int64 vocab_size,
         DataTypeString(table->value_dtype()));
   }
 
-  TextFileLineIterator iter;
-  TF_RETURN_IF_ERROR(iter.Init(filename, vocab_size, delimiter, key_dtype,
-                               key_index, value_dtype, value_index, env));
   // For initialization from files, ignore if the table is already
   // initialized. The table shared name should contain the filename to
   // avoid trying to initialize the same table from the same file at the same
   // time.
-  Status s = table->Initialize(iter);
+  Status s;
+  if (UseParallelVocabImport()) {
+    TextFileBatchIterator iter;
+    TF_RETURN_IF_ERROR(iter.Init(filename, vocab_size, delimiter, key_dtype,
+                                 key_index, value_dtype, value_index, env));
+    s = table->Initialize(iter);
+  } else {
+    TextFileLineIterator iter;
+    TF_RETURN_IF_ERROR(iter.Init(filename, vocab_size, delimiter, key_dtype,
+                                 key_index, value_dtype, value_index, env));
+    s = table->Initialize(iter);
+  }
   if (errors::IsFailedPrecondition(s) && table->is_initialized()) {
     LOG(INFO) << "Table trying to initialize from file " << filename
               << " is already initialized.";
@@ -0,0 +1,203 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Implements matrix multiplication with other kernels baked into the
+// processing, to optimize latency and memory usage:
+//  - MatMul + BiasAdd + <Activation>
+//
+// Activation: Relu, Relu6, Elu.
+//
+// Just like fused Conv2D (see `conv_ops_fused_impl.h`) fusion is implemented
+// with an Eigen tensor contraction output kernel, and we reuse the output
+// kernels defined for the fused convolution. Only the CPU device is supported.
+
+#define USE_EIGEN_TENSOR
+#define EIGEN_USE_THREADS
+
+#include <string>
+#include <vector>
+
+#include "absl/strings/str_join.h"
+#include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/register_types.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/kernels/conv_ops_fused_impl.h"
+#include "tensorflow/core/kernels/fill_functor.h"
+
+namespace tensorflow {
+
+template <typename Device, typename T>
+class FusedMatMulOp : public OpKernel {
+ public:
+  explicit FusedMatMulOp(OpKernelConstruction* context) : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("transpose_a", &transpose_a_));
+    OP_REQUIRES_OK(context, context->GetAttr("transpose_b", &transpose_b_));
+
+    // 'fused_ops' and 'num_args' attributes are specified by the Grappler
+    // Remapper optimizer (see grappler/optimizers/remapper.cc).
+
+    std::vector<string> fused_ops;
+    OP_REQUIRES_OK(context, context->GetAttr("fused_ops", &fused_ops));
+    OP_REQUIRES(context, !fused_ops.empty(),
+                errors::InvalidArgument(
+                    "Fused MatMul must have at least one fused op."));
+
+    int num_args;
+    OP_REQUIRES_OK(context, context->GetAttr("num_args", &num_args));
+
+    // Match combination of fused ops to one of the supported fusions.
+    if (FusedOpsMatch(fused_ops, {"BiasAdd"})) {
+      fused_computation_ = FusedComputationType::kBiasAdd;
+    } else if (FusedOpsMatch(fused_ops, {"BiasAdd", "Relu"})) {
+      fused_computation_ = FusedComputationType::kBiasAddWithRelu;
+    } else if (FusedOpsMatch(fused_ops, {"BiasAdd", "Relu6"})) {
+      fused_computation_ = FusedComputationType::kBiasAddWithRelu6;
+    } else if (FusedOpsMatch(fused_ops, {"BiasAdd", "Elu"})) {
+      fused_computation_ = FusedComputationType::kBiasAddWithElu;
+    } else {
+      OP_REQUIRES(context, false,
+                  errors::Unimplemented("Fusion is not implemented: [",
+                                        absl::StrJoin(fused_ops, ","), "]"));
+    }
+
+    // All supported fusions take a single extra argument: bias.
+    OP_REQUIRES(context, num_args == 1,
+                errors::InvalidArgument(
+                    "Fused MatMul must have one extra argument: bias."));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& a = context->input(0);
+    const Tensor& b = context->input(1);
+
+    // Check that the dimensions of the two matrices are valid.
+    OP_REQUIRES(
+        context, TensorShapeUtils::IsMatrix(a.shape()),
+        errors::InvalidArgument("In[0] is not a matrix. Instead it has shape ",
+                                a.shape().DebugString()));
+    OP_REQUIRES(
+        context, TensorShapeUtils::IsMatrix(b.shape()),
+        errors::InvalidArgument("In[1] is not a matrix. Instead it has shape ",
+                                b.shape().DebugString()));
+    Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1> dim_pair;
+    dim_pair[0].first = transpose_a_ ? 0 : 1;
+    dim_pair[0].second = transpose_b_ ? 1 : 0;
+
+    OP_REQUIRES(
+        context,
+        a.dim_size(dim_pair[0].first) == b.dim_size(dim_pair[0].second),
+        errors::InvalidArgument(
+            "Matrix size-incompatible: In[0]: ", a.shape().DebugString(),
+            ", In[1]: ", b.shape().DebugString()));
+    int a_dim_remaining = 1 - dim_pair[0].first;
+    int b_dim_remaining = 1 - dim_pair[0].second;
+    TensorShape out_shape(
+        {a.dim_size(a_dim_remaining), b.dim_size(b_dim_remaining)});
+    Tensor* out = nullptr;
+    OP_REQUIRES_OK(context, context->allocate_output(0, out_shape, &out));
+
+    if (out->NumElements() == 0) {
+      // If a has shape [0, x] or b has shape [x, 0], the output shape
+      // is a 0-element matrix, so there is nothing to do.
+      return;
+    }
+
+    if (a.NumElements() == 0 || b.NumElements() == 0) {
+      // If a has shape [x, 0] and b has shape [0, y], the
+      // output shape is [x, y] where x and y are non-zero, so we fill
+      // the output with zeros.
+      functor::SetZeroFunctor<Device, T> f;
+      f(context->eigen_device<Device>(), out->flat<T>());
+      return;
+    }
+
+    const T* bias_data = nullptr;
+    OP_REQUIRES_OK(context, InitBiasAddData(context, &bias_data));
+
+    switch (fused_computation_) {
+      case FusedComputationType::kBiasAdd:
+        ExecuteMatMul(context, a, b, dim_pair, WithBiasAdd<T>(bias_data), out);
+        break;
+
+      case FusedComputationType::kBiasAddWithRelu:
+        ExecuteMatMul(context, a, b, dim_pair, WithBiasAddAndRelu<T>(bias_data),
+                      out);
+        break;
+
+      case FusedComputationType::kBiasAddWithRelu6:
+        ExecuteMatMul(context, a, b, dim_pair,
+                      WithBiasAddAndRelu6<T>(bias_data), out);
+        break;
+
+      case FusedComputationType::kBiasAddWithElu:
+        ExecuteMatMul(context, a, b, dim_pair, WithBiasAddAndElu<T>(bias_data),
+                      out);
+        break;
+
+      default:
+        OP_REQUIRES(context, false,
+                    errors::Internal("Fusion type is not supported"));
+    }
+  }
+
+ private:
+  bool FusedOpsMatch(const std::vector<string>& fused_ops,
+                     const std::vector<string>& expected) const {
+    return fused_ops == expected;
+  }
+
+  Status InitBiasAddData(OpKernelContext* context,
+                         const T** bias_data) const {
+    // Bias of the following dimensions: [ output_depth ]
+    const Tensor& bias = context->input(2);
+    if (bias.dims() != 1) {
+      return errors::InvalidArgument("bias must be 1-dimensional",
+                                     bias.shape().DebugString());
+    }
+    *bias_data = reinterpret_cast<const T*>(bias.tensor_data().data());
+    return Status::OK();
+  }
+
+  template <typename OutputKernel>
+  void ExecuteMatMul(
+      OpKernelContext* context, const Tensor& a, const Tensor& b,
+      const Eigen::array<Eigen::IndexPair<Eigen::DenseIndex>, 1>& dim_pair,
+      const OutputKernel& output_kernel, Tensor* output) {
+    functor::MatMulConvFunctor<Device, T, OutputKernel>()(
+        context->eigen_device<Device>(), output->matrix<T>(), a.matrix<T>(),
+        b.matrix<T>(), dim_pair, output_kernel);
+  }
+
+  bool transpose_a_;
+  bool transpose_b_;
+
+  FusedComputationType fused_computation_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(FusedMatMulOp);
+};
+
+// Registration of the CPU implementations.
+#define REGISTER_FUSED_CPU_MATMUL(T)                                  \
+  REGISTER_KERNEL_BUILDER(                                            \
+      Name("_FusedMatMul").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
+      FusedMatMulOp<CPUDevice, T>);
+
+TF_CALL_float(REGISTER_FUSED_CPU_MATMUL);
+TF_CALL_double(REGISTER_FUSED_CPU_MATMUL);
+
+#undef REGISTER_FUSED_CPU_MATMUL
+
+}  // namespace tensorflow
@@ -1298,6 +1298,12 @@ BM_ImageNetSoftmaxFwd(32, 1008, 1, true, "softmax32");
 BM_ImageNetSoftmaxFwd(128, 1008, 1, true, "softmax128");
 BM_ImageNetSoftmaxFwd(8192, 1024, 1, true, "softmax32");
 BM_ImageNetSoftmaxFwd(8192, 32768, 1, true, "softmax128");
+// Vocabulary-sized class counts exercising the row-tiled CPU fast path.
+BM_ImageNetSoftmaxFwd(16, 10000, 1, false, "softmax_vocab_10k");
+BM_ImageNetSoftmaxFwd(16, 100000, 1, false, "softmax_vocab_100k");
+BM_ImageNetSoftmaxFwd(16, 500000, 1, false, "softmax_vocab_500k");
+BM_ImageNetSoftmaxFwd(16, 100000, 4, false, "softmax_vocab_100k");
+BM_ImageNetSoftmaxFwd(16, 500000, 4, false, "softmax_vocab_500k");
 
 static void BM_TopK(int iters, int rows, int cols, int k, int num_threads,
                     bool use_gpu, const string& label) {
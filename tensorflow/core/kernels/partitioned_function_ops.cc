@@ -221,6 +221,7 @@ class PartitionedCallOp : public AsyncOpKernel {
     // TODO(akshayka): Consider selecting a runner on a per-device basis,
     // i.e., using device-specific threadpools when available.
     run_opts.runner = ctx->runner();
+    run_opts.run_all_kernels_inline = ctx->run_all_kernels_inline();
     run_opts.source_device = lib->device()->name();
     run_opts.allow_dead_tensors = true;
     // TODO(akshayka): Accommodate the multiple-worker scenario by adding the
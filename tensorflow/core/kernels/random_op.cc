@@ -28,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/hash/crc32c.h"
+#include "tensorflow/core/lib/random/philox_random_batch.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/platform/logging.h"
@@ -101,6 +102,82 @@ struct FillPhiloxRandomTask<Distribution, false> {
   }
 };
 
+// Specializations for the hottest fixed-sample distributions (float uniform
+// and float normal, which back dropout and augmentation noise). Instead of
+// interleaving one scalar Philox call with one transform per group, they
+// generate the raw bits for a whole block of groups with FillPhiloxBatch --
+// whose lock-step lanes auto-vectorize -- and then apply the distribution
+// transform in a second contiguous loop over the block. The output bits are
+// identical to the generic task above, so sharding and determinism are
+// unchanged.
+template <>
+struct FillPhiloxRandomTask<
+    random::UniformDistribution<random::PhiloxRandom, float>, false> {
+  typedef random::UniformDistribution<random::PhiloxRandom, float>
+      Distribution;
+  static void Run(random::PhiloxRandom gen, float* data, int64 size,
+                  int64 start_group, int64 limit_group, Distribution dist) {
+    const int kGroupSize = Distribution::kResultElementCount;
+    static const int64 kBlockGroups = 256;
+
+    gen.Skip(start_group);
+    int64 offset = start_group * kGroupSize;
+
+    uint32 raw[kBlockGroups * PhiloxRandom::kResultElementCount];
+    int64 group = start_group;
+    while (group < limit_group) {
+      const int64 block = std::min(kBlockGroups, limit_group - group);
+      random::FillPhiloxBatch(&gen, raw, block);
+      const int64 block_elements =
+          std::min(block * kGroupSize, size - offset);
+      for (int64 i = 0; i < block_elements; ++i) {
+        data[offset + i] = random::Uint32ToFloat(raw[i]);
+      }
+      offset += block_elements;
+      group += block;
+    }
+  }
+};
+
+template <>
+struct FillPhiloxRandomTask<
+    random::NormalDistribution<random::PhiloxRandom, float>, false> {
+  typedef random::NormalDistribution<random::PhiloxRandom, float>
+      Distribution;
+  static void Run(random::PhiloxRandom gen, float* data, int64 size,
+                  int64 start_group, int64 limit_group, Distribution dist) {
+    const int kGroupSize = Distribution::kResultElementCount;
+    static const int64 kBlockGroups = 256;
+
+    gen.Skip(start_group);
+    int64 offset = start_group * kGroupSize;
+
+    uint32 raw[kBlockGroups * PhiloxRandom::kResultElementCount];
+    int64 group = start_group;
+    while (group < limit_group) {
+      const int64 block = std::min(kBlockGroups, limit_group - group);
+      random::FillPhiloxBatch(&gen, raw, block);
+      const int64 block_elements =
+          std::min(block * kGroupSize, size - offset);
+      // Box-Muller consumes the raw bits in the same pairs as the generic
+      // task, so the transformed values match it exactly.
+      int64 i = 0;
+      for (; i + 2 <= block_elements; i += 2) {
+        random::BoxMullerFloat(raw[i], raw[i + 1], &data[offset + i],
+                               &data[offset + i + 1]);
+      }
+      if (i < block_elements) {
+        float f0;
+        float f1;
+        random::BoxMullerFloat(raw[i], raw[i + 1], &f0, &f1);
+        data[offset + i] = f0;
+      }
+      offset += block_elements;
+      group += block;
+    }
+  }
+};
+
 // Specialization for distribution that takes a variable number of samples for
 // each output. This will be slower due to the generality.
 template <class Distribution>
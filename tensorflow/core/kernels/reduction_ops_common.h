@@ -249,6 +249,78 @@ class ReductionOp : public OpKernel {
 
 namespace functor {
 
+#if defined(EIGEN_HAS_INDEX_LIST)
+// Row-wise (innermost axis) float reductions -- softmax denominators,
+// normalization statistics -- are dominated by one dependent accumulator
+// chain per row when funneled through Eigen's generalized reducer. The
+// specializations below handle the rank-2 inner-axis case (the higher-rank
+// cases also funnel into it through the transpose fallback above) with a
+// block of independent accumulators -- four streams of eight float lanes --
+// combined by a tree at the end, so the compiler can both vectorize the
+// inner loop and hide the latency of the vector op. Whole rows are sharded
+// over the intra-op pool.
+template <typename BinaryOp>
+void ReduceInnerAxis(const CPUDevice& d, typename TTypes<float, 1>::Tensor out,
+                     typename TTypes<float, 2>::ConstTensor in, float init,
+                     BinaryOp op) {
+  const int64 rows = in.dimension(0);
+  const int64 cols = in.dimension(1);
+  const float* in_data = in.data();
+  float* out_data = out.data();
+  auto reduce_rows = [in_data, out_data, cols, init,
+                      op](Eigen::Index first_row, Eigen::Index last_row) {
+    static const int kBlock = 32;
+    for (Eigen::Index r = first_row; r < last_row; ++r) {
+      const float* row = in_data + r * cols;
+      float acc[kBlock];
+      for (int j = 0; j < kBlock; ++j) acc[j] = init;
+      int64 i = 0;
+      for (; i + kBlock <= cols; i += kBlock) {
+        for (int j = 0; j < kBlock; ++j) {
+          acc[j] = op(acc[j], row[i + j]);
+        }
+      }
+      for (; i < cols; ++i) {
+        acc[0] = op(acc[0], row[i]);
+      }
+      for (int width = kBlock / 2; width >= 1; width /= 2) {
+        for (int j = 0; j < width; ++j) {
+          acc[j] = op(acc[j], acc[j + width]);
+        }
+      }
+      out_data[r] = acc[0];
+    }
+  };
+  const Eigen::TensorOpCost cost(/*bytes_loaded=*/cols * sizeof(float),
+                                 /*bytes_stored=*/sizeof(float),
+                                 /*compute_cycles=*/cols);
+  d.parallelFor(rows, cost, reduce_rows);
+}
+
+#define REGISTER_INNER_AXIS_REDUCTION(reducer, init, op)                      \
+  template <>                                                                 \
+  struct ReduceEigenImpl<CPUDevice, TTypes<float, 1>::Tensor,                 \
+                         TTypes<float, 2>::ConstTensor,                       \
+                         Eigen::IndexList<Eigen::type2index<1>>, reducer> {   \
+    void operator()(const CPUDevice& d, TTypes<float, 1>::Tensor out,         \
+                    TTypes<float, 2>::ConstTensor in,                         \
+                    const Eigen::IndexList<Eigen::type2index<1>>&,            \
+                    const reducer&) {                                         \
+      ReduceInnerAxis(d, out, in, init,                                       \
+                      [](float a, float b) { return op; });                   \
+    }                                                                         \
+  };
+
+REGISTER_INNER_AXIS_REDUCTION(Eigen::internal::SumReducer<float>, 0.0f, a + b)
+REGISTER_INNER_AXIS_REDUCTION(Eigen::internal::MaxReducer<float>,
+                              Eigen::NumTraits<float>::lowest(),
+                              Eigen::numext::maxi(a, b))
+REGISTER_INNER_AXIS_REDUCTION(Eigen::internal::MinReducer<float>,
+                              Eigen::NumTraits<float>::highest(),
+                              Eigen::numext::mini(a, b))
+#undef REGISTER_INNER_AXIS_REDUCTION
+#endif  // EIGEN_HAS_INDEX_LIST
+
 template <typename Device, typename Reducer>
 struct ReduceFunctorBase {
   template <typename OUT_T, typename IN_T, typename ReductionAxes>
@@ -189,4 +189,27 @@ static void BM_Bool2DToScalarGPU(int iters, int num_x, int num_y) {
 }
 BENCHMARK(BM_Bool2DToScalarGPU)->RangePair(2048, 8192, 2048, 8192);
 
+// CPU inner-axis (row-wise) reductions; these exercise the specialized
+// multi-accumulator paths in reduction_ops_common.h for the shapes that
+// show up as softmax denominators and normalization statistics.
+static void BM_Sum2DRowReduceCPU(int iters, int num_x, int num_y) {
+  DoRowReduce(iters, "cpu", "Sum", num_x, num_y);
+}
+BENCHMARK(BM_Sum2DRowReduceCPU)->RangePair(1, 8192, 1, 8192);
+
+static void BM_Max2DRowReduceCPU(int iters, int num_x, int num_y) {
+  DoRowReduce(iters, "cpu", "Max", num_x, num_y);
+}
+BENCHMARK(BM_Max2DRowReduceCPU)->RangePair(1, 8192, 1, 8192);
+
+static void BM_Min2DRowReduceCPU(int iters, int num_x, int num_y) {
+  DoRowReduce(iters, "cpu", "Min", num_x, num_y);
+}
+BENCHMARK(BM_Min2DRowReduceCPU)->RangePair(1, 8192, 1, 8192);
+
+static void BM_Sum2DColumnReduceCPU(int iters, int num_x, int num_y) {
+  DoColReduce(iters, "cpu", "Sum", num_x, num_y);
+}
+BENCHMARK(BM_Sum2DColumnReduceCPU)->RangePair(1, 8192, 1, 8192);
+
 }  // end namespace tensorflow
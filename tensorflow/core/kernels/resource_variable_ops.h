@@ -16,6 +16,8 @@ limitations under the License.
 #define TENSORFLOW_CORE_KERNELS_RESOURCE_VARIABLE_OPS_H_
 
 #include "tensorflow/core/framework/op_kernel.h"
+#include "tensorflow/core/framework/resource_mgr.h"
+#include "tensorflow/core/framework/resource_var.h"
 
 namespace tensorflow {
 
@@ -26,6 +28,9 @@ class ReadVariableOp : public OpKernel {
 
  private:
   DataType dtype_;
+  // Steady-state reads resolve against the cache without touching the
+  // resource manager's locks.
+  CachedResourceLookup<Var> cache_;
 };
 
 class ReadVariablesOp : public OpKernel {
@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/kernels/save_restore_tensor.h"
+
+#include <algorithm>
 #include <numeric>
 #include <unordered_map>
 #include <utility>
@@ -23,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/kernels/async_checkpoint_engine.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/strings/str_util.h"
@@ -37,6 +40,75 @@ limitations under the License.
 
 namespace tensorflow {
 
+namespace {
+
+// Serializes the already-validated snapshot of tensors to "filename".
+// This function owns no OpKernelContext state, so it can run on a
+// background thread after the save kernel has returned (see
+// async_checkpoint_engine.h).
+Status WriteTensorSlices(
+    const string& filename,
+    checkpoint::TensorSliceWriter::CreateBuilderFunction builder_func,
+    const std::vector<string>& tensor_names,
+    const std::vector<string>& shapes_and_slices,
+    const std::vector<Tensor>& tensors) {
+  VLOG(1) << "About to save tensors to file " << filename << "...";
+  checkpoint::TensorSliceWriter writer(filename, std::move(builder_func));
+
+  Status s;
+
+  // Process tensors in sorted name order.  This allows us to avoid seeking
+  // during restoration in the common case where we are restoring a full
+  // checkpoint.
+  std::vector<size_t> sorted_name_idx(tensor_names.size());
+  std::iota(sorted_name_idx.begin(), sorted_name_idx.end(), 0);
+  std::sort(sorted_name_idx.begin(), sorted_name_idx.end(),
+            [&tensor_names](size_t a, size_t b) {
+              return tensor_names[a] < tensor_names[b];
+            });
+
+  for (const size_t i : sorted_name_idx) {
+    const string& name = tensor_names[i];
+    const Tensor& input = tensors[i];
+    TensorShape shape(input.shape());
+    TensorSlice slice(input.dims());
+    if (!shapes_and_slices[i].empty()) {
+      const string& shape_spec = shapes_and_slices[i];
+      TensorShape slice_shape;
+      TF_RETURN_IF_ERROR(checkpoint::ParseShapeAndSlice(shape_spec, &shape,
+                                                        &slice, &slice_shape));
+      if (!slice_shape.IsSameSize(input.shape())) {
+        return errors::InvalidArgument(
+            "Slice in shape_and_slice "
+            "specification does not match the "
+            "shape of the tensor to  save: ",
+            shape_spec, ", tensor: ", input.shape().DebugString());
+      }
+    }
+
+#define WRITER_ADD(T)                                           \
+  case DataTypeToEnum<T>::value:                                \
+    s = writer.Add(name, shape, slice, input.flat<T>().data()); \
+    break;
+
+    switch (input.dtype()) {
+      TF_CALL_SAVE_RESTORE_TYPES(WRITER_ADD)
+      default:
+        return errors::Unimplemented("Saving data type ",
+                                     DataTypeString(input.dtype()),
+                                     " not yet supported");
+    }
+#undef WRITER_ADD
+    if (!s.ok()) {
+      return s;
+    }
+  }
+
+  return writer.Finish();
+}
+
+}  // namespace
+
 void SaveTensors(
     OpKernelContext* context,
     checkpoint::TensorSliceWriter::CreateBuilderFunction builder_func,
@@ -79,63 +151,48 @@ void SaveTensors(
                                       N, " names, but received ",
                                       context->num_inputs(), " inputs"));
 
-  VLOG(1) << "About to save tensors to file " << filename_t.flat<string>()(0)
-          << "...";
-  checkpoint::TensorSliceWriter writer(filename_t.flat<string>()(0),
-                                       std::move(builder_func));
+  const bool async = AsyncCheckpointEngine::Enabled();
 
-  Status s;
+  const string filename = filename_t.flat<string>()(0);
   auto tensor_names_flat = tensor_names_t.flat<string>();
-
-  // Process tensors in sorted name order.  This allows us to avoid seeking
-  // during restoration in the common case where we are restoring a full
-  // checkpoint.
-  std::vector<size_t> sorted_name_idx(tensor_names_flat.size());
-  std::iota(sorted_name_idx.begin(), sorted_name_idx.end(), 0);
-  std::sort(sorted_name_idx.begin(), sorted_name_idx.end(),
-            [&tensor_names_flat](size_t a, size_t b) {
-              return tensor_names_flat(a) < tensor_names_flat(b);
-            });
-
-  for (const size_t i : sorted_name_idx) {
-    const string& name = tensor_names_flat(i);
+  std::vector<string> tensor_names(tensor_names_flat.data(),
+                                   tensor_names_flat.data() + N);
+  std::vector<string> shapes_and_slices(N);
+  if (save_slices) {
+    shapes_and_slices.assign(tensor_shapes_and_slices_ptr,
+                             tensor_shapes_and_slices_ptr + N);
+  }
+  std::vector<Tensor> tensors;
+  tensors.reserve(N);
+  for (int i = 0; i < N; ++i) {
     const Tensor& input = context->input(i + kFixedInputs);
-    TensorShape shape(input.shape());
-    TensorSlice slice(input.dims());
-    if (save_slices && !tensor_shapes_and_slices_ptr[i].empty()) {
-      const string& shape_spec = tensor_shapes_and_slices_ptr[i];
-      TensorShape slice_shape;
-      OP_REQUIRES_OK(context, checkpoint::ParseShapeAndSlice(
-                                  shape_spec, &shape, &slice, &slice_shape));
-      OP_REQUIRES(context, slice_shape.IsSameSize(input.shape()),
-                  errors::InvalidArgument(
-                      "Slice in shape_and_slice "
-                      "specification does not match the "
-                      "shape of the tensor to  save: ",
-                      shape_spec, ", tensor: ", input.shape().DebugString()));
-    }
-
-#define WRITER_ADD(T)                                           \
-  case DataTypeToEnum<T>::value:                                \
-    s = writer.Add(name, shape, slice, input.flat<T>().data()); \
-    break;
+    // On the synchronous path the inputs outlive the write, so a plain
+    // buffer-sharing copy suffices; the asynchronous path snapshots so
+    // that in-place updates during the write cannot corrupt the
+    // checkpoint.
+    tensors.push_back(async ? AsyncCheckpointEngine::Snapshot(input) : input);
+  }
 
-    switch (input.dtype()) {
-      TF_CALL_SAVE_RESTORE_TYPES(WRITER_ADD)
-      default:
-        context->SetStatus(errors::Unimplemented("Saving data type ",
-                                                 DataTypeString(input.dtype()),
-                                                 " not yet supported"));
-        return;
-    }
-#undef WRITER_ADD
-    if (!s.ok()) {
-      context->SetStatus(s);
-      return;
-    }
+  if (async) {
+    AsyncCheckpointEngine* engine = AsyncCheckpointEngine::Global();
+    // Failures of a background save are surfaced on the next save.
+    OP_REQUIRES_OK(context, engine->ConsumeLastStatus());
+    // NOTE: std::bind so that the snapshot vectors are moved, not
+    // copied, into the closure.
+    engine->ScheduleSave(std::bind(
+        [filename, builder_func](const std::vector<string>& tensor_names,
+                                 const std::vector<string>& shapes_and_slices,
+                                 const std::vector<Tensor>& tensors) {
+          return WriteTensorSlices(filename, builder_func, tensor_names,
+                                   shapes_and_slices, tensors);
+        },
+        std::move(tensor_names), std::move(shapes_and_slices),
+        std::move(tensors)));
+    return;
   }
 
-  s = writer.Finish();
+  Status s = WriteTensorSlices(filename, std::move(builder_func), tensor_names,
+                               shapes_and_slices, tensors);
   if (!s.ok()) {
     context->SetStatus(s);
   }
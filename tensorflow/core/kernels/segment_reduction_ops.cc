@@ -35,7 +35,10 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/util.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
 #include "tensorflow/core/common_runtime/gpu/gpu_event_mgr.h"
@@ -56,6 +59,21 @@ namespace tensorflow {
 typedef Eigen::ThreadPoolDevice CPUDevice;
 typedef Eigen::GpuDevice GPUDevice;
 
+// Returns true if the opt-in parallel CPU segment reduction paths should be
+// used (enabled with TF_PARALLEL_SEGMENT_REDUCTION=1). The parallel paths
+// partition the work by output segments, so each output row is written by
+// exactly one worker and rows are accumulated in input order; the results
+// are bitwise identical to the serial implementations.
+static bool ParallelSegmentReductionEnabled() {
+  bool enabled = false;
+  Status status = ReadBoolFromEnvVar("TF_PARALLEL_SEGMENT_REDUCTION",
+                                     /*default_val=*/false, &enabled);
+  if (!status.ok()) {
+    LOG(WARNING) << status.error_message();
+  }
+  return enabled;
+}
+
 // Static routines not in the templated class to reduce code size
 static void SegmentReductionValidationHelper(OpKernelContext* context,
                                              const Tensor& input,
@@ -387,6 +405,42 @@ struct UnsortedSegmentFunctor<CPUDevice, T, Index, InitialValueF, ReductionF> {
     const int64 N = segment_ids.dimension(0);
     ReductionF reduction;
     auto data_flat = typename TTypes<T, 2>::ConstTensor(data, N, data_size / N);
+    auto* worker_threads = ctx->device()->tensorflow_cpu_worker_threads();
+    if (ParallelSegmentReductionEnabled() && worker_threads->num_threads > 1 &&
+        num_segments > 1) {
+      // Validate the segment ids up front so that workers do not have to
+      // report errors through shared state.
+      for (int64 i = 0; i < N; ++i) {
+        const Index j = internal::SubtleMustCopy(segment_ids(i));
+        OP_REQUIRES(ctx, j < 0 || FastBoundsCheck(j, num_segments),
+                    errors::InvalidArgument(
+                        "segment_ids", SliceDebugString(segment_ids_shape, i),
+                        " = ", j, " is out of range [0, ", num_segments, ")"));
+      }
+      // Each worker owns a contiguous range of output segments and scans the
+      // full segment id vector, applying only the rows that fall into its
+      // range. Each output row is written by exactly one worker, and rows
+      // are accumulated in input order, so the result is bitwise identical
+      // to the serial loop below.
+      auto work = [&](int64 seg_begin, int64 seg_end) {
+        for (int64 i = 0; i < N; ++i) {
+          const Index j = internal::SubtleMustCopy(segment_ids(i));
+          if (j < seg_begin || j >= seg_end) {
+            continue;
+          }
+          reduction(data_flat.template chip<0>(i), output.template chip<0>(j));
+        }
+      };
+      // Every worker scans all N segment ids, so the useful work per output
+      // segment is roughly the average number of rows mapped to it.
+      const int64 rows_per_segment =
+          (N + static_cast<int64>(num_segments) - 1) / num_segments;
+      const int64 cost_per_segment =
+          (rows_per_segment + 1) * (data_size / N) * sizeof(T);
+      Shard(worker_threads->num_threads, worker_threads->workers, num_segments,
+            cost_per_segment, work);
+      return;
+    }
     for (int64 i = 0; i < N; ++i) {
       Index j = internal::SubtleMustCopy(segment_ids(i));
       if (j < 0) {
@@ -702,6 +756,73 @@ class SparseSegmentReductionOpBase : public OpKernel {
                 errors::InvalidArgument("segment ids must be >= 0"));
     auto output_flat = output->flat_outer_dims<T>();
 
+    auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    if (ParallelSegmentReductionEnabled() && worker_threads->num_threads > 1 &&
+        output_rows > 1) {
+      // Validate the segment ids and record where the run of input rows for
+      // each output row starts. Rows for output row 'r' occupy the range
+      // [segment_offsets[r], segment_offsets[r + 1]); an empty range marks a
+      // gap that must be filled with the default value.
+      std::vector<int64> segment_offsets(output_rows + 1);
+      OutputRow prev_index = -1;
+      for (int64 i = 0; i < num_indices; ++i) {
+        const OutputRow this_index = internal::SubtleMustCopy(segment_vec(i));
+        OP_REQUIRES(context, this_index >= prev_index,
+                    errors::InvalidArgument("segment ids are not increasing"));
+        OP_REQUIRES(
+            context, FastBoundsCheck(this_index, output_rows),
+            errors::InvalidArgument(
+                "Segment id ", this_index, " out of range [0, ", output_rows,
+                "), possibly because 'segment_ids' input is not sorted."));
+        for (OutputRow r = prev_index + 1; r <= this_index; ++r) {
+          segment_offsets[r] = i;
+        }
+        prev_index = this_index;
+      }
+      for (OutputRow r = prev_index + 1; r <= output_rows; ++r) {
+        segment_offsets[r] = num_indices;
+      }
+
+      // Each worker owns a contiguous range of output rows, so the result is
+      // bitwise identical to the serial loop below. Invalid indices are
+      // reported through a shared variable, keeping the smallest position so
+      // the error message does not depend on the sharding.
+      mutex mu;
+      int64 bad_index = -1;
+      auto work = [&](int64 row_begin, int64 row_end) {
+        for (int64 r = row_begin; r < row_end; ++r) {
+          const int64 seg_start = segment_offsets[r];
+          const int64 seg_end = segment_offsets[r + 1];
+          if (seg_start == seg_end) {
+            output_flat.template chip<0>(r).setConstant(default_value_);
+            continue;
+          }
+          auto out = output_flat.template chip<0>(r);
+          const int64 bad_offset =
+              Reduce(input_flat, indices_vec, seg_start, seg_end - seg_start,
+                     out);
+          if (bad_offset >= 0) {
+            mutex_lock l(mu);
+            if (bad_index < 0 || seg_start + bad_offset < bad_index) {
+              bad_index = seg_start + bad_offset;
+            }
+          }
+        }
+      };
+      const int64 rows_per_segment =
+          (num_indices + output_rows - 1) / output_rows;
+      const int64 cost_per_row = (rows_per_segment + 1) * num_col * sizeof(T);
+      Shard(worker_threads->num_threads, worker_threads->workers, output_rows,
+            cost_per_row, work);
+      OP_REQUIRES(
+          context, bad_index < 0,
+          errors::InvalidArgument("Bad: indices[", bad_index,
+                                  "] == ", indices_vec(bad_index),
+                                  " out of range [0, ", input_flat.dimension(0),
+                                  ")"));
+      return;
+    }
+
     int64 start = 0, end = 1;
     // Index from which the output is not initialized.
     OutputRow uninitialized_index = 0;
@@ -113,6 +113,128 @@ BM_Reduce_Arg(64, 32, 2);
 BM_Reduce_Arg(4096, 32, 2);
 BM_Reduce_Arg(4096, 128, 2);
 
+static void UnsortedSegmentSumHelper(int iters, int num_rows, int num_cols,
+                                     int num_segments, bool parallel) {
+  testing::StopTiming();
+  if (parallel) {
+    setenv("TF_PARALLEL_SEGMENT_REDUCTION", "1", 1 /* overwrite */);
+  }
+  Graph* g = new Graph(OpRegistry::Global());
+
+  Tensor input(DT_FLOAT, TensorShape({num_rows, num_cols}));
+  input.flat<float>().setRandom();
+
+  Tensor segments(DT_INT32, TensorShape({num_rows}));
+  auto segments_flat = segments.flat<int32>();
+  for (int i = 0; i < num_rows; ++i) {
+    segments_flat(i) = (i * 31) % num_segments;
+  }
+
+  Tensor num_segments_t(DT_INT32, TensorShape({}));
+  num_segments_t.scalar<int32>()() = num_segments;
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "UnsortedSegmentSum")
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, segments))
+                  .Input(test::graph::HostConstant(g, num_segments_t))
+                  .Attr("T", DT_FLOAT)
+                  .Finalize(g, &node));
+
+  testing::UseRealTime();
+  testing::BytesProcessed(static_cast<int64>(iters) * num_rows * num_cols *
+                          sizeof(float));
+  testing::StartTiming();
+  test::Benchmark("cpu", g).Run(iters);
+  if (parallel) {
+    testing::StopTiming();
+    unsetenv("TF_PARALLEL_SEGMENT_REDUCTION");
+    testing::StartTiming();
+  }
+}
+
+static void BM_UnsortedSegmentSum(int iters, int num_rows, int num_segments) {
+  UnsortedSegmentSumHelper(iters, num_rows, 128, num_segments, false);
+}
+
+static void BM_UnsortedSegmentSum_Parallel(int iters, int num_rows,
+                                           int num_segments) {
+  UnsortedSegmentSumHelper(iters, num_rows, 128, num_segments, true);
+}
+
+BENCHMARK(BM_UnsortedSegmentSum)
+    ->ArgPair(16 * 1024, 64)
+    ->ArgPair(16 * 1024, 4096)
+    ->ArgPair(256 * 1024, 64)
+    ->ArgPair(256 * 1024, 4096)
+    ->ArgPair(256 * 1024, 64 * 1024);
+BENCHMARK(BM_UnsortedSegmentSum_Parallel)
+    ->ArgPair(16 * 1024, 64)
+    ->ArgPair(16 * 1024, 4096)
+    ->ArgPair(256 * 1024, 64)
+    ->ArgPair(256 * 1024, 4096)
+    ->ArgPair(256 * 1024, 64 * 1024);
+
+static void SparseSegmentSumHelper(int iters, int num_rows, int num_cols,
+                                   int num_segments, bool parallel) {
+  testing::StopTiming();
+  if (parallel) {
+    setenv("TF_PARALLEL_SEGMENT_REDUCTION", "1", 1 /* overwrite */);
+  }
+  Graph* g = new Graph(OpRegistry::Global());
+
+  Tensor input(DT_FLOAT, TensorShape({num_rows, num_cols}));
+  input.flat<float>().setRandom();
+
+  Tensor indices(DT_INT32, TensorShape({num_rows}));
+  auto indices_flat = indices.flat<int32>();
+  Tensor segments(DT_INT32, TensorShape({num_rows}));
+  auto segments_flat = segments.flat<int32>();
+  for (int i = 0; i < num_rows; ++i) {
+    indices_flat(i) = (i * 31) % num_rows;
+    segments_flat(i) = static_cast<int64>(i) * num_segments / num_rows;
+  }
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "SparseSegmentSum")
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, indices))
+                  .Input(test::graph::Constant(g, segments))
+                  .Attr("T", DT_FLOAT)
+                  .Finalize(g, &node));
+
+  testing::UseRealTime();
+  testing::BytesProcessed(static_cast<int64>(iters) * num_rows * num_cols *
+                          sizeof(float));
+  testing::StartTiming();
+  test::Benchmark("cpu", g).Run(iters);
+  if (parallel) {
+    testing::StopTiming();
+    unsetenv("TF_PARALLEL_SEGMENT_REDUCTION");
+    testing::StartTiming();
+  }
+}
+
+static void BM_SparseSegmentSum(int iters, int num_rows, int num_segments) {
+  SparseSegmentSumHelper(iters, num_rows, 128, num_segments, false);
+}
+
+static void BM_SparseSegmentSum_Parallel(int iters, int num_rows,
+                                         int num_segments) {
+  SparseSegmentSumHelper(iters, num_rows, 128, num_segments, true);
+}
+
+BENCHMARK(BM_SparseSegmentSum)
+    ->ArgPair(16 * 1024, 64)
+    ->ArgPair(16 * 1024, 4096)
+    ->ArgPair(256 * 1024, 4096)
+    ->ArgPair(256 * 1024, 64 * 1024);
+BENCHMARK(BM_SparseSegmentSum_Parallel)
+    ->ArgPair(16 * 1024, 64)
+    ->ArgPair(16 * 1024, 4096)
+    ->ArgPair(256 * 1024, 4096)
+    ->ArgPair(256 * 1024, 64 * 1024);
+
 static void SparseSegmentMeanGradHelper(int iters, float uniqueness, int size) {
   testing::StopTiming();
   Graph* g = new Graph(OpRegistry::Global());
@@ -201,7 +201,10 @@ class SerializeManySparseOp : public SerializeManySparseOpBase<U> {
     OP_REQUIRES_OK(context, this->Initialize(N, &serialized_sparse));
     auto serialized_sparse_t = serialized_sparse.matrix<U>();
 
-    OP_REQUIRES_OK(context, input_st.IndicesValid());
+    OP_REQUIRES_OK(context,
+                   input_st.IndicesValid(
+                       context->device()->tensorflow_cpu_worker_threads()
+                           ->workers));
 
     // Initialize output with empty values and the proper shapes.
     Tensor output_blank_indices(DT_INT64, {0, rank - 1});
@@ -18,6 +18,8 @@ limitations under the License.
 #include "tensorflow/core/lib/strings/str_util.h"
 #define EIGEN_USE_THREADS
 
+#include <cmath>
+
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
@@ -46,6 +48,46 @@ struct SoftmaxFunctorBase {
 template <typename T>
 struct SoftmaxFunctor<CPUDevice, T> : SoftmaxFunctorBase<CPUDevice, T> {};
 
+// Row-tiled implementation for float on CPU. The generic Eigen
+// implementation evaluates each stage (max, exp, sum, normalize) as a
+// separate whole-tensor pass, so for wide output layers (vocabulary-sized
+// class counts) the logits and softmax buffers are streamed through memory
+// several times and the op becomes bandwidth bound. Processing one row at
+// a time keeps the row resident in cache across all stages; rows are
+// sharded over the intra-op pool.
+template <>
+struct SoftmaxFunctor<CPUDevice, float> {
+  void operator()(const CPUDevice& d, TTypes<float>::ConstMatrix logits,
+                  TTypes<float>::Matrix softmax, const bool log) {
+    const int64 batch_size = logits.dimension(0);
+    const int64 num_classes = logits.dimension(1);
+    const float* logits_data = logits.data();
+    float* softmax_data = softmax.data();
+    auto compute_rows = [logits_data, softmax_data, num_classes,
+                         log](Eigen::Index first_row, Eigen::Index last_row) {
+      typedef Eigen::Map<const Eigen::ArrayXf> ConstRow;
+      typedef Eigen::Map<Eigen::ArrayXf> Row;
+      for (Eigen::Index r = first_row; r < last_row; ++r) {
+        ConstRow in_row(logits_data + r * num_classes, num_classes);
+        Row out_row(softmax_data + r * num_classes, num_classes);
+        const float row_max = in_row.maxCoeff();
+        if (log) {
+          out_row = in_row - row_max;
+          out_row -= std::log(out_row.exp().sum());
+        } else {
+          out_row = (in_row - row_max).exp();
+          out_row *= 1.0f / out_row.sum();
+        }
+      }
+    };
+    const Eigen::TensorOpCost cost(
+        /*bytes_loaded=*/3 * num_classes * sizeof(float),
+        /*bytes_stored=*/2 * num_classes * sizeof(float),
+        /*compute_cycles=*/10 * num_classes);
+    d.parallelFor(batch_size, cost, compute_rows);
+  }
+};
+
 #ifdef TENSORFLOW_USE_SYCL
 template <typename T>
 struct SoftmaxFunctor<SYCLDevice, T> : SoftmaxFunctorBase<SYCLDevice, T> {};
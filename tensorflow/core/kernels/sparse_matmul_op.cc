@@ -33,6 +33,7 @@ limitations under the License.
 #include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
+#include "tensorflow/core/lib/hash/hash.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/core/platform/mutex.h"
@@ -785,8 +786,40 @@ class SparseMatMul {
   using MatrixMapR = BasicMatrixMap<TR>;
 
  public:
-  // Not used; added to match interface of LibxsmmSparseMatMul
-  struct TensorInfoCache {};
+  // Cache of the sparse encoding of the left matrix, keyed on a fingerprint
+  // of its contents. Encoding the left matrix into SparseSlices makes a full
+  // pass over it and allocates index/value arrays for every grid block.
+  // Pruned weight matrices are typically constant across steps at inference
+  // time, so the encoding from the previous call is reused whenever the
+  // fingerprint, dimensions and blocking match; only a read-only hash pass
+  // over the matrix is paid per call. Weights that change on every call
+  // (e.g. while training) can never hit, so after a few consecutive misses
+  // the fingerprint pass is skipped as well and the cache stays disabled for
+  // the lifetime of the kernel.
+  struct TensorInfoCache {
+    // Holds the encoded slices. Entries are shared so that a concurrent
+    // Compute call can keep using an entry while it is being replaced.
+    struct Entry {
+      std::vector<std::vector<SparseSlice<TL>*>> slices;
+      ~Entry() {
+        for (auto& slice_vector : slices) {
+          gtl::STLDeleteElements(&slice_vector);
+        }
+      }
+    };
+
+    mutex lock;
+    bool disabled GUARDED_BY(lock);
+    int consecutive_misses GUARDED_BY(lock);
+    uint64 fingerprint GUARDED_BY(lock);
+    std::shared_ptr<Entry> entry GUARDED_BY(lock);
+
+    TensorInfoCache()
+        : disabled(false), consecutive_misses(0), fingerprint(0) {}
+
+   private:
+    TF_DISALLOW_COPY_AND_ASSIGN(TensorInfoCache);
+  };
 
   // Perform matrix multiplication of "left" and "right", and store the result
   // in *"output".
@@ -1528,20 +1561,55 @@ inline void LibxsmmSparseMatMul<TL, TR>::Compute(
 //    {l_i} and JB elements from {r_j} and compute the IB * JB inner products.
 template <typename TL, typename TR>
 inline void SparseMatMul<TL, TR>::Compute(
-    typename SparseMatMul<TL, TR>::TensorInfoCache* /*cache*/,
+    typename SparseMatMul<TL, TR>::TensorInfoCache* cache,
     const typename SparseMatMul<TL, TR>::ConstMatrixMapL& left,
     const typename SparseMatMul<TL, TR>::ConstMatrixMapR& right,
     bool transpose_left, const DeviceBase::CpuWorkerThreads* thread_pool,
     bool transpose_output, MatrixMap* output) {
+  static const int kMaxConsecutiveCacheMisses = 3;
   const int num_threads = thread_pool->num_threads;
   int KR, NR, KL, JB, IB;
   ComputeBlockSizes(left, right, transpose_left, num_threads, &KR, &NR, &KL,
                     &JB, &IB);
-  // Slice the left matrix
-  std::vector<std::vector<SparseSlice<TL>*>> left_slices;
-  std::unique_ptr<BlockingCounter> sparse_slice_counter =
-      CreateSparseSlices(ConstMatrixMapL(left.data(), left.dimensions()),
-                         transpose_left, M, K, KL, &left_slices, thread_pool);
+  // Slice the left matrix, reusing the encoding from a previous call when the
+  // cache holds one for the same contents and blocking.
+  uint64 fingerprint = 0;
+  bool fingerprinted = false;
+  bool cache_hit = false;
+  std::shared_ptr<typename TensorInfoCache::Entry> encoded;
+  if (cache != nullptr) {
+    bool probe;
+    {
+      mutex_lock l(cache->lock);
+      probe = !cache->disabled;
+    }
+    if (probe) {
+      // The encoding depends on the contents, the dimensions, the transpose
+      // flag and the column blocking, so all of them go into the key. The
+      // kernel does not see a version number for its inputs, so a content
+      // fingerprint stands in for one.
+      fingerprint = Hash64(reinterpret_cast<const char*>(left.data()),
+                           left.size() * sizeof(TL));
+      fingerprint = Hash64Combine(fingerprint, left.dimension(0));
+      fingerprint = Hash64Combine(
+          fingerprint, (static_cast<uint64>(KL) << 1) | transpose_left);
+      fingerprinted = true;
+      mutex_lock l(cache->lock);
+      if (cache->entry && cache->fingerprint == fingerprint) {
+        encoded = cache->entry;
+        cache->consecutive_misses = 0;
+        cache_hit = true;
+      }
+    }
+  }
+  std::unique_ptr<BlockingCounter> sparse_slice_counter;
+  if (!cache_hit) {
+    encoded.reset(new typename TensorInfoCache::Entry());
+    sparse_slice_counter = CreateSparseSlices(
+        ConstMatrixMapL(left.data(), left.dimensions()), transpose_left, M, K,
+        KL, &encoded->slices, thread_pool);
+  }
+  std::vector<std::vector<SparseSlice<TL>*>>& left_slices = encoded->slices;
   const int num_left_slices = left_slices.size();
 
   const int right_dim0 = right.dimension(0);
@@ -1616,8 +1684,20 @@ inline void SparseMatMul<TL, TR>::Compute(
       right_slices.clear();
     }
   }
-  for (auto& left_slice : left_slices) {
-    gtl::STLDeleteElements(&left_slice);
+  // The encoded slices are owned by "encoded" and freed when the last user
+  // drops its reference. On a miss, publish the new encoding; if the left
+  // matrix keeps changing, give up on caching to stop paying for the
+  // fingerprint pass.
+  if (fingerprinted && !cache_hit) {
+    mutex_lock l(cache->lock);
+    ++cache->consecutive_misses;
+    if (cache->consecutive_misses > kMaxConsecutiveCacheMisses) {
+      cache->disabled = true;
+      cache->entry.reset();
+    } else {
+      cache->fingerprint = fingerprint;
+      cache->entry = encoded;
+    }
   }
 }
 
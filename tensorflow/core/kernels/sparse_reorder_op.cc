@@ -65,7 +65,9 @@ class SparseReorderOp : public OpKernel {
         context, sparse::SparseTensor::Create(input_ind, input_val, input_shape,
                                               std_order, &input_sp));
 
-    if (input_sp.IndicesValid().ok()) {
+    thread::ThreadPool* pool =
+        context->device()->tensorflow_cpu_worker_threads()->workers;
+    if (input_sp.IndicesValid(pool).ok()) {
       context->set_output(0, input_sp.indices());
       context->set_output(1, input_sp.values());
     } else {
@@ -75,7 +77,7 @@ class SparseReorderOp : public OpKernel {
                      sparse::SparseTensor::Create(tensor::DeepCopy(input_ind),
                                                   tensor::DeepCopy(input_val),
                                                   input_shape, &reordered_sp));
-      reordered_sp.Reorder<T>(std_order);
+      reordered_sp.Reorder<T>(std_order, pool);
       context->set_output(0, reordered_sp.indices());
       context->set_output(1, reordered_sp.values());
     }
@@ -125,7 +125,9 @@ class SparseToDense : public OpKernel {
                                                 output->shape(), order, &st));
 
     if (validate_indices_) {
-      OP_REQUIRES_OK(c, st.IndicesValid());
+      OP_REQUIRES_OK(
+          c, st.IndicesValid(c->device()->tensorflow_cpu_worker_threads()
+                                 ->workers));
     }
 
     output->flat<T>().setConstant(default_value.scalar<T>()());
@@ -15,6 +15,9 @@ limitations under the License.
 
 // See docs in ../ops/audio_ops.cc
 
+#include <memory>
+#include <vector>
+
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
@@ -22,6 +25,7 @@ limitations under the License.
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/kernels/spectrogram.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 
@@ -118,4 +122,114 @@ class AudioSpectrogramOp : public OpKernel {
 REGISTER_KERNEL_BUILDER(Name("AudioSpectrogram").Device(DEVICE_CPU),
                         AudioSpectrogramOp);
 
+// Stateful variant of AudioSpectrogram for streaming audio. The samples
+// at the tail of each input that have not yet completed a window are
+// buffered inside the kernel, so successive calls can feed consecutive
+// chunks of a stream and each call only pays for the FFTs of the frames
+// it newly completes, instead of re-transforming the overlapping history
+// every time. The output height is therefore the number of frames
+// finished by this call, which varies until the stream warms up.
+class StreamingAudioSpectrogramOp : public OpKernel {
+ public:
+  explicit StreamingAudioSpectrogramOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("window_size", &window_size_));
+    OP_REQUIRES_OK(context, context->GetAttr("stride", &stride_));
+    OP_REQUIRES_OK(context,
+                   context->GetAttr("magnitude_squared", &magnitude_squared_));
+  }
+
+  void Compute(OpKernelContext* context) override {
+    const Tensor& input = context->input(0);
+    OP_REQUIRES(context, input.dims() == 2,
+                errors::InvalidArgument("input must be 2-dimensional",
+                                        input.shape().DebugString()));
+    const auto input_as_matrix = input.matrix<float>();
+
+    const int64 sample_count = input.dim_size(0);
+    const int64 channel_count = input.dim_size(1);
+
+    mutex_lock lock(mu_);
+    if (spectrograms_.empty()) {
+      for (int64 channel = 0; channel < channel_count; ++channel) {
+        spectrograms_.push_back(std::unique_ptr<Spectrogram>(new Spectrogram));
+        OP_REQUIRES(
+            context, spectrograms_.back()->Initialize(window_size_, stride_),
+            errors::InvalidArgument(
+                "Spectrogram initialization failed for window size ",
+                window_size_, " and stride ", stride_));
+      }
+    }
+    OP_REQUIRES(
+        context, channel_count == static_cast<int64>(spectrograms_.size()),
+        errors::InvalidArgument(
+            "Channel count must stay constant across a stream: started with ",
+            spectrograms_.size(), " but got ", channel_count));
+
+    const int64 output_width = spectrograms_[0]->output_frequency_channels();
+
+    std::vector<float> input_for_channel(sample_count);
+    std::vector<std::vector<std::vector<float>>> outputs_per_channel(
+        channel_count);
+    for (int64 channel = 0; channel < channel_count; ++channel) {
+      for (int i = 0; i < sample_count; ++i) {
+        input_for_channel[i] = input_as_matrix(i, channel);
+      }
+      OP_REQUIRES(
+          context,
+          spectrograms_[channel]->ComputeSquaredMagnitudeSpectrogram(
+              input_for_channel, &outputs_per_channel[channel]),
+          errors::InvalidArgument("Spectrogram compute failed"));
+      OP_REQUIRES(
+          context,
+          outputs_per_channel[channel].size() == outputs_per_channel[0].size(),
+          errors::InvalidArgument(
+              "Spectrogram channels produced inconsistent frame counts: ",
+              outputs_per_channel[0].size(), " vs ",
+              outputs_per_channel[channel].size()));
+    }
+
+    // Every channel has seen the same number of samples, so they all
+    // complete the same number of new frames.
+    const int64 output_height = outputs_per_channel[0].size();
+    Tensor* output_tensor = nullptr;
+    OP_REQUIRES_OK(
+        context,
+        context->allocate_output(
+            0, TensorShape({channel_count, output_height, output_width}),
+            &output_tensor));
+    auto output_flat = output_tensor->flat<float>().data();
+
+    for (int64 channel = 0; channel < channel_count; ++channel) {
+      float* output_slice =
+          output_flat + (channel * output_height * output_width);
+      for (int row_index = 0; row_index < output_height; ++row_index) {
+        const std::vector<float>& spectrogram_row =
+            outputs_per_channel[channel][row_index];
+        DCHECK_EQ(spectrogram_row.size(), output_width);
+        float* output_row = output_slice + (row_index * output_width);
+        if (magnitude_squared_) {
+          for (int i = 0; i < output_width; ++i) {
+            output_row[i] = spectrogram_row[i];
+          }
+        } else {
+          for (int i = 0; i < output_width; ++i) {
+            output_row[i] = sqrtf(spectrogram_row[i]);
+          }
+        }
+      }
+    }
+  }
+
+ private:
+  int32 window_size_;
+  int32 stride_;
+  bool magnitude_squared_;
+
+  mutex mu_;
+  std::vector<std::unique_ptr<Spectrogram>> spectrograms_ GUARDED_BY(mu_);
+};
+REGISTER_KERNEL_BUILDER(Name("StreamingAudioSpectrogram").Device(DEVICE_CPU),
+                        StreamingAudioSpectrogramOp);
+
 }  // namespace tensorflow
@@ -20,6 +20,7 @@ limitations under the License.
 #include <vector>
 
 #include "tensorflow/cc/client/client_session.h"
+#include "tensorflow/cc/ops/array_ops.h"
 #include "tensorflow/cc/ops/audio_ops.h"
 #include "tensorflow/cc/ops/const_op.h"
 #include "tensorflow/cc/ops/math_ops.h"
@@ -101,6 +102,43 @@ TEST(SpectrogramOpTest, SquaredTest) {
       test::AsTensor<float>({0, 1, 4, 1, 0}, TensorShape({1, 1, 5})), 1e-3);
 }
 
+TEST(SpectrogramOpTest, StreamingMatchesOneShot) {
+  Scope root = Scope::NewRootScope();
+
+  Output audio_placeholder =
+      Placeholder(root.WithOpName("audio_placeholder"), DT_FLOAT,
+                  Placeholder::Shape(TensorShape({4, 1})));
+
+  StreamingAudioSpectrogram spectrogram_op = StreamingAudioSpectrogram(
+      root.WithOpName("spectrogram_op"), audio_placeholder, 8, 1);
+
+  TF_ASSERT_OK(root.status());
+
+  ClientSession session(root);
+  std::vector<Tensor> outputs;
+
+  // The first chunk doesn't fill a whole window, so no frames come out
+  // yet; the samples stay buffered inside the op.
+  Tensor first_chunk(DT_FLOAT, TensorShape({4, 1}));
+  test::FillValues<float>(&first_chunk, {-1.0f, 0.0f, 1.0f, 0.0f});
+  TF_EXPECT_OK(session.Run({{audio_placeholder, first_chunk}},
+                           {spectrogram_op.spectrogram}, &outputs));
+  EXPECT_EQ(3, outputs[0].dims());
+  EXPECT_EQ(1, outputs[0].dim_size(0));
+  EXPECT_EQ(0, outputs[0].dim_size(1));
+  EXPECT_EQ(5, outputs[0].dim_size(2));
+
+  // The second chunk completes the window, producing the same frame that
+  // AudioSpectrogram emits for the concatenated eight samples.
+  Tensor second_chunk(DT_FLOAT, TensorShape({4, 1}));
+  test::FillValues<float>(&second_chunk, {-1.0f, 0.0f, 1.0f, 0.0f});
+  TF_EXPECT_OK(session.Run({{audio_placeholder, second_chunk}},
+                           {spectrogram_op.spectrogram}, &outputs));
+  test::ExpectTensorNear<float>(
+      outputs[0],
+      test::AsTensor<float>({0, 1, 2, 1, 0}, TensorShape({1, 1, 5})), 1e-3);
+}
+
 }  // namespace
 }  // namespace ops
 }  // namespace tensorflow
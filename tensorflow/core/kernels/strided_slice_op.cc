@@ -38,37 +38,79 @@ limitations under the License.
 #include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/platform/prefetch.h"
 #include "tensorflow/core/util/strided_slice_op.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 namespace {
 
 template <typename T>
 struct MemCpyFunctor {
+  // Copies a stride-1 slice by decomposing it into contiguous runs: the
+  // innermost dimensions that are fully covered form, together with the
+  // extent of the first partially covered dimension, a run that is
+  // contiguous in both the input and the output. The runs are copied with
+  // memcpy and sharded over the intra-op threadpool.
   // Returns true if the copy was made with memcpy, false otherwise.
-  bool Copy(const Tensor& input, const gtl::InlinedVector<int64, 4>& begin,
+  bool Copy(OpKernelContext* context, const Tensor& input,
+            const gtl::InlinedVector<int64, 4>& begin,
             const gtl::InlinedVector<int64, 4>& end, Tensor* result) {
-    if (DataTypeCanUseMemcpy(DataTypeToEnum<T>::v())) {
-      auto in = input.tensor<T, 2>();
-      auto output = result->tensor<T, 2>();
-      // TODO(agarwal): Consider multi-threading if size[0] is large
-      for (int row_in = begin[0], row_out = 0; row_in < end[0];
-           ++row_in, ++row_out) {
-        if (row_in + 1 < end[0]) {
-          port::prefetch<port::PREFETCH_HINT_T0>(&output(row_in + 1, 0));
-          port::prefetch<port::PREFETCH_HINT_T0>(&in(row_in + 1, begin[1]));
+    if (!DataTypeCanUseMemcpy(DataTypeToEnum<T>::v())) {
+      return false;
+    }
+    const int dims = input.dims();
+    // Find the innermost dimension such that every dimension after it is
+    // fully covered by the slice.
+    int inner = dims - 1;
+    while (inner > 0 && begin[inner] == 0 &&
+           end[inner] == input.dim_size(inner)) {
+      --inner;
+    }
+    int64 run = end[inner] - begin[inner];
+    for (int i = inner + 1; i < dims; ++i) {
+      run *= input.dim_size(i);
+    }
+    int64 num_runs = 1;
+    for (int i = 0; i < inner; ++i) {
+      num_runs *= end[i] - begin[i];
+    }
+    if (run == 0 || num_runs == 0) {
+      return false;
+    }
+    gtl::InlinedVector<int64, 4> input_stride(dims);
+    input_stride[dims - 1] = 1;
+    for (int i = dims - 2; i >= 0; --i) {
+      input_stride[i] = input_stride[i + 1] * input.dim_size(i + 1);
+    }
+    const T* in = input.flat<T>().data();
+    T* out = result->flat<T>().data();
+    // Runs are indexed in row-major order over the sliced outer dimensions;
+    // decompose the run index to find the input offset.
+    auto copy_runs = [&](int64 start_run, int64 limit_run) {
+      for (int64 r = start_run; r < limit_run; ++r) {
+        int64 remaining = r;
+        int64 offset = begin[inner] * input_stride[inner];
+        for (int i = inner - 1; i >= 0; --i) {
+          const int64 size = end[i] - begin[i];
+          offset += (begin[i] + remaining % size) * input_stride[i];
+          remaining /= size;
         }
-        memcpy(&output(row_out, 0), &in(row_in, begin[1]),
-               (end[1] - begin[1]) * sizeof(T));
+        if (r + 1 < limit_run) {
+          port::prefetch<port::PREFETCH_HINT_T0>(out + (r + 1) * run);
+        }
+        memcpy(out + r * run, in + offset, run * sizeof(T));
       }
-      return true;
-    }
-    return false;
+    };
+    auto worker_threads = context->device()->tensorflow_cpu_worker_threads();
+    Shard(worker_threads->num_threads, worker_threads->workers, num_runs,
+          run * sizeof(T) /* cost_per_unit */, copy_runs);
+    return true;
   }
 };
 
 template <>
 struct MemCpyFunctor<ResourceHandle> {
-  bool Copy(const Tensor& input, const gtl::InlinedVector<int64, 4>& begin,
+  bool Copy(OpKernelContext* context, const Tensor& input,
+            const gtl::InlinedVector<int64, 4>& begin,
             const gtl::InlinedVector<int64, 4>& end, Tensor* result) {
     return false;
   }
@@ -141,17 +183,15 @@ class StridedSliceOp : public OpKernel {
     const int processing_dims = processing_shape.dims();
 
     if (processing_shape.num_elements() > 0) {
-      // Optimization #3, slice has stride 1 in all dimensions
-      // Optimization #3A, slice has only two dimensions
-      // TODO(aselle): Here we are restricting to processing_shape and
-      // final_shape being 2D. This isn't strictly necessary, but I don't
-      // want to blow up code gen size, because to shape<> you need static
-      // NDIM and T
+      // Optimization #3, slice has stride 1 in all dimensions, so it
+      // decomposes into contiguous runs that are copied with sharded
+      // memcpys. The result is written through its flat buffer, which is
+      // valid for any final_shape since new_axis_mask == 0 and shrink axes
+      // only drop size-1 dimensions.
       if (is_simple_slice && std::is_same<Device, CPUDevice>::value &&
-          input_dims == 2 && processing_shape.dims() == 2 &&
-          final_shape.dims() == 2 && new_axis_mask == 0) {
+          processing_dims == input_dims && new_axis_mask == 0) {
         MemCpyFunctor<T> functor;
-        if (functor.Copy(input, begin, end, result)) {
+        if (functor.Copy(context, input, begin, end, result)) {
           return;
         }
       }
@@ -242,6 +282,17 @@ class StridedSliceGradOp : public OpKernel {
 
     if (!context->status().ok()) return;
 
+    // If the slice was the identity, the scatter covers the whole output;
+    // the gradient is dy reshaped to the input shape and both the zero-fill
+    // and the strided scatter can be skipped.
+    if (is_identity) {
+      Tensor tmp;
+      OP_REQUIRES(context, tmp.CopyFrom(context->input(4), input_shape),
+                  errors::Internal("Copy failed"));
+      context->set_output(0, tmp);
+      return;
+    }
+
     // const int input_dims = input.dims();
     const int processing_dims = processing_shape.dims();
     Tensor* result = nullptr;
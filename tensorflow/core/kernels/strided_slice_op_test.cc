@@ -94,6 +94,58 @@ static void BM_SliceBFloat16(int iters, int dim2) {
 
 BENCHMARK(BM_SliceBFloat16)->Arg(100)->Arg(1000)->Arg(10000);
 
+// Slices a 3-D tensor along its two outer dimensions, keeping the inner
+// dimension whole, to exercise the sharded memcpy path.
+template <typename T>
+static void Slice3DHelper(int iters, int size) {
+  testing::StopTiming();
+  Graph* g = new Graph(OpRegistry::Global());
+  DataType dt = DataTypeToEnum<T>::v();
+  int kDim = 100;
+  int kMaxSize = 1500;
+  int kInner = 32;
+  CHECK_LT(size, kMaxSize);
+
+  Tensor begin(DT_INT32, TensorShape({3}));
+  begin.flat<int32>()(0) = 10;
+  begin.flat<int32>()(1) = 10;
+  begin.flat<int32>()(2) = 0;
+
+  Tensor end(DT_INT32, TensorShape({3}));
+  end.flat<int32>()(0) = 10 + kDim;
+  end.flat<int32>()(1) = 10 + size;
+  end.flat<int32>()(2) = kInner;
+
+  Tensor strides(DT_INT32, TensorShape({3}));
+  strides.flat<int32>()(0) = 1;
+  strides.flat<int32>()(1) = 1;
+  strides.flat<int32>()(2) = 1;
+
+  Tensor input(dt, TensorShape({2 * kDim, kMaxSize, kInner}));
+  input.flat<T>().setRandom();
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "StridedSlice")
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::Constant(g, begin))
+                  .Input(test::graph::Constant(g, end))
+                  .Input(test::graph::Constant(g, strides))
+                  .Attr("T", dt)
+                  .Finalize(g, &node));
+
+  testing::BytesProcessed(static_cast<int64>(iters) * kDim * size * kInner *
+                          sizeof(T));
+  testing::StartTiming();
+  test::Benchmark("cpu", g).Run(iters);
+  testing::UseRealTime();
+}
+
+static void BM_Slice3DFloat(int iters, int dim1) {
+  Slice3DHelper<float>(iters, dim1);
+}
+
+BENCHMARK(BM_Slice3DFloat)->Arg(100)->Arg(1000);
+
 static void BM_ValidateStridedSliceOp(int iters) {
   testing::StopTiming();
   int kDim = 100;
@@ -18,16 +18,24 @@ limitations under the License.
 
 // See docs in ../ops/summary_ops.cc.
 
+#include <float.h>
+
+#include <algorithm>
+#include <memory>
 #include <unordered_set>
+#include <vector>
 
 #include "tensorflow/core/framework/op_kernel.h"
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/resource_mgr.h"
 #include "tensorflow/core/framework/summary.pb.h"
+#include "tensorflow/core/kernels/boosted_trees/quantiles/weighted_quantiles_stream.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/gtl/array_slice.h"
 #include "tensorflow/core/lib/histogram/histogram.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
@@ -84,20 +92,63 @@ class SummaryHistoOp : public OpKernel {
     const auto flat = values.flat<T>();
     OP_REQUIRES(c, IsLegacyScalar(tags.shape()),
                 errors::InvalidArgument("tags must be scalar"));
-    // Build histogram of values in "values" tensor
+    // Build histogram of values in "values" tensor.  Large tensors are
+    // sharded across the worker threads into per-shard histograms that
+    // are merged at the end, since per-element bucketing of e.g. a
+    // full set of model weights on one thread measurably stalls the
+    // step when histogram summaries are enabled.
     histogram::Histogram histo;
-    for (int64 i = 0; i < flat.size(); i++) {
-      const double double_val = static_cast<double>(flat(i));
-      if (Eigen::numext::isnan(double_val)) {
+    const int64 num_elements = flat.size();
+    const T* data = flat.data();
+    bool has_bad_value = false;
+    double bad_value = 0;
+    auto* worker_threads = c->device()->tensorflow_cpu_worker_threads();
+    const int64 num_shards =
+        (worker_threads == nullptr)
+            ? 1
+            : std::min<int64>(worker_threads->num_threads,
+                              num_elements / kMinElementsPerShard);
+    if (num_shards <= 1) {
+      AddRange(data, 0, num_elements, &histo, &has_bad_value, &bad_value);
+    } else {
+      const int64 block = (num_elements + num_shards - 1) / num_shards;
+      std::vector<std::unique_ptr<histogram::Histogram>> shard_histos(
+          num_shards);
+      std::vector<char> shard_has_bad(num_shards, 0);
+      std::vector<double> shard_bad_value(num_shards, 0);
+      for (auto& shard_histo : shard_histos) {
+        shard_histo.reset(new histogram::Histogram);
+      }
+      auto work = [&](int64 start_shard, int64 limit_shard) {
+        for (int64 s = start_shard; s < limit_shard; ++s) {
+          const int64 start = s * block;
+          const int64 limit = std::min(num_elements, start + block);
+          bool bad = false;
+          AddRange(data, start, limit, shard_histos[s].get(), &bad,
+                   &shard_bad_value[s]);
+          shard_has_bad[s] = bad;
+        }
+      };
+      Shard(worker_threads->num_threads, worker_threads->workers, num_shards,
+            block, work);
+      for (int64 s = 0; s < num_shards; ++s) {
+        if (shard_has_bad[s]) {
+          has_bad_value = true;
+          bad_value = shard_bad_value[s];
+          break;
+        }
+        histo.Merge(*shard_histos[s]);
+      }
+    }
+    if (has_bad_value) {
+      if (Eigen::numext::isnan(bad_value)) {
         c->SetStatus(
             errors::InvalidArgument("Nan in summary histogram for: ", name()));
-        break;
-      } else if (Eigen::numext::isinf(double_val)) {
+      } else {
         c->SetStatus(errors::InvalidArgument(
             "Infinity in summary histogram for: ", name()));
-        break;
       }
-      histo.Add(double_val);
+      return;
     }
 
     Summary s;
@@ -109,6 +160,128 @@ class SummaryHistoOp : public OpKernel {
     OP_REQUIRES_OK(c, c->allocate_output(0, TensorShape({}), &summary_tensor));
     CHECK(s.SerializeToString(&summary_tensor->scalar<string>()()));
   }
+
+ private:
+  // Inputs with fewer elements than this per available thread are
+  // histogrammed serially.
+  static constexpr int64 kMinElementsPerShard = 1 << 17;
+  // Values are staged into fixed-size batches before being added to a
+  // histogram so the summary statistics accumulate in registers.
+  static constexpr int64 kAddBatchSize = 4096;
+
+  // Adds data[start, limit) to histo.  On encountering a non-finite
+  // value, stops and reports it through has_bad_value/bad_value.
+  static void AddRange(const T* data, int64 start, int64 limit,
+                       histogram::Histogram* histo, bool* has_bad_value,
+                       double* bad_value) {
+    double batch[kAddBatchSize];
+    int64 batch_size = 0;
+    for (int64 i = start; i < limit; ++i) {
+      const double double_val = static_cast<double>(data[i]);
+      if (TF_PREDICT_FALSE(!Eigen::numext::isfinite(double_val))) {
+        *has_bad_value = true;
+        *bad_value = double_val;
+        return;
+      }
+      batch[batch_size++] = double_val;
+      if (batch_size == kAddBatchSize) {
+        histo->Add(gtl::ArraySlice<double>(batch, batch_size));
+        batch_size = 0;
+      }
+    }
+    if (batch_size > 0) {
+      histo->Add(gtl::ArraySlice<double>(batch, batch_size));
+    }
+  }
+};
+
+// Summarizes the distribution of a tensor with a streaming quantile
+// sketch instead of exact bucket counts.  One pass feeds the values
+// into a weighted quantile stream with approximation error `eps`, and
+// the summary is emitted as a histogram whose bucket boundaries are the
+// approximate quantiles, each holding an equal share of the values.
+// Much cheaper than HistogramSummary for very large tensors, at the
+// cost of bucket-level approximation.
+template <typename T>
+class SummaryQuantileOp : public OpKernel {
+ public:
+  explicit SummaryQuantileOp(OpKernelConstruction* context)
+      : OpKernel(context) {
+    OP_REQUIRES_OK(context, context->GetAttr("num_quantiles",
+                                             &num_quantiles_));
+    OP_REQUIRES_OK(context, context->GetAttr("eps", &eps_));
+    OP_REQUIRES(context, eps_ > 0,
+                errors::InvalidArgument("eps must be positive: ", eps_));
+  }
+
+  void Compute(OpKernelContext* c) override {
+    const Tensor& tags = c->input(0);
+    const Tensor& values = c->input(1);
+    const auto flat = values.flat<T>();
+    OP_REQUIRES(c, IsLegacyScalar(tags.shape()),
+                errors::InvalidArgument("tags must be scalar"));
+
+    const int64 num_elements = flat.size();
+    boosted_trees::quantiles::WeightedQuantilesStream<double, double> stream(
+        eps_, num_elements + 1);
+    double min = DBL_MAX;
+    double max = -DBL_MAX;
+    double sum = 0;
+    double sum_squares = 0;
+    for (int64 i = 0; i < num_elements; i++) {
+      const double double_val = static_cast<double>(flat(i));
+      if (Eigen::numext::isnan(double_val)) {
+        c->SetStatus(
+            errors::InvalidArgument("Nan in quantile summary for: ", name()));
+        return;
+      } else if (Eigen::numext::isinf(double_val)) {
+        c->SetStatus(errors::InvalidArgument(
+            "Infinity in quantile summary for: ", name()));
+        return;
+      }
+      stream.PushEntry(double_val, 1.0);
+      if (min > double_val) min = double_val;
+      if (max < double_val) max = double_val;
+      sum += double_val;
+      sum_squares += double_val * double_val;
+    }
+    stream.Finalize();
+
+    Summary s;
+    Summary::Value* v = s.add_value();
+    v->set_tag(tags.scalar<string>()());
+    HistogramProto* histo = v->mutable_histo();
+    histo->set_min(min);
+    histo->set_max(max);
+    histo->set_num(num_elements);
+    histo->set_sum(sum);
+    histo->set_sum_squares(sum_squares);
+    const std::vector<double> boundaries =
+        stream.GenerateBoundaries(num_quantiles_);
+    if (boundaries.size() < 2) {
+      // Too few distinct values for quantile buckets; emit everything
+      // into one bucket.
+      histo->add_bucket_limit(DBL_MAX);
+      histo->add_bucket(num_elements);
+    } else {
+      // Each inter-quantile bucket holds an equal share of the values
+      // up to the stream's approximation error.
+      const double per_bucket =
+          static_cast<double>(num_elements) / (boundaries.size() - 1);
+      for (size_t i = 1; i < boundaries.size(); ++i) {
+        histo->add_bucket_limit(boundaries[i]);
+        histo->add_bucket(per_bucket);
+      }
+    }
+
+    Tensor* summary_tensor = nullptr;
+    OP_REQUIRES_OK(c, c->allocate_output(0, TensorShape({}), &summary_tensor));
+    CHECK(s.SerializeToString(&summary_tensor->scalar<string>()()));
+  }
+
+ private:
+  int num_quantiles_;
+  float eps_;
 };
 
 #define REGISTER(T)                                                       \
@@ -117,7 +290,10 @@ class SummaryHistoOp : public OpKernel {
       SummaryScalarOp<T>);                                                \
   REGISTER_KERNEL_BUILDER(                                                \
       Name("HistogramSummary").Device(DEVICE_CPU).TypeConstraint<T>("T"), \
-      SummaryHistoOp<T>);
+      SummaryHistoOp<T>);                                                 \
+  REGISTER_KERNEL_BUILDER(                                                \
+      Name("QuantileSummary").Device(DEVICE_CPU).TypeConstraint<T>("T"),  \
+      SummaryQuantileOp<T>);
 TF_CALL_REAL_NUMBER_TYPES(REGISTER)
 #undef REGISTER
 
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <math.h>
+
 #include <functional>
 #include <memory>
 
@@ -270,6 +272,63 @@ TEST_F(SummaryHistoOpTest, Error_TooManyTagValues) {
   EXPECT_TRUE(str_util::StrContains(s.ToString(), "tags must be scalar")) << s;
 }
 
+// --------------------------------------------------------------------------
+// SummaryQuantileOp
+// --------------------------------------------------------------------------
+class SummaryQuantileOpTest : public OpsTestBase {
+ protected:
+  void MakeOp(DataType dt, int num_quantiles) {
+    TF_ASSERT_OK(NodeDefBuilder("myop", "QuantileSummary")
+                     .Input(FakeInput())
+                     .Input(FakeInput(dt))
+                     .Attr("num_quantiles", num_quantiles)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+};
+
+TEST_F(SummaryQuantileOpTest, SimpleFloat) {
+  MakeOp(DT_FLOAT, 4);
+
+  // Feed and run
+  AddInputFromArray<string>(TensorShape({}), {"tagquantile"});
+  AddInputFromArray<float>(TensorShape({8}),
+                           {1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f, 8.0f});
+  TF_ASSERT_OK(RunOpKernel());
+
+  Tensor* out_tensor = GetOutput(0);
+  ASSERT_EQ(0, out_tensor->dims());
+  Summary summary;
+  ParseProtoUnlimited(&summary, out_tensor->scalar<string>()());
+  ASSERT_EQ(summary.value_size(), 1);
+  EXPECT_EQ(summary.value(0).tag(), "tagquantile");
+  const HistogramProto& histo = summary.value(0).histo();
+  EXPECT_EQ(histo.min(), 1.0);
+  EXPECT_EQ(histo.max(), 8.0);
+  EXPECT_EQ(histo.num(), 8.0);
+  EXPECT_EQ(histo.sum(), 36.0);
+  // Buckets are bounded by approximate quantiles and hold equal counts.
+  ASSERT_GT(histo.bucket_size(), 0);
+  EXPECT_EQ(histo.bucket_size(), histo.bucket_limit_size());
+  double total = 0;
+  for (int i = 0; i < histo.bucket_size(); ++i) {
+    total += histo.bucket(i);
+  }
+  EXPECT_NEAR(total, 8.0, 1e-6);
+  EXPECT_EQ(histo.bucket_limit(histo.bucket_limit_size() - 1), 8.0);
+}
+
+TEST_F(SummaryQuantileOpTest, Error_NanValue) {
+  MakeOp(DT_FLOAT, 4);
+
+  AddInputFromArray<string>(TensorShape({}), {"tagquantile"});
+  AddInputFromArray<float>(TensorShape({2}), {1.0f, NAN});
+  Status s = RunOpKernel();
+  EXPECT_TRUE(
+      str_util::StrContains(s.ToString(), "Nan in quantile summary"))
+      << s;
+}
+
 // --------------------------------------------------------------------------
 // SummaryMergeOp
 // --------------------------------------------------------------------------
@@ -20,6 +20,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/topk_op.h"
 
 #include <algorithm>
+#include <atomic>
 #include <numeric>
 #include <vector>
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -27,6 +28,7 @@ limitations under the License.
 #include "tensorflow/core/framework/register_types.h"
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/framework/thread_scratchpad.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/gtl/top_n.h"
 #include "tensorflow/core/util/work_sharder.h"
@@ -134,8 +136,99 @@ struct TopKFunctor<CPUDevice, T> {
       return Status::OK();
     }
 
+    // Sample-and-filter path: when k is much smaller than num_cols, estimate
+    // the k-th largest value of a row from a deterministic sample, collect
+    // only the entries at least that large with a cheap linear scan, and then
+    // select the top k exactly among the candidates. The threshold is an
+    // estimate only; whenever it turns out too high (fewer than k candidates)
+    // or too low (too many candidates to be worthwhile), the row falls back
+    // to the heap below, so the results are always exact.
+    constexpr int64 kMinFilterCols = 1 << 16;
+    constexpr int64 kMinSplitRowCols = 1 << 20;
+    constexpr int64 kFilterSampleSize = 1024;
+    const bool use_filter =
+        num_cols >= kMinFilterCols && static_cast<int64>(k) * 16 <= num_cols;
+    // Candidates we are willing to collect before giving up on the filter.
+    const int64 candidate_cap = std::max<int64>(4 * static_cast<int64>(k),
+                                                kFilterSampleSize);
+
+    // Estimates a slight underestimate of the k-th largest value of the row,
+    // so that the candidate set stays a superset of the true top k. The
+    // sample is strided rather than random to keep repeated runs identical.
+    auto EstimateThreshold = [&](const T* input_data, T* threshold) {
+      const int64 stride = num_cols / kFilterSampleSize;
+      T samples[kFilterSampleSize];
+      int64 c = stride / 2;
+      for (int64 i = 0; i < kFilterSampleSize; ++i, c += stride) {
+        const T v = input_data[c];
+        // Bail out on NaN to keep the heap path's behavior.
+        if (Eigen::numext::isnan(v)) return false;
+        samples[i] = v;
+      }
+      // Rank of the k-th largest scaled down to the sample, with a 2x margin
+      // (plus slack for tiny k) pushing the estimate toward smaller values.
+      const int64 rank = std::min<int64>(
+          kFilterSampleSize - 1,
+          2 * static_cast<int64>(k) * kFilterSampleSize / num_cols + 3);
+      std::nth_element(samples, samples + rank, samples + kFilterSampleSize,
+                       [](const T& a, const T& b) { return b < a; });
+      *threshold = samples[rank];
+      return true;
+    };
+
+    // Selects the top k entries of a candidate superset into row b of the
+    // outputs, breaking ties toward lower indices like the heap path does.
+    // The output is always sorted, which is also valid when sorted == false.
+    auto SelectCandidates = [&](int32 b, int32* candidates,
+                                int64 num_candidates) {
+      if (num_candidates < k) return false;
+      const T* input_data = &input(b, 0);
+      const auto stable_comp = [input_data](const int32 a, const int32 b) {
+        if (input_data[b] < input_data[a]) {
+          return true;
+        } else if (input_data[b] > input_data[a]) {
+          return false;
+        } else {
+          return a < b;
+        }
+      };
+      std::nth_element(candidates, candidates + k, candidates + num_candidates,
+                       stable_comp);
+      std::sort(candidates, candidates + k, stable_comp);
+      std::copy(candidates, candidates + k, &indices(b, 0));
+      std::transform(&indices(b, 0), &indices(b, k), &values(b, 0),
+                     [b, &input](const int32 loc) { return input(b, loc); });
+      return true;
+    };
+
+    auto FilterTopKRow = [&](int32 b) {
+      const T* input_data = &input(b, 0);
+      T threshold;
+      if (!EstimateThreshold(input_data, &threshold)) return false;
+      // Every row asks for the same candidate capacity, so check the
+      // buffer out of the per-thread scratchpad instead of allocating a
+      // fresh vector per row.
+      ThreadScratchpad::Handle scratch =
+          context->scratchpad(candidate_cap * sizeof(int32));
+      int32* candidates = scratch.data_as<int32>();
+      if (candidates == nullptr) return false;
+      int64 num_candidates = 0;
+      for (int64 c = 0; c < num_cols; ++c) {
+        if (!(input_data[c] < threshold)) {
+          if (num_candidates >= candidate_cap) {
+            return false;
+          }
+          candidates[num_candidates++] = c;
+        }
+      }
+      // At least k entries compare >= threshold, so the true top k are all
+      // among the candidates and the selection below is exact.
+      return SelectCandidates(b, candidates, num_candidates);
+    };
+
     auto SortIndices = [&, context](int start_batch, int limit_batch) {
       for (int32 b = start_batch; b < limit_batch; ++b) {
+        if (use_filter && FilterTopKRow(b)) continue;
         const T* input_data = &input(b, 0);
         const auto stable_comp = [input_data](const int32 a, const int32 b) {
           if (input_data[b] < input_data[a]) {
@@ -205,6 +298,59 @@ struct TopKFunctor<CPUDevice, T> {
       }  // for (int32 b = ...
     };
 
+    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
+
+    // With only a few very large rows, sharding over rows cannot keep the
+    // pool busy; instead run the candidate scan of each row in parallel over
+    // column segments. Merging the per-segment candidate lists in segment
+    // order keeps the candidate indices ascending, so the selection is
+    // identical to the serial filter.
+    if (use_filter && num_cols >= kMinSplitRowCols &&
+        num_rows < worker_threads.num_threads) {
+      auto ParallelFilterTopKRow = [&](int32 b) {
+        const T* input_data = &input(b, 0);
+        T threshold;
+        if (!EstimateThreshold(input_data, &threshold)) return false;
+        const int64 num_segments = worker_threads.num_threads;
+        std::vector<std::vector<int32>> segment_candidates(num_segments);
+        std::atomic<bool> over_cap(false);
+        auto scan = [&](int64 seg_begin, int64 seg_end) {
+          for (int64 s = seg_begin; s < seg_end; ++s) {
+            const int64 col_begin = s * num_cols / num_segments;
+            const int64 col_end = (s + 1) * num_cols / num_segments;
+            std::vector<int32>& cand = segment_candidates[s];
+            for (int64 c = col_begin; c < col_end; ++c) {
+              if (!(input_data[c] < threshold)) {
+                if (static_cast<int64>(cand.size()) >= candidate_cap) {
+                  over_cap = true;
+                  return;
+                }
+                cand.push_back(c);
+              }
+            }
+          }
+        };
+        const int64 scan_cost =
+            (num_cols / num_segments) *
+            static_cast<int64>(Eigen::TensorOpCost::AddCost<T>() + 1);
+        Shard(worker_threads.num_threads, worker_threads.workers, num_segments,
+              scan_cost, scan);
+        if (over_cap) return false;
+        std::vector<int32> candidates;
+        for (const std::vector<int32>& cand : segment_candidates) {
+          candidates.insert(candidates.end(), cand.begin(), cand.end());
+        }
+        return SelectCandidates(b, candidates.data(),
+                                static_cast<int64>(candidates.size()));
+      };
+      for (int32 b = 0; b < num_rows; ++b) {
+        if (!ParallelFilterTopKRow(b)) {
+          SortIndices(b, b + 1);
+        }
+      }
+      return Status::OK();
+    }
+
     // Guesstimate of cost; 4*N*log(K) where N == num_cols.
     // If K == N, assume the cost is N*log(K + 1).
     const double cmp_cost = 3 * Eigen::TensorOpCost::AddCost<int32>() +
@@ -219,7 +365,6 @@ struct TopKFunctor<CPUDevice, T> {
     const int64 final_cost = (total_cost >= static_cast<double>(kint64max))
                                  ? kint64max
                                  : static_cast<int64>(total_cost);
-    auto worker_threads = *(context->device()->tensorflow_cpu_worker_threads());
     Shard(worker_threads.num_threads, worker_threads.workers, num_rows,
           final_cost, SortIndices);
 
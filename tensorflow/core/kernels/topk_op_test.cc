@@ -0,0 +1,168 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include <algorithm>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+#include "tensorflow/core/common_runtime/kernel_benchmark_testlib.h"
+#include "tensorflow/core/framework/fake_input.h"
+#include "tensorflow/core/framework/node_def_builder.h"
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_testutil.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/graph/node_builder.h"
+#include "tensorflow/core/graph/testlib.h"
+#include "tensorflow/core/kernels/ops_testutil.h"
+#include "tensorflow/core/kernels/ops_util.h"
+#include "tensorflow/core/platform/test.h"
+#include "tensorflow/core/platform/test_benchmark.h"
+
+namespace tensorflow {
+namespace {
+
+class TopKOpTest : public OpsTestBase {
+ protected:
+  void MakeOp() {
+    TF_ASSERT_OK(NodeDefBuilder("topk_op", "TopKV2")
+                     .Input(FakeInput(DT_FLOAT))
+                     .Input(FakeInput(DT_INT32))
+                     .Attr("sorted", true)
+                     .Finalize(node_def()));
+    TF_ASSERT_OK(InitOp());
+  }
+
+  // Runs TopKV2 over a single row and checks the outputs against a
+  // reference computed with a full stable sort.
+  void RunAndValidate(const std::vector<float>& row, int k) {
+    const int64 num_cols = row.size();
+    AddInputFromArray<float>(TensorShape({num_cols}), row);
+    AddInputFromArray<int32>(TensorShape({}), {k});
+    TF_ASSERT_OK(RunOpKernel());
+
+    // Reference: indices sorted by descending value, ties broken toward
+    // lower indices, matching the kernel's documented tie behavior.
+    std::vector<int32> ref(num_cols);
+    std::iota(ref.begin(), ref.end(), 0);
+    std::sort(ref.begin(), ref.end(), [&row](int32 a, int32 b) {
+      if (row[b] < row[a]) return true;
+      if (row[a] < row[b]) return false;
+      return a < b;
+    });
+
+    const auto& values = GetOutput(0)->flat<float>();
+    const auto& indices = GetOutput(1)->flat<int32>();
+    ASSERT_EQ(k, values.size());
+    ASSERT_EQ(k, indices.size());
+    for (int i = 0; i < k; ++i) {
+      EXPECT_EQ(ref[i], indices(i)) << "i=" << i;
+      EXPECT_EQ(row[ref[i]], values(i)) << "i=" << i;
+    }
+  }
+};
+
+// Large row with k << num_cols engages the sample-and-filter path.
+TEST_F(TopKOpTest, LargeRowFilterPath) {
+  MakeOp();
+  const int64 num_cols = 1 << 17;
+  std::vector<float> row(num_cols);
+  for (int64 i = 0; i < num_cols; ++i) {
+    // Pseudo-random permutation of distinct values.
+    row[i] = static_cast<float>((i * 7919) % num_cols);
+  }
+  RunAndValidate(row, 100);
+}
+
+// Massive duplication blows past the candidate cap and must fall back to
+// the heap path while still producing exact results.
+TEST_F(TopKOpTest, LargeRowManyTies) {
+  MakeOp();
+  const int64 num_cols = 1 << 17;
+  std::vector<float> row(num_cols);
+  for (int64 i = 0; i < num_cols; ++i) {
+    row[i] = static_cast<float>(i % 4);
+  }
+  RunAndValidate(row, 64);
+}
+
+// NaNs disable the filter path; behavior must match the heap path.
+TEST_F(TopKOpTest, LargeRowWithNaN) {
+  MakeOp();
+  const int64 num_cols = 1 << 17;
+  std::vector<float> row(num_cols);
+  for (int64 i = 0; i < num_cols; ++i) {
+    row[i] = static_cast<float>((i * 104729) % num_cols);
+  }
+  row[12345] = std::numeric_limits<float>::quiet_NaN();
+  AddInputFromArray<float>(TensorShape({num_cols}), row);
+  AddInputFromArray<int32>(TensorShape({}), {10});
+  TF_ASSERT_OK(RunOpKernel());
+  const auto& values = GetOutput(0)->flat<float>();
+  // The top 10 of the permutation are num_cols - 1 .. num_cols - 10.
+  for (int i = 0; i < 10; ++i) {
+    EXPECT_EQ(static_cast<float>(num_cols - 1 - i), values(i));
+  }
+}
+
+static Graph* TopKGraph(int num_rows, int num_cols, int k) {
+  Graph* g = new Graph(OpRegistry::Global());
+  Tensor input(DT_FLOAT, TensorShape({num_rows, num_cols}));
+  input.flat<float>().setRandom();
+  Tensor k_tensor(DT_INT32, TensorShape({}));
+  k_tensor.scalar<int32>()() = k;
+  Node* ret;
+  TF_CHECK_OK(NodeBuilder(g->NewName("topk"), "TopKV2")
+                  .Input(test::graph::Constant(g, input))
+                  .Input(test::graph::HostConstant(g, k_tensor))
+                  .Attr("sorted", true)
+                  .Finalize(g, &ret));
+  return g;
+}
+
+static void RunTopKBenchmark(int iters, int num_rows, int num_cols, int k) {
+  testing::StopTiming();
+  Graph* g = TopKGraph(num_rows, num_cols, k);
+  testing::BytesProcessed(static_cast<int64>(iters) * num_rows * num_cols *
+                          sizeof(float));
+  testing::UseRealTime();
+  testing::StartTiming();
+  test::Benchmark("cpu", g).Run(iters);
+}
+
+// Batched rows; the filter path engages when num_cols >= 2^16 and
+// 16 * k <= num_cols, otherwise this measures the heap path.
+static void BM_TopKBatched(int iters, int num_cols, int k) {
+  RunTopKBenchmark(iters, 64, num_cols, k);
+}
+BENCHMARK(BM_TopKBatched)
+    ->ArgPair(16 << 10, 64)     // heap (row below filter threshold)
+    ->ArgPair(1 << 20, 64)      // filter
+    ->ArgPair(1 << 20, 1024)    // filter
+    ->ArgPair(1 << 20, 131072)  // heap (k too large for the filter)
+    ->ArgPair(1 << 20, 1 << 20);  // full sort (k == num_cols)
+
+// A single huge row, the retrieval serving shape; the filter path shards
+// the candidate scan within the row.
+static void BM_TopKSingleRow(int iters, int num_cols, int k) {
+  RunTopKBenchmark(iters, 1, num_cols, k);
+}
+BENCHMARK(BM_TopKSingleRow)
+    ->ArgPair(8 << 20, 1000)      // filter, sharded scan
+    ->ArgPair(8 << 20, 100000)    // filter, sharded scan
+    ->ArgPair(8 << 20, 1 << 20);  // heap (k too large for the filter)
+
+}  // namespace
+}  // namespace tensorflow
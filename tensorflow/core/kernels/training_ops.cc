@@ -24,6 +24,7 @@ limitations under the License.
 #include "tensorflow/core/kernels/training_op_helpers.h"
 #include "tensorflow/core/kernels/training_ops.h"
 #include "tensorflow/core/kernels/variable_ops.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 #ifdef TENSORFLOW_USE_SYCL
 #include "tensorflow/core/common_runtime/sycl/sycl_util.h"
@@ -3061,6 +3062,182 @@ REGISTER_KERNELS(GPU, double);
 #undef REGISTER_CPU_KERNELS
 #undef REGISTER_KERNELS
 
+// Applies the same Adam update to a batch of variables in one kernel
+// invocation. Training graphs with thousands of small variables pay more in
+// per-op dispatch than in arithmetic when each variable gets its own
+// ResourceApplyAdam node; this kernel amortizes the dispatch over the whole
+// group. Groups are formed by the fusion pass in
+// common_runtime/multi_tensor_adam_optimizer.cc.
+template <typename Device, typename T>
+class ApplyAdamNOp : public OpKernel {
+ public:
+  explicit ApplyAdamNOp(OpKernelConstruction* ctx) : OpKernel(ctx) {
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("N", &num_tensors_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_locking", &use_exclusive_lock_));
+    OP_REQUIRES_OK(ctx, ctx->GetAttr("use_nesterov", &use_nesterov_));
+  }
+
+  void Compute(OpKernelContext* ctx) override {
+    const bool sparse = false;
+    const int n = num_tensors_;
+    // Inputs are laid out as var[0..n), m[0..n), v[0..n), the six scalar
+    // hyperparameters, then grad[0..n).
+    std::vector<int> state_ids(3 * n);
+    for (int i = 0; i < 3 * n; ++i) state_ids[i] = i;
+    auto locks = MaybeLockVariableInputMutexesInOrder<Device, T>(
+        ctx, use_exclusive_lock_, sparse, state_ids);
+
+    std::vector<Tensor> vars(n), ms(n), vs(n);
+    for (int i = 0; i < n; ++i) {
+      OP_REQUIRES_OK(ctx, GetInputTensorFromVariable<Device, T>(
+                              ctx, i, use_exclusive_lock_, sparse, &vars[i]));
+      OP_REQUIRES_OK(ctx,
+                     GetInputTensorFromVariable<Device, T>(
+                         ctx, n + i, use_exclusive_lock_, sparse, &ms[i]));
+      OP_REQUIRES_OK(ctx,
+                     GetInputTensorFromVariable<Device, T>(
+                         ctx, 2 * n + i, use_exclusive_lock_, sparse, &vs[i]));
+      OP_REQUIRES(ctx, vars[i].IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(i)));
+      OP_REQUIRES(ctx, ms[i].IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(n + i)));
+      OP_REQUIRES(ctx, vs[i].IsInitialized(),
+                  errors::FailedPrecondition(
+                      "Attempting to use uninitialized variables: ",
+                      requested_input(2 * n + i)));
+    }
+
+    const Tensor& beta1_power = ctx->input(3 * n);
+    const Tensor& beta2_power = ctx->input(3 * n + 1);
+    const Tensor& lr = ctx->input(3 * n + 2);
+    const Tensor& beta1 = ctx->input(3 * n + 3);
+    const Tensor& beta2 = ctx->input(3 * n + 4);
+    const Tensor& epsilon = ctx->input(3 * n + 5);
+
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta1_power.shape()),
+                errors::InvalidArgument("beta1_power is not a scalar: ",
+                                        beta1_power.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta2_power.shape()),
+                errors::InvalidArgument("beta2_power is not a scalar: ",
+                                        beta2_power.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(lr.shape()),
+                errors::InvalidArgument("lr is not a scalar : ",
+                                        lr.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta1.shape()),
+                errors::InvalidArgument("beta1 is not a scalar: ",
+                                        beta1.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(beta2.shape()),
+                errors::InvalidArgument("beta2 is not a scalar: ",
+                                        beta2.shape().DebugString()));
+    OP_REQUIRES(ctx, TensorShapeUtils::IsScalar(epsilon.shape()),
+                errors::InvalidArgument("epsilon is not a scalar: ",
+                                        epsilon.shape().DebugString()));
+
+    int64 total_elements = 0;
+    for (int i = 0; i < n; ++i) {
+      const Tensor& grad = ctx->input(3 * n + 6 + i);
+      OP_REQUIRES(ctx, vars[i].shape().IsSameSize(ms[i].shape()),
+                  errors::InvalidArgument(
+                      "var and m do not have the same shape",
+                      vars[i].shape().DebugString(), " ",
+                      ms[i].shape().DebugString()));
+      OP_REQUIRES(ctx, vars[i].shape().IsSameSize(vs[i].shape()),
+                  errors::InvalidArgument(
+                      "var and v do not have the same shape",
+                      vars[i].shape().DebugString(), " ",
+                      vs[i].shape().DebugString()));
+      OP_REQUIRES(ctx, vars[i].shape().IsSameSize(grad.shape()),
+                  errors::InvalidArgument(
+                      "var and grad do not have the same shape",
+                      vars[i].shape().DebugString(), " ",
+                      grad.shape().DebugString()));
+      total_elements += grad.NumElements();
+    }
+
+    if (std::is_same<Device, CPUDevice>::value) {
+      // One small variable rarely fills even a single core, so instead of
+      // running the threaded Eigen device per tensor we shard whole tensors
+      // across the pool and evaluate each one inline on its worker.
+      const T beta1_power_s = beta1_power.scalar<T>()();
+      const T beta2_power_s = beta2_power.scalar<T>()();
+      const T lr_s = lr.scalar<T>()();
+      const T beta1_s = beta1.scalar<T>()();
+      const T beta2_s = beta2.scalar<T>()();
+      const T epsilon_s = epsilon.scalar<T>()();
+      const T alpha = lr_s *
+                      Eigen::numext::sqrt(T(1) - beta2_power_s) /
+                      (T(1) - beta1_power_s);
+      const bool use_nesterov = use_nesterov_;
+      auto update_tensors = [ctx, n, alpha, beta1_s, beta2_s, epsilon_s,
+                             use_nesterov, &vars, &ms,
+                             &vs](int64 start, int64 limit) {
+        Eigen::DefaultDevice d;
+        for (int64 i = start; i < limit; ++i) {
+          auto var = vars[i].flat<T>();
+          auto m = ms[i].flat<T>();
+          auto v = vs[i].flat<T>();
+          auto grad = ctx->input(3 * n + 6 + i).flat<T>();
+          m.device(d) += (grad - m) * (T(1) - beta1_s);
+          v.device(d) += (grad.square() - v) * (T(1) - beta2_s);
+          if (use_nesterov) {
+            var.device(d) -=
+                ((grad * (T(1) - beta1_s) + beta1_s * m) * alpha) /
+                (v.sqrt() + epsilon_s);
+          } else {
+            var.device(d) -= (m * alpha) / (v.sqrt() + epsilon_s);
+          }
+        }
+      };
+      auto worker_threads = *(ctx->device()->tensorflow_cpu_worker_threads());
+      // ~10 flops plus 4 memory streams per element; cost is per tensor.
+      const int64 cost_per_tensor = 10 * (total_elements / n + 1);
+      Shard(worker_threads.num_threads, worker_threads.workers, n,
+            cost_per_tensor, update_tensors);
+    } else {
+      const Device& device = ctx->template eigen_device<Device>();
+      for (int i = 0; i < n; ++i) {
+        functor::ApplyAdam<Device, T>()(
+            device, vars[i].flat<T>(), ms[i].flat<T>(), vs[i].flat<T>(),
+            beta1_power.scalar<T>(), beta2_power.scalar<T>(), lr.scalar<T>(),
+            beta1.scalar<T>(), beta2.scalar<T>(), epsilon.scalar<T>(),
+            ctx->input(3 * n + 6 + i).flat<T>(), use_nesterov_);
+      }
+    }
+  }
+
+ private:
+  int num_tensors_;
+  bool use_exclusive_lock_;
+  bool use_nesterov_;
+};
+
+#define REGISTER_KERNELS(D, T)                          \
+  REGISTER_KERNEL_BUILDER(Name("ResourceApplyAdamN")    \
+                              .HostMemory("var")        \
+                              .HostMemory("m")          \
+                              .HostMemory("v")          \
+                              .Device(DEVICE_##D)       \
+                              .TypeConstraint<T>("T"),  \
+                          ApplyAdamNOp<D##Device, T>);
+#define REGISTER_CPU_KERNELS(T) REGISTER_KERNELS(CPU, T);
+
+TF_CALL_half(REGISTER_CPU_KERNELS);
+TF_CALL_bfloat16(REGISTER_CPU_KERNELS);
+TF_CALL_float(REGISTER_CPU_KERNELS);
+TF_CALL_double(REGISTER_CPU_KERNELS);
+
+#if GOOGLE_CUDA || TENSORFLOW_USE_ROCM
+REGISTER_KERNELS(GPU, Eigen::half);
+REGISTER_KERNELS(GPU, float);
+REGISTER_KERNELS(GPU, double);
+#endif
+#undef REGISTER_CPU_KERNELS
+#undef REGISTER_KERNELS
+
 template <typename Device, typename T>
 class ApplyAdamWithAmsgradOp : public OpKernel {
  public:
@@ -15,6 +15,7 @@ limitations under the License.
 
 #define EIGEN_USE_THREADS
 
+#include <algorithm>
 #include <complex>
 
 #include "third_party/eigen3/unsupported/Eigen/CXX11/Tensor"
@@ -65,12 +66,95 @@ void TransposeSimple(const CPUDevice& device, const Tensor& in,
   device.parallelFor(in.NumElements(), cost, std::move(transpose_fn));
 }
 
+// Below this size the Eigen shuffle is cheap enough that the tiled kernel
+// does not pay for its dispatch overhead.
+constexpr int64 kMinTiledTransposeElements = 8 * 1024;
+
+// Swaps dimension 1 and 2 of a rank-3 tensor (a batched 2-D transpose) by
+// walking cache-sized square tiles, so that both the strided reads and the
+// sequential writes of a tile stay within the L1 cache. The fixed tile
+// bounds let the compiler vectorize the inner loops into in-register
+// transposes for small element types. Tiles are sharded across the intra-op
+// threadpool.
+template <typename T, bool conjugate>
+void TransposeTiled(const CPUDevice& device, const T* in, int64 batch,
+                    int64 rows, int64 cols, T* out) {
+  constexpr int64 kTileDim = sizeof(T) <= 4 ? 32 : 16;
+  const int64 tile_rows = (rows + kTileDim - 1) / kTileDim;
+  const int64 tile_cols = (cols + kTileDim - 1) / kTileDim;
+  const int64 tiles_per_matrix = tile_rows * tile_cols;
+  const int64 matrix_size = rows * cols;
+  auto transpose_tiles = [=](int64 begin, int64 end) {
+    for (int64 t = begin; t < end; ++t) {
+      const int64 tile_idx = t % tiles_per_matrix;
+      const int64 r0 = (tile_idx / tile_cols) * kTileDim;
+      const int64 c0 = (tile_idx % tile_cols) * kTileDim;
+      const int64 r1 = std::min(r0 + kTileDim, rows);
+      const int64 c1 = std::min(c0 + kTileDim, cols);
+      const T* in_mat = in + (t / tiles_per_matrix) * matrix_size;
+      T* out_mat = out + (t / tiles_per_matrix) * matrix_size;
+      // The inner loop runs over 'r', so the stores are sequential and only
+      // the loads are strided; the whole tile is cache resident.
+      for (int64 c = c0; c < c1; ++c) {
+        for (int64 r = r0; r < r1; ++r) {
+          if (conjugate) {
+            out_mat[c * rows + r] = Eigen::numext::conj(in_mat[r * cols + c]);
+          } else {
+            out_mat[c * rows + r] = in_mat[r * cols + c];
+          }
+        }
+      }
+    }
+  };
+  Eigen::TensorOpCost cost(
+      /*bytes_loaded=*/kTileDim * kTileDim * sizeof(T),
+      /*bytes_stored=*/kTileDim * kTileDim * sizeof(T),
+      /*compute_cycles=*/kTileDim * kTileDim * (conjugate ? 2 : 1));
+  device.parallelFor(batch * tiles_per_matrix, cost,
+                     std::move(transpose_tiles));
+}
+
+// Tries to reduce the permutation to a (batched) swap of the two innermost
+// combined dimensions (this covers NHWC<->NCHW style conversions) and, if it
+// is one, runs the blocked kernel above. Returns false if the permutation
+// has a different structure or the tensor is small, in which case the caller
+// falls back to the Eigen shuffle. This is the CPU analogue of
+// TransposeUsingTile in transpose_functor_gpu.cu.cc.
+template <typename T, bool conjugate>
+struct TransposeUsingTile {
+  static bool run(const CPUDevice& d, const Tensor& in,
+                  const gtl::ArraySlice<int32> perm, Tensor* out) {
+    if (in.NumElements() < kMinTiledTransposeElements) return false;
+    internal::TransposePermsVec new_perm;
+    internal::TransposeDimsVec new_dims;
+    internal::ReduceTransposeDimensions(in.shape(), perm, &new_perm,
+                                        &new_dims);
+    const T* in_data = reinterpret_cast<const T*>(in.tensor_data().data());
+    T* out_data =
+        reinterpret_cast<T*>(const_cast<char*>(out->tensor_data().data()));
+    if (new_perm == internal::TransposePermsVec({1, 0})) {
+      TransposeTiled<T, conjugate>(d, in_data, 1, new_dims[0], new_dims[1],
+                                   out_data);
+      return true;
+    }
+    if (new_perm == internal::TransposePermsVec({0, 2, 1})) {
+      TransposeTiled<T, conjugate>(d, in_data, new_dims[0], new_dims[1],
+                                   new_dims[2], out_data);
+      return true;
+    }
+    return false;
+  }
+};
+
 }  // namespace
 
 template <typename T, bool conjugate>
 struct Transpose<CPUDevice, T, conjugate> {
   static void run(const CPUDevice& d, const Tensor& in,
                   const gtl::ArraySlice<int32> perm, Tensor* out) {
+    if (TransposeUsingTile<T, conjugate>::run(d, in, perm, out)) {
+      return;
+    }
     switch (in.dims()) {
       case 2:
         internal::TransposeUsingEigen<CPUDevice, T, 2>(d, in, perm, conjugate,
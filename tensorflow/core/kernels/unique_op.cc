@@ -13,9 +13,11 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <algorithm>
 #include <functional>
 #include <unordered_map>
 #include <utility>
+#include <vector>
 
 #include "tensorflow/core/framework/bounds_check.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -24,15 +26,140 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_shape.h"
 #include "tensorflow/core/lib/core/status.h"
 #include "tensorflow/core/lib/hash/hash.h"
+#include "tensorflow/core/util/env_var.h"
+#include "tensorflow/core/util/work_sharder.h"
 
 namespace tensorflow {
 
 typedef Eigen::ThreadPoolDevice CPUDevice;
 
+namespace {
+
+// Inputs smaller than this are deduplicated with the serial implementation
+// even when the sharded implementation is enabled; below this size the
+// partition and merge phases cost more than they save.
+constexpr int64 kMinParallelUniqueElements = 1 << 16;
+
+// Sharded hash-based unique for the 1-D case. Elements are partitioned by
+// hash into per-shard buckets, every shard is deduplicated independently on
+// the intra-op pool, and a merge phase assigns the global unique ids in order
+// of first occurrence so that the result is identical to the serial
+// implementation.
+//
+// Fills `idx_vec` and `uniq_values` (unique values ordered by first
+// occurrence) and returns the number of unique values.
+template <typename T, typename TIndex>
+int64 ParallelUnique(OpKernelContext* context,
+                     typename TTypes<T>::ConstFlat Tin,
+                     typename TTypes<TIndex>::Vec idx_vec,
+                     std::vector<T>* uniq_values) {
+  const int64 N = static_cast<int64>(Tin.size());
+  auto* worker_threads = context->device()->tensorflow_cpu_worker_threads();
+  const int num_shards = std::min(worker_threads->num_threads, 32);
+
+  const auto shard_of = [&Tin, num_shards](int64 i) {
+    return static_cast<int>(hash<T>{}(Tin(i)) % num_shards);
+  };
+
+  // Phase 1: partition input indices into per-(block, shard) buckets. Blocks
+  // are contiguous input ranges, so walking the buckets of one shard in block
+  // order visits that shard's elements in input order.
+  const int64 num_blocks = num_shards;
+  const int64 block_size = (N + num_blocks - 1) / num_blocks;
+  std::vector<std::vector<std::vector<int64>>> buckets(
+      num_blocks, std::vector<std::vector<int64>>(num_shards));
+  Shard(worker_threads->num_threads, worker_threads->workers, num_blocks,
+        block_size, [&](int64 block_start, int64 block_end) {
+          for (int64 b = block_start; b < block_end; ++b) {
+            const int64 start = b * block_size;
+            const int64 end = std::min(N, start + block_size);
+            for (int64 i = start; i < end; ++i) {
+              buckets[b][shard_of(i)].push_back(i);
+            }
+          }
+        });
+
+  // Phase 2: deduplicate every shard independently. Local unique ids are
+  // assigned in input order and stored into `idx_vec`; the first occurrence
+  // of every unique value is recorded for the merge phase.
+  std::vector<std::vector<int64>> first_occurrence(num_shards);
+  std::vector<std::vector<T>> shard_values(num_shards);
+  Shard(worker_threads->num_threads, worker_threads->workers, num_shards,
+        2 * block_size, [&](int64 shard_start, int64 shard_end) {
+          for (int64 s = shard_start; s < shard_end; ++s) {
+            std::unordered_map<T, TIndex> uniq;
+            uniq.reserve(2 * (N / num_shards + 1));
+            TIndex j = 0;
+            for (int64 b = 0; b < num_blocks; ++b) {
+              for (int64 i : buckets[b][s]) {
+                auto it = uniq.insert(std::make_pair(Tin(i), j));
+                idx_vec(i) = it.first->second;
+                if (it.second) {
+                  first_occurrence[s].push_back(i);
+                  shard_values[s].push_back(Tin(i));
+                  ++j;
+                }
+              }
+            }
+          }
+        });
+
+  // Phase 3: assign global unique ids ordered by first occurrence across all
+  // shards, matching the id assignment of the serial implementation.
+  struct UniqueRef {
+    int64 first;   // input index of the first occurrence
+    int shard;
+    TIndex local;  // unique id local to the shard
+  };
+  int64 uniq_size = 0;
+  for (int s = 0; s < num_shards; ++s) {
+    uniq_size += static_cast<int64>(shard_values[s].size());
+  }
+  std::vector<UniqueRef> refs;
+  refs.reserve(uniq_size);
+  for (int s = 0; s < num_shards; ++s) {
+    for (size_t l = 0; l < shard_values[s].size(); ++l) {
+      refs.push_back({first_occurrence[s][l], s, static_cast<TIndex>(l)});
+    }
+  }
+  std::sort(refs.begin(), refs.end(),
+            [](const UniqueRef& a, const UniqueRef& b) {
+              return a.first < b.first;
+            });
+
+  std::vector<std::vector<TIndex>> global_id(num_shards);
+  for (int s = 0; s < num_shards; ++s) {
+    global_id[s].resize(shard_values[s].size());
+  }
+  uniq_values->resize(uniq_size);
+  for (int64 g = 0; g < uniq_size; ++g) {
+    const UniqueRef& ref = refs[g];
+    global_id[ref.shard][ref.local] = static_cast<TIndex>(g);
+    (*uniq_values)[g] = std::move(shard_values[ref.shard][ref.local]);
+  }
+
+  // Phase 4: translate the local unique ids in `idx_vec` to global ids.
+  Shard(worker_threads->num_threads, worker_threads->workers, N, 10,
+        [&](int64 start, int64 end) {
+          for (int64 i = start; i < end; ++i) {
+            idx_vec(i) = global_id[shard_of(i)][idx_vec(i)];
+          }
+        });
+
+  return uniq_size;
+}
+
+}  // namespace
+
 template <typename T, typename TIndex>
 class UniqueOp : public OpKernel {
  public:
-  explicit UniqueOp(OpKernelConstruction* context) : OpKernel(context) {}
+  explicit UniqueOp(OpKernelConstruction* context) : OpKernel(context) {
+    // Opt-in sharded implementation for large 1-D inputs (see
+    // ParallelUnique above).
+    OP_REQUIRES_OK(context, ReadBoolFromEnvVar("TF_PARALLEL_UNIQUE", false,
+                                               &use_parallel_unique_));
+  }
 
   void Compute(OpKernelContext* context) override {
     const Tensor& input = context->input(0);
@@ -106,26 +233,47 @@ class UniqueOp : public OpKernel {
       auto Tin = input.flat<T>();
       const int64 N = static_cast<int64>(Tin.size());
 
-      std::unordered_map<T, TIndex> uniq;
-      uniq.reserve(2 * N);
-      for (Eigen::Index i = 0, j = 0; i < N; ++i) {
-        auto it = uniq.insert(std::make_pair(Tin(i), j));
-        idx_vec(i) = it.first->second;
-        if (it.second) {
-          ++j;
+      const bool parallel =
+          use_parallel_unique_ && N >= kMinParallelUniqueElements &&
+          context->device()->tensorflow_cpu_worker_threads()->num_threads > 1;
+
+      if (parallel) {
+        std::vector<T> uniq_values;
+        uniq_size =
+            ParallelUnique<T, TIndex>(context, Tin, idx_vec, &uniq_values);
+
+        TensorShape output_shape(input.shape());
+        output_shape.set_dim(axis, uniq_size);
+        Tensor* output = nullptr;
+        OP_REQUIRES_OK(context,
+                       context->allocate_output(0, output_shape, &output));
+        auto Tout = output->flat<T>();
+
+        for (int64 i = 0; i < uniq_size; ++i) {
+          Tout(i) = std::move(uniq_values[i]);
+        }
+      } else {
+        std::unordered_map<T, TIndex> uniq;
+        uniq.reserve(2 * N);
+        for (Eigen::Index i = 0, j = 0; i < N; ++i) {
+          auto it = uniq.insert(std::make_pair(Tin(i), j));
+          idx_vec(i) = it.first->second;
+          if (it.second) {
+            ++j;
+          }
         }
-      }
 
-      uniq_size = static_cast<int64>(uniq.size());
-      TensorShape output_shape(input.shape());
-      output_shape.set_dim(axis, uniq_size);
-      Tensor* output = nullptr;
-      OP_REQUIRES_OK(context,
-                     context->allocate_output(0, output_shape, &output));
-      auto Tout = output->flat<T>();
+        uniq_size = static_cast<int64>(uniq.size());
+        TensorShape output_shape(input.shape());
+        output_shape.set_dim(axis, uniq_size);
+        Tensor* output = nullptr;
+        OP_REQUIRES_OK(context,
+                       context->allocate_output(0, output_shape, &output));
+        auto Tout = output->flat<T>();
 
-      for (auto it : uniq) {
-        Tout(it.second) = it.first;
+        for (auto it : uniq) {
+          Tout(it.second) = it.first;
+        }
       }
     } else {
       // General implementation when unique is run over multiple elements.
@@ -192,6 +340,9 @@ class UniqueOp : public OpKernel {
       }
     }
   }
+
+ private:
+  bool use_parallel_unique_;
 };
 
 #define REGISTER_UNIQUE(type)                                    \
@@ -102,6 +102,29 @@ static void BM_Unique_INT32_Repeat(int iters, int dim, int max_int) {
   test::Benchmark("cpu", g).Run(iters);
 }
 
+static void BM_Unique_INT32_Parallel(int iters, int dim, int max_int) {
+  testing::StopTiming();
+  setenv("TF_PARALLEL_UNIQUE", "1", 1 /* overwrite */);
+  Graph* g = new Graph(OpRegistry::Global());
+
+  Tensor input(DT_INT32, TensorShape({dim}));
+  CHECK(input.FromProto(GetRandomInt32TensorProto(dim, max_int)));
+
+  Node* node;
+  TF_CHECK_OK(NodeBuilder(g->NewName("n"), "Unique")
+                  .Input(test::graph::Constant(g, input))
+                  .Attr("T", DT_INT32)
+                  .Finalize(g, &node));
+
+  testing::BytesProcessed(static_cast<int64>(iters) * dim * sizeof(int32));
+  testing::UseRealTime();
+  testing::StartTiming();
+  test::Benchmark("cpu", g).Run(iters);
+  testing::StopTiming();
+  unsetenv("TF_PARALLEL_UNIQUE");
+  testing::StartTiming();
+}
+
 TensorProto GetRandomStringsTensorProto(int dim, int max_str_len) {
   TensorProto tensor_proto;
   tensor_proto.set_dtype(DT_STRING);
@@ -180,6 +203,12 @@ BENCHMARK(BM_Unique_INT32_Repeat)
     ->ArgPair(64 * 1024, 64 * 1024 * 1024)
     ->ArgPair(1024 * 1024, 64 * 1024 * 1024);
 
+BENCHMARK(BM_Unique_INT32_Parallel)
+    ->ArgPair(1024 * 1024, 1024 * 1024)
+    ->ArgPair(4 * 1024 * 1024, 1024 * 1024)
+    ->ArgPair(1024 * 1024, 64 * 1024 * 1024)
+    ->ArgPair(4 * 1024 * 1024, 64 * 1024 * 1024);
+
 BENCHMARK(BM_Unique_STRING)
     ->Arg(32)
     ->Arg(256)
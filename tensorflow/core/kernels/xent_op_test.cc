@@ -58,4 +58,10 @@ BM_XentDev(16, 10000, cpu);
 BM_XentDev(32, 10000, cpu);
 BM_XentDev(64, 10000, cpu);
 
+/// Vocabulary-sized class counts exercising the row-tiled CPU fast path.
+BM_XentDev(16, 30000, cpu);
+BM_XentDev(16, 100000, cpu);
+BM_XentDev(16, 500000, cpu);
+BM_XentDev(64, 100000, cpu);
+
 }  // end namespace tensorflow
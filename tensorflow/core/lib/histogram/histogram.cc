@@ -113,6 +113,42 @@ void Histogram::Add(double value) {
   sum_squares_ += (value * value);
 }
 
+void Histogram::Add(gtl::ArraySlice<double> values) {
+  if (values.empty()) return;
+  double min = min_;
+  double max = max_;
+  double sum = 0;
+  double sum_squares = 0;
+  for (double value : values) {
+    int b =
+        std::upper_bound(bucket_limits_.begin(), bucket_limits_.end(), value) -
+        bucket_limits_.begin();
+    buckets_[b] += 1.0;
+    if (min > value) min = value;
+    if (max < value) max = value;
+    sum += value;
+    sum_squares += (value * value);
+  }
+  min_ = min;
+  max_ = max;
+  num_ += values.size();
+  sum_ += sum;
+  sum_squares_ += sum_squares;
+}
+
+void Histogram::Merge(const Histogram& other) {
+  DCHECK_EQ(bucket_limits_.size(), other.bucket_limits_.size());
+  for (size_t i = 0; i < buckets_.size(); i++) {
+    DCHECK_EQ(bucket_limits_[i], other.bucket_limits_[i]);
+    buckets_[i] += other.buckets_[i];
+  }
+  if (min_ > other.min_) min_ = other.min_;
+  if (max_ < other.max_) max_ = other.max_;
+  num_ += other.num_;
+  sum_ += other.sum_;
+  sum_squares_ += other.sum_squares_;
+}
+
 double Histogram::Median() const { return Percentile(50.0); }
 
 // Linearly map the variable x from [x0, x1] unto [y0, y1]
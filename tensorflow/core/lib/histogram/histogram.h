@@ -54,6 +54,16 @@ class Histogram {
   void Clear();
   void Add(double value);
 
+  // Add every value in "values".  Cheaper than calling Add() per
+  // element for large inputs since the summary statistics are
+  // accumulated in locals across the batch.
+  void Add(gtl::ArraySlice<double> values);
+
+  // Merge the contents of "other" into this histogram.  Used to combine
+  // histograms built in parallel over shards of a large input.
+  // REQUIRES: both histograms have identical bucket limits.
+  void Merge(const Histogram& other);
+
   // Save the current state of the histogram to "*proto".  If
   // "preserve_zero_buckets" is false, only non-zero bucket values and
   // ranges are saved, and the bucket boundaries of zero-valued buckets
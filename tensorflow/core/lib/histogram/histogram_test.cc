@@ -15,6 +15,7 @@ limitations under the License.
 
 #include "tensorflow/core/lib/histogram/histogram.h"
 #include <float.h>
+#include <vector>
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/test.h"
@@ -112,6 +113,42 @@ TEST(Histogram, Basic) {
   Validate(h);
 }
 
+TEST(Histogram, BatchAddMatchesSingleAdds) {
+  Histogram single;
+  Histogram batched;
+  std::vector<double> values;
+  for (int i = 0; i < 100; i++) {
+    single.Add(i * 0.37 - 5.0);
+    values.push_back(i * 0.37 - 5.0);
+  }
+  batched.Add(values);
+  HistogramProto single_proto;
+  HistogramProto batched_proto;
+  single.EncodeToProto(&single_proto, true /* preserve_zero_buckets */);
+  batched.EncodeToProto(&batched_proto, true /* preserve_zero_buckets */);
+  EXPECT_EQ(single_proto.DebugString(), batched_proto.DebugString());
+}
+
+TEST(Histogram, MergeMatchesCombinedAdds) {
+  Histogram combined;
+  Histogram first;
+  Histogram second;
+  for (int i = 0; i < 100; i++) {
+    combined.Add(i);
+    if (i < 60) {
+      first.Add(i);
+    } else {
+      second.Add(i);
+    }
+  }
+  first.Merge(second);
+  HistogramProto combined_proto;
+  HistogramProto merged_proto;
+  combined.EncodeToProto(&combined_proto, true /* preserve_zero_buckets */);
+  first.EncodeToProto(&merged_proto, true /* preserve_zero_buckets */);
+  EXPECT_EQ(combined_proto.DebugString(), merged_proto.DebugString());
+}
+
 TEST(ThreadSafeHistogram, Basic) {
   // Fill a normal histogram.
   Histogram h;
@@ -13,6 +13,8 @@ See the License for the specific language governing permissions and
 limitations under the License.
 ==============================================================================*/
 
+#include <string.h>
+
 #include <limits>
 
 #include "tensorflow/core/lib/io/format.h"
@@ -161,5 +163,53 @@ Status ReadBlock(RandomAccessFile* file, const BlockHandle& handle,
   return Status::OK();
 }
 
+Status DecodeBlock(const char* data, const BlockHandle& handle,
+                   BlockContents* result) {
+  result->data = StringPiece();
+  result->cachable = false;
+  result->heap_allocated = false;
+
+  // Check the crc of the type and the block contents.  See table_builder.cc
+  // for the code that built this structure.
+  const size_t n = static_cast<size_t>(handle.size());
+  const uint32 crc = crc32c::Unmask(core::DecodeFixed32(data + n + 1));
+  const uint32 actual = crc32c::Value(data, n + 1);
+  if (actual != crc) {
+    return errors::DataLoss("block checksum mismatch");
+  }
+
+  switch (data[n]) {
+    case kNoCompression: {
+      // Copy the contents so that the result does not alias "data", whose
+      // lifetime the caller controls independently of the block.
+      char* buf = new char[n];
+      memcpy(buf, data, n);
+      result->data = StringPiece(buf, n);
+      result->heap_allocated = true;
+      result->cachable = true;
+      break;
+    }
+    case kSnappyCompression: {
+      size_t ulength = 0;
+      if (!port::Snappy_GetUncompressedLength(data, n, &ulength)) {
+        return errors::DataLoss("corrupted compressed block contents");
+      }
+      char* ubuf = new char[ulength];
+      if (!port::Snappy_Uncompress(data, n, ubuf)) {
+        delete[] ubuf;
+        return errors::DataLoss("corrupted compressed block contents");
+      }
+      result->data = StringPiece(ubuf, ulength);
+      result->heap_allocated = true;
+      result->cachable = true;
+      break;
+    }
+    default:
+      return errors::DataLoss("bad block type");
+  }
+
+  return Status::OK();
+}
+
 }  // namespace table
 }  // namespace tensorflow
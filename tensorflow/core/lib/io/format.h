@@ -99,6 +99,13 @@ struct BlockContents {
 extern Status ReadBlock(RandomAccessFile* file, const BlockHandle& handle,
                         BlockContents* result);
 
+// Decode the block stored at "data", which holds the raw bytes of the block
+// described by "handle" followed by its type/crc trailer (i.e.
+// handle.size() + kBlockTrailerSize bytes), as laid out in a table file.  On
+// success fills *result with a heap-allocated copy of the block contents.
+extern Status DecodeBlock(const char* data, const BlockHandle& handle,
+                          BlockContents* result);
+
 // Implementation details follow.  Clients should ignore,
 
 inline BlockHandle::BlockHandle()
@@ -0,0 +1,48 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/lib/io/memory_region_file.h"
+
+#include "tensorflow/core/lib/core/errors.h"
+
+namespace tensorflow {
+namespace io {
+
+MemoryRegionRandomAccessFile::MemoryRegionRandomAccessFile(
+    std::unique_ptr<ReadOnlyMemoryRegion> region)
+    : region_(std::move(region)) {
+  DCHECK(region_ != nullptr);
+}
+
+Status MemoryRegionRandomAccessFile::Read(uint64 offset, size_t n,
+                                          StringPiece* result,
+                                          char* scratch) const {
+  const uint64 size = region_->length();
+  if (offset >= size) {
+    *result = StringPiece();
+    return errors::OutOfRange("EOF reached: read past end of mapped region");
+  }
+  const uint64 available = size - offset;
+  *result = StringPiece(static_cast<const char*>(region_->data()) + offset,
+                        std::min<uint64>(n, available));
+  if (available < n) {
+    return errors::OutOfRange("EOF reached: requested ", n,
+                              " bytes with only ", available, " available");
+  }
+  return Status::OK();
+}
+
+}  // namespace io
+}  // namespace tensorflow
@@ -0,0 +1,52 @@
+/* Copyright 2018 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_LIB_IO_MEMORY_REGION_FILE_H_
+#define TENSORFLOW_CORE_LIB_IO_MEMORY_REGION_FILE_H_
+
+#include <memory>
+
+#include "tensorflow/core/platform/env.h"
+
+namespace tensorflow {
+namespace io {
+
+// A RandomAccessFile backed by a ReadOnlyMemoryRegion (typically an mmap'd
+// file).  Reads are served as StringPieces pointing directly into the mapped
+// region without touching the scratch buffer, so readers that consume the
+// result in place (e.g. RecordReader) avoid both the read syscall and the
+// copy into a read buffer.
+class MemoryRegionRandomAccessFile : public RandomAccessFile {
+ public:
+  // Takes ownership of "region", which must be non-null.
+  explicit MemoryRegionRandomAccessFile(
+      std::unique_ptr<ReadOnlyMemoryRegion> region);
+
+  // Returns a view into the mapped region; "scratch" is unused.  Returns
+  // OUT_OF_RANGE with a partial result if fewer than "n" bytes are
+  // available, matching the RandomAccessFile contract.
+  Status Read(uint64 offset, size_t n, StringPiece* result,
+              char* scratch) const override;
+
+ private:
+  const std::unique_ptr<ReadOnlyMemoryRegion> region_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(MemoryRegionRandomAccessFile);
+};
+
+}  // namespace io
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_IO_MEMORY_REGION_FILE_H_
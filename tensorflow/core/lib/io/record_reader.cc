@@ -23,11 +23,25 @@ limitations under the License.
 #include "tensorflow/core/lib/io/buffered_inputstream.h"
 #include "tensorflow/core/lib/io/compression.h"
 #include "tensorflow/core/lib/io/random_inputstream.h"
+#if !defined(IS_SLIM_BUILD)
+#include "tensorflow/core/lib/io/snappy/snappy_inputbuffer.h"
+#endif  // IS_SLIM_BUILD
 #include "tensorflow/core/platform/env.h"
 
 namespace tensorflow {
 namespace io {
 
+#if !defined(IS_SLIM_BUILD)
+namespace {
+// The input buffer must be able to hold one whole compressed block. The
+// writer batches up to kSnappyBufferSize bytes (see record_writer.cc) per
+// block, so allow for snappy's worst-case expansion of that batch. The
+// output buffer holds one uncompressed block.
+const size_t kSnappyReaderInputBufferSize = 1 << 21;   // 2MB
+const size_t kSnappyReaderOutputBufferSize = 1 << 20;  // 1MB
+}  // namespace
+#endif  // IS_SLIM_BUILD
+
 RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
     const string& compression_type) {
   RecordReaderOptions options;
@@ -46,6 +60,12 @@ RecordReaderOptions RecordReaderOptions::CreateRecordReaderOptions(
                << " No compression will be used.";
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
+#endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kSnappy) {
+    options.compression_type = io::RecordReaderOptions::SNAPPY_COMPRESSION;
+#if defined(IS_SLIM_BUILD)
+    LOG(ERROR) << "Compression is not supported but compression_type is set."
+               << " No compression will be used.";
 #endif  // IS_SLIM_BUILD
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
@@ -71,6 +91,16 @@ RecordReader::RecordReader(RandomAccessFile* file,
     input_stream_.reset(new ZlibInputStream(
         input_stream_.release(), options.zlib_options.input_buffer_size,
         options.zlib_options.output_buffer_size, options.zlib_options, true));
+#endif  // IS_SLIM_BUILD
+  } else if (options.compression_type ==
+             RecordReaderOptions::SNAPPY_COMPRESSION) {
+#if defined(IS_SLIM_BUILD)
+    LOG(FATAL) << "Snappy compression is unsupported on mobile platforms.";
+#else   // IS_SLIM_BUILD
+    // SnappyInputBuffer does its own buffered reads from the file, so the
+    // buffering stream built above is not needed.
+    input_stream_.reset(new SnappyInputBuffer(
+        file, kSnappyReaderInputBufferSize, kSnappyReaderOutputBufferSize));
 #endif  // IS_SLIM_BUILD
   } else if (options.compression_type == RecordReaderOptions::NONE) {
     // Nothing to do.
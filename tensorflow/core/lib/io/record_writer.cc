@@ -26,6 +26,17 @@ namespace {
 bool IsZlibCompressed(RecordWriterOptions options) {
   return options.compression_type == RecordWriterOptions::ZLIB_COMPRESSION;
 }
+
+bool IsSnappyCompressed(RecordWriterOptions options) {
+  return options.compression_type == RecordWriterOptions::SNAPPY_COMPRESSION;
+}
+
+#if !defined(IS_SLIM_BUILD)
+// Size of the buffer in which records are batched up before being compressed
+// as a single snappy block. The reader's buffers (see record_reader.cc) must
+// be able to hold a whole block, so keep the two in sync.
+const int32 kSnappyBufferSize = 1 << 20;  // 1MB
+#endif  // IS_SLIM_BUILD
 }  // namespace
 
 RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
@@ -46,6 +57,12 @@ RecordWriterOptions RecordWriterOptions::CreateRecordWriterOptions(
                << " No compression will be used.";
 #else
     options.zlib_options = io::ZlibCompressionOptions::GZIP();
+#endif  // IS_SLIM_BUILD
+  } else if (compression_type == compression::kSnappy) {
+    options.compression_type = io::RecordWriterOptions::SNAPPY_COMPRESSION;
+#if defined(IS_SLIM_BUILD)
+    LOG(ERROR) << "Compression is not supported but compression_type is set."
+               << " No compression will be used.";
 #endif  // IS_SLIM_BUILD
   } else if (compression_type != compression::kNone) {
     LOG(ERROR) << "Unsupported compression_type:" << compression_type
@@ -71,6 +88,12 @@ RecordWriter::RecordWriter(WritableFile* dest,
                  << s.ToString();
     }
     dest_ = zlib_output_buffer;
+#endif  // IS_SLIM_BUILD
+  } else if (IsSnappyCompressed(options)) {
+#if defined(IS_SLIM_BUILD)
+    LOG(FATAL) << "Snappy compression is unsupported on mobile platforms.";
+#else   // IS_SLIM_BUILD
+    dest_ = new SnappyOutputBuffer(dest, kSnappyBufferSize, kSnappyBufferSize);
 #endif  // IS_SLIM_BUILD
   } else if (options.compression_type == RecordWriterOptions::NONE) {
     // Nothing to do
@@ -110,7 +133,7 @@ Status RecordWriter::WriteRecord(StringPiece data) {
 Status RecordWriter::Close() {
   if (dest_ == nullptr) return Status::OK();
 #if !defined(IS_SLIM_BUILD)
-  if (IsZlibCompressed(options_)) {
+  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
     Status s = dest_->Close();
     delete dest_;
     dest_ = nullptr;
@@ -125,7 +148,7 @@ Status RecordWriter::Flush() {
     return Status(::tensorflow::error::FAILED_PRECONDITION,
                   "Writer not initialized or previously closed");
   }
-  if (IsZlibCompressed(options_)) {
+  if (IsZlibCompressed(options_) || IsSnappyCompressed(options_)) {
     return dest_->Flush();
   }
   return Status::OK();
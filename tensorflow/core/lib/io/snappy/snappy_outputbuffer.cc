@@ -76,6 +76,19 @@ Status SnappyOutputBuffer::Flush() {
   return Status::OK();
 }
 
+Status SnappyOutputBuffer::Append(StringPiece data) { return Write(data); }
+
+Status SnappyOutputBuffer::Close() {
+  // Compresses and writes out any cached input; the file itself is not
+  // owned, so it is left open.
+  return Flush();
+}
+
+Status SnappyOutputBuffer::Sync() {
+  TF_RETURN_IF_ERROR(Flush());
+  return file_->Sync();
+}
+
 int32 SnappyOutputBuffer::AvailableInputSpace() const {
   return input_buffer_capacity_ - avail_in_;
 }
@@ -43,7 +43,11 @@ namespace io {
 // _compressed_ block _excluding_ this header. The compressed
 // block (excluding the 4 byte header) is a valid snappy block and can directly
 // be uncompressed using Snappy_Uncompress.
-class SnappyOutputBuffer {
+//
+// SnappyOutputBuffer is a WritableFile, so it can stand in for the
+// destination file of a writer that compresses its output (see
+// RecordWriter).
+class SnappyOutputBuffer : public WritableFile {
  public:
   // Create an SnappyOutputBuffer for `file` with two buffers that cache the
   // 1. input data to be deflated
@@ -65,7 +69,19 @@ class SnappyOutputBuffer {
 
   // Compresses any cached input and writes all output to file. This must be
   // called before the destructor to avoid any data loss.
-  Status Flush();
+  Status Flush() override;
+
+  // WritableFile methods.
+  //
+  // Appends `data` to the compression pipeline; equivalent to `Write()`.
+  Status Append(StringPiece data) override;
+
+  // Compresses and writes out any cached input. Does *not* close `file_`,
+  // which is not owned.
+  Status Close() override;
+
+  // Flushes any cached input and syncs `file_`.
+  Status Sync() override;
 
  private:
   // Appends `data` to `input_buffer_`.
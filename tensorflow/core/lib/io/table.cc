@@ -15,6 +15,10 @@ limitations under the License.
 
 #include "tensorflow/core/lib/io/table.h"
 
+#include <string.h>
+
+#include <algorithm>
+
 #include "tensorflow/core/lib/core/coding.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/io/block.h"
@@ -22,6 +26,7 @@ limitations under the License.
 #include "tensorflow/core/lib/io/table_options.h"
 #include "tensorflow/core/lib/io/two_level_iterator.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 
 namespace tensorflow {
 namespace table {
@@ -36,6 +41,14 @@ struct Table::Rep {
 
   BlockHandle metaindex_handle;  // Handle to metaindex_block: saved from footer
   Block* index_block;
+
+  // Readahead state, used only when options.readahead_bytes > 0.
+  mutex mu;
+  // File offset of the first byte of `readahead_buffer`.  Only meaningful
+  // when the buffer is non-empty.
+  uint64 readahead_offset GUARDED_BY(mu) = 0;
+  // Span of the file fetched by the most recent readahead read.
+  string readahead_buffer GUARDED_BY(mu);
 };
 
 Status Table::Open(const Options& options, RandomAccessFile* file, uint64 size,
@@ -105,7 +118,11 @@ Iterator* Table::BlockReader(void* arg, const StringPiece& index_value) {
 
   if (s.ok()) {
     BlockContents contents;
-    s = ReadBlock(table->rep_->file, handle, &contents);
+    if (table->rep_->options.readahead_bytes > 0) {
+      s = table->ReadWithReadahead(handle, &contents);
+    } else {
+      s = ReadBlock(table->rep_->file, handle, &contents);
+    }
     if (s.ok()) {
       block = new Block(contents);
     }
@@ -121,6 +138,44 @@ Iterator* Table::BlockReader(void* arg, const StringPiece& index_value) {
   return iter;
 }
 
+Status Table::ReadWithReadahead(const BlockHandle& handle,
+                                BlockContents* contents) {
+  Rep* r = rep_;
+  const uint64 needed = handle.size() + kBlockTrailerSize;
+  mutex_lock l(r->mu);
+  if (handle.offset() < r->readahead_offset ||
+      handle.offset() + needed >
+          r->readahead_offset + r->readahead_buffer.size()) {
+    // Miss: read forward from the requested block, covering as many
+    // subsequent blocks as fit in the readahead span.
+    const uint64 num_bytes =
+        std::max<uint64>(needed, r->options.readahead_bytes);
+    r->readahead_buffer.clear();
+    r->readahead_buffer.resize(num_bytes);
+    StringPiece data;
+    Status s = r->file->Read(handle.offset(), num_bytes, &data,
+                             &r->readahead_buffer[0]);
+    // A read that runs into the end of the file reports OUT_OF_RANGE but
+    // still returns the available bytes, which may cover the block.
+    if (!s.ok() && !errors::IsOutOfRange(s)) {
+      r->readahead_buffer.clear();
+      return s;
+    }
+    if (data.size() < needed) {
+      r->readahead_buffer.clear();
+      return errors::DataLoss("truncated block read");
+    }
+    if (data.data() != r->readahead_buffer.data()) {
+      memcpy(&r->readahead_buffer[0], data.data(), data.size());
+    }
+    r->readahead_buffer.resize(data.size());
+    r->readahead_offset = handle.offset();
+  }
+  return DecodeBlock(
+      r->readahead_buffer.data() + (handle.offset() - r->readahead_offset),
+      handle, contents);
+}
+
 Iterator* Table::NewIterator() const {
   return NewTwoLevelIterator(rep_->index_block->NewIterator(),
                              &Table::BlockReader, const_cast<Table*>(this));
@@ -26,6 +26,7 @@ namespace table {
 
 class Block;
 class BlockHandle;
+struct BlockContents;
 class Footer;
 struct Options;
 
@@ -69,6 +70,11 @@ class Table {
   explicit Table(Rep* rep) { rep_ = rep; }
   static Iterator* BlockReader(void*, const StringPiece&);
 
+  // Reads the block identified by "handle", serving it from the readahead
+  // buffer when possible and refilling the buffer (with up to
+  // Options::readahead_bytes starting at the block) on a miss.
+  Status ReadWithReadahead(const BlockHandle& handle, BlockContents* contents);
+
   // Calls (*handle_result)(arg, ...) with the entry found after a call
   // to Seek(key).  May not make such a call if filter policy says
   // that key is not present.
@@ -60,6 +60,15 @@ struct Options {
   // incompressible, the kSnappyCompression implementation will
   // efficiently detect that and will switch to uncompressed mode.
   CompressionType compression = kSnappyCompression;
+
+  // When positive, data block reads issued by table iterators fetch up to
+  // this many bytes starting at the requested block and serve subsequent
+  // blocks from the buffered span, so a sequential scan of the table issues
+  // a few large reads instead of one random read per block.  Reads that fall
+  // outside the buffered span trigger a new readahead read.
+  //
+  // Default: 0 (one read per block).
+  size_t readahead_bytes = 0;
 };
 
 }  // namespace table
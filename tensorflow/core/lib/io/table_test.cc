@@ -138,14 +138,18 @@ class StringSource : public RandomAccessFile {
     memcpy(scratch, &contents_[offset], n);
     *result = StringPiece(scratch, n);
     bytes_read_ += n;
+    num_reads_++;
     return Status::OK();
   }
 
   uint64 BytesRead() const { return bytes_read_; }
 
+  uint64 NumReads() const { return num_reads_; }
+
  private:
   string contents_;
   mutable uint64 bytes_read_;
+  mutable uint64 num_reads_ = 0;
 };
 
 typedef std::map<string, string, STLLessThan> KVMap;
@@ -609,6 +613,60 @@ TEST(TableTest, ApproximateOffsetOfCompressed) {
   ASSERT_TRUE(Between(c.ApproximateOffsetOf("xyz"), 4000, 7000));
 }
 
+// Scans the whole table through an iterator opened with "options",
+// verifying it against "data", and returns the number of file reads the
+// scan issued (excluding the reads done by Table::Open).
+static uint64 ScanTable(const Options& options, StringSource* source,
+                        const KVMap& data) {
+  Table* table = nullptr;
+  TF_CHECK_OK(Table::Open(options, source, source->Size(), &table));
+  const uint64 reads_before_scan = source->NumReads();
+  Iterator* iter = table->NewIterator();
+  KVMap::const_iterator expected = data.begin();
+  for (iter->SeekToFirst(); iter->Valid(); iter->Next()) {
+    CHECK(expected != data.end());
+    EXPECT_EQ(expected->first, iter->key());
+    EXPECT_EQ(expected->second, iter->value());
+    ++expected;
+  }
+  EXPECT_TRUE(expected == data.end());
+  TF_CHECK_OK(iter->status());
+  delete iter;
+  delete table;
+  return source->NumReads() - reads_before_scan;
+}
+
+TEST(TableTest, ReadaheadBatchesSequentialReads) {
+  KVMap data((STLLessThan()));
+  for (int i = 0; i < 100; i++) {
+    char key[16];
+    snprintf(key, sizeof(key), "k%04d", i);
+    data[key] = string(500, 'x');
+  }
+  StringSink sink;
+  Options options;
+  options.block_size = 1024;
+  options.compression = kNoCompression;
+  TableBuilder builder(options, &sink);
+  for (KVMap::const_iterator it = data.begin(); it != data.end(); ++it) {
+    builder.Add(it->first, it->second);
+    TF_CHECK_OK(builder.status());
+  }
+  TF_CHECK_OK(builder.Finish());
+
+  StringSource per_block_source(sink.contents());
+  const uint64 per_block_reads = ScanTable(options, &per_block_source, data);
+
+  options.readahead_bytes = 1 << 20;
+  StringSource readahead_source(sink.contents());
+  const uint64 readahead_reads = ScanTable(options, &readahead_source, data);
+
+  // The plain scan reads every data block individually, while the readahead
+  // scan covers all the data blocks with a single large read.
+  EXPECT_GT(per_block_reads, 10);
+  EXPECT_LE(readahead_reads, 1);
+}
+
 TEST(TableTest, SeekToFirstKeyDoesNotReadTooMuch) {
   random::PhiloxRandom philox(301, 17);
   random::SimplePhilox rnd(&philox);
@@ -0,0 +1,124 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+// Batched CPU generation of Philox random bits. PhiloxRandom is a counter
+// based generator, so consecutive 128-bit samples are fully independent and
+// can be computed in parallel lanes. FillPhiloxBatch runs several counters
+// through the ten Philox rounds in lock-step, laid out structure-of-arrays
+// so that the per-round loops auto-vectorize (AVX2 on x86, NEON on ARM)
+// without any platform-specific intrinsics. The output bits are identical
+// to calling PhiloxRandom::operator() sequentially.
+
+#ifndef TENSORFLOW_CORE_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
+#define TENSORFLOW_CORE_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
+
+#include <algorithm>
+
+#include "tensorflow/core/lib/random/philox_random.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+namespace random {
+
+// The number of Philox counters computed in lock-step. Eight 32-bit lanes
+// fill one AVX2 register; on narrower SIMD units the compiler simply
+// unrolls to two or four registers.
+static const int kPhiloxBatchLanes = 8;
+
+// Writes the next `num_groups` 128-bit samples of `*gen` to `out` (that is,
+// `num_groups * PhiloxRandom::kResultElementCount` uint32 values) and
+// advances `*gen` past them. Produces exactly the same bits, in the same
+// order, as calling `(*gen)()` `num_groups` times.
+inline void FillPhiloxBatch(PhiloxRandom* gen, uint32* out,
+                            int64 num_groups) {
+  // Constants from the original paper, identical to those used by
+  // PhiloxRandom (they are private there).
+  const uint32 kPhiloxW32A = 0x9E3779B9;
+  const uint32 kPhiloxW32B = 0xBB67AE85;
+  const uint32 kPhiloxM4x32A = 0xD2511F53;
+  const uint32 kPhiloxM4x32B = 0xCD9E8D57;
+
+  const int kLanes = kPhiloxBatchLanes;
+  while (num_groups >= kLanes) {
+    const PhiloxRandom::ResultType& base = gen->counter();
+    const PhiloxRandom::Key& base_key = gen->key();
+
+    // Lane l starts from the 128-bit counter value base + l.
+    uint32 c0[kLanes];
+    uint32 c1[kLanes];
+    uint32 c2[kLanes];
+    uint32 c3[kLanes];
+    for (int l = 0; l < kLanes; ++l) {
+      const uint32 lo = base[0] + static_cast<uint32>(l);
+      uint32 carry = lo < base[0] ? 1 : 0;
+      c0[l] = lo;
+      const uint32 w1 = base[1] + carry;
+      carry = (carry != 0 && w1 == 0) ? 1 : 0;
+      c1[l] = w1;
+      const uint32 w2 = base[2] + carry;
+      carry = (carry != 0 && w2 == 0) ? 1 : 0;
+      c2[l] = w2;
+      c3[l] = base[3] + carry;
+    }
+
+    // Ten rounds; the key is the same scalar for every lane.
+    uint32 key0 = base_key[0];
+    uint32 key1 = base_key[1];
+    for (int round = 0; round < 10; ++round) {
+      for (int l = 0; l < kLanes; ++l) {
+        const uint64 product0 = static_cast<uint64>(kPhiloxM4x32A) * c0[l];
+        const uint64 product1 = static_cast<uint64>(kPhiloxM4x32B) * c2[l];
+        const uint32 lo0 = static_cast<uint32>(product0);
+        const uint32 hi0 = static_cast<uint32>(product0 >> 32);
+        const uint32 lo1 = static_cast<uint32>(product1);
+        const uint32 hi1 = static_cast<uint32>(product1 >> 32);
+        const uint32 result0 = hi1 ^ c1[l] ^ key0;
+        const uint32 result2 = hi0 ^ c3[l] ^ key1;
+        c0[l] = result0;
+        c1[l] = lo1;
+        c2[l] = result2;
+        c3[l] = lo0;
+      }
+      key0 += kPhiloxW32A;
+      key1 += kPhiloxW32B;
+    }
+
+    // Interleave the lanes back into the sequential output order.
+    for (int l = 0; l < kLanes; ++l) {
+      out[4 * l + 0] = c0[l];
+      out[4 * l + 1] = c1[l];
+      out[4 * l + 2] = c2[l];
+      out[4 * l + 3] = c3[l];
+    }
+    out += 4 * kLanes;
+    gen->Skip(kLanes);
+    num_groups -= kLanes;
+  }
+
+  // Scalar tail for the last few groups.
+  while (num_groups > 0) {
+    const PhiloxRandom::ResultType sample = (*gen)();
+    for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+      out[j] = sample[j];
+    }
+    out += PhiloxRandom::kResultElementCount;
+    --num_groups;
+  }
+}
+
+}  // namespace random
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_LIB_RANDOM_PHILOX_RANDOM_BATCH_H_
@@ -21,6 +21,7 @@ limitations under the License.
 #include <unordered_map>
 #include <vector>
 
+#include "tensorflow/core/lib/random/philox_random_batch.h"
 #include "tensorflow/core/lib/random/philox_random_test_utils.h"
 #include "tensorflow/core/lib/random/random.h"
 #include "tensorflow/core/lib/random/random_distributions.h"
@@ -68,6 +69,35 @@ TEST(PhiloxRandomTest, SkipMatchTest) {
   }
 }
 
+// This test checks that the batched lane-parallel generator produces
+// exactly the bits of sequential generation, including when the group
+// count is not a multiple of the lane width, and that it leaves the
+// generator in the same state.
+TEST(PhiloxRandomTest, BatchMatchTest) {
+  constexpr int count = 1024 + kPhiloxBatchLanes - 1;
+
+  uint64 test_seed = GetTestSeed();
+  std::vector<uint32> v1(count * PhiloxRandom::kResultElementCount);
+  PhiloxRandom gen1(test_seed);
+  FillPhiloxBatch(&gen1, &v1[0], count);
+
+  std::vector<uint32> v2(count * PhiloxRandom::kResultElementCount);
+  PhiloxRandom gen2(test_seed);
+  FillRandoms<TrivialPhiloxDistribution>(gen2, &v2[0], v2.size());
+
+  for (size_t i = 0; i < v1.size(); ++i) {
+    ASSERT_EQ(v1[i], v2[i]);
+  }
+
+  // Both generators should have been advanced past the same samples.
+  gen2.Skip(count);
+  auto s1 = gen1();
+  auto s2 = gen2();
+  for (int j = 0; j < PhiloxRandom::kResultElementCount; ++j) {
+    ASSERT_EQ(s1[j], s2[j]);
+  }
+}
+
 }  // namespace
 }  // namespace random
 }  // namespace tensorflow
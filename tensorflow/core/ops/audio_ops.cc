@@ -100,6 +100,24 @@ Status SpectrogramShapeFn(InferenceContext* c) {
   return Status::OK();
 }
 
+Status StreamingSpectrogramShapeFn(InferenceContext* c) {
+  ShapeHandle input;
+  TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 2, &input));
+  int32 window_size;
+  TF_RETURN_IF_ERROR(c->GetAttr("window_size", &window_size));
+
+  DimensionHandle input_channels = c->Dim(input, 1);
+
+  // The number of frames produced by a call depends on how many samples
+  // were left buffered by previous calls, so only the channel counts are
+  // statically known.
+  DimensionHandle output_channels =
+      c->MakeDim(1 + NextPowerOfTwo(window_size) / 2);
+  c->set_output(
+      0, c->MakeShape({input_channels, c->UnknownDim(), output_channels}));
+  return Status::OK();
+}
+
 Status MfccShapeFn(InferenceContext* c) {
   ShapeHandle spectrogram;
   TF_RETURN_IF_ERROR(c->WithRank(c->input(0), 3, &spectrogram));
@@ -144,6 +162,15 @@ REGISTER_OP("AudioSpectrogram")
     .Output("spectrogram: float")
     .SetShapeFn(SpectrogramShapeFn);
 
+REGISTER_OP("StreamingAudioSpectrogram")
+    .Input("input: float")
+    .Attr("window_size: int")
+    .Attr("stride: int")
+    .Attr("magnitude_squared: bool = false")
+    .Output("spectrogram: float")
+    .SetIsStateful()
+    .SetShapeFn(StreamingSpectrogramShapeFn);
+
 REGISTER_OP("Mfcc")
     .Input("spectrogram: float")
     .Input("sample_rate: int32")
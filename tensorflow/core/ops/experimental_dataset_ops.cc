@@ -476,6 +476,29 @@ REGISTER_OP("ExperimentalLMDBDataset")
                       // stateful to inhibit constant folding.
     .SetShapeFn(shape_inference::ScalarShape);
 
+REGISTER_OP("ExperimentalDecodeJpegDataset")
+    .Input("input_dataset: variant")
+    .Output("handle: variant")
+    .Attr("channels: int = 3")
+    .Attr("ratio: int = 1")
+    .Attr("num_decode_threads: int = 0")
+    .SetShapeFn(shape_inference::ScalarShape);
+
+REGISTER_OP("ExperimentalSnapshotDataset")
+    .Input("input_dataset: variant")
+    .Input("path: string")
+    .Output("handle: variant")
+    .Attr("compression: string = ''")
+    .Attr("num_writer_threads: int = 2")
+    .Attr("output_types: list(type) >= 1")
+    .Attr("output_shapes: list(shape) >= 1")
+    .SetShapeFn([](shape_inference::InferenceContext* c) {
+      shape_inference::ShapeHandle unused;
+      // `path` should be a scalar.
+      TF_RETURN_IF_ERROR(c->WithRank(c->input(1), 0, &unused));
+      return shape_inference::ScalarShape(c);
+    });
+
 REGISTER_OP("ExperimentalChooseFastestDataset")
     .Input("input_datasets: N * variant")
     .Output("handle: variant")
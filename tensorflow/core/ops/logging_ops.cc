@@ -98,6 +98,15 @@ REGISTER_OP("HistogramSummary")
     .Attr("T: realnumbertype = DT_FLOAT")
     .SetShapeFn(shape_inference::ScalarShape);
 
+REGISTER_OP("QuantileSummary")
+    .Input("tag: string")
+    .Input("values: T")
+    .Output("summary: string")
+    .Attr("T: realnumbertype = DT_FLOAT")
+    .Attr("num_quantiles: int >= 2 = 100")
+    .Attr("eps: float = 0.01")
+    .SetShapeFn(shape_inference::ScalarShape);
+
 REGISTER_OP("ImageSummary")
     .Input("tag: string")
     .Input("tensor: T")
@@ -769,6 +769,43 @@ REGISTER_OP("ResourceApplyAdam")
       return ApplyAdamShapeFn(c, false /* sparse */);
     });
 
+static Status ApplyAdamNShapeFn(InferenceContext* c) {
+  int n;
+  TF_RETURN_IF_ERROR(c->GetAttr("N", &n));
+  ShapeHandle unused;
+  for (int i = 0; i < 6; ++i) {  // beta1_power..epsilon
+    TF_RETURN_IF_ERROR(c->WithRank(c->input(3 * n + i), 0, &unused));
+  }
+  for (int i = 0; i < n; ++i) {
+    ShapeHandle s = ShapeOrHandleShape(c, i);                           // var
+    TF_RETURN_IF_ERROR(c->Merge(s, ShapeOrHandleShape(c, n + i), &s));  // m
+    TF_RETURN_IF_ERROR(
+        c->Merge(s, ShapeOrHandleShape(c, 2 * n + i), &s));  // v
+    TF_RETURN_IF_ERROR(
+        c->Merge(s, c->input(3 * n + 6 + i), &s));  // grad
+  }
+  return Status::OK();
+}
+
+// Fused variant of ResourceApplyAdam produced by the multi-tensor Adam
+// fusion pass; not intended to be constructed directly by users.
+REGISTER_OP("ResourceApplyAdamN")
+    .Input("var: N * resource")
+    .Input("m: N * resource")
+    .Input("v: N * resource")
+    .Input("beta1_power: T")
+    .Input("beta2_power: T")
+    .Input("lr: T")
+    .Input("beta1: T")
+    .Input("beta2: T")
+    .Input("epsilon: T")
+    .Input("grad: N * T")
+    .Attr("N: int >= 1")
+    .Attr("T: numbertype")
+    .Attr("use_locking: bool = false")
+    .Attr("use_nesterov: bool = false")
+    .SetShapeFn(ApplyAdamNShapeFn);
+
 static Status ApplyAdamWithAmsgradShapeFn(InferenceContext* c, bool sparse) {
   ShapeHandle unused;
   ShapeHandle s = ShapeOrHandleShape(c, 0);                       // var
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include <algorithm>
+#include <atomic>
 
 #include "tensorflow/core/platform/cloud/curl_http_request.h"
 
@@ -443,6 +444,22 @@ Status CurlHttpRequest::Send() {
   CHECK_CURL_OK(libcurl_->curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE,
                                             &response_code_));
 
+  // Connection reuse accounting. libcurl reports how many connections this
+  // request had to open; anything above zero means its connection cache
+  // missed, costing an extra TCP+TLS handshake on the critical path.
+  uint64 num_connects = 0;
+  CHECK_CURL_OK(libcurl_->curl_easy_getinfo(curl_, CURLINFO_NUM_CONNECTS,
+                                            &num_connects));
+  static std::atomic<uint64> total_requests(0);
+  static std::atomic<uint64> total_new_connections(0);
+  const uint64 requests = total_requests.fetch_add(1) + 1;
+  const uint64 new_connections =
+      total_new_connections.fetch_add(num_connects) + num_connects;
+  if (requests % 100 == 0) {
+    VLOG(1) << "HTTP connection reuse: " << new_connections
+            << " connections opened over " << requests << " requests";
+  }
+
   auto get_error_message = [this]() -> string {
     string error_message = strings::StrCat(
         "Error executing an HTTP request: HTTP response code ", response_code_);
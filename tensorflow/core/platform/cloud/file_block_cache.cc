@@ -0,0 +1,54 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/cloud/file_block_cache.h"
+
+#include "tensorflow/core/platform/logging.h"
+
+namespace tensorflow {
+namespace {
+
+struct RegistryState {
+  mutex mu;
+  std::map<string, FileBlockCacheRegistry::Factory> factories GUARDED_BY(mu);
+};
+
+RegistryState* GetRegistryState() {
+  static RegistryState* state = new RegistryState;
+  return state;
+}
+
+}  // namespace
+
+void FileBlockCacheRegistry::Register(const string& name, Factory factory) {
+  RegistryState* state = GetRegistryState();
+  mutex_lock l(state->mu);
+  CHECK(state->factories.emplace(name, std::move(factory)).second)
+      << "A file block cache factory is already registered under '" << name
+      << "'";
+}
+
+FileBlockCacheRegistry::Factory FileBlockCacheRegistry::Lookup(
+    const string& name) {
+  RegistryState* state = GetRegistryState();
+  mutex_lock l(state->mu);
+  auto it = state->factories.find(name);
+  if (it == state->factories.end()) {
+    return Factory();
+  }
+  return it->second;
+}
+
+}  // namespace tensorflow
@@ -93,6 +93,31 @@ class FileBlockCache {
   virtual bool IsCacheEnabled() const = 0;
 };
 
+/// \brief A registry of external FileBlockCache implementations, keyed by name.
+///
+/// An alternative block cache backend (e.g. a client for a shared-memory
+/// segment or a local cache daemon, through which several processes on one
+/// host share cached blocks in a single copy) can register a factory here from
+/// a static initializer, and users select it by name; GcsFileSystem does so
+/// via the GCS_EXTERNAL_BLOCK_CACHE environment variable. The factory receives
+/// the same parameters as the built-in RAM cache; in a shared backend,
+/// `max_bytes` acts as the per-process quota.
+class FileBlockCacheRegistry {
+ public:
+  typedef std::function<std::unique_ptr<FileBlockCache>(
+      size_t block_size, size_t max_bytes, uint64 max_staleness,
+      FileBlockCache::BlockFetcher block_fetcher)>
+      Factory;
+
+  /// Register `factory` under `name`. Dies with a CHECK failure if a factory
+  /// is already registered under the same name.
+  static void Register(const string& name, Factory factory);
+
+  /// Return the factory registered under `name`, or an empty function if no
+  /// factory is registered under that name.
+  static Factory Lookup(const string& name);
+};
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_PLATFORM_CLOUD_FILE_BLOCK_CACHE_H_
@@ -0,0 +1,98 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/platform/cloud/file_block_cache.h"
+#include <cstring>
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+// A minimal FileBlockCache that records its construction parameters and
+// forwards reads to the fetcher.
+class TestBlockCache : public FileBlockCache {
+ public:
+  TestBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
+                 BlockFetcher block_fetcher)
+      : block_size_(block_size),
+        max_bytes_(max_bytes),
+        max_staleness_(max_staleness),
+        block_fetcher_(block_fetcher) {}
+
+  Status Read(const string& filename, size_t offset, size_t n, char* buffer,
+              size_t* bytes_transferred) override {
+    return block_fetcher_(filename, offset, n, buffer, bytes_transferred);
+  }
+
+  bool ValidateAndUpdateFileSignature(const string& filename,
+                                      int64 file_signature) override {
+    return true;
+  }
+
+  void RemoveFile(const string& filename) override {}
+
+  void Flush() override {}
+
+  size_t block_size() const override { return block_size_; }
+  size_t max_bytes() const override { return max_bytes_; }
+  uint64 max_staleness() const override { return max_staleness_; }
+  size_t CacheSize() const override { return 0; }
+  bool IsCacheEnabled() const override { return true; }
+
+ private:
+  const size_t block_size_;
+  const size_t max_bytes_;
+  const uint64 max_staleness_;
+  const BlockFetcher block_fetcher_;
+};
+
+TEST(FileBlockCacheRegistryTest, RegisterAndLookup) {
+  EXPECT_FALSE(FileBlockCacheRegistry::Lookup("not-registered"));
+
+  FileBlockCacheRegistry::Register(
+      "test", [](size_t block_size, size_t max_bytes, uint64 max_staleness,
+                 FileBlockCache::BlockFetcher block_fetcher) {
+        return std::unique_ptr<FileBlockCache>(new TestBlockCache(
+            block_size, max_bytes, max_staleness, block_fetcher));
+      });
+
+  FileBlockCacheRegistry::Factory factory =
+      FileBlockCacheRegistry::Lookup("test");
+  ASSERT_TRUE(static_cast<bool>(factory));
+
+  int calls = 0;
+  auto fetcher = [&calls](const string& filename, size_t offset, size_t n,
+                          char* buffer, size_t* bytes_transferred) {
+    calls++;
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return Status::OK();
+  };
+  std::unique_ptr<FileBlockCache> cache = factory(16, 32, 5, fetcher);
+  EXPECT_EQ(cache->block_size(), 16);
+  EXPECT_EQ(cache->max_bytes(), 32);
+  EXPECT_EQ(cache->max_staleness(), 5);
+
+  std::vector<char> out(8, 0);
+  size_t bytes_transferred = 0;
+  TF_EXPECT_OK(cache->Read("file", 0, out.size(), out.data(),
+                           &bytes_transferred));
+  EXPECT_EQ(bytes_transferred, 8);
+  EXPECT_EQ(calls, 1);
+}
+
+}  // namespace
+}  // namespace tensorflow
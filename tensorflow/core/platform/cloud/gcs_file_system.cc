@@ -83,6 +83,16 @@ constexpr size_t kDefaultMaxCacheSize = kDefaultBlockSize;
 // will be evicted on the next read.
 constexpr char kMaxStaleness[] = "GCS_READ_CACHE_MAX_STALENESS";
 constexpr uint64 kDefaultMaxStaleness = 0;
+// The environment variable that enables parallel block downloads and
+// readahead in the block cache, and bounds the readahead depth (in blocks).
+// A value of 0 (the default) fetches blocks one at a time, on demand.
+constexpr char kMaxReadaheadBlocks[] = "GCS_READ_CACHE_MAX_READAHEAD_BLOCKS";
+constexpr size_t kDefaultMaxReadaheadBlocks = 0;
+// The environment variable that selects an external block cache backend
+// registered with FileBlockCacheRegistry (e.g. a client for a cache shared by
+// the processes on one host) by name. When unset, or when no backend is
+// registered under the name, the per-process RAM cache is used.
+constexpr char kExternalBlockCache[] = "GCS_EXTERNAL_BLOCK_CACHE";
 // The environment variable that overrides the maximum age of entries in the
 // Stat cache. A value of 0 (the default) means nothing is cached.
 constexpr char kStatCacheMaxAge[] = "GCS_STAT_CACHE_MAX_AGE";
@@ -657,6 +667,7 @@ GcsFileSystem::GcsFileSystem() {
   size_t block_size = kDefaultBlockSize;
   size_t max_bytes = kDefaultMaxCacheSize;
   uint64 max_staleness = kDefaultMaxStaleness;
+  max_readahead_blocks_ = kDefaultMaxReadaheadBlocks;
 
   http_request_factory_ = std::make_shared<CurlHttpRequest::Factory>();
   compute_engine_metadata_client_ =
@@ -681,13 +692,17 @@ GcsFileSystem::GcsFileSystem() {
   if (GetEnvVar(kMaxStaleness, strings::safe_strtou64, &value)) {
     max_staleness = value;
   }
+  if (GetEnvVar(kMaxReadaheadBlocks, strings::safe_strtou64, &value)) {
+    max_readahead_blocks_ = value;
+  }
   if (std::getenv(kReadCacheDisabled)) {
     // Setting either to 0 disables the cache; set both for good measure.
     block_size = max_bytes = 0;
   }
   VLOG(1) << "GCS cache max size = " << max_bytes << " ; "
           << "block size = " << block_size << " ; "
-          << "max staleness = " << max_staleness;
+          << "max staleness = " << max_staleness << " ; "
+          << "max readahead blocks = " << max_readahead_blocks_;
   file_block_cache_ = MakeFileBlockCache(block_size, max_bytes, max_staleness);
   // Apply overrides for the stat cache max age and max entries, if provided.
   uint64 stat_cache_max_age = kStatCacheDefaultMaxAge;
@@ -880,13 +895,26 @@ void GcsFileSystem::ResetFileBlockCache(size_t block_size_bytes,
 // A helper function to build a FileBlockCache for GcsFileSystem.
 std::unique_ptr<FileBlockCache> GcsFileSystem::MakeFileBlockCache(
     size_t block_size, size_t max_bytes, uint64 max_staleness) {
-  std::unique_ptr<FileBlockCache> file_block_cache(new RamFileBlockCache(
-      block_size, max_bytes, max_staleness,
+  FileBlockCache::BlockFetcher fetcher =
       [this](const string& filename, size_t offset, size_t n, char* buffer,
              size_t* bytes_transferred) {
         return LoadBufferFromGCS(filename, offset, n, buffer,
                                  bytes_transferred);
-      }));
+      };
+  StringPiece cache_name;
+  if (GetEnvVar(kExternalBlockCache, StringPieceIdentity, &cache_name)) {
+    FileBlockCacheRegistry::Factory factory =
+        FileBlockCacheRegistry::Lookup(string(cache_name));
+    if (factory) {
+      VLOG(1) << "Using external GCS block cache '" << cache_name << "'";
+      return factory(block_size, max_bytes, max_staleness, fetcher);
+    }
+    LOG(WARNING) << "No file block cache is registered under '" << cache_name
+                 << "'; using the per-process RAM cache instead.";
+  }
+  std::unique_ptr<FileBlockCache> file_block_cache(
+      new RamFileBlockCache(block_size, max_bytes, max_staleness, fetcher,
+                            Env::Default(), max_readahead_blocks_));
   return file_block_cache;
 }
 
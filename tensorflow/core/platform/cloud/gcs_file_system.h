@@ -308,6 +308,10 @@ class GcsFileSystem : public FileSystem {
   std::unique_ptr<AuthProvider> auth_provider_ GUARDED_BY(mu_);
   std::shared_ptr<HttpRequest::Factory> http_request_factory_;
   std::unique_ptr<ZoneProvider> zone_provider_;
+  // The maximum readahead depth (in blocks) of the file block cache. A value
+  // of 0 disables parallel block downloads and readahead. Must be declared
+  // before file_block_cache_, whose construction reads it.
+  size_t max_readahead_blocks_ = 0;
   // block_cache_lock_ protects the file_block_cache_ pointer (Note that
   // FileBlockCache instances are themselves threadsafe).
   mutex block_cache_lock_;
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/platform/cloud/ram_file_block_cache.h"
+#include <algorithm>
 #include <cstring>
 #include <memory>
 #include "tensorflow/core/lib/gtl/cleanup.h"
@@ -84,7 +85,17 @@ Status RamFileBlockCache::UpdateLRU(const Key& key,
     Key fmax = std::make_pair(key.first, std::numeric_limits<size_t>::max());
     auto fcmp = block_map_.upper_bound(fmax);
     if (fcmp != block_map_.begin() && key < (--fcmp)->first) {
-      return errors::Internal("Block cache contents are inconsistent.");
+      // Only report an inconsistency if the later block holds actual data. A
+      // block that is still being fetched, or that was fetched empty because
+      // it lies entirely past the end of the file, may be legitimately in the
+      // map while a partial block exists at a lower offset (e.g. when blocks
+      // near EOF are fetched concurrently); empty blocks are dropped from the
+      // map once their fetch completes (see MaybeFetch).
+      mutex_lock fl(fcmp->second->mu);
+      if (fcmp->second->state == FetchState::FINISHED &&
+          !fcmp->second->data.empty()) {
+        return errors::Internal("Block cache contents are inconsistent.");
+      }
     }
   }
 
@@ -104,12 +115,20 @@ Status RamFileBlockCache::MaybeFetch(const Key& key,
           mutex_lock l(mu_);
           // Do not update state if the block is already to be evicted.
           if (block->timestamp != 0) {
-            cache_size_ += block->data.size();
-            // Put to beginning of LRA list.
-            lra_list_.erase(block->lra_iterator);
-            lra_list_.push_front(key);
-            block->lra_iterator = lra_list_.begin();
-            block->timestamp = env_->NowSeconds();
+            if (block->data.empty()) {
+              // The block is entirely past the end of the file. Caching it
+              // would make a partial block at a lower offset look
+              // inconsistent (see UpdateLRU), which can happen when blocks
+              // near EOF are fetched concurrently, so drop it instead.
+              RemoveBlock(block_map_.find(key));
+            } else {
+              cache_size_ += block->data.size();
+              // Put to beginning of LRA list.
+              lra_list_.erase(block->lra_iterator);
+              lra_list_.push_front(key);
+              block->lra_iterator = lra_list_.begin();
+              block->timestamp = env_->NowSeconds();
+            }
           }
         }
       });
@@ -155,6 +174,61 @@ Status RamFileBlockCache::MaybeFetch(const Key& key,
       "Control flow should never reach the end of RamFileBlockCache::Fetch.");
 }
 
+void RamFileBlockCache::MaybeSchedulePrefetch(const string& filename,
+                                              size_t offset, size_t n,
+                                              size_t start, size_t finish) {
+  if (max_readahead_blocks_ == 0) {
+    return;
+  }
+  size_t limit = finish;
+  {
+    mutex_lock lock(mu_);
+    ReadaheadState& state = readahead_state_[filename];
+    if (offset == state.next_offset) {
+      // The read continues a sequential pattern; ramp up the readahead depth.
+      state.depth = std::min(std::max<size_t>(state.depth * 2, 1),
+                             max_readahead_blocks_);
+    } else {
+      // The pattern is broken (e.g. a random access); stop reading ahead
+      // until the reader proves sequential again.
+      state.depth = 0;
+    }
+    state.next_offset = offset + n;
+    limit = finish + state.depth * block_size_;
+  }
+  // The caller fetches the block at `start` itself; fetch the rest of the
+  // blocks of the read, and the readahead window beyond it, concurrently.
+  for (size_t pos = start + block_size_; pos < limit; pos += block_size_) {
+    FetchAsync(filename, pos);
+  }
+}
+
+void RamFileBlockCache::FetchAsync(const string& filename, size_t pos) {
+  const Key key = std::make_pair(filename, pos);
+  {
+    mutex_lock lock(mu_);
+    if (prefetches_in_flight_ >= max_readahead_blocks_) {
+      return;
+    }
+    if (block_map_.find(key) != block_map_.end()) {
+      // The block is already cached or being fetched.
+      return;
+    }
+    prefetches_in_flight_++;
+  }
+  env_->SchedClosure([this, key] {
+    std::shared_ptr<Block> block = Lookup(key);
+    if (MaybeFetch(key, block).ok()) {
+      // Errors are ignored here; the block is left in the ERROR state, and
+      // the reader that consumes it will re-fetch it and surface the error.
+      UpdateLRU(key, block).IgnoreError();
+    }
+    mutex_lock lock(mu_);
+    prefetches_in_flight_--;
+    prefetch_cond_var_.notify_all();
+  });
+}
+
 Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
                                char* buffer, size_t* bytes_transferred) {
   *bytes_transferred = 0;
@@ -173,6 +247,7 @@ Status RamFileBlockCache::Read(const string& filename, size_t offset, size_t n,
     finish += block_size_;
   }
   size_t total_bytes_transferred = 0;
+  MaybeSchedulePrefetch(filename, offset, n, start, finish);
   // Now iterate through the blocks, reading them one at a time.
   for (size_t pos = start; pos < finish; pos += block_size_) {
     Key key = std::make_pair(filename, pos);
@@ -261,6 +336,7 @@ void RamFileBlockCache::Flush() {
   block_map_.clear();
   lru_list_.clear();
   lra_list_.clear();
+  readahead_state_.clear();
   cache_size_ = 0;
 }
 
@@ -277,6 +353,7 @@ void RamFileBlockCache::RemoveFile_Locked(const string& filename) {
     RemoveBlock(it);
     it = next;
   }
+  readahead_state_.erase(filename);
 }
 
 void RamFileBlockCache::RemoveBlock(BlockMap::iterator entry) {
@@ -49,11 +49,18 @@ class RamFileBlockCache : public FileBlockCache {
                                size_t* bytes_transferred)>
       BlockFetcher;
 
+  /// If `max_readahead_blocks` is greater than zero, blocks of multi-block
+  /// reads are fetched concurrently, and sequential readers additionally
+  /// trigger asynchronous readahead of up to `max_readahead_blocks` blocks
+  /// past the requested range. At most `max_readahead_blocks` asynchronous
+  /// fetches are in flight at any time.
   RamFileBlockCache(size_t block_size, size_t max_bytes, uint64 max_staleness,
-                    BlockFetcher block_fetcher, Env* env = Env::Default())
+                    BlockFetcher block_fetcher, Env* env = Env::Default(),
+                    size_t max_readahead_blocks = 0)
       : block_size_(block_size),
         max_bytes_(max_bytes),
         max_staleness_(max_staleness),
+        max_readahead_blocks_(max_readahead_blocks),
         block_fetcher_(block_fetcher),
         env_(env) {
     if (max_staleness_ > 0) {
@@ -65,6 +72,13 @@ class RamFileBlockCache : public FileBlockCache {
   }
 
   ~RamFileBlockCache() override {
+    {
+      // Wait for asynchronous block fetches, which capture `this`.
+      mutex_lock lock(mu_);
+      while (prefetches_in_flight_ > 0) {
+        prefetch_cond_var_.wait(lock);
+      }
+    }
     if (pruning_thread_) {
       stop_pruning_thread_.Notify();
       // Destroying pruning_thread_ will block until Prune() receives the above
@@ -126,6 +140,9 @@ class RamFileBlockCache : public FileBlockCache {
   const size_t max_bytes_;
   /// The maximum staleness of any block in the LRU cache, in seconds.
   const uint64 max_staleness_;
+  /// The maximum readahead depth, in blocks. Zero disables both concurrent
+  /// block fetches and readahead.
+  const size_t max_readahead_blocks_;
   /// The callback to read a block from the underlying filesystem.
   const BlockFetcher block_fetcher_;
   /// The Env from which we read timestamps.
@@ -199,6 +216,22 @@ class RamFileBlockCache : public FileBlockCache {
   Status MaybeFetch(const Key& key, const std::shared_ptr<Block>& block)
       LOCKS_EXCLUDED(mu_);
 
+  /// \brief Schedule asynchronous fetches around the read `[offset, offset+n)`.
+  ///
+  /// Fetches the blocks of the read beyond the first one concurrently with the
+  /// caller, which picks up their results in its own block loop. If the read
+  /// continues a sequential access pattern, also fetches up to the current
+  /// readahead depth of blocks past the end of the read; the depth doubles on
+  /// every sequential read up to `max_readahead_blocks_` and resets when the
+  /// pattern is broken. `start` and `finish` are the block-aligned bounds of
+  /// the read. No-op unless `max_readahead_blocks_` is greater than zero.
+  void MaybeSchedulePrefetch(const string& filename, size_t offset, size_t n,
+                             size_t start, size_t finish) LOCKS_EXCLUDED(mu_);
+
+  /// Fetch the block at `filename`/`pos` asynchronously, unless it is already
+  /// cached or too many asynchronous fetches are in flight.
+  void FetchAsync(const string& filename, size_t pos) LOCKS_EXCLUDED(mu_);
+
   /// Trim the block cache to make room for another entry.
   void Trim() EXCLUSIVE_LOCKS_REQUIRED(mu_);
 
@@ -241,6 +274,24 @@ class RamFileBlockCache : public FileBlockCache {
 
   // A filename->file_signature map.
   std::map<string, int64> file_signature_map_ GUARDED_BY(mu_);
+
+  /// \brief Per-file sequential access tracking for readahead.
+  ///
+  /// `next_offset` is where a sequential reader of the file would read next,
+  /// and `depth` is the current readahead depth in blocks.
+  struct ReadaheadState {
+    size_t next_offset = 0;
+    size_t depth = 0;
+  };
+
+  /// A filename->readahead state map.
+  std::map<string, ReadaheadState> readahead_state_ GUARDED_BY(mu_);
+
+  /// The number of asynchronous block fetches currently in flight.
+  size_t prefetches_in_flight_ GUARDED_BY(mu_) = 0;
+
+  /// Signaled whenever `prefetches_in_flight_` is decremented.
+  condition_variable prefetch_cond_var_;
 };
 
 }  // namespace tensorflow
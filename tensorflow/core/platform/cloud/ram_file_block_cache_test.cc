@@ -14,11 +14,14 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/core/platform/cloud/ram_file_block_cache.h"
+#include <algorithm>
 #include <cstring>
+#include <set>
 #include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
 #include "tensorflow/core/platform/cloud/now_seconds_env.h"
 #include "tensorflow/core/platform/env.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/notification.h"
 #include "tensorflow/core/platform/test.h"
 
@@ -541,6 +544,121 @@ TEST(RamFileBlockCacheTest, CoalesceConcurrentReads) {
   EXPECT_EQ(1, num_requests);
 }
 
+TEST(RamFileBlockCacheTest, ParallelBlockFetches) {
+  // With readahead enabled, the blocks of a multi-block read are fetched
+  // concurrently, and the read still assembles them in order.
+  const size_t block_size = 8;
+  mutex mu;
+  std::vector<size_t> fetched;
+  auto fetcher = [&mu, &fetched, block_size](
+                     const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    EXPECT_EQ(n, block_size);
+    EXPECT_EQ(offset % block_size, 0);
+    {
+      mutex_lock l(mu);
+      fetched.push_back(offset);
+    }
+    // Encode the block offset in the block contents, so the test can verify
+    // that concurrently fetched blocks land in the right places.
+    memset(buffer, 'a' + offset / block_size, n);
+    *bytes_transferred = n;
+    return Status::OK();
+  };
+  RamFileBlockCache cache(block_size, 8 * block_size, 0, fetcher,
+                          Env::Default(), /* max_readahead_blocks = */ 4);
+  std::vector<char> out;
+  // Read at a nonzero offset, so that the read does not look sequential and
+  // only the blocks of the read itself are fetched.
+  TF_EXPECT_OK(ReadCache(&cache, "", block_size, 4 * block_size, &out));
+  std::vector<char> want;
+  for (size_t i = 1; i <= 4; i++) {
+    want.insert(want.end(), block_size, 'a' + i);
+  }
+  EXPECT_EQ(out, want);
+  mutex_lock l(mu);
+  EXPECT_EQ(fetched.size(), 4);
+}
+
+TEST(RamFileBlockCacheTest, Readahead) {
+  // Sequential reads should trigger asynchronous fetches of blocks past the
+  // end of the read, and a random access should stop the readahead.
+  const size_t block_size = 8;
+  mutex mu;
+  std::set<size_t> fetched;
+  auto fetcher = [&mu, &fetched, block_size](
+                     const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    EXPECT_EQ(n, block_size);
+    EXPECT_EQ(offset % block_size, 0);
+    {
+      mutex_lock l(mu);
+      fetched.insert(offset);
+    }
+    memset(buffer, 'x', n);
+    *bytes_transferred = n;
+    return Status::OK();
+  };
+  {
+    RamFileBlockCache cache(block_size, 32 * block_size, 0, fetcher,
+                            Env::Default(), /* max_readahead_blocks = */ 4);
+    std::vector<char> out;
+    // Two sequential reads; the second ramps the readahead depth up to two
+    // blocks, so blocks at offsets 16 and 24 are fetched without being read.
+    TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+    TF_EXPECT_OK(ReadCache(&cache, "", block_size, block_size, &out));
+    // A random access resets the readahead depth; no blocks past it are
+    // fetched.
+    TF_EXPECT_OK(ReadCache(&cache, "", 12 * block_size, block_size, &out));
+    // The cache destructor waits for the asynchronous fetches to finish.
+  }
+  mutex_lock l(mu);
+  EXPECT_EQ(fetched, (std::set<size_t>{0, 8, 16, 24, 96}));
+}
+
+TEST(RamFileBlockCacheTest, ReadaheadPastEndOfFile) {
+  // Readahead past the end of the file must not poison the cache: an empty
+  // block fetched beyond EOF is dropped, so reading the partial block at the
+  // end of the file still succeeds.
+  const size_t block_size = 8;
+  const size_t file_size = 20;
+  mutex mu;
+  std::set<size_t> fetched;
+  auto fetcher = [&mu, &fetched, block_size, file_size](
+                     const string& filename, size_t offset, size_t n,
+                     char* buffer, size_t* bytes_transferred) {
+    EXPECT_EQ(n, block_size);
+    EXPECT_EQ(offset % block_size, 0);
+    {
+      mutex_lock l(mu);
+      fetched.insert(offset);
+    }
+    size_t bytes_to_copy =
+        offset < file_size ? std::min(n, file_size - offset) : 0;
+    memset(buffer, 'x', bytes_to_copy);
+    *bytes_transferred = bytes_to_copy;
+    return Status::OK();
+  };
+  RamFileBlockCache cache(block_size, 32 * block_size, 0, fetcher,
+                          Env::Default(), /* max_readahead_blocks = */ 4);
+  std::vector<char> out;
+  TF_EXPECT_OK(ReadCache(&cache, "", 0, block_size, &out));
+  TF_EXPECT_OK(ReadCache(&cache, "", block_size, block_size, &out));
+  // The second read triggers readahead of the partial block at offset 16 and
+  // the empty block at offset 24. Wait for both fetches to complete.
+  while (true) {
+    {
+      mutex_lock l(mu);
+      if (fetched.count(24) > 0) break;
+    }
+    Env::Default()->SleepForMicroseconds(1000);
+  }
+  // The partial block must still be readable, i.e. the empty block at offset
+  // 24 did not make the cache contents look inconsistent.
+  TF_EXPECT_OK(ReadCache(&cache, "", 2 * block_size, block_size, &out));
+  EXPECT_EQ(out.size(), file_size - 2 * block_size);
+}
+
 TEST(RamFileBlockCacheTest, Flush) {
   int calls = 0;
   auto fetcher = [&calls](const string& filename, size_t offset, size_t n,
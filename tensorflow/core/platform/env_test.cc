@@ -85,6 +85,42 @@ TEST_F(DefaultEnvTest, IncompleteReadOutOfRange) {
   EXPECT_EQ(input, result);
 }
 
+TEST_F(DefaultEnvTest, ReadBatch) {
+  const string filename = io::JoinPath(BaseDir(), "read_batch");
+  const string input = CreateTestFile(env_, filename, 16);
+  std::unique_ptr<RandomAccessFile> f;
+  TF_EXPECT_OK(env_->NewRandomAccessFile(filename, &f));
+
+  // Two contiguous regions (which a filesystem may coalesce into one
+  // read), a separated one, and one that runs past EOF.
+  char scratch[4][8];
+  std::vector<RandomAccessFile::ReadRequest> batch(4);
+  batch[0].offset = 0;
+  batch[0].n = 4;
+  batch[0].scratch = scratch[0];
+  batch[1].offset = 4;
+  batch[1].n = 4;
+  batch[1].scratch = scratch[1];
+  batch[2].offset = 12;
+  batch[2].n = 4;
+  batch[2].scratch = scratch[2];
+  batch[3].offset = 14;
+  batch[3].n = 8;
+  batch[3].scratch = scratch[3];
+
+  EXPECT_EQ(error::OUT_OF_RANGE, f->ReadBatch(&batch).code());
+  TF_EXPECT_OK(batch[0].status);
+  EXPECT_EQ(input.substr(0, 4), batch[0].result);
+  TF_EXPECT_OK(batch[1].status);
+  EXPECT_EQ(input.substr(4, 4), batch[1].result);
+  TF_EXPECT_OK(batch[2].status);
+  EXPECT_EQ(input.substr(12, 4), batch[2].result);
+  // The request past EOF reports OUT_OF_RANGE but still returns the
+  // available bytes, just like Read().
+  EXPECT_EQ(error::OUT_OF_RANGE, batch[3].status.code());
+  EXPECT_EQ(input.substr(14), batch[3].result);
+}
+
 TEST_F(DefaultEnvTest, ReadFileToString) {
   for (const int length : {0, 1, 1212, 2553, 4928, 8196, 9000, (1 << 20) - 1,
                            1 << 20, (1 << 20) + 1, (256 << 20) + 100}) {
@@ -51,6 +51,16 @@ void FileSystem::FlushCaches() {}
 
 RandomAccessFile::~RandomAccessFile() {}
 
+Status RandomAccessFile::ReadBatch(std::vector<ReadRequest>* batch) const {
+  Status overall;
+  for (ReadRequest& request : *batch) {
+    request.status =
+        Read(request.offset, request.n, &request.result, request.scratch);
+    overall.Update(request.status);
+  }
+  return overall;
+}
+
 WritableFile::~WritableFile() {}
 
 FileSystemRegistry::~FileSystemRegistry() {}
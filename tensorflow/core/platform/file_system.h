@@ -260,6 +260,35 @@ class RandomAccessFile {
   virtual Status Read(uint64 offset, size_t n, StringPiece* result,
                       char* scratch) const = 0;
 
+  /// \brief One region of the file to read in a `ReadBatch()` call.
+  ///
+  /// `offset`, `n` and `scratch` are filled in by the caller and have
+  /// the same meaning as the `Read()` arguments; `result` and `status`
+  /// are outputs with the same contract as `Read()`'s `*result` and
+  /// return value.
+  struct ReadRequest {
+    uint64 offset = 0;
+    size_t n = 0;
+    char* scratch = nullptr;
+    StringPiece result;
+    Status status;
+  };
+
+  /// \brief Reads several regions of the file in one call.
+  ///
+  /// All requests are attempted even if some of them fail; each
+  /// request's `status` reports its individual outcome and the returned
+  /// status is the first non-OK request status, if any.
+  ///
+  /// The default implementation issues one `Read()` per request.
+  /// Implementations may override it to submit the batch with fewer
+  /// syscalls (e.g. by coalescing reads of adjacent regions), which
+  /// callers can encourage by batching reads that are contiguous or
+  /// close together in the file.
+  ///
+  /// Safe for concurrent use by multiple threads.
+  virtual Status ReadBatch(std::vector<ReadRequest>* batch) const;
+
  private:
   TF_DISALLOW_COPY_AND_ASSIGN(RandomAccessFile);
 };
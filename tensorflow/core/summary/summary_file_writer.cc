@@ -14,6 +14,8 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/core/summary/summary_file_writer.h"
 
+#include <algorithm>
+
 #include "tensorflow/core/summary/summary_converter.h"
 #include "tensorflow/core/framework/graph.pb.h"
 #include "tensorflow/core/framework/op_kernel.h"
@@ -21,6 +23,7 @@ limitations under the License.
 #include "tensorflow/core/framework/summary.pb.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/lib/io/path.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/events_writer.h"
 #include "tensorflow/core/util/ptr_util.h"
 
@@ -29,11 +32,12 @@ namespace {
 
 class SummaryFileWriter : public SummaryWriterInterface {
  public:
-  SummaryFileWriter(int max_queue, int flush_millis, Env* env)
+  SummaryFileWriter(int max_queue, int flush_millis, Env* env, bool async)
       : SummaryWriterInterface(),
         is_initialized_(false),
         max_queue_(max_queue),
         flush_millis_(flush_millis),
+        async_(async),
         env_(env) {}
 
   Status Initialize(const string& logdir, const string& filename_suffix) {
@@ -52,6 +56,12 @@ class SummaryFileWriter : public SummaryWriterInterface {
         "Could not initialize events writer.");
     last_flush_ = env_->NowMicros();
     is_initialized_ = true;
+    if (async_) {
+      // The thread blocks on mu_ until initialization completes.
+      background_thread_.reset(
+          env_->StartThread(ThreadOptions(), "async_summary_writer",
+                            [this] { RunBackground(); }));
+    }
     return Status::OK();
   }
 
@@ -60,11 +70,41 @@ class SummaryFileWriter : public SummaryWriterInterface {
     if (!is_initialized_) {
       return errors::FailedPrecondition("Class was not properly initialized.");
     }
-    return InternalFlush();
+    if (!async_) {
+      return InternalFlush();
+    }
+    // Wait for the background thread to drain the queue and flush the events
+    // file, so that Flush() keeps its synchronous contract.
+    const int64 my_generation = ++flush_requested_;
+    work_cv_.notify_one();
+    while (flush_completed_ < my_generation) {
+      flush_cv_.wait(ml);
+    }
+    Status s = background_status_;
+    background_status_ = Status::OK();
+    return s;
   }
 
   ~SummaryFileWriter() override {
-    (void)Flush();  // Ignore errors.
+    if (async_) {
+      {
+        mutex_lock ml(mu_);
+        shutdown_ = true;
+        work_cv_.notify_one();
+      }
+      // Joins the background thread, which drains the queue and flushes the
+      // events file before exiting.
+      background_thread_.reset();
+      mutex_lock ml(mu_);
+      if (dropped_events_ > 0 || coalesced_events_ > 0) {
+        LOG(WARNING) << "The summary event queue was full " << dropped_events_
+                     << " times (and coalesced " << coalesced_events_
+                     << " repeated-tag events) because the background writer "
+                     << "could not keep up.";
+      }
+    } else {
+      (void)Flush();  // Ignore errors.
+    }
   }
 
   Status WriteTensor(int64 global_step, Tensor t, const string& tag,
@@ -140,11 +180,33 @@ class SummaryFileWriter : public SummaryWriterInterface {
 
   Status WriteEvent(std::unique_ptr<Event> event) override {
     mutex_lock ml(mu_);
-    queue_.emplace_back(std::move(event));
-    if (queue_.size() > max_queue_ ||
-        env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
-      return InternalFlush();
+    if (!async_) {
+      queue_.emplace_back(std::move(event));
+      if (queue_.size() > max_queue_ ||
+          env_->NowMicros() - last_flush_ > 1000 * flush_millis_) {
+        return InternalFlush();
+      }
+      return Status::OK();
     }
+    if (!background_status_.ok()) {
+      // Surface an error from an earlier background flush to the caller.
+      Status s = background_status_;
+      background_status_ = Status::OK();
+      return s;
+    }
+    const size_t cap = static_cast<size_t>(std::max(max_queue_, 1));
+    if (queue_.size() >= cap && !CoalesceLocked(*event)) {
+      // The background writer cannot keep up. Drop the event rather than
+      // stalling the step that recorded it, and account for the loss.
+      dropped_events_++;
+      if (dropped_events_ == 1 || dropped_events_ % 1000 == 0) {
+        LOG(WARNING) << "The summary event queue is full; dropped "
+                     << dropped_events_ << " events so far.";
+      }
+      return Status::OK();
+    }
+    queue_.emplace_back(std::move(event));
+    work_cv_.notify_one();
     return Status::OK();
   }
 
@@ -166,26 +228,121 @@ class SummaryFileWriter : public SummaryWriterInterface {
     return Status::OK();
   }
 
+  /// \brief Drop the oldest queued event that carries the same tags as
+  /// `incoming`, keeping the newest data point for those tags.
+  ///
+  /// Only called under backpressure, so that during normal operation every
+  /// data point is kept. Returns true if a queue slot was freed.
+  bool CoalesceLocked(const Event& incoming) EXCLUSIVE_LOCKS_REQUIRED(mu_) {
+    if (incoming.summary().value_size() == 0) {
+      return false;
+    }
+    for (auto it = queue_.begin(); it != queue_.end(); ++it) {
+      const Summary& queued = (*it)->summary();
+      if (queued.value_size() != incoming.summary().value_size()) {
+        continue;
+      }
+      bool same_tags = true;
+      for (int i = 0; i < queued.value_size(); i++) {
+        if (queued.value(i).tag() != incoming.summary().value(i).tag()) {
+          same_tags = false;
+          break;
+        }
+      }
+      if (same_tags) {
+        queue_.erase(it);
+        coalesced_events_++;
+        return true;
+      }
+    }
+    return false;
+  }
+
+  /// The loop run by the background thread in async mode. It drains the queue
+  /// whenever events are enqueued, and flushes the events file when the flush
+  /// interval has elapsed, a Flush() call is pending, or the writer is being
+  /// destroyed. The events file is written with mu_ released, so writers only
+  /// ever block on the queue operations themselves.
+  void RunBackground() {
+    mutex_lock ml(mu_);
+    while (true) {
+      if (!shutdown_ && queue_.empty() &&
+          flush_completed_ >= flush_requested_) {
+        work_cv_.wait_for(
+            ml, std::chrono::milliseconds(std::max(flush_millis_, 1)));
+      }
+      const bool exiting = shutdown_;
+      const int64 flush_goal = flush_requested_;
+      const bool flush_file =
+          exiting || flush_goal > flush_completed_ ||
+          env_->NowMicros() - last_flush_ > 1000 * flush_millis_;
+      std::vector<std::unique_ptr<Event>> events;
+      events.swap(queue_);
+      mu_.unlock();  // Release the lock while doing file I/O.
+      for (const std::unique_ptr<Event>& e : events) {
+        events_writer_->WriteEvent(*e);
+      }
+      Status s;
+      if (flush_file) {
+        s = events_writer_->Flush();
+        if (!s.ok()) {
+          errors::AppendToMessage(&s, "Could not flush events file.");
+        }
+      }
+      mu_.lock();
+      if (flush_file) {
+        last_flush_ = env_->NowMicros();
+        if (!s.ok() && background_status_.ok()) {
+          background_status_ = s;
+        }
+        flush_completed_ = flush_goal;
+        flush_cv_.notify_all();
+      }
+      if (exiting && queue_.empty()) {
+        return;
+      }
+    }
+  }
+
   bool is_initialized_;
   const int max_queue_;
   const int flush_millis_;
+  const bool async_;
   uint64 last_flush_;
   Env* env_;
   mutex mu_;
   std::vector<std::unique_ptr<Event>> queue_ GUARDED_BY(mu_);
-  // A pointer to allow deferred construction.
-  std::unique_ptr<EventsWriter> events_writer_ GUARDED_BY(mu_);
+  // A pointer to allow deferred construction. In async mode, only the
+  // background thread may use this after initialization; in sync mode it is
+  // used under mu_.
+  std::unique_ptr<EventsWriter> events_writer_;
   std::vector<std::pair<string, SummaryMetadata>> registered_summaries_
       GUARDED_BY(mu_);
+  // Async mode state. The background thread drains queue_ and flushes the
+  // events file; Flush() waits until the flush generation it requested has
+  // completed.
+  std::unique_ptr<Thread> background_thread_;
+  bool shutdown_ GUARDED_BY(mu_) = false;
+  int64 flush_requested_ GUARDED_BY(mu_) = 0;
+  int64 flush_completed_ GUARDED_BY(mu_) = 0;
+  int64 dropped_events_ GUARDED_BY(mu_) = 0;
+  int64 coalesced_events_ GUARDED_BY(mu_) = 0;
+  Status background_status_ GUARDED_BY(mu_);
+  condition_variable work_cv_;
+  condition_variable flush_cv_;
 };
 
 }  // namespace
 
-Status CreateSummaryFileWriter(int max_queue, int flush_millis,
-                               const string& logdir,
-                               const string& filename_suffix, Env* env,
-                               SummaryWriterInterface** result) {
-  SummaryFileWriter* w = new SummaryFileWriter(max_queue, flush_millis, env);
+namespace {
+
+Status CreateSummaryFileWriterInternal(int max_queue, int flush_millis,
+                                       const string& logdir,
+                                       const string& filename_suffix, Env* env,
+                                       bool async,
+                                       SummaryWriterInterface** result) {
+  SummaryFileWriter* w =
+      new SummaryFileWriter(max_queue, flush_millis, env, async);
   const Status s = w->Initialize(logdir, filename_suffix);
   if (!s.ok()) {
     w->Unref();
@@ -196,4 +353,29 @@ Status CreateSummaryFileWriter(int max_queue, int flush_millis,
   return Status::OK();
 }
 
+}  // namespace
+
+Status CreateSummaryFileWriter(int max_queue, int flush_millis,
+                               const string& logdir,
+                               const string& filename_suffix, Env* env,
+                               SummaryWriterInterface** result) {
+  static const bool async = [] {
+    bool enabled = false;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_SUMMARY_ASYNC_WRITES",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return CreateSummaryFileWriterInternal(max_queue, flush_millis, logdir,
+                                         filename_suffix, env, async, result);
+}
+
+Status CreateAsyncSummaryFileWriter(int max_queue, int flush_millis,
+                                    const string& logdir,
+                                    const string& filename_suffix, Env* env,
+                                    SummaryWriterInterface** result) {
+  return CreateSummaryFileWriterInternal(max_queue, flush_millis, logdir,
+                                         filename_suffix, env, /*async=*/true,
+                                         result);
+}
+
 }  // namespace tensorflow
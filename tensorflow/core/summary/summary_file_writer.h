@@ -33,11 +33,25 @@ namespace tensorflow {
 /// filename_suffix. The caller owns a reference to result if the
 /// returned status is ok. The Env object must not be destroyed until
 /// after the returned writer.
+/// The writer normally writes and flushes events on the calling thread. When
+/// the TF_SUMMARY_ASYNC_WRITES environment variable is set to true, writes
+/// enqueue onto a bounded queue drained by a background thread, so heavy
+/// summaries (e.g. images and histograms) do not stall the step that records
+/// them. Under backpressure, repeated-tag events are coalesced and further
+/// events are dropped with accounting. Flush() still blocks until everything
+/// enqueued before it is on disk.
 Status CreateSummaryFileWriter(int max_queue, int flush_millis,
                                const string& logdir,
                                const string& filename_suffix, Env* env,
                                SummaryWriterInterface** result);
 
+/// \brief Like CreateSummaryFileWriter, but always writes asynchronously,
+/// regardless of TF_SUMMARY_ASYNC_WRITES.
+Status CreateAsyncSummaryFileWriter(int max_queue, int flush_millis,
+                                    const string& logdir,
+                                    const string& filename_suffix, Env* env,
+                                    SummaryWriterInterface** result);
+
 }  // namespace tensorflow
 
 #endif  // TENSORFLOW_CORE_SUMMARY_SUMMARY_FILE_WRITER_H_
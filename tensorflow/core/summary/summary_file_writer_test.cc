@@ -44,13 +44,18 @@ class SummaryFileWriterTest : public ::testing::Test {
   Status SummaryTestHelper(
       const string& test_name,
       const std::function<Status(SummaryWriterInterface*)>& writer_fn,
-      const std::function<void(const Event&)>& test_fn) {
+      const std::function<void(const Event&)>& test_fn, bool async = false) {
     static std::set<string>* tests = new std::set<string>();
     CHECK(tests->insert(test_name).second) << ": " << test_name;
 
     SummaryWriterInterface* writer;
-    TF_CHECK_OK(CreateSummaryFileWriter(1, 1, testing::TmpDir(), test_name,
-                                        &env_, &writer));
+    if (async) {
+      TF_CHECK_OK(CreateAsyncSummaryFileWriter(1, 1, testing::TmpDir(),
+                                               test_name, &env_, &writer));
+    } else {
+      TF_CHECK_OK(CreateSummaryFileWriter(1, 1, testing::TmpDir(), test_name,
+                                          &env_, &writer));
+    }
     core::ScopedUnref deleter(writer);
 
     TF_CHECK_OK(writer_fn(writer));
@@ -217,6 +222,46 @@ TEST_F(SummaryFileWriterTest, WriteEvent) {
                         }));
 }
 
+TEST_F(SummaryFileWriterTest, AsyncWriteScalar) {
+  TF_CHECK_OK(SummaryTestHelper(
+      "scalar_async_test",
+      [](SummaryWriterInterface* writer) {
+        Tensor one(DT_FLOAT, TensorShape({}));
+        one.scalar<float>()() = 1.0;
+        TF_RETURN_IF_ERROR(writer->WriteScalar(2, one, "name"));
+        // Flush() must block until the background thread has written the
+        // event to disk.
+        TF_RETURN_IF_ERROR(writer->Flush());
+        return Status::OK();
+      },
+      [](const Event& e) {
+        EXPECT_EQ(e.step(), 2);
+        CHECK_EQ(e.summary().value_size(), 1);
+        EXPECT_EQ(e.summary().value(0).tag(), "name");
+        EXPECT_EQ(e.summary().value(0).simple_value(), 1.0);
+      },
+      /*async=*/true));
+}
+
+TEST_F(SummaryFileWriterTest, AsyncWriteEvent) {
+  TF_CHECK_OK(SummaryTestHelper(
+      "event_async_test",
+      [](SummaryWriterInterface* writer) {
+        std::unique_ptr<Event> e{new Event};
+        e->set_step(7);
+        e->mutable_summary()->add_value()->set_tag("hi");
+        TF_RETURN_IF_ERROR(writer->WriteEvent(std::move(e)));
+        TF_RETURN_IF_ERROR(writer->Flush());
+        return Status::OK();
+      },
+      [](const Event& e) {
+        EXPECT_EQ(e.step(), 7);
+        CHECK_EQ(e.summary().value_size(), 1);
+        EXPECT_EQ(e.summary().value(0).tag(), "hi");
+      },
+      /*async=*/true));
+}
+
 TEST_F(SummaryFileWriterTest, WallTime) {
   env_.AdvanceByMillis(7023);
   TF_CHECK_OK(SummaryTestHelper(
@@ -0,0 +1,137 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#ifndef TENSORFLOW_CORE_UTIL_COMPACT_STRING_ARRAY_H_
+#define TENSORFLOW_CORE_UTIL_COMPACT_STRING_ARRAY_H_
+
+#include <vector>
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/types.h"
+#include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/stringpiece.h"
+#include "tensorflow/core/platform/types.h"
+
+namespace tensorflow {
+
+// An append-only array of strings backed by a single byte buffer plus an
+// offset array. Unlike a std::vector<string> (or a DT_STRING tensor, which
+// stores one std::string object per element), appending n short strings
+// costs at most a few buffer growths rather than n heap allocations, and
+// Clear() retains the capacity, so a reused instance reaches a steady state
+// with no allocations at all. Elements are exposed as StringPiece views into
+// the buffer; since appending may grow the buffer, views should only be
+// taken once the array holds everything the caller intends to add, and are
+// invalidated by Clear() and destruction.
+//
+// Kernels that accumulate many short intermediate strings (field splitting,
+// proto parsing and the like) can build them here and convert to a DT_STRING
+// tensor at the boundary with CopyToTensor(), keeping compatibility with
+// consumers that expect regular string tensors.
+//
+// This class is not thread-safe.
+class CompactStringArray {
+ public:
+  CompactStringArray() : offsets_(1, 0) {}
+
+  // Reserves room for num_strings strings totalling num_bytes bytes.
+  void Reserve(size_t num_strings, size_t num_bytes) {
+    offsets_.reserve(num_strings + 1);
+    buffer_.reserve(num_bytes);
+  }
+
+  // Appends a complete string.
+  void Add(StringPiece value) {
+    buffer_.append(value.data(), value.size());
+    offsets_.push_back(buffer_.size());
+  }
+
+  // Incremental building of a single string, for callers that produce one
+  // element in several pieces (e.g. unescaping). Bytes appended between
+  // BeginString() and EndString() form one element; Add() must not be called
+  // while a string is open.
+  void BeginString() {}
+  void AppendBytes(StringPiece value) {
+    buffer_.append(value.data(), value.size());
+  }
+  void AppendByte(char c) { buffer_.push_back(c); }
+  void EndString() { offsets_.push_back(buffer_.size()); }
+
+  // Appends every element of the DT_STRING tensor t.
+  Status AddTensor(const Tensor& t) {
+    if (t.dtype() != DT_STRING) {
+      return errors::InvalidArgument(
+          "CompactStringArray can only ingest DT_STRING tensors but got ",
+          DataTypeString(t.dtype()));
+    }
+    const auto t_flat = t.flat<string>();
+    for (int64 i = 0; i < t_flat.size(); ++i) {
+      Add(t_flat(i));
+    }
+    return Status::OK();
+  }
+
+  // Number of complete strings in the array.
+  size_t size() const { return offsets_.size() - 1; }
+
+  // Total number of payload bytes, including any open string.
+  size_t total_bytes() const { return buffer_.size(); }
+
+  // Returns a view of the i-th string. The view is invalidated by appends
+  // that grow the buffer, by Clear(), and by destruction.
+  StringPiece view(size_t i) const {
+    return StringPiece(buffer_.data() + offsets_[i],
+                       offsets_[i + 1] - offsets_[i]);
+  }
+
+  // Removes all strings but keeps the underlying capacity.
+  void Clear() {
+    buffer_.clear();
+    offsets_.resize(1);
+  }
+
+  // Copies the strings into the preallocated DT_STRING tensor out, which
+  // must have exactly size() elements.
+  Status CopyToTensor(Tensor* out) const {
+    if (out->dtype() != DT_STRING) {
+      return errors::InvalidArgument(
+          "CompactStringArray can only fill DT_STRING tensors but got ",
+          DataTypeString(out->dtype()));
+    }
+    auto out_flat = out->flat<string>();
+    if (static_cast<size_t>(out_flat.size()) != size()) {
+      return errors::InvalidArgument("Cannot copy ", size(),
+                                     " strings into a tensor of ",
+                                     out_flat.size(), " elements");
+    }
+    for (size_t i = 0; i < size(); ++i) {
+      const StringPiece value = view(i);
+      out_flat(i).assign(value.data(), value.size());
+    }
+    return Status::OK();
+  }
+
+ private:
+  // Element i occupies buffer_[offsets_[i], offsets_[i + 1]).
+  string buffer_;
+  std::vector<size_t> offsets_;
+
+  TF_DISALLOW_COPY_AND_ASSIGN(CompactStringArray);
+};
+
+}  // namespace tensorflow
+
+#endif  // TENSORFLOW_CORE_UTIL_COMPACT_STRING_ARRAY_H_
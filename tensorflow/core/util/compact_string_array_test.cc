@@ -0,0 +1,100 @@
+/* Copyright 2019 The TensorFlow Authors. All Rights Reserved.
+
+Licensed under the Apache License, Version 2.0 (the "License");
+you may not use this file except in compliance with the License.
+You may obtain a copy of the License at
+
+    http://www.apache.org/licenses/LICENSE-2.0
+
+Unless required by applicable law or agreed to in writing, software
+distributed under the License is distributed on an "AS IS" BASIS,
+WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+See the License for the specific language governing permissions and
+limitations under the License.
+==============================================================================*/
+
+#include "tensorflow/core/util/compact_string_array.h"
+
+#include "tensorflow/core/framework/tensor.h"
+#include "tensorflow/core/framework/tensor_shape.h"
+#include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/platform/test.h"
+
+namespace tensorflow {
+namespace {
+
+TEST(CompactStringArrayTest, AddAndView) {
+  CompactStringArray array;
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.total_bytes(), 0);
+
+  array.Add("hello");
+  array.Add("");
+  array.Add("world");
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_EQ(array.total_bytes(), 10);
+  EXPECT_EQ(array.view(0), "hello");
+  EXPECT_EQ(array.view(1), "");
+  EXPECT_EQ(array.view(2), "world");
+}
+
+TEST(CompactStringArrayTest, IncrementalBuilding) {
+  CompactStringArray array;
+  array.Add("first");
+  array.BeginString();
+  array.AppendBytes("se");
+  array.AppendByte('c');
+  array.AppendBytes("ond");
+  array.EndString();
+  EXPECT_EQ(array.size(), 2);
+  EXPECT_EQ(array.view(0), "first");
+  EXPECT_EQ(array.view(1), "second");
+}
+
+TEST(CompactStringArrayTest, ClearKeepsNothingButWorks) {
+  CompactStringArray array;
+  array.Add("abc");
+  array.Clear();
+  EXPECT_EQ(array.size(), 0);
+  EXPECT_EQ(array.total_bytes(), 0);
+  array.Add("de");
+  EXPECT_EQ(array.size(), 1);
+  EXPECT_EQ(array.view(0), "de");
+}
+
+TEST(CompactStringArrayTest, TensorRoundTrip) {
+  Tensor t(DT_STRING, TensorShape({3}));
+  auto t_flat = t.vec<string>();
+  t_flat(0) = "a";
+  t_flat(1) = "bb";
+  t_flat(2) = "ccc";
+
+  CompactStringArray array;
+  TF_ASSERT_OK(array.AddTensor(t));
+  EXPECT_EQ(array.size(), 3);
+  EXPECT_EQ(array.view(2), "ccc");
+
+  Tensor out(DT_STRING, TensorShape({3}));
+  TF_ASSERT_OK(array.CopyToTensor(&out));
+  auto out_flat = out.vec<string>();
+  EXPECT_EQ(out_flat(0), "a");
+  EXPECT_EQ(out_flat(1), "bb");
+  EXPECT_EQ(out_flat(2), "ccc");
+}
+
+TEST(CompactStringArrayTest, CopyToTensorChecksShapeAndType) {
+  CompactStringArray array;
+  array.Add("x");
+
+  Tensor wrong_size(DT_STRING, TensorShape({2}));
+  EXPECT_FALSE(array.CopyToTensor(&wrong_size).ok());
+
+  Tensor wrong_type(DT_INT32, TensorShape({1}));
+  EXPECT_FALSE(array.CopyToTensor(&wrong_type).ok());
+
+  Tensor not_a_string(DT_INT32, TensorShape({1}));
+  EXPECT_FALSE(array.AddTensor(not_a_string).ok());
+}
+
+}  // namespace
+}  // namespace tensorflow
@@ -213,6 +213,21 @@ TEST(FastParse, SingleInt64) {
   TestCorrectness(Serialize(example));
 }
 
+TEST(FastParse, LongPackedInt64List) {
+  // Exercises the bulk varint decoder: long runs of single-byte varints
+  // interleaved with multi-byte ones, including 10-byte (negative) values.
+  Example example;
+  Int64List* int64_list =
+      (*example.mutable_features()->mutable_feature())["ids"]
+          .mutable_int64_list();
+  for (int i = 0; i < 1000; ++i) {
+    int64_list->add_value(i % 100);
+    if (i % 10 == 0) int64_list->add_value(int64{1} << (i % 62));
+    if (i % 50 == 0) int64_list->add_value(-i);
+  }
+  TestCorrectness(Serialize(example));
+}
+
 static string ExampleWithSomeFeatures() {
   Example example;
 
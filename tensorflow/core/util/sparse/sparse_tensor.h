@@ -16,6 +16,8 @@ limitations under the License.
 #ifndef TENSORFLOW_CORE_UTIL_SPARSE_SPARSE_TENSOR_H_
 #define TENSORFLOW_CORE_UTIL_SPARSE_SPARSE_TENSOR_H_
 
+#include <algorithm>
+#include <functional>
 #include <limits>
 #include <numeric>
 #include <vector>
@@ -27,12 +29,16 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/framework/types.h"
 #include "tensorflow/core/framework/types.pb.h"
+#include "tensorflow/core/lib/core/blocking_counter.h"
 #include "tensorflow/core/lib/core/errors.h"
 #include "tensorflow/core/lib/core/status.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/strings/str_util.h"
 #include "tensorflow/core/lib/strings/strcat.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
 #include "tensorflow/core/platform/types.h"
+#include "tensorflow/core/util/overflow.h"
 #include "tensorflow/core/util/sparse/dim_comparator.h"
 #include "tensorflow/core/util/sparse/group_iterator.h"
 
@@ -180,6 +186,46 @@ class SparseTensor {
     return Status::OK();
   }
 
+  // Like IndicesValid(), but shards the validation across 'pool'. Each entry
+  // is checked only against its predecessor, so shards can validate disjoint
+  // ranges independently; on failure, the error for the smallest offending
+  // entry is returned, so the result does not depend on scheduling.
+  Status IndicesValid(thread::ThreadPool* pool) const {
+    const int64 kMinEntriesForParallelValidation = 1 << 14;
+    const int64 num = num_entries();
+    if (pool == nullptr || num < kMinEntriesForParallelValidation) {
+      return IndicesValid();
+    }
+    for (int64 ord : order_) {
+      if (ord < 0) {
+        return errors::FailedPrecondition(
+            "Order was not provided.  Provide an order at "
+            "construction time or run ReorderInPlace");
+      }
+    }
+
+    const auto ix_t = ix_.matrix<int64>();
+    mutex mu;
+    int64 first_invalid = -1;
+    Status result;
+    pool->ParallelFor(
+        num, 10 * dims_ /* cycles per entry */,
+        [this, &ix_t, &mu, &first_invalid, &result](int64 begin, int64 end) {
+          for (int64 n = begin; n < end; ++n) {
+            Status s = IndexValid(ix_t, n);
+            if (TF_PREDICT_FALSE(!s.ok())) {
+              mutex_lock l(mu);
+              if (first_invalid == -1 || n < first_invalid) {
+                first_invalid = n;
+                result = s;
+              }
+              return;
+            }
+          }
+        });
+    return result;
+  }
+
   VarDimArray shape() const { return shape_; }
 
   VarDimArray order() const { return order_; }
@@ -188,6 +234,17 @@ class SparseTensor {
   template <typename T>
   void Reorder(const VarDimArray& order);
 
+  // Like Reorder<T>(), but sorts with a parallel radix sort keyed on the
+  // indices flattened in 'order', sharded across 'pool', and applies the
+  // resulting permutation as a parallel gather into freshly allocated index
+  // and value tensors. Bounds checking is fused into the key-building pass;
+  // the serial path is used for small inputs, when the flattened key does
+  // not fit in an int64, or when an out-of-bounds index is found. For valid
+  // indices the result is identical to the serial path and does not depend
+  // on scheduling.
+  template <typename T>
+  void Reorder(const VarDimArray& order, thread::ThreadPool* pool);
+
   // Returns a group iterable that can be used for clumping indices
   // and values according to the group indices of interest.
   //
@@ -435,6 +492,146 @@ void SparseTensor::Reorder(const VarDimArray& order) {
   order_ = ShapeArray(order.begin(), order.end());
 }
 
+// The parallel variant sorts (flattened index, row) pairs with a stable LSD
+// radix sort: each pass histograms the current digit per shard, computes the
+// per-shard write offsets with an exclusive prefix sum over (digit, shard),
+// and scatters into a double buffer. Every row then moves to its final
+// position with a parallel gather, which is O(N) data movement instead of
+// the serial path's permutation-by-swaps over the tensors themselves.
+template <typename T>
+void SparseTensor::Reorder(const VarDimArray& order,
+                           thread::ThreadPool* pool) {
+  DCHECK_EQ(DataTypeToEnum<T>::v(), dtype())
+      << "Reorder requested with the wrong datatype";
+  DCHECK_EQ(order.size(), dims_) << "Order length must be SparseTensor rank";
+  const int64 kMinEntriesForParallelReorder = 1 << 14;
+  const int64 num = num_entries();
+  if (pool == nullptr || num < kMinEntriesForParallelReorder) {
+    Reorder<T>(order);
+    return;
+  }
+
+  // Strides for flattening each index row into a single sort key, with
+  // order[0] as the most significant dimension. If the dense size does not
+  // fit in an int64, fall back to the serial comparison sort.
+  gtl::InlinedVector<int64, 8> strides(dims_);
+  int64 dense_size = 1;
+  for (int d = dims_ - 1; d >= 0; --d) {
+    strides[d] = dense_size;
+    dense_size = MultiplyWithoutOverflow(dense_size, shape_[order[d]]);
+    if (dense_size < 0) {
+      Reorder<T>(order);
+      return;
+    }
+  }
+
+  auto ix_t = ix_.matrix<int64>();
+  auto vals_t = vals_.vec<T>();
+
+  // Runs 'work' over fixed contiguous shards; shard 0 runs on the calling
+  // thread. The shard boundaries are identical in every phase, so the
+  // per-shard histograms and write offsets below line up.
+  const int64 kMinShardSize = 1 << 13;
+  const int num_shards = std::max<int64>(
+      1, std::min<int64>(pool->NumThreads(), num / kMinShardSize));
+  auto run_shards =
+      [num, num_shards,
+       pool](const std::function<void(int64, int64, int)>& work) {
+        BlockingCounter counter(num_shards - 1);
+        for (int s = 1; s < num_shards; ++s) {
+          pool->Schedule([num, num_shards, s, &work, &counter] {
+            work(num * s / num_shards, num * (s + 1) / num_shards, s);
+            counter.DecrementCount();
+          });
+        }
+        work(0, num / num_shards, 0);
+        counter.Wait();
+      };
+
+  // Build the keys, with the bounds check fused into the same pass. An
+  // out-of-bounds index would alias another key, so fall back to the serial
+  // comparison sort, which tolerates it.
+  struct KeyIndex {
+    int64 key;
+    int64 index;
+  };
+  std::vector<KeyIndex> entries(num);
+  std::vector<KeyIndex> scratch(num);
+  std::vector<char> shard_out_of_bounds(num_shards, 0);
+  run_shards([&](int64 begin, int64 end, int shard) {
+    bool out_of_bounds = false;
+    for (int64 n = begin; n < end; ++n) {
+      int64 key = 0;
+      for (int d = 0; d < dims_; ++d) {
+        const int64 ix_n_d = ix_t(n, order[d]);
+        if (ix_n_d < 0 || ix_n_d >= shape_[order[d]]) out_of_bounds = true;
+        key += ix_n_d * strides[d];
+      }
+      entries[n].key = key;
+      entries[n].index = n;
+    }
+    if (out_of_bounds) shard_out_of_bounds[shard] = 1;
+  });
+  for (int s = 0; s < num_shards; ++s) {
+    if (shard_out_of_bounds[s]) {
+      Reorder<T>(order);
+      return;
+    }
+  }
+
+  const int64 max_key = dense_size > 0 ? dense_size - 1 : 0;
+  int num_bits = 0;
+  while ((max_key >> num_bits) != 0) ++num_bits;
+  const int num_passes = (num_bits + 7) / 8;
+
+  std::vector<std::vector<int64>> counts(num_shards, std::vector<int64>(256));
+  KeyIndex* in = entries.data();
+  KeyIndex* out = scratch.data();
+  for (int pass = 0; pass < num_passes; ++pass) {
+    const int shift = 8 * pass;
+    run_shards([&](int64 begin, int64 end, int shard) {
+      std::vector<int64>& shard_counts = counts[shard];
+      std::fill(shard_counts.begin(), shard_counts.end(), 0);
+      for (int64 n = begin; n < end; ++n) {
+        shard_counts[(in[n].key >> shift) & 0xff]++;
+      }
+    });
+    int64 total = 0;
+    for (int digit = 0; digit < 256; ++digit) {
+      for (int s = 0; s < num_shards; ++s) {
+        const int64 shard_count = counts[s][digit];
+        counts[s][digit] = total;
+        total += shard_count;
+      }
+    }
+    run_shards([&](int64 begin, int64 end, int shard) {
+      std::vector<int64>& offsets = counts[shard];
+      for (int64 n = begin; n < end; ++n) {
+        out[offsets[(in[n].key >> shift) & 0xff]++] = in[n];
+      }
+    });
+    std::swap(in, out);
+  }
+
+  Tensor output_ix(DT_INT64, TensorShape({num, dims_}));
+  Tensor output_vals(DataTypeToEnum<T>::v(), TensorShape({num}));
+  auto output_ix_t = output_ix.matrix<int64>();
+  auto output_vals_t = output_vals.vec<T>();
+  run_shards([&](int64 begin, int64 end, int shard) {
+    for (int64 n = begin; n < end; ++n) {
+      const int64 r = in[n].index;
+      for (int d = 0; d < dims_; ++d) {
+        output_ix_t(n, d) = ix_t(r, d);
+      }
+      output_vals_t(n) = vals_t(r);
+    }
+  });
+
+  ix_ = output_ix;
+  vals_ = output_vals;
+  order_ = ShapeArray(order.begin(), order.end());
+}
+
 template <typename T>
 bool SparseTensor::ValidateAndInitializeToDense(Tensor* out, bool initialize) {
   DCHECK_EQ(DataTypeToEnum<T>::v(), dtype())
@@ -22,8 +22,10 @@ limitations under the License.
 #include "tensorflow/core/framework/tensor.h"
 #include "tensorflow/core/framework/tensor_types.h"
 #include "tensorflow/core/lib/core/status_test_util.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/random/simple_philox.h"
 #include "tensorflow/core/lib/strings/str_util.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/test.h"
 #include "tensorflow/core/platform/test_benchmark.h"
 
@@ -310,6 +312,80 @@ TEST(SparseTensorTest, ValidateIndicesFindsInvalid) {
             st_indices_valid.error_message());
 }
 
+TEST(SparseTensorTest, ParallelReorderMatchesSerial) {
+  const int64 N = 1 << 16;  // above the parallel reorder threshold
+  const int NDIM = 3;
+  thread::ThreadPool pool(Env::Default(), "parallel_reorder_test", 4);
+
+  Tensor ix(DT_INT64, TensorShape({N, NDIM}));
+  Tensor vals(DT_FLOAT, TensorShape({N}));
+  Tensor parallel_ix(DT_INT64, TensorShape({N, NDIM}));
+  Tensor parallel_vals(DT_FLOAT, TensorShape({N}));
+  auto fill = [N](Tensor* indices, Tensor* values) {
+    auto ix_t = indices->matrix<int64>();
+    auto vals_t = values->vec<float>();
+    for (int64 i = 0; i < N; ++i) {
+      // Multiplying by an odd constant modulo 2^30 is a bijection, so every
+      // row gets a distinct index.
+      const uint64 key = (static_cast<uint64>(i) * 2654435761ULL) & 0x3fffffff;
+      ix_t(i, 0) = key & 0x3ff;
+      ix_t(i, 1) = (key >> 10) & 0x3ff;
+      ix_t(i, 2) = (key >> 20) & 0x3ff;
+      vals_t(i) = static_cast<float>(i);
+    }
+  };
+  fill(&ix, &vals);
+  fill(&parallel_ix, &parallel_vals);
+
+  TensorShape shape({1024, 1024, 1024});
+  SparseTensor serial_st;
+  TF_ASSERT_OK(SparseTensor::Create(ix, vals, shape, &serial_st));
+  SparseTensor parallel_st;
+  TF_ASSERT_OK(
+      SparseTensor::Create(parallel_ix, parallel_vals, shape, &parallel_st));
+
+  serial_st.Reorder<float>({2, 0, 1});
+  parallel_st.Reorder<float>({2, 0, 1}, &pool);
+  TF_EXPECT_OK(serial_st.IndicesValid());
+  TF_EXPECT_OK(parallel_st.IndicesValid(&pool));
+
+  auto serial_ix_t = serial_st.indices().matrix<int64>();
+  auto parallel_ix_t = parallel_st.indices().matrix<int64>();
+  auto serial_vals_t = serial_st.values().vec<float>();
+  auto parallel_vals_t = parallel_st.values().vec<float>();
+  for (int64 i = 0; i < N; ++i) {
+    ASSERT_EQ(serial_vals_t(i), parallel_vals_t(i));
+    for (int d = 0; d < NDIM; ++d) {
+      ASSERT_EQ(serial_ix_t(i, d), parallel_ix_t(i, d));
+    }
+  }
+}
+
+TEST(SparseTensorTest, ParallelValidateIndicesFindsInvalid) {
+  const int64 N = 1 << 15;  // above the parallel validation threshold
+  thread::ThreadPool pool(Env::Default(), "parallel_validate_test", 4);
+
+  Tensor ix(DT_INT64, TensorShape({N, 1}));
+  Tensor vals(DT_STRING, TensorShape({N}));
+  auto ix_t = ix.matrix<int64>();
+  for (int64 i = 0; i < N; ++i) {
+    ix_t(i, 0) = i;
+  }
+
+  TensorShape shape({N});
+  std::vector<int64> order{0};
+  SparseTensor st;
+  TF_ASSERT_OK(SparseTensor::Create(ix, vals, shape, order, &st));
+  TF_EXPECT_OK(st.IndicesValid(&pool));
+
+  // The smallest offending entry is reported, as in the serial path.
+  ix_t(17, 0) = ix_t(16, 0);
+  Status st_indices_valid = st.IndicesValid(&pool);
+  EXPECT_FALSE(st_indices_valid.ok());
+  EXPECT_EQ("indices[17] = [16] is repeated",
+            st_indices_valid.error_message());
+}
+
 TEST(SparseTensorTest, SparseTensorCheckBoundaries) {
   int N = 5;
   const int NDIM = 3;
@@ -15,19 +15,24 @@ limitations under the License.
 
 #include "tensorflow/core/util/tensor_slice_reader.h"
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include "tensorflow/core/framework/types.pb_text.h"
 #include "tensorflow/core/framework/versions.h"
 #include "tensorflow/core/lib/core/errors.h"
+#include "tensorflow/core/lib/core/threadpool.h"
 #include "tensorflow/core/lib/gtl/stl_util.h"
 #include "tensorflow/core/lib/io/iterator.h"
+#include "tensorflow/core/lib/io/memory_region_file.h"
 #include "tensorflow/core/lib/io/table.h"
 #include "tensorflow/core/lib/io/table_options.h"
+#include "tensorflow/core/platform/cpu_info.h"
 #include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
 #include "tensorflow/core/platform/protobuf.h"
 #include "tensorflow/core/public/version.h"
+#include "tensorflow/core/util/env_var.h"
 #include "tensorflow/core/util/saved_tensor_slice_util.h"
 #include "tensorflow/core/util/tensor_slice_util.h"
 
@@ -65,6 +70,43 @@ class TensorSliceReaderTable : public TensorSliceReader::Table {
   RandomAccessFile* file_;  // Owns.
   table::Table* table_;
 };
+
+// Readahead span for checkpoint table reads. Restoring a checkpoint scans
+// each shard's table roughly sequentially, so a large span turns one random
+// read per block into a few batched reads.
+int64 TableReadaheadBytes() {
+  static int64 result = [] {
+    int64 bytes;
+    TF_CHECK_OK(ReadInt64FromEnvVar("TF_CHECKPOINT_READAHEAD_BYTES",
+                                    /*default_val=*/0, &bytes));
+    return bytes;
+  }();
+  return result;
+}
+
+// Whether to memory-map checkpoint shard files instead of issuing read
+// syscalls against them. Uncompressed table blocks are then served directly
+// out of the mapping with no copy.
+bool MmapCheckpointEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_CHECKPOINT_MMAP",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
+
+// Whether to open the shards of a sharded checkpoint concurrently.
+bool ParallelShardOpenEnabled() {
+  static bool result = [] {
+    bool enabled;
+    TF_CHECK_OK(ReadBoolFromEnvVar("TF_CHECKPOINT_PARALLEL_SHARD_OPEN",
+                                   /*default_val=*/false, &enabled));
+    return enabled;
+  }();
+  return result;
+}
 }  // namespace
 
 Status OpenTableTensorSliceReader(const string& fname,
@@ -72,12 +114,32 @@ Status OpenTableTensorSliceReader(const string& fname,
   *result = nullptr;
   Env* env = Env::Default();
   std::unique_ptr<RandomAccessFile> f;
-  Status s = env->NewRandomAccessFile(fname, &f);
+  bool mapped = false;
+  Status s;
+  if (MmapCheckpointEnabled()) {
+    std::unique_ptr<ReadOnlyMemoryRegion> region;
+    s = env->NewReadOnlyMemoryRegionFromFile(fname, &region);
+    if (s.ok()) {
+      f.reset(new io::MemoryRegionRandomAccessFile(std::move(region)));
+      mapped = true;
+    } else {
+      VLOG(1) << "Cannot memory-map " << fname << ": " << s
+              << "; falling back to buffered reads";
+    }
+  }
+  if (!f) {
+    s = env->NewRandomAccessFile(fname, &f);
+  }
   if (s.ok()) {
     uint64 file_size;
     s = env->GetFileSize(fname, &file_size);
     if (s.ok()) {
       table::Options options;
+      // Readahead buys nothing once the file is mapped; reads are already
+      // served from memory.
+      if (!mapped && TableReadaheadBytes() > 0) {
+        options.readahead_bytes = TableReadaheadBytes();
+      }
       table::Table* table;
       s = table::Table::Open(options, f.get(), file_size, &table);
       if (s.ok()) {
@@ -143,8 +205,6 @@ void TensorSliceReader::LoadShard(int shard) const {
   if (sss_[shard] || !status_.ok()) {
     return;  // Already loaded, or invalid.
   }
-  string value;
-  SavedTensorSlices sts;
   const string fname = fnames_[shard];
   VLOG(1) << "Reading meta data from file " << fname << "...";
   Table* table;
@@ -154,6 +214,13 @@ void TensorSliceReader::LoadShard(int shard) const {
                                s.ToString());
     return;
   }
+  RegisterShard(shard, table);
+}
+
+void TensorSliceReader::RegisterShard(int shard, Table* table) const {
+  string value;
+  SavedTensorSlices sts;
+  const string fname = fnames_[shard];
   sss_[shard].reset(table);
   if (!(table->Get(kSavedTensorSlicesKey, &value) &&
         ParseProtoUnlimited(&sts, value))) {
@@ -180,6 +247,40 @@ void TensorSliceReader::LoadShard(int shard) const {
 
 void TensorSliceReader::LoadAllShards() const {
   VLOG(1) << "Loading all shards for " << filepattern_;
+  if (ParallelShardOpenEnabled() && fnames_.size() > 1 && status_.ok()) {
+    // Open every shard's table concurrently so cold-start restore is bounded
+    // by the aggregate bandwidth of the disks holding the shards, not by one
+    // open at a time. Registering the slice metadata updates shared maps and
+    // stays serial.
+    std::vector<Table*> tables(fnames_.size(), nullptr);
+    std::vector<Status> statuses(fnames_.size());
+    {
+      thread::ThreadPool pool(
+          Env::Default(), "checkpoint_shard_open",
+          std::min<int>(fnames_.size(), port::NumSchedulableCPUs()));
+      for (size_t i = 0; i < fnames_.size(); ++i) {
+        if (sss_[i]) continue;  // Already loaded.
+        pool.Schedule([this, i, &tables, &statuses] {
+          statuses[i] = open_function_(fnames_[i], &tables[i]);
+        });
+      }
+    }
+    for (size_t i = 0; i < fnames_.size(); ++i) {
+      if (sss_[i]) continue;
+      if (!status_.ok()) {
+        delete tables[i];
+        continue;
+      }
+      if (!statuses[i].ok()) {
+        status_ = errors::DataLoss("Unable to open table file ", fnames_[i],
+                                   ": ", statuses[i].ToString());
+        continue;
+      }
+      RegisterShard(i, tables[i]);
+    }
+    all_shards_loaded_ = true;
+    return;
+  }
   for (size_t i = 0; i < fnames_.size() && status_.ok(); ++i) {
     LoadShard(i);
   }
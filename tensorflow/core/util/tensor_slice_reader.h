@@ -118,6 +118,9 @@ class TensorSliceReader {
 
   void LoadShard(int shard) const;
   void LoadAllShards() const;
+  // Takes ownership of "table" as the given shard's table and registers the
+  // slice metadata it holds.
+  void RegisterShard(int shard, Table* table) const;
 
   const TensorSliceSet* FindTensorSlice(
       const string& name, const TensorSlice& slice,
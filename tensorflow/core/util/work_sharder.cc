@@ -15,11 +15,84 @@ limitations under the License.
 
 #include "tensorflow/core/util/work_sharder.h"
 
+#include <atomic>
+
 #include "tensorflow/core/lib/core/blocking_counter.h"
+#include "tensorflow/core/lib/gtl/flatmap.h"
+#include "tensorflow/core/platform/env.h"
 #include "tensorflow/core/platform/logging.h"
+#include "tensorflow/core/platform/mutex.h"
+#include "tensorflow/core/util/env_var.h"
 
 namespace tensorflow {
 
+namespace {
+
+// Returns true iff TF_ADAPTIVE_SHARDING is set.  When enabled, Shard()
+// replaces caller-supplied cost_per_unit guesses with measured per-unit
+// times and lets workers claim chunks dynamically (see
+// Sharder::DoAdaptive).
+bool AdaptiveShardingEnabled() {
+  static bool result = []() {
+    bool enabled = false;
+    Status status =
+        ReadBoolFromEnvVar("TF_ADAPTIVE_SHARDING", false, &enabled);
+    if (!status.ok()) {
+      LOG(ERROR) << status.error_message();
+    }
+    return enabled;
+  }();
+  return result;
+}
+
+// Measured per-unit cost, keyed by Shard() callsite.  Caller-supplied
+// cost_per_unit values are static guesses and chronically wrong for
+// data-dependent kernels (gather, concat, parsing); an EWMA of observed
+// per-unit time at the same callsite tracks the real cost.
+class ShardCostEstimator {
+ public:
+  static ShardCostEstimator* Get() {
+    static ShardCostEstimator* estimator = new ShardCostEstimator;
+    return estimator;
+  }
+
+  // Returns the measured per-unit cost for 'site_id', or the caller's
+  // guess when no sample has been recorded yet.
+  int64 AdjustedCost(uint64 site_id, int64 cost_per_unit) {
+    mutex_lock l(mu_);
+    auto it = sites_.find(site_id);
+    if (it == sites_.end()) return cost_per_unit;
+    return std::max(int64{1}, static_cast<int64>(it->second.ewma_cost));
+  }
+
+  // Records one measured execution of 'units' work units in 'nanos'.
+  void Record(uint64 site_id, int64 units, int64 nanos) {
+    if (units <= 0 || nanos <= 0) return;
+    const double cost = static_cast<double>(nanos) / units;
+    mutex_lock l(mu_);
+    Site& site = sites_[site_id];
+    if (site.samples == 0) {
+      site.ewma_cost = cost;
+    } else {
+      site.ewma_cost += kAlpha * (cost - site.ewma_cost);
+    }
+    ++site.samples;
+  }
+
+ private:
+  struct Site {
+    double ewma_cost = 0.0;
+    int64 samples = 0;
+  };
+
+  static constexpr double kAlpha = 0.25;
+
+  mutex mu_;
+  gtl::FlatMap<uint64, Site> sites_ GUARDED_BY(mu_);
+};
+
+}  // namespace
+
 /* ABSL_CONST_INIT */ thread_local int per_thread_max_parallism = 1000000;
 
 void SetPerThreadMaxParallelism(int max_parallelism) {
@@ -41,6 +114,19 @@ void Shard(int max_parallelism, thread::ThreadPool* workers, int64 total,
     work(0, total);
     return;
   }
+  if (AdaptiveShardingEnabled()) {
+    uint64 site_id = 0;
+#if defined(__GNUC__)
+    // Shard() is never inlined (it lives in this translation unit), so the
+    // return address identifies the calling kernel's shard site.
+    site_id = reinterpret_cast<uint64>(__builtin_return_address(0));
+#endif
+    Sharder::DoAdaptive(
+        total, cost_per_unit, work,
+        [&workers](Sharder::Closure c) { workers->Schedule(c); },
+        std::min(max_parallelism, workers->NumThreads()), site_id);
+    return;
+  }
   if (max_parallelism >= workers->NumThreads()) {
     workers->ParallelFor(total, cost_per_unit, work);
     return;
@@ -93,4 +179,59 @@ void Sharder::Do(int64 total, int64 cost_per_unit, const Work& work,
   counter.Wait();
 }
 
+void Sharder::DoAdaptive(int64 total, int64 cost_per_unit, const Work& work,
+                         const Runner& runner, int max_parallelism,
+                         uint64 site_id) {
+  ShardCostEstimator* estimator = ShardCostEstimator::Get();
+  cost_per_unit = std::max(
+      int64{1}, estimator->AdjustedCost(site_id, std::max(int64{1},
+                                                          cost_per_unit)));
+  // A chunk below ~10us of work costs more in dispatch and claim overhead
+  // than it saves in parallelism.
+  static const int64 kMinCostPerChunk = 10000;
+  const int64 min_chunk_units =
+      std::max(int64{1}, kMinCostPerChunk / cost_per_unit);
+  const int num_workers = std::max<int>(
+      1, std::min<int64>(max_parallelism, total / min_chunk_units));
+  if (num_workers <= 1) {
+    const int64 start_ns = Env::Default()->NowNanos();
+    work(0, total);
+    estimator->Record(site_id, total, Env::Default()->NowNanos() - start_ns);
+    return;
+  }
+  // Workers claim fixed-size chunks from a shared counter, so a worker
+  // that finishes early picks up the tail instead of idling.  Roughly
+  // four chunks per worker balances tail latency against claim overhead.
+  const int64 chunk = std::max(
+      min_chunk_units, (total + 4 * num_workers - 1) / (4 * num_workers));
+  std::atomic<int64> next(0);
+  BlockingCounter counter(num_workers - 1);
+  auto run_chunks = [&work, &next, total, chunk]() {
+    for (;;) {
+      const int64 start = next.fetch_add(chunk, std::memory_order_relaxed);
+      if (start >= total) return;
+      work(start, std::min(start + chunk, total));
+    }
+  };
+  for (int i = 1; i < num_workers; ++i) {
+    runner([&run_chunks, &counter]() {
+      run_chunks();
+      counter.DecrementCount();
+    });
+  }
+  // The calling thread times its first chunk to feed the cost estimate;
+  // chunk execution is serial on one thread, so the sample is not skewed
+  // by the parallelism in flight.
+  const int64 first = next.fetch_add(chunk, std::memory_order_relaxed);
+  if (first < total) {
+    const int64 limit = std::min(first + chunk, total);
+    const int64 start_ns = Env::Default()->NowNanos();
+    work(first, limit);
+    estimator->Record(site_id, limit - first,
+                      Env::Default()->NowNanos() - start_ns);
+    run_chunks();
+  }
+  counter.Wait();
+}
+
 }  // end namespace tensorflow
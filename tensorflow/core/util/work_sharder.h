@@ -94,6 +94,15 @@ class Sharder {
   // schedule a closure. Shard() uses thread::ThreadPool instead.
   static void Do(int64 total, int64 cost_per_unit, const Work& work,
                  const Runner& runner, int max_parallelism);
+
+  // Variant of Do() used by Shard() when TF_ADAPTIVE_SHARDING is set.
+  // Replaces the caller's cost_per_unit guess with an EWMA of per-unit
+  // times previously measured at the same callsite ('site_id'), and has
+  // workers claim fixed-size chunks from a shared counter so that a
+  // worker finishing early picks up the tail of the range.
+  static void DoAdaptive(int64 total, int64 cost_per_unit, const Work& work,
+                         const Runner& runner, int max_parallelism,
+                         uint64 site_id);
 };
 
 }  // end namespace tensorflow
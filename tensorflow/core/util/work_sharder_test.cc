@@ -89,6 +89,37 @@ TEST(Shard, OverflowTest) {
   }
 }
 
+TEST(Shard, Adaptive) {
+  thread::ThreadPool threads(Env::Default(), "test", 16);
+  auto runner = [&threads](Sharder::Closure c) { threads.Schedule(c); };
+  const uint64 site_id = 0x8badf00d;
+  // Repeated runs exercise both the cold path (caller's guess) and the
+  // warm path (measured EWMA cost).
+  for (int iter = 0; iter < 3; ++iter) {
+    for (auto total : {0, 1, 7, 64, 1000, 9999}) {
+      for (auto cost_per_unit : {0, 1, 1003, 1000007}) {
+        mutex mu;
+        int64 num_done_work = 0;
+        std::vector<bool> work(total, false);
+        Sharder::DoAdaptive(
+            total, cost_per_unit,
+            [=, &mu, &num_done_work, &work](int64 start, int64 limit) {
+              EXPECT_GE(start, 0);
+              EXPECT_LE(limit, total);
+              mutex_lock l(mu);
+              for (; start < limit; ++start) {
+                EXPECT_FALSE(work[start]);  // No duplicate
+                ++num_done_work;
+                work[start] = true;
+              }
+            },
+            runner, 16, site_id);
+        EXPECT_EQ(num_done_work, total);
+      }
+    }
+  }
+}
+
 void BM_Sharding(int iters, int arg) {
   thread::ThreadPool threads(Env::Default(), "test", 16);
   const int64 total = 1LL << 30;
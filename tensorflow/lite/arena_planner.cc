@@ -66,6 +66,8 @@ TfLiteStatus ArenaPlanner::PlanAllocations() {
   // The alloc_queue_ is specific to the graph topology, and will be
   // completely reconstructed from graph data here.
   alloc_queue_.clear();
+  // Cached plans were computed against the old topology.
+  plan_cache_.clear();
 
   // Keeps track of references to each tensor.
   std::vector<int> refcounts(graph_info_->num_tensors(), 0);
@@ -190,7 +192,30 @@ TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   TF_LITE_ENSURE(context_, graph_info_->num_tensors() >= allocs_.size());
   allocs_.resize(graph_info_->num_tensors());
 
-  TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+  // Plans are only cached when the whole graph is allocated in a single
+  // pass. Incremental passes are driven by dynamic tensors, whose sizes are
+  // only known at invocation time and are not captured by the input-shape
+  // signature.
+  const bool whole_graph =
+      first_node == 0 &&
+      last_node + 1 >= static_cast<int>(graph_info_->num_nodes());
+  if (whole_graph) {
+    const std::vector<int> signature = InputShapeSignature();
+    CachedPlan* cached = FindCachedPlan(signature);
+    if (cached != nullptr) {
+      // Reinstate the cached plan instead of replaying the allocation queue.
+      allocs_ = cached->allocs;
+      allocs_.resize(graph_info_->num_tensors());
+      arena_.RestoreHighWaterMark(cached->arena_high_water_mark);
+      persistent_arena_.RestoreHighWaterMark(
+          cached->persistent_arena_high_water_mark);
+    } else {
+      TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+      CachePlan(signature);
+    }
+  } else {
+    TF_LITE_ENSURE_STATUS(CalculateAllocations(first_node, last_node));
+  }
   TF_LITE_ENSURE_STATUS(Commit());
 
   for (int i = 0; i < graph_info_->num_tensors(); ++i) {
@@ -204,6 +229,51 @@ TfLiteStatus ArenaPlanner::ExecuteAllocations(int first_node, int last_node) {
   return kTfLiteOk;
 }
 
+std::vector<int> ArenaPlanner::InputShapeSignature() {
+  std::vector<int> signature;
+  for (int tensor_index : graph_info_->inputs()) {
+    if (tensor_index == kOptionalTensor) continue;
+    const TfLiteTensor& tensor = *graph_info_->tensor(tensor_index);
+    // Separate tensors so signatures can't collide across input boundaries.
+    signature.push_back(-1);
+    signature.push_back(static_cast<int>(tensor.bytes));
+    if (tensor.dims == nullptr) continue;
+    for (int i = 0; i < tensor.dims->size; ++i) {
+      signature.push_back(tensor.dims->data[i]);
+    }
+  }
+  return signature;
+}
+
+ArenaPlanner::CachedPlan* ArenaPlanner::FindCachedPlan(
+    const std::vector<int>& signature) {
+  for (auto& plan : plan_cache_) {
+    if (plan.signature == signature) {
+      plan.last_used = ++plan_cache_clock_;
+      return &plan;
+    }
+  }
+  return nullptr;
+}
+
+void ArenaPlanner::CachePlan(const std::vector<int>& signature) {
+  if (static_cast<int>(plan_cache_.size()) >= kMaxCachedAllocationPlans) {
+    // Evict the least recently used plan.
+    size_t lru = 0;
+    for (size_t i = 1; i < plan_cache_.size(); ++i) {
+      if (plan_cache_[i].last_used < plan_cache_[lru].last_used) lru = i;
+    }
+    plan_cache_.erase(plan_cache_.begin() + lru);
+  }
+  plan_cache_.push_back(CachedPlan());
+  CachedPlan& plan = plan_cache_.back();
+  plan.signature = signature;
+  plan.allocs = allocs_;
+  plan.arena_high_water_mark = arena_.GetHighWaterMark();
+  plan.persistent_arena_high_water_mark = persistent_arena_.GetHighWaterMark();
+  plan.last_used = ++plan_cache_clock_;
+}
+
 TfLiteStatus ArenaPlanner::Commit() {
   TF_LITE_ENSURE_STATUS(arena_.Commit(context_));
   TF_LITE_ENSURE_STATUS(persistent_arena_.Commit(context_));
@@ -29,6 +29,12 @@ namespace tflite {
 constexpr const int kDefaultArenaAlignment = 64;
 constexpr const int kDefaultTensorAlignment = 64;
 
+// Number of allocation plans kept hot, keyed by input-shape signature.
+// Models that alternate between a few input sizes replan on every resize;
+// keeping the last few plans around lets a previously computed plan be
+// reinstated without replaying the allocation queue.
+constexpr const int kMaxCachedAllocationPlans = 4;
+
 struct AllocationInfo;
 
 // A memory planner that makes all the allocations using arenas.
@@ -65,6 +71,31 @@ class ArenaPlanner : public MemoryPlanner {
   int64_t BasePointer(TfLiteAllocationType type);
 
  private:
+  // A computed allocation plan for one input-shape signature, so that
+  // alternating between known input sizes does not replay the allocation
+  // queue each time. Assumes that op preparation is deterministic, i.e. that
+  // identical input shapes always produce identical tensor sizes.
+  struct CachedPlan {
+    std::vector<int> signature;
+    std::vector<ArenaAlloc> allocs;
+    size_t arena_high_water_mark;
+    size_t persistent_arena_high_water_mark;
+    // Tick of the last cache hit, used for least-recently-used eviction.
+    int last_used;
+  };
+
+  // Returns the input-shape signature of the current graph: the dimensions
+  // and byte sizes of all graph inputs.
+  std::vector<int> InputShapeSignature();
+
+  // Returns the cached plan matching 'signature', or nullptr if there is
+  // none.
+  CachedPlan* FindCachedPlan(const std::vector<int>& signature);
+
+  // Records the just-computed allocation plan under 'signature', evicting
+  // the least recently used entry if the cache is full.
+  void CachePlan(const std::vector<int>& signature);
+
   // Make sure all the arenas have reserved enough memory to store all their
   // tensors.
   TfLiteStatus Commit();
@@ -120,6 +151,13 @@ class ArenaPlanner : public MemoryPlanner {
 
   // Number of bytes that tensor buffers should be aligned to.
   int tensor_alignment_;
+
+  // Allocation plans computed for recently seen input-shape signatures.
+  // Invalidated whenever the graph topology changes.
+  std::vector<CachedPlan> plan_cache_;
+
+  // Monotonic counter used to time-stamp plan cache hits.
+  int plan_cache_clock_ = 0;
 };
 
 }  // namespace tflite
@@ -534,6 +534,45 @@ TEST_F(ArenaPlannerTest, ModifiedGraph) {
   EXPECT_EQ(GetOffset(3), GetOffsetAfter(1));
 }
 
+TEST_F(ArenaPlannerTest, PlanCacheAlternatingInputSizes) {
+  TestGraph graph({0, 1},
+                  {
+                      /* in, out, tmp */
+                      {{0, 1}, {2}, {}},     // First op
+                      {{2, 0}, {4, 5}, {}},  // Second op
+                      {{4, 5}, {3}, {}}      // Third op
+                  },
+                  {3});
+  SetGraph(&graph);
+  Execute(0, 10);
+  std::vector<int64_t> small_offsets;
+  for (int i = 0; i <= 5; ++i) small_offsets.push_back(GetOffset(i));
+
+  // Simulate a resize of input #0, as AllocateTensors() would: reset the
+  // allocations and re-execute the whole plan.
+  (*graph.tensors())[0].bytes = 40;
+  ASSERT_EQ(planner_->ResetAllocations(), kTfLiteOk);
+  Execute(0, 10);
+  std::vector<int64_t> large_offsets;
+  for (int i = 0; i <= 5; ++i) large_offsets.push_back(GetOffset(i));
+
+  // Alternating between the two input sizes must reproduce the layouts
+  // computed above, now reinstated from the plan cache.
+  (*graph.tensors())[0].bytes = 3;
+  ASSERT_EQ(planner_->ResetAllocations(), kTfLiteOk);
+  Execute(0, 10);
+  for (int i = 0; i <= 5; ++i) {
+    EXPECT_EQ(GetOffset(i), small_offsets[i]);
+  }
+
+  (*graph.tensors())[0].bytes = 40;
+  ASSERT_EQ(planner_->ResetAllocations(), kTfLiteOk);
+  Execute(0, 10);
+  for (int i = 0; i <= 5; ++i) {
+    EXPECT_EQ(GetOffset(i), large_offsets[i]);
+  }
+}
+
 }  // namespace
 }  // namespace tflite
 
@@ -14,6 +14,12 @@ limitations under the License.
 ==============================================================================*/
 
 #include "tensorflow/lite/core/subgraph.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 #include "tensorflow/lite/arena_planner.h"
 #include "tensorflow/lite/c/c_api_internal.h"
 #include "tensorflow/lite/context_util.h"
@@ -471,6 +477,26 @@ TfLiteStatus Subgraph::AllocateTensors() {
     return kTfLiteError;
   }
 
+  // Run any op initializations deferred from AddNodeWithParameters(). This
+  // must happen before any op is prepared.
+  if (!nodes_pending_init_.empty()) {
+    for (int node_index : nodes_pending_init_) {
+      TfLiteNode& node = nodes_and_registration_[node_index].first;
+      const TfLiteRegistration& registration =
+          nodes_and_registration_[node_index].second;
+      if (node.custom_initial_data) {
+        node.user_data =
+            OpInit(registration,
+                   reinterpret_cast<const char*>(node.custom_initial_data),
+                   node.custom_initial_data_size);
+      } else {
+        node.user_data = OpInit(
+            registration, reinterpret_cast<const char*>(node.builtin_data), 0);
+      }
+    }
+    nodes_pending_init_.clear();
+  }
+
   // Explicit (re)allocation is necessary if nodes have been changed or tensors
   // have been resized. For inputs marked as dynamic, we can't short-circuit the
   // allocation as the client may have done the resize manually.
@@ -549,7 +575,16 @@ TfLiteStatus Subgraph::AddNodeWithParameters(
   node.inputs = ConvertVectorToTfLiteIntArray(inputs);
   node.outputs = ConvertVectorToTfLiteIntArray(outputs);
   node.temporaries = TfLiteIntArrayCreate(0);
-  if (init_data) {
+  if (deferred_op_init_ &&
+      (init_data == nullptr ||
+       registration->builtin_code == BuiltinOperator_CUSTOM)) {
+    // The init arguments are recoverable from the node itself
+    // (`custom_initial_data` or `builtin_data`), so initialization can wait
+    // until the subgraph is first prepared. `init_data` must outlive this
+    // subgraph, which holds for flatbuffer-backed models.
+    node.user_data = nullptr;
+    nodes_pending_init_.push_back(new_node_index);
+  } else if (init_data) {
     node.user_data = OpInit(*registration, init_data, init_data_size);
   } else {
     node.user_data =
@@ -645,6 +680,10 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
 
   int last_exec_plan_index_prepared = 0;
 
+  // Executing allocations may move tensor buffers, so any dependency graph
+  // derived from buffer addresses must be rebuilt.
+  parallel_plan_valid_ = false;
+
   TF_LITE_ENSURE_STATUS(PrepareOpsStartingAt(
       next_execution_plan_index_to_prepare_, &last_exec_plan_index_prepared));
   TF_LITE_ENSURE_STATUS(memory_planner_->ExecuteAllocations(
@@ -654,6 +693,172 @@ TfLiteStatus Subgraph::PrepareOpsAndTensors() {
   return kTfLiteOk;
 }
 
+void Subgraph::SetParallelExecution(bool enable, int num_threads) {
+  parallel_execution_enabled_ = enable && num_threads > 1;
+  parallel_num_threads_ = num_threads;
+  parallel_plan_valid_ = false;
+}
+
+bool Subgraph::ParallelInvokeEligible() const {
+  // The parallel path assumes a fully prepared graph with a fixed memory
+  // plan. Dynamic tensors re-enter PrepareOpsAndTensors() mid-invoke,
+  // copying stale delegate buffers mutates shared tensor state, and neither
+  // the profiler nor the cancellation callback is required to be
+  // thread-safe, so all of these fall back to the serial loop.
+  if (has_dynamic_tensors_) return false;
+  if (next_execution_plan_index_to_prepare_ != execution_plan_.size()) {
+    return false;
+  }
+  if (profiler_ != nullptr) return false;
+  if (check_cancelled_func_ != nullptr) return false;
+  for (const auto& tensor : tensors_) {
+    if (tensor.delegate != nullptr) return false;
+  }
+  return true;
+}
+
+void Subgraph::BuildParallelExecutionPlan() {
+  const int plan_size = execution_plan_.size();
+  parallel_dependents_.assign(plan_size, std::vector<int>());
+  parallel_pending_counts_.assign(plan_size, 0);
+
+  // Plan position of the producer of each tensor, or -1 for graph inputs,
+  // constants and variable tensors.
+  std::vector<int> producer(tensors_.size(), -1);
+  for (int i = 0; i < plan_size; ++i) {
+    const TfLiteNode& node = nodes_and_registration_[execution_plan_[i]].first;
+    for (int tensor_index : TfLiteIntArrayView(node.outputs)) {
+      producer[tensor_index] = i;
+    }
+  }
+
+  // Byte ranges read and written by each plan position. The arena planner
+  // reuses buffers between tensors whose lifetimes don't overlap in serial
+  // execution order, so two nodes that share no tensor may still touch the
+  // same memory; such pairs must keep their serial ordering.
+  struct ByteRange {
+    const char* begin;
+    const char* end;
+  };
+  std::vector<std::vector<ByteRange>> reads(plan_size);
+  std::vector<std::vector<ByteRange>> writes(plan_size);
+  auto collect_ranges = [this](const TfLiteIntArray* indices,
+                               std::vector<ByteRange>* ranges) {
+    for (int tensor_index : TfLiteIntArrayView(indices)) {
+      if (tensor_index == kOptionalTensor) continue;
+      const TfLiteTensor& tensor = tensors_[tensor_index];
+      if (tensor.data.raw == nullptr || tensor.bytes == 0) continue;
+      ranges->push_back({tensor.data.raw, tensor.data.raw + tensor.bytes});
+    }
+  };
+  for (int i = 0; i < plan_size; ++i) {
+    const TfLiteNode& node = nodes_and_registration_[execution_plan_[i]].first;
+    collect_ranges(node.inputs, &reads[i]);
+    collect_ranges(node.outputs, &writes[i]);
+    // Scratch tensors may share arena space with other nodes' tensors.
+    collect_ranges(node.temporaries, &writes[i]);
+  }
+  auto overlaps = [](const std::vector<ByteRange>& a,
+                     const std::vector<ByteRange>& b) {
+    for (const ByteRange& range_a : a) {
+      for (const ByteRange& range_b : b) {
+        if (range_a.begin < range_b.end && range_b.begin < range_a.end) {
+          return true;
+        }
+      }
+    }
+    return false;
+  };
+
+  std::vector<char> is_dependency(plan_size);
+  for (int later = 0; later < plan_size; ++later) {
+    std::fill(is_dependency.begin(), is_dependency.end(), 0);
+    const TfLiteNode& node =
+        nodes_and_registration_[execution_plan_[later]].first;
+    // True dependencies through produced tensors.
+    for (int tensor_index : TfLiteIntArrayView(node.inputs)) {
+      if (tensor_index == kOptionalTensor) continue;
+      const int p = producer[tensor_index];
+      if (p >= 0 && p < later) is_dependency[p] = 1;
+    }
+    // Ordering constraints through overlapping buffers.
+    for (int earlier = 0; earlier < later; ++earlier) {
+      if (!is_dependency[earlier] &&
+          (overlaps(writes[later], reads[earlier]) ||
+           overlaps(writes[later], writes[earlier]) ||
+           overlaps(reads[later], writes[earlier]))) {
+        is_dependency[earlier] = 1;
+      }
+    }
+    for (int earlier = 0; earlier < later; ++earlier) {
+      if (is_dependency[earlier]) {
+        parallel_dependents_[earlier].push_back(later);
+        ++parallel_pending_counts_[later];
+      }
+    }
+  }
+  parallel_plan_valid_ = true;
+}
+
+TfLiteStatus Subgraph::InvokeParallel() {
+  if (!parallel_plan_valid_) BuildParallelExecutionPlan();
+
+  const int plan_size = execution_plan_.size();
+  EnsureTensorsVectorCapacity();
+
+  std::mutex mu;
+  std::condition_variable work_available;
+  std::vector<int> ready;
+  std::vector<int> pending = parallel_pending_counts_;
+  int remaining = plan_size;
+  TfLiteStatus status = kTfLiteOk;
+  // Seed in reverse so that popping from the back yields plan order.
+  for (int i = plan_size - 1; i >= 0; --i) {
+    if (pending[i] == 0) ready.push_back(i);
+  }
+
+  auto work_loop = [&]() {
+    std::unique_lock<std::mutex> lock(mu);
+    while (true) {
+      while (ready.empty() && remaining > 0 && status == kTfLiteOk) {
+        work_available.wait(lock);
+      }
+      if (ready.empty() || status != kTfLiteOk) return;
+      const int plan_index = ready.back();
+      ready.pop_back();
+      lock.unlock();
+
+      const int node_index = execution_plan_[plan_index];
+      TfLiteNode& node = nodes_and_registration_[node_index].first;
+      const TfLiteRegistration& registration =
+          nodes_and_registration_[node_index].second;
+      const TfLiteStatus op_status = OpInvoke(registration, &node);
+
+      lock.lock();
+      if (op_status == kTfLiteError) {
+        if (status == kTfLiteOk) {
+          status = ReportOpError(context_, node, registration, node_index,
+                                 "failed to invoke");
+        }
+        work_available.notify_all();
+        return;
+      }
+      --remaining;
+      for (int dependent : parallel_dependents_[plan_index]) {
+        if (--pending[dependent] == 0) ready.push_back(dependent);
+      }
+      if (remaining == 0 || !ready.empty()) work_available.notify_all();
+    }
+  };
+
+  const int num_threads = std::min(parallel_num_threads_, plan_size);
+  std::vector<std::thread> workers;
+  for (int i = 1; i < num_threads; ++i) workers.emplace_back(work_loop);
+  work_loop();
+  for (auto& worker : workers) worker.join();
+  return status;
+}
+
 TfLiteStatus Subgraph::Invoke() {
   if (!consistent_) {
     ReportError("Invoke called on model that is not consistent.");
@@ -680,6 +885,10 @@ TfLiteStatus Subgraph::Invoke() {
     }
   }
 
+  if (parallel_execution_enabled_ && ParallelInvokeEligible()) {
+    return InvokeParallel();
+  }
+
   // Invocations are always done in node order.
   // Note that calling Invoke repeatedly will cause the original memory plan to
   // be reused, unless either ResizeInputTensor() or AllocateTensors() has been
@@ -120,6 +120,15 @@ class Subgraph {
   // Overrides execution plan. This bounds checks indices sent in.
   TfLiteStatus SetExecutionPlan(const std::vector<int>& new_plan);
 
+  // When enabled, ops added to this subgraph are not given their init
+  // callback until the subgraph is first prepared by `AllocateTensors`. A
+  // subgraph that is never executed then never pays per-op initialization,
+  // which shortens model setup. Must be set before nodes are added. Ops
+  // whose init data is neither builtin nor custom cannot be deferred and
+  // are initialized immediately.
+  // WARNING: This is an experimental API and subject to change.
+  void SetDeferredOpInit(bool enable) { deferred_op_init_ = enable; }
+
   // Get a mutable tensor data structure.
   // TODO(aselle): Create a safe ArrayHandle interface to avoid exposing this
   // read/write access to structure
@@ -220,6 +229,16 @@ class Subgraph {
 
   void UseNNAPI(bool enable);
 
+  // Enables executing independent ops of the execution plan concurrently on
+  // `num_threads` threads (including the calling thread). Dependencies are
+  // derived from tensor producer/consumer edges and from arena buffer reuse,
+  // so results are identical to serial execution as long as the kernels
+  // themselves are safe to run concurrently. The serial path remains the
+  // default; graphs with dynamic tensors, delegates, an attached profiler or
+  // a cancellation function always execute serially.
+  // WARNING: This is an experimental API and subject to change.
+  void SetParallelExecution(bool enable, int num_threads);
+
   // Return the subgraph specific context.
   TfLiteContext* context() { return context_; }
 
@@ -333,6 +352,21 @@ class Subgraph {
   // to wait until Invoke() to resolve the sizes of dynamic tensors.
   TfLiteStatus PrepareOpsAndTensors();
 
+  // Returns true if the current graph can use the parallel execution path.
+  // See the `SetParallelExecution` comment for the exclusions.
+  bool ParallelInvokeEligible() const;
+
+  // Derives the dependency graph used by `InvokeParallel` from the current
+  // execution plan and tensor allocations. Must run after all ops have been
+  // prepared and the memory plan executed, since it inspects tensor buffer
+  // addresses.
+  void BuildParallelExecutionPlan();
+
+  // Runs the execution plan on a pool of threads, dispatching each op once
+  // all of its dependencies have completed. Only called when
+  // `ParallelInvokeEligible` is true.
+  TfLiteStatus InvokeParallel();
+
   // Call OpPrepare() for all ops starting at 'first_node'. Stop when a
   // dynamic tensors is found or all ops have been prepared. Fill
   // 'last_node_prepared' with the id of the op containing dynamic tensors, or
@@ -536,6 +570,34 @@ class Subgraph {
   // The value is invalid before `PrepareOpStartingAt` is called.
   bool has_dynamic_tensors_ = true;
 
+  // Whether op initialization is deferred to the first `AllocateTensors`.
+  // Set through `SetDeferredOpInit`.
+  bool deferred_op_init_ = false;
+
+  // Node indices whose init callback has not run yet. Drained by
+  // `AllocateTensors`.
+  std::vector<int> nodes_pending_init_;
+
+  // Whether `Invoke` should try the parallel execution path. Set through
+  // `SetParallelExecution`.
+  bool parallel_execution_enabled_ = false;
+
+  // Number of threads (including the invoking thread) used by the parallel
+  // execution path.
+  int parallel_num_threads_ = 1;
+
+  // Whether `parallel_dependents_` and `parallel_pending_counts_` match the
+  // current execution plan and memory plan. Invalidated whenever ops are
+  // re-prepared, since the arena may move tensor buffers.
+  bool parallel_plan_valid_ = false;
+
+  // For each execution plan position, the plan positions that depend on it.
+  std::vector<std::vector<int>> parallel_dependents_;
+
+  // For each execution plan position, the number of dependencies that must
+  // complete before it may run.
+  std::vector<int> parallel_pending_counts_;
+
   // Reference to cancellation function that can cancel a request in the middle
   // of a call to Invoke(). When this function returns True, a kTfLiteError is
   // thrown by Invoke().
@@ -92,6 +92,13 @@ constexpr int32_t kMinSdkVersionForNNAPI = 27;
 constexpr int32_t kMinSdkVersionForNNAPI11 = 28;
 constexpr int32_t kMinSdkVersionForNNAPI12 = 29;
 
+// Length of the token accepted by ANeuralNetworksCompilation_setCaching.
+constexpr size_t kByteSizeOfCacheToken = 32;
+
+// Directory used for NNAPI compilation caching, or nullptr when caching is
+// disabled. Set through NnApiDelegateSetCompilationCacheDir().
+const char* nnapi_cache_dir = nullptr;
+
 }  // namespace
 
 // RAII NN API Model Destructor for use with std::unique_ptr
@@ -975,6 +982,17 @@ class NNAPIDelegateKernel {
       RETURN_TFLITE_ERROR_IF_NN_ERROR(
           context, nnapi_->ANeuralNetworksCompilation_create(nn_model_.get(),
                                                              &compilation));
+      if (nnapi_cache_dir != nullptr &&
+          nnapi_->android_sdk_version >= kMinSdkVersionForNNAPI12 &&
+          nnapi_->ANeuralNetworksCompilation_setCaching != nullptr) {
+        uint8_t token[kByteSizeOfCacheToken];
+        ComputeCacheToken(context, token);
+        // A failure to set up caching downgrades to a plain compilation;
+        // it is not an error. The NNAPI runtime itself discards cache
+        // entries that were produced by a different driver version.
+        nnapi_->ANeuralNetworksCompilation_setCaching(compilation,
+                                                      nnapi_cache_dir, token);
+      }
       RETURN_TFLITE_ERROR_IF_NN_ERROR(
           context, nnapi_->ANeuralNetworksCompilation_finish(compilation));
       nn_compilation_.reset(compilation);
@@ -982,6 +1000,53 @@ class NNAPIDelegateKernel {
     return kTfLiteOk;
   }
 
+  // Fills 'token' with a fingerprint of the delegated partition: the node
+  // indices, their op codes and versions, the types and shapes of their
+  // input tensors, and the NNAPI feature level. Partitions with equal
+  // fingerprints map to the same compilation cache entry.
+  void ComputeCacheToken(TfLiteContext* context, uint8_t* token) {
+    // 64-bit FNV-1a, replicated over four differently seeded lanes to fill
+    // the 32 byte token.
+    constexpr uint64_t kFnvOffsetBasis = 0xcbf29ce484222325ULL;
+    constexpr uint64_t kFnvPrime = 0x100000001b3ULL;
+    constexpr int kNumLanes = kByteSizeOfCacheToken / sizeof(uint64_t);
+    uint64_t lanes[kNumLanes];
+    for (int i = 0; i < kNumLanes; ++i) {
+      lanes[i] = kFnvOffsetBasis + 0x9e3779b97f4a7c15ULL * i;
+    }
+    auto add = [&lanes](uint64_t value) {
+      for (uint64_t& lane : lanes) {
+        for (int i = 0; i < 8; ++i) {
+          lane = (lane ^ ((value >> (8 * i)) & 0xff)) * kFnvPrime;
+        }
+      }
+    };
+
+    add(nnapi_->android_sdk_version);
+    for (int node_index : nodes_) {
+      add(node_index);
+      TfLiteNode* node;
+      TfLiteRegistration* registration;
+      if (context->GetNodeAndRegistration(context, node_index, &node,
+                                          &registration) != kTfLiteOk) {
+        continue;
+      }
+      add(registration->builtin_code);
+      add(registration->version);
+      for (int tensor_index : TfLiteIntArrayView(node->inputs)) {
+        add(static_cast<uint64_t>(tensor_index));
+        if (tensor_index == kOptionalTensor) continue;
+        const TfLiteTensor& tensor = context->tensors[tensor_index];
+        add(tensor.type);
+        if (tensor.dims == nullptr) continue;
+        for (int i = 0; i < tensor.dims->size; ++i) {
+          add(tensor.dims->data[i]);
+        }
+      }
+    }
+    memcpy(token, lanes, kByteSizeOfCacheToken);
+  }
+
   TfLiteStatus Invoke(TfLiteContext* context, TfLiteNode* node) {
     ANeuralNetworksExecution* execution = nullptr;
     RETURN_TFLITE_ERROR_IF_NN_ERROR(
@@ -1327,4 +1392,8 @@ TfLiteDelegate* NnApiDelegate() {
   return &delegate;
 }
 
+void NnApiDelegateSetCompilationCacheDir(const char* cache_dir) {
+  nnapi_cache_dir = cache_dir;
+}
+
 }  // namespace tflite
@@ -26,6 +26,16 @@ namespace tflite {
 // NnApiDelegate() returns a singleton, so you should not free this
 // pointer or worry about its lifetime.
 TfLiteDelegate* NnApiDelegate();
+
+// Sets the directory used by NnApiDelegate() for NNAPI compilation caching
+// on platforms that support it (NNAPI feature level 1.2 and later). When
+// set, each delegated partition registers a cache token derived from its
+// structure, so warm process starts reuse previously compiled artifacts
+// instead of recompiling; the NNAPI runtime invalidates entries compiled by
+// a different driver version. Pass nullptr to disable caching (the
+// default). The string must outlive all uses of the delegate, and this must
+// be called before the delegate is applied to an interpreter.
+void NnApiDelegateSetCompilationCacheDir(const char* cache_dir);
 }  // namespace tflite
 
 #endif  // TENSORFLOW_LITE_DELEGATES_NNAPI_NNAPI_DELEGATE_H_
@@ -194,6 +194,12 @@ TfLiteStatus Interpreter::SetExecutionPlan(const std::vector<int>& new_plan) {
 
 void Interpreter::UseNNAPI(bool enable) { primary_subgraph().UseNNAPI(enable); }
 
+void Interpreter::SetParallelExecution(bool enable, int num_threads) {
+  for (auto& subgraph : subgraphs_) {
+    subgraph->SetParallelExecution(enable, num_threads);
+  }
+}
+
 void Interpreter::SetNumThreads(int num_threads) {
   for (auto& subgraph : subgraphs_) {
     subgraph->context()->recommended_num_threads = num_threads;
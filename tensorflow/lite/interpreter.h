@@ -345,6 +345,15 @@ class Interpreter {
   // Set the number of threads available to the interpreter.
   void SetNumThreads(int num_threads);
 
+  // Enable executing independent ops of the graph concurrently on
+  // `num_threads` threads (including the calling thread). Ops are dispatched
+  // as soon as all of their dependencies have completed, so models with
+  // parallel branches can overlap work across cores. The serial path remains
+  // the default; graphs with dynamic tensors, delegates, an attached profiler
+  // or a cancellation function always execute serially.
+  // WARNING: This is an experimental API and subject to change.
+  void SetParallelExecution(bool enable, int num_threads);
+
   // Allow float16 precision for FP32 calculation when possible.
   // default: not allow.
   // WARNING: This is an experimental API and subject to change.
@@ -579,6 +579,124 @@ TEST(BasicInterpreter, OneOpInterpreter) {
   ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
 }
 
+// Checks that with deferred op init enabled, op init callbacks only run when
+// the subgraph is first prepared, and exactly once.
+TEST(BasicInterpreter, DeferredOpInit) {
+  Interpreter interpreter;
+  int first_new_subgraph = 0;
+  interpreter.AddSubgraphs(1, &first_new_subgraph);
+  Subgraph* subgraph = interpreter.subgraph(first_new_subgraph);
+  ASSERT_NE(subgraph, nullptr);
+  subgraph->SetDeferredOpInit(true);
+
+  ASSERT_EQ(subgraph->AddTensors(2), kTfLiteOk);
+  ASSERT_EQ(subgraph->SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(subgraph->SetOutputs({1}), kTfLiteOk);
+  TfLiteQuantization quantization;
+  quantization.type = kTfLiteNoQuantization;
+  for (int i = 0; i < 2; ++i) {
+    ASSERT_EQ(subgraph->SetTensorParametersReadWrite(i, kTfLiteFloat32, "",
+                                                     {3}, quantization),
+              kTfLiteOk);
+  }
+
+  static int init_count;
+  init_count = 0;
+  TfLiteRegistration reg = {nullptr, nullptr, nullptr, nullptr};
+  reg.init = [](TfLiteContext* context, const char*, size_t) -> void* {
+    ++init_count;
+    return nullptr;
+  };
+  reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    return kTfLiteOk;
+  };
+  ASSERT_EQ(
+      subgraph->AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr, &reg),
+      kTfLiteOk);
+  EXPECT_EQ(init_count, 0);
+
+  ASSERT_EQ(subgraph->AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(init_count, 1);
+  ASSERT_EQ(subgraph->Invoke(), kTfLiteOk);
+
+  // A subsequent re-preparation must not initialize the op again.
+  ASSERT_EQ(subgraph->ResizeInputTensor(0, {4}), kTfLiteOk);
+  ASSERT_EQ(subgraph->AllocateTensors(), kTfLiteOk);
+  EXPECT_EQ(init_count, 1);
+}
+
+// Checks that the experimental parallel execution path computes the same
+// results as the default serial path on a graph with independent branches.
+TEST(BasicInterpreter, ParallelExecutionMatchesSerial) {
+  Interpreter interpreter;
+  ASSERT_EQ(interpreter.AddTensors(4), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetInputs({0}), kTfLiteOk);
+  ASSERT_EQ(interpreter.SetOutputs({3}), kTfLiteOk);
+
+  TfLiteQuantizationParams quantized;
+  for (int i = 0; i < 4; ++i) {
+    ASSERT_EQ(interpreter.SetTensorParametersReadWrite(i, kTfLiteFloat32, "",
+                                                       {3}, quantized),
+              kTfLiteOk);
+  }
+
+  TfLiteRegistration double_reg = {nullptr, nullptr, nullptr, nullptr};
+  double_reg.prepare = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    return context->ResizeTensor(context, output,
+                                 TfLiteIntArrayCopy(input->dims));
+  };
+  double_reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* input = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < input->dims->data[0]; ++i) {
+      output->data.f[i] = input->data.f[i] * 2.f;
+    }
+    return kTfLiteOk;
+  };
+  TfLiteRegistration add_reg = {nullptr, nullptr, nullptr, nullptr};
+  add_reg.prepare = double_reg.prepare;
+  add_reg.invoke = [](TfLiteContext* context, TfLiteNode* node) {
+    TfLiteTensor* a = &context->tensors[node->inputs->data[0]];
+    TfLiteTensor* b = &context->tensors[node->inputs->data[1]];
+    TfLiteTensor* output = &context->tensors[node->outputs->data[0]];
+    for (int i = 0; i < a->dims->data[0]; ++i) {
+      output->data.f[i] = a->data.f[i] + b->data.f[i];
+    }
+    return kTfLiteOk;
+  };
+
+  // Two independent branches feeding a final add.
+  ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {1}, nullptr, 0, nullptr,
+                                              &double_reg),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AddNodeWithParameters({0}, {2}, nullptr, 0, nullptr,
+                                              &double_reg),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AddNodeWithParameters({1, 2}, {3}, nullptr, 0, nullptr,
+                                              &add_reg),
+            kTfLiteOk);
+  ASSERT_EQ(interpreter.AllocateTensors(), kTfLiteOk);
+
+  interpreter.SetParallelExecution(true, 4);
+  for (int iteration = 0; iteration < 16; ++iteration) {
+    for (int i = 0; i < 3; ++i) {
+      interpreter.typed_tensor<float>(0)[i] = i + iteration;
+    }
+    ASSERT_EQ(interpreter.Invoke(), kTfLiteOk);
+    for (int i = 0; i < 3; ++i) {
+      EXPECT_EQ(interpreter.typed_tensor<float>(3)[i], 4.f * (i + iteration));
+    }
+  }
+}
+
 // Forcefully divides tensor allocation in three steps: one before invocation
 // and two more at invocation time. This happens because we use string tensors
 // and their sizes can't be determined until invocation time.
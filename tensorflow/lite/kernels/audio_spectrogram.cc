@@ -150,6 +150,90 @@ TfLiteStatus Eval(TfLiteContext* context, TfLiteNode* node) {
   return kTfLiteOk;
 }
 
+// Streaming variant. The spectrogram's internal buffer carries the tail
+// of each input over to the next Invoke(), so consecutive chunks of an
+// audio stream only pay for the frames they newly complete instead of
+// re-transforming the overlapping history each time. The buffer is
+// primed with window_size - stride zeros so that every chunk of
+// sample_count samples yields exactly sample_count / stride frames,
+// keeping the output shape static. Re-running Prepare (e.g. after a
+// resize) re-primes the buffer and restarts the stream.
+TfLiteStatus StreamingPrepare(TfLiteContext* context, TfLiteNode* node) {
+  auto* params =
+      reinterpret_cast<TfLiteAudioSpectrogramParams*>(node->user_data);
+
+  TF_LITE_ENSURE_EQ(context, NumInputs(node), 1);
+  TF_LITE_ENSURE_EQ(context, NumOutputs(node), 1);
+
+  const TfLiteTensor* input = GetInput(context, node, kInputTensor);
+  TfLiteTensor* output = GetOutput(context, node, kOutputTensor);
+
+  TF_LITE_ENSURE_EQ(context, NumDimensions(input), 2);
+  TF_LITE_ENSURE_EQ(context, input->dims->data[1], 1);
+
+  TF_LITE_ENSURE_EQ(context, output->type, kTfLiteFloat32);
+  TF_LITE_ENSURE_EQ(context, input->type, output->type);
+
+  TF_LITE_ENSURE(context, params->stride > 0);
+  TF_LITE_ENSURE(context, params->window_size >= params->stride);
+  const int64_t sample_count = input->dims->data[0];
+  TF_LITE_ENSURE(context, sample_count >= params->stride);
+  TF_LITE_ENSURE_EQ(context, sample_count % params->stride, 0);
+
+  TF_LITE_ENSURE(context, params->spectrogram->Initialize(params->window_size,
+                                                          params->stride));
+  const std::vector<float> priming_samples(
+      params->window_size - params->stride, 0.0f);
+  std::vector<std::vector<float>> unused_output;
+  TF_LITE_ENSURE(context,
+                 params->spectrogram->ComputeSquaredMagnitudeSpectrogram(
+                     priming_samples, &unused_output));
+  TF_LITE_ENSURE(context, unused_output.empty());
+
+  params->output_height = sample_count / params->stride;
+  TfLiteIntArray* output_size = TfLiteIntArrayCreate(3);
+  output_size->data[0] = 1;
+  output_size->data[1] = params->output_height;
+  output_size->data[2] = params->spectrogram->output_frequency_channels();
+
+  return context->ResizeTensor(context, output, output_size);
+}
+
+TfLiteStatus StreamingEval(TfLiteContext* context, TfLiteNode* node) {
+  auto* params =
+      reinterpret_cast<TfLiteAudioSpectrogramParams*>(node->user_data);
+
+  const TfLiteTensor* input = GetInput(context, node, kInputTensor);
+  TfLiteTensor* output = GetOutput(context, node, kOutputTensor);
+
+  const float* input_data = GetTensorData<float>(input);
+  const int64_t sample_count = input->dims->data[0];
+  const int64_t output_width = params->spectrogram->output_frequency_channels();
+  float* output_flat = GetTensorData<float>(output);
+
+  const std::vector<float> samples(input_data, input_data + sample_count);
+  std::vector<std::vector<float>> spectrogram_output;
+  TF_LITE_ENSURE(context,
+                 params->spectrogram->ComputeSquaredMagnitudeSpectrogram(
+                     samples, &spectrogram_output));
+  TF_LITE_ENSURE_EQ(context, spectrogram_output.size(), params->output_height);
+  for (int row_index = 0; row_index < params->output_height; ++row_index) {
+    const std::vector<float>& spectrogram_row = spectrogram_output[row_index];
+    TF_LITE_ENSURE_EQ(context, spectrogram_row.size(), output_width);
+    float* output_row = output_flat + (row_index * output_width);
+    if (params->magnitude_squared) {
+      for (int i = 0; i < output_width; ++i) {
+        output_row[i] = spectrogram_row[i];
+      }
+    } else {
+      for (int i = 0; i < output_width; ++i) {
+        output_row[i] = sqrtf(spectrogram_row[i]);
+      }
+    }
+  }
+  return kTfLiteOk;
+}
+
 }  // namespace audio_spectrogram
 
 TfLiteRegistration* Register_AUDIO_SPECTROGRAM() {
@@ -160,6 +244,13 @@ TfLiteRegistration* Register_AUDIO_SPECTROGRAM() {
   return &r;
 }
 
+TfLiteRegistration* Register_STREAMING_AUDIO_SPECTROGRAM() {
+  static TfLiteRegistration r = {
+      audio_spectrogram::Init, audio_spectrogram::Free,
+      audio_spectrogram::StreamingPrepare, audio_spectrogram::StreamingEval};
+  return &r;
+}
+
 }  // namespace custom
 }  // namespace ops
 }  // namespace tflite
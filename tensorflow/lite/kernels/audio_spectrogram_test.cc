@@ -29,6 +29,7 @@ namespace ops {
 namespace custom {
 
 TfLiteRegistration* Register_AUDIO_SPECTROGRAM();
+TfLiteRegistration* Register_STREAMING_AUDIO_SPECTROGRAM();
 
 namespace {
 
@@ -110,6 +111,56 @@ TEST(SpectrogramOpTest, StrideTest) {
                                  {0, 1, 4, 1, 0, 1, 2, 1, 2, 1}, 1e-3)));
 }
 
+class StreamingAudioSpectrogramOpModel : public SingleOpModel {
+ public:
+  StreamingAudioSpectrogramOpModel(const TensorData& input1,
+                                   const TensorData& output, int window_size,
+                                   int stride, bool magnitude_squared) {
+    input1_ = AddInput(input1);
+    output_ = AddOutput(output);
+
+    flexbuffers::Builder fbb;
+    fbb.Map([&]() {
+      fbb.Int("window_size", window_size);
+      fbb.Int("stride", stride);
+      fbb.Bool("magnitude_squared", magnitude_squared);
+    });
+    fbb.Finish();
+    SetCustomOp("StreamingAudioSpectrogram", fbb.GetBuffer(),
+                Register_STREAMING_AUDIO_SPECTROGRAM);
+    BuildInterpreter({GetShape(input1_)});
+  }
+
+  int input1() { return input1_; }
+  std::vector<float> GetOutput() { return ExtractVector<float>(output_); }
+  std::vector<int> GetOutputShape() { return GetTensorShape(output_); }
+
+ protected:
+  int input1_;
+  int output_;
+};
+
+TEST(StreamingAudioSpectrogramOpModel, StreamingTest) {
+  StreamingAudioSpectrogramOpModel m({TensorType_FLOAT32, {4, 1}},
+                                     {TensorType_FLOAT32, {}}, 8, 4, false);
+
+  // The first chunk's window starts in the zero-primed history.
+  m.PopulateTensor<float>(m.input1(), {-1.0f, 0.0f, 1.0f, 0.0f});
+  m.Invoke();
+  EXPECT_THAT(m.GetOutputShape(), ElementsAre(1, 1, 5));
+  EXPECT_THAT(m.GetOutput(),
+              ElementsAreArray(ArrayFloatNear(
+                  {0.5f, 1.118f, 1.5f, 1.118f, 0.5f}, 1e-3)));
+
+  // The second chunk completes a window spanning both chunks, and matches
+  // what AudioSpectrogram produces for the eight samples in one call.
+  m.PopulateTensor<float>(m.input1(), {-1.0f, 0.0f, 1.0f, 0.0f});
+  m.Invoke();
+  EXPECT_THAT(m.GetOutputShape(), ElementsAre(1, 1, 5));
+  EXPECT_THAT(m.GetOutput(), ElementsAreArray(ArrayFloatNear(
+                                 {0.0f, 1.0f, 2.0f, 1.0f, 0.0f}, 1e-3)));
+}
+
 }  // namespace
 }  // namespace custom
 }  // namespace ops
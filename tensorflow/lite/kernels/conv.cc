@@ -424,6 +424,14 @@ void EvalQuantized(TfLiteContext* context, TfLiteNode* node,
                    TfLiteTensor* output) {
   gemmlowp::GemmContext* gemm_context = gemm_support::GetFromContext(context);
 
+  // Match the gemmlowp thread count to this conv's GEMM shape; the small
+  // depths common in mobile models don't always amortize fanning work out
+  // to every core.
+  const int gemm_rows = SizeOfDimension(filter, 0);
+  gemm_support::SetNumThreadsForShape(context, gemm_rows,
+                                      NumElements(output) / gemm_rows,
+                                      NumElements(filter) / gemm_rows);
+
   auto input_offset = -input->params.zero_point;
   auto filter_offset = -filter->params.zero_point;
   auto output_offset = output->params.zero_point;
@@ -318,6 +318,14 @@ TfLiteStatus EvalQuantized(TfLiteContext* context, TfLiteNode* node,
                            TfLiteTensor* output) {
   gemmlowp::GemmContext* gemm_context = gemm_support::GetFromContext(context);
 
+  // Match the gemmlowp thread count to this layer's GEMM shape; small
+  // batches over a modest number of units don't amortize fanning work out
+  // to every core.
+  const int num_units = SizeOfDimension(filter, 0);
+  gemm_support::SetNumThreadsForShape(context, num_units,
+                                      NumElements(output) / num_units,
+                                      SizeOfDimension(filter, 1));
+
   int32_t input_offset = -input->params.zero_point;
   int32_t filter_offset = -filter->params.zero_point;
   int32_t output_offset = output->params.zero_point;
@@ -394,6 +402,11 @@ TfLiteStatus EvalShuffledQuantized(TfLiteContext* context, TfLiteNode* node,
                                    TfLiteTensor* shuffled_input_workspace) {
   gemmlowp::GemmContext* gemm_context = gemm_support::GetFromContext(context);
 
+  const int num_units = SizeOfDimension(filter, 0);
+  gemm_support::SetNumThreadsForShape(context, num_units,
+                                      NumElements(output) / num_units,
+                                      SizeOfDimension(filter, 1));
+
   // TODO(b/110697972) decide more consistently if / how / where we want
   // to perform this kind of runtime data type checks.
   if (input->type != kTfLiteUInt8 || filter->type != kTfLiteUInt8 ||
@@ -14,6 +14,7 @@ limitations under the License.
 ==============================================================================*/
 #include "tensorflow/lite/kernels/gemm_support.h"
 
+#include <cstdint>
 #include <memory>
 
 #include "tensorflow/lite/kernels/op_macros.h"
@@ -25,8 +26,18 @@ namespace {
 struct RefCountedGemmContext : public TfLiteExternalContext {
   std::unique_ptr<gemmlowp::GemmContext> gemm_context;
   int num_references = 0;
+  // Thread count configured through the interpreter, used as the ceiling
+  // for per-shape thread selection. 0 if none was ever configured, in which
+  // case the gemmlowp default (single-threaded) applies.
+  int configured_max_threads = 0;
 };
 
+// Minimum number of multiply-accumulate operations assigned to each worker
+// thread. Below this, the synchronization overhead of an extra thread
+// outweighs its contribution, which hurts in particular at the small depths
+// common in mobile models.
+constexpr int64_t kMinMacsPerThread = 1 << 17;
+
 RefCountedGemmContext* GetGemmLowpContext(TfLiteContext* context) {
   return reinterpret_cast<RefCountedGemmContext*>(
       context->GetExternalContext(context, kTfLiteGemmLowpContext));
@@ -36,6 +47,9 @@ TfLiteStatus Refresh(TfLiteContext* context) {
   auto* ptr = GetGemmLowpContext(context);
   if (ptr != nullptr) {
     ptr->gemm_context->set_max_num_threads(context->recommended_num_threads);
+    if (context->recommended_num_threads > 0) {
+      ptr->configured_max_threads = context->recommended_num_threads;
+    }
   }
   return kTfLiteOk;
 }
@@ -51,6 +65,9 @@ void IncrementUsageCounter(TfLiteContext* context) {
     ptr->gemm_context.reset(new gemmlowp::GemmContext());
     if (context->recommended_num_threads != -1) {
       ptr->gemm_context->set_max_num_threads(context->recommended_num_threads);
+      if (context->recommended_num_threads > 0) {
+        ptr->configured_max_threads = context->recommended_num_threads;
+      }
     }
     ptr->num_references = 0;
     context->SetExternalContext(context, kTfLiteGemmLowpContext, ptr);
@@ -80,5 +97,26 @@ gemmlowp::GemmContext* GetFromContext(TfLiteContext* context) {
   return ptr->gemm_context.get();
 }
 
+void SetNumThreadsForShape(TfLiteContext* context, int rows, int cols,
+                           int depth) {
+  auto* ptr = GetGemmLowpContext(context);
+  if (ptr == nullptr) {
+    TF_LITE_FATAL(
+        "Call to SetNumThreadsForShape() not preceded by "
+        "IncrementUsageCounter()");
+  }
+  // Per-shape selection only makes sense once a multithreaded ceiling has
+  // been configured; otherwise keep the gemmlowp default.
+  if (ptr->configured_max_threads <= 1) return;
+  const int64_t macs =
+      static_cast<int64_t>(rows) * static_cast<int64_t>(cols) * depth;
+  int num_threads = static_cast<int>(macs / kMinMacsPerThread);
+  if (num_threads < 1) num_threads = 1;
+  if (num_threads > ptr->configured_max_threads) {
+    num_threads = ptr->configured_max_threads;
+  }
+  ptr->gemm_context->set_max_num_threads(num_threads);
+}
+
 }  // namespace gemm_support
 }  // namespace tflite
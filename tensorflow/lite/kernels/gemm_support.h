@@ -37,6 +37,15 @@ namespace gemm_support {
 //   }
 gemmlowp::GemmContext* GetFromContext(TfLiteContext* context);
 
+// Adjusts the number of gemmlowp worker threads to suit a GEMM with the
+// given dimensions. Small products do not amortize the fixed cost of fanning
+// work out to additional cores, so the thread count grows with the number of
+// multiply-accumulates, capped at the count configured through the
+// interpreter. Must be called between IncrementUsageCounter() and
+// DecrementUsageCounter(), before running the GEMM.
+void SetNumThreadsForShape(TfLiteContext* context, int rows, int cols,
+                           int depth);
+
 // Let the framework know that the GemmContext stored in 'context' will be used
 // by an op. If necessary a new GemmContext is created and placed in 'context'.
 void IncrementUsageCounter(TfLiteContext* context);
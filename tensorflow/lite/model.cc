@@ -534,6 +534,12 @@ TfLiteStatus InterpreterBuilder::operator()(
           subgraph_index);
       return cleanup_and_error();
     }
+    if (subgraph_index != 0) {
+      // Non-primary subgraphs are only prepared if and when they are first
+      // used. Deferring per-op initialization to that point keeps setup cost
+      // proportional to the subgraphs actually executed.
+      modified_subgraph->SetDeferredOpInit(true);
+    }
     if (modified_subgraph->AddTensors(tensors->Length()) != kTfLiteOk) {
       return cleanup_and_error();
     }
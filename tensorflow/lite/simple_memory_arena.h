@@ -64,6 +64,21 @@ class SimpleMemoryArena {
 
   TfLiteStatus Commit(TfLiteContext* context);
 
+  // Returns the current high water mark, i.e. the size of the used portion
+  // of the underlying buffer.
+  size_t GetHighWaterMark() const { return high_water_mark_; }
+
+  // Restores a previously recorded high water mark. Used when a cached
+  // allocation plan is reinstated without replaying its individual
+  // allocations; `Commit` sizes the underlying buffer from this value. The
+  // mark never shrinks, so the buffer is retained at its high water size
+  // across re-plans.
+  void RestoreHighWaterMark(size_t high_water_mark) {
+    if (high_water_mark > high_water_mark_) {
+      high_water_mark_ = high_water_mark;
+    }
+  }
+
   TfLiteStatus ResolveAlloc(TfLiteContext* context, const ArenaAlloc& alloc,
                             char** output_ptr);
 
@@ -94,7 +94,7 @@ class _TFRecordDataset(dataset_ops.DatasetSource):
     Args:
       filenames: A `tf.string` tensor containing one or more filenames.
       compression_type: (Optional.) A `tf.string` scalar evaluating to one of
-        `""` (no compression), `"ZLIB"`, or `"GZIP"`.
+        `""` (no compression), `"ZLIB"`, `"GZIP"`, or `"SNAPPY"`.
       buffer_size: (Optional.) A `tf.int64` scalar representing the number of
         bytes in the read buffer. 0 means no buffering.
     """
@@ -185,7 +185,7 @@ class TFRecordDatasetV2(dataset_ops.DatasetV2):
       filenames: A `tf.string` tensor or `tf.data.Dataset` containing one or
         more filenames.
       compression_type: (Optional.) A `tf.string` scalar evaluating to one of
-        `""` (no compression), `"ZLIB"`, or `"GZIP"`.
+        `""` (no compression), `"ZLIB"`, `"GZIP"`, or `"SNAPPY"`.
       buffer_size: (Optional.) A `tf.int64` scalar representing the number of
         bytes in the read buffer. 0 means no buffering.
       num_parallel_reads: (Optional.) A `tf.int64` scalar representing the
@@ -35,6 +35,7 @@ class TFRecordCompressionType(object):
   NONE = 0
   ZLIB = 1
   GZIP = 2
+  SNAPPY = 3
 
 
 @tf_export(
@@ -46,6 +47,7 @@ class TFRecordOptions(object):
   compression_type_map = {
       TFRecordCompressionType.ZLIB: "ZLIB",
       TFRecordCompressionType.GZIP: "GZIP",
+      TFRecordCompressionType.SNAPPY: "SNAPPY",
       TFRecordCompressionType.NONE: ""
   }
 
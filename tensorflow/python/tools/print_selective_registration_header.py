@@ -63,7 +63,9 @@ if __name__ == '__main__':
       '--proto_fileformat',
       type=str,
       default='rawproto',
-      help='Format of proto file, either textproto or rawproto.')
+      help='Format of proto file, either textproto, rawproto or savedmodel. '
+      'With savedmodel, each path should name a SavedModel protobuf, '
+      'e.g. some/dir/saved_model.pb.')
   parser.add_argument(
       '--default_ops',
       type=str,
@@ -24,6 +24,7 @@ import sys
 from google.protobuf import text_format
 
 from tensorflow.core.framework import graph_pb2
+from tensorflow.core.protobuf import saved_model_pb2
 from tensorflow.python.framework import test_util
 from tensorflow.python.platform import gfile
 from tensorflow.python.platform import test
@@ -139,6 +140,31 @@ class PrintOpFilegroupTest(test.TestCase):
         ],
         ops_and_kernels)
 
+  def testGetOpsFromSavedModelAndFunctions(self):
+    default_ops = ''
+    graph_def = text_format.Parse(GRAPH_DEF_TXT_2, graph_pb2.GraphDef())
+    # Move the BiasAdd node into a library function so that only the
+    # function-library traversal can find it.
+    function_def = graph_def.library.function.add()
+    function_def.signature.name = 'bias_fn'
+    function_def.node_def.add().CopyFrom(graph_def.node[0])
+    del graph_def.node[0]
+
+    saved_model = saved_model_pb2.SavedModel()
+    saved_model.meta_graphs.add().graph_def.CopyFrom(graph_def)
+    fname = os.path.join(self.get_temp_dir(), 'saved_model.pb')
+    with gfile.GFile(fname, 'wb') as f:
+      f.write(saved_model.SerializeToString())
+
+    ops_and_kernels = selective_registration_header_lib.get_ops_and_kernels(
+        'savedmodel', [fname], default_ops)
+    self.assertListEqual(
+        [
+            ('AccumulateNV2', None),  #
+            ('BiasAdd', 'BiasOp<CPUDevice, float>'),  #
+        ],
+        ops_and_kernels)
+
   def testAll(self):
     default_ops = 'all'
     graphs = [
@@ -28,6 +28,7 @@ import sys
 from google.protobuf import text_format
 
 from tensorflow.core.framework import graph_pb2
+from tensorflow.core.protobuf import saved_model_pb2
 from tensorflow.python import pywrap_tensorflow
 from tensorflow.python.platform import gfile
 from tensorflow.python.platform import tf_logging
@@ -43,35 +44,49 @@ OPS_WITHOUT_KERNEL_WHITELIST = frozenset([
 ])
 
 
+def _get_ops_from_nodedefs(node_defs, ops):
+  """Adds the op and kernel needed by each NodeDef to the ops set."""
+  for node_def in node_defs:
+    if not node_def.device:
+      node_def.device = '/cpu:0'
+    kernel_class = pywrap_tensorflow.TryFindKernelClass(
+        node_def.SerializeToString())
+    op = str(node_def.op)
+    if kernel_class or op in OPS_WITHOUT_KERNEL_WHITELIST:
+      op_and_kernel = (op, str(kernel_class.decode('utf-8'))
+                       if kernel_class else None)
+      if op_and_kernel not in ops:
+        ops.add(op_and_kernel)
+    else:
+      print(
+          'Warning: no kernel found for op %s' % node_def.op, file=sys.stderr)
+
+
 def get_ops_and_kernels(proto_fileformat, proto_files, default_ops_str):
   """Gets the ops and kernels needed from the model files."""
   ops = set()
 
   for proto_file in proto_files:
     tf_logging.info('Loading proto file %s', proto_file)
-    # Load GraphDef.
+    # Load GraphDef(s).
     file_data = gfile.GFile(proto_file, 'rb').read()
     if proto_fileformat == 'rawproto':
-      graph_def = graph_pb2.GraphDef.FromString(file_data)
+      graph_defs = [graph_pb2.GraphDef.FromString(file_data)]
+    elif proto_fileformat == 'savedmodel':
+      saved_model = saved_model_pb2.SavedModel.FromString(file_data)
+      graph_defs = [
+          meta_graph.graph_def for meta_graph in saved_model.meta_graphs
+      ]
     else:
       assert proto_fileformat == 'textproto'
-      graph_def = text_format.Parse(file_data, graph_pb2.GraphDef())
-
-    # Find all ops and kernels used by the graph.
-    for node_def in graph_def.node:
-      if not node_def.device:
-        node_def.device = '/cpu:0'
-      kernel_class = pywrap_tensorflow.TryFindKernelClass(
-          node_def.SerializeToString())
-      op = str(node_def.op)
-      if kernel_class or op in OPS_WITHOUT_KERNEL_WHITELIST:
-        op_and_kernel = (op, str(kernel_class.decode('utf-8'))
-                         if kernel_class else None)
-        if op_and_kernel not in ops:
-          ops.add(op_and_kernel)
-      else:
-        print(
-            'Warning: no kernel found for op %s' % node_def.op, file=sys.stderr)
+      graph_defs = [text_format.Parse(file_data, graph_pb2.GraphDef())]
+
+    # Find all ops and kernels used by the graphs, including those reachable
+    # only through the function library.
+    for graph_def in graph_defs:
+      _get_ops_from_nodedefs(graph_def.node, ops)
+      for function_def in graph_def.library.function:
+        _get_ops_from_nodedefs(function_def.node_def, ops)
 
   # Add default ops.
   if default_ops_str and default_ops_str != 'all':
@@ -174,8 +189,10 @@ def get_header(graphs,
 
   Args:
     graphs: a list of paths to GraphDef files to include.
-    proto_fileformat: optional format of proto file, either 'textproto' or
-      'rawproto' (default).
+    proto_fileformat: optional format of proto file, either 'textproto',
+      'rawproto' (default) or 'savedmodel'.  With 'savedmodel' each path
+      names a SavedModel protobuf (e.g. saved_model.pb) and every meta
+      graph in it contributes its ops.
     default_ops: optional comma-separated string of operator:kernel pairs to
       always include implementation for. Pass 'all' to have all operators and
       kernels included. Default: 'NoOp:NoOp,_Recv:RecvOp,_Send:SendOp'.
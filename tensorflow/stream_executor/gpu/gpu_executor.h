@@ -264,6 +264,18 @@ class GpuExecutor : public internal::StreamExecutorInterface {
   bool GetKernelMetadata(GpuKernel* cuda_kernel,
                          KernelMetadata* kernel_metadata);
 
+  // Aggregate statistics on GPU module loads performed by this executor.
+  // Modules load lazily on first use of each kernel, so these numbers
+  // capture the cold-start latency paid before steady state.
+  struct ModuleLoadStats {
+    int64 load_count = 0;
+    int64 total_load_micros = 0;
+    int64 max_load_micros = 0;
+  };
+
+  // (supported on ROCm only)
+  ModuleLoadStats GetModuleLoadStats();
+
   // Prints to VLOG(2) information about the kernel's occupancy and how it might
   // be improved.
   void VlogOccupancyInfo(const KernelBase& kernel, const ThreadDim& thread_dims,
@@ -285,6 +297,13 @@ class GpuExecutor : public internal::StreamExecutorInterface {
   bool UnloadGpuBinary(const void* gpu_binary)
       EXCLUSIVE_LOCKS_REQUIRED(in_memory_modules_mu_);
 
+  // Pre-loads GPU modules at executor initialization so the first launch
+  // of each kernel does not pay code-object load latency.  Loads every
+  // hsaco file found in the directory named by TF_ROCM_MODULE_PREWARM_DIR
+  // (e.g. a pre-linked cache produced by an earlier run); a no-op when
+  // the variable is unset.  (supported on ROCm only)
+  void MaybePrewarmModules();
+
   // Guards the on-disk-module mapping.
   mutex disk_modules_mu_;
 
@@ -307,6 +326,15 @@ class GpuExecutor : public internal::StreamExecutorInterface {
   std::unordered_map<const void*, std::pair<GpuModuleHandle, uint64>>
       gpu_binary_to_module_ GUARDED_BY(in_memory_modules_mu_);
 
+  // Storage backing the modules loaded by MaybePrewarmModules.  Module
+  // caching is keyed on the binary's address, so these buffers must stay
+  // alive as long as the modules do.  (used on ROCm only)
+  std::vector<string> prewarmed_hsacos_ GUARDED_BY(in_memory_modules_mu_);
+
+  // Module-load latency accounting; see GetModuleLoadStats.  (used on
+  // ROCm only)
+  ModuleLoadStats module_load_stats_ GUARDED_BY(in_memory_modules_mu_);
+
   // Guards the launched kernel set.
   mutex launched_kernels_mu_;
 
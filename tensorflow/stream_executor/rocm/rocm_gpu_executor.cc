@@ -16,7 +16,12 @@ limitations under the License.
 #include "tensorflow/stream_executor/rocm/rocm_gpu_executor.h"
 
 #include <unistd.h>
+
+#include <algorithm>
+#include <cstdlib>
+
 #include "absl/base/casts.h"
+#include "absl/strings/match.h"
 #include "absl/strings/str_cat.h"
 #include "absl/strings/str_format.h"
 #include "tensorflow/stream_executor/kernel_cache_config.h"
@@ -173,7 +178,13 @@ port::Status GpuExecutor::Init(int device_ordinal,
     return status;
   }
 
-  return GpuDriver::GetGpuISAVersion(&version_, device_);
+  status = GpuDriver::GetGpuISAVersion(&version_, device_);
+  if (!status.ok()) {
+    return status;
+  }
+
+  MaybePrewarmModules();
+  return port::Status::OK();
 }
 
 bool GpuExecutor::FindOnDiskForComputeCapability(
@@ -410,14 +421,21 @@ bool GpuExecutor::LoadModuleFromHsaco(const char* hsaco, hipModule_t* module) {
   std::tie(*module, module_refcount) = gpu_binary_to_module_[hsaco];
 
   if (*module == nullptr) {
+    const uint64 start_micros = port::Env::Default()->NowMicros();
     if (!GpuDriver::LoadHsaco(context_, hsaco, module)) {
       LOG(ERROR) << "failed to load : HSACO \n";
       return false;
     }
+    const int64 load_micros =
+        static_cast<int64>(port::Env::Default()->NowMicros() - start_micros);
+    module_load_stats_.load_count++;
+    module_load_stats_.total_load_micros += load_micros;
+    module_load_stats_.max_load_micros =
+        std::max(module_load_stats_.max_load_micros, load_micros);
     module_refcount = 1;
     in_memory_modules_[hsaco] = *module;
-    VLOG(3) << "Loaded HSACO " << static_cast<const void*>(hsaco)
-            << " as module " << *module;
+    VLOG(1) << "Loaded HSACO " << static_cast<const void*>(hsaco)
+            << " as module " << *module << " in " << load_micros << " us";
   } else {
     ++module_refcount;
     VLOG(3) << "HSACO " << static_cast<const void*>(hsaco)
@@ -427,6 +445,57 @@ bool GpuExecutor::LoadModuleFromHsaco(const char* hsaco, hipModule_t* module) {
   return true;
 }
 
+GpuExecutor::ModuleLoadStats GpuExecutor::GetModuleLoadStats() {
+  mutex_lock lock{in_memory_modules_mu_};
+  return module_load_stats_;
+}
+
+void GpuExecutor::MaybePrewarmModules() {
+  const char* prewarm_dir = std::getenv("TF_ROCM_MODULE_PREWARM_DIR");
+  if (prewarm_dir == nullptr) {
+    return;
+  }
+
+  std::vector<string> children;
+  port::Status status =
+      port::Env::Default()->GetChildren(prewarm_dir, &children);
+  if (!status.ok()) {
+    LOG(WARNING) << "could not list module pre-warm directory " << prewarm_dir
+                 << ": " << status;
+    return;
+  }
+
+  const uint64 start_micros = port::Env::Default()->NowMicros();
+  int num_loaded = 0;
+  mutex_lock lock{in_memory_modules_mu_};
+  for (const string& child : children) {
+    if (!absl::EndsWith(child, ".hsaco")) {
+      continue;
+    }
+    const string path = port::JoinPath(prewarm_dir, child);
+    string hsaco;
+    status = tensorflow::ReadFileToString(port::Env::Default(), path, &hsaco);
+    if (!status.ok()) {
+      LOG(WARNING) << "could not read module " << path << ": " << status;
+      continue;
+    }
+    // Module caching is keyed on the binary's address, so keep the bytes
+    // alive for the lifetime of this executor.
+    prewarmed_hsacos_.push_back(std::move(hsaco));
+    hipModule_t module = nullptr;
+    if (!LoadModuleFromHsaco(prewarmed_hsacos_.back().c_str(), &module)) {
+      LOG(WARNING) << "failed to pre-warm module " << path;
+      continue;
+    }
+    ++num_loaded;
+  }
+  if (num_loaded > 0) {
+    LOG(INFO) << "pre-warmed " << num_loaded << " GPU module(s) from "
+              << prewarm_dir << " in "
+              << (port::Env::Default()->NowMicros() - start_micros) << " us";
+  }
+}
+
 // This is a non-essential operation; if there's a failure, proceed without
 // logging an error. It's nearly certain that in case of failures, we'd never
 // get here in the first place; these are very low-impact routines.
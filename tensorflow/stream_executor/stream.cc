@@ -15,6 +15,9 @@ limitations under the License.
 
 #include "tensorflow/stream_executor/stream.h"
 
+#include <cstdlib>
+#include <cstring>
+
 #include "tensorflow/stream_executor/platform/port.h"
 
 #include "absl/strings/str_cat.h"
@@ -326,6 +329,7 @@ Stream &Stream::InitWithTimer(Timer *timer) {
 Stream &Stream::ThenRecordEvent(Event *event) {
   VLOG_CALL(PARAM(event));
 
+  op_count_.fetch_add(1, std::memory_order_relaxed);
   port::Status status = parent_->RecordEvent(this, event);
   if (!status.ok()) {
     LOG(ERROR) << "Error recording event in stream: " << status.error_message()
@@ -5113,6 +5117,23 @@ Stream &Stream::ThenTransformTensor(const dnn::BatchDescriptor &input_desc,
   return *this;
 }
 
+namespace {
+
+// If true, runs of consecutive host callbacks on one stream are coalesced
+// into a single stream callback.  Each stream callback is a
+// synchronization point on some platforms (notably HIP), and
+// cleanup-heavy steps can entrain thousands of tiny ones.
+bool HostCallbackBatchingEnabled() {
+  static bool enabled = [] {
+    const char* env = std::getenv("TF_STREAM_HOST_CALLBACK_BATCHING");
+    return env != nullptr &&
+           (strcmp(env, "1") == 0 || strcmp(env, "true") == 0);
+  }();
+  return enabled;
+}
+
+}  // namespace
+
 Stream &Stream::ThenDoHostCallback(std::function<void()> callback) {
   VLOG_CALL(PARAM(callback));
 
@@ -5120,6 +5141,13 @@ Stream &Stream::ThenDoHostCallback(std::function<void()> callback) {
     LOG(INFO) << DebugStreamPointers()
               << " was in error state before adding host callback";
   }
+  if (HostCallbackBatchingEnabled()) {
+    auto cb = std::move(callback);
+    return ThenDoHostCallbackBatched([cb]() {
+      cb();
+      return port::Status::OK();
+    });
+  }
   CheckError(parent_->HostCallback(this, std::move(callback)));
   return *this;
 }
@@ -5132,10 +5160,56 @@ Stream &Stream::ThenDoHostCallbackWithStatus(
     LOG(INFO) << DebugStreamPointers()
               << " was in error state before adding host callback";
   }
+  if (HostCallbackBatchingEnabled()) {
+    return ThenDoHostCallbackBatched(std::move(callback));
+  }
   CheckError(parent_->HostCallback(this, std::move(callback)));
   return *this;
 }
 
+Stream &Stream::ThenDoHostCallbackBatched(
+    std::function<port::Status()> callback) {
+  std::shared_ptr<HostCallbackBatch> batch;
+  {
+    mutex_lock lock(mu_);
+    if (host_callback_batch_ != nullptr &&
+        host_callback_batch_op_count_ ==
+            op_count_.load(std::memory_order_relaxed)) {
+      // Nothing was entrained since the open batch's stream callback, so
+      // running this callback at the batch's synchronization point is
+      // equivalent to entraining it now.
+      mutex_lock batch_lock(host_callback_batch_->mu);
+      if (!host_callback_batch_->started) {
+        host_callback_batch_->callbacks.push_back(std::move(callback));
+        return *this;
+      }
+    }
+    batch = std::make_shared<HostCallbackBatch>();
+    batch->callbacks.push_back(std::move(callback));
+    host_callback_batch_ = batch;
+  }
+  CheckError(parent_->HostCallback(this, [batch]() -> port::Status {
+    std::vector<std::function<port::Status()>> callbacks;
+    {
+      mutex_lock batch_lock(batch->mu);
+      batch->started = true;
+      callbacks.swap(batch->callbacks);
+    }
+    for (auto &cb : callbacks) {
+      port::Status s = cb();
+      if (!s.ok()) {
+        LOG(WARNING) << "Host callback failed: " << s;
+      }
+    }
+    return port::Status::OK();
+  }));
+  {
+    mutex_lock lock(mu_);
+    host_callback_batch_op_count_ = op_count_.load(std::memory_order_relaxed);
+  }
+  return *this;
+}
+
 Stream &Stream::ThenFft(fft::Plan *plan,
                         const DeviceMemory<std::complex<float>> &input,
                         DeviceMemory<std::complex<float>> *output) {
@@ -5501,6 +5575,7 @@ string Stream::DebugStreamPointers() const {
 }
 
 void Stream::CheckStatus(port::Status status) {
+  op_count_.fetch_add(1, std::memory_order_relaxed);
   if (status.ok()) {
     return;
   }
@@ -21,9 +21,11 @@ limitations under the License.
 #ifndef TENSORFLOW_STREAM_EXECUTOR_STREAM_H_
 #define TENSORFLOW_STREAM_EXECUTOR_STREAM_H_
 
+#include <atomic>
 #include <complex>
 #include <functional>
 #include <memory>
+#include <vector>
 
 #include "tensorflow/core/platform/macros.h"
 #include "tensorflow/stream_executor/blas.h"
@@ -2062,6 +2064,7 @@ class Stream {
   // Sets the error state if operation_retcode is false.
   // This is a useful shorthand for many stream routines.
   void CheckError(bool operation_retcode) LOCKS_EXCLUDED(mu_) {
+    op_count_.fetch_add(1, std::memory_order_relaxed);
     if (operation_retcode) {
       return;
     }
@@ -2112,6 +2115,31 @@ class Stream {
   // BlockHostUntilDone() is called.
   internal::TemporaryMemoryManager temporary_memory_manager_;
 
+  // State for coalescing a run of consecutive host callbacks into a
+  // single stream callback (see ThenDoHostCallbackBatched).  "started"
+  // flips when the stream reaches the batch, after which no further
+  // callbacks may join it.
+  struct HostCallbackBatch {
+    mutex mu;
+    bool started GUARDED_BY(mu) = false;
+    std::vector<std::function<port::Status()>> callbacks GUARDED_BY(mu);
+  };
+
+  // Appends "callback" to the currently open batch when nothing else has
+  // been entrained on this stream since the batch's stream callback was,
+  // so the coalescing is exact: every callback still runs at (never
+  // before) its enqueue point.  Otherwise entrains a new batch.  Only
+  // called when TF_STREAM_HOST_CALLBACK_BATCHING is enabled.
+  Stream &ThenDoHostCallbackBatched(std::function<port::Status()> callback);
+
+  // Count of operations entrained on this stream, used to detect whether
+  // anything was enqueued since the open host-callback batch was created.
+  std::atomic<uint64> op_count_{0};
+
+  std::shared_ptr<HostCallbackBatch> host_callback_batch_ GUARDED_BY(mu_);
+  // Value of op_count_ immediately after the open batch was entrained.
+  uint64 host_callback_batch_op_count_ GUARDED_BY(mu_) = 0;
+
   // Implementation of ThenConvolveBackwardBias that is shared by all types.
   template <typename T>
   Stream &ThenConvolveBackwardBiasImpl(